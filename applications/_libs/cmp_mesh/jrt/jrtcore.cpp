@@ -12,12 +12,14 @@
 #include "jrtkdtreebuilder.h"
 #include "jrtheuristickdtreebuilder.h"
 #include "jrth2kdtreebuilder.h"
+#include "jrtparallelkdtreebuilder.h"
 
 JRTCore::JRTCore()
     : m_pTree(NULL)
     , m_pHitArray(new TootleRayHit[5])
     , m_nArraySize(5)
 {
+    memset(&m_treeStats, 0, sizeof(m_treeStats));
 }
 
 JRTCore::~JRTCore()
@@ -37,8 +39,8 @@ JRTCore* JRTCore::Build(const std::vector<JRTMesh*>& rMeshes)
     }
 
     // build KD tree
-    JRTHeuristicKDTreeBuilder builder;
-    JRTKDTree*                pTree = builder.BuildTree(rMeshes);
+    JRTParallelKDTreeBuilder builder;
+    JRTKDTree*               pTree = builder.BuildTree(rMeshes);
 
     if (!pTree)
     {
@@ -46,16 +48,96 @@ JRTCore* JRTCore::Build(const std::vector<JRTMesh*>& rMeshes)
         return NULL;
     }
 
-    pCaster->m_pTree = pTree;
+    pCaster->m_pTree     = pTree;
+    pCaster->m_treeStats = builder.GetStats();
 
     return pCaster;
 }
 
+JRTTraceContext::JRTTraceContext()
+    : m_pMailboxes(NULL)
+    , m_pMailboxMasks(NULL)
+    , m_pBackFacing(NULL)
+    , m_nNextRayID(1)
+{
+    for (UINT i = 0; i < MAX_PACKET_SIZE; i++)
+    {
+        m_pHitArrays[i]  = NULL;
+        m_nArraySizes[i] = 0;
+    }
+}
+
+JRTTraceContext::~JRTTraceContext()
+{
+    JRT_SAFE_DELETE_ARRAY(m_pMailboxes);
+    JRT_SAFE_DELETE_ARRAY(m_pMailboxMasks);
+    JRT_SAFE_DELETE_ARRAY(m_pBackFacing);
+
+    for (UINT i = 0; i < MAX_PACKET_SIZE; i++)
+    {
+        JRT_SAFE_DELETE_ARRAY(m_pHitArrays[i]);
+    }
+}
+
+bool JRTTraceContext::Init(UINT nTriangles)
+{
+    m_pMailboxes    = new UINT[nTriangles];
+    m_pMailboxMasks = new UINT[nTriangles];
+    m_pBackFacing   = new bool[nTriangles];
+
+    if (!m_pMailboxes || !m_pMailboxMasks || !m_pBackFacing)
+    {
+        return false;
+    }
+
+    // mailboxes start out empty, ray IDs start at 1
+    memset(m_pMailboxes, 0, sizeof(UINT) * nTriangles);
+    memset(m_pMailboxMasks, 0, sizeof(UINT) * nTriangles);
+    memset(m_pBackFacing, 0, sizeof(bool) * nTriangles);
+
+    for (UINT i = 0; i < MAX_PACKET_SIZE; i++)
+    {
+        m_pHitArrays[i] = new TootleRayHit[5];
+
+        if (!m_pHitArrays[i])
+        {
+            return false;
+        }
+
+        m_nArraySizes[i] = 5;
+    }
+
+    return true;
+}
+
+UINT JRTTraceContext::NextRayID()
+{
+    UINT nRayID = m_nNextRayID;
+    m_nNextRayID++;
+
+    if (m_nNextRayID == 0)
+    {
+        // handle overflow.  The mailboxes are initialized to 0, so to be fully correct
+        // we can't have any mailboxes have ID 0
+        m_nNextRayID = 1;
+    }
+
+    return nRayID;
+}
+
+/// Orders hits by distance.  Hits at the same distance are ordered by face so that the result does
+/// not depend on the order in which the tree traversal found them
 int SortTootleHit(const void* h1, const void* h2)
 {
     const TootleRayHit* ph1 = (const TootleRayHit*)h1;
     const TootleRayHit* ph2 = (const TootleRayHit*)h2;
-    return ph1->t >= ph2->t;
+
+    if (ph1->t != ph2->t)
+    {
+        return (ph1->t < ph2->t) ? -1 : 1;
+    }
+
+    return (ph1->nFaceID < ph2->nFaceID) ? -1 : (ph1->nFaceID > ph2->nFaceID);
 }
 
 /// \param rOrigin  The ray origin
@@ -110,6 +192,103 @@ void JRTCore::CullBackfaces(const Vec3f& rViewDir, bool bCullCCW)
     m_pTree->CullBackfaces(rViewDir, bCullCCW);
 }
 
+JRTTraceContext* JRTCore::CreateTraceContext() const
+{
+    JRTTraceContext* pContext = new JRTTraceContext();
+
+    if (!pContext)
+    {
+        return NULL;
+    }
+
+    if (!pContext->Init(m_pTree ? m_pTree->GetTriCount() : 0))
+    {
+        delete pContext;
+        return NULL;
+    }
+
+    return pContext;
+}
+
+/// \param rOrigin  The ray origin
+/// \param rDirection The ray direction
+/// \param pContext  Traversal state of the calling thread
+/// \param ppHitArray  A pointer that will be set to point to an array of hits owned by pContext.  The caller should NOT delete the returned array
+/// \param pHitCount   A pointer that will receive the number of hits in the returned array.
+/// \return Returns false if out of memory, true otherwise.
+bool JRTCore::FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, JRTTraceContext* pContext, TootleRayHit** ppHitArray, UINT* pHitCount) const
+{
+    *ppHitArray = NULL;
+    *pHitCount  = 0;
+
+    if (!m_pTree)
+    {
+        return true;
+    }
+
+    UINT nHits = m_pTree->FindAllHits(rOrigin, rDirection, pContext);
+
+    if (nHits == JRTKDTree::OUT_OF_MEMORY)
+    {
+        return false;
+    }
+
+    // sort hits by distance
+    qsort(pContext->m_pHitArrays[0], nHits, sizeof(TootleRayHit), &SortTootleHit);
+    *ppHitArray = pContext->m_pHitArrays[0];
+    *pHitCount  = nHits;
+
+    return true;
+}
+
+void JRTCore::CullBackfaces(const Vec3f& rViewDir, bool bCullCCW, JRTTraceContext* pContext) const
+{
+    if (m_pTree)
+    {
+        m_pTree->CullBackfaces(rViewDir, bCullCCW, pContext->m_pBackFacing);
+    }
+}
+
+/// \param pOrigins    The ray origins
+/// \param nRays       Number of rays, at most JRTTraceContext::MAX_PACKET_SIZE
+/// \param rDirection  The direction of all of the rays
+/// \param pContext    Traversal state of the calling thread
+/// \param ppHitArrays Array that will receive, for each ray, a pointer to its hits.  The hit arrays are owned by pContext
+/// \param pnHits      Array that will receive the number of hits for each ray
+/// \return Returns false if out of memory, true otherwise.
+bool JRTCore::FindAllHitsPacket(const Vec3f*     pOrigins,
+                                UINT             nRays,
+                                const Vec3f&     rDirection,
+                                JRTTraceContext* pContext,
+                                TootleRayHit**   ppHitArrays,
+                                UINT*            pnHits) const
+{
+    for (UINT i = 0; i < nRays; i++)
+    {
+        ppHitArrays[i] = NULL;
+        pnHits[i]      = 0;
+    }
+
+    if (!m_pTree)
+    {
+        return true;
+    }
+
+    if (!m_pTree->FindAllHitsPacket(pOrigins, nRays, rDirection, pContext, pnHits))
+    {
+        return false;
+    }
+
+    // sort the hits of each ray by distance
+    for (UINT i = 0; i < nRays; i++)
+    {
+        qsort(pContext->m_pHitArrays[i], pnHits[i], sizeof(TootleRayHit), &SortTootleHit);
+        ppHitArrays[i] = pContext->m_pHitArrays[i];
+    }
+
+    return true;
+}
+
 bool JRTCore::GetSceneBBHit(const Vec3f& rOrigin, const Vec3f& rDirection, Vec3f* pHitPt)
 {
     const JRTBoundingBox& rBB = m_pTree->GetSceneBounds();
@@ -8,6 +8,7 @@
 
 #include "jrtcommon.h"
 #include "jrttriangleintersection.h"
+#include "jrtkdtreebuilder.h"
 
 struct JRTHitInfo
 {
@@ -30,6 +31,45 @@ class JRTMesh;
 class JRTKDTree;
 class JRTBoundingBox;
 
+/// Mutable ray traversal state (mailboxes, back-face flags and hit buffers).
+/// The JRTCore methods without a context argument use state owned by the core and must not be
+/// called concurrently.  Threads that trace through the same JRTCore each use their own context.
+class JRTTraceContext
+{
+public:
+    /// Maximum number of rays traced together by JRTCore::FindAllHitsPacket
+    static const UINT MAX_PACKET_SIZE = 16;
+
+    ~JRTTraceContext();
+
+private:
+    friend class JRTCore;
+    friend class JRTKDTree;
+
+    JRTTraceContext();
+
+    /// Allocates the per-triangle arrays.  Returns false if out of memory
+    bool Init(UINT nTriangles);
+
+    /// Returns a new ray ID.  A packet uses a single ID for all of its rays
+    UINT NextRayID();
+
+    // per triangle ID of the last ray or packet that hit it
+    UINT* m_pMailboxes;
+
+    // per triangle mask of the packet rays that hit it, valid while m_pMailboxes holds the packet's ID
+    UINT* m_pMailboxMasks;
+
+    // flags to indicate whether or not a triangle is back-facing
+    bool* m_pBackFacing;
+
+    UINT m_nNextRayID;
+
+    // hit buffers, one per packet ray.  Single rays use the first one
+    TootleRayHit* m_pHitArrays[MAX_PACKET_SIZE];
+    UINT          m_nArraySizes[MAX_PACKET_SIZE];
+};
+
 class JRTCore
 {
 public:
@@ -41,12 +81,36 @@ public:
 
     void CullBackfaces(const Vec3f& rViewDir, bool bCullCCW);
 
+    /// Creates traversal state for a thread tracing rays through this core.  Returns NULL if out of memory
+    JRTTraceContext* CreateTraceContext() const;
+
+    /// Thread safe versions of FindAllHits and CullBackfaces, which only modify the given context
+    bool FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, JRTTraceContext* pContext, TootleRayHit** ppHitArray, UINT* pnHits) const;
+
+    void CullBackfaces(const Vec3f& rViewDir, bool bCullCCW, JRTTraceContext* pContext) const;
+
+    /// Finds all hits for a packet of up to JRTTraceContext::MAX_PACKET_SIZE parallel rays, such as
+    /// neighbouring pixels of an orthographic camera.  ppHitArrays[i] and pnHits[i] receive the hits
+    /// for ray i, sorted by distance.  Returns false if out of memory
+    bool FindAllHitsPacket(const Vec3f*     pOrigins,
+                           UINT             nRays,
+                           const Vec3f&     rDirection,
+                           JRTTraceContext* pContext,
+                           TootleRayHit**   ppHitArrays,
+                           UINT*            pnHits) const;
+
     /// Locates the position at which the given ray hits the scene bounding box.
     /// Returns false if the ray misses the bounding box
     bool GetSceneBBHit(const Vec3f& rOrigin, const Vec3f& rDirection, Vec3f* pHitPt);
 
     const JRTBoundingBox& GetSceneBB() const;
 
+    /// Returns the build time and quality statistics of the KD tree
+    const JRTKDTreeStats& GetTreeStats() const
+    {
+        return m_treeStats;
+    };
+
 private:
     JRTCore();
 
@@ -54,6 +118,8 @@ private:
     UINT          m_nArraySize;
 
     JRTKDTree* m_pTree;
+
+    JRTKDTreeStats m_treeStats;
 };
 
 #endif
\ No newline at end of file
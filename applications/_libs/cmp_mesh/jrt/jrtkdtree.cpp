@@ -349,6 +349,11 @@ bool JRTKDTree::FindFirstHit(const Vec3f&   rOrigin,
 }
 
 void JRTKDTree::CullBackfaces(const Vec3f& rViewDir, bool bCullCCW)
+{
+    CullBackfaces(rViewDir, bCullCCW, m_bBackFacing);
+}
+
+void JRTKDTree::CullBackfaces(const Vec3f& rViewDir, bool bCullCCW, bool* pBackFacing) const
 {
     Vec3f viewDir;
 
@@ -364,11 +369,23 @@ void JRTKDTree::CullBackfaces(const Vec3f& rViewDir, bool bCullCCW)
 
     for (UINT i = 0; i < m_nTriangleCount; i++)
     {
-        UINT nTriIndex   = m_pTriArray[i].nTriIndex;
-        m_bBackFacing[i] = (DotProduct(viewDir, m_pTriArray[i].pMesh->GetFaceNormal(nTriIndex)) >= 0);
+        UINT nTriIndex = m_pTriArray[i].nTriIndex;
+        pBackFacing[i] = (DotProduct(viewDir, m_pTriArray[i].pMesh->GetFaceNormal(nTriIndex)) >= 0);
     }
 }
 
+/// Doubles the size of a hit array, keeping its contents
+static void GrowHitArray(TootleRayHit** ppHitArray, UINT* pnArraySize)
+{
+    UINT          nOldArraySize = *pnArraySize;
+    TootleRayHit* pTemp         = new TootleRayHit[2 * nOldArraySize];
+
+    memcpy(pTemp, *ppHitArray, nOldArraySize * sizeof(TootleRayHit));
+    delete[] *ppHitArray;
+    *ppHitArray  = pTemp;
+    *pnArraySize = 2 * nOldArraySize;
+}
+
 /// This method traces the given ray through the KD tree and locates all ray hits.  The hits are placed
 /// into the given array, which may be re-sized if necessary
 /// \param rOrigin Ray origin
@@ -377,6 +394,43 @@ void JRTKDTree::CullBackfaces(const Vec3f& rViewDir, bool bCullCCW)
 /// \param pnArraySize  A pointer to the array size
 /// \return The number of hits that were found.  Returns JRTKDTree::OUT_OF_MEMORY if out of memory
 UINT JRTKDTree::FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, TootleRayHit** ppHitArray, UINT* pnArraySize)
+{
+    // assign a new ID to this ray
+    UINT nRayID = m_nNextRayID;
+    m_nNextRayID++;
+
+    if (m_nNextRayID == 0)
+    {
+        // handle overflow.  The mailboxes are initialized to 0, so to be fully correct
+        // we can't have any mailboxes have ID 0
+        m_nNextRayID = 1;
+    }
+
+    return TraceAllHits(rOrigin, rDirection, nRayID, m_pMailboxes, m_bBackFacing, ppHitArray, pnArraySize);
+}
+
+/// \param rOrigin Ray origin
+/// \param rDirection Ray direction
+/// \param pContext  Traversal state of the calling thread.  The hits are placed in its first hit buffer
+/// \return The number of hits that were found.  Returns JRTKDTree::OUT_OF_MEMORY if out of memory
+UINT JRTKDTree::FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, JRTTraceContext* pContext) const
+{
+    return TraceAllHits(rOrigin,
+                        rDirection,
+                        pContext->NextRayID(),
+                        pContext->m_pMailboxes,
+                        pContext->m_pBackFacing,
+                        &pContext->m_pHitArrays[0],
+                        &pContext->m_nArraySizes[0]);
+}
+
+UINT JRTKDTree::TraceAllHits(const Vec3f&   rOrigin,
+                             const Vec3f&   rDirection,
+                             UINT           nRayID,
+                             UINT*          pMailboxes,
+                             const bool*    pBackFacing,
+                             TootleRayHit** ppHitArray,
+                             UINT*          pnArraySize) const
 {
     // bounding box test to determine ray traversal ranges, and handle trivial rejections
     float tmin, tmax;
@@ -401,29 +455,13 @@ UINT JRTKDTree::FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, Tootl
 
     UINT nHitsFound = 0;
 
-    // assign a new ID to this ray
-    UINT nRayID = m_nNextRayID;
-    m_nNextRayID++;
-
-    if (m_nNextRayID == 0)
-    {
-        // handle overflow.  The mailboxes are initialized to 0, so to be fully correct
-        // we can't have any mailboxes have ID 0
-        m_nNextRayID = 1;
-    }
-
     float GlobalTMax = tmax;  // where the ray finally leaves the tree
 
     // compute ray direction inverse here to avoid a divide during traversal
     Vec3f inv_direction = Vec3f(1.0f / rDirection.x, 1.0f / rDirection.y, 1.0f / rDirection.z);
 
-    static float barycentrics[3];
-
-    // rather than using recursion, we're using iteration and handling the stack ourselves
-    //static float   tmin_stack[MAX_TREE_DEPTH];
-    //static float   tmax_stack[MAX_TREE_DEPTH];
-    //static UINT    node_stack[MAX_TREE_DEPTH];
-
+    // rather than using recursion, we're using iteration and handling the stack ourselves.
+    // The stack is local so that several threads can traverse the tree at once
     struct StackFrame
     {
         float tmin;
@@ -431,7 +469,7 @@ UINT JRTKDTree::FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, Tootl
         UINT  NextNode;
     };
 
-    static StackFrame traversal_stack[MAX_TREE_DEPTH];
+    StackFrame traversal_stack[MAX_TREE_DEPTH];
 
     // set up the traversal stack
     //node_stack[0] = 0;
@@ -644,7 +682,7 @@ UINT JRTKDTree::FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, Tootl
 
                     // add the second subtree to our little stack
                     // we will test it later...
-                    pFrame->NextNode = front;
+                    pFrame->NextNode = back;
                     pFrame->tmin     = tmin;
                     pFrame->tmax     = tmax;
                     pFrame++;
@@ -674,7 +712,7 @@ UINT JRTKDTree::FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, Tootl
                 UINT triIndex = m_pIndexArray[tri];
 
                 // mailbox and backfacing test
-                if (m_bBackFacing[triIndex] || m_pMailboxes[triIndex] == nRayID)
+                if (pBackFacing[triIndex] || pMailboxes[triIndex] == nRayID)
                 {
                     continue;
                 }
@@ -690,7 +728,7 @@ UINT JRTKDTree::FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, Tootl
                     JRT_ASSERT(tval >= tmin && tval <= GlobalTMax);
 
                     // set mailbox
-                    m_pMailboxes[triIndex] = nRayID;
+                    pMailboxes[triIndex] = nRayID;
 
                     // record the hit
                     (*ppHitArray)[nHitsFound].nFaceID = pTri->nTriIndex;
@@ -700,14 +738,7 @@ UINT JRTKDTree::FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, Tootl
                     // grow hit array if needed
                     if (*pnArraySize == nHitsFound)
                     {
-                        // grow array
-                        UINT nOldArraySize  = *pnArraySize;
-                        *pnArraySize        = 2 * (*pnArraySize);
-                        TootleRayHit* pTemp = new TootleRayHit[*pnArraySize];
-
-                        memcpy(pTemp, *ppHitArray, nOldArraySize * sizeof(TootleRayHit));
-                        delete[] *ppHitArray;
-                        *ppHitArray = pTemp;
+                        GrowHitArray(ppHitArray, pnArraySize);
                     }
                 }
             }
@@ -726,6 +757,309 @@ UINT JRTKDTree::FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, Tootl
     return nHitsFound;
 }
 
+/// Traces a packet of parallel rays through the tree together.  The rays share the node fetches and
+/// the triangle data of each leaf, and each ray visits exactly the nodes the single ray traversal in
+/// TraceAllHits would visit, so both find the same hits.
+/// \param pOrigins    The ray origins
+/// \param nRays       Number of rays in the packet, at most JRTTraceContext::MAX_PACKET_SIZE
+/// \param rDirection  Direction shared by all of the rays
+/// \param pContext    Traversal state of the calling thread.  The hits of ray i are placed in its i'th hit buffer
+/// \param pnHits      Array receiving the number of hits of each ray
+/// \return False if out of memory
+bool JRTKDTree::FindAllHitsPacket(const Vec3f* pOrigins, UINT nRays, const Vec3f& rDirection, JRTTraceContext* pContext, UINT* pnHits) const
+{
+    const UINT MAX_RAYS = JRTTraceContext::MAX_PACKET_SIZE;
+    JRT_ASSERT(nRays <= MAX_RAYS);
+
+    const float EPSILON = 0.00001f;
+
+    // per ray traversal ranges, with the bounding box test handling trivial rejections
+    float tmin[MAX_RAYS];
+    float tmax[MAX_RAYS];
+    float GlobalTMax[MAX_RAYS];
+    UINT  nActive = 0;
+
+    for (UINT i = 0; i < nRays; i++)
+    {
+        pnHits[i] = 0;
+
+        if (!m_treeBounds.RayHit(pOrigins[i], rDirection, &tmin[i], &tmax[i]) || tmax[i] <= 0)
+        {
+            continue;
+        }
+
+        if (tmin[i] < 0)
+        {
+            tmin[i] = 0;
+        }
+
+        tmax[i] += EPSILON;
+        GlobalTMax[i] = tmax[i];
+        nActive |= (1 << i);
+    }
+
+    if (nActive == 0)
+    {
+        return true;
+    }
+
+    // one ID for the whole packet, the mailbox masks record which of its rays hit a triangle
+    UINT nPacketID = pContext->NextRayID();
+
+    Vec3f inv_direction = Vec3f(1.0f / rDirection.x, 1.0f / rDirection.y, 1.0f / rDirection.z);
+
+    struct StackFrame
+    {
+        float tmin[MAX_RAYS];
+        float tmax[MAX_RAYS];
+        UINT  nActive;
+        UINT  NextNode;
+    };
+
+    StackFrame  traversal_stack[MAX_TREE_DEPTH];
+    StackFrame* pFrame = traversal_stack;
+
+    UINT curr_node = 0;
+
+    for (;;)
+    {
+        // walk the tree down to a leaf
+        JRTKDNode* node = &m_pNodeArray[curr_node];
+
+        while (!node->IsLeaf())
+        {
+            UBYTE axis  = node->inner.axis;
+            UINT  front = node->inner.front_offset;
+            UINT  back  = front + 1;
+
+            float dv = rDirection[axis];
+
+            float front_tmin[MAX_RAYS], front_tmax[MAX_RAYS];
+            float back_tmin[MAX_RAYS], back_tmax[MAX_RAYS];
+            UINT  nFront = 0;
+            UINT  nBack  = 0;
+
+            // the same cases as TraceAllHits, evaluated for each ray of the packet
+            for (UINT i = 0; i < nRays; i++)
+            {
+                UINT bit = (1 << i);
+
+                if (!(nActive & bit))
+                {
+                    continue;
+                }
+
+                float ov   = pOrigins[i][axis];
+                float thit = (node->inner.position - ov) * inv_direction[axis];
+
+                bool bFront = false;
+                bool bBack  = false;
+                bool bSplit = false;  // the front and back ranges are split at thit
+
+                if (ov > node->inner.position)
+                {
+                    if (dv >= 0 || thit > tmax[i])
+                    {
+                        bFront = true;
+                    }
+                    else if (thit < tmin[i])
+                    {
+                        bBack = true;
+                    }
+                    else
+                    {
+                        bFront = bBack = bSplit = true;
+                    }
+                }
+                else if (ov < node->inner.position)
+                {
+                    if (dv <= 0 || thit > tmax[i])
+                    {
+                        bBack = true;
+                    }
+                    else if (thit < tmin[i])
+                    {
+                        bFront = true;
+                    }
+                    else
+                    {
+                        bFront = bBack = bSplit = true;
+                    }
+                }
+                else
+                {
+                    bFront = (dv >= 0);
+                    bBack  = (dv <= 0);
+                }
+
+                if (bFront)
+                {
+                    nFront |= bit;
+                    front_tmin[i] = tmin[i];
+                    front_tmax[i] = tmax[i];
+                }
+
+                if (bBack)
+                {
+                    nBack |= bit;
+                    back_tmin[i] = tmin[i];
+                    back_tmax[i] = tmax[i];
+                }
+
+                if (bSplit)
+                {
+                    // the ray goes from the side of the origin into the other side at thit
+                    if (ov > node->inner.position)
+                    {
+                        front_tmax[i] = thit;
+                        back_tmin[i]  = thit;
+                    }
+                    else
+                    {
+                        back_tmax[i]  = thit;
+                        front_tmin[i] = thit;
+                    }
+                }
+            }
+
+            // the rays are parallel, so the child nearest to them along the direction is visited first
+            bool bBackFirst = (dv > 0);
+            UINT nNear      = bBackFirst ? nBack : nFront;
+            UINT nFar       = bBackFirst ? nFront : nBack;
+
+            const float* near_tmin = bBackFirst ? back_tmin : front_tmin;
+            const float* near_tmax = bBackFirst ? back_tmax : front_tmax;
+            const float* far_tmin  = bBackFirst ? front_tmin : back_tmin;
+            const float* far_tmax  = bBackFirst ? front_tmax : back_tmax;
+
+            if (nNear && nFar)
+            {
+                // add the far subtree to the stack, we will test it later
+                JRT_ASSERT(pFrame < traversal_stack + MAX_TREE_DEPTH);
+                pFrame->NextNode = bBackFirst ? front : back;
+                pFrame->nActive  = nFar;
+
+                for (UINT i = 0; i < nRays; i++)
+                {
+                    if (nFar & (1 << i))
+                    {
+                        pFrame->tmin[i] = far_tmin[i];
+                        pFrame->tmax[i] = far_tmax[i];
+                    }
+                }
+
+                pFrame++;
+            }
+
+            if (nNear)
+            {
+                curr_node = bBackFirst ? back : front;
+                nActive   = nNear;
+
+                for (UINT i = 0; i < nRays; i++)
+                {
+                    if (nNear & (1 << i))
+                    {
+                        tmin[i] = near_tmin[i];
+                        tmax[i] = near_tmax[i];
+                    }
+                }
+            }
+            else
+            {
+                curr_node = bBackFirst ? front : back;
+                nActive   = nFar;
+
+                for (UINT i = 0; i < nRays; i++)
+                {
+                    if (nFar & (1 << i))
+                    {
+                        tmin[i] = far_tmin[i];
+                        tmax[i] = far_tmax[i];
+                    }
+                }
+            }
+
+            JRT_ASSERT(curr_node < m_nNodeCount);
+            node = &m_pNodeArray[curr_node];
+        }
+
+        // at a leaf, test each triangle against the active rays that have not hit it yet
+        int triangle_end = node->leaf.triangle_start + node->leaf.triangle_count;
+
+        for (int tri = node->leaf.triangle_start; tri < triangle_end; tri++)
+        {
+            UINT triIndex = m_pIndexArray[tri];
+
+            if (pContext->m_pBackFacing[triIndex])
+            {
+                continue;
+            }
+
+            UINT nDone = (pContext->m_pMailboxes[triIndex] == nPacketID) ? pContext->m_pMailboxMasks[triIndex] : 0;
+            UINT nTodo = nActive & ~nDone;
+
+            if (nTodo == 0)
+            {
+                continue;
+            }
+
+            const JRTCoreTriangle* pTri = &m_pTriArray[triIndex];
+
+            for (UINT i = 0; i < nRays; i++)
+            {
+                float tval;
+
+                if (!(nTodo & (1 << i)) || !RayTriangleIntersect(pTri, pOrigins[i], rDirection, tmin[i], GlobalTMax[i], &tval, NULL))
+                {
+                    continue;
+                }
+
+                JRT_ASSERT(tval >= tmin[i] && tval <= GlobalTMax[i]);
+
+                nDone |= (1 << i);
+
+                // record the hit
+                TootleRayHit** ppHitArray = &pContext->m_pHitArrays[i];
+                (*ppHitArray)[pnHits[i]].nFaceID = pTri->nTriIndex;
+                (*ppHitArray)[pnHits[i]].t       = tval;
+                pnHits[i]++;
+
+                // grow hit array if needed
+                if (pContext->m_nArraySizes[i] == pnHits[i])
+                {
+                    GrowHitArray(ppHitArray, &pContext->m_nArraySizes[i]);
+                }
+            }
+
+            // set mailbox
+            pContext->m_pMailboxes[triIndex]    = nPacketID;
+            pContext->m_pMailboxMasks[triIndex] = nDone;
+        }
+
+        // done with this leaf, continue with the last subtree that was put aside
+        if (pFrame == traversal_stack)
+        {
+            break;
+        }
+
+        pFrame--;
+        curr_node = pFrame->NextNode;
+        nActive   = pFrame->nActive;
+
+        for (UINT i = 0; i < nRays; i++)
+        {
+            if (nActive & (1 << i))
+            {
+                tmin[i] = pFrame->tmin[i];
+                tmax[i] = pFrame->tmax[i];
+            }
+        }
+    }
+
+    return true;
+}
+
 UINT JRTKDTree::GetMaxDepth() const
 {
     return RecurseMaxDepth(0);
@@ -82,6 +82,16 @@ public:
 
     UINT FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, TootleRayHit** ppHitArray, UINT* pnArraySize);
 
+    /// Computes the back-face flags for a view direction into pBackFacing, which holds one flag per triangle
+    void CullBackfaces(const Vec3f& rViewDir, bool bCullCCW, bool* pBackFacing) const;
+
+    /// Finds all hits using the traversal state in pContext.  The hits are placed in the context's first hit buffer
+    UINT FindAllHits(const Vec3f& rOrigin, const Vec3f& rDirection, JRTTraceContext* pContext) const;
+
+    /// Finds all hits for a packet of parallel rays.  The hits of ray i are placed in the context's i'th
+    /// hit buffer and their number in pnHits[i].  Returns false if out of memory
+    bool FindAllHitsPacket(const Vec3f* pOrigins, UINT nRays, const Vec3f& rDirection, JRTTraceContext* pContext, UINT* pnHits) const;
+
     UINT GetNodeCount() const
     {
         return m_nNodeCount;
@@ -117,6 +127,14 @@ public:
 private:
     UINT RecurseMaxDepth(UINT nNode) const;
 
+    UINT TraceAllHits(const Vec3f&   rOrigin,
+                      const Vec3f&   rDirection,
+                      UINT           nRayID,
+                      UINT*          pMailboxes,
+                      const bool*    pBackFacing,
+                      TootleRayHit** ppHitArray,
+                      UINT*          pnArraySize) const;
+
     friend class JRTKDTreeBuilder;
     JRTKDTree();
 
@@ -151,9 +169,8 @@ private:
 
     //****************** Ray traversal state ***********************
 
-    // this is mutable state that changes during ray traversal.  If we every want
-    // to make this thing multi-threaded, we will need to allocate this stuff seperately
-    // for each worker thread
+    // this is mutable state that changes during ray traversal.  It is only used by FindFirstHit
+    // and the FindAllHits/CullBackfaces overloads without a JRTTraceContext, threads use their own contexts
 
     // mailboxes, one per triangle.  These store the ray-id for the last ray to be tested
     // with this triangle
@@ -10,6 +10,8 @@
 #include "jrtmesh.h"
 #include "jrtcoreutils.h"
 
+#include <chrono>
+
 //
 //
 //    PartitionTriangles
@@ -136,6 +138,10 @@ void JRTKDTreeBuilder::BuildTreeImpl(const JRTBoundingBox&                  rBou
 
 JRTKDTree* JRTKDTreeBuilder::BuildTree(const std::vector<JRTMesh*>& rMeshes)
 {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    memset(&m_stats, 0, sizeof(m_stats));
+
     JRTKDTree*                      pTree = NULL;
     std::vector<JRTKDNode>          nodes;
     std::vector<UINT>               indices;
@@ -179,8 +185,9 @@ JRTKDTree* JRTKDTreeBuilder::BuildTree(const std::vector<JRTMesh*>& rMeshes)
     pTree->m_pMailboxes  = new UINT[triArray.size()];
     pTree->m_bBackFacing = new bool[triArray.size()];
 
-    // initialize the tree structure
-    pTree->m_pNodeArray = (JRTKDNode*)_aligned_malloc(sizeof(JRTKDNode) * nodes.size(), 16);
+    // initialize the tree structure.  The node array is cache line aligned so that sibling nodes which
+    // start at an even index share a cache line
+    pTree->m_pNodeArray = (JRTKDNode*)_aligned_malloc(sizeof(JRTKDNode) * nodes.size(), 64);
     pTree->m_pTriArray  = (JRTCoreTriangle*)_aligned_malloc(sizeof(JRTCoreTriangle) * triArray.size(), 16);
 
     if (!pTree->m_pNodeArray || !pTree->m_pTriArray)
@@ -224,5 +231,69 @@ JRTKDTree* JRTKDTreeBuilder::BuildTree(const std::vector<JRTMesh*>& rMeshes)
         pTree->m_bBackFacing[i] = false;
     }
 
+    ComputeStats(pTree);
+    m_stats.fBuildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
     return pTree;
+}
+
+/// Walks the tree to gather the statistics.  The SAH cost weighs each node by the probability that a ray
+/// which hits the scene box also hits the node, which is the ratio of their surface areas
+void JRTKDTreeBuilder::ComputeStats(const JRTKDTree* pTree)
+{
+    struct StackEntry
+    {
+        UINT           nNode;
+        UINT           nDepth;
+        JRTBoundingBox bounds;
+    };
+
+    const float fRootArea = Max(0.0000001f, pTree->m_treeBounds.GetSurfaceArea());
+
+    std::vector<StackEntry> stack;
+    StackEntry              root = {0, 0, pTree->m_treeBounds};
+    stack.push_back(root);
+
+    double fCost = 0;
+
+    while (!stack.empty())
+    {
+        StackEntry entry = stack.back();
+        stack.pop_back();
+
+        const JRTKDNode& rNode = pTree->m_pNodeArray[entry.nNode];
+        float            fProb = entry.bounds.GetSurfaceArea() / fRootArea;
+
+        m_stats.nNodes++;
+
+        if (rNode.IsLeaf())
+        {
+            m_stats.nLeaves++;
+            m_stats.nMaxDepth = Max(m_stats.nMaxDepth, entry.nDepth);
+            m_stats.nTriangleRefs += rNode.leaf.triangle_count;
+
+            if (rNode.leaf.triangle_count == 0)
+            {
+                m_stats.nEmptyLeaves++;
+            }
+
+            fCost += fProb * rNode.leaf.triangle_count;
+        }
+        else
+        {
+            fCost += fProb;
+
+            UINT nFront = rNode.inner.front_offset;
+
+            StackEntry front = {nFront, entry.nDepth + 1, entry.bounds};
+            StackEntry back  = {nFront + 1, entry.nDepth + 1, entry.bounds};
+            entry.bounds.Split(rNode.inner.axis, rNode.inner.position, front.bounds, back.bounds);
+            stack.push_back(front);
+            stack.push_back(back);
+        }
+    }
+
+    UINT nFullLeaves     = m_stats.nLeaves - m_stats.nEmptyLeaves;
+    m_stats.fTrisPerLeaf = nFullLeaves ? (float)m_stats.nTriangleRefs / nFullLeaves : 0.0f;
+    m_stats.fSAHCost     = (float)fCost;
 }
\ No newline at end of file
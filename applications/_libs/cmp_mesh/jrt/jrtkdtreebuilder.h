@@ -14,18 +14,47 @@ class JRTTriangle;
 class JRTKDNode;
 class JRTBoundingBox;
 
+/// \brief Statistics about a KD tree, gathered by JRTKDTreeBuilder::BuildTree
+struct JRTKDTreeStats
+{
+    double fBuildSeconds;  ///< Time spent building the tree
+    UINT   nNodes;         ///< Number of nodes reachable from the root
+    UINT   nLeaves;        ///< Number of leaves, including empty ones
+    UINT   nEmptyLeaves;   ///< Number of leaves without triangles
+    UINT   nMaxDepth;      ///< Depth of the deepest leaf
+    UINT   nTriangleRefs;  ///< Sum of the triangle counts of all leaves
+    float  fTrisPerLeaf;   ///< Average triangle count of the non-empty leaves
+    float  fSAHCost;       ///< Expected cost of tracing a ray through the scene box, in node visits and triangle tests
+};
+
 /// \brief The tree builder class is responsible for constructing a KD tree from triangle soup.
 /// The base implementation uses a stupid naive splitting heuristic
 class JRTKDTreeBuilder
 {
 public:
+    JRTKDTreeBuilder()
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+    };
+
     JRTKDTree* BuildTree(const std::vector<JRTMesh*>& rMeshes);
 
+    /// Returns the statistics of the last tree built
+    const JRTKDTreeStats& GetStats() const
+    {
+        return m_stats;
+    };
+
 protected:
     virtual void BuildTreeImpl(const JRTBoundingBox&                  rBounds,
                                const std::vector<const JRTTriangle*>& rTris,
                                std::vector<JRTKDNode>&                rNodesOut,
                                std::vector<UINT>&                     rTriIndicesOut);
+
+private:
+    void ComputeStats(const JRTKDTree* pTree);
+
+    JRTKDTreeStats m_stats;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,384 @@
+/************************************************************************************/ /**
+// Copyright (c) 2006-2024 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+****************************************************************************************/
+#include "tootlepch.h"
+#include "jrtcommon.h"
+#include "jrtkdtree.h"
+#include "jrtboundingbox.h"
+#include "jrtmesh.h"
+#include "jrtparallelkdtreebuilder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+/// Cost of an intersection test relative to a node visit
+static const float INTERSECT_COST = 1.;
+
+/// Nodes with fewer triangles than this are not split before the parallel subtree construction starts
+static const UINT MIN_TASK_TRIS = 4096;
+
+/// Number of subtrees to build in parallel.  It does not depend on the thread count, so neither does the tree
+static const UINT MAX_TASKS = 64;
+
+JRTParallelKDTreeBuilder::JRTParallelKDTreeBuilder(UINT nThreads)
+    : m_nThreads(nThreads)
+    , m_pTris(NULL)
+{
+}
+
+/// Finds the split plane with the lowest SAH cost, if it is cheaper than making a leaf
+/// \param rBounds      The node bounding box
+/// \param rTris        The triangles in the node
+/// \param eSplitAxis   Receives the axis of the split plane
+/// \param fSplitValue  Receives the position of the split plane, which is strictly inside the node
+/// \return False if the node should be a leaf
+bool JRTParallelKDTreeBuilder::FindBestSplit(const JRTBoundingBox& rBounds, const std::vector<UINT>& rTris, UINT& eSplitAxis, float& fSplitValue) const
+{
+    const UINT nTriCount = (UINT)rTris.size();
+
+    // initialize best cost to cost of not splitting
+    float fBestCost = INTERSECT_COST * nTriCount;
+    bool  bSplit    = false;
+
+    Vec3f bbSize = rBounds.GetMax() - rBounds.GetMin();
+
+    for (UINT axis = X_AXIS; axis <= Z_AXIS; axis++)
+    {
+        float fNodeMin = rBounds.GetMin()[axis];
+        float fNodeMax = rBounds.GetMax()[axis];
+        float fExtent  = fNodeMax - fNodeMin;
+
+        if (!(fExtent > 0.0f))
+        {
+            continue;
+        }
+
+        // count the triangle bounds starting and ending in each bin.  Bounds outside the node go in the end bins
+        UINT  minBins[BIN_COUNT] = {0};
+        UINT  maxBins[BIN_COUNT] = {0};
+        float fScale             = BIN_COUNT / fExtent;
+
+        for (UINT i = 0; i < nTriCount; i++)
+        {
+            const TriangleBounds& rTB = m_triBounds[rTris[i]];
+
+            float fMinBin = (rTB.fMin[axis] - fNodeMin) * fScale;
+            float fMaxBin = (rTB.fMax[axis] - fNodeMin) * fScale;
+
+            minBins[fMinBin <= 0.0f ? 0 : (fMinBin >= BIN_COUNT ? BIN_COUNT - 1 : (UINT)fMinBin)]++;
+            maxBins[fMaxBin <= 0.0f ? 0 : (fMaxBin >= BIN_COUNT ? BIN_COUNT - 1 : (UINT)fMaxBin)]++;
+        }
+
+        // surface areas as in JRTHeuristicKDTreeBuilder::LocateBestSplit, omitting the common factor of two
+        float bbSizeU  = UCOMP(bbSize, axis);
+        float bbSizeV  = VCOMP(bbSize, axis);
+        float sa_const = bbSizeU * bbSizeV;
+        float farea    = bbSizeU * bbSizeV + fExtent * bbSizeU + fExtent * bbSizeV;
+
+        if (farea == 0.0f)
+        {
+            farea = 0.00000001f;
+        }
+
+        farea = 1.0f / farea;
+
+        // sweep the planes between the bins.  Triangles starting before a plane are behind it, triangles ending
+        // after it are in front, and triangles doing both are counted on each side
+        UINT nTrisBehind  = 0;
+        UINT nTrisInFront = nTriCount;
+
+        for (UINT k = 1; k < BIN_COUNT; k++)
+        {
+            nTrisBehind += minBins[k - 1];
+            nTrisInFront -= maxBins[k - 1];
+
+            float fPosition = fNodeMin + fExtent * k / BIN_COUNT;
+
+            if (!(fPosition > fNodeMin && fPosition < fNodeMax))
+            {
+                continue;
+            }
+
+            float back_area  = sa_const + (bbSizeU + bbSizeV) * (fPosition - fNodeMin);
+            float front_area = sa_const + (bbSizeU + bbSizeV) * (fNodeMax - fPosition);
+            float cost       = 1.0f + INTERSECT_COST * farea * ((back_area * nTrisBehind) + (front_area * nTrisInFront));
+
+            if (cost < fBestCost)
+            {
+                fBestCost   = cost;
+                fSplitValue = fPosition;
+                eSplitAxis  = axis;
+                bSplit      = true;
+            }
+        }
+    }
+
+    return bSplit;
+}
+
+/// Partitions triangles the same way as the heuristic builder: triangles that straddle the plane go on both sides
+void JRTParallelKDTreeBuilder::PartitionTris(UINT eAxis, float fPosition, const std::vector<UINT>& rTris, std::vector<UINT>& rBack, std::vector<UINT>& rFront) const
+{
+    for (UINT i = 0; i < rTris.size(); i++)
+    {
+        const TriangleBounds& rTB = m_triBounds[rTris[i]];
+
+        if (rTB.fMin[eAxis] >= fPosition)
+        {
+            // its in front
+            rFront.push_back(rTris[i]);
+        }
+        else if (rTB.fMax[eAxis] < fPosition)
+        {
+            // its in back
+            rBack.push_back(rTris[i]);
+        }
+        else
+        {
+            // it straddles
+            rFront.push_back(rTris[i]);
+            rBack.push_back(rTris[i]);
+        }
+    }
+}
+
+void JRTParallelKDTreeBuilder::MakeLeaf(const JRTBoundingBox& rBounds, const std::vector<UINT>& rTris, JRTKDNode* pNode, std::vector<UINT>& rTriIndicesOut) const
+{
+    pNode->leaf.is_leaf        = true;
+    pNode->leaf.triangle_count = 0;
+    pNode->leaf.triangle_start = (UINT)rTriIndicesOut.size();
+
+    for (UINT i = 0; i < rTris.size(); i++)
+    {
+        // do robust tri-box clipping at the leaves
+        const JRTTriangle* pTri = (*m_pTris)[rTris[i]];
+
+        if (rBounds.TriangleIntersect(&pTri->GetV1(), &pTri->GetV2(), &pTri->GetV3()))
+        {
+            rTriIndicesOut.push_back(rTris[i]);
+            pNode->leaf.triangle_count++;
+        }
+    }
+}
+
+void JRTParallelKDTreeBuilder::BuildSubtree(UINT                    nDepthLimit,
+                                            const JRTBoundingBox&   rBounds,
+                                            std::vector<UINT>&      rTris,
+                                            UINT                    nNode,
+                                            std::vector<JRTKDNode>& rNodesOut,
+                                            std::vector<UINT>&      rTriIndicesOut) const
+{
+    UINT  eSplitAxis  = X_AXIS;
+    float fSplitValue = 0.0f;
+
+    if (nDepthLimit == 0 || !FindBestSplit(rBounds, rTris, eSplitAxis, fSplitValue))
+    {
+        MakeLeaf(rBounds, rTris, &rNodesOut[nNode], rTriIndicesOut);
+        return;
+    }
+
+    std::vector<UINT> backTris;
+    std::vector<UINT> frontTris;
+    PartitionTris(eSplitAxis, fSplitValue, rTris, backTris, frontTris);
+
+    // save memory
+    std::vector<UINT>().swap(rTris);
+
+    // by convention, always create front child right before back child
+    UINT nFront = (UINT)rNodesOut.size();
+    UINT nBack  = nFront + 1;
+    rNodesOut.push_back(JRTKDNode());
+    rNodesOut.push_back(JRTKDNode());
+
+    JRTKDNode* pNode          = &rNodesOut[nNode];
+    pNode->inner.is_leaf      = false;
+    pNode->inner.axis         = eSplitAxis;
+    pNode->inner.position     = fSplitValue;
+    pNode->inner.front_offset = nFront;
+
+    JRTBoundingBox front_bounds, back_bounds;
+    rBounds.Split(eSplitAxis, fSplitValue, front_bounds, back_bounds);
+
+    BuildSubtree(nDepthLimit - 1, front_bounds, frontTris, nFront, rNodesOut, rTriIndicesOut);
+    BuildSubtree(nDepthLimit - 1, back_bounds, backTris, nBack, rNodesOut, rTriIndicesOut);
+}
+
+void JRTParallelKDTreeBuilder::BuildTreeImpl(const JRTBoundingBox&                  rBounds,
+                                             const std::vector<const JRTTriangle*>& rTris,
+                                             std::vector<JRTKDNode>&                rNodesOut,
+                                             std::vector<UINT>&                     rTriIndicesOut)
+{
+    m_pTris = &rTris;
+
+    // extract triangle bounds
+    m_triBounds.resize(rTris.size());
+
+    for (UINT i = 0; i < rTris.size(); i++)
+    {
+        const Vec3f& v1 = rTris[i]->GetV1();
+        const Vec3f& v2 = rTris[i]->GetV2();
+        const Vec3f& v3 = rTris[i]->GetV3();
+
+        for (UINT axis = X_AXIS; axis <= Z_AXIS; axis++)
+        {
+            m_triBounds[i].fMin[axis] = Min(v1[axis], Min(v2[axis], v3[axis]));
+            m_triBounds[i].fMax[axis] = Max(v1[axis], Max(v2[axis], v3[axis]));
+        }
+    }
+
+    // create the root node, and an unused node so that all sibling pairs start at an even index
+    rNodesOut.push_back(JRTKDNode());
+    rNodesOut.push_back(JRTKDNode());
+    rNodesOut[1].leaf.is_leaf        = true;
+    rNodesOut[1].leaf.triangle_start = 0;
+    rNodesOut[1].leaf.triangle_count = 0;
+
+    // build the upper levels of the tree on this thread, always splitting the largest subtree, until there
+    // are enough subtrees to keep the worker threads busy
+    std::vector<BuildTask> tasks(1);
+    tasks[0].nNode       = 0;
+    tasks[0].nDepthLimit = JRTKDTree::MAX_TREE_DEPTH;
+    tasks[0].bounds      = rBounds;
+    tasks[0].tris.resize(rTris.size());
+
+    for (UINT i = 0; i < rTris.size(); i++)
+    {
+        tasks[0].tris[i] = i;
+    }
+
+    tasks[0].bSplit = FindBestSplit(tasks[0].bounds, tasks[0].tris, tasks[0].eSplitAxis, tasks[0].fSplitValue);
+
+    while (tasks.size() < MAX_TASKS)
+    {
+        UINT nLargest = (UINT)tasks.size();
+
+        for (UINT i = 0; i < tasks.size(); i++)
+        {
+            if (tasks[i].bSplit && tasks[i].nDepthLimit > 0 && tasks[i].tris.size() >= MIN_TASK_TRIS &&
+                (nLargest == tasks.size() || tasks[i].tris.size() > tasks[nLargest].tris.size()))
+            {
+                nLargest = i;
+            }
+        }
+
+        if (nLargest == tasks.size())
+        {
+            break;
+        }
+
+        BuildTask task = std::move(tasks[nLargest]);
+
+        UINT nFront = (UINT)rNodesOut.size();
+        rNodesOut.push_back(JRTKDNode());
+        rNodesOut.push_back(JRTKDNode());
+
+        JRTKDNode* pNode          = &rNodesOut[task.nNode];
+        pNode->inner.is_leaf      = false;
+        pNode->inner.axis         = task.eSplitAxis;
+        pNode->inner.position     = task.fSplitValue;
+        pNode->inner.front_offset = nFront;
+
+        BuildTask front;
+        BuildTask back;
+        front.nNode       = nFront;
+        back.nNode        = nFront + 1;
+        front.nDepthLimit = task.nDepthLimit - 1;
+        back.nDepthLimit  = task.nDepthLimit - 1;
+        task.bounds.Split(task.eSplitAxis, task.fSplitValue, front.bounds, back.bounds);
+        PartitionTris(task.eSplitAxis, task.fSplitValue, task.tris, back.tris, front.tris);
+
+        front.bSplit = FindBestSplit(front.bounds, front.tris, front.eSplitAxis, front.fSplitValue);
+        back.bSplit  = FindBestSplit(back.bounds, back.tris, back.eSplitAxis, back.fSplitValue);
+
+        tasks[nLargest] = std::move(front);
+        tasks.push_back(std::move(back));
+    }
+
+    // build the subtrees in parallel, largest first, each into arrays of its own
+    std::vector<UINT> order(tasks.size());
+
+    for (UINT i = 0; i < tasks.size(); i++)
+    {
+        order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&tasks](UINT a, UINT b) { return tasks[a].tris.size() > tasks[b].tris.size(); });
+
+    std::vector<std::vector<JRTKDNode> > subtreeNodes(tasks.size());
+    std::vector<std::vector<UINT> >      subtreeTris(tasks.size());
+    std::atomic<UINT>                    nNextTask(0);
+
+    auto worker = [&]() {
+        for (;;)
+        {
+            UINT nTask = nNextTask++;
+
+            if (nTask >= tasks.size())
+            {
+                break;
+            }
+
+            BuildTask& rTask = tasks[order[nTask]];
+            subtreeNodes[order[nTask]].push_back(JRTKDNode());
+            BuildSubtree(rTask.nDepthLimit, rTask.bounds, rTask.tris, 0, subtreeNodes[order[nTask]], subtreeTris[order[nTask]]);
+        }
+    };
+
+    UINT nThreads = m_nThreads;
+
+    if (nThreads == 0)
+    {
+        nThreads = (std::max)(1u, std::thread::hardware_concurrency());
+    }
+
+    nThreads = (std::min)(nThreads, (UINT)tasks.size());
+
+    std::vector<std::thread> threads;
+
+    for (UINT i = 1; i < nThreads; i++)
+    {
+        threads.push_back(std::thread(worker));
+    }
+
+    worker();
+
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+
+    // append the subtrees in task order.  The subtree root replaces the task node, its other nodes
+    // (which come in sibling pairs from local index 1) are appended with their offsets rebased
+    for (UINT i = 0; i < tasks.size(); i++)
+    {
+        std::vector<JRTKDNode>& rNodes = subtreeNodes[i];
+        UINT                    nBase  = (UINT)rNodesOut.size() - 1;
+        UINT                    nTris  = (UINT)rTriIndicesOut.size();
+
+        for (UINT j = 0; j < rNodes.size(); j++)
+        {
+            if (rNodes[j].IsLeaf())
+            {
+                rNodes[j].leaf.triangle_start += nTris;
+            }
+            else
+            {
+                rNodes[j].inner.front_offset += nBase;
+            }
+        }
+
+        rNodesOut[tasks[i].nNode] = rNodes[0];
+        rNodesOut.insert(rNodesOut.end(), rNodes.begin() + 1, rNodes.end());
+        rTriIndicesOut.insert(rTriIndicesOut.end(), subtreeTris[i].begin(), subtreeTris[i].end());
+
+        std::vector<JRTKDNode>().swap(rNodes);
+        std::vector<UINT>().swap(subtreeTris[i]);
+    }
+
+    std::vector<TriangleBounds>().swap(m_triBounds);
+    m_pTris = NULL;
+}
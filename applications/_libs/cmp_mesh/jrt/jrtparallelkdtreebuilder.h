@@ -0,0 +1,74 @@
+/************************************************************************************/ /**
+// Copyright (c) 2006-2024 Advanced Micro Devices, Inc. All rights reserved.
+/// \author AMD Developer Tools Team
+/// \file
+****************************************************************************************/
+#ifndef _JRT_PARALLEL_KD_TREE_BUILDER_H_
+#define _JRT_PARALLEL_KD_TREE_BUILDER_H_
+
+#include "jrtkdtreebuilder.h"
+#include "jrtboundingbox.h"
+#include "jrtcoreutils.h"
+
+/// \brief A multithreaded KD tree builder using a binned surface area heuristic.
+///
+/// Instead of sorting every triangle boundary like JRTHeuristicKDTreeBuilder, each node evaluates the SAH at
+/// BIN_COUNT - 1 evenly spaced planes per axis, from per-bin counts of the triangle bounds.  The upper levels of
+/// the tree are built first on the calling thread, then the remaining subtrees are built in parallel and appended
+/// to the node array in a fixed order, so the tree does not depend on the thread count.
+///
+/// Sibling nodes always start at an even index.  Together with the cache line alignment of the node array this
+/// keeps each pair of children in a single cache line, and each subtree is stored in depth first order.
+class JRTParallelKDTreeBuilder : public JRTKDTreeBuilder
+{
+public:
+    /// \param nThreads  Number of threads to use, 0 to use one per processor core
+    explicit JRTParallelKDTreeBuilder(UINT nThreads = 0);
+
+protected:
+    virtual void BuildTreeImpl(const JRTBoundingBox&                  rBounds,
+                               const std::vector<const JRTTriangle*>& rTris,
+                               std::vector<JRTKDNode>&                rNodesOut,
+                               std::vector<UINT>&                     rTriIndicesOut);
+
+private:
+    static const UINT BIN_COUNT = 32;
+
+    /// Triangle bounds, stored by axis
+    struct TriangleBounds
+    {
+        float fMin[3];
+        float fMax[3];
+    };
+
+    /// A subtree which is still to be built
+    struct BuildTask
+    {
+        UINT              nNode;        ///< Index of the subtree root in the node array
+        UINT              nDepthLimit;  ///< Maximum depth of the subtree
+        bool              bSplit;       ///< True if the root has a split and can be expanded further
+        UINT              eSplitAxis;
+        float             fSplitValue;
+        JRTBoundingBox    bounds;
+        std::vector<UINT> tris;
+    };
+
+    bool FindBestSplit(const JRTBoundingBox& rBounds, const std::vector<UINT>& rTris, UINT& eSplitAxis, float& fSplitValue) const;
+
+    void PartitionTris(UINT eAxis, float fPosition, const std::vector<UINT>& rTris, std::vector<UINT>& rBack, std::vector<UINT>& rFront) const;
+
+    void MakeLeaf(const JRTBoundingBox& rBounds, const std::vector<UINT>& rTris, JRTKDNode* pNode, std::vector<UINT>& rTriIndicesOut) const;
+
+    void BuildSubtree(UINT                    nDepthLimit,
+                      const JRTBoundingBox&   rBounds,
+                      std::vector<UINT>&      rTris,
+                      UINT                    nNode,
+                      std::vector<JRTKDNode>& rNodesOut,
+                      std::vector<UINT>&      rTriIndicesOut) const;
+
+    UINT                                   m_nThreads;
+    const std::vector<const JRTTriangle*>* m_pTris;
+    std::vector<TriangleBounds>            m_triBounds;
+};
+
+#endif
@@ -18,6 +18,7 @@
 #endif
 
 #include "tootleraytracer.h"
+#include "jrtkdtreebuilder.h"
 
 //=================================================================================================================================
 //
@@ -36,6 +37,12 @@ static Soup* s_pSoup = NULL;
 D3DOverdrawWindow* s_pOverdrawWindow;
 #endif
 
+/// Statistics of the KD tree built by the last ray traced overdraw computation
+static TootleRaytraceStats s_raytraceStats;
+
+/// Flag to indicate whether s_raytraceStats holds the statistics of a tree
+static bool s_bRaytraceStats = false;
+
 /// If number of clusters is higher than this, use the raytracing algorithm
 const UINT RAYTRACE_CLUSTER_THRESHOLD = 225;
 
@@ -47,6 +54,28 @@ const UINT RAYTRACE_CLUSTER_THRESHOLD = 225;
 // compute face normals for the mesh.
 static std::vector<float> ComputeFaceNormals(const float* pfVB, const unsigned int* pnIB, unsigned int nFaces);
 
+//=================================================================================================================================
+/// Keeps the statistics of the KD tree just built by a ray tracer, for TootleGetRaytraceStats
+//=================================================================================================================================
+static void SaveRaytraceStats(const TootleRaytracer& rTracer)
+{
+    JRTKDTreeStats treeStats;
+
+    if (!rTracer.GetTreeStats(&treeStats))
+    {
+        return;
+    }
+
+    s_raytraceStats.fBuildSeconds = treeStats.fBuildSeconds;
+    s_raytraceStats.nNodes        = treeStats.nNodes;
+    s_raytraceStats.nLeaves       = treeStats.nLeaves;
+    s_raytraceStats.nEmptyLeaves  = treeStats.nEmptyLeaves;
+    s_raytraceStats.nMaxDepth     = treeStats.nMaxDepth;
+    s_raytraceStats.fTrisPerLeaf  = treeStats.fTrisPerLeaf;
+    s_raytraceStats.fSAHCost      = treeStats.fSAHCost;
+    s_bRaytraceStats              = true;
+}
+
 //=================================================================================================================================
 /// Computes the overdraw graph using the ray tracing implementation
 ///
@@ -98,6 +127,8 @@ TootleResult ODComputeGraphRaytrace(const float*            pViewpoints,
         return TOOTLE_OUT_OF_MEMORY;
     }
 
+    SaveRaytraceStats(tr);
+
     // generate the per-cluster overdraw table
     if (!tr.CalculateOverdraw(pViewpoints, nViewpoints, TOOTLE_RAYTRACE_IMAGE_SIZE, bCullCCW, &fullgraph))
     {
@@ -224,6 +255,21 @@ bool ODIsInitialized()
 #endif
 }
 
+//=================================================================================================================================
+/// \param pStatsOut  Receives the statistics of the KD tree built by the last ray traced overdraw computation
+/// \return False if no overdraw has been computed by ray tracing
+//=================================================================================================================================
+bool ODGetRaytraceStats(TootleRaytraceStats* pStatsOut)
+{
+    if (!s_bRaytraceStats)
+    {
+        return false;
+    }
+
+    *pStatsOut = s_raytraceStats;
+    return true;
+}
+
 //=================================================================================================================================
 /// Sets the triangle soup that will be used for the overdraw computations
 /// It is not necessary to call this method again when the contents of the soup changes.  This will be done
@@ -339,6 +385,8 @@ TootleResult ODObjectOverdrawRaytrace(const float*        pfVB,
         return TOOTLE_OUT_OF_MEMORY;
     }
 
+    SaveRaytraceStats(tr);
+
     // generate the per-cluster overdraw table
     if (!tr.MeasureOverdraw(pViewpoints, nViewpoints, TOOTLE_RAYTRACE_IMAGE_SIZE, bCullCCW, fAvgOD, fMaxOD))
     {
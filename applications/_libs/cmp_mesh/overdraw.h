@@ -41,6 +41,9 @@ TootleResult ODOverdrawGraph(const float*            pViewpoints,
                              std::vector<t_edge>&    rGraphOut,
                              TootleOverdrawOptimizer eOverdrawOptimizer);
 
+/// Returns the statistics of the KD tree built by the last ray traced overdraw computation
+bool ODGetRaytraceStats(TootleRaytraceStats* pStatsOut);
+
 void ODCleanup();
 
 #endif
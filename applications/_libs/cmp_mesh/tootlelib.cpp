@@ -2089,3 +2089,27 @@ TootleResult TOOTLE_DLL TootleOptimizeVertexMemory(const void*         pVB,
 
     AMD_TOOTLE_API_FUNCTION_END
 }
+
+//=================================================================================================================================
+/// Returns the statistics of the KD tree built by the last ray traced overdraw computation
+///
+/// \param pStatsOut  Receives the statistics
+///
+/// \return TOOTLE_INVALID_ARGS if pStatsOut is NULL or no overdraw has been computed by ray tracing, otherwise TOOTLE_OK
+//=================================================================================================================================
+TootleResult TOOTLE_DLL TootleGetRaytraceStats(TootleRaytraceStats* pStatsOut)
+{
+    if (!pStatsOut)
+    {
+        errorf(("TootleGetRaytraceStats: pStatsOut is NULL"));
+
+        return TOOTLE_INVALID_ARGS;
+    }
+
+    if (!ODGetRaytraceStats(pStatsOut))
+    {
+        return TOOTLE_INVALID_ARGS;
+    }
+
+    return TOOTLE_OK;
+}
@@ -71,6 +71,18 @@ enum TootleOverdrawOptimizer
     TOOTLE_OVERDRAW_FAST           ///< Use a fast approximation algorithm (from SIGGRAPH 2007) to reorder clusters.
 };
 
+/// Statistics of the KD tree the ray tracer builds for an overdraw computation
+struct TootleRaytraceStats
+{
+    double       fBuildSeconds;  ///< Time spent building the tree
+    unsigned int nNodes;         ///< Number of nodes reachable from the root
+    unsigned int nLeaves;        ///< Number of leaves, including empty ones
+    unsigned int nEmptyLeaves;   ///< Number of leaves without triangles
+    unsigned int nMaxDepth;      ///< Depth of the deepest leaf
+    float        fTrisPerLeaf;   ///< Average triangle count of the non-empty leaves
+    float        fSAHCost;       ///< Expected cost of tracing a ray through the scene box, in node visits and triangle tests
+};
+
 //=================================================================================================================================
 /// \brief Performs one-time initialization required by Tootle
 //=================================================================================================================================
@@ -424,6 +436,16 @@ TootleResult TOOTLE_DLL TootleOptimizeVertexMemory(const void*         pVB,
                                                    unsigned int*       pnIBOut,
                                                    unsigned int*       pnVertexRemapOut);
 
+//=================================================================================================================================
+/// Returns the build time and traversal quality of the KD tree built by the last overdraw optimization or measurement that
+///  used ray tracing.
+///
+/// \param pStatsOut            Receives the statistics.  May not be NULL.
+///
+/// \return Possible return codes: TOOTLE_INVALID_ARGS if no overdraw has been computed by ray tracing, or TOOTLE_OK
+//=================================================================================================================================
+TootleResult TOOTLE_DLL TootleGetRaytraceStats(TootleRaytraceStats* pStatsOut);
+
 // @}
 
 #endif
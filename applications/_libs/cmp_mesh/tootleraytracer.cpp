@@ -19,6 +19,16 @@
 #include "jrtppmimage.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <thread>
+
+// pixels are traced in tiles of TILE_SIZE x TILE_SIZE, which must fit in a ray packet
+static const UINT TILE_SIZE = 4;
+static_assert(TILE_SIZE * TILE_SIZE <= JRTTraceContext::MAX_PACKET_SIZE, "pixel tiles must fit in a ray packet");
+
 // function defined by Tootle that is called to process ray hits for each pixel
 extern void ProcessPixel(TootleRayHit*, int);
 
@@ -26,6 +36,8 @@ TootleRaytracer::TootleRaytracer()
     : m_pMesh(NULL)
     , m_pCore(NULL)
     , m_pFaceClusters(0)
+    , m_nThreads(0)
+    , m_bPacketTracing(true)
 {
 }
 
@@ -102,17 +114,7 @@ bool TootleRaytracer::Init(const float* pVertexPositions,
 //=================================================================================================================================
 bool TootleRaytracer::CalculateOverdraw(const float* pViewpoints, UINT nViewpoints, UINT nImageSize, bool bCullCCW, TootleOverdrawTable* pODArray)
 {
-    for (UINT i = 0; i < nViewpoints; i++)
-    {
-        if (!ProcessViewpoint(pViewpoints, nImageSize, bCullCCW, pODArray))
-        {
-            return false;
-        }
-
-        pViewpoints += 3;
-    }
-
-    return true;
+    return TraceViewpoints(pViewpoints, nViewpoints, nImageSize, bCullCCW, pODArray, NULL, NULL);
 }
 
 //=================================================================================================================================
@@ -137,27 +139,26 @@ bool TootleRaytracer::MeasureOverdraw(const float* pViewpoints, UINT nViewpoints
     fAvgODOut = 0;
     fMaxODOut = 0;
 
+    std::vector<UINT> pixelHit(nViewpoints, 0);
+    std::vector<UINT> pixelDrawn(nViewpoints, 0);
+
+    if (!TraceViewpoints(pViewpoints, nViewpoints, nImageSize, bCullCCW, NULL, pixelHit.data(), pixelDrawn.data()))
+    {
+        return false;
+    }
+
     UINT nTotalPixelHit   = 0;
     UINT nTotalPixelDrawn = 0;
-    UINT nPixelHit;
-    UINT nPixelDrawn;
 
     for (UINT i = 0; i < nViewpoints; i++)
     {
-        if (!ProcessViewpoint(pViewpoints, nImageSize, bCullCCW, nPixelHit, nPixelDrawn))
-        {
-            return false;
-        }
+        nTotalPixelHit += pixelHit[i];
+        nTotalPixelDrawn += pixelDrawn[i];
 
-        nTotalPixelHit += nPixelHit;
-        nTotalPixelDrawn += nPixelDrawn;
-
-        if (nPixelHit > 0)
+        if (pixelHit[i] > 0)
         {
-            fMaxODOut = (std::max)(fMaxODOut, (float)nPixelDrawn / nPixelHit);
+            fMaxODOut = (std::max)(fMaxODOut, (float)pixelDrawn[i] / pixelHit[i]);
         }
-
-        pViewpoints += 3;
     }
 
     if (nTotalPixelHit > 0)
@@ -183,155 +184,257 @@ void TootleRaytracer::Cleanup()
 }
 
 //=================================================================================================================================
-/// Computes overdraw from a particular viewpoint
-/// \param pCameraPosition  Camera position to use for this viewpoint.  The camera will be looking at the origin
-/// \param nImageSize       Size of the pixel grid on each axis
-/// \param bCullCCW         Set to true to cull CCW faces, otherwise cull CW faces.
-/// \param pODArray         A table that will be updated with per-cluster overdraw
-/// \return            False if out of memory.  True otherwise
+/// \param pStatsOut  Receives the statistics of the tree built by the last call to Init
+/// \return False if Init has not built a tree, or Cleanup has released it
 //=================================================================================================================================
-bool TootleRaytracer::ProcessViewpoint(const float* pCameraPosition, UINT nImageSize, bool bCullCCW, TootleOverdrawTable* pODArray)
+bool TootleRaytracer::GetTreeStats(JRTKDTreeStats* pStatsOut) const
 {
-    assert(pCameraPosition);
-
-    if (nImageSize < 1)
+    if (!m_pCore)
     {
-        nImageSize = 1;  // a strange 1x1 image
+        return false;
     }
 
-    // build camera basis vectors
-    Vec3f position(pCameraPosition);
-    position      = position;
-    Vec3f viewDir = Normalize(position) * -1.;
-    Vec3f up;
+    *pStatsOut = m_pCore->GetTreeStats();
+    return true;
+}
 
-    // Compute the up vector by performing 90 degree 2D rotation on the position vector
-    //  (choose two good component vectors).
-    if ((position[1] * position[1]) < (position[0] * position[0]))
+//=================================================================================================================================
+/// \param nThreads  Number of threads used by CalculateOverdraw and MeasureOverdraw, 0 to use one per processor core
+//=================================================================================================================================
+void TootleRaytracer::SetThreadCount(UINT nThreads)
+{
+    m_nThreads = nThreads;
+}
+
+//=================================================================================================================================
+/// \param bPacketTracing  True to trace tiles of pixels as ray packets, false to trace one ray at a time.  Both give the same results
+//=================================================================================================================================
+void TootleRaytracer::SetPacketTracing(bool bPacketTracing)
+{
+    m_bPacketTracing = bPacketTracing;
+}
+
+//=================================================================================================================================
+/// Traces a set of viewpoints on the worker threads.
+///
+/// Each viewpoint is divided into bands of rows when there are fewer viewpoints than threads.  The threads take the bands in
+/// viewpoint order, each with its own traversal context, and only recompute the backface flags when they move to another
+/// viewpoint.  Overdraw tables are accumulated per thread and added into pODArray at the end.
+///
+/// \param pViewpoints   Array of viewpoints to use
+/// \param nViewpoints   The size of this array
+/// \param nImageSize    The size of the pixel grid on each axis
+/// \param bCullCCW      Set to true to cull CCW faces, otherwise cull CW faces.
+/// \param pODArray      Overdraw table to update, or NULL to measure the overdraw
+/// \param pnPixelHit    When measuring, an array receiving the number of pixels hit for each viewpoint
+/// \param pnPixelDrawn  When measuring, an array receiving the number of pixels drawn for each viewpoint
+/// \return              False if out of memory.  True otherwise
+//=================================================================================================================================
+bool TootleRaytracer::TraceViewpoints(const float*         pViewpoints,
+                                      UINT                 nViewpoints,
+                                      UINT                 nImageSize,
+                                      bool                 bCullCCW,
+                                      TootleOverdrawTable* pODArray,
+                                      UINT*                pnPixelHit,
+                                      UINT*                pnPixelDrawn)
+{
+    assert(pViewpoints || nViewpoints == 0);
+
+    if (nViewpoints == 0)
     {
-        up[0] = -position[2];
-        up[1] = 0;
-        up[2] = position[0];
+        return true;
     }
-    else
+
+    if (nImageSize < 1)
     {
-        up[0] = 0;
-        up[1] = position[2];
-        up[2] = -position[1];
+        nImageSize = 1;  // a strange 1x1 image
     }
 
-    up = Normalize(up);
+    UINT nThreads = m_nThreads;
 
-    // choose viewport size:
-    // transform bounding box corners into viewing space
-    // as we do this, track the bounding square of the x and y coordinates
-    // we will take the size of the larger dimension to be the viewport size
-    Vec3f corners[8];
-    m_pCore->GetSceneBB().GetCorners(corners);
+    if (nThreads == 0)
+    {
+        nThreads = (std::max)(1u, std::thread::hardware_concurrency());
+    }
 
-    Matrix4f mLookAt = MatrixLookAt(position, Vec3f(0, 0, 0), up);
-    float    xmin = FLT_MAX, xmax = -FLT_MAX, ymin = FLT_MAX, ymax = -FLT_MAX;
+#ifdef DEBUG_IMAGES
+    nThreads = 1;  // the debug images are written one viewpoint at a time
+#endif
 
-    for (int i = 0; i < 8; i++)
+    // split the viewpoints into enough bands for all threads.  Bands are a multiple of the packet tile height
+    UINT nBands = 1;
+
+    if (nViewpoints < 2 * nThreads)
     {
-        TransformVector(&corners[i], &mLookAt, &corners[i]);
-        xmin = Min(xmin, corners[i].x);
-        xmax = Max(xmax, corners[i].x);
-        ymin = Min(ymin, corners[i].y);
-        ymax = Max(ymax, corners[i].y);
+        nBands = (2 * nThreads + nViewpoints - 1) / nViewpoints;
     }
 
-    float fViewSize = Max(xmax - xmin, ymax - ymin) * 2;
-    //float fViewSize = sqrt(pow(xmax-xmin,2) + pow(ymax-ymin,2)); //Max( xmax - xmin, ymax - ymin );
+#ifdef DEBUG_IMAGES
+    nBands = 1;
+#endif
 
-    // build the camera
-    JRTOrthoCamera camera(position, viewDir, up, fViewSize);
+    UINT nBandRows = (nImageSize + nBands - 1) / nBands;
+    nBandRows      = (nBandRows + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE;
+    nBands         = (nImageSize + nBandRows - 1) / nBandRows;
 
-    // cull backfaces
-    m_pCore->CullBackfaces(viewDir, bCullCCW);
+    const UINT nItems = nViewpoints * nBands;
+    nThreads          = (std::min)(nThreads, nItems);
 
-    // iterate over the pixels that we're interested in
-    float delta = 1.0f / nImageSize;
-    float s     = 0;
-    float t     = 0;
+    std::vector<UINT> itemPixelHit(nItems, 0);
+    std::vector<UINT> itemPixelDrawn(nItems, 0);
 
-#ifdef DEBUG_IMAGES
-    JRTPPMImage img(nImageSize, nImageSize);
-#endif
+    std::atomic<UINT> nNextItem(0);
+    std::atomic<bool> bOutOfMemory(false);
+    std::mutex        mergeMutex;
 
-    for (int i = 0; i < (int)nImageSize; i++)
-    {
-        for (int j = 0; j < (int)nImageSize; j++)
+    auto worker = [&]() {
+        JRTTraceContext* pContext = m_pCore->CreateTraceContext();
+
+        if (!pContext)
         {
-            // compute the camera ray for this pixel
-            Vec3f rayOrigin, rayDirection;
-            camera.GetRay(s, t, &rayOrigin, &rayDirection);
+            bOutOfMemory = true;
+            return;
+        }
 
-            // trace through the scene data structures to find all hits
-            TootleRayHit* pHitArray = 0;
-            UINT          nHits     = 0;
+        // with several threads, each one accumulates overdraw into a table of its own
+        TootleOverdrawTable  localTable;
+        TootleOverdrawTable* pTable = pODArray;
 
-            if (!m_pCore->FindAllHits(rayOrigin, rayDirection, &pHitArray, &nHits))
+        if (pODArray && nThreads > 1)
+        {
+            try
             {
-                // ran out of memory
-                return false;
+                localTable.resize(pODArray->size());
+
+                for (size_t i = 0; i < pODArray->size(); i++)
+                {
+                    localTable[i].resize(pODArray->at(i).size(), 0);
+                }
+            }
+            catch (const std::bad_alloc&)
+            {
+                bOutOfMemory = true;
+                delete pContext;
+                return;
             }
 
-#ifdef DEBUG_IMAGES
-            float clr = nHits / 8.f;
+            pTable = &localTable;
+        }
+
+        UINT nCulledViewpoint = nViewpoints;
+
+        for (;;)
+        {
+            UINT nItem = nNextItem++;
 
-            img.SetPixel(j, i, clr, clr, clr);
+            if (nItem >= nItems || bOutOfMemory)
+            {
+                break;
+            }
 
-            /*if( nHits > 0 )
+            UINT nViewpoint = nItem / nBands;
+            UINT nFirstRow  = (nItem % nBands) * nBandRows;
+            UINT nEndRow    = (std::min)(nFirstRow + nBandRows, nImageSize);
+
+            if (!ProcessViewpoint(pViewpoints + 3 * nViewpoint,
+                                  nImageSize,
+                                  nFirstRow,
+                                  nEndRow,
+                                  bCullCCW,
+                                  nViewpoint != nCulledViewpoint,
+                                  pContext,
+                                  pTable,
+                                  itemPixelHit[nItem],
+                                  itemPixelDrawn[nItem]))
             {
-               UINT nTriIndex = pHitArray[0].nFaceID;
-               Vec3f normal = m_pMesh->GetFaceNormal( nTriIndex );
-               normal /= 2;
-               normal += Vec3f(0.5,0.5,0.5);
-               img.SetPixel( j, i, normal.x, normal.y, normal.z );
-            }*/
+                bOutOfMemory = true;
+                break;
+            }
 
-#endif
+            nCulledViewpoint = nViewpoint;
+        }
 
-            ProcessPixel(pHitArray, nHits, pODArray);
+        delete pContext;
 
-            s += delta;
+        if (pTable != pODArray && !bOutOfMemory)
+        {
+            std::lock_guard<std::mutex> lock(mergeMutex);
+
+            for (size_t i = 0; i < localTable.size(); i++)
+            {
+                for (size_t j = 0; j < localTable[i].size(); j++)
+                {
+                    (*pODArray)[i][j] += localTable[i][j];
+                }
+            }
         }
+    };
 
-        t += delta;
-        s = 0;
+    // the calling thread is one of the workers
+    std::vector<std::thread> threads;
+
+    for (UINT i = 1; i < nThreads; i++)
+    {
+        threads.push_back(std::thread(worker));
     }
 
-#ifdef DEBUG_IMAGES
-    static int nFrameNum = 0;
-    char       filename[100];
-    sprintf(filename, "C:\\images\\view_%d.ppm", nFrameNum);
-    img.SaveFile(filename);
-    nFrameNum++;
-#endif
+    worker();
+
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+
+    if (bOutOfMemory)
+    {
+        return false;
+    }
+
+    if (pnPixelHit && pnPixelDrawn)
+    {
+        for (UINT i = 0; i < nViewpoints; i++)
+        {
+            pnPixelHit[i]   = 0;
+            pnPixelDrawn[i] = 0;
+
+            for (UINT j = 0; j < nBands; j++)
+            {
+                pnPixelHit[i] += itemPixelHit[i * nBands + j];
+                pnPixelDrawn[i] += itemPixelDrawn[i * nBands + j];
+            }
+        }
+    }
 
     return true;
 }
 
 //=================================================================================================================================
-/// Measure overdraw from a particular viewpoint.
-///
+/// Computes overdraw for a band of rows seen from a particular viewpoint
 /// \param pCameraPosition  Camera position to use for this viewpoint.  The camera will be looking at the origin
 /// \param nImageSize       Size of the pixel grid on each axis
+/// \param nFirstRow        First image row to trace
+/// \param nEndRow          Row after the last image row to trace
 /// \param bCullCCW         Set to true to cull CCW faces, otherwise cull CW faces.
-/// \param fAvgODOut        A variable to receive the average overdraw per pixel.
-///
-/// \return                 False if out of memory.  True otherwise
+/// \param bUpdateCulling   True if the backface flags of pContext must be computed for this viewpoint
+/// \param pContext         Ray traversal context of the calling thread
+/// \param pODArray         A table that will be updated with per-cluster overdraw, or NULL to measure the overdraw
+/// \param nPixelHit        When measuring, incremented by the number of pixels hit
+/// \param nPixelDrawn      When measuring, incremented by the number of times these pixels are drawn
+/// \return            False if out of memory.  True otherwise
 //=================================================================================================================================
-bool TootleRaytracer::ProcessViewpoint(const float* pCameraPosition, UINT nImageSize, bool bCullCCW, UINT& nPixelHit, UINT& nPixelDrawn)
+bool TootleRaytracer::ProcessViewpoint(const float*         pCameraPosition,
+                                       UINT                 nImageSize,
+                                       UINT                 nFirstRow,
+                                       UINT                 nEndRow,
+                                       bool                 bCullCCW,
+                                       bool                 bUpdateCulling,
+                                       JRTTraceContext*     pContext,
+                                       TootleOverdrawTable* pODArray,
+                                       UINT&                nPixelHit,
+                                       UINT&                nPixelDrawn)
 {
     assert(pCameraPosition);
 
-    if (nImageSize < 1)
-    {
-        nImageSize = 1;  // a strange 1x1 image
-    }
-
     // build camera basis vectors
     Vec3f position(pCameraPosition);
     Vec3f viewDir = Normalize(position) * -1.0;
@@ -354,8 +457,6 @@ bool TootleRaytracer::ProcessViewpoint(const float* pCameraPosition, UINT nImage
 
     up = Normalize(up);
 
-    Matrix4f mLookAt = MatrixLookAt(position, Vec3f(0, 0, 0), up);
-
     // choose viewport size:
     // transform bounding box corners into viewing space
     // as we do this, track the bounding square of the x and y coordinates
@@ -363,10 +464,8 @@ bool TootleRaytracer::ProcessViewpoint(const float* pCameraPosition, UINT nImage
     Vec3f corners[8];
     m_pCore->GetSceneBB().GetCorners(corners);
 
-    float xmin = FLT_MAX;
-    float xmax = -FLT_MAX;
-    float ymin = FLT_MAX;
-    float ymax = -FLT_MAX;
+    Matrix4f mLookAt = MatrixLookAt(position, Vec3f(0, 0, 0), up);
+    float    xmin = FLT_MAX, xmax = -FLT_MAX, ymin = FLT_MAX, ymax = -FLT_MAX;
 
     for (int i = 0; i < 8; i++)
     {
@@ -384,70 +483,82 @@ bool TootleRaytracer::ProcessViewpoint(const float* pCameraPosition, UINT nImage
     JRTOrthoCamera camera(position, viewDir, up, fViewSize);
 
     // cull backfaces
-    m_pCore->CullBackfaces(viewDir, bCullCCW);
+    if (bUpdateCulling)
+    {
+        m_pCore->CullBackfaces(viewDir, bCullCCW, pContext);
+    }
 
-    // iterate over the pixels that we're interested in
+    // iterate over the pixels that we're interested in, a tile at a time.  All rays of the
+    // orthographic camera are parallel, so the tiles are traced as ray packets
     float delta = 1.0f / nImageSize;
-    float s     = 0;
-    float t     = 0;
+
 #ifdef DEBUG_IMAGES
     JRTPPMImage img(nImageSize, nImageSize);
 #endif
 
-    UINT nPixelDrawnTmp;
+    const UINT    nTileSize = m_bPacketTracing ? TILE_SIZE : 1;
+    Vec3f         rayOrigins[TILE_SIZE * TILE_SIZE];
+    Vec3f         rayDirection;
+    TootleRayHit* pHitArrays[TILE_SIZE * TILE_SIZE];
+    UINT          nHits[TILE_SIZE * TILE_SIZE];
 
-    nPixelHit   = 0;
-    nPixelDrawn = 0;
-
-    for (int i = 0; i < (int)nImageSize; i++)
+    for (UINT nTileRow = nFirstRow; nTileRow < nEndRow; nTileRow += nTileSize)
     {
-        for (int j = 0; j < (int)nImageSize; j++)
+        UINT nRows = (std::min)(nTileSize, nEndRow - nTileRow);
+
+        for (UINT nTileCol = 0; nTileCol < nImageSize; nTileCol += nTileSize)
         {
-            // compute the camera ray for this pixel
-            Vec3f rayOrigin, rayDirection;
-            camera.GetRay(s, t, &rayOrigin, &rayDirection);
+            UINT nCols = (std::min)(nTileSize, nImageSize - nTileCol);
+            UINT nRays = nRows * nCols;
 
-            // trace through the scene data structures to find all hits
-            TootleRayHit* pHitArray = 0;
-            UINT          nHits     = 0;
+            // compute the camera rays for the pixels of this tile
+            for (UINT i = 0; i < nRows; i++)
+            {
+                for (UINT j = 0; j < nCols; j++)
+                {
+                    camera.GetRay((nTileCol + j) * delta, (nTileRow + i) * delta, &rayOrigins[i * nCols + j], &rayDirection);
+                }
+            }
 
-            if (!m_pCore->FindAllHits(rayOrigin, rayDirection, &pHitArray, &nHits))
+            // trace through the scene data structures to find all hits
+            if (nRays > 1)
+            {
+                if (!m_pCore->FindAllHitsPacket(rayOrigins, nRays, rayDirection, pContext, pHitArrays, nHits))
+                {
+                    // ran out of memory
+                    return false;
+                }
+            }
+            else if (!m_pCore->FindAllHits(rayOrigins[0], rayDirection, pContext, &pHitArrays[0], &nHits[0]))
             {
                 // ran out of memory
                 return false;
             }
 
-            if (nHits > 0)
+            for (UINT i = 0; i < nRays; i++)
             {
-                nPixelHit++;
-
-                // compute the number of triangles overdrawn for the pixel
-                GetPixelDrawn(pHitArray, nHits, nPixelDrawnTmp);
-
-                nPixelDrawn += nPixelDrawnTmp;
-            }
-
 #ifdef DEBUG_IMAGES
-            float clr = nHits / 8.f;
+                float clr = nHits[i] / 8.f;
 
-            img.SetPixel(j, i, clr, clr, clr);
+                img.SetPixel(nTileCol + i % nCols, nTileRow + i / nCols, clr, clr, clr);
+#endif
 
-            /*if( nHits > 0 )
-            {
-               UINT nTriIndex = pHitArray[0].nFaceID;
-               Vec3f normal = m_pMesh->GetFaceNormal( nTriIndex );
-               normal /= 2;
-               normal += Vec3f(0.5,0.5,0.5);
-               img.SetPixel( j, i, normal.x, normal.y, normal.z );
-            }*/
+                if (pODArray)
+                {
+                    ProcessPixel(pHitArrays[i], nHits[i], pODArray);
+                }
+                else if (nHits[i] > 0)
+                {
+                    nPixelHit++;
 
-#endif
+                    // compute the number of triangles overdrawn for the pixel
+                    UINT nPixelDrawnTmp;
+                    GetPixelDrawn(pHitArrays[i], nHits[i], nPixelDrawnTmp);
 
-            s += delta;
+                    nPixelDrawn += nPixelDrawnTmp;
+                }
+            }
         }
-
-        t += delta;
-        s = 0;
     }
 
 #ifdef DEBUG_IMAGES
@@ -467,7 +578,7 @@ bool TootleRaytracer::ProcessViewpoint(const float* pCameraPosition, UINT nImage
 /// \param pODArray  A table that will be updated to take into account per-cluster overdraw discovered in this pixel
 //=================================================================================================================================
 
-void TootleRaytracer::ProcessPixel(TootleRayHit* pRayHits, UINT nHits, TootleOverdrawTable* pODArray)
+void TootleRaytracer::ProcessPixel(TootleRayHit* pRayHits, UINT nHits, TootleOverdrawTable* pODArray) const
 {
     // we are given a set of ray hits, sorted by depth
     // we can use this to adjust the compute pairwise overdraw between clusters by repeatedly marching
@@ -493,7 +604,7 @@ void TootleRaytracer::ProcessPixel(TootleRayHit* pRayHits, UINT nHits, TootleOve
 /// \param nHits            Number of hits in the array
 /// \param nPixelDrawn      The number of times this pixel is drawn by the mesh.
 //=================================================================================================================================
-void TootleRaytracer::GetPixelDrawn(TootleRayHit* pRayHits, UINT nHits, UINT& nPixelDrawn)
+void TootleRaytracer::GetPixelDrawn(TootleRayHit* pRayHits, UINT nHits, UINT& nPixelDrawn) const
 {
     assert(pRayHits);
 
@@ -10,6 +10,8 @@
 class JRTCore;
 class JRTMesh;
 class JRTOrthoCamera;
+class JRTTraceContext;
+struct JRTKDTreeStats;
 
 #include <vector>
 
@@ -43,22 +45,50 @@ public:
     /// Cleans up the internal data structures
     void Cleanup();
 
-private:
-    /// Renders the scene from a particular camera position and updates the overdraw array
-    bool ProcessViewpoint(const float* pCameraPosition, unsigned int nImageSize, bool bCullCCW, TootleOverdrawTable* pODArray);
+    /// Sets the number of threads used to trace the viewpoints.  0, the default, uses one thread per processor core
+    void SetThreadCount(unsigned int nThreads);
+
+    /// Selects whether tiles of 4x4 pixels are traced as ray packets (the default) or one ray at a time
+    void SetPacketTracing(bool bPacketTracing);
 
-    /// Renders the scene from a particular camera position and measures the overdraw
-    bool ProcessViewpoint(const float* pCameraPosition, unsigned int nImageSize, bool bCullCCW, unsigned int& nPixelHit, unsigned int& nPixelDrawn);
+    /// Copies the build time and quality statistics of the KD tree built by Init.  Returns false if there is no tree
+    bool GetTreeStats(JRTKDTreeStats* pStatsOut) const;
+
+private:
+    /// Traces all viewpoints, dividing them into bands of image rows which are processed by the worker threads.
+    /// Either updates the overdraw table, or fills pnPixelHit and pnPixelDrawn with the counts of each viewpoint
+    bool TraceViewpoints(const float*         pViewpoints,
+                         unsigned int         nViewpoints,
+                         unsigned int         nImageSize,
+                         bool                 bCullCCW,
+                         TootleOverdrawTable* pODArray,
+                         unsigned int*        pnPixelHit,
+                         unsigned int*        pnPixelDrawn);
+
+    /// Renders rows nFirstRow to nEndRow - 1 of the image seen from a particular camera position.  Updates the overdraw
+    /// table if pODArray is not NULL, otherwise adds the number of pixels hit and drawn to nPixelHit and nPixelDrawn
+    bool ProcessViewpoint(const float*         pCameraPosition,
+                          unsigned int         nImageSize,
+                          unsigned int         nFirstRow,
+                          unsigned int         nEndRow,
+                          bool                 bCullCCW,
+                          bool                 bUpdateCulling,
+                          JRTTraceContext*     pContext,
+                          TootleOverdrawTable* pODArray,
+                          unsigned int&        nPixelHit,
+                          unsigned int&        nPixelDrawn);
 
     /// Updates the overdraw table with overdraw that occurs for a particular pixel in the test image
-    void ProcessPixel(TootleRayHit* pRayHit, unsigned int nHits, TootleOverdrawTable* pODArray);
+    void ProcessPixel(TootleRayHit* pRayHit, unsigned int nHits, TootleOverdrawTable* pODArray) const;
 
     /// Compute the number of times for a particular pixel is drawn by the mesh
-    void GetPixelDrawn(TootleRayHit* pRayHits, UINT nHits, UINT& nPixelOverdrawn);
+    void GetPixelDrawn(TootleRayHit* pRayHits, UINT nHits, UINT& nPixelOverdrawn) const;
 
     const unsigned int* m_pFaceClusters;
     JRTCore*            m_pCore;
     JRTMesh*            m_pMesh;
+    unsigned int        m_nThreads;
+    bool                m_bPacketTracing;
 };
 
 #endif
\ No newline at end of file
@@ -108,6 +108,29 @@ MESHOPTIMIZER_API size_t meshopt_encodeIndexBufferBound(size_t index_count, size
  */
 MESHOPTIMIZER_API int meshopt_decodeIndexBuffer(unsigned int* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size);
 
+/**
+ * Experimental: Vertex buffer encoder
+ * Encodes vertex data into an array of bytes that is generally smaller and compresses better compared to original.
+ * Returns encoded data size on success, 0 on error; the only error condition is if buffer doesn't have enough space
+ * This function works for a single vertex stream; for multiple vertex streams, call meshopt_encodeVertexBuffer for each stream.
+ * For maximum efficiency the vertex buffer being encoded has to be quantized and optimized for locality of reference (cache/fetch) first.
+ *
+ * buffer must contain enough space for the encoded vertex buffer (use meshopt_encodeVertexBufferBound to estimate)
+ * vertex_size must be a multiple of 4 and not exceed 256
+ */
+MESHOPTIMIZER_API size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size);
+MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size);
+
+/**
+ * Experimental: Vertex buffer decoder
+ * Decodes vertex data from an array of bytes generated by meshopt_encodeVertexBuffer
+ * Returns 0 if decoding was successful, and an error code otherwise
+ * Uses SSSE3 when the CPU supports it.
+ *
+ * destination must contain enough space for the resulting vertex buffer (vertex_count * vertex_size bytes)
+ */
+MESHOPTIMIZER_API int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size);
+
 /**
  * Experimental: Mesh simplifier
  * Reduces the number of triangles in the mesh, attempting to preserve mesh appearance as much as possible
@@ -118,6 +141,21 @@ MESHOPTIMIZER_API int meshopt_decodeIndexBuffer(unsigned int* destination, size_
  */
 MESHOPTIMIZER_API size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count);
 
+/**
+ * Experimental: Mesh simplifier with a reusable setup, for LOD chains
+ * meshopt_simplifyBegin computes the vertex quadrics of the source mesh once; each meshopt_simplifyFromContext call then
+ * produces the same result as meshopt_simplify from the source indices for its target_index_count.
+ * meshopt_simplifyFromContext only reads the context, so several targets can be simplified on different threads at once.
+ *
+ * indices is referenced by the context and must stay valid until meshopt_simplifyEnd
+ * destination must contain enough space for the source index buffer (index_count elements) and must not alias indices
+ */
+struct meshopt_SimplifyContext;
+
+MESHOPTIMIZER_API struct meshopt_SimplifyContext* meshopt_simplifyBegin(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+MESHOPTIMIZER_API size_t meshopt_simplifyFromContext(unsigned int* destination, const struct meshopt_SimplifyContext* context, size_t target_index_count);
+MESHOPTIMIZER_API void meshopt_simplifyEnd(struct meshopt_SimplifyContext* context);
+
 /**
  * Experimental: Mesh stripifier
  * Converts a previously vertex cache optimized triangle list to triangle strip, stitching strips using restart index
@@ -173,10 +173,30 @@ static unsigned long long edgeId(unsigned int a, unsigned int b) {
     return (static_cast<unsigned long long>(a) << 32) | b;
 }
 
-static size_t simplifyEdgeCollapse(unsigned int* result, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_positions_stride, size_t vertex_count, size_t target_index_count) {
+// Vertex positions and the quadrics of the source mesh; these only depend on the source, so all simplification
+// targets of the same mesh can share them
+struct SimplifySetup {
+    const unsigned int* indices;
+    size_t index_count;
+    size_t vertex_count;
+
+    meshopt_Buffer<Vector3> vertex_positions;
+    meshopt_Buffer<Quadric> vertex_quadrics;
+
+    explicit SimplifySetup(size_t vertex_count)
+        : vertex_positions(vertex_count)
+        , vertex_quadrics(vertex_count) {
+    }
+};
+
+static void simplifyPrepare(SimplifySetup& setup, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_positions_stride, size_t vertex_count) {
     size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
 
-    meshopt_Buffer<Vector3> vertex_positions(vertex_count);
+    setup.indices = indices;
+    setup.index_count = index_count;
+    setup.vertex_count = vertex_count;
+
+    meshopt_Buffer<Vector3>& vertex_positions = setup.vertex_positions;
 
     for (size_t i = 0; i < vertex_count; ++i) {
         const float* v = vertex_positions_data + i * vertex_stride_float;
@@ -186,7 +206,7 @@ static size_t simplifyEdgeCollapse(unsigned int* result, const unsigned int* ind
         vertex_positions[i].z = v[2];
     }
 
-    meshopt_Buffer<Quadric> vertex_quadrics(vertex_count);
+    meshopt_Buffer<Quadric>& vertex_quadrics = setup.vertex_quadrics;
     memset(vertex_quadrics.data, 0, vertex_count * sizeof(Quadric));
 
     // face quadrics
@@ -236,6 +256,18 @@ static size_t simplifyEdgeCollapse(unsigned int* result, const unsigned int* ind
             }
         }
     }
+}
+
+static size_t simplifyEdgeCollapse(unsigned int* result, const SimplifySetup& setup, size_t target_index_count) {
+    const unsigned int* indices = setup.indices;
+    size_t index_count = setup.index_count;
+    size_t vertex_count = setup.vertex_count;
+
+    const meshopt_Buffer<Vector3>& vertex_positions = setup.vertex_positions;
+
+    // collapses accumulate quadrics, so work on a copy to keep the setup reusable
+    meshopt_Buffer<Quadric> vertex_quadrics(vertex_count);
+    memcpy(vertex_quadrics.data, setup.vertex_quadrics.data, vertex_count * sizeof(Quadric));
 
     if (result != indices) {
         for (size_t i = 0; i < index_count; ++i) {
@@ -357,5 +389,42 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
     assert(vertex_positions_stride % sizeof(float) == 0);
     assert(target_index_count <= index_count);
 
-    return simplifyEdgeCollapse(destination, indices, index_count, vertex_positions, vertex_positions_stride, vertex_count, target_index_count);
+    SimplifySetup setup(vertex_count);
+    simplifyPrepare(setup, indices, index_count, vertex_positions, vertex_positions_stride, vertex_count);
+
+    return simplifyEdgeCollapse(destination, setup, target_index_count);
+}
+
+struct meshopt_SimplifyContext {
+    meshopt::SimplifySetup setup;
+
+    explicit meshopt_SimplifyContext(size_t vertex_count)
+        : setup(vertex_count) {
+    }
+};
+
+meshopt_SimplifyContext* meshopt_simplifyBegin(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride) {
+    using namespace meshopt;
+
+    assert(index_count % 3 == 0);
+    assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+    assert(vertex_positions_stride % sizeof(float) == 0);
+
+    meshopt_SimplifyContext* context = new meshopt_SimplifyContext(vertex_count);
+    simplifyPrepare(context->setup, indices, index_count, vertex_positions, vertex_positions_stride, vertex_count);
+
+    return context;
+}
+
+size_t meshopt_simplifyFromContext(unsigned int* destination, const meshopt_SimplifyContext* context, size_t target_index_count) {
+    using namespace meshopt;
+
+    assert(context);
+    assert(target_index_count <= context->setup.index_count);
+
+    return simplifyEdgeCollapse(destination, context->setup, target_index_count);
+}
+
+void meshopt_simplifyEnd(meshopt_SimplifyContext* context) {
+    delete context;
 }
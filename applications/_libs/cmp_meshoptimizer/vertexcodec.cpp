@@ -0,0 +1,656 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <string.h>
+
+// The decoder has an SSSE3 path that is compiled in on x86/x64 and selected at runtime if the CPU supports it
+#if !defined(MESHOPTIMIZER_NO_SIMD) && (defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__))
+#define SIMD_SSE
+#endif
+
+#ifdef SIMD_SSE
+#include <tmmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SIMD_TARGET
+#else
+#include <cpuid.h>
+#define SIMD_TARGET __attribute__((target("ssse3")))
+#endif
+#endif
+
+// The vertex stream is split into blocks of up to 256 vertices; each byte of the vertex is encoded separately
+// within a block as a stream of zigzag-encoded deltas from the same byte of the previous vertex.
+// Deltas are packed in groups of 16, each group uses 0, 2, 4 or 8 bits per delta; with 2 and 4 bits the largest
+// value is a sentinel that marks a delta which is stored as a full byte after the packed bits.
+// The 2-bit group modes for all groups of a byte stream are stored in a header in front of the group data.
+namespace meshopt {
+
+const unsigned char kVertexHeader = 0xa0;
+
+const size_t kVertexBlockSizeBytes = 8192;
+const size_t kVertexBlockMaxSize = 256;
+const size_t kByteGroupSize = 16;
+const size_t kByteGroupDecodeLimit = 24;
+const size_t kTailMaxSize = 32;
+
+static size_t getVertexBlockSize(size_t vertex_size) {
+    // make sure the entire block fits into the scratch buffer
+    size_t result = kVertexBlockSizeBytes / vertex_size;
+
+    // align to byte group size; we encode each byte as a byte group
+    // if vertex block is misaligned, it results in wasted bytes, so just truncate the block size
+    result &= ~(kByteGroupSize - 1);
+
+    return (result < kVertexBlockMaxSize) ? result : kVertexBlockMaxSize;
+}
+
+static inline unsigned char zigzag8(unsigned char v) {
+    return ((signed char)(v) >> 7) ^ (v << 1);
+}
+
+static inline unsigned char unzigzag8(unsigned char v) {
+    return -(v & 1) ^ (v >> 1);
+}
+
+static bool encodeBytesGroupZero(const unsigned char* buffer) {
+    for (size_t i = 0; i < kByteGroupSize; ++i)
+        if (buffer[i])
+            return false;
+
+    return true;
+}
+
+static size_t encodeBytesGroupMeasure(const unsigned char* buffer, int bits) {
+    assert(bits >= 1 && bits <= 8);
+
+    if (bits == 1)
+        return encodeBytesGroupZero(buffer) ? 0 : size_t(-1);
+
+    if (bits == 8)
+        return kByteGroupSize;
+
+    size_t result = kByteGroupSize * bits / 8;
+
+    unsigned char sentinel = (1 << bits) - 1;
+
+    for (size_t i = 0; i < kByteGroupSize; ++i)
+        result += buffer[i] >= sentinel;
+
+    return result;
+}
+
+static unsigned char* encodeBytesGroup(unsigned char* data, const unsigned char* buffer, int bitslog2) {
+    assert(bitslog2 >= 0 && bitslog2 <= 3);
+
+    if (bitslog2 == 0)
+        return data;
+
+    if (bitslog2 == 3) {
+        memcpy(data, buffer, kByteGroupSize);
+        return data + kByteGroupSize;
+    }
+
+    int bits = 1 << bitslog2;
+    size_t byte_size = 8 / bits;
+    assert(kByteGroupSize % byte_size == 0);
+
+    // fixed portion: bits bits for each value, first value in the high bits
+    // variable portion: full byte for each out-of-range value (using 1...1 as sentinel)
+    unsigned char sentinel = (1 << bits) - 1;
+
+    for (size_t i = 0; i < kByteGroupSize; i += byte_size) {
+        unsigned char byte = 0;
+
+        for (size_t k = 0; k < byte_size; ++k) {
+            unsigned char enc = (buffer[i + k] >= sentinel) ? sentinel : buffer[i + k];
+
+            byte <<= bits;
+            byte |= enc;
+        }
+
+        *data++ = byte;
+    }
+
+    for (size_t i = 0; i < kByteGroupSize; ++i)
+        if (buffer[i] >= sentinel)
+            *data++ = buffer[i];
+
+    return data;
+}
+
+static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end, const unsigned char* buffer, size_t buffer_size) {
+    assert(buffer_size % kByteGroupSize == 0);
+
+    unsigned char* header = data;
+
+    // round number of groups to 4 to get number of header bytes
+    size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+    if (size_t(data_end - data) < header_size)
+        return 0;
+
+    data += header_size;
+
+    memset(header, 0, header_size);
+
+    for (size_t i = 0; i < buffer_size; i += kByteGroupSize) {
+        // the decoder reads kByteGroupDecodeLimit bytes per group unconditionally; the stream tail guarantees this is safe
+        if (size_t(data_end - data) < kByteGroupDecodeLimit)
+            return 0;
+
+        int best_bits = 8;
+        size_t best_size = encodeBytesGroupMeasure(buffer + i, 8);
+
+        for (int bits = 1; bits < 8; bits *= 2) {
+            size_t size = encodeBytesGroupMeasure(buffer + i, bits);
+
+            if (size < best_size) {
+                best_bits = bits;
+                best_size = size;
+            }
+        }
+
+        // bits 1 stands for the all-zero group
+        int bitslog2 = (best_bits == 1) ? 0 : (best_bits == 2) ? 1 : (best_bits == 4) ? 2 : 3;
+        assert((1 << bitslog2) == best_bits);
+
+        size_t header_offset = i / kByteGroupSize;
+
+        header[header_offset / 4] |= bitslog2 << ((header_offset % 4) * 2);
+
+        unsigned char* next = encodeBytesGroup(data, buffer + i, bitslog2);
+
+        assert(data + best_size == next);
+        data = next;
+    }
+
+    return data;
+}
+
+static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256]) {
+    assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+    unsigned char buffer[kVertexBlockMaxSize];
+    assert(sizeof(buffer) % kByteGroupSize == 0);
+
+    // we sometimes encode elements we didn't fill when rounding to kByteGroupSize
+    memset(buffer, 0, sizeof(buffer));
+
+    size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+    for (size_t k = 0; k < vertex_size; ++k) {
+        size_t vertex_offset = k;
+
+        unsigned char p = last_vertex[k];
+
+        for (size_t i = 0; i < vertex_count; ++i) {
+            buffer[i] = zigzag8(vertex_data[vertex_offset] - p);
+
+            p = vertex_data[vertex_offset];
+
+            vertex_offset += vertex_size;
+        }
+
+        data = encodeBytes(data, data_end, buffer, vertex_count_aligned);
+        if (!data)
+            return 0;
+    }
+
+    memcpy(last_vertex, &vertex_data[vertex_size * (vertex_count - 1)], vertex_size);
+
+    return data;
+}
+
+static const unsigned char* decodeBytesGroup(const unsigned char* data, unsigned char* buffer, int bitslog2) {
+    assert(bitslog2 >= 0 && bitslog2 <= 3);
+
+    if (bitslog2 == 0) {
+        memset(buffer, 0, kByteGroupSize);
+        return data;
+    }
+
+    if (bitslog2 == 3) {
+        memcpy(buffer, data, kByteGroupSize);
+        return data + kByteGroupSize;
+    }
+
+    int bits = 1 << bitslog2;
+    size_t byte_size = 8 / bits;
+
+    unsigned char sentinel = (1 << bits) - 1;
+
+    const unsigned char* data_var = data + kByteGroupSize / byte_size;
+
+    for (size_t i = 0; i < kByteGroupSize; ++i) {
+        size_t shift = 8 - bits - (i % byte_size) * bits;
+        unsigned char enc = (data[i / byte_size] >> shift) & sentinel;
+
+        buffer[i] = (enc == sentinel) ? *data_var++ : enc;
+    }
+
+    return data_var;
+}
+
+static const unsigned char* decodeBytes(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size) {
+    assert(buffer_size % kByteGroupSize == 0);
+
+    const unsigned char* header = data;
+
+    // round number of groups to 4 to get number of header bytes
+    size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+    if (size_t(data_end - data) < header_size)
+        return 0;
+
+    data += header_size;
+
+    for (size_t i = 0; i < buffer_size; i += kByteGroupSize) {
+        if (size_t(data_end - data) < kByteGroupDecodeLimit)
+            return 0;
+
+        size_t header_offset = i / kByteGroupSize;
+
+        int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+        data = decodeBytesGroup(data, buffer + i, bitslog2);
+    }
+
+    return data;
+}
+
+static const unsigned char* decodeVertexBlock(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256]) {
+    assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+    unsigned char buffer[kVertexBlockMaxSize];
+    unsigned char transposed[kVertexBlockSizeBytes];
+
+    size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+    for (size_t k = 0; k < vertex_size; ++k) {
+        data = decodeBytes(data, data_end, buffer, vertex_count_aligned);
+        if (!data)
+            return 0;
+
+        size_t vertex_offset = k;
+
+        unsigned char p = last_vertex[k];
+
+        for (size_t i = 0; i < vertex_count; ++i) {
+            unsigned char v = unzigzag8(buffer[i]) + p;
+
+            transposed[vertex_offset] = v;
+            p = v;
+
+            vertex_offset += vertex_size;
+        }
+    }
+
+    memcpy(vertex_data, transposed, vertex_count * vertex_size);
+
+    memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+    return data;
+}
+
+#ifdef SIMD_SSE
+// For each 8-bit mask of sentinel lanes: pshufb indices that gather the full bytes into those lanes, and their count
+static unsigned char kDecodeBytesGroupShuffle[256][8];
+static unsigned char kDecodeBytesGroupCount[256];
+
+static bool decodeBytesGroupBuildTables() {
+    for (int mask = 0; mask < 256; ++mask) {
+        unsigned char shuffle[8];
+        unsigned char count = 0;
+
+        for (int i = 0; i < 8; ++i) {
+            int maski = (mask >> i) & 1;
+            shuffle[i] = maski ? count : 0x80;
+            count += (unsigned char)(maski);
+        }
+
+        memcpy(kDecodeBytesGroupShuffle[mask], shuffle, 8);
+        kDecodeBytesGroupCount[mask] = count;
+    }
+
+    return true;
+}
+
+static bool decodeHasSsse3() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int cpuinfo[4] = {};
+    __cpuid(cpuinfo, 1);
+    return (cpuinfo[2] & (1 << 9)) != 0;
+#else
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    return (ecx & (1 << 9)) != 0;
+#endif
+}
+
+static const bool gDecodeSimd = decodeHasSsse3() && decodeBytesGroupBuildTables();
+
+SIMD_TARGET
+static inline __m128i decodeShuffleMask(unsigned char mask0, unsigned char mask1) {
+    __m128i sm0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kDecodeBytesGroupShuffle[mask0]));
+    __m128i sm1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kDecodeBytesGroupShuffle[mask1]));
+
+    // the second half reads the full bytes after the ones consumed by the first half; 0x80 lanes stay >= 0x80
+    __m128i sm1off = _mm_set1_epi8(kDecodeBytesGroupCount[mask0]);
+    __m128i sm1r = _mm_add_epi8(sm1, sm1off);
+
+    return _mm_unpacklo_epi64(sm0, sm1r);
+}
+
+SIMD_TARGET
+static inline const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsigned char* buffer, int bitslog2) {
+    switch (bitslog2) {
+    case 0: {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), _mm_setzero_si128());
+
+        return data;
+    }
+
+    case 1: {
+        int sel2i;
+        memcpy(&sel2i, data, 4);
+
+        __m128i sel2 = _mm_cvtsi32_si128(sel2i);
+        __m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4));
+
+        // spread 4 values per byte into one value per byte, first value from the high bits
+        __m128i sel22 = _mm_unpacklo_epi8(_mm_srli_epi16(sel2, 4), sel2);
+        __m128i sel2222 = _mm_unpacklo_epi8(_mm_srli_epi16(sel22, 2), sel22);
+        __m128i sel = _mm_and_si128(sel2222, _mm_set1_epi8(3));
+
+        __m128i mask = _mm_cmpeq_epi8(sel, _mm_set1_epi8(3));
+        int mask16 = _mm_movemask_epi8(mask);
+        unsigned char mask0 = (unsigned char)(mask16 & 255);
+        unsigned char mask1 = (unsigned char)(mask16 >> 8);
+
+        __m128i shuf = decodeShuffleMask(mask0, mask1);
+        __m128i result = _mm_or_si128(_mm_shuffle_epi8(rest, shuf), _mm_andnot_si128(mask, sel));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+        return data + 4 + kDecodeBytesGroupCount[mask0] + kDecodeBytesGroupCount[mask1];
+    }
+
+    case 2: {
+        __m128i sel4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+        __m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 8));
+
+        // spread 2 values per byte into one value per byte, first value from the high bits
+        __m128i sel44 = _mm_unpacklo_epi8(_mm_srli_epi16(sel4, 4), sel4);
+        __m128i sel = _mm_and_si128(sel44, _mm_set1_epi8(15));
+
+        __m128i mask = _mm_cmpeq_epi8(sel, _mm_set1_epi8(15));
+        int mask16 = _mm_movemask_epi8(mask);
+        unsigned char mask0 = (unsigned char)(mask16 & 255);
+        unsigned char mask1 = (unsigned char)(mask16 >> 8);
+
+        __m128i shuf = decodeShuffleMask(mask0, mask1);
+        __m128i result = _mm_or_si128(_mm_shuffle_epi8(rest, shuf), _mm_andnot_si128(mask, sel));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+        return data + 8 + kDecodeBytesGroupCount[mask0] + kDecodeBytesGroupCount[mask1];
+    }
+
+    default: {
+        __m128i result = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+        return data + 16;
+    }
+    }
+}
+
+SIMD_TARGET
+static const unsigned char* decodeBytesSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size) {
+    assert(buffer_size % kByteGroupSize == 0);
+
+    const unsigned char* header = data;
+
+    // round number of groups to 4 to get number of header bytes
+    size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+    if (size_t(data_end - data) < header_size)
+        return 0;
+
+    data += header_size;
+
+    for (size_t i = 0; i < buffer_size; i += kByteGroupSize) {
+        if (size_t(data_end - data) < kByteGroupDecodeLimit)
+            return 0;
+
+        size_t header_offset = i / kByteGroupSize;
+
+        int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+        data = decodeBytesGroupSimd(data, buffer + i, bitslog2);
+    }
+
+    return data;
+}
+
+SIMD_TARGET
+static inline __m128i unzigzag8Simd(__m128i v) {
+    __m128i xl = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi8(1)));
+    __m128i xr = _mm_and_si128(_mm_srli_epi16(v, 1), _mm_set1_epi8(127));
+
+    return _mm_xor_si128(xl, xr);
+}
+
+// Accumulates the deltas over the 4 vertices in r on top of the previous vertex p (in all lanes); returns the last vertex in all lanes
+SIMD_TARGET
+static inline __m128i prefixSumSimd(__m128i& r, __m128i p) {
+    r = _mm_add_epi8(r, _mm_slli_si128(r, 4));
+    r = _mm_add_epi8(r, _mm_slli_si128(r, 8));
+    r = _mm_add_epi8(r, p);
+
+    return _mm_shuffle_epi32(r, 0xff);
+}
+
+SIMD_TARGET
+static inline void storeVertices4Simd(unsigned char* savep, size_t vertex_size, __m128i r) {
+    for (int n = 0; n < 4; ++n) {
+        int v = _mm_cvtsi128_si32(r);
+        memcpy(savep, &v, 4);
+
+        r = _mm_srli_si128(r, 4);
+        savep += vertex_size;
+    }
+}
+
+// Decodes 4 byte streams at a time (vertex_size is a multiple of 4), then transposes 16 vertices at a time so
+// that every 32-bit lane holds 4 bytes of one vertex, which lets the delta decoding run on 4 vertices at once.
+SIMD_TARGET
+static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256]) {
+    assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+    unsigned char buffer[kVertexBlockMaxSize * 4];
+    unsigned char transposed[kVertexBlockSizeBytes];
+
+    size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+    // vertex_count_aligned never exceeds the block size, so the padding vertices still fit into transposed
+    assert(vertex_count_aligned * vertex_size <= kVertexBlockSizeBytes);
+
+    for (size_t k = 0; k < vertex_size; k += 4) {
+        for (size_t j = 0; j < 4; ++j) {
+            data = decodeBytesSimd(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+            if (!data)
+                return 0;
+        }
+
+        int pi;
+        memcpy(&pi, last_vertex + k, 4);
+
+        __m128i p = _mm_set1_epi32(pi);
+
+        for (size_t i = 0; i < vertex_count; i += 16) {
+            __m128i r0 = unzigzag8Simd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i + vertex_count_aligned * 0)));
+            __m128i r1 = unzigzag8Simd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i + vertex_count_aligned * 1)));
+            __m128i r2 = unzigzag8Simd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i + vertex_count_aligned * 2)));
+            __m128i r3 = unzigzag8Simd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i + vertex_count_aligned * 3)));
+
+            __m128i t0 = _mm_unpacklo_epi8(r0, r1);
+            __m128i t1 = _mm_unpackhi_epi8(r0, r1);
+            __m128i t2 = _mm_unpacklo_epi8(r2, r3);
+            __m128i t3 = _mm_unpackhi_epi8(r2, r3);
+
+            __m128i v0 = _mm_unpacklo_epi16(t0, t2);
+            __m128i v1 = _mm_unpackhi_epi16(t0, t2);
+            __m128i v2 = _mm_unpacklo_epi16(t1, t3);
+            __m128i v3 = _mm_unpackhi_epi16(t1, t3);
+
+            p = prefixSumSimd(v0, p);
+            p = prefixSumSimd(v1, p);
+            p = prefixSumSimd(v2, p);
+            p = prefixSumSimd(v3, p);
+
+            unsigned char* savep = transposed + i * vertex_size + k;
+
+            storeVertices4Simd(savep + vertex_size * 0, vertex_size, v0);
+            storeVertices4Simd(savep + vertex_size * 4, vertex_size, v1);
+            storeVertices4Simd(savep + vertex_size * 8, vertex_size, v2);
+            storeVertices4Simd(savep + vertex_size * 12, vertex_size, v3);
+        }
+    }
+
+    memcpy(vertex_data, transposed, vertex_count * vertex_size);
+
+    memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+    return data;
+}
+#endif
+}
+
+size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size) {
+    using namespace meshopt;
+
+    assert(vertex_size > 0 && vertex_size <= 256);
+    assert(vertex_size % 4 == 0);
+
+    const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+
+    unsigned char* data = buffer;
+    unsigned char* data_end = buffer + buffer_size;
+
+    if (size_t(data_end - data) < 1 + vertex_size)
+        return 0;
+
+    *data++ = kVertexHeader;
+
+    unsigned char last_vertex[256] = {};
+    if (vertex_count > 0)
+        memcpy(last_vertex, vertex_data, vertex_size);
+
+    size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+    size_t vertex_offset = 0;
+
+    while (vertex_offset < vertex_count) {
+        size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+        data = encodeVertexBlock(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
+        if (!data)
+            return 0;
+
+        vertex_offset += block_size;
+    }
+
+    size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+    if (size_t(data_end - data) < tail_size)
+        return 0;
+
+    // write first vertex to the end of the stream and pad it to 32 bytes; this is important to simplify bounds checks in decoder
+    if (vertex_size < kTailMaxSize) {
+        memset(data, 0, kTailMaxSize - vertex_size);
+        data += kTailMaxSize - vertex_size;
+    }
+
+    if (vertex_count > 0)
+        memcpy(data, vertex_data, vertex_size);
+    else
+        memset(data, 0, vertex_size);
+
+    data += vertex_size;
+
+    assert(data >= buffer + tail_size);
+    assert(data <= buffer + buffer_size);
+
+    return data - buffer;
+}
+
+size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size) {
+    using namespace meshopt;
+
+    assert(vertex_size > 0 && vertex_size <= 256);
+    assert(vertex_size % 4 == 0);
+
+    size_t vertex_block_size = getVertexBlockSize(vertex_size);
+    size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+    size_t vertex_block_header_size = (vertex_block_size / kByteGroupSize + 3) / 4;
+    size_t vertex_block_data_size = vertex_block_size;
+
+    size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+    return 1 + vertex_block_count * vertex_size * (vertex_block_header_size + vertex_block_data_size) + tail_size;
+}
+
+int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size) {
+    using namespace meshopt;
+
+    assert(vertex_size > 0 && vertex_size <= 256);
+    assert(vertex_size % 4 == 0);
+
+    const unsigned char* (*decode)(const unsigned char*, const unsigned char*, unsigned char*, size_t, size_t, unsigned char[256]) = decodeVertexBlock;
+
+#ifdef SIMD_SSE
+    if (gDecodeSimd)
+        decode = decodeVertexBlockSimd;
+#endif
+
+    unsigned char* vertex_data = static_cast<unsigned char*>(destination);
+
+    const unsigned char* data = buffer;
+    const unsigned char* data_end = buffer + buffer_size;
+
+    if (size_t(data_end - data) < 1 + vertex_size)
+        return -2;
+
+    if (*data++ != kVertexHeader)
+        return -1;
+
+    // the first vertex is stored at the end of the stream
+    unsigned char last_vertex[256];
+    memcpy(last_vertex, data_end - vertex_size, vertex_size);
+
+    size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+    size_t vertex_offset = 0;
+
+    while (vertex_offset < vertex_count) {
+        size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+        data = decode(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
+        if (!data)
+            return -2;
+
+        vertex_offset += block_size;
+    }
+
+    size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+    if (size_t(data_end - data) != tail_size)
+        return -3;
+
+    return 0;
+}
@@ -92,6 +92,17 @@ CMP_ERROR Plugin_CCPU_HPC::TC_GetPerformanceStats(void* pPerfStats)
     return result;
 }
 
+CMP_ERROR Plugin_CCPU_HPC::TC_GetWorkerStats(void* pWorkerStats)
+{
+    CMP_ERROR result = CMP_ERR_NOPERFSTATS;
+    if (m_pComputeBase)
+    {
+        static_cast<CCPU_HPC*>(m_pComputeBase)->GetWorkerStats(reinterpret_cast<KernelWorkerStats*>(pWorkerStats));
+        result = CMP_OK;
+    }
+    return result;
+}
+
 CMP_ERROR Plugin_CCPU_HPC::TC_GetDeviceInfo(void* pDeviceInfo)
 {
     CMP_ERROR result = CMP_ERR_NOPERFSTATS;
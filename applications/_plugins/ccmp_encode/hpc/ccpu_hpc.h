@@ -64,6 +64,7 @@ public:
     char*     TC_ComputeSourceFile();
     CMP_ERROR TC_GetPerformanceStats(void* pPerfStats);
     CMP_ERROR TC_GetDeviceInfo(void* pDeviceInfo);
+    CMP_ERROR TC_GetWorkerStats(void* pWorkerStats);
     int       TC_Close();
 
 private:
@@ -38,334 +38,234 @@
 
 #include "cmp_hpc.h"
 
-#ifdef _WIN32
-#include <strsafe.h>
-#endif
-
-#ifdef USE_ASPM_CODE
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 CompressionFunc* gCompressionFunc = CompressTexture;
 
-bool   gMultithreaded = true;
-double gCompTime      = 0.0;
-double gCompRate      = 0.0;
-int    gTexWidth      = 0;
-int    gTexHeight     = 0;
-double gError         = 0.0;
-double gError2        = 0.0;
-
-// Win32 thread API
-const int kMaxWinThreads = 64;
-
-enum EThreadState
+double gCompTime  = 0.0;
+double gCompRate  = 0.0;
+int    gTexWidth  = 0;
+int    gTexHeight = 0;
+double gError     = 0.0;
+double gError2    = 0.0;
+
+// Each thread is handed this many strips on average, so threads that finish early
+// can pick up the remaining work instead of waiting on the slowest one
+const int kStripsPerThread = 4;
+
+// How often the calling thread wakes up to report progress while workers run
+const int kProgressIntervalMS = 50;
+
+CompressThreadPool::CompressThreadPool(int threads)
+    : m_stop(false)
+    , m_job(0)
+    , m_pending(0)
+    , m_rangeFunc(NULL)
+    , m_progressFunc(NULL)
+    , m_numItems(0)
+    , m_itemsPerRange(1)
+    , m_jobThreads(0)
+    , m_nextItem(0)
+    , m_itemsDone(0)
+    , m_aborted(false)
 {
-    eThreadState_WaitForData,
-    eThreadState_DataLoaded,
-    eThreadState_Running,
-    eThreadState_Done
-};
+    if (threads <= 0)
+        threads = (int)std::thread::hardware_concurrency();
+    if (threads <= 0)
+        threads = 1;
+    m_numThreads = threads;
 
-struct WinThreadData
-{
-    EThreadState state;
-    int          threadIdx;
-    //void (*cmpFunc)(const BYTE* inBuf, BYTE* outBuf);
-    CompressionFunc* cmpFunc;
-    texture_surface  input;
-    BYTE*            output;
-
-    // Defaults..
-    WinThreadData()
-        : state(eThreadState_Done)
-        , threadIdx(-1)
-        , input()
-        , output(NULL)
-        , cmpFunc(NULL)
+    if (m_numThreads > 1)
     {
+        for (int threadIdx = 0; threadIdx < m_numThreads; threadIdx++)
+            m_workers.emplace_back(&CompressThreadPool::WorkerLoop, this, threadIdx);
     }
+}
 
-} gWinThreadData[kMaxWinThreads];
-
-HANDLE gWinThreadWorkEvent[kMaxWinThreads];
-HANDLE gWinThreadStartEvent = NULL;
-HANDLE gWinThreadDoneEvent  = NULL;
-int    gNumWinThreads       = 0;
-DWORD  gNumProcessors       = 1;  // We have at least one processor.
-DWORD  dwThreadIdArray[kMaxWinThreads];
-HANDLE hThreadArray[kMaxWinThreads];
-
-void DestroyThreads()
+CompressThreadPool::~CompressThreadPool()
 {
-    if (gMultithreaded)
     {
-        // Release all windows threads that may be active...
-        for (int i = 0; i < gNumWinThreads; i++)
-        {
-            gWinThreadData[i].state = eThreadState_Done;
-        }
-
-        // Send the event for the threads to start.
-        if (ResetEvent(gWinThreadDoneEvent) == NULL)
-        {
-            printf("DestroyThreads Error 1\n");
-        }
-
-        if (SetEvent(gWinThreadStartEvent) == NULL)
-        {
-            printf("DestroyThreads Error 2\n");
-        }
-
-        // Wait for all the threads to finish....
-        DWORD dwWaitRet = WaitForMultipleObjects(gNumWinThreads, hThreadArray, TRUE, INFINITE);
-        if (WAIT_FAILED == dwWaitRet)
-        {
-            printf("DestroyThreads() Error: WaitForMultipleObjects\n");
-        }
-
-        // !HACK! This doesn't actually do anything. There is either a bug in the
-        // Intel compiler or the windows run-time that causes the threads to not
-        // be cleaned up properly if the following two lines of code are not present.
-        // Since we're passing INFINITE to WaitForMultipleObjects, that function will
-        // never time out and per-microsoft spec, should never give this return value...
-        // Even with these lines, the bug does not consistently disappear unless you
-        // clean and rebuild. Heigenbug?
-        //
-        // If we compile with MSVC, then the following two lines are not necessary.
-        else if (WAIT_TIMEOUT == dwWaitRet)
-            OutputDebugString("DestroyThreads() -- WaitForMultipleObjects -- TIMEOUT");
-
-        // Reset the start event
-        if (ResetEvent(gWinThreadStartEvent) == NULL)
-        {
-            printf("DestroyThreads() Error:2\n");
-        }
-
-        if (SetEvent(gWinThreadDoneEvent) == NULL)
-        {
-            printf("DestroyThreads() Error:3\n");
-        }
-
-        // Close all thread handles.
-        for (int i = 0; i < gNumWinThreads; i++)
-        {
-            if (CloseHandle(hThreadArray[i]) == NULL)
-            {
-                printf("DestroyThreads() Error:3\n");
-            }
-        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
 
-        for (int i = 0; i < kMaxWinThreads; i++)
-        {
-            hThreadArray[i] = NULL;
-        }
+    for (std::thread& worker : m_workers)
+        worker.join();
+}
 
-        // Close all event handles...
-        if (CloseHandle(gWinThreadDoneEvent) == NULL)
-        {
-            printf("DestroyThreads() Error:4\n");
-        }
+void CompressThreadPool::RunRanges(int threadIdx, bool reportProgress)
+{
+    while (!m_aborted)
+    {
+        int start = m_nextItem.fetch_add(m_itemsPerRange);
+        if (start >= m_numItems)
+            break;
 
-        gWinThreadDoneEvent = NULL;
+        int end = start + m_itemsPerRange;
+        if (end > m_numItems)
+            end = m_numItems;
 
-        if (CloseHandle(gWinThreadStartEvent) == NULL)
-        {
-            printf("DestroyThreads() Error:5\n");
-        }
+        (*m_rangeFunc)(threadIdx, start, end);
+        m_itemsDone += end - start;
 
-        gWinThreadStartEvent = NULL;
+        if (reportProgress && *m_progressFunc && (*m_progressFunc)((float)m_itemsDone / m_numItems))
+            m_aborted = true;
+    }
+}
 
-        for (int i = 0; i < gNumWinThreads; i++)
+void CompressThreadPool::WorkerLoop(int threadIdx)
+{
+    int lastJob = 0;
+    for (;;)
+    {
         {
-            if (CloseHandle(gWinThreadWorkEvent[i]) == NULL)
-            {
-                printf("DestroyThreads() Error:6\n");
-            }
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_job != lastJob; });
+            if (m_stop)
+                return;
+            lastJob = m_job;
+            if (threadIdx >= m_jobThreads)
+                continue;
         }
 
-        for (int i = 0; i < kMaxWinThreads; i++)
-        {
-            gWinThreadWorkEvent[i] = NULL;
-        }
+        RunRanges(threadIdx, false);
 
-        gNumWinThreads = 0;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0)
+            m_done.notify_all();
     }
 }
 
-void CompressImageST(const texture_surface* input, BYTE* output)
+bool CompressThreadPool::Run(int numItems, int itemsPerRange, int threads, const CompressRangeFunc& rangeFunc, const CompressProgressFunc& progressFunc)
 {
-    if (gCompressionFunc == NULL)
-    {
-        printf("CompressImageST Error\n");
-        return;
-    }
+    if (numItems <= 0)
+        return true;
 
-    // Do the compression.
-    (*gCompressionFunc)(input, output);
-}
+    if (itemsPerRange < 1)
+        itemsPerRange = 1;
 
-VOID CompressImageMT(const texture_surface* input, BYTE* output)
-{
-    const int numThreads    = gNumWinThreads;
-    const int bytesPerBlock = 16;  // BC3, BC7 128 bits compressed , BC1 is 64 bits = 8 Bytes
+    const int numRanges = (numItems + itemsPerRange - 1) / itemsPerRange;
 
-    // We want to split the data evenly among all threads.
-    const int linesPerThread = (input->height + numThreads - 1) / numThreads;
+    if ((threads <= 0) || (threads > m_numThreads))
+        threads = m_numThreads;
+    if (threads > numRanges)
+        threads = numRanges;
 
-    if (gCompressionFunc == NULL)
-    {
-        printf("CompressImageMT Error!\n");
-        return;
-    }
+    m_rangeFunc     = &rangeFunc;
+    m_progressFunc  = &progressFunc;
+    m_numItems      = numItems;
+    m_itemsPerRange = itemsPerRange;
+    m_nextItem      = 0;
+    m_itemsDone     = 0;
+    m_aborted       = false;
 
-    // Load the threads.
-    for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+    if (threads == 1)
     {
-        int y_start = (linesPerThread * threadIdx) / 4 * 4;
-        int y_end   = (linesPerThread * (threadIdx + 1)) / 4 * 4;
-        if (y_end > input->height)
-            y_end = input->height;
-
-        WinThreadData* data = &gWinThreadData[threadIdx];
-        data->input         = *input;
-        data->input.ptr     = input->ptr + y_start * input->stride;
-        data->input.height  = y_end - y_start;
-        data->output        = output + (y_start / 4) * (input->width / 4) * bytesPerBlock;
-        data->cmpFunc       = gCompressionFunc;
-        data->state         = eThreadState_DataLoaded;
-        data->threadIdx     = threadIdx;
+        RunRanges(0, true);
+        return !m_aborted;
     }
 
-    // Send the event for the threads to start.
-    if (ResetEvent(gWinThreadDoneEvent) == NULL)
     {
-        printf("CompressImageMT Error 1\n");
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobThreads = threads;
+        m_pending    = threads;
+        m_job++;
     }
+    m_wake.notify_all();
 
-    if (SetEvent(gWinThreadStartEvent) == NULL)
+    // The callback is only ever called from this thread
+    float lastProgress = -1.0f;
+    for (;;)
     {
-        printf("CompressImageMT Error 2\n");
-    }
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_done.wait_for(lock, std::chrono::milliseconds(kProgressIntervalMS), [this] { return m_pending == 0; }))
+                break;
+        }
 
-    // Wait for all the threads to finish
-    if (WAIT_FAILED == WaitForMultipleObjects(numThreads, gWinThreadWorkEvent, TRUE, INFINITE))
-        printf("CompressImageDXTWIN -- WaitForMultipleObjects\n");
+        if (!progressFunc || m_aborted)
+            continue;
 
-    // Reset the start event
-    if (ResetEvent(gWinThreadStartEvent) == NULL)
-    {
+        float progress = (float)m_itemsDone / numItems;
+        if (progress != lastProgress)
+        {
+            lastProgress = progress;
+            if (progressFunc(progress))
+                m_aborted = true;
+        }
     }
 
-    if (SetEvent(gWinThreadDoneEvent) == NULL)
-    {
-    }
+    return !m_aborted;
 }
 
-DWORD WINAPI CompressImageMT_Thread(LPVOID lpParam)
+bool CompressRangesMT(int numItems, int itemsPerRange, int threads, const CompressRangeFunc& rangeFunc, const CompressProgressFunc& progressFunc)
 {
-    WinThreadData* data = (WinThreadData*)lpParam;
+    if (numItems <= 0)
+        return true;
 
-    while (data->state != eThreadState_Done)
-    {
-        if (WAIT_FAILED == WaitForSingleObject(gWinThreadStartEvent, INFINITE))
-            printf("CompressImageMT_Thread Error 1\n");
-
-        if (data->state == eThreadState_Done)
-            break;
+    if (itemsPerRange < 1)
+        itemsPerRange = 1;
 
-        data->state = eThreadState_Running;
-        (*(data->cmpFunc))(&data->input, data->output);
+    const int numRanges = (numItems + itemsPerRange - 1) / itemsPerRange;
 
-        data->state = eThreadState_WaitForData;
+    if (threads <= 0)
+        threads = (int)std::thread::hardware_concurrency();
+    if (threads > numRanges)
+        threads = numRanges;
 
-        HANDLE workEvent = gWinThreadWorkEvent[data->threadIdx];
-        if (WAIT_FAILED == SignalObjectAndWait(workEvent, gWinThreadDoneEvent, INFINITE, FALSE))
-            printf("CompressImageMT_Thread Error 2\n");
-    }
-
-    return 0;
+    CompressThreadPool pool(threads);
+    return pool.Run(numItems, itemsPerRange, threads, rangeFunc, progressFunc);
 }
 
-void Initialize()
+bool CompressStripsMT(int numBlockRows, int threads, const CompressRangeFunc& stripFunc, const CompressProgressFunc& progressFunc)
 {
-    // Make sure that the event array is set to null...
-    memset(gWinThreadWorkEvent, 0, sizeof(gWinThreadWorkEvent));
-
-    // Figure out how many cores there are on this machine
-    SYSTEM_INFO sysinfo;
-    GetSystemInfo(&sysinfo);
-    gNumProcessors = sysinfo.dwNumberOfProcessors;
+    if (threads <= 0)
+        threads = (int)std::thread::hardware_concurrency();
+    if (threads <= 0)
+        threads = 1;
 
-    // Make sure all of our threads are empty.
-    for (int i = 0; i < kMaxWinThreads; i++)
-    {
-        hThreadArray[i] = NULL;
-    }
+    int rowsPerStrip = numBlockRows / (threads * kStripsPerThread);
+    return CompressRangesMT(numBlockRows, rowsPerStrip, threads, stripFunc, progressFunc);
 }
 
-void InitWin32Threads(int numThreads)
+void CompressSTMT(const texture_surface* input, unsigned char* output, int threads)
 {
-    if (gNumWinThreads > 0)
-    {
-        return;
-    }
-
-    SetLastError(0);
-
-    // Each Processor is assigned 2 threads by default!
-    gNumWinThreads = numThreads;
-
-    if (gNumWinThreads > MAXIMUM_WAIT_OBJECTS)
-        gNumWinThreads = MAXIMUM_WAIT_OBJECTS;
-
-    printf("Num Threads %d (Max Processors %d)\n", numThreads, gNumProcessors);
-
-    // Create the synchronization events.
-    for (int i = 0; i < gNumWinThreads; i++)
-    {
-        gWinThreadWorkEvent[i] = CreateEvent(NULL, FALSE, FALSE, NULL);
-        if (gWinThreadWorkEvent[i] == NULL)
-        {
-            printf("InitWin32Threads Error 1\n");
-        }
-    }
-
-    gWinThreadStartEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-    if (gWinThreadStartEvent == NULL)
-    {
-        printf("InitWin32Threads Error 2\n");
-    }
-
-    gWinThreadDoneEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-    if (gWinThreadDoneEvent == NULL)
-    {
-        printf("InitWin32Threads Error 3\n");
-    }
+    const int bytesPerBlock = 16;  // BC3, BC7 128 bits compressed , BC1 is 64 bits = 8 Bytes
 
-    // Create threads
-    for (int threadIdx = 0; threadIdx < gNumWinThreads; threadIdx++)
+    if (gCompressionFunc == NULL)
     {
-        gWinThreadData[threadIdx].state = eThreadState_WaitForData;
-        hThreadArray[threadIdx]         = CreateThread(NULL, 0, CompressImageMT_Thread, &gWinThreadData[threadIdx], 0, &dwThreadIdArray[threadIdx]);
-        if (hThreadArray[threadIdx] == NULL)
-        {
-            printf("InitWin32Threads Error 4\n");
-        }
+        printf("CompressSTMT Error!\n");
+        return;
     }
-}
 
-VOID CompressSTMT(const texture_surface* input, BYTE* output, int threads)
-{
-    //printf("CompressSTMT %d %d\n",gNumProcessors,threads);
     // If we aren't multi-cored, then just run everything serially.
-    if ((gNumProcessors < 2) || (threads == 1))
-    {
-        gMultithreaded = false;
-        CompressImageST(input, output);
-    }
-    else
-    {
-        gMultithreaded = true;
-        CompressImageMT(input, output);
-    }
+    if (std::thread::hardware_concurrency() < 2)
+        threads = 1;
+
+    const int blocksPerRow = input->width / 4;
+    const int numBlockRows = (input->height + 3) / 4;
+
+    CompressStripsMT(
+        numBlockRows,
+        threads,
+        [&](int, int rowStart, int rowEnd) {
+            int y_start = rowStart * 4;
+            int y_end   = rowEnd * 4;
+            if (y_end > input->height)
+                y_end = input->height;
+
+            texture_surface strip = *input;
+            strip.ptr             = input->ptr + y_start * input->stride;
+            strip.height          = y_end - y_start;
+
+            (*gCompressionFunc)(&strip, output + rowStart * blocksPerRow * bytesPerBlock);
+        },
+        nullptr);
 }
-#endif
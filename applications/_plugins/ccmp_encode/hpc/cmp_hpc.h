@@ -16,6 +16,12 @@
 #define _CMP_HPC_H
 
 #include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #ifdef _WIN32
 #include <tchar.h>
@@ -49,8 +55,64 @@ extern int      gTexHeight;
 extern double   gError;
 extern double   gError2;
 
-void InitWin32Threads(int numThreads);
-void DestroyThreads();
+// Called for the items [start, end) of a range. threadIdx is in [0, threads)
+// and lets the caller keep per thread state such as an encoder instance.
+typedef std::function<void(int threadIdx, int start, int end)> CompressRangeFunc;
+
+// Called with the fraction of items done, return true to abort the compression
+typedef std::function<bool(float progress)> CompressProgressFunc;
+
+// Worker threads that are started once and then run any number of CompressRangesMT style
+// jobs. The calling thread of Run waits for the workers and reports progress.
+class CompressThreadPool
+{
+public:
+    // threads <= 0 uses all hardware threads. No worker is started for a single thread.
+    explicit CompressThreadPool(int threads);
+    ~CompressThreadPool();
+
+    int GetNumThreads() const
+    {
+        return m_numThreads;
+    }
+
+    // Splits numItems into ranges of itemsPerRange that are claimed by up to threads of
+    // the pool workers, threads <= 0 uses all of them. Returns false if aborted.
+    bool Run(int numItems, int itemsPerRange, int threads, const CompressRangeFunc& rangeFunc, const CompressProgressFunc& progressFunc);
+
+private:
+    void WorkerLoop(int threadIdx);
+    void RunRanges(int threadIdx, bool reportProgress);
+
+    int                      m_numThreads;
+    std::vector<std::thread> m_workers;
+    std::mutex               m_mutex;
+    std::condition_variable  m_wake;  // Signals workers that a job was posted or the pool stops
+    std::condition_variable  m_done;  // Signals the calling thread that a worker finished its part
+    bool                     m_stop;
+    int                      m_job;      // Incremented for each posted job
+    int                      m_pending;  // Workers still running the current job
+
+    // Current job
+    const CompressRangeFunc*    m_rangeFunc;
+    const CompressProgressFunc* m_progressFunc;
+    int                         m_numItems;
+    int                         m_itemsPerRange;
+    int                         m_jobThreads;
+    std::atomic<int>            m_nextItem;
+    std::atomic<int>            m_itemsDone;
+    std::atomic<bool>           m_aborted;
+};
+
+// Runs one job on a CompressThreadPool started for it. Splits numItems into ranges of
+// itemsPerRange that are claimed by threads workers.
+// threads <= 0 uses all hardware threads. With more than one thread the calling thread
+// waits for the workers and reports progress, otherwise it runs the ranges itself.
+// Returns false if aborted.
+bool CompressRangesMT(int numItems, int itemsPerRange, int threads, const CompressRangeFunc& rangeFunc, const CompressProgressFunc& progressFunc);
+
+// CompressRangesMT over strips of block rows, sized so each thread gets several strips
+bool CompressStripsMT(int numBlockRows, int threads, const CompressRangeFunc& stripFunc, const CompressProgressFunc& progressFunc);
 
 void CompressSTMT(const texture_surface* input, unsigned char* output, int threads);
 extern void CompressTexture(const texture_surface* input, unsigned char* output);
@@ -26,15 +26,15 @@
 #include "plugininterface.h"
 #include "cmp_plugininterface.h"
 #include "ccpu_hpc.h"
+#include "cmp_hpc.h"
+#include "cmp_blockcache.h"
 
 #include <chrono>
-#include <thread>
 
 using namespace std::chrono;
 
-#ifndef _WIN32
-#define _stdcall
-#endif
+// Block ranges handed out per encoding thread on average
+static const int kRangesPerThread = 16;
 
 //#include "debug.h"
 
@@ -43,29 +43,23 @@ char DbgTracer::buff[MAX_DBGBUFF_SIZE];
 char DbgTracer::PrintBuff[MAX_DBGPPRINTBUFF_SIZE];
 #endif
 
-unsigned int _stdcall ProcEncode(void* param)
+// Bytes per encoded block of the formats whose blocks can be reused by EncodeBlocks, 0 for
+// other formats. Their encoders read 4x4 RGBA8 texels from the source image, in rows.
+static CMP_UINT GetReusableBlockSize(CMP_FORMAT format)
 {
-    using namespace std::chrono;
-    ThreadParam* tp = (ThreadParam*)param;
-
-    //printf("Thead Active [%4x]\n",std::this_thread::get_id());
-    std::this_thread::sleep_for(std::chrono::milliseconds(0));
-
-    using namespace std::chrono;
-
-    while (tp->exit == false)
+    switch (format)
     {
-        if (tp->run == true)
-        {
-            tp->cmp_encoder->CompressBlock(tp->x, tp->y, tp->in, tp->out);
-            tp->run = false;
-        }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(0));
+    case CMP_FORMAT_BC1:
+    case CMP_FORMAT_BC4:
+        return 8;
+    case CMP_FORMAT_BC2:
+    case CMP_FORMAT_BC3:
+    case CMP_FORMAT_BC5:
+    case CMP_FORMAT_BC7:
+        return 16;
+    default:
+        return 0;
     }
-
-    // printf("Thead Closed [%x] run[%d]\n",std::this_thread::get_id(),tp->run?1:0);
-    return 0;
 }
 
 float CCPU_HPC::GetProcessElapsedTimeMS()
@@ -98,156 +92,150 @@ const char* CCPU_HPC::GetVersion()
     return m_version.c_str();
 }
 
-CodecError CCPU_HPC::CreateEncoderThreadPool()
+CMP_Encoder* CCPU_HPC::CreateEncoder()
 {
-    if (!m_ThreadCodecInitialized)
+    CMP_Encoder* encoder = (CMP_Encoder*)m_plugin_compute->TC_Create();
+    if (encoder)
     {
-        //printf("m_ThreadCodecInitialized %d\n",m_NumEncodingThreads);
-        // Create the encoding threads in the suspended state
-        for (int i = 0; i < m_NumEncodingThreads; i++)
-        {
-            m_encoder[i] = (CMP_Encoder*)m_plugin_compute->TC_Create();
-
-            // Cleanup if problem!
-            if (!m_encoder[i])
-            {
-                for (int j = 0; j < i; j++)
-                {
-                    m_plugin_compute->TC_Destroy(m_encoder[j]);
-                }
-                return CE_Unknown;
-            }
-
-            m_encoder[i]->m_quality   = m_SourceInfo.m_fquality;
-            m_encoder[i]->m_srcHeight = m_SourceInfo.m_src_height;
-            m_encoder[i]->m_srcWidth  = m_SourceInfo.m_src_width;
-            m_encoder[i]->m_xdim      = m_SourceInfo.m_width_in_blocks;
-            m_encoder[i]->m_ydim      = m_SourceInfo.m_height_in_blocks;
-            m_encoder[i]->m_zdim      = 0;
-
-            m_EncodeParameterStorage[i].cmp_encoder = m_encoder[i];
-            m_EncodeParameterStorage[i].run         = false;
-            m_EncodeParameterStorage[i].exit        = false;
-            m_EncodeParameterStorage[i].in          = NULL;
-            m_EncodeParameterStorage[i].out         = NULL;
-            m_EncodeParameterStorage[i].x           = 0;
-            m_EncodeParameterStorage[i].y           = 0;
-
-            m_EncodingThreadHandle[i] = std::thread(ProcEncode, (void*)&m_EncodeParameterStorage[i]);
-        }
-
-        m_ThreadCodecInitialized = true;
+        encoder->m_quality   = m_SourceInfo.m_fquality;
+        encoder->m_srcHeight = m_SourceInfo.m_src_height;
+        encoder->m_srcWidth  = m_SourceInfo.m_src_width;
+        encoder->m_xdim      = m_SourceInfo.m_width_in_blocks;
+        encoder->m_ydim      = m_SourceInfo.m_height_in_blocks;
+        encoder->m_zdim      = 0;
     }
+    return encoder;
+}
 
-    return CE_OK;
+void CCPU_HPC::GetWorkerStats(KernelWorkerStats* pWorkerStats)
+{
+    pWorkerStats->m_num_workers = m_num_workers;
+    for (int i = 0; i < CMP_MAX_PERF_WORKERS; i++)
+    {
+        pWorkerStats->m_worker_blocks[i] = (i < m_num_workers) ? m_worker_blocks[i] : 0;
+        pWorkerStats->m_worker_busyMS[i] = (i < m_num_workers) ? m_worker_busyMS[i] : 0.0f;
+    }
 }
 
-void CCPU_HPC::DeleteEncoderThreadPool()
+CodecError CCPU_HPC::EncodeBlocks(KernelOptions*          Options,
+                                  CMP_UINT                widthInBlocks,
+                                  CMP_UINT                heightInBlocks,
+                                  CMP_Feedback_Proc       pFeedback,
+                                  CMP_DOUBLE&             feedbackTimeMS,
+                                  std::vector<CMP_INT>&   workerBlocks,
+                                  std::vector<CMP_FLOAT>& workerBusyMS)
 {
-    // Make sure threads are not in running any state
-    // Wait for all the live threads to finish any current work
-    if (m_ThreadCodecInitialized)
+    const int numBlocks  = (int)(widthInBlocks * heightInBlocks);
+    int       numThreads = m_Use_MultiThreading ? m_NumEncodingThreads : 1;
+
+    // Several ranges per thread so threads that finish early take over the remaining work.
+    // Ranges are contiguous in the destination, so each worker writes to its own cache lines.
+    int blocksPerRange = numBlocks / (numThreads * kRangesPerThread);
+    if (blocksPerRange < 1)
+        blocksPerRange = 1;
+
+    int numRanges = (numBlocks + blocksPerRange - 1) / blocksPerRange;
+    if (numThreads > numRanges)
+        numThreads = numRanges;
+
+    // Each worker thread owns an encoder, encoders are not shared between threads
+    for (int i = 0; i < numThreads; i++)
     {
-        // Wait for Threads to exit
-        for (CMP_DWORD dwThread = 0; dwThread < m_NumEncodingThreads; dwThread++)
+        m_encoder[i] = CreateEncoder();
+        if (!m_encoder[i])
         {
-            m_EncodeParameterStorage[dwThread].exit = true;
-            std::thread& curThread                  = m_EncodingThreadHandle[dwThread];
-            curThread.join();
+            for (int j = 0; j < i; j++)
+            {
+                m_plugin_compute->TC_Destroy(m_encoder[j]);
+                m_encoder[j] = NULL;
+            }
+            return CE_Unknown;
         }
+    }
 
-        // Clean up data storage
-        for (unsigned int i = 0; i < m_NumEncodingThreads; i++)
-        {
-            if (m_encoder[i])
-                m_plugin_compute->TC_Destroy(m_encoder[i]);
-
-            m_EncodeParameterStorage[i].cmp_encoder = NULL;
+    workerBlocks.assign(numThreads, 0);
+    workerBusyMS.assign(numThreads, 0.0f);
 
-            m_EncodeParameterStorage[i].run  = false;
-            m_EncodeParameterStorage[i].exit = false;
-            m_EncodeParameterStorage[i].in   = NULL;
-            m_EncodeParameterStorage[i].out  = NULL;
-            m_EncodeParameterStorage[i].x    = 0;
-            m_EncodeParameterStorage[i].y    = 0;
-        }
+    CMP_Vec4uc*    source      = m_psource;
+    unsigned char* destination = p_destination;
 
-        m_ThreadCodecInitialized = false;
-    }
-}
+    // Uniform and repeated blocks are encoded once per worker, for the complete blocks of
+    // the formats that support it. Partial blocks are padded by the encoders.
+    const CMP_UINT              encodedSize = GetReusableBlockSize(m_current_format);
+    const CMP_UINT              srcWidth    = m_SourceInfo.m_src_width;
+    const CMP_UINT              srcHeight   = m_SourceInfo.m_src_height;
+    std::vector<CMP_BlockCache> blockCaches;
+    if (encodedSize > 0)
+        blockCaches.assign(numThreads, CMP_BlockCache(BLOCK_SIZE_4X4, sizeof(CMP_Vec4uc), encodedSize, numBlocks / numThreads));
 
-CodecError CCPU_HPC::EncodeThreadBlock(int x, int y, void* in, void* out)
-{
-    if (m_Use_MultiThreading)
-    {
-        CMP_WORD threadIndex;
+    CompressRangeFunc rangeFunc = [&](int threadIdx, int start, int end) {
+        high_resolution_clock::time_point rangeStart;
+        if (Options->getPerfStats)
+            rangeStart = high_resolution_clock::now();
 
-        // Loop and look for an available thread
-        CMP_BOOL found = false;
-        threadIndex    = 0;
-        // printf("threadIndex = %d\n",threadIndex);
-        while (found == false)
+        CMP_Encoder*    encoder    = m_encoder[threadIdx];
+        CMP_BlockCache* blockCache = blockCaches.empty() ? NULL : &blockCaches[threadIdx];
+        for (int block = start; block < end; block++)
         {
-            if (m_EncodeParameterStorage[threadIndex].run == false)
+            CMP_UINT x = block % widthInBlocks;
+            CMP_UINT y = block / widthInBlocks;
+            if (blockCache && ((x + 1) * 4 <= srcWidth) && ((y + 1) * 4 <= srcHeight))
             {
-                found = true;
-                break;
-            }
+                CMP_Vec4uc srcBlock[BLOCK_SIZE_4X4];
+                for (int row = 0; row < 4; row++)
+                {
+                    const CMP_Vec4uc* srcRow = &source[(y * 4 + row) * srcWidth + x * 4];
+                    for (int col = 0; col < 4; col++)
+                        srcBlock[row * 4 + col] = srcRow[col];
+                }
 
-            // Increment and wrap the thread index
-            threadIndex++;
-            if (threadIndex == m_NumEncodingThreads)
-            {
-                threadIndex = 0;
+                unsigned char* encoded = destination + ((size_t)y * widthInBlocks + x) * encodedSize;
+                blockCache->Encode(srcBlock, encoded, [&]() { encoder->CompressBlock(x, y, (void*)source, (void*)destination); });
             }
+            else
+                encoder->CompressBlock(x, y, (void*)source, (void*)destination);
         }
 
-        m_EncodeParameterStorage[threadIndex].x = x;
-        m_EncodeParameterStorage[threadIndex].y = y;
-
-        // point to the input data
-        m_EncodeParameterStorage[threadIndex].in = in;
-
-        // Set the output pointer for the thread to the provided location
-        m_EncodeParameterStorage[threadIndex].out = out;
+        // Each worker only touches its own entries, they are read once all workers are done
+        workerBlocks[threadIdx] += end - start;
+        if (Options->getPerfStats)
+            workerBusyMS[threadIdx] += duration<CMP_FLOAT, std::milli>(high_resolution_clock::now() - rangeStart).count();
+    };
 
-        // Tell the thread to start working
-        m_EncodeParameterStorage[threadIndex].run = true;
-    }
-    else
+    CompressProgressFunc progressFunc;
+    if (pFeedback)
     {
-        //printf("HPC Use single threaded\n");
-        // Copy the input data into the thread storage
-        // point to the input data
-        m_EncodeParameterStorage[0].in = in;
-
-        // Set the output pointer for the thread to the provided location
-        m_EncodeParameterStorage[0].out = out;
+        progressFunc = [&](float progress) {
+            if (Options->getPerfStats)
+                m_cputimer.Start(1);
 
-        m_EncodeParameterStorage[0].x = x;
-        m_EncodeParameterStorage[0].y = y;
+            bool abort = pFeedback(progress * 100.0f, NULL, NULL) ? true : false;
 
-        m_encoder[0]->CompressBlock(x, y, in, out);
+            if (Options->getPerfStats)
+            {
+                m_cputimer.Stop(1);
+                feedbackTimeMS += m_cputimer.GetTimeMS(1);
+            }
+            return abort;
+        };
     }
-    return CE_OK;
-}
 
-void CCPU_HPC::FinishThreadEncoding()
-{
-    using namespace std::chrono;
+    if ((numThreads > 1) && (m_threadPool == NULL))
+        m_threadPool = new CompressThreadPool(m_NumEncodingThreads);
 
-    // Wait for all the live threads to finish any current work
-    for (CMP_DWORD i = 0; i < m_NumEncodingThreads; i++)
-    {
-        // If a thread is in the running state then we need to wait for it to finish
-        // its work from the producer
-        while (m_EncodeParameterStorage[i].run == true)
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
+    bool completed;
+    if (m_threadPool)
+        completed = m_threadPool->Run(numBlocks, blocksPerRange, numThreads, rangeFunc, progressFunc);
+    else
+        completed = CompressRangesMT(numBlocks, blocksPerRange, 1, rangeFunc, progressFunc);
 
-        m_EncodeParameterStorage[i].exit = true;
+    for (int i = 0; i < numThreads; i++)
+    {
+        m_plugin_compute->TC_Destroy(m_encoder[i]);
+        m_encoder[i] = NULL;
     }
+
+    return completed ? CE_OK : CE_Aborted;
 }
 
 void CCPU_HPC::Init()
@@ -255,11 +243,12 @@ void CCPU_HPC::Init()
     m_cputimer = cpu_timer();
 
     m_plugin_compute         = NULL;
-    m_ThreadCodecInitialized = false;
+    m_threadPool             = NULL;
     m_current_format         = CMP_FORMAT_Unknown;
     m_computeShaderElapsedMS = 0.0f;
     m_num_blocks             = 0;
     m_CmpMTxPerSec           = 0.0f;
+    m_num_workers            = 0;
 
     //printf("HPC Threads input %d\n",m_kernel_options->threads);
     if (m_kernel_options->threads != 1)
@@ -270,8 +259,8 @@ void CCPU_HPC::Init()
             m_NumEncodingThreads = (CMP_WORD)CMP_NumberOfProcessors();
             if (m_NumEncodingThreads <= 2)
                 m_NumEncodingThreads = 8;  // fallback to a default!
-            if (m_NumEncodingThreads > 128)
-                m_NumEncodingThreads = 128;
+            if (m_NumEncodingThreads > MAX_ENCODER_THREADS)
+                m_NumEncodingThreads = MAX_ENCODER_THREADS;
         }
         m_Use_MultiThreading = true;  //always enable multithread by default for this release!
     }
@@ -281,19 +270,16 @@ void CCPU_HPC::Init()
         m_Use_MultiThreading = false;
     }
 
-    //printf("HPC Threads set %d\n",m_kernel_options->threads);
+    if (m_NumEncodingThreads > MAX_ENCODER_THREADS)
+        m_NumEncodingThreads = MAX_ENCODER_THREADS;
 
-    m_EncodeParameterStorage = new ThreadParam[m_NumEncodingThreads];
-    m_EncodingThreadHandle   = new std::thread[m_NumEncodingThreads];
-    if (!m_EncodingThreadHandle)
-    {
-        delete[] m_EncodeParameterStorage;
-        m_EncodeParameterStorage = NULL;
-    }
+    //printf("HPC Threads set %d\n",m_kernel_options->threads);
 
-    for (int i = 0; i < m_NumEncodingThreads; i++)
+    for (int i = 0; i < MAX_ENCODER_THREADS; i++)
     {
-        m_encoder[i] = NULL;
+        m_encoder[i]       = NULL;
+        m_worker_blocks[i] = 0;
+        m_worker_busyMS[i] = 0.0f;
     }
 }
 
@@ -311,25 +297,10 @@ void CCPU_HPC::SetComputeOptions(ComputeOptions* CLOptions)
 
 CCPU_HPC::~CCPU_HPC()
 {
-    if (m_EncodeParameterStorage)
-    {
-        delete[] m_EncodeParameterStorage;
-        m_EncodeParameterStorage = NULL;
-    }
-    if (m_EncodingThreadHandle)
-    {
-        delete[] m_EncodingThreadHandle;
-        m_EncodingThreadHandle = NULL;
-    }
+    if (m_threadPool)
+        delete m_threadPool;
 }
 
-#include "cmp_hpc.h"
-
-//extern void CompressImage(const texture_surface* input, BYTE* output);
-extern void InitWin32Threads(int numThreads);
-extern void DestroyThreads();
-extern void Initialize();
-
 CMP_Encoder* g_plugin_compute;
 
 void CompressTexture(const texture_surface* input, unsigned char* output)
@@ -372,15 +343,13 @@ CMP_ERROR CCPU_HPC::Compress(KernelOptions* Options, MipSet& SrcTexture, MipSet&
 #endif
 
 #ifdef USE_ASPM_CODE
-    // Prototype Code: Enabling use of SPMD (enabled only on Windows Platforms)
+    // Prototype Code: Enabling use of the SPMD BC7 kernel
     if (destTexture.m_format == CMP_FORMAT_BC7)
     {
         // When ASPM code path is enabled
         if (Options->fquality == 0.99f)
         {
             g_plugin_compute = (CMP_Encoder*)m_plugin_compute->TC_Create();
-            Initialize();
-            InitWin32Threads(Options->threads);
             texture_surface edged_img;
             edged_img.height = SrcTexture.dwHeight;
             edged_img.width  = SrcTexture.dwWidth;
@@ -389,7 +358,6 @@ CMP_ERROR CCPU_HPC::Compress(KernelOptions* Options, MipSet& SrcTexture, MipSet&
             m_plugin_compute->TC_Start();
             CompressSTMT(&edged_img, destTexture.pData, Options->threads);
             m_plugin_compute->TC_End();
-            DestroyThreads();
             m_plugin_compute->TC_Destroy(g_plugin_compute);
             return (CMP_OK);
         }
@@ -449,66 +417,23 @@ CMP_ERROR CCPU_HPC::Compress(KernelOptions* Options, MipSet& SrcTexture, MipSet&
     {
         CMP_DOUBLE pFeedbackTimeMS = 0;  // Tracks time spent outside of encoder loop
 
-        // initialize the Encoder based on num thread set in Init
-        CreateEncoderThreadPool();
-
         // printf("Encoder %x Source %x  Destination %x\n",m_plugin_compute, m_psource,p_destination);
-        CMP_FLOAT xyblocks = (CMP_FLOAT)m_padded_height_in_blocks * m_padded_width_in_blocks;
-
-        if (xyblocks <= 0.01f)
-            xyblocks = 1.0;
-
-        unsigned int y = 0;
-        unsigned int x;
-        float        progress;
-        float        progress_old  = FLT_MAX;
-        CMP_INT      lineAtPercent = (CMP_INT)(m_padded_height_in_blocks * 0.01f);
-        if (lineAtPercent <= 0)
-            lineAtPercent = 1;
+        std::vector<CMP_INT>   workerBlocks;
+        std::vector<CMP_FLOAT> workerBusyMS;
 
         if (Options->getPerfStats)
             m_cputimer.Start(0);
 
         m_plugin_compute->TC_Start();
 
-        while (y < m_padded_height_in_blocks)
+        CodecError encodeResult =
+            EncodeBlocks(Options, m_padded_width_in_blocks, m_padded_height_in_blocks, pFeedback, pFeedbackTimeMS, workerBlocks, workerBusyMS);
+        if (encodeResult != CE_OK)
         {
-            for (x = 0; x < m_padded_width_in_blocks; x++)
-            {
-                EncodeThreadBlock(x, y, (void*)m_psource, (void*)p_destination);
-            }
-            y++;
-            if (pFeedback)
-            {
-                if (Options->getPerfStats)
-                    m_cputimer.Start(1);
-                if (((y % lineAtPercent) == 0) && (xyblocks > 0))
-                {
-                    progress = (x * y) / xyblocks;
-                    if (progress_old != progress)
-                    {
-                        progress_old = progress;
-                        if (pFeedback(progress * 100.0f, NULL, NULL))
-                        {
-                            break;
-                        }
-                    }
-                }
-
-                if (Options->getPerfStats)
-                {
-                    m_cputimer.Stop(1);
-                    pFeedbackTimeMS += m_cputimer.GetTimeMS(1);
-                }
-            }
+            m_plugin_compute->TC_End();
+            return (encodeResult == CE_Aborted) ? CMP_ABORTED : CMP_ERR_UNABLE_TO_CREATE_ENCODER;
         }
 
-        // Wait for all threads to Finish
-        FinishThreadEncoding();
-
-        // Delete the Encoder Thread Pool
-        DeleteEncoderThreadPool();
-
         if (Options->getPerfStats)
             m_cputimer.Stop(0);
 
@@ -523,6 +448,13 @@ CMP_ERROR CCPU_HPC::Compress(KernelOptions* Options, MipSet& SrcTexture, MipSet&
             }
             else
                 m_CmpMTxPerSec = 0;
+
+            m_num_workers = (int)workerBlocks.size();
+            for (int i = 0; i < m_num_workers; i++)
+            {
+                m_worker_blocks[i] = workerBlocks[i];
+                m_worker_busyMS[i] = workerBusyMS[i];
+            }
         }
 
         m_plugin_compute->TC_End();
@@ -32,21 +32,11 @@
 #include "compressonator.h"
 #include "cpu_timing.h"
 
-#include <thread>
-#include <atomic>
+#include <vector>
 
-#define MAX_ENCODER_THREADS 128
+#define MAX_ENCODER_THREADS CMP_MAX_PERF_WORKERS
 
-struct ThreadParam
-{
-    CMP_Encoder*      cmp_encoder;
-    void*             in;
-    void*             out;
-    int               x;
-    int               y;
-    std::atomic<bool> run;
-    std::atomic<bool> exit;
-};
+class CompressThreadPool;
 
 using namespace CMP_Compute_Base;
 
@@ -63,15 +53,22 @@ public:
     const char* GetDeviceName();
     const char* GetVersion();
     int         GetMaxUCores();
+    void        GetWorkerStats(KernelWorkerStats* pWorkerStats);
 
 private:
     // Encoders
     CMP_Encoder* m_encoder[MAX_ENCODER_THREADS];
 
+    // Worker threads, started on the first multi threaded EncodeBlocks and reused for every mip level
+    CompressThreadPool* m_threadPool;
+
     // Performance Info
     CGU_FLOAT m_computeShaderElapsedMS;  // Total Elapsed GPU Compute Time to process all the blocks
     CGU_INT   m_num_blocks;              // Number of 4x4 pixel blocks
     CGU_FLOAT m_CmpMTxPerSec;            // Number of Texels per second
+    CGU_INT   m_num_workers;                         // Number of worker threads used for the top mip level
+    CMP_INT   m_worker_blocks[MAX_ENCODER_THREADS];  // Blocks encoded by each worker
+    CMP_FLOAT m_worker_busyMS[MAX_ENCODER_THREADS];  // Time each worker spent encoding
     // Device Info
     std::string m_deviceName;
     std::string m_version;
@@ -79,16 +76,16 @@ private:
 
     cpu_timer m_cputimer;
     // Thread Code
-    ThreadParam* m_EncodeParameterStorage;
-    std::thread* m_EncodingThreadHandle;
     CMP_BOOL     m_Use_MultiThreading;
     CMP_WORD     m_NumEncodingThreads;
-    CMP_WORD     m_LastThread;
-    CodecError   CreateEncoderThreadPool();
-    void         DeleteEncoderThreadPool();
-    void         FinishThreadEncoding();
-    CodecError   EncodeThreadBlock(int x, int y, void* in, void* out);
-    bool         m_ThreadCodecInitialized;
+    CMP_Encoder* CreateEncoder();
+    CodecError   EncodeBlocks(KernelOptions*          Options,
+                              CMP_UINT                widthInBlocks,
+                              CMP_UINT                heightInBlocks,
+                              CMP_Feedback_Proc       pFeedback,
+                              CMP_DOUBLE&             feedbackTimeMS,
+                              std::vector<CMP_INT>&   workerBlocks,
+                              std::vector<CMP_FLOAT>& workerBusyMS);
 
     // Image data
     std::string    m_source_file;
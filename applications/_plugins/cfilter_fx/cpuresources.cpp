@@ -0,0 +1,521 @@
+//=============================================================================
+// Copyright (c) 2024  Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//==============================================================================
+
+#include "cpuresources.h"
+#include "cpuresources_kernels.h"
+#include "halfconvert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FX_CPU_X86
+#ifdef _MSC_VER
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+namespace
+{
+
+//--------------------------------------------------------------------------------------------
+// Kernel selection
+//--------------------------------------------------------------------------------------------
+struct FxCPUFeatures
+{
+    bool avx  = false;
+    bool avx2 = false;
+
+    // Same checks as the swizzle functions, GetCPUExtensions() does not detect anything on Linux
+    FxCPUFeatures()
+    {
+#if defined(FX_CPU_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        // The OS must save the YMM registers on context switches
+        avx = ((info[2] & (1 << 28)) != 0) && ((info[2] & (1 << 27)) != 0) && ((_xgetbv(0) & 0x6) == 0x6);
+        if (avx && maxLeaf >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#elif defined(FX_CPU_X86)
+        __builtin_cpu_init();
+        avx  = __builtin_cpu_supports("avx") != 0;
+        avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+};
+
+// NULL when the kernels are not built in or not supported by the CPU
+const FxKernels* SelectKernels(CpuResources::SIMD simd)
+{
+    static const FxCPUFeatures cpu;
+
+    switch (simd)
+    {
+    case CpuResources::SIMD_AUTO:
+        if (cpu.avx2 && FxGetKernelsAVX2())
+            return FxGetKernelsAVX2();
+        if (cpu.avx && FxGetKernelsAVX())
+            return FxGetKernelsAVX();
+        if (FxGetKernelsSSE2())
+            return FxGetKernelsSSE2();
+        if (FxGetKernelsNEON())
+            return FxGetKernelsNEON();
+        return FxGetKernelsScalar();
+    case CpuResources::SIMD_SCALAR:
+        return FxGetKernelsScalar();
+    case CpuResources::SIMD_SSE2:
+        return FxGetKernelsSSE2();
+    case CpuResources::SIMD_AVX:
+        return cpu.avx ? FxGetKernelsAVX() : NULL;
+    case CpuResources::SIMD_AVX2:
+        return cpu.avx2 ? FxGetKernelsAVX2() : NULL;
+    case CpuResources::SIMD_NEON:
+        return FxGetKernelsNEON();
+    default:
+        return NULL;
+    }
+}
+
+std::atomic<const FxKernels*> g_kernels(NULL);
+
+const FxKernels& GetKernels()
+{
+    const FxKernels* kernels = g_kernels.load(std::memory_order_acquire);
+    if (!kernels)
+    {
+        // Keep a choice made by SetSIMD() on another thread
+        const FxKernels* expected = NULL;
+        kernels                   = SelectKernels(CpuResources::SIMD_AUTO);
+        if (!g_kernels.compare_exchange_strong(expected, kernels, std::memory_order_acq_rel))
+            kernels = expected;
+    }
+    return *kernels;
+}
+
+//--------------------------------------------------------------------------------------------
+// Planar float image with a clamped border so the kernels never test for the image edges
+//--------------------------------------------------------------------------------------------
+struct FxImage : FxPlanes
+{
+    std::vector<float> buffer;
+
+    void Allocate(int w, int h)
+    {
+        width  = w;
+        height = h;
+        // Room for the border and for a full vector past the last pixel of a row
+        stride    = FxBorder + ((w + 7) & ~7) + FxBorder + 8;
+        planeSize = (size_t)stride * (h + 2 * FxBorder);
+        buffer.assign(planeSize * FX_CHANNELS, 0.0f);
+        data = buffer.data();
+    }
+
+    // Pointer to pixel 0 of row y, y may be in [-FxBorder, height + FxBorder)
+    float* Row(int channel, int y)
+    {
+        return data + channel * planeSize + (size_t)(y + FxBorder) * stride + FxBorder;
+    }
+
+    void ClampRowEdges(int y)
+    {
+        for (int c = 0; c < FX_CHANNELS; c++)
+        {
+            float* row = Row(c, y);
+            for (int x = -FxBorder; x < 0; x++)
+                row[x] = row[0];
+            for (int x = width; x < stride - FxBorder; x++)
+                row[x] = row[width - 1];
+        }
+    }
+
+    // Called once all the rows are set and their edges clamped
+    void ClampTopBottom()
+    {
+        for (int c = 0; c < FX_CHANNELS; c++)
+        {
+            for (int y = -FxBorder; y < 0; y++)
+                std::copy(Row(c, 0) - FxBorder, Row(c, 0) - FxBorder + stride, Row(c, y) - FxBorder);
+            for (int y = height; y < height + FxBorder; y++)
+                std::copy(Row(c, height - 1) - FxBorder, Row(c, height - 1) - FxBorder + stride, Row(c, y) - FxBorder);
+        }
+    }
+};
+
+// Runs fn(firstRow, endRow) over bands of rows on all the cores
+template <typename Fn>
+void FxParallelRows(int rows, const Fn& fn)
+{
+    const int band     = 16;
+    const int numBands = (rows + band - 1) / band;
+
+    int numThreads = (int)std::thread::hardware_concurrency();
+    numThreads     = std::max(1, std::min(numThreads, numBands));
+
+    std::atomic<int> nextBand(0);
+    auto             worker = [&]() {
+        for (;;)
+        {
+            int b = nextBand.fetch_add(1);
+            if (b >= numBands)
+                break;
+            fn(b * band, std::min(rows, (b + 1) * band));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; i++)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& t : threads)
+        t.join();
+}
+
+//--------------------------------------------------------------------------------------------
+// Conversion between the MipSet data and the float planes
+//--------------------------------------------------------------------------------------------
+enum FxPixelType
+{
+    FX_PIXEL_UNORM8,
+    FX_PIXEL_FLOAT16,
+    FX_PIXEL_FLOAT32,
+    FX_PIXEL_UNSUPPORTED
+};
+
+// All the supported formats keep alpha in the last channel, the filters weigh red and blue
+// the same so the order of the color channels does not matter.
+FxPixelType GetPixelType(CMP_FORMAT format)
+{
+    switch (format)
+    {
+    case CMP_FORMAT_ARGB_8888:
+    case CMP_FORMAT_RGBA_8888:
+    case CMP_FORMAT_BGRA_8888:
+        return FX_PIXEL_UNORM8;
+    case CMP_FORMAT_ARGB_16F:
+    case CMP_FORMAT_ABGR_16F:
+    case CMP_FORMAT_RGBA_16F:
+        return FX_PIXEL_FLOAT16;
+    case CMP_FORMAT_ARGB_32F:
+    case CMP_FORMAT_RGBA_32F:
+        return FX_PIXEL_FLOAT32;
+    default:
+        return FX_PIXEL_UNSUPPORTED;
+    }
+}
+
+float SRGBToLinear(float c)
+{
+    return (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSRGB(float c)
+{
+    c = std::min(std::max(c, 0.0f), 1.0f);
+    return (c <= 0.0031308f) ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+const int FxEncodeBuckets = 4096;
+
+struct FxUnorm8Tables
+{
+    float    decode[256];                       // byte to linear float
+    float    thresholds[255];                   // linear value from which the encoded byte is at least i + 1
+    CMP_BYTE buckets[FxEncodeBuckets + 1];      // encoded byte at the start of each 1/4096 step of the linear range
+
+    void Init(bool useSRGB)
+    {
+        for (int i = 0; i < 256; i++)
+            decode[i] = useSRGB ? SRGBToLinear(i / 255.0f) : i / 255.0f;
+        for (int i = 0; i < 255; i++)
+            thresholds[i] = useSRGB ? SRGBToLinear((i + 0.5f) / 255.0f) : (i + 0.5f) / 255.0f;
+        for (int i = 0; i <= FxEncodeBuckets; i++)
+            buckets[i] = (CMP_BYTE)(std::upper_bound(thresholds, thresholds + 255, (float)i / FxEncodeBuckets) - thresholds);
+    }
+
+    // Same result as rounding the encoded value, without a pow() per channel. A bucket spans
+    // at most one threshold so the loop runs once at most.
+    CMP_BYTE Encode(float value) const
+    {
+        if (!(value > 0.0f))
+            return 0;
+        if (value >= 1.0f)
+            return 255;
+        int i = buckets[(int)(value * FxEncodeBuckets)];
+        while (i < 255 && thresholds[i] <= value)
+            i++;
+        return (CMP_BYTE)i;
+    }
+};
+
+const FxUnorm8Tables& GetUnorm8Tables(bool useSRGB)
+{
+    struct Tables
+    {
+        FxUnorm8Tables linear;
+        FxUnorm8Tables srgb;
+        Tables()
+        {
+            linear.Init(false);
+            srgb.Init(true);
+        }
+    };
+    static const Tables tables;
+    return useSRGB ? tables.srgb : tables.linear;
+}
+
+const CMP_BYTE* GetLevelData(const CMP_MipSet* mipSet)
+{
+    if (mipSet->m_pMipLevelTable && mipSet->m_pMipLevelTable[0] && mipSet->m_pMipLevelTable[0]->m_pbData)
+        return mipSet->m_pMipLevelTable[0]->m_pbData;
+    return mipSet->pData;
+}
+
+CMP_BYTE* GetLevelData(CMP_MipSet* mipSet)
+{
+    return const_cast<CMP_BYTE*>(GetLevelData(static_cast<const CMP_MipSet*>(mipSet)));
+}
+
+void UnpackImage(const CMP_MipSet* src, FxPixelType type, bool useSRGB, FxImage& image)
+{
+    const CMP_BYTE*       data   = GetLevelData(src);
+    const int             width  = image.width;
+    const FxUnorm8Tables& tables = GetUnorm8Tables(useSRGB);
+
+    FxParallelRows(image.height, [&](int y0, int y1) {
+        std::vector<float> pixels(type == FX_PIXEL_FLOAT16 ? (size_t)width * 4 : 0);
+        for (int y = y0; y < y1; y++)
+        {
+            float* rows[FX_CHANNELS] = {image.Row(FX_R, y), image.Row(FX_G, y), image.Row(FX_B, y), image.Row(FX_A, y)};
+
+            const float* rowPixels = pixels.data();
+            if (type == FX_PIXEL_UNORM8)
+            {
+                const CMP_BYTE* p = data + (size_t)y * width * 4;
+                for (int x = 0; x < width; x++, p += 4)
+                {
+                    rows[FX_R][x] = tables.decode[p[0]];
+                    rows[FX_G][x] = tables.decode[p[1]];
+                    rows[FX_B][x] = tables.decode[p[2]];
+                    rows[FX_A][x] = p[3] / 255.0f;
+                }
+            }
+            else
+            {
+                if (type == FX_PIXEL_FLOAT16)
+                    CMP_HalfToFloatN(pixels.data(), reinterpret_cast<const unsigned short*>(data) + (size_t)y * width * 4, (size_t)width * 4);
+                else
+                    rowPixels = reinterpret_cast<const float*>(data) + (size_t)y * width * 4;
+
+                for (int x = 0; x < width; x++)
+                    for (int c = 0; c < FX_CHANNELS; c++)
+                        rows[c][x] = rowPixels[x * 4 + c];
+            }
+            image.ClampRowEdges(y);
+        }
+    });
+    image.ClampTopBottom();
+}
+
+// Writes one row of filtered pixels to the destination
+void PackRow(const float* const rows[FX_CHANNELS], int width, int y, FxPixelType type, bool useSRGB, CMP_BYTE* data, std::vector<float>& scratch)
+{
+    if (type == FX_PIXEL_UNORM8)
+    {
+        const FxUnorm8Tables& tables = GetUnorm8Tables(useSRGB);
+        const FxUnorm8Tables& alpha  = GetUnorm8Tables(false);
+
+        CMP_BYTE* p = data + (size_t)y * width * 4;
+        for (int x = 0; x < width; x++, p += 4)
+        {
+            p[0] = tables.Encode(rows[FX_R][x]);
+            p[1] = tables.Encode(rows[FX_G][x]);
+            p[2] = tables.Encode(rows[FX_B][x]);
+            p[3] = alpha.Encode(rows[FX_A][x]);
+        }
+        return;
+    }
+
+    float* pixels;
+    if (type == FX_PIXEL_FLOAT16)
+    {
+        scratch.resize((size_t)width * 4);
+        pixels = scratch.data();
+    }
+    else
+        pixels = reinterpret_cast<float*>(data) + (size_t)y * width * 4;
+
+    for (int x = 0; x < width; x++)
+        for (int c = 0; c < FX_CHANNELS; c++)
+            pixels[x * 4 + c] = rows[c][x];
+
+    if (type == FX_PIXEL_FLOAT16)
+        CMP_FloatToHalfN(reinterpret_cast<unsigned short*>(data) + (size_t)y * width * 4, pixels, (size_t)width * 4);
+}
+
+FxScaling GetScaling(int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+{
+    FxScaling scaling;
+    scaling.scaleX  = (float)srcWidth / (float)dstWidth;
+    scaling.scaleY  = (float)srcHeight / (float)dstHeight;
+    scaling.offsetX = 0.5f * scaling.scaleX - 0.5f;
+    scaling.offsetY = 0.5f * scaling.scaleY - 0.5f;
+    return scaling;
+}
+
+bool CheckMipSets(const CMP_MipSet* src, const CMP_MipSet* dst)
+{
+    if (!src || !dst || !GetLevelData(src) || !GetLevelData(dst))
+        return false;
+    if (src->m_nWidth <= 0 || src->m_nHeight <= 0 || dst->m_nWidth <= 0 || dst->m_nHeight <= 0)
+        return false;
+    return true;
+}
+
+}  // namespace
+
+bool CpuResources::SetSIMD(SIMD simd)
+{
+    const FxKernels* kernels = SelectKernels(simd);
+    if (!kernels)
+        return false;
+
+    g_kernels.store(kernels, std::memory_order_release);
+    return true;
+}
+
+bool CpuResources::IsFormatSupported(CMP_FORMAT format)
+{
+    return GetPixelType(format) != FX_PIXEL_UNSUPPORTED;
+}
+
+int CpuResources::CAS(float sharpness, bool useSRGB, const CMP_MipSet* src, CMP_MipSet* dst)
+{
+    if (!CheckMipSets(src, dst))
+        return CMP_ERR_INVALID_SOURCE_TEXTURE;
+
+    FxPixelType type = GetPixelType(src->m_format);
+    if (type == FX_PIXEL_UNSUPPORTED)
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+    if (GetPixelType(dst->m_format) != type)
+        return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
+
+    // Same limit as CasSupportScaling()
+    const float area = ((float)dst->m_nWidth * dst->m_nHeight) / ((float)src->m_nWidth * src->m_nHeight);
+    if (area > 4.0f)
+        return CMP_ERR_SIZE_MISMATCH;
+
+    // Float formats are always processed as linear, as in the shader
+    useSRGB = useSRGB && (type == FX_PIXEL_UNORM8);
+
+    FxImage image;
+    image.Allocate(src->m_nWidth, src->m_nHeight);
+    UnpackImage(src, type, useSRGB, image);
+
+    const float peak      = -1.0f / (8.0f - 3.0f * std::min(std::max(sharpness, 0.0f), 1.0f));
+    const bool  noScaling = (src->m_nWidth == dst->m_nWidth) && (src->m_nHeight == dst->m_nHeight);
+    const int   dstWidth  = dst->m_nWidth;
+    FxScaling   scaling   = GetScaling(src->m_nWidth, src->m_nHeight, dst->m_nWidth, dst->m_nHeight);
+    CMP_BYTE*   dstData   = GetLevelData(dst);
+
+    const FxKernels& kernels = GetKernels();
+
+    FxParallelRows(dst->m_nHeight, [&](int y0, int y1) {
+        const int          rowStride = ((dstWidth + 7) & ~7);
+        std::vector<float> rowData((size_t)rowStride * FX_CHANNELS);
+        std::vector<float> scratch;
+        float* const       out[FX_CHANNELS] = {&rowData[0], &rowData[rowStride], &rowData[2 * rowStride], &rowData[3 * rowStride]};
+
+        for (int y = y0; y < y1; y++)
+        {
+            if (noScaling)
+                kernels.CasRowNoScaling(image, y, peak, out);
+            else
+                kernels.CasRowScaling(image, y, dstWidth, scaling, peak, out);
+            PackRow(out, dstWidth, y, type, useSRGB, dstData, scratch);
+        }
+    });
+
+    return CMP_OK;
+}
+
+int CpuResources::FSR(float sharpness, const CMP_MipSet* src, CMP_MipSet* dst)
+{
+    if (!CheckMipSets(src, dst))
+        return CMP_ERR_INVALID_SOURCE_TEXTURE;
+
+    FxPixelType type = GetPixelType(src->m_format);
+    if (type == FX_PIXEL_UNSUPPORTED)
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+    if (GetPixelType(dst->m_format) != type)
+        return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
+
+    const FxKernels& kernels = GetKernels();
+
+    FxImage image;
+    image.Allocate(src->m_nWidth, src->m_nHeight);
+    UnpackImage(src, type, false, image);
+
+    // EASU into a bordered image so RCAS can read its neighbors
+    FxImage   scaled;
+    FxScaling scaling = GetScaling(src->m_nWidth, src->m_nHeight, dst->m_nWidth, dst->m_nHeight);
+    scaled.Allocate(dst->m_nWidth, dst->m_nHeight);
+    FxParallelRows(scaled.height, [&](int y0, int y1) {
+        for (int y = y0; y < y1; y++)
+        {
+            kernels.EasuRow(image, y, scaled, scaling);
+            scaled.ClampRowEdges(y);
+        }
+    });
+    scaled.ClampTopBottom();
+
+    // FsrRcasCon() takes stops of sharpness reduction, 0 is the sharpest
+    const float stops = 2.0f * (1.0f - std::min(std::max(sharpness, 0.0f), 1.0f));
+    const float con   = std::exp2(-stops);
+    const int   dstWidth = dst->m_nWidth;
+    CMP_BYTE*   dstData  = GetLevelData(dst);
+
+    FxParallelRows(scaled.height, [&](int y0, int y1) {
+        const int          rowStride = ((dstWidth + 7) & ~7);
+        std::vector<float> rowData((size_t)rowStride * FX_CHANNELS);
+        std::vector<float> scratch;
+        float* const       out[FX_CHANNELS] = {&rowData[0], &rowData[rowStride], &rowData[2 * rowStride], &rowData[3 * rowStride]};
+
+        for (int y = y0; y < y1; y++)
+        {
+            kernels.RcasRow(scaled, y, con, out);
+            PackRow(out, dstWidth, y, type, false, dstData, scratch);
+        }
+    });
+
+    return CMP_OK;
+}
@@ -0,0 +1,74 @@
+//=============================================================================
+// Copyright (c) 2024  Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//==============================================================================
+
+#ifndef _CPURESOURCES_FILTERFX_H
+#define _CPURESOURCES_FILTERFX_H
+
+#include "compressonator.h"
+
+// CPU implementation of the FidelityFX filters used by the plugin when no DirectX
+// device is available (Linux and macOS) or when it is requested explicitly.
+//
+// The kernels are ports of the single precision CasFilter(), FsrEasuF() and
+// FsrRcasF() shader code in cmp_core/shaders, vectorized across the pixels of a
+// row and run on row bands over all the cores. Exact rcp and sqrt are used where
+// the shaders use approximations. The kernels are built for each instruction set
+// of the target and the best one supported by the CPU is picked at runtime: AVX2,
+// AVX or SSE2 on x86 and NEON on ARM64. They all give the same results as the
+// scalar kernels.
+//
+// Unlike the GPU path the alpha channel is kept: it is copied when the size does
+// not change and bilinearly resampled otherwise. Image edges are clamped.
+class CpuResources
+{
+public:
+    // Contrast adaptive sharpening of level 0 of src into level 0 of dst. dst must be
+    // allocated with the same format, its size may differ from src by up to 4x area.
+    // 8 bit sources are converted from sRGB when useSRGB is set.
+    int CAS(float sharpness, bool useSRGB, const CMP_MipSet* src, CMP_MipSet* dst);
+
+    // FSR 1.0 edge adaptive upscaling (EASU) of level 0 of src to the size of dst,
+    // followed by robust contrast adaptive sharpening (RCAS). sharpness 1.0 is the
+    // strongest RCAS setting, each 0.5 below it halves the sharpening.
+    int FSR(float sharpness, const CMP_MipSet* src, CMP_MipSet* dst);
+
+    static bool IsFormatSupported(CMP_FORMAT format);
+
+    enum SIMD
+    {
+        SIMD_AUTO,
+        SIMD_SCALAR,
+        SIMD_SSE2,
+        SIMD_AVX,
+        SIMD_AVX2,
+        SIMD_NEON,
+    };
+
+    // Manually sets which instruction set the kernels use, for testing and
+    // benchmarking. The most recent call wins, SIMD_AUTO restores the automatic
+    // choice. Returns false and keeps the current choice if the kernels are not
+    // built for the target or the CPU does not support them.
+    static bool SetSIMD(SIMD simd);
+};
+
+#endif
@@ -0,0 +1,46 @@
+//=============================================================================
+// Copyright (c) 2024  Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//==============================================================================
+
+// AVX kernels with the AVX2 gathers of the scaling kernels. Built with -mavx2 or
+// /arch:AVX2 on x86 targets.
+
+#include "cpuresources_kernels.h"
+
+#if defined(__AVX2__)
+
+#define FX_SIMD_AVX2
+#include "cpuresources_simd.h"
+
+const FxKernels* FxGetKernelsAVX2()
+{
+    return &FxKernelTable;
+}
+
+#else
+
+const FxKernels* FxGetKernelsAVX2()
+{
+    return NULL;
+}
+
+#endif
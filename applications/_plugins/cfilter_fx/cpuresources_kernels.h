@@ -0,0 +1,83 @@
+//=============================================================================
+// Copyright (c) 2024  Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//==============================================================================
+
+#ifndef _CPURESOURCES_KERNELS_FILTERFX_H
+#define _CPURESOURCES_KERNELS_FILTERFX_H
+
+#include <stddef.h>
+
+// Row kernels of CpuResources. cpuresources_simd.h is compiled once per instruction
+// set by the cpuresources_<isa>.cpp files, each with its own compiler flags, and
+// cpuresources.cpp picks one of the resulting kernel tables at runtime.
+
+// Planar float image with a clamped border so the kernels never test for the image edges
+const int FxBorder = 2;
+
+enum
+{
+    FX_R = 0,
+    FX_G,
+    FX_B,
+    FX_A,
+    FX_CHANNELS
+};
+
+// The planes of an FxImage as seen by the kernels. Each row has room for the border
+// and for a full vector of 8 floats past its last pixel.
+struct FxPlanes
+{
+    float* data      = NULL;
+    int    width     = 0;
+    int    height    = 0;
+    int    stride    = 0;
+    size_t planeSize = 0;
+};
+
+// Output pixel x maps to source position x * scale + offset, as set up by CasSetup() and FsrEasuCon()
+struct FxScaling
+{
+    float scaleX, scaleY;
+    float offsetX, offsetY;
+};
+
+struct FxKernels
+{
+    // CAS, port of CasFilter() without CAS_BETTER_DIAGONALS and CAS_SLOW
+    void (*CasRowNoScaling)(const FxPlanes& src, int y, float peak, float* const out[FX_CHANNELS]);
+    void (*CasRowScaling)(const FxPlanes& src, int y, int dstWidth, const FxScaling& scaling, float peak, float* const out[FX_CHANNELS]);
+
+    // FSR EASU, port of FsrEasuF(). Writes row y of dst without clamping its edges.
+    void (*EasuRow)(const FxPlanes& src, int y, const FxPlanes& dst, const FxScaling& scaling);
+
+    // FSR RCAS, port of FsrRcasF() without FSR_RCAS_DENOISE
+    void (*RcasRow)(const FxPlanes& src, int y, float sharpness, float* const out[FX_CHANNELS]);
+};
+
+// NULL when the instruction set is not available on the build target
+const FxKernels* FxGetKernelsScalar();
+const FxKernels* FxGetKernelsSSE2();
+const FxKernels* FxGetKernelsAVX();
+const FxKernels* FxGetKernelsAVX2();
+const FxKernels* FxGetKernelsNEON();
+
+#endif
@@ -0,0 +1,771 @@
+//=============================================================================
+// Copyright (c) 2024  Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//==============================================================================
+
+#ifndef _CPURESOURCES_SIMD_FILTERFX_H
+#define _CPURESOURCES_SIMD_FILTERFX_H
+
+// Kernels of CpuResources, included by one of the cpuresources_<isa>.cpp files after
+// it defines FX_SIMD_AVX2, FX_SIMD_AVX, FX_SIMD_SSE2, FX_SIMD_NEON or none of them for
+// the scalar kernels. Those files are compiled with the flags of their instruction set,
+// so everything here has internal linkage and no inline library function is called:
+// the linker could otherwise keep a copy of it built for another instruction set.
+
+#include "cpuresources_kernels.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(FX_SIMD_AVX2)
+#define FX_SIMD_AVX
+#endif
+
+#if defined(FX_SIMD_AVX)
+#include <immintrin.h>
+#elif defined(FX_SIMD_SSE2)
+#include <emmintrin.h>
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+#elif defined(FX_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+
+//--------------------------------------------------------------------------------------------
+// Small SIMD wrapper, one lane per output pixel
+//--------------------------------------------------------------------------------------------
+#if defined(FX_SIMD_AVX)
+
+const int FxLanes = 8;
+struct FxVec
+{
+    __m256 v;
+};
+struct FxMask
+{
+    __m256 v;
+};
+
+inline FxVec FxLoad(const float* p)
+{
+    return {_mm256_loadu_ps(p)};
+}
+inline void FxStore(float* p, FxVec a)
+{
+    _mm256_storeu_ps(p, a.v);
+}
+inline FxVec FxSet(float f)
+{
+    return {_mm256_set1_ps(f)};
+}
+inline FxVec operator+(FxVec a, FxVec b)
+{
+    return {_mm256_add_ps(a.v, b.v)};
+}
+inline FxVec operator-(FxVec a, FxVec b)
+{
+    return {_mm256_sub_ps(a.v, b.v)};
+}
+inline FxVec operator*(FxVec a, FxVec b)
+{
+    return {_mm256_mul_ps(a.v, b.v)};
+}
+inline FxVec operator/(FxVec a, FxVec b)
+{
+    return {_mm256_div_ps(a.v, b.v)};
+}
+inline FxVec FxMin(FxVec a, FxVec b)
+{
+    return {_mm256_min_ps(a.v, b.v)};
+}
+inline FxVec FxMax(FxVec a, FxVec b)
+{
+    return {_mm256_max_ps(a.v, b.v)};
+}
+inline FxVec FxAbs(FxVec a)
+{
+    return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)};
+}
+inline FxVec FxSqrt(FxVec a)
+{
+    return {_mm256_sqrt_ps(a.v)};
+}
+inline FxVec FxFloor(FxVec a)
+{
+    return {_mm256_floor_ps(a.v)};
+}
+inline FxMask FxLess(FxVec a, FxVec b)
+{
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)};
+}
+inline FxVec FxSelect(FxMask m, FxVec a, FxVec b)
+{
+    return {_mm256_blendv_ps(b.v, a.v, m.v)};
+}
+
+#elif defined(FX_SIMD_SSE2)
+
+const int FxLanes = 4;
+struct FxVec
+{
+    __m128 v;
+};
+struct FxMask
+{
+    __m128 v;
+};
+
+inline FxVec FxLoad(const float* p)
+{
+    return {_mm_loadu_ps(p)};
+}
+inline void FxStore(float* p, FxVec a)
+{
+    _mm_storeu_ps(p, a.v);
+}
+inline FxVec FxSet(float f)
+{
+    return {_mm_set1_ps(f)};
+}
+inline FxVec operator+(FxVec a, FxVec b)
+{
+    return {_mm_add_ps(a.v, b.v)};
+}
+inline FxVec operator-(FxVec a, FxVec b)
+{
+    return {_mm_sub_ps(a.v, b.v)};
+}
+inline FxVec operator*(FxVec a, FxVec b)
+{
+    return {_mm_mul_ps(a.v, b.v)};
+}
+inline FxVec operator/(FxVec a, FxVec b)
+{
+    return {_mm_div_ps(a.v, b.v)};
+}
+inline FxVec FxMin(FxVec a, FxVec b)
+{
+    return {_mm_min_ps(a.v, b.v)};
+}
+inline FxVec FxMax(FxVec a, FxVec b)
+{
+    return {_mm_max_ps(a.v, b.v)};
+}
+inline FxVec FxAbs(FxVec a)
+{
+    return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)};
+}
+inline FxVec FxSqrt(FxVec a)
+{
+    return {_mm_sqrt_ps(a.v)};
+}
+inline FxVec FxFloor(FxVec a)
+{
+#ifdef __SSE4_1__
+    return {_mm_floor_ps(a.v)};
+#else
+    // Truncate, then step down the lanes that were rounded up (negative values)
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+    return {_mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f)))};
+#endif
+}
+inline FxMask FxLess(FxVec a, FxVec b)
+{
+    return {_mm_cmplt_ps(a.v, b.v)};
+}
+inline FxVec FxSelect(FxMask m, FxVec a, FxVec b)
+{
+    return {_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))};
+}
+
+#elif defined(FX_SIMD_NEON)
+
+const int FxLanes = 4;
+struct FxVec
+{
+    float32x4_t v;
+};
+struct FxMask
+{
+    uint32x4_t v;
+};
+
+inline FxVec FxLoad(const float* p)
+{
+    return {vld1q_f32(p)};
+}
+inline void FxStore(float* p, FxVec a)
+{
+    vst1q_f32(p, a.v);
+}
+inline FxVec FxSet(float f)
+{
+    return {vdupq_n_f32(f)};
+}
+inline FxVec operator+(FxVec a, FxVec b)
+{
+    return {vaddq_f32(a.v, b.v)};
+}
+inline FxVec operator-(FxVec a, FxVec b)
+{
+    return {vsubq_f32(a.v, b.v)};
+}
+inline FxVec operator*(FxVec a, FxVec b)
+{
+    return {vmulq_f32(a.v, b.v)};
+}
+inline FxVec operator/(FxVec a, FxVec b)
+{
+    return {vdivq_f32(a.v, b.v)};
+}
+inline FxVec FxMin(FxVec a, FxVec b)
+{
+    return {vminq_f32(a.v, b.v)};
+}
+inline FxVec FxMax(FxVec a, FxVec b)
+{
+    return {vmaxq_f32(a.v, b.v)};
+}
+inline FxVec FxAbs(FxVec a)
+{
+    return {vabsq_f32(a.v)};
+}
+inline FxVec FxSqrt(FxVec a)
+{
+    return {vsqrtq_f32(a.v)};
+}
+inline FxVec FxFloor(FxVec a)
+{
+    return {vrndmq_f32(a.v)};
+}
+inline FxMask FxLess(FxVec a, FxVec b)
+{
+    return {vcltq_f32(a.v, b.v)};
+}
+inline FxVec FxSelect(FxMask m, FxVec a, FxVec b)
+{
+    return {vbslq_f32(m.v, a.v, b.v)};
+}
+
+#else
+
+const int FxLanes = 1;
+struct FxVec
+{
+    float v;
+};
+struct FxMask
+{
+    bool v;
+};
+
+inline FxVec FxLoad(const float* p)
+{
+    return {*p};
+}
+inline void FxStore(float* p, FxVec a)
+{
+    *p = a.v;
+}
+inline FxVec FxSet(float f)
+{
+    return {f};
+}
+inline FxVec operator+(FxVec a, FxVec b)
+{
+    return {a.v + b.v};
+}
+inline FxVec operator-(FxVec a, FxVec b)
+{
+    return {a.v - b.v};
+}
+inline FxVec operator*(FxVec a, FxVec b)
+{
+    return {a.v * b.v};
+}
+inline FxVec operator/(FxVec a, FxVec b)
+{
+    return {a.v / b.v};
+}
+inline FxVec FxMin(FxVec a, FxVec b)
+{
+    return {a.v < b.v ? a.v : b.v};
+}
+inline FxVec FxMax(FxVec a, FxVec b)
+{
+    return {a.v > b.v ? a.v : b.v};
+}
+inline FxVec FxAbs(FxVec a)
+{
+    return {fabsf(a.v)};
+}
+inline FxVec FxSqrt(FxVec a)
+{
+    return {sqrtf(a.v)};
+}
+inline FxVec FxFloor(FxVec a)
+{
+    return {floorf(a.v)};
+}
+inline FxMask FxLess(FxVec a, FxVec b)
+{
+    return {a.v < b.v};
+}
+inline FxVec FxSelect(FxMask m, FxVec a, FxVec b)
+{
+    return m.v ? a : b;
+}
+
+#endif
+
+inline FxVec FxMin3(FxVec a, FxVec b, FxVec c)
+{
+    return FxMin(FxMin(a, b), c);
+}
+inline FxVec FxMax3(FxVec a, FxVec b, FxVec c)
+{
+    return FxMax(FxMax(a, b), c);
+}
+inline FxVec FxSat(FxVec a)
+{
+    return FxMin(FxMax(a, FxSet(0.0f)), FxSet(1.0f));
+}
+
+// The shaders rely on the GPU returning a huge value for rcp(0), keep the result finite here
+inline FxVec FxRcp(FxVec a)
+{
+    return FxSet(1.0f) / FxMax(a, FxSet(FLT_MIN));
+}
+
+inline FxVec FxLaneIndex(int x)
+{
+    float lanes[FxLanes];
+    for (int i = 0; i < FxLanes; i++)
+        lanes[i] = (float)(x + i);
+    return FxLoad(lanes);
+}
+
+inline void FxToInt(FxVec a, int* out)
+{
+    float lanes[FxLanes];
+    FxStore(lanes, a);
+    for (int i = 0; i < FxLanes; i++)
+        out[i] = (int)lanes[i];
+}
+
+// Loads row[idx[i] + offset] into lane i
+inline FxVec FxGather(const float* row, const int* idx, int offset)
+{
+    row += offset;
+#if defined(FX_SIMD_AVX2)
+    return {_mm256_i32gather_ps(row, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx)), 4)};
+#elif defined(FX_SIMD_AVX)
+    return {_mm256_setr_ps(row[idx[0]], row[idx[1]], row[idx[2]], row[idx[3]], row[idx[4]], row[idx[5]], row[idx[6]], row[idx[7]])};
+#elif defined(FX_SIMD_SSE2)
+    return {_mm_setr_ps(row[idx[0]], row[idx[1]], row[idx[2]], row[idx[3]])};
+#else
+    float lanes[FxLanes];
+    for (int i = 0; i < FxLanes; i++)
+        lanes[i] = row[idx[i]];
+    return FxLoad(lanes);
+#endif
+}
+
+inline int FxClamp(int v, int lo, int hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Pointer to pixel 0 of row y, y may be in [-FxBorder, height + FxBorder)
+inline float* FxRow(const FxPlanes& image, int channel, int y)
+{
+    return image.data + channel * image.planeSize + (size_t)(y + FxBorder) * image.stride + FxBorder;
+}
+
+// Source taps of the scaling kernels relative to f = floor(position)
+//    b c
+//  e f g h
+//  i j k l
+//    n o
+struct FxTaps
+{
+    FxVec b, c, e, f, g, h, i, j, k, l, n, o;
+
+    void Load(const FxPlanes& image, int channel, int fy, const int* fx)
+    {
+        const float* r0 = FxRow(image, channel, fy - 1);
+        const float* r1 = FxRow(image, channel, fy);
+        const float* r2 = FxRow(image, channel, fy + 1);
+        const float* r3 = FxRow(image, channel, fy + 2);
+
+        b = FxGather(r0, fx, 0);
+        c = FxGather(r0, fx, 1);
+        e = FxGather(r1, fx, -1);
+        f = FxGather(r1, fx, 0);
+        g = FxGather(r1, fx, 1);
+        h = FxGather(r1, fx, 2);
+        i = FxGather(r2, fx, -1);
+        j = FxGather(r2, fx, 0);
+        k = FxGather(r2, fx, 1);
+        l = FxGather(r2, fx, 2);
+        n = FxGather(r3, fx, 0);
+        o = FxGather(r3, fx, 1);
+    }
+};
+
+// Source position of the lanes starting at output pixel x, returns floor() as clamped indices and the fraction
+inline FxVec ScaledColumns(const FxScaling& scaling, int x, int srcWidth, int* fx)
+{
+    FxVec pp = FxLaneIndex(x) * FxSet(scaling.scaleX) + FxSet(scaling.offsetX);
+    FxVec fp = FxFloor(pp);
+    FxToInt(fp, fx);
+    // Lanes past the end of the row can go beyond the border, they are not written out
+    for (int i = 0; i < FxLanes; i++)
+        fx[i] = FxClamp(fx[i], -1, srcWidth - 1);
+    return pp - fp;
+}
+
+inline int ScaledRow(const FxScaling& scaling, int y, int srcHeight, float& fracY)
+{
+    float pp = y * scaling.scaleY + scaling.offsetY;
+    float fp = floorf(pp);
+    fracY    = pp - fp;
+    return FxClamp((int)fp, -1, srcHeight - 1);
+}
+
+// Bilinear alpha from the f g j k taps
+inline FxVec BilinearAlpha(const FxPlanes& image, int fy, const int* fx, FxVec ppx, FxVec ppy)
+{
+    const float* r1 = FxRow(image, FX_A, fy);
+    const float* r2 = FxRow(image, FX_A, fy + 1);
+    FxVec        top    = FxGather(r1, fx, 0) + (FxGather(r1, fx, 1) - FxGather(r1, fx, 0)) * ppx;
+    FxVec        bottom = FxGather(r2, fx, 0) + (FxGather(r2, fx, 1) - FxGather(r2, fx, 0)) * ppx;
+    return top + (bottom - top) * ppy;
+}
+
+//--------------------------------------------------------------------------------------------
+// CAS, port of CasFilter() without CAS_BETTER_DIAGONALS and CAS_SLOW
+//--------------------------------------------------------------------------------------------
+void CasRowNoScaling(const FxPlanes& src, int y, float peak, float* const out[FX_CHANNELS])
+{
+    const float* rows[3][3];
+    for (int c = 0; c < 3; c++)
+    {
+        rows[c][0] = FxRow(src, c, y - 1);
+        rows[c][1] = FxRow(src, c, y);
+        rows[c][2] = FxRow(src, c, y + 1);
+    }
+
+    for (int x = 0; x < src.width; x += FxLanes)
+    {
+        //    b
+        //  d e f
+        //    h
+        // Only the green channel drives the filter weights
+        FxVec bG = FxLoad(rows[FX_G][0] + x);
+        FxVec dG = FxLoad(rows[FX_G][1] + x - 1);
+        FxVec eG = FxLoad(rows[FX_G][1] + x);
+        FxVec fG = FxLoad(rows[FX_G][1] + x + 1);
+        FxVec hG = FxLoad(rows[FX_G][2] + x);
+
+        FxVec mn = FxMin3(FxMin3(dG, eG, fG), bG, hG);
+        FxVec mx = FxMax3(FxMax3(dG, eG, fG), bG, hG);
+
+        FxVec amp       = FxSqrt(FxSat(FxMin(mn, FxSet(1.0f) - mx) * FxRcp(mx)));
+        FxVec w         = amp * FxSet(peak);
+        FxVec rcpWeight = FxSet(1.0f) / (FxSet(1.0f) + FxSet(4.0f) * w);
+
+        for (int c = 0; c < 3; c++)
+        {
+            FxVec ring = FxLoad(rows[c][0] + x) + FxLoad(rows[c][1] + x - 1) + FxLoad(rows[c][1] + x + 1) + FxLoad(rows[c][2] + x);
+            FxStore(out[c] + x, FxSat((ring * w + FxLoad(rows[c][1] + x)) * rcpWeight));
+        }
+    }
+
+    memcpy(out[FX_A], FxRow(src, FX_A, y), src.width * sizeof(float));
+}
+
+void CasRowScaling(const FxPlanes& src, int y, int dstWidth, const FxScaling& scaling, float peak, float* const out[FX_CHANNELS])
+{
+    float     fracY;
+    const int fy  = ScaledRow(scaling, y, src.height, fracY);
+    FxVec     ppy = FxSet(fracY);
+
+    int     fx[FxLanes];
+    FxTaps  taps[3];
+    for (int x = 0; x < dstWidth; x += FxLanes)
+    {
+        FxVec ppx = ScaledColumns(scaling, x, src.width, fx);
+        for (int c = 0; c < 3; c++)
+            taps[c].Load(src, c, fy, fx);
+
+        // Soft min and max of the 4 nearest neighborhoods, green only
+        const FxTaps& t    = taps[FX_G];
+        FxVec         mnf  = FxMin3(FxMin3(t.b, t.e, t.f), t.g, t.j);
+        FxVec         mxf  = FxMax3(FxMax3(t.b, t.e, t.f), t.g, t.j);
+        FxVec         mng  = FxMin3(FxMin3(t.c, t.f, t.g), t.h, t.k);
+        FxVec         mxg  = FxMax3(FxMax3(t.c, t.f, t.g), t.h, t.k);
+        FxVec         mnj  = FxMin3(FxMin3(t.f, t.i, t.j), t.k, t.n);
+        FxVec         mxj  = FxMax3(FxMax3(t.f, t.i, t.j), t.k, t.n);
+        FxVec         mnk  = FxMin3(FxMin3(t.g, t.j, t.k), t.l, t.o);
+        FxVec         mxk  = FxMax3(FxMax3(t.g, t.j, t.k), t.l, t.o);
+        FxVec         one  = FxSet(1.0f);
+        FxVec         vpk  = FxSet(peak);
+
+        FxVec wf = FxSqrt(FxSat(FxMin(mnf, one - mxf) * FxRcp(mxf))) * vpk;
+        FxVec wg = FxSqrt(FxSat(FxMin(mng, one - mxg) * FxRcp(mxg))) * vpk;
+        FxVec wj = FxSqrt(FxSat(FxMin(mnj, one - mxj) * FxRcp(mxj))) * vpk;
+        FxVec wk = FxSqrt(FxSat(FxMin(mnk, one - mxk) * FxRcp(mxk))) * vpk;
+
+        // Bilinear weights, thinned on edges
+        FxVec thinB = FxSet(1.0f / 32.0f);
+        FxVec s     = (one - ppx) * (one - ppy) / (thinB + (mxf - mnf));
+        FxVec tt    = ppx * (one - ppy) / (thinB + (mxg - mng));
+        FxVec u     = (one - ppx) * ppy / (thinB + (mxj - mnj));
+        FxVec v     = ppx * ppy / (thinB + (mxk - mnk));
+
+        FxVec qbe = wf * s;
+        FxVec qch = wg * tt;
+        FxVec qf  = wg * tt + wj * u + s;
+        FxVec qg  = wf * s + wk * v + tt;
+        FxVec qj  = wf * s + wk * v + u;
+        FxVec qk  = wg * tt + wj * u + v;
+        FxVec qin = wj * u;
+        FxVec qlo = wk * v;
+
+        FxVec rcpW = one / (FxSet(2.0f) * (qbe + qch + qin + qlo) + qf + qg + qj + qk);
+
+        for (int c = 0; c < 3; c++)
+        {
+            const FxTaps& p   = taps[c];
+            FxVec         sum = (p.b + p.e) * qbe + (p.c + p.h) * qch + (p.i + p.n) * qin + (p.l + p.o) * qlo + p.f * qf + p.g * qg + p.j * qj +
+                        p.k * qk;
+            FxStore(out[c] + x, FxSat(sum * rcpW));
+        }
+        FxStore(out[FX_A] + x, BilinearAlpha(src, fy, fx, ppx, ppy));
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// FSR EASU, port of FsrEasuF()
+//--------------------------------------------------------------------------------------------
+// Accumulate direction and length from the '+' around c weighted by the bilinear weight w
+inline void EasuSet(FxVec& dirX, FxVec& dirY, FxVec& len, FxVec w, FxVec lA, FxVec lB, FxVec lC, FxVec lD, FxVec lE)
+{
+    FxVec dc   = lD - lC;
+    FxVec cb   = lC - lB;
+    FxVec lenX = FxRcp(FxMax(FxAbs(dc), FxAbs(cb)));
+    FxVec dx   = lD - lB;
+    dirX       = dirX + dx * w;
+    lenX       = FxSat(FxAbs(dx) * lenX);
+    len        = len + lenX * lenX * w;
+
+    FxVec ec   = lE - lC;
+    FxVec ca   = lC - lA;
+    FxVec lenY = FxRcp(FxMax(FxAbs(ec), FxAbs(ca)));
+    FxVec dy   = lE - lA;
+    dirY       = dirY + dy * w;
+    lenY       = FxSat(FxAbs(dy) * lenY);
+    len        = len + lenY * lenY * w;
+}
+
+// Simplest multi-channel approximate luma, times 2
+inline FxVec EasuLuma(FxVec r, FxVec g, FxVec b)
+{
+    return b * FxSet(0.5f) + (r * FxSet(0.5f) + g);
+}
+
+struct EasuKernel
+{
+    FxVec dirX, dirY;
+    FxVec len2X, len2Y;
+    FxVec lob, clp;
+};
+
+// Weight of a tap at offset (offX, offY) from the resolve position, approximated lanczos2
+inline FxVec EasuTapWeight(const EasuKernel& k, FxVec offX, FxVec offY)
+{
+    FxVec vx = (offX * k.dirX + offY * k.dirY) * k.len2X;
+    FxVec vy = (offY * k.dirX - offX * k.dirY) * k.len2Y;
+    FxVec d2 = FxMin(vx * vx + vy * vy, k.clp);
+    FxVec wB = FxSet(2.0f / 5.0f) * d2 - FxSet(1.0f);
+    FxVec wA = k.lob * d2 - FxSet(1.0f);
+    wB       = wB * wB;
+    wA       = wA * wA;
+    wB       = FxSet(25.0f / 16.0f) * wB - FxSet(25.0f / 16.0f - 1.0f);
+    return wB * wA;
+}
+
+void EasuRow(const FxPlanes& src, int y, const FxPlanes& dst, const FxScaling& scaling)
+{
+    float     fracY;
+    const int fy  = ScaledRow(scaling, y, src.height, fracY);
+    FxVec     ppy = FxSet(fracY);
+
+    float* out[FX_CHANNELS] = {FxRow(dst, FX_R, y), FxRow(dst, FX_G, y), FxRow(dst, FX_B, y), FxRow(dst, FX_A, y)};
+
+    int    fx[FxLanes];
+    FxTaps taps[3];
+    for (int x = 0; x < dst.width; x += FxLanes)
+    {
+        FxVec ppx = ScaledColumns(scaling, x, src.width, fx);
+        for (int c = 0; c < 3; c++)
+            taps[c].Load(src, c, fy, fx);
+
+        // Luma times 2
+        const FxTaps* r = &taps[FX_R];
+        const FxTaps* g = &taps[FX_G];
+        const FxTaps* b = &taps[FX_B];
+        FxTaps        luma;
+        luma.b = EasuLuma(r->b, g->b, b->b);
+        luma.c = EasuLuma(r->c, g->c, b->c);
+        luma.e = EasuLuma(r->e, g->e, b->e);
+        luma.f = EasuLuma(r->f, g->f, b->f);
+        luma.g = EasuLuma(r->g, g->g, b->g);
+        luma.h = EasuLuma(r->h, g->h, b->h);
+        luma.i = EasuLuma(r->i, g->i, b->i);
+        luma.j = EasuLuma(r->j, g->j, b->j);
+        luma.k = EasuLuma(r->k, g->k, b->k);
+        luma.l = EasuLuma(r->l, g->l, b->l);
+        luma.n = EasuLuma(r->n, g->n, b->n);
+        luma.o = EasuLuma(r->o, g->o, b->o);
+
+        // Accumulate for bilinear interpolation
+        FxVec one  = FxSet(1.0f);
+        FxVec half = FxSet(0.5f);
+        FxVec zero = FxSet(0.0f);
+        FxVec dirX = zero, dirY = zero, len = zero;
+        EasuSet(dirX, dirY, len, (one - ppx) * (one - ppy), luma.b, luma.e, luma.f, luma.g, luma.j);
+        EasuSet(dirX, dirY, len, ppx * (one - ppy), luma.c, luma.f, luma.g, luma.h, luma.k);
+        EasuSet(dirX, dirY, len, (one - ppx) * ppy, luma.f, luma.i, luma.j, luma.k, luma.n);
+        EasuSet(dirX, dirY, len, ppx * ppy, luma.g, luma.j, luma.k, luma.l, luma.o);
+
+        // Normalize, and cleanup close to zero
+        FxVec  dirR = dirX * dirX + dirY * dirY;
+        FxMask zro  = FxLess(dirR, FxSet(1.0f / 32768.0f));
+        dirR        = FxSelect(zro, one, one / FxSqrt(FxMax(dirR, FxSet(FLT_MIN))));
+        dirX        = FxSelect(zro, one, dirX);
+
+        EasuKernel k;
+        k.dirX = dirX * dirR;
+        k.dirY = dirY * dirR;
+
+        // Transform from {0 to 2} to {0 to 1} range, and shape with square
+        len = len * half;
+        len = len * len;
+
+        // Stretch kernel {1.0 vert|horz, to sqrt(2.0) on diagonal}
+        FxVec stretch = (k.dirX * k.dirX + k.dirY * k.dirY) * FxRcp(FxMax(FxAbs(k.dirX), FxAbs(k.dirY)));
+        k.len2X       = one + (stretch - one) * len;
+        k.len2Y       = one - half * len;
+        k.lob         = half + FxSet((1.0f / 4.0f - 0.04f) - 0.5f) * len;
+        k.clp         = FxRcp(k.lob);
+
+        // Offsets of the taps from the resolve position
+        FxVec ox[4] = {zero - ppx, one - ppx, FxSet(-1.0f) - ppx, FxSet(2.0f) - ppx};  // x = 0, 1, -1, 2
+        FxVec oy[4] = {zero - ppy, one - ppy, FxSet(-1.0f) - ppy, FxSet(2.0f) - ppy};  // y = 0, 1, -1, 2
+
+        FxVec wb = EasuTapWeight(k, ox[0], oy[2]);
+        FxVec wc = EasuTapWeight(k, ox[1], oy[2]);
+        FxVec we = EasuTapWeight(k, ox[2], oy[0]);
+        FxVec wf = EasuTapWeight(k, ox[0], oy[0]);
+        FxVec wg = EasuTapWeight(k, ox[1], oy[0]);
+        FxVec wh = EasuTapWeight(k, ox[3], oy[0]);
+        FxVec wi = EasuTapWeight(k, ox[2], oy[1]);
+        FxVec wj = EasuTapWeight(k, ox[0], oy[1]);
+        FxVec wk = EasuTapWeight(k, ox[1], oy[1]);
+        FxVec wl = EasuTapWeight(k, ox[3], oy[1]);
+        FxVec wn = EasuTapWeight(k, ox[0], oy[3]);
+        FxVec wo = EasuTapWeight(k, ox[1], oy[3]);
+
+        FxVec rcpW = one / (wb + wc + we + wf + wg + wh + wi + wj + wk + wl + wn + wo);
+
+        for (int c = 0; c < 3; c++)
+        {
+            const FxTaps& p = taps[c];
+            // Dering against the 4 nearest
+            FxVec mn4 = FxMin(FxMin3(p.f, p.g, p.j), p.k);
+            FxVec mx4 = FxMax(FxMax3(p.f, p.g, p.j), p.k);
+            FxVec sum = p.b * wb + p.c * wc + p.e * we + p.f * wf + p.g * wg + p.h * wh + p.i * wi + p.j * wj + p.k * wk + p.l * wl + p.n * wn +
+                        p.o * wo;
+            FxStore(out[c] + x, FxMin(mx4, FxMax(mn4, sum * rcpW)));
+        }
+        FxStore(out[FX_A] + x, BilinearAlpha(src, fy, fx, ppx, ppy));
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+// FSR RCAS, port of FsrRcasF() without FSR_RCAS_DENOISE
+//--------------------------------------------------------------------------------------------
+#define FX_RCAS_LIMIT (0.25f - (1.0f / 16.0f))
+
+void RcasRow(const FxPlanes& src, int y, float sharpness, float* const out[FX_CHANNELS])
+{
+    const float* rows[3][3];
+    for (int c = 0; c < 3; c++)
+    {
+        rows[c][0] = FxRow(src, c, y - 1);
+        rows[c][1] = FxRow(src, c, y);
+        rows[c][2] = FxRow(src, c, y + 1);
+    }
+
+    for (int x = 0; x < src.width; x += FxLanes)
+    {
+        //    b
+        //  d e f
+        //    h
+        FxVec b[3], d[3], e[3], f[3], h[3];
+        FxVec lobe = FxSet(-FLT_MAX);
+        for (int c = 0; c < 3; c++)
+        {
+            b[c] = FxLoad(rows[c][0] + x);
+            d[c] = FxLoad(rows[c][1] + x - 1);
+            e[c] = FxLoad(rows[c][1] + x);
+            f[c] = FxLoad(rows[c][1] + x + 1);
+            h[c] = FxLoad(rows[c][2] + x);
+
+            // Min and max of ring, then the limiters which need to be exact rcps
+            FxVec mn4    = FxMin(FxMin3(b[c], d[c], f[c]), h[c]);
+            FxVec mx4    = FxMax(FxMax3(b[c], d[c], f[c]), h[c]);
+            FxVec hitMin = FxMin(mn4, e[c]) * FxRcp(FxSet(4.0f) * mx4);
+            FxVec hitMax = (FxSet(1.0f) - FxMax(mx4, e[c])) / FxMin(FxSet(4.0f) * mn4 - FxSet(4.0f), FxSet(-FLT_MIN));
+            lobe         = FxMax(lobe, FxMax(FxSet(0.0f) - hitMin, hitMax));
+        }
+        lobe = FxMax(FxSet(-FX_RCAS_LIMIT), FxMin(lobe, FxSet(0.0f))) * FxSet(sharpness);
+
+        FxVec rcpL = FxSet(1.0f) / (FxSet(4.0f) * lobe + FxSet(1.0f));
+        for (int c = 0; c < 3; c++)
+            FxStore(out[c] + x, (lobe * (b[c] + d[c] + h[c] + f[c]) + e[c]) * rcpL);
+    }
+
+    memcpy(out[FX_A], FxRow(src, FX_A, y), src.width * sizeof(float));
+}
+
+const FxKernels FxKernelTable = {CasRowNoScaling, CasRowScaling, EasuRow, RcasRow};
+
+}  // namespace
+
+#endif
@@ -97,16 +97,39 @@ int Plugin_CFilterFx::TC_PluginGetVersion(TC_PluginVersion* pPluginVersion)
 //--------------------------------------------------------------------------------------------
 // DirectX Filter
 //--------------------------------------------------------------------------------------------
+#ifdef _WIN32
 void Plugin_CFilterFx::Error(TCHAR* pszCaption, TC_ErrorLevel errorLevel, UINT nErrorString)
 {
     // Add code to print message to caller
 }
+#endif
+
+//--------------------------------------------------------------------------------------------
+// CPU Filter
+//--------------------------------------------------------------------------------------------
+int Plugin_CFilterFx::CpuCFilter(CMP_MipSet* srcMipSet, CMP_MipSet* dstMipSet, CMP_CFilterParams* pCFilterParams)
+{
+    if (!CpuResources::IsFormatSupported(srcMipSet->m_format))
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+
+    if (pCFilterParams->nFxFilter == CMP_FX_FILTER_FSR)
+        return m_CpuResources.FSR(pCFilterParams->fSharpness, srcMipSet, dstMipSet);
+
+    return m_CpuResources.CAS(pCFilterParams->fSharpness, pCFilterParams->useSRGB, srcMipSet, dstMipSet);
+}
 
 int Plugin_CFilterFx::TC_CFilter(CMP_MipSet* srcMipSet, CMP_MipSet* dstMipSet, CMP_CFilterParams* pCFilterParams)
 {
     int result = CMP_OK;
 
+    if (!srcMipSet || !dstMipSet || !pCFilterParams)
+        return CMP_ERR_GENERIC;
+
 #ifdef _WIN32
+    // The DirectX path only implements CAS
+    if ((pCFilterParams->nFxBackend == CMP_FX_BACKEND_CPU) || (pCFilterParams->nFxFilter == CMP_FX_FILTER_FSR))
+        return CpuCFilter(srcMipSet, dstMipSet, pCFilterParams);
+
     assert(m_GpuResources);
     if (!initialized)
     {
@@ -176,6 +199,8 @@ int Plugin_CFilterFx::TC_CFilter(CMP_MipSet* srcMipSet, CMP_MipSet* dstMipSet, C
 
     deviceContext->Unmap(dstStagingTexture, 0);
     dstStagingTexture.Release();
+#else
+    result = CpuCFilter(srcMipSet, dstMipSet, pCFilterParams);
 #endif
-    return CMP_OK;
+    return result;
 }
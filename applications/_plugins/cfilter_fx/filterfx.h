@@ -27,6 +27,7 @@
 
 #include "plugininterface.h"
 #include "cmp_plugininterface.h"
+#include "cpuresources.h"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -65,8 +66,12 @@ public:
     int TC_CFilter(CMP_MipSet* srcMipSet, CMP_MipSet* dstMipSet, CMP_CFilterParams* pCFilterParams);
 
 private:
+#ifdef _WIN32
     void Error(TCHAR* pszCaption, TC_ErrorLevel errorLevel, UINT nErrorString);
+#endif
+    int  CpuCFilter(CMP_MipSet* srcMipSet, CMP_MipSet* dstMipSet, CMP_CFilterParams* pCFilterParams);
     bool initialized = false;
+    CpuResources m_CpuResources;
 #ifdef _WIN32
     std::unique_ptr<GpuResources> m_GpuResources;
 #endif
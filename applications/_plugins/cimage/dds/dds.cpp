@@ -25,6 +25,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <vector>
+
 #include "common.h"
 #include "compressonator.h"
 #include "tc_pluginapi.h"
@@ -130,19 +132,55 @@ int Plugin_DDS::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         return PE_Unknown;
     }
 
-    CMP_DWORD dwFileHeader;
-    fread(&dwFileHeader, sizeof(CMP_DWORD), 1, pFile);
+    // Read the whole file with one call, the loaders copy the levels out of it
+    std::vector<CMP_BYTE> fileData;
+    long                  fileSize = -1;
+    if (fseek(pFile, 0, SEEK_END) == 0)
+    {
+        fileSize = ftell(pFile);
+        if (fseek(pFile, 0, SEEK_SET) != 0)
+            fileSize = -1;
+    }
+    if (fileSize > 0)
+    {
+        fileData.resize(fileSize);
+        if (fread(fileData.data(), 1, fileSize, pFile) != (size_t)fileSize)
+            fileSize = -1;
+    }
+    fclose(pFile);
+
+    if (fileSize <= 0)
+    {
+        DDS_CMips->PrintError("Error [%x]: DDS Plugin Failed to load texture file %s\n", IDS_ERROR_FILE_OPEN, pszFilename);
+        return PE_Unknown;
+    }
+
+    DDS_Stream stream = {fileData.data(), fileData.size(), 0};
+    return LoadTexture(&stream, pszFilename, pMipSet);
+}
+
+int Plugin_DDS::TC_PluginMemoryLoadTexture(const void* pBuffer, size_t size, MipSet* pMipSet)
+{
+    const char* pszName = "<memory>";
+    g_pszFilename       = pszName;
+
+    DDS_Stream stream = {(const CMP_BYTE*)pBuffer, size, 0};
+    return LoadTexture(&stream, pszName, pMipSet);
+}
+
+int Plugin_DDS::LoadTexture(DDS_Stream* pFile, const char* pszFilename, MipSet* pMipSet)
+{
+    CMP_DWORD dwFileHeader = 0;
+    DDS_Read(&dwFileHeader, sizeof(CMP_DWORD), 1, pFile);
     if (dwFileHeader != DDS_HEADER)
     {
-        fclose(pFile);
         DDS_CMips->PrintError("Error [%x]: DDS Plugin Failed to load texture file %s\n", IDS_ERROR_NOT_DDS, pszFilename);
         return PE_Unknown;
     }
 
     DDSD2 ddsd;
-    if (fread(&ddsd, sizeof(DDSD2), 1, pFile) != 1)
+    if (DDS_Read(&ddsd, sizeof(DDSD2), 1, pFile) != 1)
     {
-        fclose(pFile);
         DDS_CMips->PrintError("Error [%x]: DDS Plugin Failed to load texture file %s\n", IDS_ERROR_NOT_DDS, pszFilename);
         return PE_Unknown;
     }
@@ -151,7 +189,6 @@ int Plugin_DDS::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         ddsd.dwMipMapCount = 1;
     else if (ddsd.dwMipMapCount == 0)
     {
-        fclose(pFile);
         DDS_CMips->PrintError("Error [%x]: DDS Plugin Failed to load texture file %s\n", IDS_ERROR_NOT_DDS, pszFilename);
         return PE_Unknown;
     }
@@ -242,8 +279,6 @@ int Plugin_DDS::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         return LoadDDS_RGB8888(pFile, &ddsd, pMipSet, (ddsd.ddpfPixelFormat.dwFlags & DDPF_ALPHAPIXELS) ? true : false);
     }
 
-    fclose(pFile);
-
     DDS_CMips->PrintError("Error [%x]: DDS Plugin Failed to load texture file %s\n", IDS_ERROR_UNSUPPORTED_TYPE, pszFilename);
     return PE_Unknown;
 }
@@ -28,6 +28,10 @@
 #include "cmp_plugininterface.h"
 #include "plugininterface.h"
 
+#include <stdio.h>
+
+struct DDS_Stream;
+
 #ifdef _WIN32
 #include "ddraw.h"
 #include "d3d9types.h"
@@ -62,6 +66,10 @@ public:
     int TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet);
     int TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* srcTexture);
     int TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* srcTexture);
+    int TC_PluginMemoryLoadTexture(const void* pBuffer, size_t size, MipSet* pMipSet);
+
+private:
+    int LoadTexture(DDS_Stream* pFile, const char* pszFilename, MipSet* pMipSet);
 };
 
 extern CMIPS* DDS_CMips;
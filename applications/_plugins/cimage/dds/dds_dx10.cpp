@@ -45,21 +45,21 @@
 #include "version.h"
 #include "texture.h"
 
-TC_PluginError LoadDDS_DX10_RGBA_32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_RGBA32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_RGBA_16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_RGBA16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_RG32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R10G10B10A2(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R9G9B9E5_SHAREDEXP(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R11G11B10F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R8G8B8A8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R16G16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R8G8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_R8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_DX10_FourCC(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, CMP_DWORD dwFourCC);
+TC_PluginError LoadDDS_DX10_RGBA_32F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_RGBA32(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_RGBA_16F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_RGBA16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_RG32(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R10G10B10A2(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R9G9B9E5_SHAREDEXP(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R11G11B10F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R8G8B8A8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R16G16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R32(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R8G8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_R8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_DX10_FourCC(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet, CMP_DWORD dwFourCC);
 
 extern int CMP_MaxFacesOrSlices(const MipSet* pMipSet, int nMipLevel);
 
@@ -75,11 +75,11 @@ typedef struct
 // TODO: This function doesn't set pMipSet->m_format for all loaded DDS images
 // this is mostly fine because we assume RGBA8888 by default, and most of these functions convert to that format
 // but this isn't the case for everything, so a better solution should probably be sought out
-TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     DDS_HEADER_DDS10 HeaderDDS10;
     ;
-    fread(&HeaderDDS10, sizeof(HeaderDDS10), 1, pFile);
+    DDS_Read(&HeaderDDS10, sizeof(HeaderDDS10), 1, pFile);
 
     TC_PluginError err = PE_Unknown;
 
@@ -255,42 +255,41 @@ TC_PluginError LoadDDS_DX10(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
         assert(0);
     }
 
-    fclose(pFile);
 
     return err;
 }
 
-TC_PluginError LoadDDS_DX10_RGBA_32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_RGBA_32F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float32, TDT_ARGB, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
 }
 
-TC_PluginError LoadDDS_DX10_RGBA32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_RGBA32(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_32bit, TDT_ARGB, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
 }
 
-TC_PluginError LoadDDS_DX10_RGBA_16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_RGBA_16F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float16, TDT_ARGB, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
 }
 
-TC_PluginError LoadDDS_DX10_RGBA16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_RGBA16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float16, TDT_ARGB, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
 }
 
-TC_PluginError LoadDDS_DX10_RG32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_RG32(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_32bit, TDT_XRGB, PreLoopABGR32, LoopR32G32, PreLoopABGR32);
 }
 
-TC_PluginError LoadDDS_DX10_R10G10B10A2(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R10G10B10A2(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     pMipSet->m_TextureDataType   = TDT_ARGB;
     ChannelFormat channelFormat  = CF_1010102;
@@ -299,7 +298,7 @@ TC_PluginError LoadDDS_DX10_R10G10B10A2(FILE* pFile, DDSD2* pDDSD, MipSet* pMipS
         pFile, pDDSD, pMipSet, pChannelFormat, channelFormat, pMipSet->m_TextureDataType, PreLoopDefault, LoopR10G10B10A2, PostLoopDefault);
 }
 
-TC_PluginError LoadDDS_DX10_R9G9B9E5_SHAREDEXP(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R9G9B9E5_SHAREDEXP(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     pMipSet->m_TextureDataType   = TDT_XRGB;
     ChannelFormat channelFormat  = CF_Float9995E;
@@ -307,7 +306,7 @@ TC_PluginError LoadDDS_DX10_R9G9B9E5_SHAREDEXP(FILE* pFile, DDSD2* pDDSD, MipSet
     return GenericLoadFunction(pFile, pDDSD, pMipSet, pChannelFormat, channelFormat, pMipSet->m_TextureDataType, PreLoopDefault, LoopR9G9B9E5, PostLoopDefault);
 }
 
-TC_PluginError LoadDDS_DX10_R11G11B10F(FILE* /*pFile*/, DDSD2* /*pDDSD*/, MipSet* /*pMipSet*/)
+TC_PluginError LoadDDS_DX10_R11G11B10F(DDS_Stream* /*pFile*/, DDSD2* /*pDDSD*/, MipSet* /*pMipSet*/)
 {
     return PE_Unknown;
     /*
@@ -316,7 +315,7 @@ TC_PluginError LoadDDS_DX10_R11G11B10F(FILE* /*pFile*/, DDSD2* /*pDDSD*/, MipSet
     */
 }
 
-TC_PluginError LoadDDS_DX10_R8G8B8A8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R8G8B8A8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     ARGB8888Struct* pARGB8888Struct = (ARGB8888Struct*)calloc(sizeof(ARGB8888Struct), 1);
     void*           extra           = pARGB8888Struct;
@@ -335,37 +334,37 @@ TC_PluginError LoadDDS_DX10_R8G8B8A8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, pMipSet->m_TextureDataType, PreLoopRGB8888, LoopRGB8888, PostLoopRGB8888);
 }
 
-TC_PluginError LoadDDS_DX10_R16G16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R16G16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_16bit, TDT_XRGB, PreLoopABGR16, LoopR16G16, PreLoopABGR16);
 }
 
-TC_PluginError LoadDDS_DX10_R8G8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R8G8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB8888, LoopR8G8, PreLoopRGB8888);
 }
 
-TC_PluginError LoadDDS_DX10_R32(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R32(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_32bit, TDT_XRGB, PreLoopABGR32, LoopR32, PostLoopABGR32);
 }
 
-TC_PluginError LoadDDS_DX10_R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_16bit, TDT_XRGB, PreLoopABGR16, LoopR16, PostLoopABGR16);
 }
 
-TC_PluginError LoadDDS_DX10_R8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_DX10_R8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void* extra;
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB8888, LoopR8, PreLoopRGB8888);
 }
 
-TC_PluginError LoadDDS_DX10_FourCC(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, CMP_DWORD /*dwFourCC*/)
+TC_PluginError LoadDDS_DX10_FourCC(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet, CMP_DWORD /*dwFourCC*/)
 {
     void* extra;
     return GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopFourCC, LoopFourCC, PostLoopFourCC);
@@ -48,11 +48,10 @@
 #include "texture.h"
 #include "atiformats.h"
 
-TC_PluginError LoadDDS_FourCC(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_FourCC(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopFourCC, LoopFourCC, PostLoopFourCC);
-    fclose(pFile);
 
     // Try to set MipSet format for know FourCC formats
     if (pMipSet->m_format == CMP_FORMAT_Unknown)
@@ -61,25 +60,23 @@ TC_PluginError LoadDDS_FourCC(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
     return err;
 }
 
-TC_PluginError LoadDDS_RGB565(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_RGB565(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB565, LoopRGB565, PostLoopRGB565);
     //pMipSet->m_format  = CMP_FORMAT_RGB_565;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_RGB888(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_RGB888(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, TDT_XRGB, PreLoopRGB888, LoopRGB888, PostLoopRGB888);
     pMipSet->m_format  = CMP_FORMAT_ARGB_8888;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_RGB8888(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha)
+TC_PluginError LoadDDS_RGB8888(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha)
 {
     ARGB8888Struct* pARGB8888Struct = (ARGB8888Struct*)calloc(sizeof(ARGB8888Struct), 1);
     void*           extra           = pARGB8888Struct;
@@ -155,11 +152,10 @@ TC_PluginError LoadDDS_RGB8888(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool
     pMipSet->m_TextureDataType = bAlpha ? TDT_ARGB : TDT_XRGB;
 
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, pMipSet->m_TextureDataType, PreLoopRGB8888, LoopRGB8888, PostLoopRGB8888);
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_RGB8888_S(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha)
+TC_PluginError LoadDDS_RGB8888_S(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha)
 {
     ARGB8888Struct* pARGB8888Struct = (ARGB8888Struct*)calloc(sizeof(ARGB8888Struct), 1);
     void*           extra           = pARGB8888Struct;
@@ -214,11 +210,10 @@ TC_PluginError LoadDDS_RGB8888_S(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, boo
     pMipSet->m_TextureDataType = bAlpha ? TDT_ARGB : TDT_XRGB;
 
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_8bit, pMipSet->m_TextureDataType, PreLoopRGB8888, LoopRGB8888_S, PostLoopRGB8888);
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_ARGB2101010(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_ARGB2101010(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     pMipSet->m_TextureDataType    = TDT_ARGB;
     ChannelFormat  channelFormat  = CF_2101010;
@@ -233,11 +228,10 @@ TC_PluginError LoadDDS_ARGB2101010(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
                                              (pDDSD->ddpfPixelFormat.dwRBitMask == 0x3ff00000) ? LoopR10G10B10A2 : LoopDefault,
                                              PostLoopDefault);
     pMipSet->m_format             = CMP_FORMAT_ARGB_2101010;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_RGBA1010102(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_RGBA1010102(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     pMipSet->m_TextureDataType    = TDT_ARGB;
     ChannelFormat  channelFormat  = CF_1010102;
@@ -252,124 +246,110 @@ TC_PluginError LoadDDS_RGBA1010102(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
                                              (pDDSD->ddpfPixelFormat.dwRBitMask == 0xffc00000) ? LoopR10G10B10A2 : LoopDefault,
                                              PostLoopDefault);
     pMipSet->m_format             = CMP_FORMAT_RGBA_1010102;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_ABGR32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_ABGR32F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float32, TDT_ARGB, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
     pMipSet->m_format  = CMP_FORMAT_ARGB_32F;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_GR32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_GR32F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float32, TDT_RG, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
     //pMipSet->m_format  = CMP_FORMAT_GR32F;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_R32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_R32F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float32, TDT_R, PreLoopABGR32F, LoopABGR32F, PostLoopABGR32F);
     //pMipSet->m_format  = CMP_FORMAT_R32F;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_R16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_R16F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float16, TDT_R, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
     //pMipSet->m_format  = CMP_FORMAT_R16F;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_G16R16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_G16R16F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float16, TDT_RG, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
     //pMipSet->m_format  = CMP_FORMAT_G16R16F;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_ABGR16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_ABGR16F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Float16, TDT_ARGB, PreLoopABGR16F, LoopABGR16F, PostLoopABGR16F);
     pMipSet->m_format  = CMP_FORMAT_ABGR_16F;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_G8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_G8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopG8, LoopG8, PostLoopG8);
     //pMipSet->m_format  = CMP_FORMAT_G8;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_AG8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_AG8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_ARGB, PreLoopAG8, LoopAG8, PostLoopAG8);
     //pMipSet->m_format  = CMP_FORMAT_AG8;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_G16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_G16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_XRGB, PreLoopG16, LoopG16, PostLoopG16);
     //pMipSet->m_format  = CMP_FORMAT_G16;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_A8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_A8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_Compressed, TDT_ARGB, PreLoopA8, LoopA8, PostLoopA8);
     //pMipSet->m_format  = CMP_FORMAT_A8;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_ABGR16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_ABGR16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_16bit, TDT_ARGB, PreLoopABGR16, LoopABGR16, PostLoopABGR16);
     pMipSet->m_format  = CMP_FORMAT_ABGR_16;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_G16R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_G16R16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_16bit, TDT_RG, PreLoopG16R16, LoopABGR16, PostLoopG16R16);
     //pMipSet->m_format  = CMP_FORMAT_G16R16;
-    fclose(pFile);
     return err;
 }
 
-TC_PluginError LoadDDS_R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet)
+TC_PluginError LoadDDS_R16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet)
 {
     void*          extra;
     TC_PluginError err = GenericLoadFunction(pFile, pDDSD, pMipSet, extra, CF_16bit, TDT_R, PreLoopR16, LoopR16, PostLoopR16);
     pMipSet->m_format  = CMP_FORMAT_R_16;
-    fclose(pFile);
     return err;
 }
 
@@ -574,26 +574,39 @@ static const CMP_DWORD DDS_HEADER = CMP_MAKEFOURCC('D', 'D', 'S', ' ');
 #define DDS_CUBEMAP 0x00000200                  // DDSCAPS2_CUBEMAP
 #define DDS_FLAGS_VOLUME 0x00200000             // DDSCAPS2_VOLUME
 
-TC_PluginError LoadDDS_ABGR32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_ABGR16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_GR32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_R32F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_R16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_G16R16F(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_FourCC(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_RGB565(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_RGB888(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_RGB8888(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha);
-TC_PluginError LoadDDS_RGB8888_S(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha);
-TC_PluginError LoadDDS_ARGB2101010(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_RGBA1010102(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_ABGR16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_G16R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_R16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_G8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_G16(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_AG8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError LoadDDS_A8(FILE* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+// Read position in a DDS image held in memory, the loaders read through it in place of a FILE
+struct DDS_Stream
+{
+    const CMP_BYTE* pData;
+    size_t          size;
+    size_t          pos;
+};
+
+// Same semantics as fread, fseek and ftell
+size_t DDS_Read(void* pBuffer, size_t size, size_t count, DDS_Stream* pStream);
+int    DDS_Seek(DDS_Stream* pStream, long offset, int origin);
+long   DDS_Tell(const DDS_Stream* pStream);
+
+TC_PluginError LoadDDS_ABGR32F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_ABGR16F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_GR32F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_R32F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_R16F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_G16R16F(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_FourCC(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_RGB565(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_RGB888(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_RGB8888(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha);
+TC_PluginError LoadDDS_RGB8888_S(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet, bool bAlpha);
+TC_PluginError LoadDDS_ARGB2101010(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_RGBA1010102(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_ABGR16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_G16R16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_R16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_G8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_G16(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_AG8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
+TC_PluginError LoadDDS_A8(DDS_Stream* pFile, DDSD2* pDDSD, MipSet* pMipSet);
 
 TC_PluginError SaveDDS_ABGR32F(FILE* pFile, const MipSet* pMipSet);
 TC_PluginError SaveDDS_RG32F(FILE* pFile, const MipSet* pMipSet);
@@ -27,6 +27,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <limits>
 
@@ -37,11 +38,55 @@
 #include "version.h"
 
 extern int CMP_MaxFacesOrSlices(const MipSet* pMipSet, int nMipLevel);
-typedef TC_PluginError(PreLoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+
+size_t DDS_Read(void* pBuffer, size_t size, size_t count, DDS_Stream* pStream)
+{
+    if (size == 0 || pStream->pos >= pStream->size)
+        return 0;
+
+    size_t available = (pStream->size - pStream->pos) / size;
+    if (count > available)
+        count = available;
+
+    memcpy(pBuffer, pStream->pData + pStream->pos, size * count);
+    pStream->pos += size * count;
+    return count;
+}
+
+int DDS_Seek(DDS_Stream* pStream, long offset, int origin)
+{
+    long base;
+    switch (origin)
+    {
+    case SEEK_SET:
+        base = 0;
+        break;
+    case SEEK_CUR:
+        base = (long)pStream->pos;
+        break;
+    case SEEK_END:
+        base = (long)pStream->size;
+        break;
+    default:
+        return -1;
+    }
+
+    if (base + offset < 0)
+        return -1;
+
+    pStream->pos = (size_t)(base + offset);
+    return 0;
+}
+
+long DDS_Tell(const DDS_Stream* pStream)
+{
+    return (long)pStream->pos;
+}
+typedef TC_PluginError(PreLoopFunction)(DDS_Stream*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
 typedef TC_PluginError(
-    LoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-typedef TC_PluginError(PostLoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
-TC_PluginError GenericLoadFunction(FILE*&           pFile,
+    LoopFunction)(DDS_Stream*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+typedef TC_PluginError(PostLoopFunction)(DDS_Stream*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+TC_PluginError GenericLoadFunction(DDS_Stream*&     pFile,
                                    DDSD2*&          pDDSD,
                                    MipSet*&         pMipSet,
                                    void*&           extra,
@@ -120,7 +165,7 @@ void DetermineTextureType(const DDSD2* pDDSD, MipSet* pMipSet)
     }
 }
 
-TC_PluginError GenericLoadFunction(FILE*&           pFile,
+TC_PluginError GenericLoadFunction(DDS_Stream*&     pFile,
                                    DDSD2*&          pDDSD,
                                    MipSet*&         pMipSet,
                                    void*&           extra,
@@ -196,12 +241,12 @@ TC_PluginError GenericLoadFunction(FILE*&           pFile,
     return fnPostLoop(pFile, pDDSD, pMipSet, extra);
 }
 
-TC_PluginError PreLoopDefault(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PreLoopDefault(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError LoopDefault(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopDefault(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
 
@@ -212,18 +257,18 @@ TC_PluginError LoopDefault(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (DDS_Read(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopDefault(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopDefault(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopFourCC(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
+TC_PluginError PreLoopFourCC(DDS_Stream*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
 {
     if (pDDSD->ddpfPixelFormat.dwFourCC == CMP_FOURCC_DXT1 && !(pDDSD->ddpfPixelFormat.dwFlags & DDPF_ALPHAPIXELS))
         pMipSet->m_TextureDataType = TDT_XRGB;
@@ -234,10 +279,10 @@ TC_PluginError PreLoopFourCC(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void
         pMipSet->m_dwFourCC2 = pDDSD->ddpfPixelFormat.dwPrivateFormatBitCount;
 
     // Get Data Size
-    long nCurrPos = ftell(pFile);
-    fseek(pFile, 0, SEEK_END);
-    long nSize = ftell(pFile) - nCurrPos;
-    fseek(pFile, nCurrPos, SEEK_SET);
+    long nCurrPos = DDS_Tell(pFile);
+    DDS_Seek(pFile, 0, SEEK_END);
+    long nSize = DDS_Tell(pFile) - nCurrPos;
+    DDS_Seek(pFile, nCurrPos, SEEK_SET);
 
     CMP_DWORD dwWidth;
     CMP_DWORD dwHeight;
@@ -270,7 +315,6 @@ TC_PluginError PreLoopFourCC(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void
         break;
     default:
         assert(0);
-        fclose(pFile);
         return PE_Unknown;
     }
     //make a DWORD, then cast to void*
@@ -280,7 +324,7 @@ TC_PluginError PreLoopFourCC(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void
     return PE_OK;
 }
 
-TC_PluginError LoopFourCC(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extra*/, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopFourCC(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extra*/, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
 
@@ -291,10 +335,10 @@ TC_PluginError LoopFourCC(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extr
 
     // Get Data Size
     // We need to read everything that we can as we don't know how big each mip-level is
-    long nCurrPos = ftell(pFile);
-    fseek(pFile, 0, SEEK_END);
-    long nSize = ftell(pFile) - nCurrPos;
-    fseek(pFile, nCurrPos, SEEK_SET);
+    long nCurrPos = DDS_Tell(pFile);
+    DDS_Seek(pFile, 0, SEEK_END);
+    long nSize = DDS_Tell(pFile) - nCurrPos;
+    DDS_Seek(pFile, nCurrPos, SEEK_SET);
 
     if (!DDS_CMips->AllocateCompressedMipLevelData(pMipLevel, dwWidth, dwHeight, nSize))
     {
@@ -302,7 +346,7 @@ TC_PluginError LoopFourCC(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extr
     }
 
     //read in the data....
-    if (fread(pMipLevel->m_pbData, nSize, 1, pFile) != 1)
+    if (DDS_Read(pMipLevel->m_pbData, nSize, 1, pFile) != 1)
     {
         //Error(PLUGIN_NAME, EL_Error, IDS_ERROR_FILE_OPEN, g_pszFilename);
         return PE_Unknown;
@@ -310,12 +354,12 @@ TC_PluginError LoopFourCC(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extr
     return PE_OK;
 }
 
-TC_PluginError PostLoopFourCC(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopFourCC(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopRGB565(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
+TC_PluginError PreLoopRGB565(DDS_Stream*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
@@ -326,7 +370,7 @@ TC_PluginError PreLoopRGB565(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& ext
     return extra ? PE_OK : PE_Unknown;
 }
 
-TC_PluginError LoopRGB565(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopRGB565(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     // Allocate the permanent buffer and unpack the bitmap data into it
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
@@ -336,7 +380,7 @@ TC_PluginError LoopRGB565(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra,
         return PE_Unknown;
     }
 
-    if (fread(extra, pMipLevel->m_dwLinearSize / 2, 1, pFile) != 1)
+    if (DDS_Read(extra, pMipLevel->m_dwLinearSize / 2, 1, pFile) != 1)
     {
         free(extra);
         return PE_Unknown;
@@ -357,13 +401,13 @@ TC_PluginError LoopRGB565(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra,
     return PE_OK;
 }
 
-TC_PluginError PostLoopRGB565(FILE*&, DDSD2*&, MipSet*&, void*& extra)
+TC_PluginError PostLoopRGB565(DDS_Stream*&, DDSD2*&, MipSet*&, void*& extra)
 {
     free(extra);
     return PE_OK;
 }
 
-TC_PluginError PreLoopRGB888(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
+TC_PluginError PreLoopRGB888(DDS_Stream*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
@@ -374,9 +418,9 @@ TC_PluginError PreLoopRGB888(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& ext
     return extra ? PE_OK : PE_Unknown;
 }
 
-TC_PluginError LoopRGB888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopRGB888(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
-    if (fread(extra, dwWidth * dwHeight * 3, 1, pFile) != 1)
+    if (DDS_Read(extra, dwWidth * dwHeight * 3, 1, pFile) != 1)
     {
         free(extra);
         return PE_Unknown;
@@ -410,20 +454,20 @@ TC_PluginError LoopRGB888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra,
     return PE_OK;
 }
 
-TC_PluginError PostLoopRGB888(FILE*&, DDSD2*&, MipSet*&, void*& extra)
+TC_PluginError PostLoopRGB888(DDS_Stream*&, DDSD2*&, MipSet*&, void*& extra)
 {
     free(extra);
     return PE_OK;
 }
 
-TC_PluginError PreLoopRGB8888(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopRGB8888(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopRGB8888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopRGB8888(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
 
@@ -436,7 +480,7 @@ TC_PluginError LoopRGB8888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra
     if (!(pARGB8888Struct->nFlags & EF_UseBitMasks))
     {
         //not using bitmasks
-        if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+        if (DDS_Read(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         {
             return PE_Unknown;
         }
@@ -444,7 +488,7 @@ TC_PluginError LoopRGB8888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra
     else
     {
         //using bitmasks
-        if (fread(pARGB8888Struct->pMemory, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+        if (DDS_Read(pARGB8888Struct->pMemory, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         {
             return PE_Unknown;
         }
@@ -466,7 +510,7 @@ TC_PluginError LoopRGB8888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra
     return PE_OK;
 }
 
-TC_PluginError LoopRGB8888_S(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopRGB8888_S(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
 
@@ -479,7 +523,7 @@ TC_PluginError LoopRGB8888_S(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& ext
     if (!(pARGB8888Struct->nFlags & EF_UseBitMasks))
     {
         //not using bitmasks
-        if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+        if (DDS_Read(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         {
             return PE_Unknown;
         }
@@ -487,7 +531,7 @@ TC_PluginError LoopRGB8888_S(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& ext
     else
     {
         //using bitmasks
-        if (fread(pARGB8888Struct->pMemory, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+        if (DDS_Read(pARGB8888Struct->pMemory, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         {
             return PE_Unknown;
         }
@@ -513,19 +557,19 @@ TC_PluginError LoopRGB8888_S(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& ext
     return PE_OK;
 }
 
-TC_PluginError PostLoopRGB8888(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopRGB8888(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopABGR32F(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopABGR32F(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopABGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopABGR32F(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -534,18 +578,18 @@ TC_PluginError LoopABGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (DDS_Read(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopABGR32F(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopABGR32F(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError LoopGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopGR32F(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -560,7 +604,7 @@ TC_PluginError LoopGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nM
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (DDS_Read(pTempData, dwSize, 1, pFile) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -582,7 +626,7 @@ TC_PluginError LoopGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nM
     return PE_OK;
 }
 
-TC_PluginError LoopR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR32F(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -597,7 +641,7 @@ TC_PluginError LoopR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (DDS_Read(pTempData, dwSize, 1, pFile) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -619,7 +663,7 @@ TC_PluginError LoopR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     return PE_OK;
 }
 
-TC_PluginError LoopR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR16F(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -634,7 +678,7 @@ TC_PluginError LoopR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     if (!pTempData)
         return PE_Unknown;
 
-    size_t dwBytesRead = fread(pTempData, 1, dwSize, pFile);
+    size_t dwBytesRead = DDS_Read(pTempData, 1, dwSize, pFile);
     if (dwBytesRead != dwSize)
     {
         free(pTempData);
@@ -657,14 +701,14 @@ TC_PluginError LoopR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     return PE_OK;
 }
 
-TC_PluginError PreLoopABGR16F(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopABGR16F(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopABGR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopABGR16F(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -673,25 +717,25 @@ TC_PluginError LoopABGR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (DDS_Read(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopABGR16F(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopABGR16F(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopG8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopG8(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = CMP_FOURCC_G8;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopG8(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -700,25 +744,25 @@ TC_PluginError LoopG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipL
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (DDS_Read(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopG8(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopG8(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopAG8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopAG8(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = CMP_FOURCC_AG8;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopAG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopAG8(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -727,25 +771,25 @@ TC_PluginError LoopAG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (DDS_Read(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopAG8(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopAG8(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopG16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopG16(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = CMP_FOURCC_G16;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopG16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopG16(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -754,25 +798,25 @@ TC_PluginError LoopG16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (DDS_Read(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopG16(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopG16(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopA8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopA8(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = CMP_FOURCC_A8;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopA8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopA8(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -781,25 +825,25 @@ TC_PluginError LoopA8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipL
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (DDS_Read(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopA8(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopA8(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopABGR16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopABGR16(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopABGR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopABGR16(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -808,25 +852,25 @@ TC_PluginError LoopABGR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (DDS_Read(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopABGR16(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopABGR16(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError PreLoopG16R16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopG16R16(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopG16R16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopG16R16(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -841,7 +885,7 @@ TC_PluginError LoopG16R16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (DDS_Read(pTempData, dwSize, 1, pFile) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -863,7 +907,7 @@ TC_PluginError LoopG16R16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     return PE_OK;
 }
 
-TC_PluginError PostLoopG16R16(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopG16R16(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
@@ -949,14 +993,14 @@ bool SetupDDSD_DX10(DDSD2& ddsd2, const MipSet* pMipSet, bool /*bCompressed*/)
     return true;
 }
 
-TC_PluginError PreLoopABGR32(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&)
+TC_PluginError PreLoopABGR32(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&)
 {
     pMipSet->m_dwFourCC  = 0;
     pMipSet->m_dwFourCC2 = 0;
     return PE_OK;
 }
 
-TC_PluginError LoopABGR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopABGR32(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -965,18 +1009,18 @@ TC_PluginError LoopABGR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (DDS_Read(pMipLevel->m_pbData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError PostLoopABGR32(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopABGR32(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError LoopR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR32(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -991,7 +1035,7 @@ TC_PluginError LoopR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
     if (!pTempData)
         return PE_Unknown;
 
-    size_t dwBytesRead = fread(pTempData, 1, dwSize, pFile);
+    size_t dwBytesRead = DDS_Read(pTempData, 1, dwSize, pFile);
     if (dwBytesRead != dwSize)
     {
         free(pTempData);
@@ -1014,7 +1058,7 @@ TC_PluginError LoopR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
     return PE_OK;
 }
 
-TC_PluginError LoopR8G8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR8G8(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1029,7 +1073,7 @@ TC_PluginError LoopR8G8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (DDS_Read(pTempData, dwSize, 1, pFile) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -1052,7 +1096,7 @@ TC_PluginError LoopR8G8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMi
     return PE_OK;
 }
 
-TC_PluginError LoopR32G32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR32G32(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1067,7 +1111,7 @@ TC_PluginError LoopR32G32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (DDS_Read(pTempData, dwSize, 1, pFile) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -1089,7 +1133,7 @@ TC_PluginError LoopR32G32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     return PE_OK;
 }
 
-TC_PluginError LoopR10G10B10A2(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR10G10B10A2(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1104,7 +1148,7 @@ TC_PluginError LoopR10G10B10A2(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&,
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (DDS_Read(pTempData, dwSize, 1, pFile) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -1125,7 +1169,7 @@ TC_PluginError LoopR10G10B10A2(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&,
     return PE_OK;
 }
 
-TC_PluginError LoopR9G9B9E5(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR9G9B9E5(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1134,13 +1178,13 @@ TC_PluginError LoopR9G9B9E5(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int
         return PE_Unknown;
     }
 
-    if (fread(pMipLevel->m_pfData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
+    if (DDS_Read(pMipLevel->m_pfData, pMipLevel->m_dwLinearSize, 1, pFile) != 1)
         return PE_Unknown;
 
     return PE_OK;
 }
 
-TC_PluginError LoopR16G16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR16G16(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1155,7 +1199,7 @@ TC_PluginError LoopR16G16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (DDS_Read(pTempData, dwSize, 1, pFile) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -1177,12 +1221,12 @@ TC_PluginError LoopR16G16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int n
     return PE_OK;
 }
 
-TC_PluginError PreLoopR16(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PreLoopR16(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError LoopR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR16(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it, for CMP we are always using RGBA buffer
@@ -1199,7 +1243,7 @@ TC_PluginError LoopR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
     if (!pTempData)
         return PE_Unknown;
 
-    size_t dwBytesRead = fread(pTempData, 1, dwSize, pFile);
+    size_t dwBytesRead = DDS_Read(pTempData, 1, dwSize, pFile);
     if (dwBytesRead != dwSize)
     {
         free(pTempData);
@@ -1223,12 +1267,12 @@ TC_PluginError LoopR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMip
     return PE_OK;
 }
 
-TC_PluginError PostLoopR16(FILE*&, DDSD2*&, MipSet*&, void*&)
+TC_PluginError PostLoopR16(DDS_Stream*&, DDSD2*&, MipSet*&, void*&)
 {
     return PE_OK;
 }
 
-TC_PluginError LoopR8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+TC_PluginError LoopR8(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
 {
     MipLevel* pMipLevel = DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
     // Allocate the permanent buffer and unpack the bitmap data into it
@@ -1243,7 +1287,7 @@ TC_PluginError LoopR8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipL
     if (!pTempData)
         return PE_Unknown;
 
-    if (fread(pTempData, dwSize, 1, pFile) != 1)
+    if (DDS_Read(pTempData, dwSize, 1, pFile) != 1)
     {
         free(pTempData);
         return PE_Unknown;
@@ -49,11 +49,11 @@ typedef enum _ExtraFlags
     EF_UseBitMasks = 0x1,
 } ExtraFlags;
 
-typedef TC_PluginError(PreLoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+typedef TC_PluginError(PreLoopFunction)(DDS_Stream*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
 typedef TC_PluginError(
-    LoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-typedef TC_PluginError(PostLoopFunction)(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
-TC_PluginError GenericLoadFunction(FILE*&           pFile,
+    LoopFunction)(DDS_Stream*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+typedef TC_PluginError(PostLoopFunction)(DDS_Stream*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+TC_PluginError GenericLoadFunction(DDS_Stream*&     pFile,
                                    DDSD2*&          pDDSD,
                                    MipSet*&         pMipSet,
                                    void*&           extra,
@@ -65,7 +65,7 @@ TC_PluginError GenericLoadFunction(FILE*&           pFile,
 
 bool           IsD3D10Format(const MipSet* pMipSet);
 void           DetermineTextureType(const DDSD2* pDDSD, MipSet* pMipSet);
-TC_PluginError GenericLoadFunction(FILE*&           pFile,
+TC_PluginError GenericLoadFunction(DDS_Stream*&     pFile,
                                    DDSD2*&          pDDSD,
                                    MipSet*&         pMipSet,
                                    void*&           extra,
@@ -74,68 +74,68 @@ TC_PluginError GenericLoadFunction(FILE*&           pFile,
                                    PreLoopFunction  fnPreLoop,
                                    LoopFunction     fnLoop,
                                    PostLoopFunction fnPostLoop);
-TC_PluginError PreLoopDefault(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError LoopDefault(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopDefault(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopFourCC(FILE*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
-TC_PluginError LoopFourCC(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extra*/, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopFourCC(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopRGB565(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
-TC_PluginError LoopRGB565(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopRGB565(FILE*&, DDSD2*&, MipSet*&, void*& extra);
-TC_PluginError PreLoopRGB888(FILE*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
-TC_PluginError LoopRGB888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopRGB888(FILE*&, DDSD2*&, MipSet*&, void*& extra);
-TC_PluginError PreLoopRGB8888(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopRGB8888(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopRGB8888_S(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopRGB8888(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopABGR32F(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopABGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopABGR32F(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError LoopGR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR32F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PreLoopABGR16F(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopABGR16F(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopABGR16F(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopG8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopG8(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopAG8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopAG8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopAG8(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopG16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopG16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopG16(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopA8(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopA8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopA8(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError PreLoopABGR16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopABGR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopABGR16(FILE*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopDefault(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError LoopDefault(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopDefault(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopFourCC(DDS_Stream*& pFile, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+TC_PluginError LoopFourCC(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& /*extra*/, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopFourCC(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopRGB565(DDS_Stream*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+TC_PluginError LoopRGB565(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopRGB565(DDS_Stream*&, DDSD2*&, MipSet*&, void*& extra);
+TC_PluginError PreLoopRGB888(DDS_Stream*&, DDSD2*& pDDSD, MipSet*& pMipSet, void*& extra);
+TC_PluginError LoopRGB888(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopRGB888(DDS_Stream*&, DDSD2*&, MipSet*&, void*& extra);
+TC_PluginError PreLoopRGB8888(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopRGB8888(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopRGB8888_S(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*& extra, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopRGB8888(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopABGR32F(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopABGR32F(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopABGR32F(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError LoopGR32F(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR32F(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR16F(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PreLoopABGR16F(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopABGR16F(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopABGR16F(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopG8(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopG8(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopG8(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopAG8(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopAG8(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopAG8(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopG16(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopG16(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopG16(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopA8(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopA8(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopA8(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopABGR16(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopABGR16(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopABGR16(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
 
-TC_PluginError PreLoopG16R16(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopG16R16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopG16R16(FILE*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopG16R16(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopG16R16(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopG16R16(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
 
-TC_PluginError PreLoopABGR32(FILE*&, DDSD2*&, MipSet*& pMipSet, void*&);
-TC_PluginError LoopABGR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopABGR32(FILE*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopABGR32(DDS_Stream*&, DDSD2*&, MipSet*& pMipSet, void*&);
+TC_PluginError LoopABGR32(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopABGR32(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
 
-TC_PluginError LoopR32G32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR10G10B10A2(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR9G9B9E5(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR32G32(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR10G10B10A2(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR9G9B9E5(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
 
-TC_PluginError LoopR16G16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR32(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError LoopR8G8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR16G16(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR32(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR8G8(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
 
-TC_PluginError PreLoopR16(FILE*&, DDSD2*&, MipSet*&, void*&);
-TC_PluginError LoopR16(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
-TC_PluginError PostLoopR16(FILE*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError PreLoopR16(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
+TC_PluginError LoopR16(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError PostLoopR16(DDS_Stream*&, DDSD2*&, MipSet*&, void*&);
 
-TC_PluginError LoopR8(FILE*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+TC_PluginError LoopR8(DDS_Stream*& pFile, DDSD2*&, MipSet*& pMipSet, void*&, int nMipLevel, int nFaceOrSlice, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
 
 bool SetupDDSD(DDSD2& ddsd2, const MipSet* pMipSet, bool bCompressed);
 bool SetupDDSD_DX10(DDSD2& ddsd2, const MipSet* pMipSet, bool bCompressed);
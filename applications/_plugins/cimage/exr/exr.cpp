@@ -66,6 +66,10 @@ IMath.lib;Half.lib;IlmImf.lib;IlmThread.lib;Iex.lib;zlibstatic_d.lib;
 #include "common.h"
 
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <thread>
 #include "cexr.h"
 
 #pragma warning(push)
@@ -86,6 +90,7 @@ IMath.lib;Half.lib;IlmImf.lib;IlmThread.lib;Iex.lib;zlibstatic_d.lib;
 #include <ImfPixelType.h>
 #include <ImathFun.h>
 #include <ImfDeepFrameBuffer.h>
+#include <ImfThreading.h>
 #pragma warning(pop)
 
 #include "common.h"
@@ -153,6 +158,23 @@ Plugin_EXR::~Plugin_EXR()
     //MessageBox(0,"Destroy","Plugin_EXR",MB_OK);
 }
 
+// OpenEXR decompresses and compresses the chunks of a file on its global thread pool, which
+// has no threads unless it is given some. Files opened after this use one thread per core.
+static void InitEXRThreadPool()
+{
+    static std::once_flag initialized;
+    std::call_once(initialized, []() {
+        try
+        {
+            setGlobalThreadCount((int)(std::max)(1u, std::thread::hardware_concurrency()));
+        }
+        catch (...)
+        {
+            // OpenEXR was built without thread support, files are read and written on the calling thread
+        }
+    });
+}
+
 int Plugin_EXR::TC_PluginSetSharedIO(void* Shared)
 {
     if (Shared)
@@ -181,14 +203,12 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* s
     if (!CMP_FileExists(pszFilename))
         return -1;
 
-    int    width, height;
-    string inf = pszFilename;
-
-    Array2D<Rgba> pixels;
-    int           w, h;
+    InitEXRThreadPool();
 
-    Exr::fileinfo(inf, width, height);
-    Exr::readRgba(inf, pixels, w, h);
+    RgbaInputFile file(pszFilename);
+    Box2i         dw     = file.dataWindow();
+    int           width  = dw.max.x - dw.min.x + 1;
+    int           height = dw.max.y - dw.min.y + 1;
 
     srcTexture->dwSize     = sizeof(CMP_Texture);
     srcTexture->dwWidth    = width;
@@ -198,18 +218,42 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* s
     srcTexture->dwDataSize = 4 * width * height * sizeof(CMP_HALFSHORT);
     srcTexture->pData      = (CMP_BYTE*)malloc(srcTexture->dwDataSize);
 
-    Rgba2Texture(pixels, (CMP_HALFSHORT*)srcTexture->pData, width, height);
+    // Rgba has the same layout as the RGBA_16F texture, the pixels are decoded into it directly
+    file.setFrameBuffer((Rgba*)srcTexture->pData - dw.min.x - dw.min.y * width, 1, width);
+    file.readPixels(dw.min.y, dw.max.y);
     return 0;
 }
 
+// Returns the pixels of a RGBA_16F image as Rgba. Decompressed images hold half bits with the
+// same layout as Rgba and are written in place, other data is converted to half values in pixels.
+static const Rgba* imagePixels(CMP_HALFSHORT* data, int w, int h, CMP_FORMAT isDeCompressed, std::vector<Rgba>& pixels)
+{
+    if (isDeCompressed != CMP_FORMAT_Unknown)
+        return (const Rgba*)data;
+
+    size_t count = (size_t)w * h;
+    pixels.resize(count);
+    for (size_t i = 0; i < count; i++, data += 4)
+    {
+        pixels[i].r = data[0];
+        pixels[i].g = data[1];
+        pixels[i].b = data[2];
+        pixels[i].a = data[3];
+    }
+    return pixels.data();
+}
+
 int Plugin_EXR::TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* srcTexture)
 {
-    int           image_width  = srcTexture->dwWidth;
-    int           image_height = srcTexture->dwHeight;
-    Array2D<Rgba> pixels(image_height, image_width);
-    string        sFile = pszFilename;
-    Texture2Rgba((CMP_HALFSHORT*)srcTexture->pData, pixels, image_width, image_height, CMP_FORMAT_Unknown);
-    Exr::writeRgba(sFile, pixels, image_width, image_height);
+    InitEXRThreadPool();
+
+    int               image_width  = srcTexture->dwWidth;
+    int               image_height = srcTexture->dwHeight;
+    std::vector<Rgba> pixels;
+
+    RgbaOutputFile file(pszFilename, image_width, image_height, WRITE_RGBA);
+    file.setFrameBuffer(imagePixels((CMP_HALFSHORT*)srcTexture->pData, image_width, image_height, CMP_FORMAT_Unknown, pixels), 1, image_width);
+    file.writePixels(image_height);
     return 0;
 }
 
@@ -258,130 +302,149 @@ bool allocateMipSet(Array<Rgba>& pixels, MipSet* pMipSet, int w, int h)
     return true;
 }
 
-int loadImage(const char fileName[], const char layer[], Header& header, Array<Rgba>& pixels, MipSet* pMipSet)
+// Allocates the MipSet for an RGBA_16F image of w x h pixels with numLevels mip levels, the
+// level data is allocated by the caller.
+static bool allocateMipSetLevels(MipSet* pMipSet, int w, int h, int numLevels)
 {
-    MultiPartInputFile inmaster(fileName);
-    InputPart          in(inmaster, 0);
-    header = in.header();
+    if (!EXR_CMips->AllocateMipSet(pMipSet, CF_Float16, TDT_ARGB, TT_2D, w, h, 1))
+    {  // depthsupport, what should nDepth be set as here?
+        EXR_CMips->PrintError("Error(0): EXR Plugin ID(5)\n");
+        return false;
+    }
+
+    // MIPS structure defaults
+    pMipSet->m_format     = CMP_FORMAT_RGBA_16F;  // CMP_FORMAT_ARGB_16F;
+    pMipSet->m_dwFourCC   = 0;
+    pMipSet->m_dwFourCC2  = 0;
+    pMipSet->m_nMipLevels = (std::min)(numLevels, pMipSet->m_nMaxMipLevels);
+    return true;
+}
 
-    ChannelList ch = header.channels();
+// Allocates a MipSet level for the pixels of dataWindow and describes it to OpenEXR, so that the
+// pixels are decoded straight into the level. Rgba has the same layout as RGBA_16F MipSet data.
+// Channels missing from the file are filled with 0, or 1 for alpha.
+static bool mipLevelFrameBuffer(MipSet* pMipSet, int level, const Box2i& dataWindow, FrameBuffer& fb)
+{
+    int       dw       = dataWindow.max.x - dataWindow.min.x + 1;
+    int       dh       = dataWindow.max.y - dataWindow.min.y + 1;
+    MipLevel* mipLevel = EXR_CMips->GetMipLevel(pMipSet, level);
 
-    if (ch.findChannel("Y"))
+    // Allocate the permanent buffer and unpack the bitmap data into it
+    if (!EXR_CMips->AllocateMipLevelData(mipLevel, dw, dh, CF_Float16, pMipSet->m_TextureDataType))
     {
-        //load as RGBA using array2D
-        Array2D<Rgba> pixels;
-        int           width, height;
-        int           w, h;
-
-        Exr::fileinfo(fileName, width, height);
-        Exr::readRgba(fileName, pixels, w, h);
-
-        CMP_Texture srcTexture;
-        srcTexture.dwSize     = sizeof(CMP_Texture);
-        srcTexture.dwWidth    = width;
-        srcTexture.dwHeight   = height;
-        srcTexture.dwPitch    = 0;
-        srcTexture.format     = CMP_FORMAT_RGBA_16F;  // CMP_FORMAT_ARGB_16F;
-        srcTexture.dwDataSize = 4 * width * height * sizeof(CMP_HALFSHORT);
-        srcTexture.pData      = (CMP_BYTE*)malloc(srcTexture.dwDataSize);
-
-        Rgba2Texture(pixels, (CMP_HALFSHORT*)srcTexture.pData, width, height);
-
-        if (!EXR_CMips->AllocateMipSet(pMipSet, CF_Float16, TDT_ARGB, TT_2D, width, height, 1))
-        {  // depthsupport, what should nDepth be set as here?
-            if (EXR_CMips)
-                EXR_CMips->PrintError("Error(0): EXR Plugin ID(5)\n");
-            return PE_Unknown;
-        }
+        EXR_CMips->PrintError("Error(0): EXR Plugin ID(6)\n");
+        return false;
+    }
 
-        // Allocate the permanent buffer and unpack the bitmap data into it
-        if (!EXR_CMips->AllocateMipLevelData(EXR_CMips->GetMipLevel(pMipSet, 0), width, height, CF_Float16, pMipSet->m_TextureDataType))
-        {
-            if (EXR_CMips)
-                EXR_CMips->PrintError("Error(0): EXR Plugin ID(6)\n");
-            return PE_Unknown;
-        }
+    memset(mipLevel->m_pbData, 0, mipLevel->m_dwLinearSize);
 
-        // MIPS structure defaults
-        pMipSet->m_dwFourCC   = 0;
-        pMipSet->m_dwFourCC2  = 0;
-        pMipSet->m_nMipLevels = 1;
+    size_t xs   = 1 * sizeof(Rgba);
+    size_t ys   = dw * sizeof(Rgba);
+    Rgba*  base = (Rgba*)mipLevel->m_phfsData - dataWindow.min.x - (ptrdiff_t)dataWindow.min.y * dw;
 
-        CMP_BYTE* MipData = EXR_CMips->GetMipLevel(pMipSet, 0)->m_pbData;
+    fb.insert("R", Slice(HALF, (char*)&base[0].r, xs, ys, 1, 1, 0.0));
+    fb.insert("G", Slice(HALF, (char*)&base[0].g, xs, ys, 1, 1, 0.0));
+    fb.insert("B", Slice(HALF, (char*)&base[0].b, xs, ys, 1, 1, 0.0));
+    fb.insert("A", Slice(HALF, (char*)&base[0].a, xs, ys, 1, 1, 1.0));
+    return true;
+}
 
-        memcpy(MipData, srcTexture.pData, srcTexture.dwDataSize);
+// Loads a luminance / chroma (YCA) image, which RgbaInputFile converts to RGBA while decoding
+int loadYCAImage(const char fileName[], MipSet* pMipSet)
+{
+    RgbaInputFile file(fileName);
+    Box2i         dataWindow = file.dataWindow();
+    int           dw         = dataWindow.max.x - dataWindow.min.x + 1;
+    int           dh         = dataWindow.max.y - dataWindow.min.y + 1;
 
-        free(srcTexture.pData);
+    if (!allocateMipSetLevels(pMipSet, dw, dh, 1))
+        return PE_Unknown;
+
+    MipLevel* mipLevel = EXR_CMips->GetMipLevel(pMipSet, 0);
+    if (!EXR_CMips->AllocateMipLevelData(mipLevel, dw, dh, CF_Float16, pMipSet->m_TextureDataType))
+    {
+        EXR_CMips->PrintError("Error(0): EXR Plugin ID(6)\n");
+        return PE_Unknown;
     }
-    else
+
+    file.setFrameBuffer((Rgba*)mipLevel->m_phfsData - dataWindow.min.x - (ptrdiff_t)dataWindow.min.y * dw, 1, dw);
+    try
     {
-        Box2i& dataWindow = header.dataWindow();
-        int    dw         = dataWindow.max.x - dataWindow.min.x + 1;
-        int    dh         = dataWindow.max.y - dataWindow.min.y + 1;
-        int    dx         = dataWindow.min.x;
-        int    dy         = dataWindow.min.y;
+        file.readPixels(dataWindow.min.y, dataWindow.max.y);
+    }
+    catch (const std::exception& e)
+    {
+        EXR_CMips->PrintError("Error(0): EXR Plugin ID(7) %s\n", e.what());
+        return PE_Unknown;
+    }
 
-        pixels.resizeErase(dw * dh);
-        memset(pixels, 0, (dw * dh) * (sizeof(Rgba)));
+    return PE_OK;
+}
 
-        size_t xs = 1 * sizeof(Rgba);
-        size_t ys = dw * sizeof(Rgba);
+// Loads a scanline image into level 0 of the MipSet
+int loadImage(MultiPartInputFile& inmaster, MipSet* pMipSet)
+{
+    InputPart in(inmaster, 0);
+    Box2i     dataWindow = in.header().dataWindow();
+    int       dw         = dataWindow.max.x - dataWindow.min.x + 1;
+    int       dh         = dataWindow.max.y - dataWindow.min.y + 1;
 
-        FrameBuffer fb;
-        Rgba*       base = pixels - dx - dy * dw;
+    FrameBuffer fb;
+    if (!allocateMipSetLevels(pMipSet, dw, dh, 1) || !mipLevelFrameBuffer(pMipSet, 0, dataWindow, fb))
+        return PE_Unknown;
+    in.setFrameBuffer(fb);
 
-        fb.insert("R",
-                  Slice(HALF,
-                        (char*)&base[0].r,
-                        xs,
-                        ys,
-                        1,
-                        1,      // xSampling, ySampling
-                        0.0));  // fillValue
+    try
+    {
+        in.readPixels(dataWindow.min.y, dataWindow.max.y);
+    }
+    catch (const std::exception& e)
+    {
+        // A damaged or truncated file fails the load rather than giving a partly black image
+        EXR_CMips->PrintError("Error(0): EXR Plugin ID(7) %s\n", e.what());
+        return PE_Unknown;
+    }
 
-        fb.insert("G",
-                  Slice(HALF,
-                        (char*)&base[0].g,
-                        xs,
-                        ys,
-                        1,
-                        1,      // xSampling, ySampling
-                        0.0));  // fillValue
+    return PE_OK;
+}
 
-        fb.insert("B",
-                  Slice(HALF,
-                        (char*)&base[0].b,
-                        xs,
-                        ys,
-                        1,
-                        1,      // xSampling, ySampling
-                        0.0));  // fillValue
+// Loads the levels of a tiled image into the MipSet levels: all the levels of a mipmapped image
+// and the levels that are reduced in both directions, (l, l), of a ripmapped image.
+// MipSet levels halve the size rounding down. The smaller levels of a ROUND_UP file have other
+// sizes, so only its full size level is loaded and the mip levels are left to be generated.
+int loadTiledImageLevels(MultiPartInputFile& inmaster, MipSet* pMipSet)
+{
+    TiledInputPart in(inmaster, 0);
 
-        fb.insert("A",
-                  Slice(HALF,
-                        (char*)&base[0].a,
-                        xs,
-                        ys,
-                        1,
-                        1,      // xSampling, ySampling
-                        1.0));  // fillValue
+    int numLevels = 1;
+    if (in.levelMode() == MIPMAP_LEVELS)
+        numLevels = in.numLevels();
+    else if (in.levelMode() == RIPMAP_LEVELS)
+        numLevels = (std::min)(in.numXLevels(), in.numYLevels());
+
+    if ((pMipSet->m_Flags & MS_FLAG_DisableMipMapping) || (in.levelRoundingMode() != ROUND_DOWN))
+        numLevels = 1;
+
+    if (!allocateMipSetLevels(pMipSet, in.levelWidth(0), in.levelHeight(0), numLevels))
+        return PE_Unknown;
+
+    for (int level = 0; level < pMipSet->m_nMipLevels; level++)
+    {
+        FrameBuffer fb;
+        if (!mipLevelFrameBuffer(pMipSet, level, in.dataWindowForLevel(level, level), fb))
+            return PE_Unknown;
         in.setFrameBuffer(fb);
 
         try
         {
-            in.readPixels(dataWindow.min.y, dataWindow.max.y);
-            if (!allocateMipSet(pixels, pMipSet, dw, dh))
-                return PE_Unknown;
+            // One call for the whole level, so that the tiles are decoded in parallel
+            in.readTiles(0, in.numXTiles(level) - 1, 0, in.numYTiles(level) - 1, level, level);
         }
         catch (const std::exception& e)
         {
-            //
-            // If some of the pixels in the file cannot be read,
-            // print an error message, and return a partial image
-            // to the caller.
-            //
-
-            std::cerr << e.what() << std::endl;
+            // A damaged or truncated file fails the load rather than giving a partly black image
+            EXR_CMips->PrintError("Error(0): EXR Plugin ID(7) %s\n", e.what());
+            return PE_Unknown;
         }
     }
 
@@ -1122,90 +1185,10 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     // uncomment the flag below to disable EXR mipmap loading / load only level 0
     // pMipSet->m_Flags |= MS_FLAG_DisableMipMapping;
 
-    bool isTile = false;
-
-    int miplevels = 1;
-    try
-    {
-        TiledRgbaInputFile file(pszFilename);
-        if (!file.isComplete())
-            return PE_Unknown;
-
-        // get mip level data from file, first get the number of mip levels stored
-        miplevels = (file.levelMode() == MIPMAP_LEVELS) ? file.numLevels() : 1;
-
-        if (miplevels > 1)
-            isTile = true;
-
-        pMipSet->m_format = CMP_FORMAT_RGBA_16F;  // CMP_FORMAT_ARGB_16F;
-
-        //handle mipmap exr load using Tile File
-        if (((isTile)) && (!(pMipSet->m_Flags & MS_FLAG_DisableMipMapping)))
-        {
-            CMP_DWORD dwWidth  = file.levelWidth(0);
-            CMP_DWORD dwHeight = file.levelHeight(0);
-
-            if (!EXR_CMips->AllocateMipSet(pMipSet, CF_Float16, TDT_ARGB, TT_2D, dwWidth, dwHeight, 1))
-            {  // depthsupport, what should nDepth be set as here?
-                return PE_Unknown;
-            }
-
-            pMipSet->m_dwFourCC  = 0;
-            pMipSet->m_dwFourCC2 = 0;
-
-            // if the mip levels stored in file is bigger then what we can handle reset the levels
-            // to match ours
-            if (miplevels > pMipSet->m_nMaxMipLevels)
-                pMipSet->m_nMipLevels = pMipSet->m_nMaxMipLevels;
-            else
-                pMipSet->m_nMipLevels = miplevels;
-
-            // No get the mip level data.
-            for (int i = 0; i < pMipSet->m_nMipLevels; i++)
-            {
-                if (!file.isValidLevel(i, i))
-                {
-                    pMipSet->m_nMipLevels = i;
-                    break;
-                }
-
-                dwWidth  = file.levelWidth(i);
-                dwHeight = file.levelHeight(i);
-                Array2D<Rgba> pixels(dwHeight, dwWidth);
-                pixels.resizeErase(dwHeight, dwWidth);
-
-                file.setFrameBuffer(pixels[0], 1, dwWidth);
-                file.readTiles(0, file.numXTiles(i) - 1, 0, file.numYTiles(i) - 1, i);
-
-                // Allocate the permanent buffer and unpack the bitmap data into it
-                if (!EXR_CMips->AllocateMipLevelData(EXR_CMips->GetMipLevel(pMipSet, i), dwWidth, dwHeight, CF_Float16, pMipSet->m_TextureDataType))
-                    return PE_Unknown;
-
-                Rgba2Texture(pixels, (CMP_HALFSHORT*)EXR_CMips->GetMipLevel(pMipSet, i)->m_pbData, dwWidth, dwHeight);
-            }
-            return PE_OK;
-        }  // Tiled file
-    }
-    catch (...)
-    {
-        try
-        {
-            int                 numparts = 0;
-            MultiPartInputFile* infile   = new MultiPartInputFile(pszFilename);
-            numparts                     = infile->parts();
-            delete infile;
-        }
-        catch (IEX_NAMESPACE::BaseExc& e)
-        {
-            if (EXR_CMips)
-                EXR_CMips->PrintError(e.what());
-            return PE_Unknown;
-        }
-    }
+    InitEXRThreadPool();
 
     //for non mipmap load
     const char* channel = 0;
-    const char* layer   = 0;
 
     Header              header;
     Array<Rgba>         pixels;
@@ -1215,36 +1198,47 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     bool                preview  = false;
     int                 zsize    = 0;
 
-    //loadImage
-    MultiPartInputFile inmaster(pszFilename);
-    Header             h    = inmaster.header(0);
-    std::string        type = h.type();
-
-    if (type == DEEPTILE)
-    {
-        loadDeepTileImage(inmaster, zsize, header, pixels, zbuff, sampleCount, deepComp, pMipSet);
-    }
-    else if (type == DEEPSCANLINE)
+    try
     {
-        loadDeepScanlineImage(inmaster, zsize, header, pixels, zbuff, sampleCount, deepComp, pMipSet);
-    }
+        MultiPartInputFile inmaster(pszFilename);
+        Header             h    = inmaster.header(0);
+        std::string        type = h.type();
 
-    else if (preview)
-    {
-        loadPreviewImage(pszFilename, header, pixels, pMipSet);
-    }
-    else
-    {
-        if (channel)
+        if (type == DEEPTILE)
         {
-            loadImageChannel(pszFilename, channel, header, pixels, pMipSet);
+            return loadDeepTileImage(inmaster, zsize, header, pixels, zbuff, sampleCount, deepComp, pMipSet);
+        }
+        else if (type == DEEPSCANLINE)
+        {
+            return loadDeepScanlineImage(inmaster, zsize, header, pixels, zbuff, sampleCount, deepComp, pMipSet);
+        }
+        else if (preview)
+        {
+            return loadPreviewImage(pszFilename, header, pixels, pMipSet);
+        }
+        else if (channel)
+        {
+            return loadImageChannel(pszFilename, channel, header, pixels, pMipSet);
+        }
+        else if (h.channels().findChannel("Y"))
+        {
+            return loadYCAImage(pszFilename, pMipSet);
+        }
+        else if (type == TILEDIMAGE)
+        {
+            return loadTiledImageLevels(inmaster, pMipSet);
         }
         else
         {
-            loadImage(pszFilename, layer, header, pixels, pMipSet);
+            return loadImage(inmaster, pMipSet);
         }
     }
-    return PE_OK;
+    catch (const std::exception& e)
+    {
+        if (EXR_CMips)
+            EXR_CMips->PrintError(e.what());
+        return PE_Unknown;
+    }
 }
 
 int Plugin_EXR::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
@@ -1257,22 +1251,21 @@ int Plugin_EXR::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
         return PE_Unknown;
     }
 
-    LevelMode levelMode = (pMipSet->m_nMipLevels > 1) ? MIPMAP_LEVELS : ONE_LEVEL;
+    InitEXRThreadPool();
+
+    LevelMode         levelMode = (pMipSet->m_nMipLevels > 1) ? MIPMAP_LEVELS : ONE_LEVEL;
+    std::vector<Rgba> pixels;
 
     // Save Single EXR file
     if (pMipSet->m_nMipLevels == 1)
     {
-        int           image_width  = pMipSet->m_nWidth;
-        int           image_height = pMipSet->m_nHeight;
-        Array2D<Rgba> pixels(image_height, image_width);
-        pixels.resizeErase(image_height, image_width);
-        string sFile = pszFilename;
-
-        CMP_HALFSHORT* data = EXR_CMips->GetMipLevel(pMipSet, 0)->m_phfsData;
-
-        Texture2Rgba(data, pixels, image_width, image_height, pMipSet->m_isDeCompressed);
+        int            image_width  = pMipSet->m_nWidth;
+        int            image_height = pMipSet->m_nHeight;
+        CMP_HALFSHORT* data         = EXR_CMips->GetMipLevel(pMipSet, 0)->m_phfsData;
 
-        Exr::writeRgba(sFile, pixels, image_width, image_height);
+        RgbaOutputFile file(pszFilename, image_width, image_height, WRITE_RGBA);
+        file.setFrameBuffer(imagePixels(data, image_width, image_height, pMipSet->m_isDeCompressed, pixels), 1, image_width);
+        file.writePixels(image_height);
     }
     // Save Muliple MIP levels as TiledRGB
     else
@@ -1280,18 +1273,22 @@ int Plugin_EXR::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
         TiledRgbaOutputFile file(pszFilename, pMipSet->m_nWidth, pMipSet->m_nHeight, TILE_WIDTH, TILE_HEIGHT, levelMode, ROUND_DOWN);
         for (int i = 0; i < file.numLevels(); i++)
         {
-            Array2D<Rgba> pixels(file.levelHeight(i), file.levelWidth(i));
-            pixels.resizeErase(file.levelHeight(i), file.levelWidth(i));
-            CMP_HALFSHORT* data = EXR_CMips->GetMipLevel(pMipSet, i)->m_phfsData;
+            int         w        = file.levelWidth(i);
+            int         h        = file.levelHeight(i);
+            MipLevel*   mipLevel = (i < pMipSet->m_nMipLevels) ? EXR_CMips->GetMipLevel(pMipSet, i) : NULL;
+            const Rgba* levelPixels;
 
-            if (data)
+            if (mipLevel && mipLevel->m_phfsData && (mipLevel->m_nWidth == w) && (mipLevel->m_nHeight == h))
+                levelPixels = imagePixels(mipLevel->m_phfsData, w, h, pMipSet->m_isDeCompressed, pixels);
+            else
             {
-                Texture2Rgba(data, pixels, file.levelWidth(i), file.levelHeight(i), pMipSet->m_isDeCompressed);
+                // The file holds the full mip chain, levels missing from the MipSet are saved black
+                pixels.assign((size_t)w * h, Rgba(0.0f, 0.0f, 0.0f, 0.0f));
+                levelPixels = pixels.data();
             }
-            else
-                memset(data, 0, EXR_CMips->GetMipLevel(pMipSet, 0)->m_dwLinearSize);
 
-            file.setFrameBuffer(pixels[0], 1, file.levelWidth(i));
+            // One call for the whole level, so that the tiles are encoded in parallel
+            file.setFrameBuffer(levelPixels, 1, w);
             file.writeTiles(0, file.numXTiles(i) - 1, 0, file.numYTiles(i) - 1, i);
         }
     }
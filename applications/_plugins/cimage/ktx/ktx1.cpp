@@ -30,11 +30,14 @@
 #include "tc_plugininternal.h"
 #include "common.h"
 #include "softfloat.h"
+#include "cmp_swizzle.h"
 
 #include <sstream>
 #include <algorithm>
+#include <vector>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #if defined(_WIN32)                 //&& !defined(NO_LEGACY_BEHAVIOR)
 #pragma comment(lib, "glew32.lib")  // glew
@@ -120,36 +123,60 @@ uint32_t ktx_u32_byterev(uint32_t v)
 // perform endianness switch on raw data
 static void switch_endianness2(void* dataptr, int bytes)
 {
-    int      i;
-    uint8_t* data = (uint8_t*)dataptr;
-
-    for (i = 0; i < bytes / 2; i++)
-    {
-        uint8_t d0 = data[0];
-        uint8_t d1 = data[1];
-        data[0]    = d1;
-        data[1]    = d0;
-        data += 2;
-    }
+    CMP_ByteSwap16N(dataptr, bytes / 2);
 }
 
 static void switch_endianness4(void* dataptr, int bytes)
 {
-    int      i;
-    uint8_t* data = (uint8_t*)dataptr;
+    CMP_ByteSwap32N(dataptr, bytes / 4);
+}
+
+// Bytes per pixel of the uncompressed MipSet formats the loader maps, 0 for others
+static int KTXBytesPerPixel(const MipSet* pMipSet)
+{
+    int numChannel      = 0;
+    int bytesPerChannel = 0;
 
-    for (i = 0; i < bytes / 4; i++)
+    switch (pMipSet->m_TextureDataType)
     {
-        uint8_t d0 = data[0];
-        uint8_t d1 = data[1];
-        uint8_t d2 = data[2];
-        uint8_t d3 = data[3];
-        data[0]    = d3;
-        data[1]    = d2;
-        data[2]    = d1;
-        data[3]    = d0;
-        data += 4;
+    case TDT_XRGB:
+        numChannel = 3;
+        break;
+    case TDT_ARGB:
+    case TDT_NORMAL_MAP:
+        numChannel = 4;
+        break;
+    case TDT_R:
+        numChannel = 1;
+        break;
+    case TDT_RG:
+        numChannel = 2;
+        break;
+    default:
+        return 0;
     }
+
+    switch (pMipSet->m_ChannelFormat)
+    {
+    case CF_8bit:
+    case CF_2101010:
+    case CF_1010102:
+    case CF_Float9995E:
+        bytesPerChannel = 1;
+        break;
+    case CF_16bit:
+    case CF_Float16:
+        bytesPerChannel = 2;
+        break;
+    case CF_32bit:
+    case CF_Float32:
+        bytesPerChannel = 4;
+        break;
+    default:
+        return 0;
+    }
+
+    return numChannel * bytesPerChannel;
 }
 
 static void copy_scanline(void* dst, const void* src, int pixels, int method)
@@ -218,36 +245,6 @@ static void copy_scanline(void* dst, const void* src, int pixels, int method)
     } while (0);                                     \
     break;
 
-#define COPY_RGBX(dsttype, srctype, convfunc, oneval) \
-    do                                                \
-    {                                                 \
-        srctype* s = (srctype*)src;                   \
-        dsttype* d = (dsttype*)dst;                   \
-        for (i = 0; i < pixels; i++)                  \
-        {                                             \
-            d[4 * i]     = convfunc(s[4 * i]);        \
-            d[4 * i + 1] = convfunc(s[4 * i + 1]);    \
-            d[4 * i + 2] = convfunc(s[4 * i + 2]);    \
-            d[4 * i + 3] = oneval;                    \
-        }                                             \
-    } while (0);                                      \
-    break;
-
-#define COPY_BGRX(dsttype, srctype, convfunc, oneval) \
-    do                                                \
-    {                                                 \
-        srctype* s = (srctype*)src;                   \
-        dsttype* d = (dsttype*)dst;                   \
-        for (i = 0; i < pixels; i++)                  \
-        {                                             \
-            d[4 * i]     = convfunc(s[4 * i + 2]);    \
-            d[4 * i + 1] = convfunc(s[4 * i + 1]);    \
-            d[4 * i + 2] = convfunc(s[4 * i]);        \
-            d[4 * i + 3] = oneval;                    \
-        }                                             \
-    } while (0);                                      \
-    break;
-
 #define COPY_RGBA(dsttype, srctype, convfunc, oneval) \
     do                                                \
     {                                                 \
@@ -308,6 +305,11 @@ static void copy_scanline(void* dst, const void* src, int pixels, int method)
     } while (0);                                    \
     break;
 
+    // Channel orders that need no value conversion are handled by byte shuffles
+    static const unsigned char mapRGB[4]   = {0, 1, 2, 3};
+    static const unsigned char mapBGR[4]   = {2, 1, 0, 3};
+    static const unsigned char mapBGR16[8] = {4, 5, 2, 3, 0, 1, 6, 7};
+
     int i;
     switch (method)
     {
@@ -316,17 +318,23 @@ static void copy_scanline(void* dst, const void* src, int pixels, int method)
     case RG8_TO_RGBA8:
         COPY_RG(uint8_t, uint8_t, id, 0xFF);
     case RGB8_TO_RGBA8:
-        COPY_RGB(uint8_t, uint8_t, id, 0xFF);
+        CMP_ExpandToRGBA8N((unsigned char*)dst, (const unsigned char*)src, pixels, 3, mapRGB, 0xFF);
+        break;
     case RGBA8_TO_RGBA8:
-        COPY_RGBA(uint8_t, uint8_t, id, 0xFF);
+        memcpy(dst, src, (size_t)pixels * 4);
+        break;
     case BGR8_TO_RGBA8:
-        COPY_BGR(uint8_t, uint8_t, id, 0xFF);
+        CMP_ExpandToRGBA8N((unsigned char*)dst, (const unsigned char*)src, pixels, 3, mapBGR, 0xFF);
+        break;
     case BGRA8_TO_RGBA8:
-        COPY_BGRA(uint8_t, uint8_t, id, 0xFF);
+        CMP_SwizzleN(dst, src, pixels, 4, mapBGR);
+        break;
     case RGBX8_TO_RGBA8:
-        COPY_RGBX(uint8_t, uint8_t, id, 0xFF);
+        CMP_ExpandToRGBA8N((unsigned char*)dst, (const unsigned char*)src, pixels, 4, mapRGB, 0xFF);
+        break;
     case BGRX8_TO_RGBA8:
-        COPY_BGRX(uint8_t, uint8_t, id, 0xFF);
+        CMP_ExpandToRGBA8N((unsigned char*)dst, (const unsigned char*)src, pixels, 4, mapBGR, 0xFF);
+        break;
     case L8_TO_RGBA8:
         COPY_L(uint8_t, uint8_t, id, 0xFF);
     case LA8_TO_RGBA8:
@@ -339,11 +347,13 @@ static void copy_scanline(void* dst, const void* src, int pixels, int method)
     case RGB16F_TO_RGBA16F:
         COPY_RGB(uint16_t, uint16_t, id, 0x3C00);
     case RGBA16F_TO_RGBA16F:
-        COPY_RGBA(uint16_t, uint16_t, id, 0x3C00);
+        memcpy(dst, src, (size_t)pixels * 8);
+        break;
     case BGR16F_TO_RGBA16F:
         COPY_BGR(uint16_t, uint16_t, id, 0x3C00);
     case BGRA16F_TO_RGBA16F:
-        COPY_BGRA(uint16_t, uint16_t, id, 0x3C00);
+        CMP_SwizzleN(dst, src, pixels, 8, mapBGR16);
+        break;
     case L16F_TO_RGBA16F:
         COPY_L(uint16_t, uint16_t, id, 0x3C00);
     case LA16F_TO_RGBA16F:
@@ -396,22 +406,55 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         return -1;
     }
 
+    // Read the whole file with one call, the levels are copied out of it
+    std::vector<CMP_BYTE> fileData;
+    long                  fileSize = -1;
+    if (fseek(pFile, 0, SEEK_END) == 0)
+    {
+        fileSize = ftell(pFile);
+        if (fseek(pFile, 0, SEEK_SET) != 0)
+            fileSize = -1;
+    }
+    if (fileSize > 0)
+    {
+        fileData.resize(fileSize);
+        if (fread(fileData.data(), 1, fileSize, pFile) != (size_t)fileSize)
+            fileSize = -1;
+    }
+    fclose(pFile);
+
+    if (fileSize <= 0)
+    {
+        if (KTX_CMips)
+            KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) loading file = %s \n"), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    return LoadTexture(fileData.data(), fileData.size(), pszFilename, pMipSet);
+}
+
+int Plugin_KTX::TC_PluginMemoryLoadTexture(const void* pBuffer, size_t size, MipSet* pMipSet)
+{
+    return LoadTexture((const CMP_BYTE*)pBuffer, size, "<memory>", pMipSet);
+}
+
+int Plugin_KTX::LoadTexture(const CMP_BYTE* pBuffer, size_t size, const char* pszFilename, MipSet* pMipSet)
+{
     //using libktx
     KTX_header  fheader;
     KTX_texinfo texinfo;
-    if (fread(&fheader, sizeof(KTX_header), 1, pFile) != 1)
+    if (size < sizeof(KTX_header))
     {
         if (KTX_CMips)
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) invalid KTX header. Filename = %s \n"), EL_Error, IDS_ERROR_NOT_KTX, pszFilename);
-        fclose(pFile);
         return -1;
     }
+    memcpy(&fheader, pBuffer, sizeof(KTX_header));
 
     if (_ktxCheckHeader(&fheader, &texinfo) != KTX_SUCCESS)
     {
         if (KTX_CMips)
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) invalid KTX header. Filename = %s \n"), EL_Error, IDS_ERROR_NOT_KTX, pszFilename);
-        fclose(pFile);
         return -1;
     }
 
@@ -622,7 +665,6 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         default:
             if (KTX_CMips)
                 KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) unsupported GL format %x\n"), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, fheader.glFormat);
-            fclose(pFile);
             return -1;
         }
     }
@@ -742,7 +784,6 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         default:
             if (KTX_CMips)
                 KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) unsupported GL format %x\n"), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, fheader.glFormat);
-            fclose(pFile);
             return -1;
         }
     }
@@ -761,7 +802,6 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     default:
         if (KTX_CMips)
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) unsupported texture format %x\n"), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, texinfo.glTarget);
-        fclose(pFile);
         return -1;
     }
 
@@ -771,14 +811,16 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
     //{
     //    if (KTX_CMips)
     //        KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) array textures not supported %x\n"), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, fheader.numberOfArrayElements);
-    //    fclose(pFile);
     //    return -1;
     //}
 
     pMipSet->m_nMipLevels = fheader.numberOfMipmapLevels;
     if (fheader.numberOfFaces < 1)
         fheader.numberOfFaces = 1;  // depthsupport
-    pMipSet->m_nDepth = fheader.numberOfFaces;
+    if (pMipSet->m_TextureType == TT_VolumeTexture)
+        pMipSet->m_nDepth = fheader.pixelDepth;
+    else
+        pMipSet->m_nDepth = fheader.numberOfFaces;
     pMipSet->dwWidth  = fheader.pixelWidth;
     pMipSet->dwHeight = fheader.pixelHeight;
 
@@ -797,127 +839,75 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
         pMipSet->m_nMipLevels = pMipSet->m_nMaxMipLevels;
     }
 
-    fclose(pFile);
-    pFile = NULL;
-    pFile = fopen(pszFilename, "rb");
-    if (pFile == NULL)
+    int bytesPerPixel = 0;
+    if (!pMipSet->m_compressed)
     {
-        if (KTX_CMips)
-            KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) loading file = %s "), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
-        return -1;
+        bytesPerPixel = KTXBytesPerPixel(pMipSet);
+        if (bytesPerPixel == 0)
+        {
+            if (KTX_CMips)
+                KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) unsupported GL format %x\n"), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, fheader.glFormat);
+            return -1;
+        }
     }
 
+    // A MipSet holds no array textures, only the first element of an array is loaded
+    size_t numArrayElements = max(1u, (unsigned int)fheader.numberOfArrayElements);
+
+    // Only the faces of a cube map that is not an array are sized and padded one by one
+    bool cubeFaces = (fheader.numberOfFaces == 6) && (fheader.numberOfArrayElements == 0);
+
     //skip key value data
-    int imageSizeOffset = sizeof(KTX_header) + fheader.bytesOfKeyValueData;
-    if (fseek(pFile, imageSizeOffset, SEEK_SET))
-    {
-        if (KTX_CMips)
-            KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) Seek past key/vals in KTX compressed bitmap file failed. Format %x\n"),
-                                  EL_Error,
-                                  IDS_ERROR_UNSUPPORTED_TYPE,
-                                  fheader.glFormat);
-        fclose(pFile);
-        return -1;
-    }
+    size_t offset = sizeof(KTX_header) + (size_t)fheader.bytesOfKeyValueData;
 
     int w = pMipSet->m_nWidth;
     int h = pMipSet->m_nHeight;
 
-    unsigned int totalByteRead = 0;
-
-    unsigned int faceSize        = 0;
-    unsigned int faceSizeRounded = 0;
-    unsigned int numArrayElement = fheader.numberOfArrayElements;
-
-    for (int nMipLevel = 0; nMipLevel < fheader.numberOfMipmapLevels; nMipLevel++)
+    for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
     {
-        if ((w <= 0) || (h <= 0))
-            break;
-
-        totalByteRead = fread(&faceSize, 1, sizeof(khronos_uint32_t), pFile);
-        if (totalByteRead == 0)
+        khronos_uint32_t imageSize = 0;
+        if (offset + sizeof(khronos_uint32_t) > size)
         {
             if (KTX_CMips)
                 KTX_CMips->PrintError(
                     ("Error(%d): KTX Plugin ID(%d) Read image data size failed. Format %x\n"), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, fheader.glFormat);
-            fclose(pFile);
             return -1;
         }
+        memcpy(&imageSize, pBuffer + offset, sizeof(khronos_uint32_t));
         if (fheader.endianness == KTX_ENDIAN_REF_REV)
         {
-            _ktxSwapEndian32(&faceSize, 1);
+            _ktxSwapEndian32(&imageSize, 1);
+        }
+        offset += sizeof(khronos_uint32_t);
+
+        // Faces of a cube map or slices of a volume texture
+        int    nFacesOrSlices = CMP_MaxFacesOrSlices(pMipSet, nMipLevel);
+        size_t imageRounded   = ((size_t)imageSize + 3) & ~(size_t)3;
+        size_t faceSize       = cubeFaces ? imageSize : imageSize / (numArrayElements * nFacesOrSlices);
+        size_t faceStride     = cubeFaces ? imageRounded : faceSize;
+        size_t levelSize      = cubeFaces ? imageRounded * nFacesOrSlices : imageRounded;
+
+        if ((faceSize == 0) || (offset + faceStride * (nFacesOrSlices - 1) + faceSize > size))
+        {
+            if (KTX_CMips)
+                KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) Read image data failed. Unexpectec EOF. Format %x\n"),
+                                      EL_Error,
+                                      IDS_ERROR_UNSUPPORTED_TYPE,
+                                      fheader.glFormat);
+            return -1;
         }
-        faceSizeRounded = (faceSize + 3) & ~(khronos_uint32_t)3;
 
-        for (int face = 0; face < fheader.numberOfFaces; ++face)
+        for (int face = 0; face < nFacesOrSlices; ++face)
         {
+            const CMP_BYTE* pSrc = pBuffer + offset + faceStride * face;
+
             // Determine buffer size and set Mip Set Levels
             MipLevel* pMipLevel = KTX_CMips->GetMipLevel(pMipSet, nMipLevel, face);
             if (pMipSet->m_compressed)
-                KTX_CMips->AllocateCompressedMipLevelData(pMipLevel, w, h, faceSizeRounded);
+                KTX_CMips->AllocateCompressedMipLevelData(pMipLevel, w, h, (CMP_DWORD)faceSize);
             else
                 KTX_CMips->AllocateMipLevelData(pMipLevel, w, h, pMipSet->m_ChannelFormat, pMipSet->m_TextureDataType);
 
-            // handle padded KTX data
-            // store size to be read at this miplevel to check with face size in KTX file
-
-            int sizeTobeRead    = 0;
-            int numChannel      = 0;
-            int bytesPerChannel = 0;
-
-            if (pMipSet->m_compressed)
-            {
-                sizeTobeRead = faceSizeRounded;
-            }
-            else
-            {
-                switch (pMipSet->m_TextureDataType)
-                {
-                case TDT_XRGB:
-                    numChannel = 3;
-                    break;
-                case TDT_ARGB:
-                case TDT_NORMAL_MAP:
-                    numChannel = 4;
-                    break;
-
-                case TDT_R:
-                    numChannel = 1;
-                    break;
-
-                case TDT_RG:
-                    numChannel = 2;
-                    break;
-
-                default:
-                    return -1;
-                }
-
-                switch (pMipSet->m_ChannelFormat)
-                {
-                case CF_8bit:
-                case CF_2101010:
-                case CF_1010102:
-                case CF_Float9995E:
-                    bytesPerChannel = 1;
-                    break;
-
-                case CF_16bit:
-                case CF_Float16:
-                    bytesPerChannel = 2;
-                    break;
-
-                case CF_32bit:
-                case CF_Float32:
-                    bytesPerChannel = 4;
-                    break;
-
-                default:
-                    return -1;
-                }
-
-                sizeTobeRead = w * h * numChannel * bytesPerChannel;
-            }
             CMP_BYTE* pData = (CMP_BYTE*)(pMipLevel->m_pbData);
 
             if (!pData)
@@ -927,58 +917,195 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipSe
                                           EL_Error,
                                           IDS_ERROR_UNSUPPORTED_TYPE,
                                           fheader.glFormat);
-                fclose(pFile);
                 return -1;
             }
 
-            //read image data
-            unsigned int bytesRead = 0;
-            //size to be read has to be same as face size, else padding is done in the KTX file
-            if (sizeTobeRead == faceSizeRounded)
-            {
-                bytesRead = fread(pData, 1, faceSizeRounded, pFile);
-            }
-            else if (faceSizeRounded > sizeTobeRead)  // padding in KTX file
+            if (pMipSet->m_compressed)
             {
-                std::vector<CMP_BYTE> pTempData;
-                pTempData.resize(faceSizeRounded);
-                bytesRead       = fread(pTempData.data(), 1, faceSizeRounded, pFile);
-                int paddedBytes = faceSizeRounded - sizeTobeRead;
-
-                int n = 0;
-                for (int i = 0; i < pTempData.size(); i++)
-                {
-                    for (int w_i = 0; w_i < w; w_i++)
-                    {
-                        for (int j = 0; j < numChannel * bytesPerChannel; j++)
-                        {
-                            pData[n++] = pTempData[i++];
-                        }
-                    }
-                    //skip padded bytes
-                    i += (paddedBytes / h) - 1;
-                }
+                memcpy(pData, pSrc, faceSize);
+                continue;
             }
 
-            if (bytesRead != faceSizeRounded)
+            // Rows are padded in the file when the face is larger than the image
+            size_t rowSize      = (size_t)w * bytesPerPixel;
+            size_t sizeTobeRead = rowSize * h;
+            if (faceSize < sizeTobeRead)
             {
                 if (KTX_CMips)
                     KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) Read image data failed. Unexpectec EOF. Format %x\n"),
                                           EL_Error,
                                           IDS_ERROR_UNSUPPORTED_TYPE,
                                           fheader.glFormat);
-                fclose(pFile);
                 return -1;
             }
+
+            if (faceSize == sizeTobeRead)
+            {
+                memcpy(pData, pSrc, sizeTobeRead);
+            }
+            else
+            {
+                size_t rowPitch = rowSize + (faceSize - sizeTobeRead) / h;
+                for (int row = 0; row < h; row++)
+                    memcpy(pData + row * rowSize, pSrc + row * rowPitch, rowSize);
+            }
+
+            // The file was written on a machine of the other endianness, swap the data elements
+            if (fheader.endianness == KTX_ENDIAN_REF_REV)
+            {
+                if (fheader.glTypeSize == 2)
+                    switch_endianness2(pData, (int)sizeTobeRead);
+                else if (fheader.glTypeSize == 4)
+                    switch_endianness4(pData, (int)sizeTobeRead);
+            }
         }
+        offset += levelSize;
+
         // next miplevel width and height
-        w = max(0, w >> 1);
-        h = max(0, h >> 1);
+        w = max(1, w >> 1);
+        h = max(1, h >> 1);
     }
 
     return 0;
 }
 
+// Bytes per pixel of an uncompressed glFormat and glType, 0 if not known
+static khronos_uint32_t KTXGroupBytes(const KTX_texture_info& textureinfo)
+{
+    if (textureinfo.glType == GL_UNSIGNED_INT_2_10_10_10_REV)
+        return 4;
+
+    switch (textureinfo.glFormat)
+    {
+    case GL_RED:
+        return textureinfo.glTypeSize;
+    case GL_RG:
+        return textureinfo.glTypeSize * 2;
+    case GL_RGB:
+        return textureinfo.glTypeSize * 3;
+    case GL_RGBA:
+        return textureinfo.glTypeSize * 4;
+    default:
+        return 0;
+    }
+}
+
+// Lays out the header, the imageSize of each level and the faces or slices of
+// the MipSet in KTX order, with rows padded to 4 bytes (the KTX
+// UNPACK_ALIGNMENT) and cube map faces and levels padded to 4 bytes. Checks
+// textureinfo the same way ktxWriteKTXF does.
+static bool KTXBuildFile(const MipSet* pMipSet, const KTX_texture_info& textureinfo, std::vector<CMP_BYTE>& fileData)
+{
+    if ((textureinfo.glTypeSize != 1) && (textureinfo.glTypeSize != 2) && (textureinfo.glTypeSize != 4))
+        return false;
+
+    // either both or neither of glType & glFormat must be zero
+    bool compressed = (textureinfo.glType == 0) || (textureinfo.glFormat == 0);
+    if (compressed && (textureinfo.glType + textureinfo.glFormat != 0))
+        return false;
+
+    khronos_uint32_t groupBytes = compressed ? 0 : KTXGroupBytes(textureinfo);
+    if (!compressed && (groupBytes == 0))
+        return false;
+
+    // cube maps require square images
+    bool cubeFaces = textureinfo.numberOfFaces == 6;
+    if (cubeFaces && (textureinfo.pixelWidth != textureinfo.pixelHeight))
+        return false;
+
+    // imageSize and padded size of each face or slice per level
+    std::vector<size_t> faceSizes(pMipSet->m_nMipLevels);
+    std::vector<size_t> rowBytes(pMipSet->m_nMipLevels);
+    size_t              totalSize = sizeof(KTX_header);
+    for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
+    {
+        const MipLevel* pMipLevel = KTX_CMips->GetMipLevel(pMipSet, nMipLevel);
+        if ((pMipLevel == NULL) || (pMipLevel->m_pbData == NULL))
+            return false;
+
+        if (compressed)
+        {
+            faceSizes[nMipLevel] = pMipLevel->m_dwLinearSize;
+        }
+        else
+        {
+            // Sanity check, as ktxWriteKTXF does
+            size_t packedRowBytes = (size_t)groupBytes * pMipLevel->m_nWidth;
+            if (pMipLevel->m_dwLinearSize != packedRowBytes * pMipLevel->m_nHeight)
+                return false;
+            rowBytes[nMipLevel]  = (packedRowBytes + 3) & ~(size_t)3;
+            faceSizes[nMipLevel] = rowBytes[nMipLevel] * pMipLevel->m_nHeight;
+        }
+
+        size_t nFacesOrSlices = CMP_MaxFacesOrSlices(pMipSet, nMipLevel);
+        size_t faceRounded    = (faceSizes[nMipLevel] + 3) & ~(size_t)3;
+        totalSize += sizeof(khronos_uint32_t);
+        totalSize += cubeFaces ? faceRounded * nFacesOrSlices : ((faceSizes[nMipLevel] * nFacesOrSlices + 3) & ~(size_t)3);
+    }
+
+    KTX_header header = KTX_IDENTIFIER_REF;
+    header.endianness            = KTX_ENDIAN_REF;
+    header.glType                = textureinfo.glType;
+    header.glTypeSize            = textureinfo.glTypeSize;
+    header.glFormat              = textureinfo.glFormat;
+    header.glInternalFormat      = textureinfo.glInternalFormat;
+    header.glBaseInternalFormat  = textureinfo.glBaseInternalFormat;
+    header.pixelWidth            = textureinfo.pixelWidth;
+    header.pixelHeight           = textureinfo.pixelHeight;
+    header.pixelDepth            = textureinfo.pixelDepth;
+    header.numberOfArrayElements = textureinfo.numberOfArrayElements;
+    header.numberOfFaces         = textureinfo.numberOfFaces;
+    header.numberOfMipmapLevels  = textureinfo.numberOfMipmapLevels;
+    header.bytesOfKeyValueData   = 0;
+
+    // Padding bytes stay zero
+    fileData.assign(totalSize, 0);
+    memcpy(fileData.data(), &header, sizeof(KTX_header));
+
+    size_t offset = sizeof(KTX_header);
+    for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
+    {
+        int    nFacesOrSlices = CMP_MaxFacesOrSlices(pMipSet, nMipLevel);
+        size_t faceSize       = faceSizes[nMipLevel];
+        size_t faceStride     = cubeFaces ? ((faceSize + 3) & ~(size_t)3) : faceSize;
+
+        // A cube map face or the whole level of other textures
+        khronos_uint32_t imageSize = (khronos_uint32_t)(cubeFaces ? faceSize : faceSize * nFacesOrSlices);
+        memcpy(&fileData[offset], &imageSize, sizeof(imageSize));
+        offset += sizeof(imageSize);
+
+        for (int face = 0; face < nFacesOrSlices; face++)
+        {
+            const MipLevel* pMipLevel = KTX_CMips->GetMipLevel(pMipSet, nMipLevel, face);
+            if ((pMipLevel == NULL) || (pMipLevel->m_pbData == NULL))
+                return false;
+
+            CMP_BYTE*       pDst = &fileData[offset + faceStride * face];
+            const CMP_BYTE* pSrc = pMipLevel->m_pbData;
+            if (compressed)
+            {
+                memcpy(pDst, pSrc, min((size_t)pMipLevel->m_dwLinearSize, faceSize));
+                continue;
+            }
+
+            size_t packedRowBytes = (size_t)groupBytes * pMipLevel->m_nWidth;
+            if (packedRowBytes == rowBytes[nMipLevel])
+            {
+                memcpy(pDst, pSrc, faceSize);
+            }
+            else
+            {
+                for (int row = 0; row < pMipLevel->m_nHeight; row++)
+                    memcpy(pDst + row * rowBytes[nMipLevel], pSrc + row * packedRowBytes, packedRowBytes);
+            }
+        }
+
+        offset += cubeFaces ? faceStride * nFacesOrSlices : ((faceSize * nFacesOrSlices + 3) & ~(size_t)3);
+    }
+
+    return true;
+}
+
 int Plugin_KTX::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)
 {
     assert(pszFilename);
@@ -993,13 +1120,9 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
         return -1;
     }
 
-    //using libktx
     KTX_texture_info textureinfo;
-    KTX_image_info*  inputMip = new KTX_image_info[pMipSet->m_nMipLevels];
-
-    unsigned  pDataLen     = 0;
-    CMP_BYTE* pData        = NULL;
-    bool      isCompressed = false;
+    memset(&textureinfo, 0, sizeof(textureinfo));
+    bool isCompressed = false;
 
     if (pMipSet->m_TextureType == TT_CubeMap)
         textureinfo.numberOfFaces = 6;
@@ -1015,8 +1138,6 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_ALLOCATEMIPSET, pszFilename);
 
         fclose(pFile);
-        delete[] inputMip;
-
         return -1;
     }
 
@@ -1026,22 +1147,9 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_ALLOCATEMIPSET, pszFilename);
 
         fclose(pFile);
-        delete[] inputMip;
-
         return -1;
     }
 
-    int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : CMP_MaxFacesOrSlices(pMipSet, 0);
-
-    for (int nSlice = 0; nSlice < nSlices; nSlice++)
-    {
-        for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
-        {
-            inputMip[nMipLevel].size = KTX_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize;
-            inputMip[nMipLevel].data = KTX_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData;
-        }
-    }
-
     switch (pMipSet->m_format)
     {
     //uncompressed format case
@@ -1358,23 +1466,27 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
     textureinfo.pixelWidth  = pMipSet->m_nWidth;
     textureinfo.pixelHeight = pMipSet->m_nHeight;
     textureinfo.pixelDepth  = 0;  //for 1D, 2D and cube texture , depth =0;
-
-    //1D
-    if (pMipSet->m_nHeight == 1 && pData != NULL)
-    {
-        delete pData;
-        pData    = NULL;
-        pDataLen = 0;
-    }
+    if (pMipSet->m_TextureType == TT_VolumeTexture)
+        textureinfo.pixelDepth = pMipSet->m_nDepth;
 
     textureinfo.numberOfMipmapLevels = pMipSet->m_nMipLevels;
 
-    KTX_error_code save = ktxWriteKTXF(pFile, &textureinfo, pDataLen, pData, pMipSet->m_nMipLevels, inputMip);
+    // Lay out the whole file, then write it with one call
+    std::vector<CMP_BYTE> fileData;
+    if (!KTXBuildFile(pMipSet, textureinfo, fileData))
+    {
+        if (KTX_CMips)
+            KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_UNSUPPORTED_TYPE, pszFilename);
 
-    fclose(pFile);
-    delete[] inputMip;
+        fclose(pFile);
+        return -1;
+    }
+
+    bool saved = fwrite(fileData.data(), 1, fileData.size(), pFile) == fileData.size();
+    if (fclose(pFile) != 0)
+        saved = false;
 
-    if (save != KTX_SUCCESS)
+    if (!saved)
     {
         if (KTX_CMips)
             KTX_CMips->PrintError(("Error(%d): KTX Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_FILE_OPEN, pszFilename);
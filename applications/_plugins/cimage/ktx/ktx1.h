@@ -51,6 +51,10 @@ public:
     int TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet);
     int TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* srcTexture);
     int TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* srcTexture);
+    int TC_PluginMemoryLoadTexture(const void* pBuffer, size_t size, MipSet* pMipSet);
+
+private:
+    int LoadTexture(const CMP_BYTE* pBuffer, size_t size, const char* pszFilename, MipSet* pMipSet);
 };
 
 #define IDS_ERROR_FILE_OPEN 1
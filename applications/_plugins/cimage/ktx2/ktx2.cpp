@@ -66,6 +66,7 @@ static void writeId2(std::ostream& dst)
 
 Plugin_KTX2::Plugin_KTX2()
 {
+    m_zstdLevel = 0;
 }
 
 Plugin_KTX2::~Plugin_KTX2()
@@ -82,6 +83,15 @@ int Plugin_KTX2::TC_PluginSetSharedIO(void* Shared)
     return 1;
 }
 
+int Plugin_KTX2::TC_PluginSetOptions(const CMP_CompressOptions* pOptions)
+{
+    if (pOptions && (pOptions->nKTX2ZstdLevel > 0))
+        m_zstdLevel = (std::min)(pOptions->nKTX2ZstdLevel, 22);
+    else
+        m_zstdLevel = 0;
+    return 0;
+}
+
 int Plugin_KTX2::TC_PluginGetVersion(TC_PluginVersion* pPluginVersion)
 {
 #ifdef _WIN32
@@ -592,11 +602,7 @@ int Plugin_KTX2::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipS
 
                 if (!pMipSet->m_compressed)
                 {
-                    size_t               readSize = channelByteSize * channelCount * w * h;
-                    std::vector<uint8_t> pixelData(readSize);
-
-                    memcpy(&pixelData[0], imageData, readSize);
-
+                    // Level data has already been inflated by libktx if the file was supercompressed, so it is read in place
                     int pixelSize       = channelCount * channelByteSize;
                     int targetPixelSize = channelCount * channelByteSize;
                     if (channelCount == 3)
@@ -605,13 +611,18 @@ int Plugin_KTX2::TC_PluginFileLoadTexture(const char* pszFilename, MipSet* pMipS
                         targetPixelSize = 4 * channelByteSize;
                     }
 
-                    int py = 0;
-                    for (py = 0; py < h; py++)
+                    if (pixelSize == targetPixelSize)
                     {
-                        int px = 0;
-                        for (px = 0; px < w; px++)
+                        memcpy(pData, imageData, (size_t)pixelSize * w * h);
+                    }
+                    else
+                    {
+                        for (int py = 0; py < h; py++)
                         {
-                            memcpy(&pData[targetPixelSize * px + py * targetPixelSize * w], &pixelData[pixelSize * px + py * pixelSize * w], pixelSize);
+                            for (int px = 0; px < w; px++)
+                            {
+                                memcpy(&pData[targetPixelSize * px + py * targetPixelSize * w], &imageData[pixelSize * px + py * pixelSize * w], pixelSize);
+                            }
                         }
                     }
                 }
@@ -1088,6 +1099,18 @@ int Plugin_KTX2::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipS
         if (basisStatus != KTX_SUCCESS)
         {
             KTX2_CMips->PrintError("Error(%d): Basis status KTX2 Plugin on saving file = %s \n", basisStatus, pszFilename);
+            ktxTexture_Destroy(texture);
+            return -1;
+        }
+    }
+    else if (m_zstdLevel > 0)
+    {
+        // KTX2 supercompression: each level is deflated with Zstandard and the level index records the compressed sizes
+        KTX_error_code zstdStatus = ktxTexture2_DeflateZstd(texture2, m_zstdLevel);
+        if (zstdStatus != KTX_SUCCESS)
+        {
+            KTX2_CMips->PrintError("Error(%d): Zstd supercompression KTX2 Plugin on saving file = %s \n", zstdStatus, pszFilename);
+            ktxTexture_Destroy(texture);
             return -1;
         }
     }
@@ -1097,6 +1120,8 @@ int Plugin_KTX2::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipS
     ktxHashList_AddKVPair(&texture->kvDataHead, KTX_WRITER_KEY, (ktx_uint32_t)writer.str().length() + 1, writer.str().c_str());
 
     KTX_error_code save = ktxTexture_WriteToNamedFile(texture, pszFilename);
+    ktxTexture_Destroy(texture);
+
     if (save != KTX_SUCCESS)
     {
         KTX2_CMips->PrintError("Error(%d): WriteToNamedFile KTX2 Plugin on saving file = %s \n", save, pszFilename);
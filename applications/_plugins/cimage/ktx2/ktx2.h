@@ -52,6 +52,10 @@ public:
     int TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet);
     int TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* srcTexture);
     int TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* srcTexture);
+    int TC_PluginSetOptions(const CMP_CompressOptions* pOptions);
+
+private:
+    ktx_uint32_t m_zstdLevel;  // Zstandard supercompression level used on save, 0 = no supercompression
 };
 
 struct CMP_DFD
@@ -23,13 +23,20 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
 #include "tc_pluginapi.h"
 #include "tc_plugininternal.h"
 #include "compressonator.h"
+#include "cmp_swizzle.h"
 #include "tga.h"
 
-CMIPS*             TGA_CMips;
-TGA_FileSaveParams g_FileSaveParams;
+CMIPS* TGA_CMips;
 
 #ifdef BUILD_AS_PLUGIN_DLL
 DECLARE_PLUGIN(Plugin_TGA)
@@ -50,6 +57,8 @@ typedef CMP_DWORD* LPDWORD;
 
 Plugin_TGA::Plugin_TGA()
 {
+    // Saves are uncompressed unless TC_PluginSetFileSaveParams asks for RLE
+    ParseTextParams(&m_FileSaveParams, NULL);
 }
 
 Plugin_TGA::~Plugin_TGA()
@@ -78,6 +87,12 @@ int Plugin_TGA::TC_PluginGetVersion(TC_PluginVersion* pPluginVersion)
     return 0;
 }
 
+int Plugin_TGA::TC_PluginSetFileSaveParams(const char* pszTextParams)
+{
+    ParseTextParams(&m_FileSaveParams, pszTextParams);
+    return 0;
+}
+
 int Plugin_TGA::TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* srcTexture)
 {
     return 0;
@@ -219,9 +234,8 @@ int Plugin_TGA::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
         break;
     }
 
-    // napatel need to add this somehow!
-    //if(pTGAFileSaveParams->bRLECompressed)
-    //    header.cImageType |= 0x8;
+    if (m_FileSaveParams.bRLECompressed)
+        header.cImageType |= 0x8;
 
     header.nWidth  = static_cast<short>(pMipSet->m_nWidth);
     header.nHeight = static_cast<short>(pMipSet->m_nHeight);
@@ -250,164 +264,259 @@ int Plugin_TGA::TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSe
 
 //---------------- TGA Code -----------------------------------
 
-TC_PluginError LoadTGA_ARGB8888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+// Images with fewer pixels than this are decoded and encoded on the calling thread only
+#define TGA_RLE_MIN_PARALLEL_PIXELS (512 * 512)
+// Number of rows decoded or encoded by each job
+#define TGA_RLE_ROWS_PER_JOB 64
+
+// Runs job(0) .. job(numJobs - 1) on all processor cores, including the calling thread
+template <typename Job>
+static void RunTGAJobs(unsigned int numJobs, Job job)
 {
-    if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), Header.nWidth, Header.nHeight, CF_8bit, TDT_ARGB))
-        return PE_Unknown;
+    std::atomic<unsigned int> nextJob(0);
 
-    pMipSet->m_ChannelFormat   = CF_8bit;
-    pMipSet->m_TextureDataType = TDT_ARGB;
-    pMipSet->m_dwFourCC        = 0;
-    pMipSet->m_dwFourCC2       = 0;
-    pMipSet->m_format          = CMP_FORMAT_ARGB_8888;
-    pMipSet->m_nMipLevels      = 1;
+    auto worker = [&]() {
+        unsigned int jobIndex;
+        while ((jobIndex = nextJob++) < numJobs)
+            job(jobIndex);
+    };
 
-    // Allocate a temporary buffer and read the bitmap data into it
-    CMP_DWORD      dwSize    = pMipSet->m_nWidth * pMipSet->m_nHeight * sizeof(CMP_COLOR);
-    unsigned char* pTempData = static_cast<unsigned char*>(malloc(dwSize));
-    fread(pTempData, dwSize, 1, pFile);
+    unsigned int numThreads = (std::max)(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < (std::min)(numThreads, numJobs); ++i)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (std::thread& thread : workers)
+        thread.join();
+}
+
+// Number of rows handled by each job, all of them when the image is too small to split
+static int GetRowsPerJob(int nWidth, int nHeight)
+{
+    if (((size_t)nWidth * nHeight < TGA_RLE_MIN_PARALLEL_PIXELS) || (std::thread::hardware_concurrency() <= 1))
+        return (std::max)(nHeight, 1);
+    return TGA_RLE_ROWS_PER_JOB;
+}
+
+// Reads the image data, which is the rest of the file, in a single read and closes the file
+static bool ReadTGAImageData(FILE* pFile, std::vector<CMP_BYTE>& data)
+{
+    long lCurrPos = ftell(pFile);
+    fseek(pFile, 0, SEEK_END);
+    long lEndPos = ftell(pFile);
+    fseek(pFile, lCurrPos, SEEK_SET);
+
+    bool bResult = (lCurrPos >= 0) && (lEndPos >= lCurrPos);
+    if (bResult)
+    {
+        data.resize((size_t)(lEndPos - lCurrPos));
+        bResult = data.empty() || (fread(data.data(), data.size(), 1, pFile) == 1);
+    }
     fclose(pFile);
 
-    CMP_BYTE* pTempPtr = pTempData;
+    return bResult;
+}
 
-    int nStart, nEnd, nIncrement;
-    // Bottom up ?
-    if (Header.cFormatFlags & 0x20)
+// Where the decoding of a row starts: the packet holding its first pixel, and the number
+// of pixels of that packet that belong to earlier rows, as packets may cross rows
+typedef struct
+{
+    size_t nOffset;
+    int    nSkip;
+} TGA_RLEPosition;
+
+// Converts nCount TGA pixels of nSize (1, 3 or 4) bytes to RGBA8888
+static void ConvertTGAPixels(CMP_BYTE* pData, const CMP_BYTE* pSrc, int nCount, int nSize)
+{
+    static const unsigned char mapBGRA[4] = {2, 1, 0, 3};
+
+    if (nSize == 4)
+        CMP_SwizzleN(pData, pSrc, nCount, 4, mapBGRA);
+    else if (nSize == 3)
+        CMP_ExpandToRGBA8N(pData, pSrc, nCount, 3, mapBGRA, 0xff);
+    else
     {
-        nStart     = 0;
-        nEnd       = pMipSet->m_nHeight;
-        nIncrement = 1;
+        for (int i = 0; i < nCount; i++)
+        {
+            *pData++ = pSrc[i];
+            *pData++ = pSrc[i];
+            *pData++ = pSrc[i];
+            *pData++ = 0xff;
+        }
+    }
+}
+
+// Writes the TGA pixel of nSize bytes at pSrc nCount times as RGBA8888
+static void FillTGAPixels(CMP_BYTE* pData, const CMP_BYTE* pSrc, int nCount, int nSize)
+{
+    CMP_BYTE rgba[4];
+    if (nSize == 1)
+    {
+        rgba[0] = rgba[1] = rgba[2] = pSrc[0];
+        rgba[3]                     = 0xff;
     }
     else
     {
-        nStart     = pMipSet->m_nHeight - 1;
-        nEnd       = -1;
-        nIncrement = -1;
+        rgba[0] = pSrc[2];
+        rgba[1] = pSrc[1];
+        rgba[2] = pSrc[0];
+        rgba[3] = (nSize == 4) ? pSrc[3] : 0xff;
     }
 
-    CMP_BYTE nBlue;
-    CMP_BYTE nGreen;
-    CMP_BYTE nRed;
-    CMP_BYTE nAlpha;
+    uint32_t nPixel;
+    memcpy(&nPixel, rgba, sizeof(nPixel));
+    for (int i = 0; i < nCount; i++)
+        memcpy(pData + i * sizeof(nPixel), &nPixel, sizeof(nPixel));
+}
 
-    for (int j = nStart; j != nEnd; j += nIncrement)
+// Walks the packet headers to find where each job of nRowsPerJob rows starts decoding.
+// Returns false if the data ends before the last pixel.
+static bool FindTGARLEPositions(const std::vector<CMP_BYTE>& data, int nWidth, int nHeight, int nSize, int nRowsPerJob, std::vector<TGA_RLEPosition>& positions)
+{
+    size_t nPixels    = (size_t)nWidth * nHeight;
+    size_t nJobPixels = (size_t)nWidth * nRowsPerJob;
+    size_t nNextJob   = 0;  // First pixel of the next job
+    size_t nPixel     = 0;  // First pixel of the packet at nOffset
+    size_t nOffset    = 0;
+
+    while (nPixel < nPixels)
     {
-        CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * pMipSet->m_nWidth * sizeof(CMP_COLOR)));
-        for (int i = 0; i < pMipSet->m_nWidth; i++)
-        {
-            // Note MIPSet is  RGBA
-            // TGA is saved as BGRA
-            nBlue  = *pTempPtr++;
-            nGreen = *pTempPtr++;
-            nRed   = *pTempPtr++;
-            nAlpha = *pTempPtr++;
+        if (nOffset >= data.size())
+            return false;
 
-            // printf("{%d,%d,%d,%d}\n", nRed, nGreen, nBlue, nAlpha);
+        CMP_BYTE cPacket = data[nOffset];
+        size_t   nCount  = (cPacket & 0x7f) + 1;
 
-            *pData++ = nRed;
-            *pData++ = nGreen;
-            *pData++ = nBlue;
-            *pData++ = nAlpha;
+        while ((nNextJob < nPixel + nCount) && (nNextJob < nPixels))
+        {
+            TGA_RLEPosition position = {nOffset, (int)(nNextJob - nPixel)};
+            positions.push_back(position);
+            nNextJob += nJobPixels;
         }
+
+        nOffset += 1 + ((cPacket & 0x80) ? nSize : nCount * nSize);
+        nPixel += nCount;
     }
 
-    free(pTempData);
+    return nOffset <= data.size();
+}
 
-    return PE_OK;
+// Decodes nRows rows, counted in file order from nFirstRow, to RGBA8888. Returns false if the data ends early.
+static bool DecodeTGARLERows(const std::vector<CMP_BYTE>& data,
+                             TGA_RLEPosition              position,
+                             CMP_BYTE*                    pMipData,
+                             int                          nWidth,
+                             int                          nHeight,
+                             bool                         bTopDown,
+                             int                          nFirstRow,
+                             int                          nRows,
+                             int                          nSize)
+{
+    const CMP_BYTE* pSrc    = data.data();
+    size_t          nOffset = position.nOffset;
+    int             nSkip   = position.nSkip;
+    CMP_DWORD       dwPitch = nWidth * sizeof(CMP_COLOR);
+
+    for (int j = nFirstRow; j < nFirstRow + nRows; j++)
+    {
+        int       nRow  = bTopDown ? j : nHeight - 1 - j;
+        CMP_BYTE* pData = pMipData + (size_t)nRow * dwPitch;
+
+        int nColumn = 0;
+        while (nColumn < nWidth)
+        {
+            if (nOffset >= data.size())
+                return false;
+
+            CMP_BYTE cPacket     = pSrc[nOffset];
+            int      nCount      = (cPacket & 0x7f) + 1;
+            bool     bRun        = (cPacket & 0x80) != 0;
+            size_t   nPacketSize = 1 + (bRun ? nSize : (size_t)nCount * nSize);
+            if (nOffset + nPacketSize > data.size())
+                return false;
+
+            int nPixels = (std::min)(nCount - nSkip, nWidth - nColumn);
+            if (bRun)
+                FillTGAPixels(pData + nColumn * sizeof(CMP_COLOR), pSrc + nOffset + 1, nPixels, nSize);
+            else
+                ConvertTGAPixels(pData + nColumn * sizeof(CMP_COLOR), pSrc + nOffset + 1 + nSkip * nSize, nPixels, nSize);
+
+            nColumn += nPixels;
+            nSkip += nPixels;
+            if (nSkip == nCount)
+            {
+                nOffset += nPacketSize;
+                nSkip = 0;
+            }
+        }
+    }
+
+    return true;
 }
 
-TC_PluginError LoadTGA_ARGB8888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+// Loads a run length encoded image of nSize (1, 3 or 4) byte pixels as RGBA8888. The file is read
+// in one pass; large images are then decoded in parallel, in bands of rows.
+static TC_PluginError LoadTGA_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header, int nSize)
 {
     if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), Header.nWidth, Header.nHeight, CF_8bit, TDT_ARGB))
+    {
+        fclose(pFile);
         return PE_Unknown;
+    }
 
     pMipSet->m_ChannelFormat   = CF_8bit;
     pMipSet->m_TextureDataType = TDT_ARGB;
     pMipSet->m_dwFourCC        = 0;
     pMipSet->m_dwFourCC2       = 0;
-    pMipSet->m_format          = CMP_FORMAT_ARGB_8888;
     pMipSet->m_nMipLevels      = 1;
+    pMipSet->m_format          = CMP_FORMAT_ARGB_8888;
 
-    // Allocate a temporary buffer and read the bitmap data into it
-    long lCurrPos = ftell(pFile);
-    fseek(pFile, 0, SEEK_END);
-    long lEndPos = ftell(pFile);
-    fseek(pFile, lCurrPos, SEEK_SET);
-    CMP_DWORD      dwTempSize = lEndPos - lCurrPos;
-    unsigned char* pTempData  = static_cast<unsigned char*>(malloc(dwTempSize));
-    fread(pTempData, dwTempSize, 1, pFile);
-    fclose(pFile);
+    std::vector<CMP_BYTE> data;
+    bool                  bResult = ReadTGAImageData(pFile, data);
 
-    CMP_DWORD dwPitch  = pMipSet->m_nWidth * sizeof(CMP_COLOR);
-    CMP_BYTE* pTempPtr = pTempData;
+    int       nWidth   = pMipSet->m_nWidth;
+    int       nHeight  = pMipSet->m_nHeight;
+    bool      bTopDown = (Header.cFormatFlags & 0x20) != 0;
+    CMP_BYTE* pMipData = TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData;
 
-    int nStart, nEnd, nIncrement;
-    // Bottom up ?
-    if (Header.cFormatFlags & 0x20)
-    {
-        nStart     = 0;
-        nEnd       = pMipSet->m_nHeight;
-        nIncrement = 1;
-    }
+    int          nRowsPerJob = GetRowsPerJob(nWidth, nHeight);
+    unsigned int numJobs     = (nHeight + nRowsPerJob - 1) / nRowsPerJob;
+
+    std::vector<TGA_RLEPosition> positions;
+    if (bResult && (numJobs > 1))
+        bResult = FindTGARLEPositions(data, nWidth, nHeight, nSize, nRowsPerJob, positions);
     else
     {
-        nStart     = pMipSet->m_nHeight - 1;
-        nEnd       = -1;
-        nIncrement = -1;
+        TGA_RLEPosition start = {0, 0};
+        positions.push_back(start);
     }
 
-    for (int j = nStart; j != nEnd; j += nIncrement)
+    if (bResult)
     {
-        CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * dwPitch));
-
-        int nColumn = 0;
-        while (nColumn < pMipSet->m_nWidth)
-        {
-            unsigned char nLength = *pTempPtr++;
-            if (nLength & 0x80)
-            {
-                int      nRepeat = nLength - 0x7f;
-                CMP_BYTE nBlue   = *pTempPtr++;
-                CMP_BYTE nGreen  = *pTempPtr++;
-                CMP_BYTE nRed    = *pTempPtr++;
-                CMP_BYTE nAlpha  = *pTempPtr++;
-
-                while (nRepeat && nColumn < pMipSet->m_nWidth)
-                {
-                    *pData++ = nRed;
-                    *pData++ = nGreen;
-                    *pData++ = nBlue;
-                    *pData++ = nAlpha;
-                    nColumn++;
-                    nRepeat--;
-                }
-            }
-            else
-            {
-                int nRepeat = nLength + 1;
-                while (nRepeat && nColumn < pMipSet->m_nWidth)
-                {
-                    CMP_BYTE nBlue  = *pTempPtr++;
-                    CMP_BYTE nGreen = *pTempPtr++;
-                    CMP_BYTE nRed   = *pTempPtr++;
-                    CMP_BYTE nAlpha = *pTempPtr++;
-                    *pData++        = nRed;
-                    *pData++        = nGreen;
-                    *pData++        = nBlue;
-                    *pData++        = nAlpha;
-                    nColumn++;
-                    nRepeat--;
-                }
-            }
-        }
+        std::atomic<bool> bDecoded(true);
+        RunTGAJobs(numJobs, [&](unsigned int job) {
+            int nFirstRow = job * nRowsPerJob;
+            int nRows     = (std::min)(nRowsPerJob, nHeight - nFirstRow);
+            if (!DecodeTGARLERows(data, positions[job], pMipData, nWidth, nHeight, bTopDown, nFirstRow, nRows, nSize))
+                bDecoded = false;
+        });
+        bResult = bDecoded;
     }
 
-    free(pTempData);
+    if (!bResult)
+    {
+        if (TGA_CMips)
+            TGA_CMips->PrintError(("Error(%d): TGA Plugin ID(%d) run length encoded image data is incomplete "), EL_Error, IDS_ERROR_NOT_TGA);
+        return PE_Unknown;
+    }
 
     return PE_OK;
 }
 
-TC_PluginError LoadTGA_RGB888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+TC_PluginError LoadTGA_ARGB8888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
 {
     if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), Header.nWidth, Header.nHeight, CF_8bit, TDT_ARGB))
         return PE_Unknown;
@@ -416,11 +525,11 @@ TC_PluginError LoadTGA_RGB888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
     pMipSet->m_TextureDataType = TDT_ARGB;
     pMipSet->m_dwFourCC        = 0;
     pMipSet->m_dwFourCC2       = 0;
-    pMipSet->m_nMipLevels      = 1;
     pMipSet->m_format          = CMP_FORMAT_ARGB_8888;
+    pMipSet->m_nMipLevels      = 1;
 
     // Allocate a temporary buffer and read the bitmap data into it
-    CMP_DWORD      dwSize    = pMipSet->m_nWidth * pMipSet->m_nHeight * 3;
+    CMP_DWORD      dwSize    = pMipSet->m_nWidth * pMipSet->m_nHeight * sizeof(CMP_COLOR);
     unsigned char* pTempData = static_cast<unsigned char*>(malloc(dwSize));
     fread(pTempData, dwSize, 1, pFile);
     fclose(pFile);
@@ -445,20 +554,26 @@ TC_PluginError LoadTGA_RGB888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
     CMP_BYTE nBlue;
     CMP_BYTE nGreen;
     CMP_BYTE nRed;
+    CMP_BYTE nAlpha;
 
     for (int j = nStart; j != nEnd; j += nIncrement)
     {
         CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * pMipSet->m_nWidth * sizeof(CMP_COLOR)));
         for (int i = 0; i < pMipSet->m_nWidth; i++)
         {
+            // Note MIPSet is  RGBA
+            // TGA is saved as BGRA
             nBlue  = *pTempPtr++;
             nGreen = *pTempPtr++;
             nRed   = *pTempPtr++;
+            nAlpha = *pTempPtr++;
+
+            // printf("{%d,%d,%d,%d}\n", nRed, nGreen, nBlue, nAlpha);
 
             *pData++ = nRed;
             *pData++ = nGreen;
             *pData++ = nBlue;
-            *pData++ = 0xff;
+            *pData++ = nAlpha;
         }
     }
 
@@ -467,7 +582,12 @@ TC_PluginError LoadTGA_RGB888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
     return PE_OK;
 }
 
-TC_PluginError LoadTGA_RGB888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+TC_PluginError LoadTGA_ARGB8888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+{
+    return LoadTGA_RLE(pFile, pMipSet, Header, 4);
+}
+
+TC_PluginError LoadTGA_RGB888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
 {
     if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), Header.nWidth, Header.nHeight, CF_8bit, TDT_ARGB))
         return PE_Unknown;
@@ -480,17 +600,12 @@ TC_PluginError LoadTGA_RGB888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Heade
     pMipSet->m_format          = CMP_FORMAT_ARGB_8888;
 
     // Allocate a temporary buffer and read the bitmap data into it
-    long lCurrPos = ftell(pFile);
-    fseek(pFile, 0, SEEK_END);
-    long lEndPos = ftell(pFile);
-    fseek(pFile, lCurrPos, SEEK_SET);
-    CMP_DWORD      dwTempSize = lEndPos - lCurrPos;
-    unsigned char* pTempData  = static_cast<unsigned char*>(malloc(dwTempSize));
-    fread(pTempData, dwTempSize, 1, pFile);
+    CMP_DWORD      dwSize    = pMipSet->m_nWidth * pMipSet->m_nHeight * 3;
+    unsigned char* pTempData = static_cast<unsigned char*>(malloc(dwSize));
+    fread(pTempData, dwSize, 1, pFile);
     fclose(pFile);
 
-    CMP_BYTE* pTempPtr   = pTempData;
-    CMP_DWORD dwPitchOut = pMipSet->m_nWidth * sizeof(CMP_COLOR);
+    CMP_BYTE* pTempPtr = pTempData;
 
     int nStart, nEnd, nIncrement;
     // Bottom up ?
@@ -507,51 +622,23 @@ TC_PluginError LoadTGA_RGB888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Heade
         nIncrement = -1;
     }
 
-    unsigned char nRepeat = 0;
-    unsigned char nLength = 0;
+    CMP_BYTE nBlue;
+    CMP_BYTE nGreen;
+    CMP_BYTE nRed;
+
     for (int j = nStart; j != nEnd; j += nIncrement)
     {
-        CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * dwPitchOut));
-
-        int nColumn = 0;
-        while (nColumn < pMipSet->m_nWidth)
+        CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * pMipSet->m_nWidth * sizeof(CMP_COLOR)));
+        for (int i = 0; i < pMipSet->m_nWidth; i++)
         {
-            if (nRepeat == 0)
-            {
-                nLength = *pTempPtr++;
-                nRepeat = (nLength & 0x7f) + 1;
-            }
+            nBlue  = *pTempPtr++;
+            nGreen = *pTempPtr++;
+            nRed   = *pTempPtr++;
 
-            if (nLength & 0x80)
-            {
-                CMP_BYTE nBlue  = *pTempPtr++;
-                CMP_BYTE nGreen = *pTempPtr++;
-                CMP_BYTE nRed   = *pTempPtr++;
-                while (nRepeat && nColumn < pMipSet->m_nWidth)
-                {
-                    *pData++ = nRed;
-                    *pData++ = nGreen;
-                    *pData++ = nBlue;
-                    *pData++ = 0xff;
-                    nColumn++;
-                    nRepeat--;
-                }
-            }
-            else
-            {
-                while (nRepeat && nColumn < pMipSet->m_nWidth)
-                {
-                    CMP_BYTE nBlue  = *pTempPtr++;
-                    CMP_BYTE nGreen = *pTempPtr++;
-                    CMP_BYTE nRed   = *pTempPtr++;
-                    *pData++        = nRed;
-                    *pData++        = nGreen;
-                    *pData++        = nBlue;
-                    *pData++        = 0xff;
-                    nColumn++;
-                    nRepeat--;
-                }
-            }
+            *pData++ = nRed;
+            *pData++ = nGreen;
+            *pData++ = nBlue;
+            *pData++ = 0xff;
         }
     }
 
@@ -560,6 +647,11 @@ TC_PluginError LoadTGA_RGB888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Heade
     return PE_OK;
 }
 
+TC_PluginError LoadTGA_RGB888_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
+{
+    return LoadTGA_RLE(pFile, pMipSet, Header, 3);
+}
+
 // No longer used : Remove
 TC_PluginError LoadTGA_G8(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
 {
@@ -646,174 +738,123 @@ TC_PluginError LoadTGA_G8(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
 
 TC_PluginError LoadTGA_G8_RLE(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
 {
-    if (!TGA_CMips->AllocateMipLevelData(TGA_CMips->GetMipLevel(pMipSet, 0), Header.nWidth, Header.nHeight, CF_8bit, TDT_ARGB))
-        return PE_Unknown;
-
-    pMipSet->m_ChannelFormat   = CF_8bit;
-    pMipSet->m_TextureDataType = TDT_ARGB;
-    pMipSet->m_dwFourCC        = 0;
-    pMipSet->m_dwFourCC2       = 0;
-    pMipSet->m_nMipLevels      = 1;
-    pMipSet->m_format          = CMP_FORMAT_ARGB_8888;
-
-    // Allocate a temporary buffer and read the bitmap data into it
-    long lCurrPos = ftell(pFile);
-    fseek(pFile, 0, SEEK_END);
-    long lEndPos = ftell(pFile);
-    fseek(pFile, lCurrPos, SEEK_SET);
-    CMP_DWORD      dwTempSize = lEndPos - lCurrPos;
-    unsigned char* pTempData  = static_cast<unsigned char*>(malloc(dwTempSize));
-    fread(pTempData, dwTempSize, 1, pFile);
-    fclose(pFile);
+    return LoadTGA_RLE(pFile, pMipSet, Header, 1);
+}
 
-    CMP_BYTE* pTempPtr = pTempData;
+// Converts nCount RGBA8888 pixels to TGA pixels of nSize (3 or 4) bytes, which are stored as BGR(A)
+static void ConvertToTGAPixels(CMP_BYTE* pDst, const CMP_BYTE* pData, int nCount, int nSize)
+{
+    static const unsigned char mapBGRA[4] = {2, 1, 0, 3};
 
-    int nStart, nEnd, nIncrement;
-    // Bottom up ?
-    if (Header.cFormatFlags & 0x20)
-    {
-        nStart     = 0;
-        nEnd       = pMipSet->m_nHeight;
-        nIncrement = 1;
-    }
+    if (nSize == 4)
+        CMP_SwizzleN(pDst, pData, nCount, 4, mapBGRA);
     else
     {
-        nStart     = pMipSet->m_nHeight - 1;
-        nEnd       = -1;
-        nIncrement = -1;
-    }
-
-    for (int j = nStart; j != nEnd; j += nIncrement)
-    {
-        CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * pMipSet->m_nWidth * sizeof(CMP_COLOR)));
-
-        int nColumn = 0;
-        while (nColumn < pMipSet->m_nWidth)
+        for (int i = 0; i < nCount; i++)
         {
-            unsigned char nLength = *pTempPtr++;
-            if (nLength & 0x80)
-            {
-                int      nRepeat = nLength - 0x7f;
-                CMP_BYTE gray    = *pTempPtr++;
-                while (nRepeat && nColumn < pMipSet->m_nWidth)
-                {
-                    *pData++ = gray;
-                    *pData++ = gray;
-                    *pData++ = gray;
-                    *pData++ = 0xff;
-                    nColumn++;
-                    nRepeat--;
-                }
-            }
-            else
-            {
-                int      nRepeat = nLength + 1;
-                CMP_BYTE gray    = *pTempPtr++;
-                while (nRepeat && nColumn < pMipSet->m_nWidth)
-                {
-                    *pData++ = gray;
-                    *pData++ = gray;
-                    *pData++ = gray;
-                    *pData++ = 0xff;
-                    nColumn++;
-                    nRepeat--;
-                }
-            }
+            *pDst++ = pData[2];
+            *pDst++ = pData[1];
+            *pDst++ = pData[0];
+            pData += sizeof(CMP_COLOR);
         }
     }
-
-    free(pTempData);
-
-    return PE_OK;
 }
 
-CMP_BYTE CalcRunLength(CMP_BYTE* pThis, CMP_BYTE* pEnd, int nSize, int nOffset)
+// Run length encodes a row of nWidth TGA pixels of nSize bytes to pOut, which must hold
+// nWidth * (nSize + 1) bytes, and returns the number of bytes written. Packets end with the row.
+template <int nSize>
+static size_t EncodeTGARLERow(const CMP_BYTE* pRow, int nWidth, CMP_BYTE* pOut)
 {
-    CMP_BYTE* pNext      = pThis + nOffset;
-    CMP_BYTE  cRunLength = 1;
+    CMP_BYTE* pStart = pOut;
 
-    while (pNext < pEnd && memcmp(pThis, pNext, nSize) == 0 && cRunLength < 0x80)
+    int i = 0;
+    while (i < nWidth)
     {
-        cRunLength++;
-        pNext += nOffset;
-    }
+        const CMP_BYTE* pThis = pRow + i * nSize;
 
-    return cRunLength;
-}
+        // Repeats of pixel i
+        int nRun = 1;
+        while ((i + nRun < nWidth) && (nRun < 0x80) && (memcmp(pThis, pThis + nRun * nSize, nSize) == 0))
+            nRun++;
 
-CMP_BYTE CalcRawLength(CMP_BYTE* pThis, CMP_BYTE* pEnd, int nSize, int nOffset)
-{
-    CMP_BYTE* pNext      = pThis + nOffset;
-    CMP_BYTE  cRawLength = 1;
-
-    while (pNext < pEnd && memcmp(pThis, pNext, nSize) != 0 && cRawLength < 0x80)
-    {
-        cRawLength++;
-        pThis += nOffset;
-        pNext += nOffset;
+        if (nRun > 1)
+        {
+            *pOut++ = (CMP_BYTE)((nRun - 1) | 0x80);
+            memcpy(pOut, pThis, nSize);
+            pOut += nSize;
+            i += nRun;
+        }
+        else
+        {
+            // Pixels up to the next pair of equal pixels, which starts a run
+            int nRaw = 1;
+            while ((i + nRaw < nWidth) && (nRaw < 0x80) &&
+                   !((i + nRaw + 1 < nWidth) && (memcmp(pThis + nRaw * nSize, pThis + (nRaw + 1) * nSize, nSize) == 0)))
+                nRaw++;
+
+            *pOut++ = (CMP_BYTE)(nRaw - 1);
+            memcpy(pOut, pThis, nRaw * nSize);
+            pOut += nRaw * nSize;
+            i += nRaw;
+        }
     }
 
-    return cRawLength;
+    return pOut - pStart;
 }
 
-// *** NOTE ****
-// The Save data code needs to be rewored as
-// TGA is saved as BGRA and our MipSet is using RGBA
-//
-// Current implementation is saving in wronge format as RGBA
-//
-// Need to Fix this
-
-void SaveLineRLE(FILE* pFile, CMP_BYTE* pThis, CMP_BYTE* pEnd, int nSize, int nOffset)
+// Saves the image as run length encoded TGA pixels of nSize (1, 3 or 4) bytes, bottom row first.
+// Bands of rows are encoded in parallel to separate buffers, which are then written in order.
+static TC_PluginError SaveRLE(FILE* pFile, const MipSet* pMipSet, int nSize)
 {
-    while (pThis < pEnd)
-    {
-        CMP_BYTE* pNext = pThis + nOffset;
-        // Are the next two pixel the same ?
-        if (pNext < pEnd && memcmp(pThis, pNext, nSize) == 0)
+    int             nWidth   = pMipSet->m_nWidth;
+    int             nHeight  = pMipSet->m_nHeight;
+    CMP_DWORD       dwPitch  = nWidth * ((nSize == 1) ? 1 : sizeof(CMP_COLOR));
+    const CMP_BYTE* pMipData = TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData;
+
+    int          nRowsPerJob = GetRowsPerJob(nWidth, nHeight);
+    unsigned int numJobs     = (nHeight + nRowsPerJob - 1) / nRowsPerJob;
+    size_t       nMaxRowSize = (size_t)nWidth * (nSize + 1);
+
+    std::vector<std::vector<CMP_BYTE>> encoded(numJobs);
+    RunTGAJobs(numJobs, [&](unsigned int job) {
+        int nFirstRow = job * nRowsPerJob;
+        int nRows     = (std::min)(nRowsPerJob, nHeight - nFirstRow);
+
+        std::vector<CMP_BYTE>  row((size_t)nWidth * nSize);
+        std::vector<CMP_BYTE>& out   = encoded[job];
+        size_t                 nUsed = 0;
+        out.resize(nRows * nMaxRowSize);
+
+        for (int j = nFirstRow; j < nFirstRow + nRows; j++)
         {
-            CMP_BYTE cRunLength       = CalcRunLength(pThis, pEnd, nSize, nOffset);
-            CMP_BYTE cRepetitionCount = (cRunLength - 1) | 0x80;
-            fwrite(&cRepetitionCount, sizeof(cRepetitionCount), 1, pFile);
-            fwrite(pThis, nSize, 1, pFile);
-            pThis += (cRunLength * nOffset);
-        }
-        else
-        {
-            CMP_BYTE cRawLength       = CalcRawLength(pThis, pEnd, nSize, nOffset);
-            CMP_BYTE cRepetitionCount = (cRawLength - 1);
-            fwrite(&cRepetitionCount, sizeof(cRepetitionCount), 1, pFile);
-            if (nSize == nOffset)
+            const CMP_BYTE* pRow = pMipData + (size_t)(nHeight - 1 - j) * dwPitch;
+            if (nSize != 1)
             {
-                fwrite(pThis, nSize * cRawLength, 1, pFile);
-                pThis += (cRawLength * nOffset);
+                ConvertToTGAPixels(row.data(), pRow, nWidth, nSize);
+                pRow = row.data();
             }
+
+            if (nSize == 4)
+                nUsed += EncodeTGARLERow<4>(pRow, nWidth, out.data() + nUsed);
+            else if (nSize == 3)
+                nUsed += EncodeTGARLERow<3>(pRow, nWidth, out.data() + nUsed);
             else
-            {
-                for (CMP_BYTE i = 0; i < cRawLength; i++)
-                {
-                    fwrite(pThis, nSize, 1, pFile);
-                    pThis += nOffset;
-                }
-            }
+                nUsed += EncodeTGARLERow<1>(pRow, nWidth, out.data() + nUsed);
         }
-    }
-}
 
-TC_PluginError SaveRLE(FILE* pFile, const MipSet* pMipSet, int nSize, int nOffset)
-{
-    CMP_DWORD dwPitch = pMipSet->m_nWidth * nOffset;
-    for (int j = pMipSet->m_nHeight - 1; j >= 0; j--)
-    {
-        CMP_BYTE* pThis = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * dwPitch));
-        CMP_BYTE* pEnd  = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + ((j + 1) * dwPitch));
+        out.resize(nUsed);
+    });
 
-        SaveLineRLE(pFile, pThis, pEnd, nSize, nOffset);
+    bool bResult = true;
+    for (unsigned int job = 0; job < numJobs; job++)
+    {
+        if (!encoded[job].empty() && (fwrite(encoded[job].data(), encoded[job].size(), 1, pFile) != 1))
+            bResult = false;
     }
 
     fclose(pFile);
 
-    return PE_OK;
+    return bResult ? PE_OK : PE_Unknown;
 }
 
 //--------------------------------------------------------
@@ -823,32 +864,15 @@ TC_PluginError SaveRLE(FILE* pFile, const MipSet* pMipSet, int nSize, int nOffse
 
 TC_PluginError SaveTGA_ARGB8888(FILE* pFile, const MipSet* pMipSet)
 {
-    CMP_DWORD dwPitch = pMipSet->m_nWidth * 4;
+    CMP_DWORD             dwPitch = pMipSet->m_nWidth * sizeof(CMP_COLOR);
+    std::vector<CMP_BYTE> row(dwPitch);
 
-    //if (pMipSet->m_swizzle)
+    for (int j = pMipSet->m_nHeight - 1; j >= 0; j--)
     {
-        CMP_BYTE RGBA[4];
-        for (int j = pMipSet->m_nHeight - 1; j >= 0; j--)
-        {
-            CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * dwPitch));
-            for (int i = 0; i < pMipSet->m_nWidth; i++)
-            {
-                RGBA[2] = (CMP_BYTE)*pData++;
-                RGBA[1] = (CMP_BYTE)*pData++;
-                RGBA[0] = (CMP_BYTE)*pData++;
-                RGBA[3] = (CMP_BYTE)*pData++;
-                fwrite(RGBA, 4, 1, pFile);
-            }
-        }
+        CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * dwPitch));
+        ConvertToTGAPixels(row.data(), pData, pMipSet->m_nWidth, 4);
+        fwrite(row.data(), row.size(), 1, pFile);
     }
-    //else
-    //{
-    //    for (int j = pMipSet->m_nHeight - 1; j >= 0; j--)
-    //    {
-    //        CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * dwPitch));
-    //        fwrite(pData, dwPitch, 1, pFile);
-    //    }
-    //}
 
     fclose(pFile);
 
@@ -857,21 +881,19 @@ TC_PluginError SaveTGA_ARGB8888(FILE* pFile, const MipSet* pMipSet)
 
 TC_PluginError SaveTGA_ARGB8888_RLE(FILE* pFile, const MipSet* pMipSet)
 {
-    return SaveRLE(pFile, pMipSet, sizeof(CMP_COLOR), sizeof(CMP_COLOR));
+    return SaveRLE(pFile, pMipSet, 4);
 }
 
 TC_PluginError SaveTGA_RGB888(FILE* pFile, const MipSet* pMipSet)
 {
-    CMP_DWORD dwPitch = pMipSet->m_nWidth * sizeof(CMP_COLOR);
+    CMP_DWORD             dwPitch = pMipSet->m_nWidth * sizeof(CMP_COLOR);
+    std::vector<CMP_BYTE> row(pMipSet->m_nWidth * 3);
+
     for (int j = pMipSet->m_nHeight - 1; j >= 0; j--)
-    //    for(int j=0; j < pMipSet->m_nHeight-1; j++)
     {
         CMP_BYTE* pData = (CMP_BYTE*)(TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * dwPitch));
-        for (int i = 0; i < pMipSet->m_nWidth; i++)
-        {
-            fwrite(pData, 3, 1, pFile);
-            pData += sizeof(CMP_COLOR);
-        }
+        ConvertToTGAPixels(row.data(), pData, pMipSet->m_nWidth, 3);
+        fwrite(row.data(), row.size(), 1, pFile);
     }
 
     fclose(pFile);
@@ -881,7 +903,7 @@ TC_PluginError SaveTGA_RGB888(FILE* pFile, const MipSet* pMipSet)
 
 TC_PluginError SaveTGA_RGB888_RLE(FILE* pFile, const MipSet* pMipSet)
 {
-    return SaveRLE(pFile, pMipSet, 3, sizeof(CMP_COLOR));
+    return SaveRLE(pFile, pMipSet, 3);
 }
 
 TC_PluginError SaveTGA_G8(FILE* pFile, const MipSet* pMipSet)
@@ -899,7 +921,7 @@ TC_PluginError SaveTGA_G8(FILE* pFile, const MipSet* pMipSet)
 
 TC_PluginError SaveTGA_G8_RLE(FILE* pFile, const MipSet* pMipSet)
 {
-    return SaveRLE(pFile, pMipSet, sizeof(CMP_BYTE), sizeof(CMP_BYTE));
+    return SaveRLE(pFile, pMipSet, 1);
 }
 
 // ------------ Registry!
@@ -944,3 +966,23 @@ void SaveRegistryKeys(const TGA_FileSaveParams* pParams)
     RegCloseKey(hKey);
 #endif
 }
+
+// Reads the save options from space separated words, missing options are off:
+//     RLE    save 24 and 32 bit images run length encoded
+void ParseTextParams(TGA_FileSaveParams* pParams, const char* pszTextParams)
+{
+    pParams->dwSize         = sizeof(TGA_FileSaveParams);
+    pParams->bRLECompressed = false;
+    if (!pszTextParams)
+        return;
+
+    std::string params(pszTextParams);
+    size_t      nStart = params.find_first_not_of(' ');
+    while (nStart != std::string::npos)
+    {
+        size_t nEnd = params.find(' ', nStart);
+        if (params.compare(nStart, nEnd - nStart, "RLE") == 0)
+            pParams->bRLECompressed = true;
+        nStart = params.find_first_not_of(' ', nEnd);
+    }
+}
@@ -48,6 +48,13 @@ static const GUID g_GUID = {0};
 #define TC_PLUGIN_VERSION_MAJOR 1
 #define TC_PLUGIN_VERSION_MINOR 0
 
+typedef struct
+{
+    CMP_DWORD dwSize;
+
+    bool bRLECompressed;
+} TGA_FileSaveParams;
+
 class Plugin_TGA : public PluginInterface_Image
 {
 public:
@@ -60,6 +67,10 @@ public:
     int TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet);
     int TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* srcTexture);
     int TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* srcTexture);
+    int TC_PluginSetFileSaveParams(const char* pszTextParams);
+
+private:
+    TGA_FileSaveParams m_FileSaveParams;
 };
 
 extern void* make_Plugin_TGA();
@@ -109,13 +120,6 @@ static const CMP_BYTE ImageType_G8           = 3;   // Raw greyscale
 static const CMP_BYTE ImageType_ARGB8888_RLE = 10;  // RLE RGB
 static const CMP_BYTE ImageType_G8_RLE       = 11;  // RLE greyscale
 
-typedef struct
-{
-    CMP_DWORD dwSize;
-
-    bool bRLECompressed;
-} TGA_FileSaveParams;
-
 #pragma pack(pop)
 
 #define IDS_STRING1 1
@@ -143,6 +147,6 @@ TC_PluginError SaveTGA_G8_RLE(FILE* pFile, const MipSet* pMipSet);
 void LoadRegistryKeys(TGA_FileSaveParams* pParams);
 void LoadRegistryKeyDefaults(TGA_FileSaveParams* pParams);
 void SaveRegistryKeys(const TGA_FileSaveParams* pParams);
-void ParseTextParams(TGA_FileSaveParams* pParams, const TCHAR* pszTextParams);
+void ParseTextParams(TGA_FileSaveParams* pParams, const char* pszTextParams);
 
 #endif
@@ -27,6 +27,8 @@
 #include <cstdio>
 #include <cstring>
 #include <ctime>
+#include <string>
+#include <vector>
 
 #ifdef BUILD_AS_PLUGIN_DLL
 DECLARE_PLUGIN(Plugin_Mesh_Compressor)
@@ -43,6 +45,112 @@ namespace cmesh_mesh_compress
 {
 CMIPS* g_CMIPS = nullptr;
 
+#ifdef USE_MESHOPTIMIZER
+// File layout for meshes encoded with the meshoptimizer codecs: this header, then the encoded vertex buffer, then the encoded index buffer
+struct MeshoptCodecHeader
+{
+    char         magic[4];
+    unsigned int version;
+    unsigned int vertex_count;
+    unsigned int vertex_size;
+    unsigned int index_count;
+    unsigned int vertex_bytes;
+    unsigned int index_bytes;
+};
+
+static const char         MESHOPT_CODEC_MAGIC[4] = {'C', 'M', 'S', 'H'};
+static const unsigned int MESHOPT_CODEC_VERSION  = 1;
+
+int EncodeMeshoptToFile(const CMP_Mesh& mesh, const std::string& file)
+{
+    if (g_CMIPS)
+        g_CMIPS->Print("Encode Mesh To File (meshopt codec)");
+
+    if (mesh.indices.size() % 3 != 0)
+    {
+        if (g_CMIPS)
+            g_CMIPS->Print("Failed to encode the mesh. Index count is not a multiple of 3");
+        return -1;
+    }
+
+    std::vector<unsigned char> vertexData(meshopt_encodeVertexBufferBound(mesh.vertices.size(), sizeof(Vertex)));
+    std::vector<unsigned char> indexData(meshopt_encodeIndexBufferBound(mesh.indices.size(), mesh.vertices.size()));
+
+    size_t vertexBytes = meshopt_encodeVertexBuffer(vertexData.data(), vertexData.size(), mesh.vertices.data(), mesh.vertices.size(), sizeof(Vertex));
+    size_t indexBytes  = meshopt_encodeIndexBuffer(indexData.data(), indexData.size(), mesh.indices.data(), mesh.indices.size());
+    if ((vertexBytes == 0) || (indexBytes == 0))
+    {
+        if (g_CMIPS)
+            g_CMIPS->Print("Failed to encode the mesh.");
+        return -1;
+    }
+
+    MeshoptCodecHeader header;
+    memcpy(header.magic, MESHOPT_CODEC_MAGIC, sizeof(header.magic));
+    header.version      = MESHOPT_CODEC_VERSION;
+    header.vertex_count = (unsigned int)mesh.vertices.size();
+    header.vertex_size  = (unsigned int)sizeof(Vertex);
+    header.index_count  = (unsigned int)mesh.indices.size();
+    header.vertex_bytes = (unsigned int)vertexBytes;
+    header.index_bytes  = (unsigned int)indexBytes;
+
+    std::ofstream out_file(file, std::ios::binary);
+    if (!out_file)
+    {
+        if (g_CMIPS)
+            g_CMIPS->Print("Failed to create the output file.");
+        return -1;
+    }
+
+    out_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out_file.write(reinterpret_cast<const char*>(vertexData.data()), vertexBytes);
+    out_file.write(reinterpret_cast<const char*>(indexData.data()), indexBytes);
+
+    return 0;
+}
+
+// Returns a new mesh owned by the caller, or NULL if the data is not a valid meshopt codec stream
+CMP_Mesh* DecodeMeshoptBuffer(const std::vector<char>& data)
+{
+    MeshoptCodecHeader header;
+    if (data.size() < sizeof(header))
+    {
+        if (g_CMIPS)
+            g_CMIPS->Print("Failed to decode the mesh. Input is too small");
+        return NULL;
+    }
+
+    memcpy(&header, data.data(), sizeof(header));
+
+    if ((memcmp(header.magic, MESHOPT_CODEC_MAGIC, sizeof(header.magic)) != 0) || (header.version != MESHOPT_CODEC_VERSION) ||
+        (header.vertex_size != sizeof(Vertex)) || (header.index_count % 3 != 0) ||
+        ((unsigned long long)header.vertex_bytes + header.index_bytes > data.size() - sizeof(header)))
+    {
+        if (g_CMIPS)
+            g_CMIPS->Print("Failed to decode the mesh. Unsupported or corrupt input");
+        return NULL;
+    }
+
+    const unsigned char* vertexData = reinterpret_cast<const unsigned char*>(data.data()) + sizeof(header);
+    const unsigned char* indexData  = vertexData + header.vertex_bytes;
+
+    CMP_Mesh* mesh = new CMP_Mesh;
+    mesh->vertices.resize(header.vertex_count);
+    mesh->indices.resize(header.index_count);
+
+    if ((meshopt_decodeVertexBuffer(mesh->vertices.data(), header.vertex_count, sizeof(Vertex), vertexData, header.vertex_bytes) != 0) ||
+        (meshopt_decodeIndexBuffer(mesh->indices.data(), header.index_count, indexData, header.index_bytes) != 0))
+    {
+        if (g_CMIPS)
+            g_CMIPS->Print("Failed to decode the mesh.");
+        delete mesh;
+        return NULL;
+    }
+
+    return mesh;
+}
+#endif
+
 #if (LIB_BUILD_MESHCOMPRESSOR == 1)
 int EncodeMeshToFile(const draco::Mesh& mesh, const std::string& file, draco::Encoder* encoder)
 {
@@ -160,6 +268,31 @@ void* Plugin_Mesh_Compressor::ProcessMesh(void* data, void* setting, void* stats
     if ((!setting) || (!data))
         return NULL;
 
+#ifdef USE_MESHOPTIMIZER
+    // Lossless alternative to Draco for meshes that are decoded at load time: data is a CMP_Mesh to encode,
+    // or the file contents to decode into a new CMP_Mesh
+    if (((CMP_DracoOptions*)setting)->use_meshopt_codec)
+    {
+        CMP_DracoOptions* options = (CMP_DracoOptions*)setting;
+
+        if (!options->m_bDecode)
+        {
+            if (g_CMIPS)
+                g_CMIPS->Print("Mesh Compressor processing ...");
+
+            if (EncodeMeshoptToFile(*reinterpret_cast<CMP_Mesh*>(data), options->output) == 0)
+                return data;
+            else
+                return NULL;
+        }
+
+        if (g_CMIPS)
+            g_CMIPS->Print("Mesh Decoder processing ...");
+
+        return DecodeMeshoptBuffer(*reinterpret_cast<std::vector<char>*>(data));
+    }
+#endif
+
 #if (LIB_BUILD_MESHCOMPRESSOR == 1)
     draco::Mesh*       mesh;
     draco::PointCloud* pc;
@@ -25,9 +25,14 @@
 #include <cassert>
 #include <cmath>
 #include <cstdio>
+#include <atomic>
+#include <chrono>
 #include <cstring>
 #include <ctime>
 #include <random>
+#include <string>
+#include <thread>
+#include <utility>
 
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 
@@ -305,88 +310,127 @@ void optSimplify(CMP_Mesh& mesh)
     mesh.indices.swap(result.indices);
 }
 
-void optCompleteSimplify(CMP_Mesh& mesh)
+// Runs func(0) .. func(count - 1) on all cores, including the calling thread
+template <typename Func>
+void parallelFor(size_t count, const Func& func)
 {
-    const size_t lod_count = m_settings.nlevelofDetails;
+    std::atomic<size_t> next(0);
 
-    // generate 4 LOD levels (1-4), with each subsequent LOD using 70% triangles
-    // note that each LOD uses the same (shared) vertex buffer
-    // vertex cache optimization should go first as it provides data for overdraw
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++)
+            func(i);
+    };
 
-    //std::vector<unsigned int> lods[lod_count];
-    std::vector<std::vector<unsigned int>> lods;
-    lods.resize(lod_count);
+    size_t threadCount = std::thread::hardware_concurrency();
+    threadCount        = min(threadCount, count);
 
-    lods[0] = mesh.indices;
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < threadCount; ++t)
+        threads.push_back(std::thread(worker));
 
-    for (size_t i = 1; i < lod_count; ++i)
-    {
-        std::vector<unsigned int>& lod = lods[i];
+    worker();
 
-        float  threshold          = powf(0.7f, float(i));
-        size_t target_index_count = size_t(mesh.indices.size() * threshold) / 3 * 3;
+    for (size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+}
 
-        // we can simplify all the way from base level or from the last result
-        // simplifying from the base level sometimes produces better results, but simplifying from last level is faster
-        const std::vector<unsigned int>& source = lods[i - 1];
+// Generates nlevelofDetails - 1 LODs for each mesh, each one with 70% of the triangles of the previous one.
+// Every (mesh, LOD) pair is a separate task that simplifies the full resolution indices of its mesh, so the LODs of
+// all meshes are built in parallel; the tasks of a mesh share its vertex buffer and the quadrics computed once by
+// meshopt_simplifyBegin. Each LOD is then optimized for vertex cache and overdraw.
+void generateLODs(CMP_Mesh* meshes, size_t mesh_count)
+{
+    const size_t lod_count = m_settings.nlevelofDetails;
 
-        lod.resize(source.size());
-        lod.resize(meshopt_simplify(
-            &lod[0], &source[0], source.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), min(source.size(), target_index_count)));
-    }
+    if (lod_count < 2)
+        return;
 
-    // optimize each individual LOD for vertex cache & overdraw
-    for (size_t i = 0; i < lod_count; ++i)
-    {
-        std::vector<unsigned int>& lod = lods[i];
+    std::vector<meshopt_SimplifyContext*> contexts(mesh_count, (meshopt_SimplifyContext*)NULL);
 
-        meshopt_optimizeVertexCache(&lod[0], &lod[0], lod.size(), mesh.vertices.size(), 16);
-        meshopt_optimizeOverdraw(&lod[0], &lod[0], lod.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 1.0f);
-    }
+    parallelFor(mesh_count, [&](size_t m) {
+        CMP_Mesh& mesh = meshes[m];
 
-    // concatenate all LODs into one IB
-    // note: the order of concatenation is important - since we optimize the entire IB for vertex fetch,
-    // putting coarse LODs first makes sure that the vertex range referenced by them is as small as possible
-    // some GPUs process the entire range referenced by the index buffer region so doing this optimizes the vertex transform
-    // cost for coarse LODs
-    std::vector<size_t> lod_index_offsets;
-    lod_index_offsets.resize(lod_count);
-    std::vector<size_t> lod_index_counts;
-    lod_index_counts.resize(lod_count);
+        mesh.lods.clear();
+        if (mesh.indices.empty())
+            return;
 
-    size_t total_index_count = 0;
+        mesh.lods.resize(lod_count - 1);
+        contexts[m] = meshopt_simplifyBegin(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+    });
 
-    for (size_t i = lod_count - 1; i >= 0; --i)
-    {
-        lod_index_offsets[i] = total_index_count;
-        lod_index_counts[i]  = lods[i].size();
+    // larger LODs first, so that the small tasks of the last LODs balance the load at the end
+    std::vector<std::pair<size_t, size_t>> tasks;
+    for (size_t i = 1; i < lod_count; ++i)
+        for (size_t m = 0; m < mesh_count; ++m)
+            if (contexts[m])
+                tasks.push_back(std::make_pair(m, i));
 
-        total_index_count += lods[i].size();
-    }
+    parallelFor(tasks.size(), [&](size_t t) {
+        const CMP_Mesh& mesh = meshes[tasks[t].first];
+        CMP_MeshLOD&    lod  = meshes[tasks[t].first].lods[tasks[t].second - 1];
 
-    mesh.indices.resize(total_index_count);
+        float  threshold          = powf(0.7f, float(tasks[t].second));
+        size_t target_index_count = size_t(mesh.indices.size() * threshold) / 3 * 3;
 
-    for (size_t i = 0; i < lod_count; ++i)
-    {
-        memcpy(&mesh.indices[lod_index_offsets[i]], lods[i].data(), lods[i].size() * sizeof(lods[i][0]));
-    }
+        lod.indices.resize(mesh.indices.size());
+        lod.indices.resize(meshopt_simplifyFromContext(&lod.indices[0], contexts[tasks[t].first], target_index_count));
 
-    // vertex fetch optimization should go last as it depends on the final index order
-    // note that the order of LODs above affects vertex fetch results
-    meshopt_optimizeVertexFetch(&mesh.vertices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex));
+        if (lod.indices.empty())
+            return;
 
-    printf("%-9s:", "Simplify");
+        meshopt_optimizeVertexCache(&lod.indices[0], &lod.indices[0], lod.indices.size(), mesh.vertices.size(), m_settings.nCacheSize);
+        meshopt_optimizeOverdraw(&lod.indices[0],
+                                 &lod.indices[0],
+                                 lod.indices.size(),
+                                 &mesh.vertices[0].px,
+                                 mesh.vertices.size(),
+                                 sizeof(Vertex),
+                                 m_settings.nOverdrawACMRthreshold);
 
-    for (size_t i = 0; i < sizeof(lods) / sizeof(lods[0]); ++i)
-    {
-        printf(" LOD%d %d", int(i), int(lods[i].size()) / 3);
-    }
+        if (!m_settings.bShareLODVertexBuffer)
+        {
+            // copy the vertices used by the LOD into its own vertex buffer, in the order they are fetched
+            lod.vertices.resize(mesh.vertices.size());
+            lod.vertices.resize(meshopt_optimizeVertexFetch(
+                &lod.vertices[0], &lod.indices[0], lod.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex)));
+        }
+    });
 
-    printf("\n");
+    for (size_t m = 0; m < mesh_count; ++m)
+        if (contexts[m])
+            meshopt_simplifyEnd(contexts[m]);
 
-    // for using LOD data at runtime, in addition to VB and IB you have to save lod_index_offsets/lod_index_counts.
-    (void)lod_index_offsets;
-    (void)lod_index_counts;
+    if (m_settings.bShareLODVertexBuffer && m_settings.bOptimizeVFetch)
+    {
+        parallelFor(mesh_count, [&](size_t m) {
+            CMP_Mesh& mesh = meshes[m];
+
+            if (mesh.lods.empty())
+                return;
+
+            // concatenate all LODs into one IB
+            // note: the order of concatenation is important - since we optimize the entire IB for vertex fetch,
+            // putting coarse LODs first makes sure that the vertex range referenced by them is as small as possible
+            std::vector<unsigned int> indices;
+            for (size_t i = mesh.lods.size(); i > 0; --i)
+                indices.insert(indices.end(), mesh.lods[i - 1].indices.begin(), mesh.lods[i - 1].indices.end());
+            indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
+
+            std::vector<Vertex> vertices(mesh.vertices.size());
+            vertices.resize(meshopt_optimizeVertexFetch(&vertices[0], &indices[0], indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex)));
+            mesh.vertices.swap(vertices);
+
+            // split the remapped indices back into the LODs
+            size_t offset = 0;
+            for (size_t i = mesh.lods.size(); i > 0; --i)
+            {
+                std::vector<unsigned int>& lod = mesh.lods[i - 1].indices;
+                std::copy(indices.begin() + offset, indices.begin() + offset + lod.size(), lod.begin());
+                offset += lod.size();
+            }
+            std::copy(indices.begin() + offset, indices.end(), mesh.indices.begin());
+        });
+    }
 }
 
 void optimize(CMP_Mesh& mesh, const char* name, void (*optf)(CMP_Mesh& mesh), bool compare = true)
@@ -536,5 +580,30 @@ void* Plugin_Mesh_Optimizer::ProcessMesh(void* data, void* setting, void* statsO
         m_copy.push_back(*mesh);
     }
 
+    if (m_settings.bGenerateLODs)
+    {
+        if (g_CMIPS)
+        {
+            g_CMIPS->Print("Generating %d LODs for %d meshes....", int(m_settings.nlevelofDetails), int(meshdata->m_meshData.size()));
+        }
+
+        size_t first = m_copy.size() - meshdata->m_meshData.size();
+
+        auto start = std::chrono::steady_clock::now();
+        generateLODs(&m_copy[first], m_copy.size() - first);
+        auto end = std::chrono::steady_clock::now();
+
+        PrintInfo("%-9s: Process in %.2f msec\n", "LODs", std::chrono::duration<double, std::milli>(end - start).count());
+
+        for (size_t i = first; i < m_copy.size(); ++i)
+        {
+            std::string triangles = "LOD0 " + std::to_string(m_copy[i].indices.size() / 3);
+            for (size_t k = 0; k < m_copy[i].lods.size(); ++k)
+                triangles += " LOD" + std::to_string(k + 1) + " " + std::to_string(m_copy[i].lods[k].indices.size() / 3);
+
+            PrintInfo("%-9s: #%d %s\n", "LODs", int(i - first + 1), triangles.c_str());
+        }
+    }
+
     return (void*)&m_copy;
 }
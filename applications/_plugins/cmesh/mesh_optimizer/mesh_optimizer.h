@@ -47,6 +47,23 @@ static const GUID g_GUID = {0};
 //=================================================================================================================================
 struct MeshSettings
 {
+    MeshSettings()
+    {
+        pMeshName              = NULL;
+        pDestMeshName          = NULL;
+        nCacheSize             = 16;
+        nlevelofDetails        = 5;
+        nOverdrawACMRthreshold = 1.05f;
+        bSimplifyMesh          = false;
+        bGenerateLODs          = false;
+        bShareLODVertexBuffer  = false;
+        bOptimizeVFetch        = true;
+        bOptimizeOverdraw      = true;
+        bOptimizeVCacheFifo    = false;
+        bOptimizeVCache        = true;
+        bRandomizeMesh         = false;
+    };
+
     const char* pMeshName;
     const char* pDestMeshName;
 
@@ -54,7 +71,9 @@ struct MeshSettings
     unsigned int nlevelofDetails;  //LOD for mesh simplify (edge collapse)
     float        nOverdrawACMRthreshold;
 
-    bool bSimplifyMesh;  //edge collapse according to user input LOD, higher->lesser triangles
+    bool bSimplifyMesh;          //edge collapse according to user input LOD, higher->lesser triangles
+    bool bGenerateLODs;          //add nlevelofDetails - 1 simplified LODs to CMP_Mesh::lods, each with 70% of the triangles of the previous one
+    bool bShareLODVertexBuffer;  //LODs index the vertex buffer of the mesh instead of having their own, which makes the output smaller
     bool bOptimizeVFetch;
     bool bOptimizeOverdraw;
     bool bOptimizeVCacheFifo;  //optimize based on which go into cache first (using timestamp)
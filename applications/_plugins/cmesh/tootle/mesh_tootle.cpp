@@ -743,6 +743,20 @@ void* Plugin_Mesh_Tootle::ProcessMesh(void* data, void* setting, void* statOut,
         }
     }
 
+    // report the KD tree built to ray trace the last overdraw computation
+    TootleRaytraceStats raytraceStats;
+    if (g_CMIPS && (TootleGetRaytraceStats(&raytraceStats) == TOOTLE_OK))
+    {
+        g_CMIPS->Print("Overdraw KD tree built in %.3f s: %u nodes, %u leaves (%u empty), depth %u, %.2f tris per leaf, SAH cost %.2f",
+                       raytraceStats.fBuildSeconds,
+                       raytraceStats.nNodes,
+                       raytraceStats.nLeaves,
+                       raytraceStats.nEmptyLeaves,
+                       raytraceStats.nMaxDepth,
+                       raytraceStats.fTrisPerLeaf,
+                       raytraceStats.fSAHCost);
+    }
+
     //-----------------------------------------------------------------------------------------------------
     // PERFORM VERTEX MEMORY OPTIMIZATION (rearrange memory layout for vertices based on the final indices
     //  to exploit vertex cache prefetch).
@@ -23,6 +23,9 @@
 
 #include "copencl.h"
 
+#include <stdarg.h>
+#include <algorithm>
+
 #ifdef USE_CPU_PERFORMANCE_COUNTERS
 #include "cpu_timing.h"  // can use CPU timing but pref is to use GPU counters
 #endif
@@ -66,7 +69,7 @@ void PrintCL(const char* Format, ...)
     char    buff[1024];
     // process the arguments into our debug buffer
     va_start(args, Format);
-    vsprintf_s(buff, Format, args);
+    vsnprintf(buff, sizeof(buff), Format, args);
     va_end(args);
 
     if (GPU_CLMips)
@@ -75,7 +78,7 @@ void PrintCL(const char* Format, ...)
     }
     else
     {
-        printf(buff);
+        printf("%s", buff);
     }
 }
 
@@ -275,49 +278,58 @@ void COpenCL::Init()
 {
     query_timer::Initialize();
 
-    m_initDeviceOk              = false;
-    m_programRun                = false;
-    m_codecFormat               = CMP_FORMAT_Unknown;
-    m_num_blocks                = 0;
-    m_CmpMTxPerSec              = 0;
-    m_computeShaderElapsedMS    = 0.0f;
-    m_platform_id               = NULL;
-    m_device_id                 = NULL;
-    m_num_platforms             = 0;
-    m_command_queue             = NULL;
-    m_kernel                    = NULL;
-    m_device_destination_buffer = NULL;
-    m_device_source_buffer      = NULL;
-    m_Source_Info_buffer        = NULL;
-    m_Encoder_buffer            = NULL;
-    m_program_encoder           = NULL;
-    m_context                   = NULL;
-    m_svmSupport                = false;
-    m_svmData                   = NULL;
-    p_program.buffer            = NULL;
-    ocl_time_device             = 0;
-    m_deviceName                = "";
-    m_version                   = "";
-    m_maxUCores                 = 12;
+    m_initDeviceOk                = false;
+    m_codecFormat                 = CMP_FORMAT_Unknown;
+    m_num_blocks                  = 0;
+    m_CmpMTxPerSec                = 0;
+    m_computeShaderElapsedMS      = 0.0f;
+    m_platform_id                 = NULL;
+    m_device_id                   = NULL;
+    m_num_platforms               = 0;
+    m_command_queue               = NULL;
+    m_upload_queue                = NULL;
+    m_download_queue              = NULL;
+    m_kernel                      = NULL;
+    m_device_destination_buffer   = NULL;
+    m_device_source_buffer        = NULL;
+    m_Source_Info_buffer          = NULL;
+    m_Encoder_buffer              = NULL;
+    m_device_source_capacity      = 0;
+    m_device_destination_capacity = 0;
+    m_encoder_buffer_capacity     = 0;
+    m_program_encoder             = NULL;
+    m_context                     = NULL;
+    m_svmSupport                  = false;
+    m_svmData                     = NULL;
+    p_program.buffer              = NULL;
+    ocl_time_device               = 0;
+    m_deviceName                  = "";
+    m_version                     = "";
+    m_maxUCores                   = 12;
 
     //-------------------------
     // OpenCL compiler options
     //-------------------------
-    long cmp_opt_size    = sizeof(m_compile_options);
-    m_compile_options[0] = 0;
+    std::string compile_options;
 
     // Make all warnings into errors, use -w to Inhitit all warning messages
-    // strncat_s(m_compile_options, cmp_opt_size, "-Werror ", _TRUNCATE);
+    // compile_options += "-Werror ";
 
     // single and double precision denormalized numbers may be flushed to zero
-    strncat_s(m_compile_options, cmp_opt_size, "-cl-denorms-are-zero ", _TRUNCATE);
+    compile_options += "-cl-denorms-are-zero ";
 
     // Looks for addtional include file in this sub-folder
-    strncat_s(m_compile_options, cmp_opt_size, "-I ./Plugins/Compute/ ", _TRUNCATE);
+#ifdef _WIN32
+    compile_options += "-I ./Plugins/Compute/ ";
+#else
+    compile_options += "-I ./plugins/Compute/ ";
+#endif
 
     // Use this to debug with CodeXL or other debuggers
     // This option disables all optimizations
-    // strncat_s(m_compile_options, cmp_opt_size, "-g -cl-opt-disable", _TRUNCATE);
+    // compile_options += "-g -cl-opt-disable";
+
+    snprintf(m_compile_options, sizeof(m_compile_options), "%s", compile_options.c_str());
 
     // User override options set after this init call
     m_force_rebuild = false;
@@ -331,6 +343,9 @@ COpenCL::COpenCL(ComputeOptions CLOptions)
 
 COpenCL::~COpenCL()
 {
+    CleanUpKernelAndIOBuffers();
+    CleanUpProgramEncoder();
+
 #ifdef ENABLE_SVM
     if (m_context && m_svmData)
         clSVMFree(m_context, m_svmData);
@@ -338,12 +353,6 @@ COpenCL::~COpenCL()
 
     if (m_context)
         clReleaseContext(m_context);
-
-    if (m_programRun)
-    {
-        CleanUpKernelAndIOBuffers();
-        CleanUpProgramEncoder();
-    }
 }
 
 void COpenCL::SetComputeOptions(ComputeOptions* CLOptions)
@@ -359,20 +368,49 @@ COpenCL::COpenCL(void* kerneloptions)
 
 void COpenCL::CleanUpProgramEncoder()
 {
-    // Encoder Program & Buffer
+    // Encoder Kernel, Program & Buffer
+    if (m_kernel)
+        clReleaseKernel(m_kernel);
+    m_kernel = NULL;
     if (p_program.buffer)
         delete[] p_program.buffer;
+    p_program.buffer = NULL;
     if (m_program_encoder)
         clReleaseProgram(m_program_encoder);
+    m_program_encoder = NULL;
+}
+
+void COpenCL::ReleaseEvents()
+{
+    for (size_t i = 0; i < m_kernel_events.size(); i++)
+        clReleaseEvent(m_kernel_events[i]);
+    for (size_t i = 0; i < m_read_events.size(); i++)
+        clReleaseEvent(m_read_events[i]);
+    m_kernel_events.clear();
+    m_read_events.clear();
 }
 
 void COpenCL::CleanUpKernelAndIOBuffers()
 {
-    // Command Queues and Kernel functions
+    // Wait for any work that is still using the buffers
+    if (m_upload_queue)
+        clFinish(m_upload_queue);
+    if (m_command_queue)
+        clFinish(m_command_queue);
+    if (m_download_queue)
+        clFinish(m_download_queue);
+    ReleaseEvents();
+
+    // Command Queues
     if (m_command_queue)
         clReleaseCommandQueue(m_command_queue);
-    if (m_kernel)
-        clReleaseKernel(m_kernel);
+    if (m_upload_queue)
+        clReleaseCommandQueue(m_upload_queue);
+    if (m_download_queue)
+        clReleaseCommandQueue(m_download_queue);
+    m_command_queue  = NULL;
+    m_upload_queue   = NULL;
+    m_download_queue = NULL;
 
     // IO Buffers
     if (m_Encoder_buffer)
@@ -383,6 +421,13 @@ void COpenCL::CleanUpKernelAndIOBuffers()
         clReleaseMemObject(m_device_destination_buffer);
     if (m_device_source_buffer)
         clReleaseMemObject(m_device_source_buffer);
+    m_Encoder_buffer              = NULL;
+    m_Source_Info_buffer          = NULL;
+    m_device_destination_buffer   = NULL;
+    m_device_source_buffer        = NULL;
+    m_encoder_buffer_capacity     = 0;
+    m_device_destination_capacity = 0;
+    m_device_source_capacity      = 0;
 }
 
 bool COpenCL::GetPlatformID()
@@ -413,6 +458,21 @@ bool COpenCL::SearchForGPU()
 
     }  // end for
 
+    // No GPU, use a CPU OpenCL device if there is one (such as pocl)
+    if (m_result != CL_SUCCESS)
+    {
+        for (uint32_t i = 0; i < m_num_platforms; i++)
+        {
+            m_result = clGetDeviceIDs(m_platform_ids[i], CL_DEVICE_TYPE_CPU, 1, &m_device_id, NULL);
+            if (m_result == CL_SUCCESS)
+            {
+                m_platform_id = m_platform_ids[i];
+                PrintCL("No OpenCL GPU device found, using a CPU device\n");
+                break;
+            }
+        }
+    }
+
     if (m_result != CL_SUCCESS)
     {
         PrintCL("Failed to get a GPU device!\n");
@@ -482,6 +542,25 @@ bool COpenCL::CreateContext()
     return true;
 }
 
+bool COpenCL::CreateCommandQueues()
+{
+    // Kernels and the two transfer directions use their own in order queues, so that the transfers of one band of
+    // the texture can run while another band is being compressed. Kernel queue has profiling enabled
+    const cl_queue_properties properties[] = {CL_QUEUE_PROPERTIES, CL_QUEUE_PROFILING_ENABLE, 0};
+    m_command_queue                        = clCreateCommandQueueWithProperties(m_context, m_device_id, properties, &m_result);
+    if (m_result == CL_SUCCESS)
+        m_upload_queue = clCreateCommandQueueWithProperties(m_context, m_device_id, NULL, &m_result);
+    if (m_result == CL_SUCCESS)
+        m_download_queue = clCreateCommandQueueWithProperties(m_context, m_device_id, NULL, &m_result);
+    if (m_result != CL_SUCCESS)
+    {
+        PrintCL("Failed to create the command queue!\n");
+        PrintOCLError(m_result);
+        return false;
+    }
+    return true;
+}
+
 long COpenCL::file_size(FILE* p_file)
 {
     // Get the size of the program.
@@ -499,93 +578,21 @@ bool COpenCL::load_file()
     PrintCL("Loading [%s]\n", m_source_file.c_str());
 #endif
 
-    errno_t fopen_result;
-
-    m_isBinary = false;
-
-    if (!m_force_rebuild)
-    {
-        //===========================
-        // Try loading the Binary file
-        //===========================
-        FILE*       p_file_bin = NULL;
-        std::string tmp        = m_source_file;
-        bool        rebuild    = false;
-
-#ifdef _WIN32
-        // Check build configuration of the shader, has it been modified since last use
-        rebuild = cmp_recompile_shader(m_source_file);
-#endif
-
-        if (!rebuild)
-        {
-#ifdef _WIN32
-            fopen_result = fopen_s(&p_file_bin, tmp.append(".cmp").c_str(), "rb");
-            if (fopen_result != 0)
-                rebuild = true;
-#else
-            p_file_bin = fopen(tmp.append(".cmp").c_str(), "rb");
-            if (p_file_bin)
-                rebuild = true;
-#endif
-        }
-
-        // Found a .cmp file use it
-        if (!rebuild)
-        {
-            OpenCLBinary_Header BinFile_Header;
-            if (fread(&BinFile_Header, sizeof(OpenCLBinary_Header), 1, p_file_bin) != 1)
-            {
-                fclose(p_file_bin);
-                PrintCL("Failed to read \"%s.cmp\" file header!\n", m_source_file.c_str());
-                return false;
-            }
-
-            if (BinFile_Header.version != 1)
-            {
-                fclose(p_file_bin);
-                PrintCL("File \"%s.cmp\" is not compatible with current application!\n", m_source_file.c_str());
-                return false;
-            }
-
-            // entry to this code is reserved for CRC checks
-            {
-                m_isBinary     = true;
-                m_program_size = file_size(p_file_bin) - sizeof(OpenCLBinary_Header);
-
-                if (m_program_size == 0)
-                {
-                    fclose(p_file_bin);
-                    PrintCL("Failed to read \"%s.cmp\" file size!\n", m_source_file.c_str());
-                    return false;
-                }
-
-                // Allocate memory for the program.
-                p_program.ubuffer = new unsigned char[m_program_size];
-
-                // Reposition to bin data that is after header
-                fseek(p_file_bin, sizeof(OpenCLBinary_Header), SEEK_SET);
-
-                // Read the program in to memory.
-                if (fread(p_program.buffer, m_program_size, 1, p_file_bin) != 1)
-                {
-                    fclose(p_file_bin);
-                    PrintCL("Failed to read \"%s.cmp\" in to memory!\n", m_source_file.c_str());
-                    return false;
-                }
-
-                fclose(p_file_bin);
-                return true;
-            }  // reserved for CRC type checks
-        }
-    }  // !m_force_rebuild
-
     //===========================
-    // Try loading the source file
+    // Load the source file, it is also needed to find the matching binary in the program cache
     //===========================
-    FILE* p_file_src = NULL;
-    fopen_result     = fopen_s(&p_file_src, m_source_file.c_str(), "rb");
-    if (fopen_result == 0)
+    FILE* p_file_src = fopen(m_source_file.c_str(), "rb");
+#ifndef _WIN32
+    if (!p_file_src)
+    {
+        // The shader files are installed with lower case names
+        size_t pos = m_source_file.find_last_of('/');
+        pos        = (pos == std::string::npos) ? 0 : pos + 1;
+        std::transform(m_source_file.begin() + pos, m_source_file.end(), m_source_file.begin() + pos, ::tolower);
+        p_file_src = fopen(m_source_file.c_str(), "rb");
+    }
+#endif
+    if (p_file_src)
     {
         m_program_size = file_size(p_file_src);
 
@@ -615,99 +622,146 @@ bool COpenCL::load_file()
     //===========================
     // Failed to load the file
     //===========================
+    PrintCL("Failed to open \"%s\"!\n", m_source_file.c_str());
 
     return false;
 }
 
-bool COpenCL::Create_Program_File()
+// Describes the platform, device and driver, any change to these needs a new program binary
+std::string COpenCL::GetDeviceKey()
 {
-    //------------------------------
-    // Load the Source or Binary file
-    //------------------------------
-    load_file();
+    std::string key;
+    char        info[1024];
 
-    cl_int result;
+    const cl_platform_info platform_info[] = {CL_PLATFORM_NAME, CL_PLATFORM_VERSION};
+    for (size_t i = 0; i < sizeof(platform_info) / sizeof(platform_info[0]); i++)
+    {
+        info[0] = 0;
+        if (clGetPlatformInfo(m_platform_id, platform_info[i], sizeof(info), info, NULL) == CL_SUCCESS)
+            key.append(info);
+        key.append("\n");
+    }
 
-    if (!m_isBinary)
+    const cl_device_info device_info[] = {CL_DEVICE_VENDOR, CL_DEVICE_NAME, CL_DEVICE_VERSION, CL_DRIVER_VERSION};
+    for (size_t i = 0; i < sizeof(device_info) / sizeof(device_info[0]); i++)
     {
-        // Create the program.
-        m_program_encoder = clCreateProgramWithSource(m_context, 1, const_cast<char const**>(&p_program.buffer), &m_program_size, &result);
-        if (result != CL_SUCCESS)
-        {
-            PrintCL("Failed to create the program!\n");
-            PrintOCLError(result);
-            return false;
-        }
+        info[0] = 0;
+        if (clGetDeviceInfo(m_device_id, device_info[i], sizeof(info), info, NULL) == CL_SUCCESS)
+            key.append(info);
+        key.append("\n");
+    }
 
-        delete[] p_program.buffer;
-        p_program.buffer = NULL;
+    return key;
+}
 
-        // Build the program.
-        result = clBuildProgram(m_program_encoder, 1, &m_device_id, m_compile_options, NULL, NULL);
-        if (result != CL_SUCCESS)
-        {
-            char message[LOG_BUFFER_SIZE];
-            result = clGetProgramBuildInfo(m_program_encoder, m_device_id, CL_PROGRAM_BUILD_LOG, LOG_BUFFER_SIZE, message, NULL);
-            if (result != CL_SUCCESS)
-                message[0] = char(0);
-            //PrintCL("Failed to build the program!\n%s",message);
-            printf("Failed to build the program!\n%s", message);
-            return false;
-        }
+bool COpenCL::BuildProgramFromBinary(const std::vector<unsigned char>& binary)
+{
+    cl_int               result;
+    size_t               binary_size = binary.size();
+    const unsigned char* p_binary    = binary.data();
 
-        size_t compiled_size = 0;
-        result               = clGetProgramInfo(m_program_encoder, CL_PROGRAM_BINARY_SIZES, sizeof(compiled_size), &compiled_size, NULL);
+    // Create the program.
+    m_program_encoder = clCreateProgramWithBinary(m_context, 1, &m_device_id, &binary_size, &p_binary, NULL, &result);
+    if (result != CL_SUCCESS)
+    {
+        PrintCL("Failed to load the binary program!\n");
+        PrintOCLError(result);
+        m_program_encoder = NULL;
+        return false;
+    }
 
-        uint8_t* p_binary = new uint8_t[compiled_size];
-        result            = clGetProgramInfo(m_program_encoder, CL_PROGRAM_BINARIES, sizeof(p_binary), &p_binary, NULL);
+    // Build the program.
+    result = clBuildProgram(m_program_encoder, 1, &m_device_id, NULL, NULL, NULL);
+    if (result != CL_SUCCESS)
+    {
+        PrintCL("Failed to build the binary program!\n");
+        PrintOCLError(result);
+        clReleaseProgram(m_program_encoder);
+        m_program_encoder = NULL;
+        return false;
+    }
 
-        // Save the compiled code
-        FILE*   p_file       = NULL;
-        errno_t fopen_result = fopen_s(&p_file, m_source_file.append(".cmp").c_str(), "wb");
-        if (fopen_result == 0)
-        {
-            OpenCLBinary_Header BinFile_Header;
-            BinFile_Header.version = 1;
-            BinFile_Header.crc32   = 0;
-            fwrite(&BinFile_Header, sizeof(OpenCLBinary_Header), 1, p_file);
-            fwrite(p_binary, compiled_size, 1, p_file);
-        }
-        fclose(p_file);
+    return true;
+}
 
-    }  // not precompiled code
-    else
+bool COpenCL::BuildProgramFromSource()
+{
+    cl_int result;
+
+    // Create the program.
+    m_program_encoder = clCreateProgramWithSource(m_context, 1, const_cast<char const**>(&p_program.buffer), &m_program_size, &result);
+    if (result != CL_SUCCESS)
     {
-        // Create the program.
-        m_program_encoder = clCreateProgramWithBinary(m_context, 1, &m_device_id, &m_program_size, (const unsigned char**)&p_program.ubuffer, NULL, &result);
+        PrintCL("Failed to create the program!\n");
+        PrintOCLError(result);
+        m_program_encoder = NULL;
+        return false;
+    }
 
+    // Build the program.
+    result = clBuildProgram(m_program_encoder, 1, &m_device_id, m_compile_options, NULL, NULL);
+    if (result != CL_SUCCESS)
+    {
+        char message[LOG_BUFFER_SIZE];
+        result = clGetProgramBuildInfo(m_program_encoder, m_device_id, CL_PROGRAM_BUILD_LOG, LOG_BUFFER_SIZE, message, NULL);
         if (result != CL_SUCCESS)
-        {
-            PrintCL("Failed to load the binary program!\n");
-            PrintOCLError(result);
-            return false;
-        }
+            message[0] = char(0);
+        //PrintCL("Failed to build the program!\n%s",message);
+        printf("Failed to build the program!\n%s", message);
+        clReleaseProgram(m_program_encoder);
+        m_program_encoder = NULL;
+        return false;
+    }
 
-        delete[] p_program.buffer;
-        p_program.buffer = NULL;
+    // Save the compiled code, the program is still usable if this fails
+    size_t compiled_size = 0;
+    result               = clGetProgramInfo(m_program_encoder, CL_PROGRAM_BINARY_SIZES, sizeof(compiled_size), &compiled_size, NULL);
+    if ((result == CL_SUCCESS) && (compiled_size > 0))
+    {
+        std::vector<unsigned char> compiled(compiled_size);
+        unsigned char*             p_binary = compiled.data();
 
-        // Build the program.
-        result = clBuildProgram(m_program_encoder, 1, &m_device_id, NULL, NULL, NULL);
-        if (result != CL_SUCCESS)
-        {
-            PrintCL("Failed to build the program!\n");
-            PrintOCLError(result);
+        result = clGetProgramInfo(m_program_encoder, CL_PROGRAM_BINARIES, sizeof(p_binary), &p_binary, NULL);
+        if ((result != CL_SUCCESS) || !m_program_cache.Save(compiled.data(), compiled.size()))
+            PrintCL("Failed to save the program binary \"%s\"\n", m_program_cache.GetFileName().c_str());
+    }
 
-            char message[128 * 1024];
-            result = clGetProgramBuildInfo(m_program_encoder, m_device_id, CL_PROGRAM_BUILD_LOG, sizeof(message), message, NULL);
-            if (result == CL_SUCCESS)
-            {
-                PrintCL(message);
-            }
+    return true;
+}
 
-            return false;
+bool COpenCL::Create_Program_File()
+{
+    //------------------------------
+    // Load the Source file
+    //------------------------------
+    if (!load_file())
+        return false;
+
+    bool built = false;
+
+    //------------------------------
+    // Use the program binary that was built for this source, options and device if there is one
+    //------------------------------
+    m_program_cache.SetKey(m_source_file, std::string(p_program.buffer, m_program_size), m_compile_options, GetDeviceKey());
+
+    if (!m_force_rebuild)
+    {
+        std::vector<unsigned char> binary;
+        if (m_program_cache.Load(binary))
+        {
+            built = BuildProgramFromBinary(binary);
+            if (!built)
+                PrintCL("Rebuilding \"%s\" from source\n", m_source_file.c_str());
         }
     }
-    return true;
+
+    if (!built)
+        built = BuildProgramFromSource();
+
+    delete[] p_program.buffer;
+    p_program.buffer = NULL;
+
+    return built;
 }
 
 bool COpenCL::CreateProgramEncoder()
@@ -721,6 +775,26 @@ bool COpenCL::CreateProgramEncoder()
     return true;
 }
 
+bool COpenCL::ReserveBuffer(cl_mem& buffer, size_t& capacity, size_t size, cl_mem_flags flags)
+{
+    if (buffer && (capacity >= size))
+        return true;
+
+    if (buffer)
+        clReleaseMemObject(buffer);
+    capacity = 0;
+
+    buffer = clCreateBuffer(m_context, flags, size, NULL, &m_result);
+    if (m_result != CL_SUCCESS)
+    {
+        buffer = NULL;
+        return false;
+    }
+
+    capacity = size;
+    return true;
+}
+
 bool COpenCL::CreateIOBuffers()
 {
 #ifdef ENABLE_SVM
@@ -739,29 +813,30 @@ bool COpenCL::CreateIOBuffers()
     }
 #endif
 
-    // allocate device 32bit buffer for the image source
-    // idealy we want to not copy the buffer form host
-    // Look into the following options clmap  and CL_MEM_AMD_PERSISTANT
-    // Allocate the 32-bit source buffer in device memory.
+    // The buffers are only reallocated when a texture needs more space than any previous one
+    size_t source_size = m_source_buffer_size;
 
-    m_device_source_buffer = clCreateBuffer(m_context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, m_source_buffer_size, (void*)m_psource, &m_result);
-    if (m_result != CL_SUCCESS)
+    if (!ReserveBuffer(m_device_source_buffer, m_device_source_capacity, source_size, CL_MEM_READ_ONLY))
     {
         PrintCL("Failed to allocate the source buffer on the device!\n");
+        PrintOCLError(m_result);
         return false;
     }
 
-    m_Source_Info_buffer = clCreateBuffer(m_context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, sizeof(Source_Info), (void*)&m_SourceInfo, &m_result);
-    if (m_result != CL_SUCCESS)
+    if (!m_Source_Info_buffer)
     {
-        PrintCL("Failed to allocate the source info buffer on the device!\n");
-        PrintOCLError(m_result);
-        return false;
+        m_Source_Info_buffer = clCreateBuffer(m_context, CL_MEM_READ_ONLY, sizeof(Source_Info), NULL, &m_result);
+        if (m_result != CL_SUCCESS)
+        {
+            m_Source_Info_buffer = NULL;
+            PrintCL("Failed to allocate the source info buffer on the device!\n");
+            PrintOCLError(m_result);
+            return false;
+        }
     }
 
     // Allocate the destination buffer in device memory.
-    m_device_destination_buffer = clCreateBuffer(m_context, CL_MEM_WRITE_ONLY, m_destination_size, NULL, &m_result);
-    if (m_result != CL_SUCCESS)
+    if (!ReserveBuffer(m_device_destination_buffer, m_device_destination_capacity, m_destination_size, CL_MEM_WRITE_ONLY))
     {
         PrintCL("Failed to allocate the destination buffer on the device!\n");
         PrintOCLError(m_result);
@@ -777,21 +852,16 @@ bool COpenCL::RunKernel()
     //    QUERY_PERFORMANCE("Run Kernel      ");
 
     // Get a handle to the kernel.
-    m_kernel = clCreateKernel(m_program_encoder, "CMP_GPUEncoder", &m_result);
-    if (m_result != CL_SUCCESS)
-    {
-        PrintCL("Failed to create the kernel!\n");
-        PrintOCLError(m_result);
-        return false;
-    }
-
-    // Create the command queue. with profiling enabled
-    const cl_queue_properties properties[] = {CL_QUEUE_PROPERTIES, CL_QUEUE_PROFILING_ENABLE, 0};
-    m_command_queue                        = clCreateCommandQueueWithProperties(m_context, m_device_id, properties, &m_result);
-    if (m_result != CL_SUCCESS)
+    if (!m_kernel)
     {
-        PrintCL("Failed to create the command queue!\n");
-        return false;
+        m_kernel = clCreateKernel(m_program_encoder, "CMP_GPUEncoder", &m_result);
+        if (m_result != CL_SUCCESS)
+        {
+            m_kernel = NULL;
+            PrintCL("Failed to create the kernel!\n");
+            PrintOCLError(m_result);
+            return false;
+        }
     }
 
     //====================================================================================
@@ -823,13 +893,22 @@ bool COpenCL::RunKernel()
         return false;
     }
 
+    // The upload queue is in order, so the first band waits for these writes as well
+    m_result = clEnqueueWriteBuffer(m_upload_queue, m_Source_Info_buffer, CL_FALSE, 0, sizeof(Source_Info), (void*)&m_SourceInfo, 0, NULL, NULL);
+    if (m_result != CL_SUCCESS)
+    {
+        PrintCL("Failed to set the source info buffer!\n");
+        PrintOCLError(m_result);
+        return false;
+    }
+
 #ifdef ENABLE_SVM  // Don not enable unless CMP_GPUEncoder parameters are updated
     if (m_svmSupport)
     {
         if (m_svmData)
         {
             /* reserve svm space for CPU update */
-            m_result = clEnqueueSVMMap(m_command_queue,
+            m_result = clEnqueueSVMMap(m_upload_queue,
                                        CL_TRUE,  //blocking call
                                        CL_MAP_WRITE_INVALIDATE_REGION,
                                        m_svmData,
@@ -847,7 +926,7 @@ bool COpenCL::RunKernel()
                 return false;
             }
 
-            m_result = clEnqueueSVMUnmap(m_command_queue, m_svmData, 0, NULL, NULL);
+            m_result = clEnqueueSVMUnmap(m_upload_queue, m_svmData, 0, NULL, NULL);
 
             // Set appropriate arguments to the kernel
             m_result = clSetKernelArgSVMPointer(m_kernel, KERNEL_ARG_ENCODE, (void*)(m_svmData));
@@ -868,7 +947,12 @@ bool COpenCL::RunKernel()
     else
 #endif
     {
-        m_Encoder_buffer = clCreateBuffer(m_context, CL_MEM_READ_WRITE, m_kernel_options->size, NULL, &m_result);
+        if (!ReserveBuffer(m_Encoder_buffer, m_encoder_buffer_capacity, m_kernel_options->size, CL_MEM_READ_WRITE))
+        {
+            PrintCL("Failed to allocate the Encode block buffer on the device!\n");
+            PrintOCLError(m_result);
+            return false;
+        }
 
         // Set argument for the compress()
         m_result = clSetKernelArg(m_kernel, KERNEL_ARG_ENCODE, sizeof(m_Encoder_buffer), (void*)&m_Encoder_buffer);
@@ -882,7 +966,7 @@ bool COpenCL::RunKernel()
         // CMP_BC15Options *temp = reinterpret_cast<CMP_BC15Options *>(m_kernel_options->data);
         // int blocksize = sizeof(CMP_BC15Options);
 
-        m_result = clEnqueueWriteBuffer(m_command_queue, m_Encoder_buffer, CL_TRUE, 0, m_kernel_options->size, (void*)m_kernel_options->data, 0, NULL, NULL);
+        m_result = clEnqueueWriteBuffer(m_upload_queue, m_Encoder_buffer, CL_FALSE, 0, m_kernel_options->size, (void*)m_kernel_options->data, 0, NULL, NULL);
         if (m_result != CL_SUCCESS)
         {
             PrintCL("Failed to set the Encode block buffer!\n");
@@ -920,77 +1004,149 @@ bool COpenCL::RunKernel()
         global_work_size[1] = m_height_in_blocks;
     }
 
+    //----------------------------------
+    // Split the texture into bands of block rows. Each band is uploaded, compressed and read back with its own
+    // commands chained by events, so the upload of a band overlaps the compression of the previous one, which
+    // overlaps the readback of the one before it. The kernels work on whole texture buffers and find their blocks
+    // from the global id, so a band is just a global work offset. This needs both buffers to be made of equal
+    // sized rows, otherwise the texture is processed as a single band, as are small textures.
+    //----------------------------------
+    size_t source_height   = m_SourceInfo.m_src_height;
+    size_t num_blocks      = (size_t)m_width_in_blocks * m_height_in_blocks;
+    size_t source_row      = (source_height > 0) ? m_source_buffer_size / source_height : 0;
+    size_t block_size      = (num_blocks > 0) ? m_destination_size / num_blocks : 0;
+    size_t destination_row = block_size * m_width_in_blocks;
+
+    size_t band_rows = global_work_size[1];
+    if ((m_height_in_blocks >= 2 * local_work_size[1]) && (local_work_size[1] > 1) && (source_row * source_height == m_source_buffer_size) &&
+        (block_size * num_blocks == m_destination_size) && (source_height >= 4 * m_height_in_blocks))
+    {
+        size_t band_groups = (global_work_size[1] / local_work_size[1] + MAX_KERNEL_BANDS - 1) / MAX_KERNEL_BANDS;
+        band_rows          = band_groups * local_work_size[1];
+    }
+
 #ifdef USE_CPU_PERFORMANCE_COUNTERS
     cpu_timer cputimer;
     cputimer.Start(0);
-#else
-    cl_event cl_perf_event = NULL;
 #endif
 
-    m_result = clEnqueueNDRangeKernel(m_command_queue,
-                                      m_kernel,
-                                      2,
-                                      NULL,
-                                      global_work_size,
-                                      local_work_size,
-                                      0,
-                                      NULL,
-#ifdef USE_CPU_PERFORMANCE_COUNTERS
-                                      NULL
-#else
-                                      m_getPerfStats ? &cl_perf_event : NULL
-#endif
-    );
-
-    if (m_result != CL_SUCCESS)
+    for (size_t band_start = 0; band_start < global_work_size[1]; band_start += band_rows)
     {
-        PrintCL("Failed to launch the kernel!\n");
-        PrintOCLError(m_result);
-        return false;
+        size_t band_end = (band_start + band_rows < global_work_size[1]) ? band_start + band_rows : global_work_size[1];
+        bool   is_first = band_start == 0;
+        bool   is_last  = band_end == global_work_size[1];
+
+        // Source rows used by the blocks of the band
+        size_t source_offset = is_first ? 0 : band_start * 4 * source_row;
+        size_t source_end    = is_last ? m_source_buffer_size : band_end * 4 * source_row;
+
+        cl_event write_event = NULL;
+        m_result             = clEnqueueWriteBuffer(m_upload_queue,
+                                                    m_device_source_buffer,
+                                                    CL_FALSE,
+                                                    source_offset,
+                                                    source_end - source_offset,
+                                                    (CMP_BYTE*)m_psource + source_offset,
+                                                    0,
+                                                    NULL,
+                                                    &write_event);
+        if (m_result != CL_SUCCESS)
+        {
+            PrintCL("Failed to copy the source to the device!\n");
+            PrintOCLError(m_result);
+            return false;
+        }
+
+        size_t   band_offset[]    = {0, band_start};
+        size_t   band_work_size[] = {global_work_size[0], band_end - band_start};
+        cl_event kernel_event     = NULL;
+        m_result                  = clEnqueueNDRangeKernel(m_command_queue, m_kernel, 2, band_offset, band_work_size, local_work_size, 1, &write_event, &kernel_event);
+        clReleaseEvent(write_event);
+        if (m_result != CL_SUCCESS)
+        {
+            PrintCL("Failed to launch the kernel!\n");
+            PrintOCLError(m_result);
+            return false;
+        }
+        m_kernel_events.push_back(kernel_event);
+
+        // Compressed blocks of the band
+        size_t destination_offset = is_first ? 0 : band_start * destination_row;
+        size_t destination_end    = is_last ? m_destination_size : band_end * destination_row;
+
+        cl_event read_event = NULL;
+        m_result            = clEnqueueReadBuffer(m_download_queue,
+                                                   m_device_destination_buffer,
+                                                   CL_FALSE,
+                                                   destination_offset,
+                                                   destination_end - destination_offset,
+                                                   p_destination + destination_offset,
+                                                   1,
+                                                   &kernel_event,
+                                                   &read_event);
+        if (m_result != CL_SUCCESS)
+        {
+            PrintCL("Failed to copy the results from the device!\n");
+            PrintOCLError(m_result);
+            return false;
+        }
+        m_read_events.push_back(read_event);
     }
 
-    // Wait until all queued commands have been processed and completed.
-    if (m_getPerfStats)
-        m_result = clFinish(m_command_queue);
+    // Start the queued work on the device
+    clFlush(m_upload_queue);
+    clFlush(m_command_queue);
+    clFlush(m_download_queue);
 
 #ifdef USE_CPU_PERFORMANCE_COUNTERS
+    // Wait until all queued kernels have been processed and completed.
+    if (m_getPerfStats)
+        clFinish(m_command_queue);
     cputimer.Stop(0);
     m_computeShaderElapsedMS = cputimer.GetTimeMS(0);
 #endif
 
-    // Check if performance event has been set and valid
-    if (m_getPerfStats &&
-#ifdef USE_CPU_PERFORMANCE_COUNTERS
-        (m_computeShaderElapsedMS > 0) &&
-#else
-        cl_perf_event &&
-#endif
-        (m_result == CL_SUCCESS))
+    return true;
+}
+
+bool COpenCL::GetResults()
+{
+    //    QUERY_PERFORMANCE("Get Results     ");
+
+    // Wait for the results of all bands to be copied to host memory.
+    m_result = m_read_events.empty() ? CL_SUCCESS : clWaitForEvents((cl_uint)m_read_events.size(), m_read_events.data());
+
+    if (m_result != CL_SUCCESS)
     {
-#ifdef USE_CPU_PERFORMANCE_COUNTERS
-#else
-        // Get the event data
-        cl_ulong start      = 0;
-        cl_ulong end        = 0;
-        cl_ulong nspercount = 1;
+        PrintCL("Failed to copy the results from the device!\n");
+        PrintOCLError(m_result);
+        ReleaseEvents();
+        return false;
+    }
 
-        m_result = clGetEventProfilingInfo(cl_perf_event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL);
+#ifndef USE_CPU_PERFORMANCE_COUNTERS
+    if (m_getPerfStats)
+    {
+        // Get the event data, the kernel time is the sum of the time taken by each band
+        cl_ulong kernel_time = 0;
+        for (size_t i = 0; (i < m_kernel_events.size()) && (m_result == CL_SUCCESS); i++)
+        {
+            cl_ulong start = 0;
+            cl_ulong end   = 0;
 
-        if (m_result == CL_SUCCESS)
-            m_result = clGetEventProfilingInfo(cl_perf_event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL);
+            m_result = clGetEventProfilingInfo(m_kernel_events[i], CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, NULL);
 
-        // Get the number of nanoseconds per count
-        cl_ulong resolution;
-        if (m_result == CL_SUCCESS)
-            m_result = clGetDeviceInfo(m_device_id, CL_DEVICE_PROFILING_TIMER_RESOLUTION, sizeof(cl_ulong), &resolution, NULL);
+            if (m_result == CL_SUCCESS)
+                m_result = clGetEventProfilingInfo(m_kernel_events[i], CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, NULL);
 
-        if (m_result == CL_SUCCESS)
-            m_result = clReleaseEvent(cl_perf_event);
+            kernel_time += end - start;
+        }
 
         if (m_result != CL_SUCCESS)
         {
-            PrintCL("Failed clReleaseEvent!\n");
+            PrintCL("Failed clGetEventProfilingInfo!\n");
             PrintOCLError(m_result);
+            ReleaseEvents();
             return false;
         }
 
@@ -998,12 +1154,16 @@ bool COpenCL::RunKernel()
         m_num_blocks = m_height_in_blocks * m_width_in_blocks;
         if (m_num_blocks == 0)
             m_num_blocks = 1;
-        float nanoSeconds = (float)(end - start);
+        float nanoSeconds = (float)kernel_time;
         // Convert nanosec to ms divide by 1e6f
         m_computeShaderElapsedMS = nanoSeconds / 1e6f;
         // time to process a single block (4x4) which is 16 texels
         m_computeShaderElapsedMS = m_computeShaderElapsedMS / (float)m_num_blocks;
+    }
 #endif
+
+    if (m_getPerfStats)
+    {
         if (m_computeShaderElapsedMS > 0)
         {
             float ElapsedSeconds      = m_computeShaderElapsedMS / 1E3f;
@@ -1016,22 +1176,7 @@ bool COpenCL::RunKernel()
             m_CmpMTxPerSec = 0;
     }
 
-    return true;
-}
-
-bool COpenCL::GetResults()
-{
-    //    QUERY_PERFORMANCE("Get Results     ");
-
-    // Copy the results from device to host memory.
-    m_result = clEnqueueReadBuffer(m_command_queue, m_device_destination_buffer, true, 0, m_destination_size, p_destination, 0, NULL, NULL);
-
-    if (m_result != CL_SUCCESS)
-    {
-        PrintCL("Failed to copy the results from the device!\n");
-        PrintOCLError(m_result);
-        return false;
-    }
+    ReleaseEvents();
 
     return true;
 }
@@ -1133,17 +1278,15 @@ CMP_ERROR COpenCL::Compress(KernelOptions* KernelOptions, MipSet& srcTexture, Mi
             ok = false;
         if (ok && (CreateContext() == false))
             ok = false;
+        if (ok && (CreateCommandQueues() == false))
+            ok = false;
         m_initDeviceOk = ok;
     }
-    if (m_programRun)
-    {
-        CleanUpKernelAndIOBuffers();
-        if (newFormat)
-            CleanUpProgramEncoder();
-        m_programRun = false;
-    }
+
+    // The command queues and device buffers are kept for the next texture, only the program changes with the format
     if (newFormat)
     {
+        CleanUpProgramEncoder();
         if (ok && (CreateProgramEncoder() == false))
             ok = false;
     }
@@ -1155,10 +1298,16 @@ CMP_ERROR COpenCL::Compress(KernelOptions* KernelOptions, MipSet& srcTexture, Mi
         ok = false;
 
     if (ok)
-    {
-        m_programRun = true;
         return CMP_OK;
-    }
+
+    // Make sure no work is left using the buffers or the destination texture
+    if (m_upload_queue)
+        clFinish(m_upload_queue);
+    if (m_command_queue)
+        clFinish(m_command_queue);
+    if (m_download_queue)
+        clFinish(m_download_queue);
+    ReleaseEvents();
 
     return (CMP_ERR_GENERIC);
 }
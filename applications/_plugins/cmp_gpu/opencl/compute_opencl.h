@@ -26,7 +26,7 @@
 
 #define __CL_ENABLE_EXCEPTIONS
 
-#include <cl/opencl.h>
+#include <CL/opencl.h>
 
 #include "common_def.h"  // Updated at run time by COpenCL
 
@@ -36,20 +36,14 @@
 #include "textureio.h"
 #include "crc32.h"
 #include "cmp_math_common.h"
+#include "compute_opencl_cache.h"
 
 #define MAX_PLATFORMS 4
 
 using namespace CMP_Compute_Base;
 
 #define NUM_THREADS 1  // Number of threads per work group.(can have upto 64 Threads)
-// #define USE_CRC32                        // Use source file checking first to update .cmp files at run time. (slows compute loading time)
-// Disable this definition to use .cmp files first and then try src if not found
-
-struct OpenCLBinary_Header
-{
-    unsigned int version;
-    long         crc32;
-};
+#define MAX_KERNEL_BANDS 8  // Number of bands of block rows a texture is split into, so that uploads, compute and readback overlap
 
 class COpenCL : public ComputeBase
 {
@@ -68,7 +62,6 @@ public:
 
 private:
     bool       m_initDeviceOk;
-    bool       m_programRun;
     CMP_FORMAT m_codecFormat;
 
     // Performance Info
@@ -97,9 +90,20 @@ private:
     cl_mem           m_device_destination_buffer;
     cl_mem           m_Source_Info_buffer;
     cl_mem           m_Encoder_buffer;
-    cl_command_queue m_command_queue;
+    cl_command_queue m_command_queue;   // kernels
+    cl_command_queue m_upload_queue;    // host to device transfers
+    cl_command_queue m_download_queue;  // device to host transfers
     size_t           m_destination_size;
     size_t           m_source_buffer_size;
+
+    // The device buffers are kept between textures and only grow
+    size_t m_device_source_capacity;
+    size_t m_device_destination_capacity;
+    size_t m_encoder_buffer_capacity;
+
+    // Events of the work enqueued by RunKernel, waited for in GetResults
+    std::vector<cl_event> m_kernel_events;
+    std::vector<cl_event> m_read_events;
     cl_uint          m_width_in_blocks;
     cl_uint          m_height_in_blocks;
 
@@ -123,13 +127,15 @@ private:
         unsigned char* ubuffer;
     } p_program;
 
-    size_t m_program_size;
-    bool   m_isBinary;
-    long   m_sourcefile_CRC32;
-    float  ocl_time_device = 0;
+    size_t             m_program_size;
+    OpenCLProgramCache m_program_cache;
+    float              ocl_time_device = 0;
 
-    long file_size(FILE* p_file);
-    bool load_file();
+    long        file_size(FILE* p_file);
+    bool        load_file();
+    std::string GetDeviceKey();
+    bool        BuildProgramFromBinary(const std::vector<unsigned char>& binary);
+    bool        BuildProgramFromSource();
 
     // Need to fill these
     CMP_BYTE*   p_destination;
@@ -139,6 +145,8 @@ private:
     bool        SearchForGPU();
     bool        GetDeviceInfo();
     bool        CreateContext();
+    bool        CreateCommandQueues();
+    bool        ReserveBuffer(cl_mem& buffer, size_t& capacity, size_t size, cl_mem_flags flags);
     bool        Create_Program_File();
     bool        CreateProgramEncoder();
     bool        CreateIOBuffers();
@@ -147,6 +155,7 @@ private:
 
     void CleanUpProgramEncoder();
     void CleanUpKernelAndIOBuffers();
+    void ReleaseEvents();
 };
 
 #endif
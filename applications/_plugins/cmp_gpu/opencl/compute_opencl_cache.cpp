@@ -0,0 +1,275 @@
+//=====================================================================
+// Copyright (c) 2024    Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include "compute_opencl_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <set>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#define CACHE_GETPID _getpid
+#else
+#include <unistd.h>
+#define CACHE_GETPID getpid
+#endif
+
+#define FNV1A_64_INIT 14695981039346656037ULL
+#define FNV1A_64_PRIME 1099511628211ULL
+
+// 64 bit FNV-1a hash of a buffer, continuing from hash
+static unsigned long long HashBytes(unsigned long long hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV1A_64_PRIME;
+    }
+    return hash;
+}
+
+// Hashes the size before the content, so that consecutive fields cannot run into each other
+static unsigned long long HashString(unsigned long long hash, const std::string& str)
+{
+    unsigned long long size = str.size();
+    hash                    = HashBytes(hash, &size, sizeof(size));
+    return HashBytes(hash, str.data(), str.size());
+}
+
+static bool ReadTextFile(const std::string& fileName, std::string& content)
+{
+    FILE* pFile = fopen(fileName.c_str(), "rb");
+    if (!pFile)
+        return false;
+
+    content.clear();
+    char   buffer[64 * 1024];
+    size_t bytesRead;
+    while ((bytesRead = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+        content.append(buffer, bytesRead);
+
+    bool ok = ferror(pFile) == 0;
+    fclose(pFile);
+    return ok;
+}
+
+static std::string GetDirectory(const std::string& fileName)
+{
+    size_t pos = fileName.find_last_of("/\\");
+    if (pos == std::string::npos)
+        return ".";
+    return fileName.substr(0, pos);
+}
+
+// Include folders given to the OpenCL compiler with "-I dir" or "-Idir"
+static std::vector<std::string> GetIncludeDirectories(const std::string& compileOptions)
+{
+    std::vector<std::string> tokens;
+    size_t                   pos = 0;
+    while (pos < compileOptions.size())
+    {
+        size_t start = compileOptions.find_first_not_of(" \t", pos);
+        if (start == std::string::npos)
+            break;
+        size_t end = compileOptions.find_first_of(" \t", start);
+        if (end == std::string::npos)
+            end = compileOptions.size();
+        tokens.push_back(compileOptions.substr(start, end - start));
+        pos = end;
+    }
+
+    std::vector<std::string> directories;
+    for (size_t i = 0; i < tokens.size(); i++)
+    {
+        if (tokens[i] == "-I" && i + 1 < tokens.size())
+            directories.push_back(tokens[++i]);
+        else if (tokens[i].compare(0, 2, "-I") == 0 && tokens[i].size() > 2)
+            directories.push_back(tokens[i].substr(2));
+    }
+    return directories;
+}
+
+// Hashes source and the content of the files it includes with #include "...", recursively.
+// Includes that cannot be found are skipped, as are system includes.
+static unsigned long long HashSource(unsigned long long              hash,
+                                     const std::string&              fileName,
+                                     const std::string&              source,
+                                     const std::vector<std::string>& includeDirectories,
+                                     std::set<std::string>&          visited)
+{
+    hash = HashString(hash, source);
+
+    size_t lineStart = 0;
+    while (lineStart < source.size())
+    {
+        size_t lineEnd = source.find('\n', lineStart);
+        if (lineEnd == std::string::npos)
+            lineEnd = source.size();
+
+        size_t pos = source.find_first_not_of(" \t", lineStart);
+        if (pos < lineEnd && source[pos] == '#')
+        {
+            pos = source.find_first_not_of(" \t", pos + 1);
+            if (pos < lineEnd && source.compare(pos, 7, "include") == 0)
+            {
+                size_t nameStart = source.find('"', pos + 7);
+                size_t nameEnd   = nameStart < lineEnd ? source.find('"', nameStart + 1) : std::string::npos;
+                if (nameEnd < lineEnd)
+                {
+                    std::string includeName = source.substr(nameStart + 1, nameEnd - nameStart - 1);
+
+                    std::vector<std::string> searchPaths(1, GetDirectory(fileName));
+                    searchPaths.insert(searchPaths.end(), includeDirectories.begin(), includeDirectories.end());
+
+                    for (size_t i = 0; i < searchPaths.size(); i++)
+                    {
+                        std::string includeFile = searchPaths[i] + "/" + includeName;
+                        std::string includeSource;
+                        if (ReadTextFile(includeFile, includeSource))
+                        {
+                            if (visited.insert(includeFile).second)
+                            {
+                                hash = HashString(hash, includeName);
+                                hash = HashSource(hash, includeFile, includeSource, includeDirectories, visited);
+                            }
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        lineStart = lineEnd + 1;
+    }
+
+    return hash;
+}
+
+OpenCLProgramCache::OpenCLProgramCache()
+{
+    m_key = 0;
+}
+
+void OpenCLProgramCache::SetKey(const std::string& sourceFile, const std::string& source, const std::string& compileOptions, const std::string& deviceInfo)
+{
+    std::set<std::string> visited;
+    unsigned int          version = OPENCL_BINARY_CACHE_VERSION;
+
+    unsigned long long key = FNV1A_64_INIT;
+    key                    = HashBytes(key, &version, sizeof(version));
+    key                    = HashString(key, compileOptions);
+    key                    = HashString(key, deviceInfo);
+    key                    = HashSource(key, sourceFile, source, GetIncludeDirectories(compileOptions), visited);
+    m_key                  = key;
+
+    char keyName[32];
+    snprintf(keyName, sizeof(keyName), ".%016llx.cmp", m_key);
+
+    const char* cacheDirectory = getenv("CMP_OPENCL_CACHE_DIR");
+    if (cacheDirectory && cacheDirectory[0])
+    {
+        size_t pos = sourceFile.find_last_of("/\\");
+        m_fileName = std::string(cacheDirectory) + "/" + (pos == std::string::npos ? sourceFile : sourceFile.substr(pos + 1));
+    }
+    else
+        m_fileName = sourceFile;
+    m_fileName.append(keyName);
+}
+
+bool OpenCLProgramCache::Load(std::vector<unsigned char>& binary) const
+{
+    if (m_fileName.empty())
+        return false;
+
+    FILE* pFile = fopen(m_fileName.c_str(), "rb");
+    if (!pFile)
+        return false;
+
+    // The size in the header is only trusted if the file holds exactly that many bytes after it
+    long fileSize = -1;
+    if (fseek(pFile, 0, SEEK_END) == 0)
+        fileSize = ftell(pFile);
+    rewind(pFile);
+
+    OpenCLBinary_Header header;
+    bool                ok = (fileSize >= (long)sizeof(header)) && (fread(&header, sizeof(header), 1, pFile) == 1);
+    ok                     = ok && (header.version == OPENCL_BINARY_CACHE_VERSION) && (header.key == m_key) && (header.size > 0);
+    ok                     = ok && (header.size == (unsigned long long)(fileSize - (long)sizeof(header)));
+
+    if (ok)
+    {
+        binary.resize((size_t)header.size);
+        ok = fread(binary.data(), binary.size(), 1, pFile) == 1;
+        // the file must end with the binary
+        ok = ok && (fgetc(pFile) == EOF);
+    }
+    fclose(pFile);
+
+    ok = ok && (HashBytes(FNV1A_64_INIT, binary.data(), binary.size()) == header.hash);
+    if (!ok)
+        binary.clear();
+
+    return ok;
+}
+
+bool OpenCLProgramCache::Save(const unsigned char* binary, size_t size) const
+{
+    if (m_fileName.empty() || !binary || size == 0)
+        return false;
+
+    // Unique per process and per save, so that concurrent writers never share a temporary file
+    static std::atomic<unsigned int> saveCount(0);
+    char                             tempName[64];
+    snprintf(tempName, sizeof(tempName), ".%d.%u.tmp", (int)CACHE_GETPID(), saveCount++);
+    std::string tempFileName = m_fileName + tempName;
+
+    FILE* pFile = fopen(tempFileName.c_str(), "wb");
+    if (!pFile)
+        return false;
+
+    OpenCLBinary_Header header;
+    header.version  = OPENCL_BINARY_CACHE_VERSION;
+    header.reserved = 0;
+    header.key      = m_key;
+    header.size     = size;
+    header.hash     = HashBytes(FNV1A_64_INIT, binary, size);
+
+    bool ok = fwrite(&header, sizeof(header), 1, pFile) == 1;
+    ok      = ok && (fwrite(binary, size, 1, pFile) == 1);
+    ok      = (fclose(pFile) == 0) && ok;
+
+#ifdef _WIN32
+    ok = ok && MoveFileExA(tempFileName.c_str(), m_fileName.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else
+    ok = ok && (rename(tempFileName.c_str(), m_fileName.c_str()) == 0);
+#endif
+
+    if (!ok)
+        remove(tempFileName.c_str());
+
+    return ok;
+}
@@ -0,0 +1,78 @@
+//=====================================================================
+// Copyright (c) 2024    Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#ifndef H_COMPUTE_OPENCL_CACHE
+#define H_COMPUTE_OPENCL_CACHE
+
+#include <string>
+#include <vector>
+
+#define OPENCL_BINARY_CACHE_VERSION 2
+
+// Header of a cached program binary (.cmp file), followed by the binary itself
+struct OpenCLBinary_Header
+{
+    unsigned int       version;   // OPENCL_BINARY_CACHE_VERSION, must stay the first member
+    unsigned int       reserved;  // 0
+    unsigned long long key;       // OpenCLProgramCache key the binary was built for
+    unsigned long long size;      // size of the binary in bytes
+    unsigned long long hash;      // hash of the binary
+};
+
+// On disk cache of compiled OpenCL programs.
+//
+// Each entry is stored in its own <source>.<key>.cmp file, where the key is a hash of the kernel source, of the files
+// it includes, of the compile options and of the platform, device and driver that built it. Changing any of them
+// selects a different file, so a binary is never loaded on a device or driver it was not built for.
+// Files are written to a temporary file and renamed into place, so concurrent jobs never see a partial file, and
+// the header and content of a file are validated before the binary is returned.
+//
+// The cache files are written next to the kernel source, or to the directory set by the CMP_OPENCL_CACHE_DIR
+// environment variable when the source folder is not writable.
+class OpenCLProgramCache
+{
+public:
+    OpenCLProgramCache();
+
+    // Sets the key of the program built from source (the content of sourceFile) with compileOptions on the device
+    // described by deviceInfo. Files included by the source are found relative to the source and to the -I folders
+    // of the compile options.
+    void SetKey(const std::string& sourceFile, const std::string& source, const std::string& compileOptions, const std::string& deviceInfo);
+
+    // Loads the cached binary for the current key, returns false if there is none or it is not valid
+    bool Load(std::vector<unsigned char>& binary) const;
+
+    // Saves the binary for the current key, replacing any previous file
+    bool Save(const unsigned char* binary, size_t size) const;
+
+    const std::string& GetFileName() const
+    {
+        return m_fileName;
+    }
+
+private:
+    unsigned long long m_key;
+    std::string        m_fileName;
+};
+
+#endif
@@ -45,7 +45,9 @@ void* make_Plugin_Compute_OpenCL()
 }
 #endif
 
+#ifdef _WIN32
 #pragma comment(lib, "advapi32.lib")  // for RegCloseKey and other Reg calls ...
+#endif
 
 Plugin_COpenCL::Plugin_COpenCL()
 {
@@ -27,15 +27,21 @@
 #pragma once
 
 #include <assert.h>
+#ifdef _WIN32
 #include <tchar.h>
+#endif
 #include "compressonator.h"
 #include "common.h"
 #include "compute_base.h"
-#include "Compute_OpenCL.h"
+#include "compute_opencl.h"
 #include "cmp_plugininterface.h"
 
 // {D88C7EB3-38D3-4B75-BE14-22ED445156FE}
+#ifdef _WIN32
 static const GUID g_GUID_GPU = {0xd88c7eb3, 0x38d3, 0x4b75, {0xbe, 0x14, 0x22, 0xed, 0x44, 0x51, 0x56, 0xfe}};
+#else
+static const GUID g_GUID_GPU = {0};
+#endif
 
 #define TC_PLUGIN_VERSION_MAJOR 1
 #define TC_PLUGIN_VERSION_MINOR 0
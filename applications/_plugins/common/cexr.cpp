@@ -57,7 +57,7 @@ float half_conv_float(unsigned short in)
     return u.f;
 }
 
-void Exr::fileinfo(const string inf, int& width, int& height)
+void Exr::fileinfo(const std::string inf, int& width, int& height)
 {
     RgbaInputFile file(inf.c_str());
     Box2i         dw = file.dataWindow();
@@ -66,7 +66,7 @@ void Exr::fileinfo(const string inf, int& width, int& height)
     height = dw.max.y - dw.min.y + 1;
 }
 
-void Exr::readRgba(const string inf, Array2D<Rgba>& pix, int& w, int& h)
+void Exr::readRgba(const std::string inf, Array2D<Rgba>& pix, int& w, int& h)
 {
     RgbaInputFile file(inf.c_str());
     Box2i         dw = file.dataWindow();
@@ -77,7 +77,7 @@ void Exr::readRgba(const string inf, Array2D<Rgba>& pix, int& w, int& h)
     file.readPixels(dw.min.y, dw.max.y);
 }
 
-void Exr::writeRgba(const string outf, const Array2D<Rgba>& pix, int w, int h)
+void Exr::writeRgba(const std::string outf, const Array2D<Rgba>& pix, int w, int h)
 {
     RgbaOutputFile file(outf.c_str(), w, h, WRITE_RGBA);
     file.setFrameBuffer(&pix[0][0], 1, w);
@@ -39,6 +39,7 @@
 #pragma warning(pop)
 
 #include <string.h>
+#include <string>
 
 #include "common.h"
 #include "compressonator.h"
@@ -57,9 +58,9 @@ public:
     Exr(){};
     ~Exr(){};
 
-    static void fileinfo(const string inf, int& width, int& height);
-    static void readRgba(const string inf, Array2D<Rgba>& pix, int& w, int& h);
-    static void writeRgba(const string outf, const Array2D<Rgba>& pix, int w, int h);
+    static void fileinfo(const std::string inf, int& width, int& height);
+    static void readRgba(const std::string inf, Array2D<Rgba>& pix, int& w, int& h);
+    static void writeRgba(const std::string outf, const Array2D<Rgba>& pix, int w, int h);
 };
 
 extern void  Rgba2Texture(Array2D<Rgba>& pixels, CMP_HALFSHORT* data, int w, int h);
@@ -28,8 +28,17 @@
 #include "cmdline.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #ifndef _WIN32
 #include <fcntl.h> /* For O_RDWR */
@@ -61,6 +70,7 @@
 #include "version.h"
 #include "misc.h"
 #include "cmp_fileio.h"
+#include "cmp_profiler.h"
 
 #ifdef USE_MESH_CLI
 #include <gltf/tiny_gltf2.h>
@@ -175,9 +185,16 @@ static inline bool IsFileDRC(const std::string& sourceFile)
     return sourceExt.compare(".DRC") == 0;
 }
 
+static inline bool IsFileCMSH(const std::string& sourceFile)
+{
+    std::string sourceExt = CMP_GetJustFileExt(sourceFile);
+    ToUpperCase(sourceExt);
+    return sourceExt.compare(".CMSH") == 0;
+}
+
 static inline bool IsFileModel(const std::string& sourceFile)
 {
-    return IsFileGLTF(sourceFile) || IsFileOBJ(sourceFile) || IsFileDRC(sourceFile);
+    return IsFileGLTF(sourceFile) || IsFileOBJ(sourceFile) || IsFileDRC(sourceFile) || IsFileCMSH(sourceFile);
 }
 
 static inline bool IsFormatBCN(CMP_FORMAT format)
@@ -251,6 +268,11 @@ static bool ProcessSingleFlags(const char* strCommand)
         isSet                       = true;
     }
 #endif
+    else if ((strcmp(strCommand, "-meshoptcodec") == 0))
+    {
+        g_CmdPrams.use_Meshopt_Codec = true;
+        isSet                        = true;
+    }
     else if ((strcmp(strCommand, "-silent") == 0))
     {
         g_CmdPrams.silent = true;
@@ -297,6 +319,11 @@ static bool ProcessSingleFlags(const char* strCommand)
         g_CmdPrams.doMeshOptimize = true;
         isSet                     = true;
     }
+    else if ((strcmp(strCommand, "-shareMeshLODVertices") == 0))
+    {
+        g_CmdPrams.shareMeshLODVertices = true;
+        isSet                           = true;
+    }
 #endif
     else if (strcmp(strCommand, "-compress-gltf-images") == 0)
     {
@@ -363,6 +390,16 @@ static bool ProcessSingleFlags(const char* strCommand)
         g_CmdPrams.CompressOptions.doDeltaEncodeBRLG = true;
         isSet                                        = true;
     }
+    else if (strcmp(strCommand, "-TGARLE") == 0)
+    {
+        g_CmdPrams.FileSaveParams.append(" RLE");
+        isSet = true;
+    }
+    else if (strcmp(strCommand, "-Profile") == 0)
+    {
+        g_CmdPrams.profile = true;
+        isSet              = true;
+    }
 
     return isSet;
 }
@@ -676,6 +713,20 @@ static bool ProcessCMDLineOptions(const char* strCommand, const char* strParamet
             }
             g_CmdPrams.CompressOptions.iSimplifyLOD = value;
         }
+        else if (strcmp(strCommand, "-generateMeshLODs") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No LOD (Level of Details) count specified for mesh LOD generation.";
+            }
+
+            int value = std::stoi(strParameter);
+            if (value < 2)
+            {
+                throw "LOD (Level of Details) count for mesh LOD generation should be > 1.";
+            }
+            g_CmdPrams.nMeshLODs = value;
+        }
         else if (strcmp(strCommand, "-optVFetch") == 0)
         {
             if (strlen(strParameter) == 0)
@@ -978,6 +1029,91 @@ static bool ProcessCMDLineOptions(const char* strCommand, const char* strParamet
 
             g_CmdPrams.CompressOptions.NumCmds++;
         }
+        else if (strcmp(strCommand, "-KTX2Zstd") == 0)
+        {
+            if (strlen(strParameter) == 0)
+                throw "Zstandard supercompression level not specified.";
+
+            int level = std::stoi(strParameter);
+            if ((level < 0) || (level > 22))
+                throw "Zstandard supercompression level must be in the range 0 to 22.";
+
+            g_CmdPrams.CompressOptions.nKTX2ZstdLevel = level;
+        }
+        else if (strcmp(strCommand, "-RDOLambda") == 0)
+        {
+            if (strlen(strParameter) == 0)
+                throw "RDO lambda not specified.";
+
+            float lambda = std::stof(strParameter);
+            if (lambda < 0.0f)
+                throw "RDO lambda must be 0 or more.";
+
+            g_CmdPrams.CompressOptions.fRDOLambda = lambda;
+        }
+        else if (strcmp(strCommand, "-RDOMaxError") == 0)
+        {
+            if (strlen(strParameter) == 0)
+                throw "RDO maximum error increase not specified.";
+
+            float maxError = std::stof(strParameter);
+            if (maxError <= 0.0f)
+                throw "RDO maximum error increase must be more than 0.";
+
+            g_CmdPrams.CompressOptions.fRDOMaxErrorIncrease = maxError;
+        }
+        else if (strcmp(strCommand, "-Pipeline") == 0)
+        {
+            if (strlen(strParameter) == 0)
+                throw "Pipeline depth not specified.";
+
+            int depth = std::stoi(strParameter);
+            if (depth < 0)
+                throw "Pipeline depth must be 0 or more.";
+
+            g_CmdPrams.pipelineDepth = depth;
+        }
+        else if (strcmp(strCommand, "-ProfileTrace") == 0)
+        {
+            if (strlen(strParameter) == 0)
+                throw "Profile trace file not specified.";
+
+            g_CmdPrams.profileTraceFile = strParameter;
+        }
+        else if (strcmp(strCommand, "-PipelineMemory") == 0)
+        {
+            if (strlen(strParameter) == 0)
+                throw "Pipeline memory limit not specified.";
+
+            int memoryMB = std::stoi(strParameter);
+            if (memoryMB < 1)
+                throw "Pipeline memory limit must be at least 1 MB.";
+
+            g_CmdPrams.pipelineMemoryMB = memoryMB;
+        }
+        else if (strcmp(strCommand, "-CAS") == 0)
+        {
+            if (strlen(strParameter) == 0)
+                throw "CAS sharpness not specified.";
+
+            float sharpness = std::stof(strParameter);
+            if ((sharpness < 0.0f) || (sharpness > 1.0f))
+                throw "CAS sharpness must be in the range 0.0 to 1.0.";
+
+            g_CmdPrams.useCAS      = true;
+            g_CmdPrams.fxSharpness = sharpness;
+        }
+        else if (strcmp(strCommand, "-FSR") == 0)
+        {
+            if (strlen(strParameter) == 0)
+                throw "FSR scale not specified.";
+
+            float scale = std::stof(strParameter);
+            if ((scale < 1.0f) || (scale > 4.0f))
+                throw "FSR scale must be in the range 1.0 to 4.0.";
+
+            g_CmdPrams.fsrScale = scale;
+        }
         else
         {
             if ((strlen(strParameter) > 0) || (strCommand[0] == '-'))
@@ -1244,14 +1380,14 @@ bool TC_PluginCodecSupportsFormat(const MipSet* pMipSet)
             pMipSet->m_ChannelFormat == CF_32bit || pMipSet->m_ChannelFormat == CF_Float16 || pMipSet->m_ChannelFormat == CF_Float32);
 }
 
-static void DeallocateMipSet(MipSet* mipSet)
+static void DeallocateMipSet(MipSet* mipSet, CMIPS* pCMIPS = NULL)
 {
     if (!mipSet)
         return;
 
     if (mipSet->m_pMipLevelTable)
     {
-        g_CMIPS->FreeMipSet(mipSet);
+        (pCMIPS ? pCMIPS : g_CMIPS)->FreeMipSet(mipSet);
         mipSet->m_pMipLevelTable = NULL;
     }
 
@@ -1290,6 +1426,81 @@ static void cleanup(bool Delete_gMipSetIn, bool SwizzleMipSetIn)
     DeallocateMipSet(&g_MipSetOut);
 }
 
+// Applies the -CAS or -FSR FidelityFX effect to the top level of an uncompressed 2D image.
+// On success the MipSet is replaced by the single level result, which may be larger.
+static bool ApplyFxFilter(CMP_MipSet* pMipSet)
+{
+    if ((pMipSet->m_TextureType != TT_2D) || (pMipSet->m_nDepth > 1))
+    {
+        PrintInfo("Error: -CAS and -FSR only support 2D textures\n");
+        return false;
+    }
+
+    PluginInterface_Filters* plugin_Fx = reinterpret_cast<PluginInterface_Filters*>(g_pluginManager.GetPlugin("FILTERS", "EFFECTS"));
+    if (!plugin_Fx)
+    {
+        PrintInfo("Error: The FidelityFX effects plugin was not found\n");
+        return false;
+    }
+
+    CMP_CFilterParams CFilterParam = {};
+    CFilterParam.useSRGB           = g_CmdPrams.CompressOptions.useSRGBFrames;
+    CFilterParam.destWidth         = pMipSet->m_nWidth;
+    CFilterParam.destHeight        = pMipSet->m_nHeight;
+
+    if (g_CmdPrams.fsrScale > 0.0f)
+    {
+        CFilterParam.nFxFilter  = CMP_FX_FILTER_FSR;
+        CFilterParam.fSharpness = (g_CmdPrams.fxSharpness < 0.0f) ? 0.9f : g_CmdPrams.fxSharpness;
+        CFilterParam.destWidth  = (int)(pMipSet->m_nWidth * g_CmdPrams.fsrScale + 0.5f);
+        CFilterParam.destHeight = (int)(pMipSet->m_nHeight * g_CmdPrams.fsrScale + 0.5f);
+    }
+    else
+    {
+        CFilterParam.nFxFilter  = CMP_FX_FILTER_CAS;
+        CFilterParam.fSharpness = g_CmdPrams.fxSharpness;
+    }
+
+    CMP_MipSet filtered = {};
+    CMP_ERROR  result   = CMP_CreateMipSet(&filtered, CFilterParam.destWidth, CFilterParam.destHeight, 1, pMipSet->m_ChannelFormat, TT_2D);
+    if (result == CMP_OK)
+    {
+        filtered.m_format = pMipSet->m_format;
+
+        if (plugin_Fx->TC_PluginSetSharedIO(g_CMIPS) == CMP_OK)
+            result = (CMP_ERROR)plugin_Fx->TC_CFilter(pMipSet, &filtered, &CFilterParam);
+        else
+            result = CMP_ERR_PLUGIN_SHAREDIO_NOT_SET;
+    }
+
+    delete plugin_Fx;
+
+    if (result != CMP_OK)
+    {
+        if (filtered.m_pMipLevelTable)
+            g_CMIPS->FreeMipSet(&filtered);
+        PrintInfo("Error %d: Failed to apply %s to the source image\n", result, (CFilterParam.nFxFilter == CMP_FX_FILTER_FSR) ? "-FSR" : "-CAS");
+        return false;
+    }
+
+    // Keep the description of the source, only its size and data change
+    filtered.m_TextureDataType = pMipSet->m_TextureDataType;
+    filtered.m_transcodeFormat = pMipSet->m_transcodeFormat;
+    filtered.m_isDeCompressed  = pMipSet->m_isDeCompressed;
+    filtered.m_nChannels       = pMipSet->m_nChannels;
+    filtered.m_isSigned        = pMipSet->m_isSigned;
+    filtered.m_pReservedData   = pMipSet->m_pReservedData;
+    pMipSet->m_pReservedData   = NULL;
+
+    g_CMIPS->FreeMipSet(pMipSet);
+    *pMipSet = filtered;
+
+    if (!g_CmdPrams.silent)
+        PrintInfo("Applied %s, image size %dx%d\n", (CFilterParam.nFxFilter == CMP_FX_FILTER_FSR) ? "FSR" : "CAS", pMipSet->m_nWidth, pMipSet->m_nHeight);
+
+    return true;
+}
+
 // mesh optimization process
 // only support case glTF->glTF, case obj->obj
 bool OptimizeMesh(std::string SourceFile, std::string DestFile)
@@ -1381,6 +1592,26 @@ bool OptimizeMesh(std::string SourceFile, std::string DestFile)
             meshSettings.bSimplifyMesh   = (g_CmdPrams.CompressOptions.iSimplifyLOD > 0);
             if (meshSettings.bSimplifyMesh)
                 meshSettings.nlevelofDetails = g_CmdPrams.CompressOptions.iSimplifyLOD;
+            meshSettings.bGenerateLODs         = (g_CmdPrams.nMeshLODs > 0);
+            meshSettings.bShareLODVertexBuffer = g_CmdPrams.shareMeshLODVertices;
+            if (meshSettings.bGenerateLODs)
+            {
+                // nlevelofDetails is shared by both features
+                if (meshSettings.bSimplifyMesh)
+                {
+                    PrintInfo("[Mesh Optimization] Error: -simplifyMeshLOD and -generateMeshLODs cannot be used together.\n");
+                    plugin_Mesh->CleanUp();
+                    return false;
+                }
+                // LODs are saved as separate obj files, the glTF writer can only update the existing buffers in place
+                if (!IsFileOBJ(DestFile))
+                {
+                    PrintInfo("[Mesh Optimization] Error: -generateMeshLODs supports obj destination files only.\n");
+                    plugin_Mesh->CleanUp();
+                    return false;
+                }
+                meshSettings.nlevelofDetails = g_CmdPrams.nMeshLODs;
+            }
 
             try
             {
@@ -1459,6 +1690,20 @@ bool OptimizeMesh(std::string SourceFile, std::string DestFile)
                 {
                     if (!g_CmdPrams.silent)
                         PrintInfo("[Mesh Optimization] Success in saving optimized obj data.\n");
+
+                    // Each generated LOD goes to its own file next to the destination: dest_LOD1.obj, dest_LOD2.obj ...
+                    for (size_t lod = 1; (result == 0) && (lod <= (*optimized)[0].lods.size()); lod++)
+                    {
+                        CMP_Mesh    lodMesh = GetMeshLOD((*optimized)[0], lod);
+                        std::string lodFile = GetMeshLODFileName(g_CmdPrams.DestFile, lod);
+                        if (plugin_save->SaveModelData(lodFile.c_str(), &lodMesh) == -1)
+                        {
+                            PrintInfo("[Mesh Optimization] Failed to save LOD file %s.\n", lodFile.c_str());
+                            result = -1;
+                        }
+                        else if (!g_CmdPrams.silent)
+                            PrintInfo("[Mesh Optimization] Saved LOD%d to %s.\n", (int)lod, lodFile.c_str());
+                    }
                 }
                 else
                 {
@@ -1513,6 +1758,363 @@ bool OptimizeMesh(std::string SourceFile, std::string DestFile)
     return true;
 }
 
+double timeStampsec();
+
+// Image plugins keep their state in globals, so loads and saves that go through the same plugin
+// must not run concurrently. Plugins are identified by "OCV" or the upper case file extension.
+static std::mutex& ImagePluginMutex(const std::string& plugin)
+{
+    static std::mutex                        pluginMutexesLock;
+    static std::map<std::string, std::mutex> pluginMutexes;
+
+    std::lock_guard<std::mutex> lock(pluginMutexesLock);
+    return pluginMutexes[plugin];
+}
+
+// Resolves "." and ".." components and uses '/' separators, so that different spellings
+// of the same image path compare equal
+static std::string NormalizeImagePath(const std::string& path)
+{
+    std::string normalized = path;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+
+    std::vector<std::string> parts;
+    size_t                   start = 0;
+    while (start <= normalized.size())
+    {
+        size_t end = normalized.find('/', start);
+        if (end == std::string::npos)
+            end = normalized.size();
+
+        std::string part = normalized.substr(start, end - start);
+        if (part == "..")
+        {
+            if (!parts.empty() && parts.back() != ".." && !parts.back().empty())
+                parts.pop_back();
+            else
+                parts.push_back(part);
+        }
+        else if (part != "." && (!part.empty() || parts.empty()))
+            parts.push_back(part);
+
+        start = end + 1;
+    }
+
+    std::string result;
+    for (size_t i = 0; i < parts.size(); i++)
+    {
+        if (i > 0)
+            result += '/';
+        result += parts[i];
+    }
+    return result;
+}
+
+// 64 bit FNV-1a hash of a file's content
+static bool HashFileContent(const std::string& path, unsigned long long* pHash, unsigned long long* pSize)
+{
+    FILE* pFile = fopen(path.c_str(), "rb");
+    if (!pFile)
+        return false;
+
+    unsigned long long         hash = 14695981039346656037ULL;
+    unsigned long long         size = 0;
+    std::vector<unsigned char> buffer(1 << 20);
+    size_t                     bytesRead;
+    while ((bytesRead = fread(buffer.data(), 1, buffer.size(), pFile)) > 0)
+    {
+        for (size_t i = 0; i < bytesRead; i++)
+        {
+            hash ^= buffer[i];
+            hash *= 1099511628211ULL;
+        }
+        size += bytesRead;
+    }
+
+    bool ok = ferror(pFile) == 0;
+    fclose(pFile);
+
+    *pHash = hash;
+    *pSize = size;
+    return ok;
+}
+
+// Runs job(0) .. job(numJobs - 1) on up to numThreads threads, including the calling thread
+template <typename Job>
+static void RunParallelJobs(size_t numJobs, size_t numThreads, Job job)
+{
+    std::atomic<size_t> nextJob(0);
+
+    auto worker = [&]() {
+        size_t jobIndex;
+        while ((jobIndex = nextJob++) < numJobs)
+            job(jobIndex);
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < std::min(numThreads, numJobs); ++i)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (std::thread& thread : workers)
+        thread.join();
+}
+
+struct GLTFImageJob
+{
+    std::string        input;             // image uri as written in the glTF
+    std::string        source;            // path the image is loaded from
+    std::string        output;            // compressed dds written for the image
+    std::string        destDir;           // folder of output
+    size_t             compressedBy = 0;  // index of the job whose output this image shares
+    bool               hashed       = false;
+    unsigned long long hash         = 0;
+    unsigned long long size         = 0;
+};
+
+// Loads, generates mip levels for, compresses and saves a single glTF image.
+// The codecs keep tables and library state in globals, so only one image is encoded at a time
+// under encodeMutex while the other images load, generate mip levels and save.
+static bool CompressGLTFImage(const GLTFImageJob& job, CMP_DWORD numThreads, std::atomic<bool>& useCPU, std::mutex& encodeMutex, std::mutex& printMutex)
+{
+    MipSet inMips;
+    memset(&inMips, 0, sizeof(CMP_MipSet));
+
+    int ret;
+    {
+        std::lock_guard<std::mutex> lock(ImagePluginMutex(CMP_GetFileExtension(job.source.c_str(), false, true)));
+        ret = AMDLoadMIPSTextureImage(job.source.c_str(), &inMips, false, &g_pluginManager);
+    }
+    if (ret != 0)
+    {
+        std::lock_guard<std::mutex> lock(printMutex);
+        PrintInfo("Error: Failed to load image '%s'\n", job.source.c_str());
+        return false;
+    }
+
+    if (inMips.m_nMipLevels < g_CmdPrams.MipsLevel && !g_CmdPrams.use_noMipMaps)
+    {
+        CMP_INT           requestLevel  = g_CmdPrams.MipsLevel;
+        CMP_INT           nMinSize      = CMP_CalcMinMipSize(inMips.m_nHeight, inMips.m_nWidth, requestLevel);
+        CMP_CFilterParams CFilterParam  = {};
+        CFilterParam.dwMipFilterOptions = 0;
+        CFilterParam.nFilterType        = 0;
+        CFilterParam.nMinSize           = nMinSize;
+        CFilterParam.fGammaCorrection   = g_CmdPrams.CompressOptions.fInputFilterGamma;
+
+        CMP_GenerateMIPLevelsEx(&inMips, &CFilterParam);
+    }
+
+    CMP_MipSet mipSetCmp;
+    memset(&mipSetCmp, 0, sizeof(CMP_MipSet));
+
+    std::unique_lock<std::mutex> encodeLock(encodeMutex);
+
+    CMP_ERROR cmp_status = CMP_ERR_FAILED_HOST_SETUP;
+    if (!useCPU)
+    {
+        KernelOptions kernel_options;
+        memset(&kernel_options, 0, sizeof(KernelOptions));
+
+        kernel_options.format     = g_CmdPrams.CompressOptions.DestFormat;
+        kernel_options.fquality   = g_CmdPrams.CompressOptions.fquality;
+        kernel_options.threads    = numThreads;
+        kernel_options.height     = inMips.dwHeight;
+        kernel_options.width      = inMips.dwWidth;
+        kernel_options.encodeWith = g_CmdPrams.CompressOptions.nEncodeWith;
+
+        cmp_status = CMP_ProcessTexture(&inMips, &mipSetCmp, kernel_options, NULL);
+        if (cmp_status == CMP_ERR_FAILED_HOST_SETUP)
+        {
+            useCPU = true;
+            memset(&mipSetCmp, 0, sizeof(CMP_MipSet));
+        }
+    }
+
+    if (useCPU && (cmp_status == CMP_ERR_FAILED_HOST_SETUP))
+    {
+        CMP_CompressOptions options = g_CmdPrams.CompressOptions;
+        options.nEncodeWith         = CMP_Compute_type::CMP_CPU;
+        options.dwnumThreads        = numThreads;
+        cmp_status                  = CMP_ConvertMipTexture(&inMips, &mipSetCmp, &options, NULL);
+    }
+
+    encodeLock.unlock();
+
+    g_CMIPS->FreeMipSet(&inMips);
+
+    if (cmp_status != CMP_OK)
+    {
+        g_CMIPS->FreeMipSet(&mipSetCmp);
+        std::lock_guard<std::mutex> lock(printMutex);
+        PrintInfo("Error: Something went wrong while compressing image '%s'!\n", job.source.c_str());
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(ImagePluginMutex(CMP_GetFileExtension(job.output.c_str(), false, true)));
+        ret = AMDSaveMIPSTextureImage(job.output.c_str(), &mipSetCmp, false, g_CmdPrams.CompressOptions, g_CmdPrams.FileSaveParams.c_str());
+    }
+    g_CMIPS->FreeMipSet(&mipSetCmp);
+
+    if (ret != 0)
+    {
+        std::lock_guard<std::mutex> lock(printMutex);
+        PrintInfo("Error: Something went wrong while saving compressed image '%s'!\n", job.output.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+// Compresses the separate images referenced by a glTF model to dds files in dstFolder.
+// Images that resolve to the same file or whose files have identical content are compressed
+// once and the result is copied. The unique images are processed concurrently, sharing the
+// -NumThreads budget between them.
+static bool CompressGLTFImages(const Model& model, const std::string& srcFile, const std::string& dstFolder)
+{
+    double startTime = timeStampsec();
+
+    std::string imgSrcDir = "";
+    auto        pos       = srcFile.rfind("\\");
+    if (pos == std::string::npos)
+    {
+        pos = srcFile.rfind("/");
+    }
+    if (pos != std::string::npos)
+    {
+        imgSrcDir = srcFile.substr(0, pos + 1);
+    }
+
+    std::vector<GLTFImageJob> jobs(model.images.size());
+    for (size_t i = 0; i < model.images.size(); ++i)
+    {
+        GLTFImageJob& job = jobs[i];
+        job.input         = model.images[i].uri;
+        if (job.input.empty())
+        {
+            PrintInfo("Error: Compressonator can only compress separate images with glTF!\n");
+            return false;
+        }
+
+        job.source = imgSrcDir + job.input;
+        job.output = dstFolder + job.input;
+        job.output.replace(job.output.rfind('.'), 1, "_");
+        job.output += ".dds";
+
+        job.destDir = dstFolder;
+        pos         = job.output.rfind("\\");
+        if (pos == std::string::npos)
+        {
+            pos = job.output.rfind("/");
+        }
+        if (pos != std::string::npos)
+        {
+            job.destDir = job.output.substr(0, pos + 1);
+        }
+    }
+
+    size_t numThreads = g_CmdPrams.CompressOptions.dwnumThreads > 0 ? g_CmdPrams.CompressOptions.dwnumThreads : std::thread::hardware_concurrency();
+    numThreads        = std::max<size_t>(1, numThreads);
+
+    // Images that reference the same file
+    std::map<std::string, size_t> jobByPath;
+    std::vector<size_t>           uniquePaths;
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        auto inserted        = jobByPath.insert(std::make_pair(NormalizeImagePath(jobs[i].source), i));
+        jobs[i].compressedBy = inserted.first->second;
+        if (inserted.second)
+            uniquePaths.push_back(i);
+    }
+
+    // Images with identical content in different files
+    RunParallelJobs(uniquePaths.size(), numThreads, [&](size_t index) {
+        GLTFImageJob& job = jobs[uniquePaths[index]];
+        job.hashed        = HashFileContent(job.source, &job.hash, &job.size);
+    });
+
+    std::map<std::pair<unsigned long long, unsigned long long>, size_t> jobByContent;
+    std::vector<size_t>                                                 uniqueImages;
+    for (size_t i : uniquePaths)
+    {
+        if (jobs[i].hashed)
+        {
+            auto inserted = jobByContent.insert(std::make_pair(std::make_pair(jobs[i].hash, jobs[i].size), i));
+            if (!inserted.second)
+            {
+                jobs[i].compressedBy = inserted.first->second;
+                continue;
+            }
+        }
+        uniqueImages.push_back(i);
+    }
+    for (GLTFImageJob& job : jobs)
+        job.compressedBy = jobs[job.compressedBy].compressedBy;
+
+    std::vector<bool> haveDestDir(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i)
+        haveDestDir[i] = CMP_DirExists(jobs[i].destDir) || CMP_CreateDir(jobs[i].destDir);
+
+    // The encoder that is running gets the whole thread budget, the other workers load and save
+    size_t    numWorkers     = std::max<size_t>(1, std::min(numThreads, uniqueImages.size()));
+    CMP_DWORD encoderThreads = (CMP_DWORD)numThreads;
+
+    CMP_Compute_type  encodeWith = g_CmdPrams.CompressOptions.nEncodeWith;
+    std::atomic<bool> useCPU((encodeWith == CMP_Compute_type::CMP_CPU) || (encodeWith == CMP_Compute_type::CMP_UNKNOWN));
+    std::atomic<bool> failed(false);
+    std::mutex        encodeMutex;
+    std::mutex        printMutex;
+
+    RunParallelJobs(uniqueImages.size(), numWorkers, [&](size_t index) {
+        const GLTFImageJob& job = jobs[uniqueImages[index]];
+        if (failed || !haveDestDir[uniqueImages[index]])
+            return;
+
+        if (!g_CmdPrams.silent)
+        {
+            std::lock_guard<std::mutex> lock(printMutex);
+            PrintInfo("Processing '%s'\n", job.input.c_str());
+        }
+
+        if (!CompressGLTFImage(job, encoderThreads, useCPU, encodeMutex, printMutex))
+            failed = true;
+    });
+
+    if (useCPU && (encodeWith != CMP_Compute_type::CMP_CPU))
+        g_CmdPrams.CompressOptions.nEncodeWith = CMP_Compute_type::CMP_CPU;
+
+    if (failed)
+        return false;
+
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        GLTFImageJob& job = jobs[i];
+
+        if (haveDestDir[i] && (job.compressedBy != i))
+        {
+            GLTFImageJob& compressed = jobs[job.compressedBy];
+            if (NormalizeImagePath(compressed.output) != NormalizeImagePath(job.output))
+                CMP_FileCopy(compressed.output, job.output);
+        }
+
+        if (!CMP_FileExists(dstFolder + job.input))
+        {
+            std::string dst = dstFolder + job.input;
+            CMP_FileCopy(job.source, dst);
+        }
+    }
+
+    if (!g_CmdPrams.silent)
+        PrintInfo("Compressed %d unique image(s) for %d glTF image(s) in %.3f sec\n",
+                  (int)uniqueImages.size(),
+                  (int)jobs.size(),
+                  timeStampsec() - startTime);
+
+    return true;
+}
+
 // mesh draco compression/decompression
 static bool CompressDecompressMesh(std::string SourceFile, std::string DestFile)
 {
@@ -1589,106 +2191,8 @@ static bool CompressDecompressMesh(std::string SourceFile, std::string DestFile)
                 {
                     dstFolder = dstFolder.substr(0, pos + 1);
                 }
-                size_t originalImages = model.images.size();
-                for (unsigned i = 0; i < model.images.size(); ++i)
-                {
-                    std::string input = model.images[i].uri;
-                    if (!g_CmdPrams.silent)
-                        PrintInfo("Processing '%s'\n", input.c_str());
-                    if (input.empty())
-                    {
-                        PrintInfo("Error: Compressonator can only compress separate images with glTF!\n");
-                        return false;
-                    }
-                    std::string output = dstFolder + input;
-                    output.replace(output.rfind('.'), 1, "_");
-                    output += ".dds";
-
-                    std::string imgSrcDir = "";
-                    auto        pos       = srcFile.rfind("\\");
-                    if (pos == std::string::npos)
-                    {
-                        pos = srcFile.rfind("/");
-                    }
-                    if (pos != std::string::npos)
-                    {
-                        imgSrcDir = srcFile.substr(0, pos + 1);
-                    }
-
-                    std::string imgDestDir = dstFolder;
-                    pos                    = output.rfind("\\");
-                    if (pos == std::string::npos)
-                    {
-                        pos = output.rfind("/");
-                    }
-                    if (pos != std::string::npos)
-                    {
-                        imgDestDir = output.substr(0, pos + 1);
-                    }
-
-                    if (CMP_CreateDir(imgDestDir))
-                    {
-                        MipSet inMips{};
-                        memset(&inMips, 0, sizeof(CMP_MipSet));
-                        int ret = AMDLoadMIPSTextureImage((imgSrcDir + input).c_str(), &inMips, false, &g_pluginManager);
-
-                        if (inMips.m_nMipLevels < g_CmdPrams.MipsLevel && !g_CmdPrams.use_noMipMaps)
-                        {
-                            CMP_INT           requestLevel  = g_CmdPrams.MipsLevel;
-                            CMP_INT           nMinSize      = CMP_CalcMinMipSize(inMips.m_nHeight, inMips.m_nWidth, requestLevel);
-                            CMP_CFilterParams CFilterParam  = {};
-                            CFilterParam.dwMipFilterOptions = 0;
-                            CFilterParam.nFilterType        = 0;
-                            CFilterParam.nMinSize           = nMinSize;
-                            CFilterParam.fGammaCorrection   = g_CmdPrams.CompressOptions.fInputFilterGamma;
-                            CMP_GenerateMIPLevelsEx(&inMips, &CFilterParam);
-                        }
-
-                        CMP_MipSet mipSetCmp;
-                        memset(&mipSetCmp, 0, sizeof(CMP_MipSet));
-
-                        KernelOptions kernel_options;
-                        memset(&kernel_options, 0, sizeof(KernelOptions));
-
-                        kernel_options.format     = g_CmdPrams.CompressOptions.DestFormat;
-                        kernel_options.fquality   = g_CmdPrams.CompressOptions.fquality;
-                        kernel_options.threads    = g_CmdPrams.CompressOptions.dwnumThreads;
-                        kernel_options.height     = inMips.dwHeight;
-                        kernel_options.width      = inMips.dwWidth;
-                        kernel_options.encodeWith = g_CmdPrams.CompressOptions.nEncodeWith;
-
-                        auto cmp_status = CMP_ProcessTexture(&inMips, &mipSetCmp, kernel_options, CompressionCallback);
-                        if (cmp_status == CMP_ERR_FAILED_HOST_SETUP)
-                        {
-                            g_CmdPrams.CompressOptions.nEncodeWith = CMP_Compute_type::CMP_CPU;
-                            kernel_options.encodeWith              = g_CmdPrams.CompressOptions.nEncodeWith;
-                            memset(&mipSetCmp, 0, sizeof(CMP_MipSet));
-                            cmp_status = CMP_ProcessTexture(&inMips, &mipSetCmp, kernel_options, CompressionCallback);
-                        }
-
-                        if (cmp_status != CMP_OK)
-                        {
-                            PrintInfo("Error: Something went wrong while compressing image!\n");
-                            return false;
-                        }
-
-                        ret = AMDSaveMIPSTextureImage(output.c_str(), &mipSetCmp, false, g_CmdPrams.CompressOptions);
-                        if (ret != 0)
-                        {
-                            PrintInfo("Error: Something went wrong while saving compressed image!\n");
-                            return false;
-                        }
-                    }
-
-                    if (!CMP_FileExists(dstFolder + input))
-                    {
-                        std::string src = imgSrcDir;
-                        src.append(input);
-                        std::string dst = dstFolder;
-                        dst.append(input);
-                        CMP_FileCopy(src, dst);
-                    }
-                }
+                if (!CompressGLTFImages(model, srcFile, dstFolder))
+                    return false;
             }
 
             ret = saver.WriteGltfSceneToFile(&model, &err, dstFile, g_CmdPrams.CompressOptions, is_draco_src, g_CmdPrams.use_Draco_Encode);
@@ -1850,9 +2354,93 @@ static bool CompressDecompressMesh(std::string SourceFile, std::string DestFile)
     return true;
 }
 
+// mesh compression/decompression with the lossless meshoptimizer codec: obj->cmsh and cmsh->obj
+static bool CompressDecompressMeshopt(std::string SourceFile, std::string DestFile)
+{
+    if (!(CMP_FileExists(SourceFile)))
+    {
+        PrintInfo("Error: Source Model Mesh File is not found.\n");
+        return false;
+    }
+
+    PluginInterface_Mesh* plugin_MeshComp;
+    plugin_MeshComp = reinterpret_cast<PluginInterface_Mesh*>(g_pluginManager.GetPlugin("MESH_COMPRESSOR", "DRACO"));
+    if (!plugin_MeshComp)
+    {
+        PrintInfo("[Mesh Compression] Error in loading mesh compression plugin.\n");
+        return false;
+    }
+
+    PluginInterface_3DModel_Loader* plugin_obj;
+    plugin_obj = reinterpret_cast<PluginInterface_3DModel_Loader*>(g_pluginManager.GetPlugin("3DMODEL_LOADER", "OBJ"));
+    if (!plugin_obj)
+    {
+        PrintInfo("[Mesh Compression] Error in loading obj plugin.\n");
+        delete plugin_MeshComp;
+        return false;
+    }
+
+    if (plugin_MeshComp->Init() != 0)
+    {
+        PrintInfo("[Mesh Compression] Error in init mesh plugin.\n");
+        delete plugin_obj;
+        delete plugin_MeshComp;
+        return false;
+    }
+
+    plugin_MeshComp->TC_PluginSetSharedIO(g_CMIPS);
+    plugin_obj->TC_PluginSetSharedIO(g_CMIPS);
+
+    CMP_DracoOptions DracoOptions;
+    DracoOptions.use_meshopt_codec = true;
+    DracoOptions.input             = SourceFile;
+    DracoOptions.output            = DestFile;
+
+    if (!g_CmdPrams.silent)
+        PrintInfo("Processing: Mesh Compression/Decompression...\n");
+
+    bool success = false;
+    if (IsFileOBJ(SourceFile) && IsFileCMSH(DestFile))
+    {
+        if (plugin_obj->LoadModelData(SourceFile.c_str(), "", &g_pluginManager, NULL, &CompressionCallback) == 0)
+        {
+            CMODEL_DATA* modelData = (CMODEL_DATA*)plugin_obj->GetModelData();
+            if (modelData && (modelData->m_meshData.size() > 0))
+                success = plugin_MeshComp->ProcessMesh(&modelData->m_meshData[0], (void*)&DracoOptions, NULL, &CompressionCallback) != NULL;
+        }
+        else
+            PrintInfo("[Mesh Compression] Error Loading Model Data.\n");
+    }
+    else if (IsFileCMSH(SourceFile) && IsFileOBJ(DestFile))
+    {
+        std::ifstream     inputFile(SourceFile, std::ios::binary);
+        std::vector<char> inputData((std::istreambuf_iterator<char>(inputFile)), std::istreambuf_iterator<char>());
+
+        DracoOptions.m_bDecode = true;
+        CMP_Mesh* mesh         = (CMP_Mesh*)plugin_MeshComp->ProcessMesh(&inputData, (void*)&DracoOptions, NULL, &CompressionCallback);
+        if (mesh)
+        {
+            success = plugin_obj->SaveModelData(DestFile.c_str(), mesh) == 0;
+            delete mesh;
+        }
+    }
+    else
+        PrintInfo("Error: -meshoptcodec supports obj->cmsh(compression) and cmsh->obj(decompression) only.\n");
+
+    if (!success)
+        PrintInfo("[Mesh Compression] Error in processing mesh.\n");
+
+    plugin_MeshComp->CleanUp();
+    delete plugin_obj;
+    delete plugin_MeshComp;
+    return success;
+}
+
 //cmdline only
 static bool GenerateAnalysis(std::string SourceFile, std::string DestFile)
 {
+    CMP_PROFILE_SCOPE("Analysis");
+
     if (!(CMP_FileExists(SourceFile)))
     {
         PrintInfo("Error: Source Image File is not found.\n");
@@ -2177,6 +2765,8 @@ static CMP_ERROR CMP_ConvertMipTextureCGP(MipSet* pMipSetIn, MipSet* pMipSetOut,
     {
         for (int nFaceOrSlice = 0; (nFaceOrSlice < CMP_MaxFacesOrSlices(pMipSetIn, nMipLevel)) && contineProcessing; nFaceOrSlice++)
         {
+            CMP_PROFILE_SCOPE_ARG("Encode mip", nMipLevel);
+
             //=====================
             // Uncompressed source
             //======================
@@ -2376,6 +2966,9 @@ static CMP_ERROR CMP_ConvertMipTextureCGP(MipSet* pMipSetIn, MipSet* pMipSetOut,
                         }
                         else if (!g_CmdPrams.silent)
                             PrintInfo("Warning: Target device or format is not supported or failed to build. CPU will be used\n");
+
+                        if (CMP_GetWorkerStats(&g_CmdPrams.WorkerStats) != CMP_OK)
+                            g_CmdPrams.WorkerStats.m_num_workers = 0;
                     }
 
                     if (kernel_options.getDeviceInfo)
@@ -2681,6 +3274,20 @@ static void ProcessResults(CCmdLineParamaters& prams, CMP_ANALYSIS_DATA& analysi
                 fprintf(fp, "Quality      : %s\n", str_fquality.c_str());
                 fprintf(fp, "KPerf(ms)    : %s\n", str_perf.c_str());
                 fprintf(fp, "MTx/s        : %s\n", str_mtx.c_str());
+                if (prams.WorkerStats.m_num_workers > 0)
+                {
+                    const KernelWorkerStats& workerStats = prams.WorkerStats;
+
+                    CMP_INT minBlocks = workerStats.m_worker_blocks[0];
+                    CMP_INT maxBlocks = workerStats.m_worker_blocks[0];
+                    for (CMP_INT i = 1; i < workerStats.m_num_workers && i < CMP_MAX_PERF_WORKERS; i++)
+                    {
+                        minBlocks = (std::min)(minBlocks, workerStats.m_worker_blocks[i]);
+                        maxBlocks = (std::max)(maxBlocks, workerStats.m_worker_blocks[i]);
+                    }
+
+                    fprintf(fp, "Workers      : %d, blocks per worker %d to %d\n", workerStats.m_num_workers, minBlocks, maxBlocks);
+                }
                 fprintf(fp, "MSE          : %s\n", str_mse.c_str());
                 fprintf(fp, "PSNR         : %s\n", str_psnr.c_str());
                 fprintf(fp, "SSIM         : %s\n", str_ssim.c_str());
@@ -2778,6 +3385,335 @@ static CMP_Texture MipSetToTexture(const CMP_MipSet& mipSet, CMP_INT mipLevelInd
     return texture;
 }
 
+#ifdef USE_LOSSLESS_COMPRESSION
+// Compresses or decompresses each Brotli-G stream of a package. The streams do not share any state,
+// so they are distributed across worker threads that each claim the next unprocessed stream.
+static bool ProcessBRLGStreams(std::vector<CMP_MipSet>&   srcMipSets,
+                               std::vector<CMP_MipSet>&   destMipSets,
+                               std::vector<CMP_Texture>&  destTextures,
+                               bool                       compressing,
+                               const CMP_CompressOptions& options,
+                               CMP_Feedback_Proc          pFeedbackProc)
+{
+    size_t numStreams = srcMipSets.size();
+    if (numStreams == 0)
+        return true;
+
+    size_t numThreads = 1;
+    if (!options.bDisableMultiThreading)
+    {
+        numThreads = options.dwnumThreads > 0 ? options.dwnumThreads : std::thread::hardware_concurrency();
+        numThreads = std::max<size_t>(1, std::min(numThreads, numStreams));
+    }
+
+    // Progress feedback is only meaningful when a single stream is being processed at a time
+    if (numThreads > 1)
+        pFeedbackProc = NULL;
+
+    std::atomic<size_t> nextStream(0);
+    std::atomic<bool>   failed(false);
+
+    auto worker = [&]() {
+        size_t streamIndex;
+        while (!failed && (streamIndex = nextStream++) < numStreams)
+        {
+            CMP_Texture srcTexture  = MipSetToTexture(srcMipSets[streamIndex], 0);
+            CMP_Texture destTexture = MipSetToTexture(destMipSets[streamIndex], 0);
+
+            CMP_CompressOptions streamOptions = options;
+            streamOptions.DestFormat          = destMipSets[streamIndex].m_format;
+
+            CMP_ERROR result = CMP_OK;
+
+            if (compressing)
+                result = CodecCompressTexture(&srcTexture, &destTexture, &streamOptions, pFeedbackProc);
+            else
+                result = CodecDecompressTexture(&srcTexture, &destTexture, &streamOptions, pFeedbackProc);
+
+            if (result != CMP_OK)
+                failed = true;
+
+            destTextures[streamIndex] = destTexture;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < numThreads; ++i)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (std::thread& thread : workers)
+        thread.join();
+
+    return !failed;
+}
+#endif
+
+//=====================================================================================
+// Batch pipeline (-Pipeline)
+// When a list of images is processed, a reader thread loads the next source files ahead
+// of the encoder and a writer thread saves finished outputs, so file I/O overlaps with
+// encoding. The queues between the stages hold at most -Pipeline files each, and the
+// reader also stops prefetching while the loaded and unsaved data exceeds -PipelineMemory.
+// Each stage thread uses its own CMIPS, image plugin lookups are serialized by the plugin manager.
+//=====================================================================================
+static size_t MipSetDataSize(MipSet* pMipSet, CMIPS* pCMIPS)
+{
+    size_t size = 0;
+    for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMipLevels; nMipLevel++)
+    {
+        for (int nFaceOrSlice = 0; nFaceOrSlice < CMP_MaxFacesOrSlices(pMipSet, nMipLevel); nFaceOrSlice++)
+        {
+            MipLevel* pMipLevel = pCMIPS->GetMipLevel(pMipSet, nMipLevel, nFaceOrSlice);
+            if (pMipLevel)
+                size += pMipLevel->m_dwLinearSize;
+        }
+    }
+    return size;
+}
+
+class CmdLinePipeline
+{
+public:
+    CmdLinePipeline(const std::vector<std::string>& sourceFiles, int depth, size_t memoryLimit)
+        : m_sourceFiles(sourceFiles)
+        , m_depth(std::max(depth, 1))
+        , m_memoryLimit(memoryLimit)
+    {
+        m_readerCMIPS.PrintLine = PrintStatusLine;
+
+        m_startTime = timeStampsec();
+        m_reader    = std::thread(&CmdLinePipeline::ReaderLoop, this);
+        m_writer    = std::thread(&CmdLinePipeline::WriterLoop, this);
+    }
+
+    ~CmdLinePipeline()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+
+        // Outputs that were already queued are still written
+        m_reader.join();
+        m_writer.join();
+
+        for (Item& item : m_loaded)
+            DeallocateMipSet(&item.mipSet);
+    }
+
+    // Loads a source file, serialized with other loads and saves that use the same image plugin
+    int Load(const std::string& sourceFile, MipSet* pMipSet, CMIPS* pCMIPS)
+    {
+        std::string                 plugin = g_CmdPrams.use_OCV ? "OCV" : CMP_GetFileExtension(sourceFile.c_str(), false, true);
+        std::lock_guard<std::mutex> lock(ImagePluginMutex(plugin));
+        return AMDLoadMIPSTextureImage(sourceFile.c_str(), pMipSet, g_CmdPrams.use_OCV, &g_pluginManager, pCMIPS);
+    }
+
+    // Encode stage: hands over the prefetched sourceFile, returns false if it is not in the prefetch list
+    bool TakeSource(const std::string& sourceFile, MipSet* pMipSet, int* pLoadResult)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        size_t index = m_takeIndex;
+        while (index < m_sourceFiles.size() && m_sourceFiles[index] != sourceFile)
+            index++;
+        if (index == m_sourceFiles.size())
+            return false;
+
+        double waitStart = timeStampsec();
+        for (;;)
+        {
+            m_condition.wait(lock, [this] { return !m_loaded.empty(); });
+
+            Item item = m_loaded.front();
+            m_loaded.pop_front();
+            m_bytesInFlight -= item.bytes;
+            m_condition.notify_all();
+
+            // Files the encoder skipped are dropped
+            if (item.index < index)
+            {
+                DeallocateMipSet(&item.mipSet);
+                continue;
+            }
+
+            m_takeIndex = index + 1;
+            m_waitInput += timeStampsec() - waitStart;
+
+            memcpy(pMipSet, &item.mipSet, sizeof(MipSet));
+            *pLoadResult = item.result;
+            return true;
+        }
+    }
+
+    // Queues pMipSet to be saved to destFile. The pipeline takes over its data and leaves the rest of
+    // the MipSet description in place. Returns false if an earlier save has failed.
+    bool QueueSave(const std::string& destFile, MipSet* pMipSet, const CMP_CompressOptions& options)
+    {
+        Item item;
+        item.file    = destFile;
+        item.options = options;
+        item.bytes   = MipSetDataSize(pMipSet, g_CMIPS);
+        memcpy(&item.mipSet, pMipSet, sizeof(MipSet));
+
+        pMipSet->m_pMipLevelTable = NULL;
+        pMipSet->m_pReservedData  = NULL;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        double waitStart = timeStampsec();
+        m_condition.wait(lock, [this] { return m_saving.size() < m_depth; });
+        m_waitOutput += timeStampsec() - waitStart;
+
+        m_bytesInFlight += item.bytes;
+        m_saving.push_back(item);
+        m_condition.notify_all();
+
+        return m_failedSave.empty();
+    }
+
+    // Waits until all queued outputs are saved, returns false if any save failed
+    bool FlushSaves()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_saving.empty() && !m_writerBusy; });
+        return m_failedSave.empty();
+    }
+
+    std::string FailedSave()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_failedSave;
+    }
+
+    void PrintTimings()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        double wallTime   = timeStampsec() - m_startTime;
+        double encodeTime = std::max(0.0, wallTime - m_waitInput - m_waitOutput);
+
+        PrintInfo("Pipeline     : load %.3f sec, encode %.3f sec, save %.3f sec, total %.3f sec for %d file(s)\n",
+                  m_loadTime,
+                  encodeTime,
+                  m_saveTime,
+                  wallTime,
+                  (int)m_takeIndex);
+        PrintInfo("               encoder waited %.3f sec for input and %.3f sec for output\n", m_waitInput, m_waitOutput);
+    }
+
+private:
+    struct Item
+    {
+        std::string         file;
+        size_t              index = 0;
+        MipSet              mipSet;
+        int                 result = 0;
+        size_t              bytes  = 0;
+        CMP_CompressOptions options;
+    };
+
+    void ReaderLoop()
+    {
+        for (size_t index = 0; index < m_sourceFiles.size(); index++)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this] { return m_stopping || (m_loaded.size() < m_depth && m_bytesInFlight < m_memoryLimit); });
+                if (m_stopping)
+                    return;
+            }
+
+            Item item;
+            item.file  = m_sourceFiles[index];
+            item.index = index;
+            memset(&item.mipSet, 0, sizeof(MipSet));
+
+            // Same swizzle requests the encoder sets up before a load
+            if (g_CmdPrams.noswizzle)
+                item.mipSet.m_swizzle = false;
+            if (g_CmdPrams.doswizzle)
+                item.mipSet.m_swizzle = true;
+
+            double loadStart = timeStampsec();
+            item.result      = Load(item.file, &item.mipSet, &m_readerCMIPS);
+            if (item.result == 0)
+                item.bytes = MipSetDataSize(&item.mipSet, &m_readerCMIPS);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_loadTime += timeStampsec() - loadStart;
+            m_bytesInFlight += item.bytes;
+            m_loaded.push_back(item);
+            m_condition.notify_all();
+        }
+    }
+
+    void WriterLoop()
+    {
+        for (;;)
+        {
+            Item item;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this] { return m_stopping || !m_saving.empty(); });
+                if (m_saving.empty())
+                    return;
+
+                item = m_saving.front();
+                m_saving.pop_front();
+                m_writerBusy = true;
+            }
+
+            double saveStart = timeStampsec();
+            int    result;
+            {
+                std::string                 plugin = g_CmdPrams.use_OCV_out ? "OCV" : CMP_GetFileExtension(item.file.c_str(), false, true);
+                std::lock_guard<std::mutex> pluginLock(ImagePluginMutex(plugin));
+                result = AMDSaveMIPSTextureImage(item.file.c_str(), &item.mipSet, g_CmdPrams.use_OCV_out, item.options, g_CmdPrams.FileSaveParams.c_str());
+            }
+            DeallocateMipSet(&item.mipSet, &m_writerCMIPS);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_saveTime += timeStampsec() - saveStart;
+            m_bytesInFlight -= item.bytes;
+            if ((result != 0) && m_failedSave.empty())
+                m_failedSave = item.file;
+            m_writerBusy = false;
+            m_condition.notify_all();
+        }
+    }
+
+    std::vector<std::string> m_sourceFiles;
+    size_t                   m_depth;
+    size_t                   m_memoryLimit;
+    size_t                   m_takeIndex     = 0;
+    size_t                   m_bytesInFlight = 0;
+    bool                     m_stopping      = false;
+    bool                     m_writerBusy    = false;
+    std::string              m_failedSave;
+
+    std::deque<Item> m_loaded;
+    std::deque<Item> m_saving;
+
+    std::mutex              m_mutex;
+    std::condition_variable m_condition;
+
+    double m_startTime  = 0;
+    double m_loadTime   = 0;
+    double m_saveTime   = 0;
+    double m_waitInput  = 0;
+    double m_waitOutput = 0;
+
+    CMIPS m_readerCMIPS;
+    CMIPS m_writerCMIPS;
+
+    std::thread m_reader;
+    std::thread m_writer;
+};
+
 int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
 {
     int processResult = 0;
@@ -2929,6 +3865,18 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
         return -2;
     }
 
+    // Overlap loading, encoding and saving when a list of images is processed
+    std::unique_ptr<CmdLinePipeline> pipeline;
+    if ((g_CmdPrams.pipelineDepth > 0) && (g_CmdPrams.SourceFileList.size() > 0) && !p_userMipSetIn && !IsProcessingBRLG(g_CmdPrams) &&
+        !g_CmdPrams.compressImagesFromGLTF && !g_CmdPrams.analysis && !g_CmdPrams.diffImage && !g_CmdPrams.imageprops)
+    {
+        std::vector<std::string> sourceFiles;
+        sourceFiles.push_back(g_CmdPrams.SourceFile);
+        sourceFiles.insert(sourceFiles.end(), g_CmdPrams.SourceFileList.begin(), g_CmdPrams.SourceFileList.end());
+
+        pipeline.reset(new CmdLinePipeline(sourceFiles, g_CmdPrams.pipelineDepth, (size_t)g_CmdPrams.pipelineMemoryMB * 1024 * 1024));
+    }
+
     do
     {
         // Initailize stats data and defaults for repeated use in do while()!
@@ -3179,14 +4127,16 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
 
             conversion_loopStartTime = timeStampsec();
 
-            for (CMP_MipSet& srcMipSet : srcMipSets)
-            {
-                MipSet      destMipSet   = {};
-                std::string destFileName = g_CmdPrams.DestFile;
+            //================================
+            // Allocate destination MipSets
+            //================================
 
-                //================================
-                // Allocate destination MipSet
-                //================================
+            destMipSets.resize(srcMipSets.size());
+
+            for (size_t streamIndex = 0; streamIndex < srcMipSets.size(); ++streamIndex)
+            {
+                CMP_MipSet& srcMipSet  = srcMipSets[streamIndex];
+                MipSet&     destMipSet = destMipSets[streamIndex];
 
                 if (!compressingToBRLG && srcMipSet.m_transcodeFormat != CMP_FORMAT_Unknown)
                     destMipSet.m_format = srcMipSet.m_transcodeFormat;
@@ -3232,39 +4182,39 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
                     destDataSize = destMipSet.m_nWidth * destMipSet.m_nHeight * destChannelCount;
 
                 g_CMIPS->AllocateCompressedMipLevelData(destMipLevel, destMipSet.m_nWidth, destMipSet.m_nHeight, destDataSize);
+            }
 
-                //================================
-                // Lossless processing
-                //================================
-
-                CMP_Texture srcTexture  = MipSetToTexture(srcMipSet, 0);
-                CMP_Texture destTexture = MipSetToTexture(destMipSet, 0);
-
-                g_CmdPrams.CompressOptions.DestFormat = destFormat = destMipSet.m_format;
+            //================================
+            // Lossless processing
+            //================================
 
-                CMP_ERROR brlgResult = CMP_OK;
+            // Every stream is independent, so packages are processed concurrently, one stream per worker
+            std::vector<CMP_Texture> destTextures(destMipSets.size());
 
+            if (!ProcessBRLGStreams(srcMipSets, destMipSets, destTextures, compressingToBRLG, g_CmdPrams.CompressOptions, pFeedbackProc))
+            {
                 if (compressingToBRLG)
-                    brlgResult = CodecCompressTexture(&srcTexture, &destTexture, &g_CmdPrams.CompressOptions, pFeedbackProc);
+                    PrintInfo("ERROR: Failed to compress data to Brotli-G format.\n");
                 else
-                    brlgResult = CodecDecompressTexture(&srcTexture, &destTexture, &g_CmdPrams.CompressOptions, pFeedbackProc);
+                    PrintInfo("ERROR: Failed to decompress data from Brotli-G format.\n");
 
-                if (brlgResult != CMP_OK)
-                {
-                    if (compressingToBRLG)
-                        PrintInfo("ERROR: Failed to compress data to Brotli-G format.\n");
-                    else
-                        PrintInfo("ERROR: Failed to decompress data from Brotli-G format.\n");
+                DeallocateMipSets(srcMipSets);
+                DeallocateMipSets(destMipSets);
+
+                return -1;
+            }
 
-                    DeallocateMipSets(srcMipSets);
-                    DeallocateMipSets(destMipSets);
+            for (size_t streamIndex = 0; streamIndex < srcMipSets.size(); ++streamIndex)
+            {
+                CMP_MipSet& srcMipSet    = srcMipSets[streamIndex];
+                MipSet&     destMipSet   = destMipSets[streamIndex];
+                std::string destFileName = g_CmdPrams.DestFile;
 
-                    return -1;
-                }
+                g_CmdPrams.CompressOptions.DestFormat = destFormat = destMipSet.m_format;
 
                 // A little bit of configuration to make sure everything saves properly
 
-                destMipSet.dwDataSize = destTexture.dwDataSize;
+                destMipSet.dwDataSize = destTextures[streamIndex].dwDataSize;
 
                 if (!compressingToBRLG)
                 {
@@ -3352,7 +4302,6 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
                 if (!g_CmdPrams.silent)
                     PrintInfo("Processed size: %d bytes\n", destMipSet.dwDataSize);
 
-                destMipSets.push_back(std::move(destMipSet));
                 destFileNames.push_back(std::move(destFileName));
             }
 
@@ -3384,7 +4333,7 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
                 }
                 else  // standard saving of a single destination
                 {
-                    if (AMDSaveMIPSTextureImage(destFileName.c_str(), &destMipSet, false, g_CmdPrams.CompressOptions) != 0)
+                    if (AMDSaveMIPSTextureImage(destFileName.c_str(), &destMipSet, false, g_CmdPrams.CompressOptions, g_CmdPrams.FileSaveParams.c_str()) != 0)
                     {
                         LogErrorToCSVFile(ANALYSIS_FAILED_FILESAVE);
                         PrintInfo("Error: Saving file '%s' failed. Write permission denied or format is unsupported for the file extension.\n",
@@ -3570,7 +4519,20 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
                 if (!g_CmdPrams.silent)
                     PrintInfo("Processing source     : %s\n", g_CmdPrams.SourceFile.c_str());
 
-                if (AMDLoadMIPSTextureImage(g_CmdPrams.SourceFile.c_str(), &g_MipSetIn, g_CmdPrams.use_OCV, &g_pluginManager) != 0)
+                int loadResult;
+                if (pipeline)
+                {
+                    if (!pipeline->TakeSource(g_CmdPrams.SourceFile, &g_MipSetIn, &loadResult))
+                    {
+                        // Not a prefetched file (such as an intermediate transcode file), make sure it has been saved first
+                        pipeline->FlushSaves();
+                        loadResult = pipeline->Load(g_CmdPrams.SourceFile, &g_MipSetIn, g_CMIPS);
+                    }
+                }
+                else
+                    loadResult = AMDLoadMIPSTextureImage(g_CmdPrams.SourceFile.c_str(), &g_MipSetIn, g_CmdPrams.use_OCV, &g_pluginManager);
+
+                if (loadResult != 0)
                 {
                     LogErrorToCSVFile(ANALYSIS_FAILED_FILELOAD);
                     cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
@@ -3687,7 +4649,7 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
                             p_MipSetOut->m_nBlockHeight = g_CmdPrams.BlockHeight;
                             p_MipSetOut->m_nBlockDepth  = g_CmdPrams.BlockDepth;
 
-                            if (AMDSaveMIPSTextureImage(g_CmdPrams.DestFile.c_str(), &g_MipSetCmp, g_CmdPrams.use_OCV_out, g_CmdPrams.CompressOptions) != 0)
+                            if (AMDSaveMIPSTextureImage(g_CmdPrams.DestFile.c_str(), &g_MipSetCmp, g_CmdPrams.use_OCV_out, g_CmdPrams.CompressOptions, g_CmdPrams.FileSaveParams.c_str()) != 0)
                             {
                                 PrintInfo("Error: saving image failed, write permission denied or format is unsupported for the file extension.\n");
                                 cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
@@ -3732,6 +4694,23 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
                 }
             }
 
+            //=====================================================
+            // Apply FidelityFX effects to the source image
+            // ===================================================
+            if (!p_userMipSetIn && (g_CmdPrams.useCAS || (g_CmdPrams.fsrScale > 0.0f)))
+            {
+                if (g_MipSetIn.m_ChannelFormat == CF_Compressed)
+                {
+                    if (!g_CmdPrams.silent)
+                        PrintInfo("-CAS and -FSR are not supported for compressed images so they will be skipped.\n");
+                }
+                else if (!ApplyFxFilter(&g_MipSetIn))
+                {
+                    cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
+                    return -1;
+                }
+            }
+
             CMP_BOOL isGPUEncoding = !((g_CmdPrams.CompressOptions.nEncodeWith == CMP_Compute_type::CMP_CPU) ||
                                        (g_CmdPrams.CompressOptions.nEncodeWith == CMP_Compute_type::CMP_UNKNOWN) ||
                                        (g_CmdPrams.CompressOptions.nEncodeWith == CMP_Compute_type::CMP_HPC));
@@ -3787,6 +4766,7 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
                     CFilterParam.nFilterType        = 0;
                     CFilterParam.nMinSize           = nMinSize;
                     CFilterParam.fGammaCorrection   = g_CmdPrams.CompressOptions.fInputFilterGamma;
+
                     CMP_GenerateMIPLevelsEx((CMP_MipSet*)&g_MipSetIn, &CFilterParam);
                 }
                 else if (g_CmdPrams.CompressOptions.genGPUMipMaps)
@@ -3921,7 +4901,18 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
                 if (!g_CmdPrams.silent)
                     PrintInfo("\n");
 #endif
-                if (AMDSaveMIPSTextureImage(g_CmdPrams.DestFile.c_str(), &g_MipSetCmp, g_CmdPrams.use_OCV_out, g_CmdPrams.CompressOptions) != 0)
+                if (pipeline && !g_CmdPrams.doDecompress)
+                {
+                    if (!pipeline->QueueSave(g_CmdPrams.DestFile, &g_MipSetCmp, g_CmdPrams.CompressOptions))
+                    {
+                        LogErrorToCSVFile(ANALYSIS_FAILED_FILESAVE);
+                        PrintInfo("Error: Saving image '%s' failed. Write permission denied or format is unsupported for the file extension.\n",
+                                  pipeline->FailedSave().c_str());
+                        cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
+                        return -1;
+                    }
+                }
+                else if (AMDSaveMIPSTextureImage(g_CmdPrams.DestFile.c_str(), &g_MipSetCmp, g_CmdPrams.use_OCV_out, g_CmdPrams.CompressOptions, g_CmdPrams.FileSaveParams.c_str()) != 0)
                 {
                     LogErrorToCSVFile(ANALYSIS_FAILED_FILESAVE);
                     PrintInfo("Error: Saving image '%s' failed. Write permission denied or format is unsupported for the file extension.\n",
@@ -4300,7 +5291,18 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
                 }
 #endif
 
-                if (AMDSaveMIPSTextureImage(g_CmdPrams.DestFile.c_str(), p_MipSetOut, g_CmdPrams.use_OCV_out, g_CmdPrams.CompressOptions) != 0)
+                if (pipeline)
+                {
+                    if (!pipeline->QueueSave(g_CmdPrams.DestFile, p_MipSetOut, g_CmdPrams.CompressOptions))
+                    {
+                        LogErrorToCSVFile(ANALYSIS_FAILED_FILESAVE);
+                        PrintInfo("Error: saving image '%s' failed, write permission denied or format is unsupported for the file extension.\n",
+                                  pipeline->FailedSave().c_str());
+                        cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
+                        return -1;
+                    }
+                }
+                else if (AMDSaveMIPSTextureImage(g_CmdPrams.DestFile.c_str(), p_MipSetOut, g_CmdPrams.use_OCV_out, g_CmdPrams.CompressOptions, g_CmdPrams.FileSaveParams.c_str()) != 0)
                 {
                     LogErrorToCSVFile(ANALYSIS_FAILED_FILESAVE);
                     PrintInfo("Error: saving image failed, write permission denied or format is unsupported for the file extension.\n");
@@ -4378,7 +5380,16 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
 #endif
 
             // Mesh Compression and Decompression
-            if (!(g_CmdPrams.doMeshOptimize && !g_CmdPrams.use_Draco_Encode))
+            if (g_CmdPrams.use_Meshopt_Codec)
+            {
+                if (!(CompressDecompressMeshopt(g_CmdPrams.SourceFile, g_CmdPrams.DestFile)))
+                {
+                    LogErrorToCSVFile(ANALYSIS_MESH_COMPRESSION_FAILED);
+                    PrintInfo("Error: Mesh Compression Failed.\n");
+                    return -1;
+                }
+            }
+            else if (!(g_CmdPrams.doMeshOptimize && !g_CmdPrams.use_Draco_Encode))
             {  // skip mesh decompression for case only meshopt turn on: CompressonatorCLI.exe -meshopt source.gltf/obj dest.gltf/obj
                 if ((IsFileGLTF(g_CmdPrams.SourceFile) && IsFileGLTF(g_CmdPrams.DestFile))
 #ifdef _WIN32
@@ -4425,6 +5436,10 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
 #endif
             }
 
+            // The analysis reads back the destination file
+            if (pipeline)
+                pipeline->FlushSaves();
+
             CMP_ANALYSIS_DATA analysisData = {0};
             analysisData.SSIM              = -1;  // Set data content is invalid and not processed
 
@@ -4540,6 +5555,20 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet* p_userMipSetIn)
 
     processedFileList.clear();
 
+    if (pipeline)
+    {
+        if (!pipeline->FlushSaves())
+        {
+            LogErrorToCSVFile(ANALYSIS_FAILED_FILESAVE);
+            PrintInfo("Error: Saving image '%s' failed. Write permission denied or format is unsupported for the file extension.\n",
+                      pipeline->FailedSave().c_str());
+            processResult = -1;
+        }
+
+        if (!g_CmdPrams.silent)
+            pipeline->PrintTimings();
+    }
+
     //===================
     // Final Log Summary
     //===================
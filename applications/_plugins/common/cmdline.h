@@ -58,7 +58,10 @@ public:
         use_OCV_out                                = false;
         use_noMipMaps                              = false;
         use_Draco_Encode                           = false;
+        use_Meshopt_Codec                          = false;
         doMeshOptimize                             = false;
+        nMeshLODs                                  = 0;
+        shareMeshLODVertices                       = false;
         dwWidth                                    = 0;
         dwHeight                                   = 0;
         nMinSize                                   = 0;
@@ -81,6 +84,7 @@ public:
         logresultsToFile                           = true;
         CompressOptions.format_support_hostEncoder = false;
         memset(&CompressOptions, 0, sizeof(CompressOptions));
+        memset(&WorkerStats, 0, sizeof(WorkerStats));
         CompressOptions.dwSize            = sizeof(CompressOptions);
         CompressOptions.nCompressionSpeed = (CMP_Speed)CMP_Speed_Normal;
         CompressOptions.dwnumThreads      = 0;
@@ -114,11 +118,24 @@ public:
         CompressOptions.doDeltaEncodeBRLG  = false;
         CompressOptions.doSwizzleBRLG      = false;
 
+        CompressOptions.nKTX2ZstdLevel       = 0;
+        CompressOptions.fRDOLambda           = 0.0f;
+        CompressOptions.fRDOMaxErrorIncrease = 0.0f;
+
         compressImagesFromGLTF = false;
 
         mangleFileNames = false;
         packageBRLG     = false;
 
+        pipelineDepth    = 0;
+        pipelineMemoryMB = 1024;
+
+        profile = false;
+
+        useCAS      = false;
+        fsrScale    = 0.0f;
+        fxSharpness = -1.0f;
+
         LogProcessResultsFile.assign(LOG_PROCESS_RESULTS_FILE_TXT);
     }
 
@@ -133,7 +150,9 @@ public:
     std::string              FileFilter;             //
     std::string              FileOutExt;             // Usage with dest dir or unsupported file
     std::string              LogProcessResultsFile;  //
+    std::string              FileSaveParams;         // File save options of the destination image plugin, such as RLE for TGA
     CMP_CompressOptions      CompressOptions;        //
+    KernelWorkerStats        WorkerStats;            // CPU worker stats of the HPC pipeline
     CMP_DWORD                dwWidth;                // Source Width
     CMP_DWORD                dwHeight;               // Source Height
     CMP_DWORD                dwDataSize;             // Source Data Size in Bytes
@@ -153,7 +172,10 @@ public:
     bool                     showperformance;   //
     bool                     noprogressinfo;    //
     bool                     doMeshOptimize;    //  mesh optimization
+    int                      nMeshLODs;         //  number of LODs generated by mesh optimization including the full mesh, 0 = none
+    bool                     shareMeshLODVertices;  //  generated LODs index the vertex buffer of the full mesh
     bool                     use_Draco_Encode;  //  draco compression
+    bool                     use_Meshopt_Codec;  //  lossless meshoptimizer vertex/index codec: obj->cmsh, cmsh->obj
     bool                     use_noMipMaps;     //  use of image loads based on Open CV Components in place of raw image plugins for write to file
     bool                     use_WIC;           //  use of image loads based on Windows Imagaing Components in place of raw image plugins for read from file
     bool                     use_OCV;           //  use of image loads based on Open CV Components in place of raw image plugins  for read from file
@@ -173,6 +195,16 @@ public:
     bool mangleFileNames;  // Flag for whether to mangle the output file names (by appending the compression codec type and file extension), false by default
     bool packageBRLG;      // Flag for combining files into a single BRLG data stream
 
+    int pipelineDepth;     // Number of files to load ahead and queue for saving when processing a list of files, 0 processes them one at a time
+    int pipelineMemoryMB;  // Limit on loaded and unsaved image data held by the pipeline
+
+    bool        profile;           // Print the time spent in each processing stage when done
+    std::string profileTraceFile;  // Chrome trace JSON file for the stage timings, empty for none
+
+    bool  useCAS;       // Sharpen the source image with FidelityFX CAS before processing
+    float fsrScale;     // Upscale the source image with FidelityFX FSR by this factor before processing, 0 is off
+    float fxSharpness;  // Sharpness for -CAS and the RCAS pass of -FSR, negative uses the effect default
+
     // Analysis data
     double SSIM;  // Structural Similarity Index: Average of RGB Channels
     double PSNR;  // Peak Signal to Noise Ratio: Average of RGB Channels
@@ -258,6 +258,7 @@ bool CMP_IsHidden(const std::string& fullPath)
     sfs::path path(fullPath);
     if (path.filename().string().find(".") == 0)
         return true;
+    return false;
 #else
     return false;
 #endif
@@ -66,6 +66,30 @@ public:
     virtual int TC_PluginFileSaveTexture(const char* pszFilename, MipSet* pMipSet)         = 0;
     virtual int TC_PluginFileLoadTexture(const char* pszFilename, CMP_Texture* srcTexture) = 0;
     virtual int TC_PluginFileSaveTexture(const char* pszFilename, CMP_Texture* srcTexture) = 0;
+
+    // Optional: plugins that have file level settings (such as supercompression) pick them up from the save options
+    virtual int TC_PluginSetOptions(const CMP_CompressOptions* pOptions)
+    {
+        (void)pOptions;
+        return 0;
+    }
+
+    // Optional: plugins with file save options read them from a string of space separated words, such as "RLE" for TGA.
+    // The options apply to the saves made by this instance.
+    virtual int TC_PluginSetFileSaveParams(const char* pszTextParams)
+    {
+        (void)pszTextParams;
+        return 0;
+    }
+
+    // Optional: plugins that can decode a texture already held in memory, returns non zero if not supported
+    virtual int TC_PluginMemoryLoadTexture(const void* pBuffer, size_t size, MipSet* pMipSet)
+    {
+        (void)pBuffer;
+        (void)size;
+        (void)pMipSet;
+        return -1;
+    }
 };
 
 class PluginInterface_Analysis : PluginBase
@@ -156,6 +180,13 @@ public:
     virtual CMP_ERROR TC_GetPerformanceStats(void* pPerfStats)                                                                           = 0;
     virtual CMP_ERROR TC_GetDeviceInfo(void* pDeviceInfo)                                                                                = 0;
     virtual int       TC_Close()                                                                                                         = 0;
+
+    // Optional, only pipelines that run CPU worker threads report them
+    virtual CMP_ERROR TC_GetWorkerStats(void* pWorkerStats)
+    {
+        (void)pWorkerStats;
+        return CMP_ERR_NOPERFSTATS;
+    }
 };
 
 class PluginInterface_GPUDecode : PluginBase
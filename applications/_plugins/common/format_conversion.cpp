@@ -25,9 +25,16 @@
 //=====================================================================
 #include <assert.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "compressonator.h"
 #include "atiformats.h"
+#include "cmp_profiler.h"
 #include "format_conversion.h"
+#include "halfconvert.h"
 
 FloatParams::FloatParams(const CMP_AnalysisData* analysisData)
     : FloatParams()
@@ -147,6 +154,8 @@ ConvertedBuffer CreateCompatibleBuffer(CMP_FORMAT         targetFormat,
                                        CMP_DWORD          srcHeight,
                                        const FloatParams* params)
 {
+    CMP_PROFILE_SCOPE("Format conversion");
+
     // TODO: We assume the formats have 4 channels, but we should actually calculate the number of channels
     static const int numChannels = 4;
 
@@ -345,6 +354,104 @@ static float FindKneeValue(float x, float y)
     return (f0 + f1) / 2.f;
 }
 
+// Precomputed constants for the exposure, knee and gamma mapping done by FloatToByte
+struct FloatToByteMapping
+{
+    float defog;
+    float exposeScale;
+    float kl;
+    float f;
+    float invGamma;
+    float gamma;
+    float scale;
+
+    explicit FloatToByteMapping(const FloatParams* params)
+    {
+        const float luminance3f = powf(2, -3.5);  // always assume max intensity is 1 and 3.5f darker for scale later
+
+        defog       = params->defog;
+        exposeScale = powf(2, params->exposure + 2.47393f);
+        kl          = powf(2.f, params->kneeLow);
+        f           = FindKneeValue(powf(2.f, params->kneeHigh) - kl, powf(2.f, 3.5f) - kl);
+        invGamma    = 1 / params->gamma;  //for gamma correction
+        gamma       = params->gamma;
+        scale       = (float)255.0 * powf(luminance3f, invGamma);
+    }
+
+    // Maps a single channel value to a display byte, color channels use invGamma and alpha uses gamma
+    inline CMP_BYTE Map(float v, float power) const
+    {
+        //  1) Compensate for fogging by subtracting defog
+        //     from the raw pixel values.
+        // We assume a defog of 0
+        if (defog > 0.0)
+            v = v - defog;
+
+        //  2) Multiply the defogged pixel values by
+        //     2^(exposure + 2.47393).
+        v = v * exposeScale;
+
+        //  3) Values that are now 1.0 are called "middle gray".
+        //     If defog and exposure are both set to 0.0, then
+        //     middle gray corresponds to a raw pixel value of 0.18.
+        //     In step 6, middle gray values will be mapped to an
+        //     intensity 3.5 f-stops below the display's maximum
+        //     intensity.
+
+        //  4) Apply a knee function.  The knee function has two
+        //     parameters, kneeLow and kneeHigh.  Pixel values
+        //     below 2^kneeLow are not changed by the knee
+        //     function.  Pixel values above kneeLow are lowered
+        //     according to a logarithmic curve, such that the
+        //     value 2^kneeHigh is mapped to 2^3.5.  (In step 6,
+        //     this value will be mapped to the the display's
+        //     maximum intensity.)
+        if (v > kl)
+            v = kl + Knee(v - kl, f);
+
+        //  5) Gamma-correct the pixel values, according to the
+        //     screen's gamma.  (We assume that the gamma curve
+        //     is a simple power function.)
+        v = powf(v, power);
+
+        //  6) Scale the values such that middle gray pixels are
+        //     mapped to a frame buffer value that is 3.5 f-stops
+        //     below the display's maximum intensity.
+        v *= scale;
+
+        return (CMP_BYTE)Clamp(v, 0.f, 255.f);
+    }
+};
+
+// Images with fewer pixels than this are converted on the calling thread only
+#define FLOAT_TO_BYTE_MIN_PARALLEL_PIXELS (256 * 256)
+// Number of rows converted by each job
+#define FLOAT_TO_BYTE_ROWS_PER_JOB 16
+
+// Runs job(0) .. job(numJobs - 1) on all processor cores, including the calling thread
+template <typename Job>
+static void RunFloatToByteJobs(unsigned int numJobs, Job job)
+{
+    std::atomic<unsigned int> nextJob(0);
+
+    auto worker = [&]() {
+        unsigned int jobIndex;
+        while ((jobIndex = nextJob++) < numJobs)
+            job(jobIndex);
+    };
+
+    unsigned int numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < std::min(numThreads, numJobs); ++i)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (std::thread& thread : workers)
+        thread.join();
+}
+
 CMP_ERROR FloatToByte(CMP_BYTE* outBuffer, CMP_FLOAT* inBuffer, CMP_ChannelFormat channelFormat, CMP_DWORD width, CMP_DWORD height, const FloatParams* params)
 {
     assert(outBuffer);
@@ -356,46 +463,85 @@ CMP_ERROR FloatToByte(CMP_BYTE* outBuffer, CMP_FLOAT* inBuffer, CMP_ChannelForma
     if (!outBuffer)
         return CMP_ERR_INVALID_DEST_TEXTURE;
 
-    CMP_FLOAT* floatData     = inBuffer;
-    CMP_HALF*  halfFloatData = (CMP_HALF*)inBuffer;
-    CMP_DWORD* pixelData     = (CMP_DWORD*)inBuffer;
+    const FloatToByteMapping mapping(params);
 
-    const float kl          = powf(2.f, params->kneeLow);
-    const float f           = FindKneeValue(powf(2.f, params->kneeHigh) - kl, powf(2.f, 3.5f) - kl);
-    const float luminance3f = powf(2, -3.5);      // always assume max intensity is 1 and 3.5f darker for scale later
-    const float invGamma    = 1 / params->gamma;  //for gamma correction
-    const float scale       = (float)255.0 * powf(luminance3f, invGamma);
+    // Every 16-bit float value maps to a fixed byte, so for larger images it is cheaper to map all 65536 of them once
+    // than to run the knee and gamma curves on each channel of each pixel
+    std::vector<CMP_BYTE> halfColorTable;
+    std::vector<CMP_BYTE> halfAlphaTable;
+    bool                  useHalfTable = (channelFormat == CF_Float16) && ((size_t)width * height * 4 > 2 * 65536);
 
-    int outIndex = 0;
-    for (unsigned int y = 0; y < height; ++y)
+    if (useHalfTable)
     {
-        for (unsigned int x = 0; x < width; ++x)
+        halfColorTable.resize(65536);
+        halfAlphaTable.resize(65536);
+
+        RunFloatToByteJobs(256, [&](unsigned int job) {
+            for (unsigned int bits = job * 256; bits < (job + 1) * 256; ++bits)
+            {
+                CMP_HALF h;
+                h.setBits((unsigned short)bits);
+                halfColorTable[bits] = mapping.Map((float)h, mapping.invGamma);
+                halfAlphaTable[bits] = mapping.Map((float)h, mapping.gamma);
+            }
+        });
+    }
+
+    auto convertRows = [&](unsigned int yStart, unsigned int yEnd) {
+        const size_t rowStart = (size_t)yStart * width;
+        const size_t rowEnd   = (size_t)yEnd * width;
+        CMP_BYTE*    out      = outBuffer + rowStart * 4;
+
+        if (channelFormat == CF_Float16)
         {
-            float r = 0, g = 0, b = 0, a = 0;
+            const unsigned short* halfData = (const unsigned short*)inBuffer + rowStart * 4;
 
-            if (channelFormat == CF_Float16)
+            if (useHalfTable)
             {
-                r = (float)(*halfFloatData);
-                ++halfFloatData;
-                g = (float)(*halfFloatData);
-                ++halfFloatData;
-                b = (float)(*halfFloatData);
-                ++halfFloatData;
-                a = (float)(*halfFloatData);
-                ++halfFloatData;
+                for (size_t i = rowStart; i < rowEnd; ++i)
+                {
+                    *out++ = halfColorTable[*halfData++];
+                    *out++ = halfColorTable[*halfData++];
+                    *out++ = halfColorTable[*halfData++];
+                    *out++ = halfAlphaTable[*halfData++];
+                }
             }
-            else if (channelFormat == CF_Float32)
+            else
             {
-                r = (float)(*floatData);
-                ++floatData;
-                g = (float)(*floatData);
-                ++floatData;
-                b = (float)(*floatData);
-                ++floatData;
-                a = (float)(*floatData);
-                ++floatData;
+                for (size_t i = rowStart; i < rowEnd; ++i)
+                {
+                    CMP_HALF h[4];
+                    for (int c = 0; c < 4; ++c)
+                        h[c].setBits(*halfData++);
+
+                    *out++ = mapping.Map((float)h[0], mapping.invGamma);
+                    *out++ = mapping.Map((float)h[1], mapping.invGamma);
+                    *out++ = mapping.Map((float)h[2], mapping.invGamma);
+                    *out++ = mapping.Map((float)h[3], mapping.gamma);
+                }
+            }
+        }
+        else if (channelFormat == CF_Float32)
+        {
+            const CMP_FLOAT* floatData = inBuffer + rowStart * 4;
+
+            for (size_t i = rowStart; i < rowEnd; ++i)
+            {
+                *out++ = mapping.Map(floatData[0], mapping.invGamma);
+                *out++ = mapping.Map(floatData[1], mapping.invGamma);
+                *out++ = mapping.Map(floatData[2], mapping.invGamma);
+                *out++ = mapping.Map(floatData[3], mapping.gamma);
+                floatData += 4;
             }
-            else if (channelFormat == CF_Float9995E)
+        }
+        else if (channelFormat == CF_Float9995E)
+        {
+            const CMP_DWORD* pixelData = (const CMP_DWORD*)inBuffer + rowStart;
+
+            // alpha is always 1.0
+            const CMP_BYTE byteA = mapping.Map(1.0f, mapping.gamma);
+
+            for (size_t i = rowStart; i < rowEnd; ++i)
             {
                 union
                 {
@@ -410,83 +556,41 @@ CMP_ERROR FloatToByte(CMP_BYTE* outBuffer, CMP_FLOAT* inBuffer, CMP_ChannelForma
 
                 helper.i = 0x33800000 + (e << 23);
 
-                r = helper.f * (float)rm;
-                g = helper.f * (float)gm;
-                b = helper.f * (float)bm;
-                a = 1.0f;
+                *out++ = mapping.Map(helper.f * (float)rm, mapping.invGamma);
+                *out++ = mapping.Map(helper.f * (float)gm, mapping.invGamma);
+                *out++ = mapping.Map(helper.f * (float)bm, mapping.invGamma);
+                *out++ = byteA;
 
                 ++pixelData;
             }
+        }
+        else
+        {
+            // unsupported formats map to black, as a zero source pixel would
+            const CMP_BYTE byteRGB = mapping.Map(0.0f, mapping.invGamma);
+            const CMP_BYTE byteA   = mapping.Map(0.0f, mapping.gamma);
 
-            //  1) Compensate for fogging by subtracting defog
-            //     from the raw pixel values.
-            // We assume a defog of 0
-            if (params->defog > 0.0)
+            for (size_t i = rowStart; i < rowEnd; ++i)
             {
-                r = r - params->defog;
-                g = g - params->defog;
-                b = b - params->defog;
-                a = a - params->defog;
+                *out++ = byteRGB;
+                *out++ = byteRGB;
+                *out++ = byteRGB;
+                *out++ = byteA;
             }
-
-            //  2) Multiply the defogged pixel values by
-            //     2^(exposure + 2.47393).
-            const float exposeScale = powf(2, params->exposure + 2.47393f);
-            r                       = r * exposeScale;
-            g                       = g * exposeScale;
-            b                       = b * exposeScale;
-            a                       = a * exposeScale;
-
-            //  3) Values that are now 1.0 are called "middle gray".
-            //     If defog and exposure are both set to 0.0, then
-            //     middle gray corresponds to a raw pixel value of 0.18.
-            //     In step 6, middle gray values will be mapped to an
-            //     intensity 3.5 f-stops below the display's maximum
-            //     intensity.
-
-            //  4) Apply a knee function.  The knee function has two
-            //     parameters, kneeLow and kneeHigh.  Pixel values
-            //     below 2^kneeLow are not changed by the knee
-            //     function.  Pixel values above kneeLow are lowered
-            //     according to a logarithmic curve, such that the
-            //     value 2^kneeHigh is mapped to 2^3.5.  (In step 6,
-            //     this value will be mapped to the the display's
-            //     maximum intensity.)
-            if (r > kl)
-                r = kl + Knee(r - kl, f);
-            if (g > kl)
-                g = kl + Knee(g - kl, f);
-            if (b > kl)
-                b = kl + Knee(b - kl, f);
-            if (a > kl)
-                a = kl + Knee(a - kl, f);
-
-            //  5) Gamma-correct the pixel values, according to the
-            //     screen's gamma.  (We assume that the gamma curve
-            //     is a simple power function.)
-            r = powf(r, invGamma);
-            g = powf(g, invGamma);
-            b = powf(b, invGamma);
-            a = powf(a, params->gamma);
-
-            //  6) Scale the values such that middle gray pixels are
-            //     mapped to a frame buffer value that is 3.5 f-stops
-            //     below the display's maximum intensity.
-            r *= scale;
-            g *= scale;
-            b *= scale;
-            a *= scale;
-
-            CMP_BYTE byteR = (CMP_BYTE)Clamp(r, 0.f, 255.f);
-            CMP_BYTE byteG = (CMP_BYTE)Clamp(g, 0.f, 255.f);
-            CMP_BYTE byteB = (CMP_BYTE)Clamp(b, 0.f, 255.f);
-            CMP_BYTE byteA = (CMP_BYTE)Clamp(a, 0.f, 255.f);
-
-            outBuffer[outIndex++] = byteR;
-            outBuffer[outIndex++] = byteG;
-            outBuffer[outIndex++] = byteB;
-            outBuffer[outIndex++] = byteA;
         }
+    };
+
+    if ((size_t)width * height < FLOAT_TO_BYTE_MIN_PARALLEL_PIXELS)
+    {
+        convertRows(0, height);
+    }
+    else
+    {
+        unsigned int numJobs = (height + FLOAT_TO_BYTE_ROWS_PER_JOB - 1) / FLOAT_TO_BYTE_ROWS_PER_JOB;
+        RunFloatToByteJobs(numJobs, [&](unsigned int job) {
+            unsigned int yStart = job * FLOAT_TO_BYTE_ROWS_PER_JOB;
+            convertRows(yStart, std::min(yStart + FLOAT_TO_BYTE_ROWS_PER_JOB, (unsigned int)height));
+        });
     }
 
     return CMP_OK;
@@ -512,10 +616,7 @@ CMP_ERROR HalfShortToFloat(CMP_FLOAT* outBuffer, CMP_HALFSHORT* inBuffer, CMP_DW
     if (!outBuffer)
         return CMP_ERR_INVALID_DEST_TEXTURE;
 
-    for (CMP_DWORD i = 0; i < numElements; i++)
-    {
-        outBuffer[i] = HalfShortToFloat(inBuffer[i]);
-    }
+    CMP_HalfToFloatN(outBuffer, (const unsigned short*)inBuffer, numElements);
 
     return CMP_OK;
 }
@@ -538,10 +639,7 @@ CMP_ERROR FloatToHalfShort(CMP_HALFSHORT* outBuffer, CMP_FLOAT* inBuffer, CMP_DW
     if (!outBuffer)
         return CMP_ERR_INVALID_DEST_TEXTURE;
 
-    for (CMP_DWORD i = 0; i < numElements; i++)
-    {
-        outBuffer[i] = CMP_HALF(inBuffer[i]).bits();
-    }
+    CMP_FloatToHalfN((unsigned short*)outBuffer, inBuffer, numElements);
 
     return CMP_OK;
 }
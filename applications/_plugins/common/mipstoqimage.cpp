@@ -38,6 +38,16 @@ QImage* MIPS2QImage(CMIPS*, MipSet*, int, int, CMP_CompressOptions, CMP_Feedback
 
 #include <QImage>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define MIPS2QIMAGE_SIMD_SSE2
+#endif
+
 #ifdef _DEBUG
 #pragma comment(lib, "Qt5Cored.lib")
 #pragma comment(lib, "Qt5Guid.lib")
@@ -194,63 +204,49 @@ int QImage2MIPS(QImage* image, CMIPS* m_CMips, MipSet* pMipSet, CMP_Feedback_Pro
     pMipSet->m_nMipLevels = 1;
     m_CMips->AllocateMipLevelData(mipLevel, pMipSet->m_nWidth, pMipSet->m_nHeight, pMipSet->m_ChannelFormat, pMipSet->m_TextureDataType);
 
+    // Mono, grayscale and indexed images are expanded once so that every scanline can be read as QRgb values
+    QImage argbImage;
+    if ((format == QImage::Format_Mono) || (format == QImage::Format_Grayscale8) || (format == QImage::Format_Indexed8))
+    {
+        argbImage = image->convertToFormat(QImage::Format_ARGB32);
+        image     = &argbImage;
+    }
+
+    // The alpha byte of Format_RGB32 is undefined, pixel() used to return it as 255
+    const QRgb alphaMask = (format == QImage::Format_RGB32) ? 0xff000000 : 0;
+    const bool swizzle   = pMipSet->m_swizzle;
+    const int  width     = image->width();
+    const int  height    = image->height();
+
     // We have allocated a data buffer to fill get its referance
     CMP_BYTE* pData = (CMP_BYTE*)(mipLevel->m_pbData);
-    QRgb      qRGB;
-    int       i = 0;
 
-    if (pMipSet->m_swizzle)
+    for (int y = 0; y < height; y++)
     {
-        for (int y = 0; y < image->height(); y++)
-        {
-            for (int x = 0; x < image->width(); x++)
-            {
-                qRGB     = image->pixel(x, y);
-                pData[i] = qBlue(qRGB);
-                i++;
-                pData[i] = qGreen(qRGB);
-                i++;
-                pData[i] = qRed(qRGB);
-                i++;
-                pData[i] = qAlpha(qRGB);
-                i++;
-            }
+        const QRgb* row = (const QRgb*)image->constScanLine(y);
+        CMP_BYTE*   dst = pData + (size_t)y * width * 4;
 
-            if (pFeedbackProc)
-            {
-                float fProgress = 100.f * (y * image->width()) / (image->width() * image->height());
-                if (pFeedbackProc(fProgress, NULL, NULL))
-                    return -1;
-            }
-        }
-        pMipSet->m_swizzle = false;  //already swizzled; reset
-    }
-    else
-    {
-        for (int y = 0; y < image->height(); y++)
+        for (int x = 0; x < width; x++)
         {
-            for (int x = 0; x < image->width(); x++)
-            {
-                qRGB     = image->pixel(x, y);
-                pData[i] = qRed(qRGB);
-                i++;
-                pData[i] = qGreen(qRGB);
-                i++;
-                pData[i] = qBlue(qRGB);
-                i++;
-                pData[i] = qAlpha(qRGB);
-                i++;
-            }
+            QRgb qRGB = row[x] | alphaMask;
+            dst[0]    = swizzle ? qBlue(qRGB) : qRed(qRGB);
+            dst[1]    = qGreen(qRGB);
+            dst[2]    = swizzle ? qRed(qRGB) : qBlue(qRGB);
+            dst[3]    = qAlpha(qRGB);
+            dst += 4;
+        }
 
-            if (pFeedbackProc)
-            {
-                float fProgress = 100.f * (y * image->width()) / (image->width() * image->height());
-                if (pFeedbackProc(fProgress, NULL, NULL))
-                    return -1;
-            }
+        if (pFeedbackProc)
+        {
+            float fProgress = 100.f * (y * width) / (width * height);
+            if (pFeedbackProc(fProgress, NULL, NULL))
+                return -1;
         }
     }
 
+    if (swizzle)
+        pMipSet->m_swizzle = false;  //already swizzled; reset
+
     return 0;
 }
 
@@ -266,6 +262,112 @@ CMP_BYTE CMP_SBYTE_to_UBYTE(CMP_SBYTE value)
     return (value + 128);
 }
 
+// Images with fewer pixels than this are converted on the calling thread only
+#define MIPS2QIMAGE_MIN_PARALLEL_PIXELS (256 * 256)
+// Number of rows converted between progress updates
+#define MIPS2QIMAGE_ROWS_PER_BAND 256
+
+// Calls convertRow(y, row) for every row of image, where row points at the start of the scanline.
+// Large images are converted in bands of rows, with the rows of each band split across all processor cores.
+// pFeedbackProc is only called on the calling thread, between bands. Returns false if the conversion was cancelled.
+template <typename RowFunc>
+static bool ConvertScanLines(QImage* image, CMP_Feedback_Proc pFeedbackProc, RowFunc convertRow)
+{
+    // bits() can detach the image, so the scanline addresses are resolved once here instead of on each thread
+    uchar*       bits         = image->bits();
+    const size_t bytesPerLine = image->bytesPerLine();
+    const int    height       = image->height();
+
+    unsigned int numThreads = 1;
+    if ((size_t)image->width() * height >= MIPS2QIMAGE_MIN_PARALLEL_PIXELS)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int bandStart = 0; bandStart < height; bandStart += MIPS2QIMAGE_ROWS_PER_BAND)
+    {
+        const int        bandEnd = std::min(bandStart + MIPS2QIMAGE_ROWS_PER_BAND, height);
+        std::atomic<int> nextRow(bandStart);
+
+        auto worker = [&]() {
+            int y;
+            while ((y = nextRow++) < bandEnd)
+                convertRow(y, bits + y * bytesPerLine);
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned int i = 1; i < std::min(numThreads, (unsigned int)(bandEnd - bandStart)); ++i)
+            workers.emplace_back(worker);
+
+        worker();
+
+        for (std::thread& thread : workers)
+            thread.join();
+
+        if (pFeedbackProc)
+        {
+            float fProgress = 100.f * bandEnd / height;
+            if (pFeedbackProc(fProgress, NULL, NULL))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// Converts a row of RR GG BB AA pixels to QImage::Format_ARGB32, which stores each pixel as a native 0xAARRGGBB
+static void RGBA8888RowToARGB32(QRgb* dst, const CMP_BYTE* src, int width, bool isFixedAlpha)
+{
+    int x = 0;
+
+#ifdef MIPS2QIMAGE_SIMD_SSE2
+    // Little endian, so each source pixel reads as 0xAABBGGRR and only the R and B bytes have to be swapped
+    const __m128i maskAG    = _mm_set1_epi32(0xff00ff00);
+    const __m128i maskLow   = _mm_set1_epi32(0x000000ff);
+    const __m128i fixedMask = _mm_set1_epi32(isFixedAlpha ? 0xff000000 : 0);
+
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(src + x * 4));
+        __m128i ag     = _mm_and_si128(pixels, maskAG);
+        __m128i r      = _mm_slli_epi32(_mm_and_si128(pixels, maskLow), 16);
+        __m128i b      = _mm_and_si128(_mm_srli_epi32(pixels, 16), maskLow);
+        __m128i argb   = _mm_or_si128(_mm_or_si128(ag, fixedMask), _mm_or_si128(r, b));
+        _mm_storeu_si128((__m128i*)(dst + x), argb);
+    }
+#endif
+
+    for (; x < width; ++x)
+    {
+        const CMP_BYTE* pixel = src + x * 4;
+        dst[x]                = qRgba(pixel[0], pixel[1], pixel[2], isFixedAlpha ? 255 : pixel[3]);
+    }
+}
+
+// Converts a row of RR GG BB pixels to QImage::Format_ARGB32, the pixels are opaque
+static void RGB888RowToARGB32(QRgb* dst, const CMP_BYTE* src, int width)
+{
+    for (int x = 0; x < width; ++x)
+    {
+        dst[x] = qRgb(src[0], src[1], src[2]);
+        src += 3;
+    }
+}
+
+// Converts a row of 16 bit RGB or RGBA pixels to QImage::Format_ARGB32, pixels without alpha are opaque
+static void RGBA16RowToARGB32(QRgb* dst, const CMP_WORD* src, int width, bool isRGBA, bool isFixedAlpha)
+{
+    const int srcChannels = isRGBA ? 4 : 3;
+
+    for (int x = 0; x < width; ++x)
+    {
+        CMP_BYTE R = src[0] / 257;
+        CMP_BYTE G = src[1] / 257;
+        CMP_BYTE B = src[2] / 257;
+        CMP_BYTE A = (isRGBA && !isFixedAlpha) ? src[3] / 257 : 255;
+        dst[x]     = qRgba(R, G, B, A);
+        src += srcChannels;
+    }
+}
+
 //load data byte in mipset into Qimage ARGB32 format
 // TODO: A lot of this could probabaly be reworked and removed in favor of using the functions in format_conversion.h
 QImage* MIPS2QImage(CMIPS* m_CMips, MipSet* tmpMipSet, int mipmapLevel, int depthLevel, CMP_CompressOptions option, CMP_Feedback_Proc pFeedbackProc)
@@ -368,36 +470,15 @@ QImage* MIPS2QImage(CMIPS* m_CMips, MipSet* tmpMipSet, int mipmapLevel, int dept
             }
 
             // Initialize the buffer
-            CMP_BYTE R, G, B, A;
-            int      i = 0;
-            for (int y = 0; y < mipLevel->m_nHeight; y++)
+            const int    width     = mipLevel->m_nWidth;
+            const size_t srcStride = (size_t)width * (isRGBA ? 4 : 3);
+
+            if (!ConvertScanLines(image, pFeedbackProc, [&](int y, uchar* row) {
+                    RGBA16RowToARGB32((QRgb*)row, pData + y * srcStride, width, isRGBA, isFixedAlpha);
+                }))
             {
-                for (int x = 0; x < mipLevel->m_nWidth; x++)
-                {
-                    R = pData[i] / 257;
-                    i++;
-                    G = pData[i] / 257;
-                    i++;
-                    B = pData[i] / 257;
-                    i++;
-                    if (isRGBA)
-                    {
-                        if (isFixedAlpha)
-                            A = 255;
-                        else
-                            A = pData[i] / 257;
-                        i++;
-                    }
-                    else
-                        A = 255;
-                    image->setPixel(x, y, qRgba(R, G, B, A));
-                }
-                if (pFeedbackProc)
-                {
-                    float fProgress = 100.f * (y * mipLevel->m_nWidth) / (mipLevel->m_nWidth * mipLevel->m_nHeight);
-                    if (pFeedbackProc(fProgress, NULL, NULL))
-                        return NULL;
-                }
+                delete image;
+                return NULL;
             }
         }
         else if (tmpMipSet->m_ChannelFormat == CF_1010102)
@@ -478,92 +559,52 @@ QImage* MIPS2QImage(CMIPS* m_CMips, MipSet* tmpMipSet, int mipmapLevel, int dept
             }
 
             // Initialize the buffer
+            const int    width     = mipLevel->m_nWidth;
+            const size_t srcStride = (size_t)width * (isRGBA ? 4 : 3);
+            bool         converted;
+
             if (tmpMipSet->m_format == CMP_FORMAT_RGBA_8888_S)
             {
-                CMP_SBYTE* pData = mipLevel->m_psbData;
-                CMP_SBYTE  R, G, B, A;
-                CMP_FLOAT  nR, nG, nB, nA;
-                CMP_BYTE   bR, bG, bB, bA;
-                int        i = 0;
-                for (int y = 0; y < mipLevel->m_nHeight; y++)
+                // Covert from SNORM -> UINT, the view shows the signed formats as opaque
+                CMP_BYTE snormToByte[256];
+                for (int value = -128; value < 128; value++)
                 {
-                    for (int x = 0; x < mipLevel->m_nWidth; x++)
-                    {
-                        R = pData[i];
-                        i++;
-                        G = pData[i];
-                        i++;
-                        B = pData[i];
-                        i++;
-
-                        if (isRGBA)
-                        {
-                            if (isFixedAlpha)
-                                A = 127;
-                            else
-                                A = pData[i];
-                            i++;
-                        }
-                        else
-                            A = 127;
-
-                        // Normalize signed int
-                        nR = R / 127.0f;
-                        nG = G / 127.0f;
-                        nB = B / 127.0f;
-                        nA = A / 127.0f;
-
-                        // Covert from SNORM -> UINT
-                        bR = ((nR * 0.5) + 0.5) * 255.0f;
-                        bG = ((nG * 0.5) + 0.5) * 255.0f;
-                        bB = ((nB * 0.5) + 0.5) * 255.0f;
-                        bA = 255;
-
-                        //CMP_SBYTE_to_UBYTE(A);
-                        image->setPixel(x, y, qRgba(bR, bG, bB, 255));
-                    }
-                    if (pFeedbackProc)
+                    // Normalize signed int, -128 is clamped to -1.0
+                    CMP_FLOAT normalized = value / 127.0f;
+                    double    unorm      = ((normalized * 0.5) + 0.5) * 255.0f;
+
+                    snormToByte[(CMP_BYTE)value] = (unorm < 0.0) ? 0 : (CMP_BYTE)unorm;
+                }
+
+                const CMP_BYTE* pData       = (const CMP_BYTE*)mipLevel->m_psbData;
+                const int       srcChannels = isRGBA ? 4 : 3;
+
+                converted = ConvertScanLines(image, pFeedbackProc, [&](int y, uchar* row) {
+                    QRgb*           dst = (QRgb*)row;
+                    const CMP_BYTE* src = pData + y * srcStride;
+                    for (int x = 0; x < width; x++)
                     {
-                        float fProgress = 100.f * (y * mipLevel->m_nWidth) / (mipLevel->m_nWidth * mipLevel->m_nHeight);
-                        if (pFeedbackProc(fProgress, NULL, NULL))
-                            return NULL;
+                        dst[x] = qRgba(snormToByte[src[0]], snormToByte[src[1]], snormToByte[src[2]], 255);
+                        src += srcChannels;
                     }
-                }
+                });
             }
             else
             {
-                CMP_BYTE* pData = mipLevel->m_pbData;
-                CMP_BYTE  R, G, B, A;
-                int       i = 0;
-                for (int y = 0; y < mipLevel->m_nHeight; y++)
-                {
-                    for (int x = 0; x < mipLevel->m_nWidth; x++)
-                    {
-                        R = pData[i];
-                        i++;
-                        G = pData[i];
-                        i++;
-                        B = pData[i];
-                        i++;
-                        if (isRGBA)
-                        {
-                            if (isFixedAlpha)
-                                A = 255;
-                            else
-                                A = pData[i];
-                            i++;
-                        }
-                        else
-                            A = 255;
-                        image->setPixel(x, y, qRgba(R, G, B, A));
-                    }
-                    if (pFeedbackProc)
-                    {
-                        float fProgress = 100.f * (y * mipLevel->m_nWidth) / (mipLevel->m_nWidth * mipLevel->m_nHeight);
-                        if (pFeedbackProc(fProgress, NULL, NULL))
-                            return NULL;
-                    }
-                }
+                const CMP_BYTE* pData = mipLevel->m_pbData;
+
+                converted = ConvertScanLines(image, pFeedbackProc, [&](int y, uchar* row) {
+                    if (isRGBA)
+                        RGBA8888RowToARGB32((QRgb*)row, pData + y * srcStride, width, isFixedAlpha);
+                    else
+                        RGB888RowToARGB32((QRgb*)row, pData + y * srcStride, width);
+                });
+            }
+
+            if (!converted)
+            {
+                delete image;
+                return NULL;
             }
         }
     }
@@ -598,36 +639,15 @@ QImage* MIPS2QImage(CMIPS* m_CMips, MipSet* tmpMipSet, int mipmapLevel, int dept
             }
 
             // Initialize the buffer
-            CMP_BYTE R, G, B, A;
-            int      i = 0;
-            for (int y = 0; y < mipLevel->m_nHeight; y++)
+            const int    width     = mipLevel->m_nWidth;
+            const size_t srcStride = (size_t)width * (isRGBA ? 4 : 3);
+
+            if (!ConvertScanLines(image, pFeedbackProc, [&](int y, uchar* row) {
+                    RGBA16RowToARGB32((QRgb*)row, pData + y * srcStride, width, isRGBA, isFixedAlpha);
+                }))
             {
-                for (int x = 0; x < mipLevel->m_nWidth; x++)
-                {
-                    R = pData[i] / 257;
-                    i++;
-                    G = pData[i] / 257;
-                    i++;
-                    B = pData[i] / 257;
-                    i++;
-                    if (isRGBA)
-                    {
-                        if (isFixedAlpha)
-                            A = 255;
-                        else
-                            A = pData[i] / 257;
-                        i++;
-                    }
-                    else
-                        A = 255;
-                    image->setPixel(x, y, qRgba(R, G, B, A));
-                }
-                if (pFeedbackProc)
-                {
-                    float fProgress = 100.f * (y * mipLevel->m_nWidth) / (mipLevel->m_nWidth * mipLevel->m_nHeight);
-                    if (pFeedbackProc(fProgress, NULL, NULL))
-                        return NULL;
-                }
+                delete image;
+                return NULL;
             }
         }
     }
@@ -29,10 +29,35 @@
 
 #include <stdarg.h>
 #include <stdio.h>
+#include <string>
 #include "modeldata.h"
 #include <assert.h>
 #include "tc_plugininternal.h"
 
+#ifdef USE_MESHOPTIMIZER
+CMP_Mesh GetMeshLOD(const CMP_Mesh& mesh, size_t nLOD)
+{
+    assert((nLOD > 0) && (nLOD <= mesh.lods.size()));
+
+    const CMP_MeshLOD& lod = mesh.lods[nLOD - 1];
+
+    CMP_Mesh result;
+    result.vertices = lod.vertices.empty() ? mesh.vertices : lod.vertices;
+    result.indices  = lod.indices;
+    return result;
+}
+
+std::string GetMeshLODFileName(const std::string& fileName, size_t nLOD)
+{
+    size_t dotPos   = fileName.rfind('.');
+    size_t slashPos = fileName.find_last_of("/\\");
+    if ((dotPos == std::string::npos) || ((slashPos != std::string::npos) && (dotPos < slashPos)))
+        dotPos = fileName.size();
+
+    return fileName.substr(0, dotPos) + "_LOD" + std::to_string(nLOD) + fileName.substr(dotPos);
+}
+#endif
+
 CMODEL_DATA::CMODEL_DATA()
 {
 #ifdef USE_ASSIMP
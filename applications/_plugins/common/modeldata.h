@@ -57,6 +57,7 @@ struct CMP_DracoOptions
         use_metadata                 = false;
         m_bDecode                    = false;
         m_bLoadedMesh                = true;
+        use_meshopt_codec            = false;
     };
 
     bool        is_point_cloud;                // forces the input to be encoded as a point
@@ -73,6 +74,7 @@ struct CMP_DracoOptions
     std::string output;             // output file name
     bool        m_bDecode;          // false = Encode the mesh, true = decode the mesh data, default is Encode
     bool        m_bLoadedMesh;      // Loaded a mesh data struct from file!
+    bool        use_meshopt_codec;  // use the lossless meshoptimizer vertex/index codec on a CMP_Mesh instead of Draco: larger output, much faster decode
 };
 
 struct CMP_NMCOptions
@@ -184,11 +186,25 @@ struct Vertex
     }
 };
 
+// A simplified level of detail of a CMP_Mesh
+struct CMP_MeshLOD
+{
+    std::vector<Vertex>       vertices;  // empty if the LOD indexes the vertex buffer of the CMP_Mesh it belongs to
+    std::vector<unsigned int> indices;
+};
+
 struct CMP_Mesh
 {
     std::vector<Vertex>       vertices;
     std::vector<unsigned int> indices;
+    std::vector<CMP_MeshLOD>  lods;  // LOD 1 and coarser, filled in by the mesh optimizer when LOD generation is enabled
 };
+
+// Returns LOD nLOD (1 = first simplified LOD) of mesh with its own vertex buffer, for saving each LOD to its own file
+CMP_Mesh GetMeshLOD(const CMP_Mesh& mesh, size_t nLOD);
+
+// Returns the file name LOD nLOD of a mesh is saved to: "dir/mesh.obj" -> "dir/mesh_LOD1.obj"
+std::string GetMeshLODFileName(const std::string& fileName, size_t nLOD);
 #endif
 
 class CMODEL_DATA
@@ -33,9 +33,11 @@
 
 #ifdef _WIN32
 #include <windows.h>
+#define PLUGIN_EXPORT __declspec(dllexport)
 #else
 typedef int  HWND;
 typedef int* GUID;
+#define PLUGIN_EXPORT __attribute__((visibility("default")))
 #endif
 
 //===========================================================================================
@@ -76,42 +78,42 @@ typedef enum
 //#define DECLARE_PLUGIN(x)     extern "C"{__declspec(dllexport) std::unique_ptr<x> makePlugin()  { return std::move(std::make_unique<x>()); }}
 #define DECLARE_PLUGIN(x)                    \
     extern "C" {                             \
-    __declspec(dllexport) void* makePlugin() \
+    PLUGIN_EXPORT void* makePlugin()         \
     {                                        \
         return new x;                        \
     }                                        \
     }
 #define SET_PLUGIN_TYPE(x)                      \
     extern "C" {                                \
-    __declspec(dllexport) char* getPluginType() \
+    PLUGIN_EXPORT char* getPluginType()         \
     {                                           \
         return x;                               \
     }                                           \
     }
 #define SET_PLUGIN_NAME(x)                      \
     extern "C" {                                \
-    __declspec(dllexport) char* getPluginName() \
+    PLUGIN_EXPORT char* getPluginName()         \
     {                                           \
         return x;                               \
     }                                           \
     }
 #define SET_PLUGIN_UUID(x)                      \
     extern "C" {                                \
-    __declspec(dllexport) char* getPluginUUID() \
+    PLUGIN_EXPORT char* getPluginUUID()         \
     {                                           \
         return x;                               \
     }                                           \
     }
 #define SET_PLUGIN_CATEGORY(x)                      \
     extern "C" {                                    \
-    __declspec(dllexport) char* getPluginCategory() \
+    PLUGIN_EXPORT char* getPluginCategory()         \
     {                                               \
         return x;                                   \
     }                                               \
     }
 #define SET_PLUGIN_OPTIONS(x)                              \
     extern "C" {                                           \
-    __declspec(dllexport) unsigned long getPluginOptions() \
+    PLUGIN_EXPORT unsigned long getPluginOptions()         \
     {                                                      \
         return x;                                          \
     }                                                      \
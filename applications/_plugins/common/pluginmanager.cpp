@@ -30,8 +30,14 @@
 #ifdef _WIN32
 #include <windows.h>
 #define USE_NewLoader
+#else
+#include <dirent.h>
+#include <dlfcn.h>
+#include <limits.h>
+#include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <string>
 
 #ifdef USE_NewLoader
@@ -232,6 +238,39 @@ void PluginManager::getPluginDetails(PluginDetails* curPlugin)
 
         FreeLibrary(dllHandle);
     }
+#else
+    void* dllHandle = dlopen(curPlugin->getFileName(), RTLD_NOW | RTLD_LOCAL);
+
+    if (dllHandle != NULL)
+    {
+        PLUGIN_TEXTFUNC textFunc;
+        textFunc = reinterpret_cast<PLUGIN_TEXTFUNC>(dlsym(dllHandle, "getPluginType"));
+        if (textFunc)
+            curPlugin->setType(textFunc());
+
+        textFunc = reinterpret_cast<PLUGIN_TEXTFUNC>(dlsym(dllHandle, "getPluginName"));
+        if (textFunc)
+            curPlugin->setName(textFunc());
+
+        textFunc = reinterpret_cast<PLUGIN_TEXTFUNC>(dlsym(dllHandle, "getPluginUUID"));
+        if (textFunc)
+            curPlugin->setUUID(textFunc());
+
+        textFunc = reinterpret_cast<PLUGIN_TEXTFUNC>(dlsym(dllHandle, "getPluginCategory"));
+        if (textFunc)
+            curPlugin->setCategory(textFunc());
+
+        PLUGIN_ULONGFUNC ulongFunc;
+        ulongFunc = reinterpret_cast<PLUGIN_ULONGFUNC>(dlsym(dllHandle, "getPluginOptions"));
+        if (ulongFunc)
+            curPlugin->setOptions(ulongFunc());
+        else
+            curPlugin->setOptions(0);
+
+        curPlugin->isRegistered = true;
+
+        dlclose(dllHandle);
+    }
 #endif
 }
 
@@ -486,6 +525,72 @@ void PluginManager::getPluginList(char* SubFolderName, bool append)
     } while (FindNextFileA(hFind, &fd));
 
     FindClose(hFind);
+#else
+    //----------------------------------
+    // Load plugin List for processing
+    // Use the AMDCOMPRESS_PLUGINS enviornment var
+    // or the SubFolderName of the app running folder.
+    //----------------------------------
+    std::string dirPath;
+    const char* pPath = getenv("AMDCOMPRESS_PLUGINS");
+
+    if (pPath && (strlen(pPath) > 0))
+    {
+        dirPath = pPath;
+    }
+    else
+    {
+        char    exePath[PATH_MAX];
+        ssize_t pathsize = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+        if (pathsize <= 0)
+            return;
+        exePath[pathsize] = 0;
+
+        // Callers pass the sub folder with Windows separators
+        std::string subFolder = SubFolderName;
+        std::replace(subFolder.begin(), subFolder.end(), '\\', '/');
+
+        dirPath = exePath;
+        dirPath = dirPath.substr(0, dirPath.find_last_of('/'));
+        if (!subFolder.empty() && (subFolder[0] != '/'))
+            dirPath += '/';
+        dirPath += subFolder;
+    }
+
+    DIR* dir = opendir(dirPath.c_str());
+    if (dir == NULL)
+    {
+        // Plugins are installed in a lower case folder
+        std::transform(dirPath.begin(), dirPath.end(), dirPath.begin(), ::tolower);
+        dir = opendir(dirPath.c_str());
+        if (dir == NULL)
+            return;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        size_t nameLen = strlen(entry->d_name);
+        if ((nameLen <= 3) || (strcmp(entry->d_name + nameLen - 3, ".so") != 0))
+            continue;
+
+        std::string fname     = dirPath + "/" + entry->d_name;
+        void*       dllHandle = dlopen(fname.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (dllHandle == NULL)
+            continue;
+
+        // Is this library a plugin for us if so keep its type and name details
+        if (dlsym(dllHandle, "makePlugin") != NULL)
+        {
+            PluginDetails* curPlugin = new PluginDetails();
+            curPlugin->setFileName(&fname[0]);
+            getPluginDetails(curPlugin);
+            pluginRegister.push_back(curPlugin);
+        }
+        dlclose(dllHandle);
+    }
+
+    closedir(dir);
 #endif
 }
 
@@ -539,6 +644,8 @@ unsigned long PluginManager::getPluginOption(int index)
 
 void* PluginManager::GetPlugin(char* type, const char* name)
 {
+    std::lock_guard<std::mutex> lock(m_lookupMutex);
+
     if (!m_pluginlistset)
     {
         getPluginList(DEFAULT_PLUGINLIST_DIR);
@@ -561,6 +668,8 @@ void* PluginManager::GetPlugin(char* type, const char* name)
 
 bool PluginManager::RemovePlugin(char* type, char* name)
 {
+    std::lock_guard<std::mutex> lock(m_lookupMutex);
+
     if (!m_pluginlistset)
     {
         getPluginList(DEFAULT_PLUGINLIST_DIR);
@@ -583,6 +692,8 @@ bool PluginManager::RemovePlugin(char* type, char* name)
 
 void* PluginManager::GetPlugin(char* uuid)
 {
+    std::lock_guard<std::mutex> lock(m_lookupMutex);
+
     if (!m_pluginlistset)
     {
         getPluginList(DEFAULT_PLUGINLIST_DIR);
@@ -608,6 +719,9 @@ bool PluginManager::PluginSupported(char* type, char* name)
         return false;
     if (!name)
         return false;
+
+    std::lock_guard<std::mutex> lock(m_lookupMutex);
+
     if (!m_pluginlistset)
     {
         getPluginList(DEFAULT_PLUGINLIST_DIR);
@@ -701,6 +815,9 @@ PluginDetails::~PluginDetails()
 #ifdef _WIN32
     if (dllHandle)
         FreeLibrary(dllHandle);
+#else
+    if (dllHandle)
+        dlclose(dllHandle);
 #endif
     clearMembers();
 }
@@ -775,6 +892,19 @@ void* PluginDetails::makeNewInstance()
                 return funcHandle();
             }
         }
+#else
+        // Plugin instances can outlive the plugin list, keep the code mapped after dlclose
+        if (!dllHandle)
+            dllHandle = dlopen(filename, RTLD_NOW | RTLD_LOCAL | RTLD_NODELETE);
+
+        if (dllHandle != NULL)
+        {
+            funcHandle = reinterpret_cast<PLUGIN_FACTORYFUNC>(dlsym(dllHandle, "makePlugin"));
+            if (funcHandle != NULL)
+            {
+                return funcHandle();
+            }
+        }
 #endif
     }
     return NULL;
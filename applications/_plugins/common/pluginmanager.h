@@ -41,6 +41,7 @@
 #include <direct.h>
 #endif
 #include <vector>
+#include <mutex>
 
 #include "pluginbase.h"
 
@@ -99,9 +100,7 @@ public:
 private:
     void clearMembers()
     {
-#ifdef _WIN32
-        dllHandle = NULL;
-#endif
+        dllHandle    = NULL;
         isStatic     = false;
         isRegistered = false;
 
@@ -123,6 +122,8 @@ private:
 
 #ifdef _WIN32
     HINSTANCE dllHandle;
+#else
+    void* dllHandle;
 #endif
 };
 
@@ -156,6 +157,9 @@ private:
     void                        clearPluginList();
     bool                        fileExists(const std::string& abs_filename);
     std::vector<PluginDetails*> pluginRegister;
+
+    // Plugin details are filled in on first use, this guards the lookups made from worker threads
+    std::mutex m_lookupMutex;
 };
 
 #endif
@@ -33,6 +33,8 @@
 #include "pluginmanager.h"
 #include "cmp_plugininterface.h"
 #include "atiformats.h"
+#include "cmp_profiler.h"
+#include "cmp_swizzle.h"
 
 #include <gpu_decode.h>
 
@@ -538,23 +540,6 @@ MipSet* DecompressMIPSet(MipSet* MipSetIn, CMP_GPUDecode decodeWith, Config* con
     return MipSetOut;
 }
 
-void swap_Bytes(CMP_BYTE* src, int width, int height, int offset)
-{
-    int      i, j;
-    CMP_BYTE b;
-
-    for (i = 0; i < height; i++)
-    {
-        for (j = 0; j < width; j++)
-        {
-            b          = *src;          // hold 1st byte
-            *src       = *(src + 2);    // move 1st to offsetrd
-            *(src + 2) = b;             // save offset to 1st
-            src        = src + offset;  // move to next set of bytes
-        }
-    }
-}
-
 void SwizzleMipSet(MipSet* pMipSet)
 {
     if (pMipSet->m_ChannelFormat == CF_Compressed)
@@ -580,24 +565,7 @@ void SwizzleMipSet(MipSet* pMipSet)
 
             CMP_DWORD bytesPerChannel = GetChannelFormatBitSize(pMipSet->m_format) / 8;
 
-            CMP_BYTE* redChannel  = data;
-            CMP_BYTE* blueChannel = data + 2 * bytesPerChannel;
-
-            for (uint32_t y = 0; y < height; ++y)
-            {
-                for (uint32_t x = 0; x < width; ++x)
-                {
-                    for (uint32_t i = 0; i < bytesPerChannel; ++i)
-                    {
-                        CMP_BYTE temp  = redChannel[i];
-                        redChannel[i]  = blueChannel[i];
-                        blueChannel[i] = temp;
-                    }
-
-                    redChannel += bytesPerChannel * numChannels;
-                    blueChannel += bytesPerChannel * numChannels;
-                }
-            }
+            CMP_SwapRedBlueN(data, (size_t)width * height, numChannels, bytesPerChannel);
         }
     }
 }
@@ -663,11 +631,16 @@ QImage* CMP_CreateQImage(const char* SourceFile)
 }
 #endif
 
-int AMDLoadMIPSTextureImage(const char* SourceFile, MipSet* MipSetIn, bool use_OCV, void* pluginManager)
+int AMDLoadMIPSTextureImage(const char* SourceFile, MipSet* MipSetIn, bool use_OCV, void* pluginManager, CMIPS* pCMIPS)
 {
     if (pluginManager == NULL)
         return -1;
 
+    if (pCMIPS == NULL)
+        pCMIPS = g_CMIPS;
+
+    CMP_PROFILE_SCOPE("Load");
+
     PluginInterface_Image* plugin_Image;
 
     PluginManager* plugin_Manager = (PluginManager*)pluginManager;
@@ -690,7 +663,7 @@ int AMDLoadMIPSTextureImage(const char* SourceFile, MipSet* MipSetIn, bool use_O
     // do the load
     if (plugin_Image)
     {
-        plugin_Image->TC_PluginSetSharedIO(g_CMIPS);
+        plugin_Image->TC_PluginSetSharedIO(pCMIPS);
 
         if (plugin_Image->TC_PluginFileLoadTexture(SourceFile, MipSetIn) != 0)
         {
@@ -712,7 +685,7 @@ int AMDLoadMIPSTextureImage(const char* SourceFile, MipSet* MipSetIn, bool use_O
         QImage* qimage = CMP_CreateQImage(SourceFile);
         if (qimage != NULL)
         {
-            result = QImage2MIPS(qimage, g_CMIPS, MipSetIn);
+            result = QImage2MIPS(qimage, pCMIPS, MipSetIn);
             delete qimage;
         }
         return result;
@@ -726,8 +699,10 @@ int AMDLoadMIPSTextureImage(const char* SourceFile, MipSet* MipSetIn, bool use_O
     return 0;
 }
 
-int AMDSaveMIPSTextureImage(const char* DestFile, MipSet* MipSetIn, bool use_OCV, CMP_CompressOptions option)
+int AMDSaveMIPSTextureImage(const char* DestFile, MipSet* MipSetIn, bool use_OCV, CMP_CompressOptions option, const char* pszFileSaveParams)
 {
+    CMP_PROFILE_SCOPE("Save");
+
     bool  filesaved = false;
     CMIPS m_CMIPS;
     m_CMIPS.PrintLine = PrintStatusLine;
@@ -754,6 +729,8 @@ int AMDSaveMIPSTextureImage(const char* DestFile, MipSet* MipSetIn, bool use_OCV
     if (plugin_Image)
     {
         plugin_Image->TC_PluginSetSharedIO(&m_CMIPS);
+        plugin_Image->TC_PluginSetOptions(&option);
+        plugin_Image->TC_PluginSetFileSaveParams(pszFileSaveParams);
 
         bool holdswizzle = MipSetIn->m_swizzle;
 
@@ -113,8 +113,10 @@ extern CMIPS* g_CMIPS;
 bool       IsDestinationUnCompressed(const char* fname);
 CMP_FORMAT FormatByFileExtension(const char* fname, MipSet* pMipSet);
 
-int AMDLoadMIPSTextureImage(const char* SourceFile, MipSet* CMips, bool use_OCV, void* pluginManager);
-int AMDSaveMIPSTextureImage(const char* DestFile, MipSet* CMips, bool use_OCV, CMP_CompressOptions option);
+// pCMIPS is handed to the image plugin, g_CMIPS is used when it is NULL
+int AMDLoadMIPSTextureImage(const char* SourceFile, MipSet* CMips, bool use_OCV, void* pluginManager, CMIPS* pCMIPS = NULL);
+// pszFileSaveParams holds the file save options of the image plugin, see PluginInterface_Image::TC_PluginSetFileSaveParams
+int AMDSaveMIPSTextureImage(const char* DestFile, MipSet* CMips, bool use_OCV, CMP_CompressOptions option, const char* pszFileSaveParams = NULL);
 
 MipSet* DecompressMIPSet(MipSet* MipSetIn, CMP_GPUDecode decodeWith, Config* configSetting, CMP_Feedback_Proc pFeedbackProc);
 
@@ -36,6 +36,7 @@
 
 #include "cmdline.h"
 #include "cmp_fileio.h"
+#include "cmp_profiler.h"
 #include "cmp_plugininterface.h"
 #include "plugininterface.h"
 #include "pluginmanager.h"
@@ -89,6 +90,8 @@ extern void* make_Image_Plugin_BINARY();
 
 #ifdef _WIN32
 extern void* make_Plugin_KTX2();
+#else
+extern void* make_Plugin_CFilterFx();
 #endif
 
 // Setup Static Host Pluging Libs
@@ -139,6 +142,10 @@ void PrintUsage()
     printf("-miplevels  <Level>       Sets Mips Level for output, range is 1 to 20\n");
     printf("                          (mipSize overides this option): default is 1\n");
     printf("-FilterGamma <value>      A gamma correction level to apply after mipmap generation, in the range 1.0 to 2.6\n");
+    printf("-CAS <value>              Sharpen the source image with FidelityFX CAS before mipmap generation, sharpness 0.0 to 1.0\n");
+    printf("                          8 bit images are processed as sRGB when -UseSRGBFrames is set\n");
+    printf("-FSR <value>              Upscale the source image by 1.0 to 4.0 with FidelityFX FSR before mipmap generation\n");
+    printf("                          the RCAS sharpness is set with -CAS, default 0.9\n");
 #ifdef _WIN32
     printf("-GenGPUMipMaps            When encoding with GPU this flag will enable mipmap level generation\n");
     printf("                          using GPU HW. Default level is 1 unless miplevels is set\n");
@@ -175,6 +182,7 @@ void PrintUsage()
     printf("-qgen                Draco quantization bits for generic attribute (0-30), default=8. -draco has to be enabled.\n");
 #endif
 #endif
+    printf("-meshoptcodec        Lossless mesh compression with the meshoptimizer codec (obj->cmsh and cmsh->obj files)\n");
     printf("-UseMangledFileNames Enable file mangling for destination files by appending the source extension and codec type to the file name.\n");
     printf("-doswizzle           Swizzle the source images Red and Blue channels\n");
     printf("-PackageBRLG         Packages all files in a directory and its subdirectories into a single BRLG file output\n");
@@ -308,6 +316,13 @@ void PrintUsage()
         "-DoDeltaEncodeBRLG           Enable delta encoding of colours during Brotli-G preconditioning for BCn textures, might further reduce compressed file "
         "size\n");
 #endif
+    printf("-KTX2Zstd <value>            Zstandard supercompression level (1 to 22) for KTX2 output, default 0 disables supercompression\n");
+    printf("-TGARLE                      Save 24 and 32 bit TGA output files run length encoded\n");
+    printf("-RDOLambda <value>           Trade BC1, BC3, BC4, BC5 and BC7 quality for a smaller size after lossless compression\n");
+    printf("                             (Brotli-G, zstd), try 1 to 32. Default 0 disables it\n");
+    printf("-RDOMaxError <value>         Largest increase of the RMS error of a block, in 8 bit levels, allowed by -RDOLambda, default 1\n");
+    printf("-Pipeline <value>            Number of images to load ahead and queue for saving while compressing a folder, default 0 disables pipelining\n");
+    printf("-PipelineMemory <value>      Maximum size in MB of the images loaded ahead by -Pipeline, default 1024\n");
 #ifdef USE_3DMESH_OPTIMIZE
     printf("-optVCacheSize <value>        Enable vertices optimization with hardware cache size in the value specified. \n");
     printf(
@@ -326,6 +341,9 @@ void PrintUsage()
     printf(
         "                              (Value should be in range 1- no limit as it allows users to simplify the mesh until the level they desired "
         "for experiment purpose. Higher level means less triangles drawn, less details.)\n");
+    printf("-generateMeshLODs <value>     Generate a chain of <value> LODs including the full mesh, each with 70 percent of the triangles of the\n");
+    printf("                              previous one. LOD n is saved to dest_LODn.obj (obj destination files only).\n");
+    printf("-shareMeshLODVertices         Generated LODs index the vertex buffer of the full mesh instead of a compacted copy.\n");
 #endif
     printf("-Analysis <image1> <image2>  Generate analysis metric like SSIM, PSNR values \n");
     printf("                             between 2 images with same size. Analysis_Result.xml file will be generated.\n");
@@ -345,6 +363,9 @@ void PrintUsage()
     printf("-silent                      Disable print messages\n");
     printf("-performance                 Shows various performance stats\n");
     printf("-noprogress                  Disables showing of compression progress messages\n");
+    printf("-Profile                     Print the time spent loading, converting, generating mipmaps, encoding,\n");
+    printf("                             analyzing and saving when done\n");
+    printf("-ProfileTrace <file>         Write the stage times as a Chrome trace JSON file (chrome://tracing, Perfetto)\n");
     printf("\n\n");
     printf("Example compression:\n\n");
 #if (OPTION_BUILD_ASTC == 1)
@@ -385,6 +406,9 @@ void PrintUsage()
     printf("compressonatorcli source.gltf dest.gltf\n");
     printf("compressonatorcli source.drc dest.obj\n");
 #endif
+    printf("Example lossless mesh compression and decompression with the meshoptimizer codec (support OBJ file only):\n\n");
+    printf("compressonatorcli -meshoptcodec source.obj dest.cmsh\n");
+    printf("compressonatorcli -meshoptcodec source.cmsh dest.obj\n\n");
 #ifdef USE_3DMESH_OPTIMIZE
     printf("\n\n");
     printf("Example mesh optimization usage(support glTF and OBJ file only):\n");
@@ -555,6 +579,11 @@ int main(int argc, char* argv[])
     g_pluginManager.registerStaticPlugin("IMAGE", "BINARY", (void*)make_Image_Plugin_BINARY);
 #endif
 
+#ifndef _WIN32
+    // CPU FidelityFX effects, Windows loads the DirectX enabled plugin dll
+    g_pluginManager.registerStaticPlugin("FILTERS", "EFFECTS", (void*)make_Plugin_CFilterFx);
+#endif
+
     g_pluginManager.getPluginList("\\Plugins");
 
     CMP_RegisterHostPlugins();
@@ -680,8 +709,21 @@ int main(int argc, char* argv[])
             return -1;
         }
 
+        bool profile = g_CmdPrams.profile || !g_CmdPrams.profileTraceFile.empty();
+        if (profile)
+            CMP_Profiler_Enable(true);
+
         int ret = ProcessCMDLine(&CompressionCallback, NULL);
 
+        if (profile)
+        {
+            CMP_Profiler_Enable(false);
+            if (g_CmdPrams.profile)
+                CMP_Profiler_PrintSummary(stdout);
+            if (!g_CmdPrams.profileTraceFile.empty() && !CMP_Profiler_WriteTrace(g_CmdPrams.profileTraceFile.c_str()))
+                printf("Error: unable to write profile trace file %s\n", g_CmdPrams.profileTraceFile.c_str());
+        }
+
         delete g_CMIPS;
 
 #ifdef USE_GTC
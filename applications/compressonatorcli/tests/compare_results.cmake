@@ -0,0 +1,21 @@
+# Fails unless every file in EXPECTED_DIR has an identical copy in ACTUAL_DIR
+get_filename_component(EXPECTED_DIR ${EXPECTED_DIR} ABSOLUTE)
+get_filename_component(ACTUAL_DIR ${ACTUAL_DIR} ABSOLUTE)
+
+file(GLOB EXPECTED_FILES RELATIVE ${EXPECTED_DIR} ${EXPECTED_DIR}/*)
+if (NOT EXPECTED_FILES)
+    message(FATAL_ERROR "No results found in ${EXPECTED_DIR}")
+endif()
+
+foreach(RESULT_FILE ${EXPECTED_FILES})
+    if (NOT EXISTS ${ACTUAL_DIR}/${RESULT_FILE})
+        message(FATAL_ERROR "${ACTUAL_DIR}/${RESULT_FILE} was not written")
+    endif()
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} -E compare_files ${EXPECTED_DIR}/${RESULT_FILE} ${ACTUAL_DIR}/${RESULT_FILE}
+        RESULT_VARIABLE COMPARE_RESULT
+    )
+    if (COMPARE_RESULT)
+        message(FATAL_ERROR "${ACTUAL_DIR}/${RESULT_FILE} differs from ${EXPECTED_DIR}/${RESULT_FILE}")
+    endif()
+endforeach()
@@ -111,7 +111,7 @@ acImageView::acImageView(const QString filePathName, QWidget* parent, CMipImages
 
                     if (m_OriginalMipImages)
                     {
-                        image_original           = m_OriginalMipImages->QImage_list[m_depthIndex][m_ImageIndex];
+                        image_original           = m_OriginalMipImages->getImage(m_depthIndex, m_ImageIndex);
                         pixmap_original          = QPixmap::fromImage(*image_original, Qt::NoFormatConversion);
                         m_imageItem_Original     = new acCustomGraphicsImageItem(pixmap_original, NULL);
                         m_imageItem_Original->ID = m_graphicsScene->ID;
@@ -122,7 +122,7 @@ acImageView::acImageView(const QString filePathName, QWidget* parent, CMipImages
                     else
                         m_imageItem_Original = NULL;
 
-                    QImage* image_processed = m_MipImages->QImage_list[m_depthIndex][m_ImageIndex];
+                    QImage* image_processed = m_MipImages->getImage(m_depthIndex, m_ImageIndex);
 
                     if (image_processed != NULL)
                     {
@@ -1484,7 +1484,7 @@ void acImageView::onImageMipLevelChanged(int MipLevel)
         if (m_MipImages->QImage_list[m_depthIndex].size() > MipLevel)
         {
             m_ImageIndex  = MipLevel;
-            QImage* image = m_MipImages->QImage_list[m_depthIndex][m_ImageIndex];
+            QImage* image = m_MipImages->getImage(m_depthIndex, m_ImageIndex);
             if (image)
             {
                 m_imageItem_Processed->changeImage(*image);
@@ -1494,7 +1494,7 @@ void acImageView::onImageMipLevelChanged(int MipLevel)
             {
                 if (m_OriginalMipImages->QImage_list[m_depthIndex].size() > MipLevel)
                 {
-                    QImage* image_original = m_OriginalMipImages->QImage_list[m_depthIndex][m_ImageIndex];
+                    QImage* image_original = m_OriginalMipImages->getImage(m_depthIndex, m_ImageIndex);
                     if (image_original)
                     {
                         m_imageItem_Original->changeImage(*image_original);
@@ -1519,7 +1519,7 @@ void acImageView::onImageDepthChanged(int DepthLevel)
     if (m_MipImages)
     {
         m_depthIndex  = DepthLevel;
-        QImage* image = m_MipImages->QImage_list[DepthLevel][m_ImageIndex];
+        QImage* image = m_MipImages->getImage(DepthLevel, m_ImageIndex);
         if (image)
         {
             m_imageItem_Processed->changeImage(*image);
@@ -1527,7 +1527,7 @@ void acImageView::onImageDepthChanged(int DepthLevel)
 
         if (m_OriginalMipImages)
         {
-            QImage* image_original = m_OriginalMipImages->QImage_list[DepthLevel][m_ImageIndex];
+            QImage* image_original = m_OriginalMipImages->getImage(DepthLevel, m_ImageIndex);
             if (image_original)
             {
                 m_imageItem_Original->changeImage(*image_original);
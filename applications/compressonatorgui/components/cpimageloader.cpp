@@ -171,6 +171,31 @@ CMipImages::CMipImages()
     m_DecompressedFormat = MIPIMAGE_FORMAT_DECOMPRESSED::Format_NONE;
     decompressedMipSet   = NULL;
     errMsg               = "";
+
+    m_options.fInputDefog    = AMD_CODEC_DEFOG_DEFAULT;
+    m_options.fInputExposure = AMD_CODEC_EXPOSURE_DEFAULT;
+    m_options.fInputKneeLow  = AMD_CODEC_KNEELOW_DEFAULT;
+    m_options.fInputKneeHigh = AMD_CODEC_KNEEHIGH_DEFAULT;
+    m_options.fInputGamma    = AMD_CODEC_GAMMA_DEFAULT;
+}
+
+QImage* CMipImages::getImage(int depth, int mipLevel)
+{
+    if ((depth < 0) || (depth >= CMP_MIPSET_MAX_DEPTHS) || (mipLevel < 0) || (mipLevel >= (int)QImage_list[depth].size()))
+        return NULL;
+
+    // Mip levels are only converted when they are first viewed. The progress callback is not used here, as it
+    // processes Qt events and this is called from the view event handlers.
+    if ((QImage_list[depth][mipLevel] == NULL) && mipset)
+    {
+        CMIPS CMips;
+        if (decompressedMipSet)
+            QImage_list[depth][mipLevel] = MIPS2QImage(&CMips, decompressedMipSet, mipLevel, depth, m_options, NULL);
+        else
+            QImage_list[depth][mipLevel] = MIPS2QImage(&CMips, mipset, mipLevel, depth, m_options, NULL);
+    }
+
+    return QImage_list[depth][mipLevel];
 }
 
 // Deletes all allocated CMipImage data
@@ -399,6 +424,8 @@ void CImageLoader::UpdateMIPMapImages(CMipImages* MipImages)
         return;
     QImage* image;
 
+    MipImages->m_options = m_options;
+
     // Note  MipImages->QImage_list[0].count() = 1 single image no cube maps or faces
     int depthMax;
 
@@ -438,21 +465,10 @@ void CImageLoader::UpdateMIPMapImages(CMipImages* MipImages)
             MipImages->QImage_list[depth].push_back(image);
         }
 
-        // We have mip levels to process for this cube face
+        // We have mip levels to process for this cube face, these are created by CMipImages::getImage when they are viewed
         if (count < MipImages->mipset->m_nMipLevels)
         {
-            for (int i = 1; i < MipImages->mipset->m_nMipLevels; i++)
-            {
-                if (MipImages->decompressedMipSet)
-                    image = MIPS2QImage(m_CMips, MipImages->decompressedMipSet, i, depth, m_options, &ProgressCallback);
-                else
-                    image = MIPS2QImage(m_CMips, MipImages->mipset, i, depth, m_options, &ProgressCallback);
-
-                if (image)
-                {
-                    MipImages->QImage_list[depth].push_back(image);
-                }
-            }
+            MipImages->QImage_list[depth].resize(MipImages->mipset->m_nMipLevels, NULL);
         }
     }
 }
@@ -68,10 +68,13 @@ class CMipImages
 {
 public:
     CMipImages();
+    QImage* getImage(int depth, int mipLevel);  // Returns QImage_list[depth][mipLevel], creating the image from the mipset on first use
+
     std::vector<QImage*> QImage_list[CMP_MIPSET_MAX_DEPTHS];  // This is a QImage list mapping of the mipset. Its contains a list of
     // Frames (CubeMaps 0..CMP_MIPSET_MAX_DEPTHS-1) and MipLevel (0..MaxMipLevel) Images
     // for 2D type textures its set to [0][0..MaxMipLevels]
     //     Cubemap textures [0..CMP_MIPSET_MAX_DEPTHS-1][0..MaxMipLevels]
+    // Mip levels below the top one are NULL until they are first viewed, use getImage to access them
     MipSet* mipset;
     MipSet* decompressedMipSet;
 
@@ -80,6 +83,7 @@ public:
     MIPIMAGE_FORMAT_DECOMPRESSED m_DecompressedFormat;
     std::string                  errMsg;
     bool                         MIPS2QtFailed;
+    CMP_CompressOptions          m_options;  // hdr options the deferred mip level images are created with
 };
 
 class CImageLoader
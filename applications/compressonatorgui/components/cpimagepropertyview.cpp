@@ -311,7 +311,8 @@ void CImagePropertyView::OnUpdateData(QObject* data)
                 QFileInfo fi(DestinationOptions->m_modelSource);
                 QString   m_modelext = fi.suffix().toUpper();
                 m_propMeshCompressionSettings->setHidden(m_modelext.compare("OBJ") != 0 && m_modelext.compare("GLTF") != 0);
-                m_holddata->disable_mesh_compression_settings(DestinationOptions->m_Do_Mesh_Compression == C_Destination_Options::eMeshCompression::NoComp);
+                m_holddata->disable_mesh_compression_settings((DestinationOptions->m_Do_Mesh_Compression == C_Destination_Options::eMeshCompression::NoComp) ||
+                                                              (DestinationOptions->m_Do_Mesh_Compression == C_Destination_Options::eMeshCompression::Meshopt));
                 connect(m_data, SIGNAL(onMesh_Compression(QVariant&)), this, SLOT(onMesh_Compression(QVariant&)));
             }
         }
@@ -420,7 +421,8 @@ void CImagePropertyView::onMesh_Compression(QVariant& value)
     if (!m_holddata)
         return;
     C_Destination_Options::eMeshCompression comp = (C_Destination_Options::eMeshCompression&)value;
-    m_holddata->disable_mesh_compression_settings(comp == C_Destination_Options::eMeshCompression::NoComp);
+    m_holddata->disable_mesh_compression_settings((comp == C_Destination_Options::eMeshCompression::NoComp) ||
+                                                  (comp == C_Destination_Options::eMeshCompression::Meshopt));
 }
 
 //===================================================================
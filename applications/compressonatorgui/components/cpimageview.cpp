@@ -1391,12 +1391,16 @@ cpImageView::cpImageView(const QString filePathName,
             {
                 if (processedImage_miplevel_max > num)
                 {
+                    // Mip level images are created when first viewed, so the sizes are taken from the mipset
+                    MipLevel* mipLevel = m_CMips->GetMipLevel(m_processedMipImages->mipset, num);
+                    if (mipLevel == NULL)
+                        continue;
+
                     QString mipLevelList = QString::number(num + 1);
-                    QImage* image        = m_processedMipImages->QImage_list[0][num];
                     mipLevelList.append(QString(" ("));
-                    mipLevelList.append(QString::number(image->width()));
+                    mipLevelList.append(QString::number(mipLevel->m_nWidth));
                     mipLevelList.append(QString("x"));
-                    mipLevelList.append(QString::number(image->height()));
+                    mipLevelList.append(QString::number(mipLevel->m_nHeight));
                     mipLevelList.append(QString(")"));
                     m_CBimageview_MipLevel->addItem(mipLevelList);
                 }
@@ -1801,8 +1805,8 @@ void cpImageView::onSaveViewAs()
                     pMipLevelMipSet->m_dwFourCC        = m_processedMipImages->mipset->m_dwFourCC;
                     pMipLevelMipSet->m_dwFourCC2       = m_processedMipImages->mipset->m_dwFourCC2;
                     pMipLevelMipSet->m_TextureType     = m_processedMipImages->mipset->m_TextureType;
-                    pMipLevelMipSet->m_nWidth          = m_processedMipImages->QImage_list[0][mipLevel]->width();
-                    pMipLevelMipSet->m_nHeight         = m_processedMipImages->QImage_list[0][mipLevel]->height();
+                    pMipLevelMipSet->m_nWidth          = pInMipLevel->m_nWidth;
+                    pMipLevelMipSet->m_nHeight         = pInMipLevel->m_nHeight;
                     pMipLevelMipSet->m_nDepth          = m_processedMipImages->mipset->m_nDepth;  // depthsupport
                     if (pMipLevelMipSet->m_nDepth == 0)
                         pMipLevelMipSet->m_nDepth = 1;
@@ -1812,8 +1816,8 @@ void cpImageView::onSaveViewAs()
                                             pMipLevelMipSet->m_ChannelFormat,
                                             pMipLevelMipSet->m_TextureDataType,
                                             pMipLevelMipSet->m_TextureType,
-                                            m_processedMipImages->QImage_list[0][mipLevel]->width(),
-                                            m_processedMipImages->QImage_list[0][mipLevel]->height(),
+                                            pInMipLevel->m_nWidth,
+                                            pInMipLevel->m_nHeight,
                                             pMipLevelMipSet->m_nDepth);
 
                     // Determin buffer size and set Mip Set Levels we want to use for now
@@ -677,6 +677,8 @@ public:
         ,
         Draco
 #endif
+        ,
+        Meshopt = 2  // lossless meshoptimizer codec, obj only: writes dest.cmsh
     };
 
     Mesh_Compression_Settings()
@@ -716,7 +718,7 @@ public:
     void setDo_Mesh_Compression(eMeshCompression value)
     {
         m_Do_Mesh_Compression = value;
-        disable_mesh_compression_settings(value == eMeshCompression::NoComp);
+        disable_mesh_compression_settings((value == eMeshCompression::NoComp) || (value == eMeshCompression::Meshopt));
         emit onMesh_Compression((QVariant&)value);
     }
 
@@ -845,6 +847,9 @@ class Mesh_Optimizer_Settings : public Mesh_Compression_Settings
     Q_PROPERTY(bool x____Optimize_Vertex_Fetch READ getOptimizeVFetchChecked WRITE setOptimizeVFetchChecked)
     Q_PROPERTY(bool x____Simplify_Mesh READ getMeshSimplifyChecked WRITE setMeshSimplifyChecked)
     Q_PROPERTY(int x________Level_of_Detail READ getLODValue WRITE setLODValue)
+    Q_PROPERTY(bool x____Generate_LODs READ getGenerateLODsChecked WRITE setGenerateLODsChecked)
+    Q_PROPERTY(int x________LOD_Count READ getLODCount WRITE setLODCount)
+    Q_PROPERTY(bool x________Share_LOD_Vertices READ getShareLODVerticesChecked WRITE setShareLODVerticesChecked)
     // Resereved for 3.1 release
     //Q_PROPERTY(bool     x____Randomize_Index_Buffer  READ  getRandomIndexBufferChecked     WRITE setRandomIndexBufferChecked)
 public:
@@ -901,6 +906,15 @@ public:
             if (prop)
                 prop->setHidden(value);
             prop = m_controller->getProperty("        Level of Detail");
+            if (prop)
+                prop->setHidden(value);
+            prop = m_controller->getProperty("    Generate LODs");
+            if (prop)
+                prop->setHidden(value);
+            prop = m_controller->getProperty("        LOD Count");
+            if (prop)
+                prop->setHidden(value);
+            prop = m_controller->getProperty("        Share LOD Vertices");
             if (prop)
                 prop->setHidden(value);
             prop = m_controller->getProperty("    Randomize Index Buffer");
@@ -1059,6 +1073,48 @@ public:
         return m_levelofDetails;
     }
 
+    void setGenerateLODsChecked(bool value)
+    {
+        m_runGenerateLODs = value;
+        if (m_controller)
+        {
+            QtProperty* prop = m_controller->getProperty("        LOD Count");
+            if (prop)
+                prop->setEnabled(value);
+            prop = m_controller->getProperty("        Share LOD Vertices");
+            if (prop)
+                prop->setEnabled(value);
+        }
+    }
+
+    bool getGenerateLODsChecked()
+    {
+        return m_runGenerateLODs;
+    }
+
+    void setLODCount(int value)
+    {  //number of LODs including the full mesh, saved as dest_LOD1.obj, dest_LOD2.obj ...
+        if (value < 2)
+            m_lodCount = 2;
+        else
+            m_lodCount = value;
+    }
+
+    int getLODCount()
+    {
+        return m_lodCount;
+    }
+
+    void setShareLODVerticesChecked(bool value)
+    {
+        m_shareLODVertices = value;
+    }
+
+    bool getShareLODVerticesChecked()
+    {
+        return m_shareLODVertices;
+    }
+
     void setMeshData(CMODEL_DATA& meshData)
     {
         m_ModelData = meshData;
@@ -1081,6 +1137,9 @@ public:
         m_runOptimizeVFetch       = true;
         m_runMeshSimplify         = false;
         m_levelofDetails          = 1;
+        m_runGenerateLODs         = false;
+        m_lodCount                = 4;
+        m_shareLODVertices        = false;
         m_Do_Mesh_Optimization    = eMeshOptimization::AutoOpt;
     }
 
@@ -1100,6 +1159,9 @@ private:
     bool        m_runOptimizeVFetch;
     bool        m_runMeshSimplify;
     int         m_levelofDetails;
+    bool        m_runGenerateLODs;
+    int         m_lodCount;
+    bool        m_shareLODVertices;
     CMODEL_DATA m_ModelData;
 };
 #else
@@ -6475,6 +6475,20 @@ void CompressFiles(QFile* file, ProjectView* ProjectView)
                                             char*           c_ext    = ba.data();
                                             CMP_GLTFCommon* gltfdata = nullptr;
 
+                                            // LODs are saved as separate obj files and share nlevelofDetails with mesh simplification
+                                            if (data->getGenerateLODsChecked())
+                                            {
+                                                if ((strcmp(c_ext, "OBJ") == 0) && !uimeshsettings.bSimplifyMesh)
+                                                {
+                                                    uimeshsettings.bGenerateLODs         = true;
+                                                    uimeshsettings.bShareLODVertexBuffer = data->getShareLODVerticesChecked();
+                                                    uimeshsettings.nlevelofDetails       = data->getLODCount();
+                                                }
+                                                else if (ProjectView->m_CompressStatusDialog)
+                                                    ProjectView->m_CompressStatusDialog->appendText(
+                                                        "[Mesh Optimization] Note: LOD generation needs an obj file and Simplify Mesh turned off.");
+                                            }
+
                                             PluginInterface_3DModel_Loader* m_plugin_loader;
                                             m_plugin_loader =
                                                 reinterpret_cast<PluginInterface_3DModel_Loader*>(g_pluginManager.GetPlugin("3DMODEL_LOADER", c_ext));
@@ -6674,6 +6688,19 @@ void CompressFiles(QFile* file, ProjectView* ProjectView)
                                                         {
                                                             if (plugin_save->SaveModelData(ModelDestination.toStdString().data(), &((*optimized)[0])) != -1)
                                                             {
+                                                                // Each generated LOD goes to its own file next to the destination: dest_LOD1.obj, dest_LOD2.obj ...
+                                                                for (size_t lod = 1; (result == 0) && (lod <= (*optimized)[0].lods.size()); lod++)
+                                                                {
+                                                                    CMP_Mesh    lodMesh = GetMeshLOD((*optimized)[0], lod);
+                                                                    std::string lodFile = GetMeshLODFileName(ModelDestination.toStdString(), lod);
+                                                                    if (plugin_save->SaveModelData(lodFile.c_str(), &lodMesh) == -1)
+                                                                    {
+                                                                        if (ProjectView->m_CompressStatusDialog)
+                                                                            ProjectView->m_CompressStatusDialog->appendText(
+                                                                                "[Mesh Optimization] Failed to save LOD file " + QString::fromStdString(lodFile));
+                                                                        result = -1;
+                                                                    }
+                                                                }
 #ifdef _WIN32
                                                                 if (!(writeObjFileState(ModelDestination.toStdString().data(), CMP_PROCESSED)))
                                                                 {
@@ -6791,8 +6818,97 @@ void CompressFiles(QFile* file, ProjectView* ProjectView)
 
                                 if (data->getDo_Mesh_Compression() != data->NoComp)
                                 {
+                                    // Case: obj -> cmsh lossless meshoptimizer codec
+                                    if (data->getDo_Mesh_Compression() == data->Meshopt)
+                                    {
+                                        if (strcmp(c_ext, "OBJ") != 0)
+                                        {
+                                            if (ProjectView->m_CompressStatusDialog)
+                                                ProjectView->m_CompressStatusDialog->appendText(
+                                                    "[Mesh Compression] Note: Meshopt compression supports obj files only.");
+                                            NumberOfItemCompressedFailed++;
+                                            Imageitem->setIcon(0, QIcon(QStringLiteral(":/compressonatorgui/images/smallredstone.png")));
+                                            g_pProgressDlg->SetValue(0);
+                                            return;
+                                        }
+
+                                        PluginInterface_Mesh* plugin_MeshComp;
+                                        plugin_MeshComp = reinterpret_cast<PluginInterface_Mesh*>(g_pluginManager.GetPlugin("MESH_COMPRESSOR", "DRACO"));
+                                        PluginInterface_3DModel_Loader* plugin_obj;
+                                        plugin_obj = reinterpret_cast<PluginInterface_3DModel_Loader*>(g_pluginManager.GetPlugin("3DMODEL_LOADER", "OBJ"));
+
+                                        if (plugin_MeshComp && plugin_obj && (plugin_MeshComp->Init() == 0))
+                                        {
+                                            plugin_MeshComp->TC_PluginSetSharedIO(g_GUI_CMIPS);
+                                            plugin_obj->TC_PluginSetSharedIO(g_GUI_CMIPS);
+
+                                            CMP_DracoOptions DracoOptions;
+                                            DracoOptions.use_meshopt_codec = true;
+
+                                            // Check if mesh optimization was done if so then source is optimized file
+                                            if (bMeshOptimized)
+                                                DracoOptions.input = ModelDestination.toStdString();
+                                            else
+                                                DracoOptions.input = ModelSource.toStdString();
+
+                                            DracoOptions.output = ModelDestination.toStdString() + ".cmsh";
+
+                                            msgCommandLine =
+                                                "[Mesh Compression] Src: " + QString(DracoOptions.input.c_str()) + " Dst: " + QString(DracoOptions.output.c_str());
+                                            g_pProgressDlg->SetHeader("Processing: Mesh Compression");
+                                            g_pProgressDlg->SetLabelText(msgCommandLine);
+                                            if (ProjectView->m_CompressStatusDialog)
+                                                ProjectView->m_CompressStatusDialog->appendText(msgCommandLine);
+
+                                            void* modelDataOut = nullptr;
+                                            if (plugin_obj->LoadModelData(DracoOptions.input.c_str(), "", &g_pluginManager, NULL, &ProgressCallback) == 0)
+                                            {
+                                                CMODEL_DATA* modelData = (CMODEL_DATA*)plugin_obj->GetModelData();
+                                                if (modelData && (modelData->m_meshData.size() > 0))
+                                                    modelDataOut =
+                                                        plugin_MeshComp->ProcessMesh(&modelData->m_meshData[0], (void*)&DracoOptions, NULL, &ProgressCallback);
+                                            }
+
+                                            if (modelDataOut)
+                                            {
+                                                NumberOfItemCompressed++;
+                                                if (ProjectView->m_CompressStatusDialog)
+                                                    ProjectView->m_CompressStatusDialog->appendText("[Mesh Compression] Done.");
+
+                                                // Update Icon if new file exists
+                                                if (!ProjectView->Tree_updateCompressIcon(Imageitem, QString(DracoOptions.output.c_str()), true))
+                                                    NumberOfItemCompressedFailed++;
+                                            }
+                                            else
+                                            {
+                                                if (ProjectView->m_CompressStatusDialog)
+                                                    ProjectView->m_CompressStatusDialog->appendText("[Mesh Compression] Error in processing mesh.");
+
+                                                NumberOfItemCompressedFailed++;
+                                                Imageitem->setIcon(0, QIcon(QStringLiteral(":/compressonatorgui/images/smallredstone.png")));
+                                            }
+                                            g_pProgressDlg->SetValue(0);
+                                            plugin_MeshComp->CleanUp();
+                                        }
+                                        else
+                                        {
+                                            if (ProjectView->m_CompressStatusDialog)
+                                                ProjectView->m_CompressStatusDialog->appendText("[Mesh Compression] Error in loading mesh compression plugin.");
+                                        }
+
+                                        if (plugin_MeshComp)
+                                        {
+                                            delete plugin_MeshComp;
+                                            plugin_MeshComp = nullptr;
+                                        }
+                                        if (plugin_obj)
+                                        {
+                                            delete plugin_obj;
+                                            plugin_obj = nullptr;
+                                        }
+                                    }
                                     // Case: glTF -> glTF draco compression
-                                    if (strcmp(c_ext, "GLTF") == 0 && strcmp(c_extdst, "GLTF") == 0)
+                                    else if (strcmp(c_ext, "GLTF") == 0 && strcmp(c_extdst, "GLTF") == 0)
                                     {
                                         std::string         err;
                                         tinygltf2::Model    model;
@@ -30,6 +30,7 @@
 
 #include "common.h"
 #include "codec_ati1n.h"
+#include "cmp_blockcache.h"
 
 #ifdef TEST_CMP_CORE_DECODER
 #include "cmp_core.h"
@@ -80,6 +81,9 @@ CodecError CCodec_ATI1N::Compress(CCodecBuffer&       bufferIn,
 
     bool bUseFixed = (!bufferIn.IsFloat() && bufferIn.GetChannelDepth() == 8 && !m_bUseFloat);
 
+    // Uniform and repeated blocks are encoded once
+    CMP_BlockCache blockCache(BLOCK_SIZE_4X4, bUseFixed ? sizeof(CMP_BYTE) : sizeof(float), sizeof(CMP_DWORD) * 2, dwBlocksX * dwBlocksY);
+
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
         for (CMP_DWORD i = 0; i < dwBlocksX; i++)
@@ -92,7 +96,7 @@ CodecError CCodec_ATI1N::Compress(CCodecBuffer&       bufferIn,
                     bufferIn.ReadBlockB(i * 4, j * 4, 4, 4, cAlphaBlock);
                 else
                     bufferIn.ReadBlockR(i * 4, j * 4, 4, 4, cAlphaBlock);
-                CompressAlphaBlock(cAlphaBlock, compressedBlock);
+                blockCache.Encode(cAlphaBlock, compressedBlock, [&]() { CompressAlphaBlock(cAlphaBlock, compressedBlock); });
             }
             else
             {
@@ -101,7 +105,7 @@ CodecError CCodec_ATI1N::Compress(CCodecBuffer&       bufferIn,
                     bufferIn.ReadBlockB(i * 4, j * 4, 4, 4, fAlphaBlock);
                 else
                     bufferIn.ReadBlockR(i * 4, j * 4, 4, 4, fAlphaBlock);
-                CompressAlphaBlock(fAlphaBlock, compressedBlock);
+                blockCache.Encode(fAlphaBlock, compressedBlock, [&]() { CompressAlphaBlock(fAlphaBlock, compressedBlock); });
             }
             bufferOut.WriteBlock(i * 4, j * 4, compressedBlock, 2);
         }
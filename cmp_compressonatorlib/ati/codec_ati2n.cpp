@@ -30,6 +30,7 @@
 
 #include "common.h"
 #include "codec_ati2n.h"
+#include "cmp_blockcache.h"
 
 #ifdef TEST_CMP_CORE_DECODER
 #include "cmp_core.h"
@@ -72,6 +73,9 @@ CodecError CCodec_ATI2N::Compress(CCodecBuffer&       bufferIn,
 
     bool bUseFixed = (!bufferIn.IsFloat() && bufferIn.GetChannelDepth() == 8 && !m_bUseFloat);
 
+    // Uniform and repeated channel blocks are encoded once, both channels share the cache
+    CMP_BlockCache blockCache(BLOCK_SIZE_4X4, bUseFixed ? sizeof(CMP_BYTE) : sizeof(float), sizeof(CMP_DWORD) * 2, dwBlocksX * dwBlocksY * 2);
+
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
         CMP_DWORD compressedBlock[4];
@@ -86,10 +90,10 @@ CodecError CCodec_ATI2N::Compress(CCodecBuffer&       bufferIn,
                 else
                     bufferIn.ReadBlockR(i * 4, j * 4, 4, 4, cAlphaBlock);
 
-                CompressAlphaBlock(cAlphaBlock, &compressedBlock[dwXOffset]);
+                blockCache.Encode(cAlphaBlock, &compressedBlock[dwXOffset], [&]() { CompressAlphaBlock(cAlphaBlock, &compressedBlock[dwXOffset]); });
 
                 bufferIn.ReadBlockG(i * 4, j * 4, 4, 4, cAlphaBlock);
-                CompressAlphaBlock(cAlphaBlock, &compressedBlock[dwYOffset]);
+                blockCache.Encode(cAlphaBlock, &compressedBlock[dwYOffset], [&]() { CompressAlphaBlock(cAlphaBlock, &compressedBlock[dwYOffset]); });
             }
             else
             {
@@ -100,10 +104,10 @@ CodecError CCodec_ATI2N::Compress(CCodecBuffer&       bufferIn,
                 else
                     bufferIn.ReadBlockR(i * 4, j * 4, 4, 4, fAlphaBlock);
 
-                CompressAlphaBlock(fAlphaBlock, &compressedBlock[dwXOffset]);
+                blockCache.Encode(fAlphaBlock, &compressedBlock[dwXOffset], [&]() { CompressAlphaBlock(fAlphaBlock, &compressedBlock[dwXOffset]); });
 
                 bufferIn.ReadBlockG(i * 4, j * 4, 4, 4, fAlphaBlock);
-                CompressAlphaBlock(fAlphaBlock, &compressedBlock[dwYOffset]);
+                blockCache.Encode(fAlphaBlock, &compressedBlock[dwYOffset], [&]() { CompressAlphaBlock(fAlphaBlock, &compressedBlock[dwYOffset]); });
             }
             bufferOut.WriteBlock(i * 4, j * 4, compressedBlock, 4);
         }
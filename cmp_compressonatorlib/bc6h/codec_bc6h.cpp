@@ -33,8 +33,10 @@
 #include "bc6h_library.h"
 #include "bc6h_definitions.h"
 #include "hdr_encode.h"
+#include "cmp_blockcache.h"
 
 #include <chrono>
+#include <vector>
 
 using namespace HDR_Encode;
 
@@ -481,6 +483,11 @@ CodecError CCodec_BC6H::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
     float fProgress;
     float old_fProgress = FLT_MAX;
 
+    // Uniform and repeated blocks are encoded once: the cache holds the output offset of
+    // their first encoding, which is copied once the encoding threads are done
+    CMP_BlockCache                                 blockCache(BLOCK_SIZE_4X4, 4 * sizeof(CMP_FLOAT), sizeof(CMP_DWORD), dwBlocksX * dwBlocksY);
+    std::vector<std::pair<CMP_DWORD, CMP_DWORD> > duplicateBlocks;
+
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
         for (CMP_DWORD i = 0; i < dwBlocksX; i++)
@@ -517,7 +524,9 @@ CodecError CCodec_BC6H::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
             } data;
 
             memset(data.in, 0, sizeof(data));
-            CEncodeBC6HBlock(blockToEncode, pOutBuffer + block);
+            CMP_DWORD firstBlock = block;
+            if (blockCache.Encode(srcBlock, &firstBlock, [&]() { CEncodeBC6HBlock(blockToEncode, pOutBuffer + block); }))
+                duplicateBlocks.push_back(std::make_pair((CMP_DWORD)block, firstBlock));
 
 #ifdef _SAVE_AS_BC6
             if (fwrite(pOutBuffer + block, sizeof(char), 16, bc6file) != 16)
@@ -586,7 +595,12 @@ CodecError CCodec_BC6H::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
         pFeedbackProc(fProgress, pUser1, pUser2);
     }
 
-    return CFinishBC6HEncoding();
+    CodecError cError = CFinishBC6HEncoding();
+
+    for (size_t d = 0; d < duplicateBlocks.size(); d++)
+        memcpy(pOutBuffer + duplicateBlocks[d].first, pOutBuffer + duplicateBlocks[d].second, 16);
+
+    return cError;
 }
 
 CodecError CCodec_BC6H::Decompress(CCodecBuffer&       bufferIn,
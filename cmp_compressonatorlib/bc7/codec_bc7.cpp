@@ -30,7 +30,9 @@
 #include "common.h"
 #include "codec_bc7.h"
 #include "bc7_library.h"
+#include "cmp_blockcache.h"
 #include <chrono>
+#include <vector>
 
 #ifdef BC7_COMPDEBUGGER
 #include "compclient.h"
@@ -532,6 +534,11 @@ CodecError CCodec_BC7::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut,
     bc7_total_MSE  = 0;
 #endif
 
+    // Uniform and repeated blocks are encoded once: the cache holds the output offset of
+    // their first encoding, which is copied once the encoding threads are done
+    CMP_BlockCache                                 blockCache(BLOCK_SIZE_4X4, 4 * sizeof(CMP_BYTE), sizeof(CMP_DWORD), dwBlocksX * dwBlocksY);
+    std::vector<std::pair<CMP_DWORD, CMP_DWORD> > duplicateBlocks;
+
     CMP_DWORD block = 0;
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
@@ -574,7 +581,9 @@ CodecError CCodec_BC7::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut,
             }
 
             // printf("[i %3d, j%3d]\n",i,j);
-            EncodeBC7Block(blockToEncode, pOutBuffer + block);
+            CMP_DWORD firstBlock = block;
+            if (blockCache.Encode(srcBlock, &firstBlock, [&]() { EncodeBC7Block(blockToEncode, pOutBuffer + block); }))
+                duplicateBlocks.push_back(std::make_pair(block, firstBlock));
 
 #ifdef BC7_COMPDEBUGGER  // Checks decompression it should match or be close to source
             if (CompClient.Connected())
@@ -711,6 +720,9 @@ CodecError CCodec_BC7::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut,
     // Close up remaining compression blocks
     CodecError cError = FinishBC7Encoding();
 
+    for (size_t d = 0; d < duplicateBlocks.size(); d++)
+        memcpy(pOutBuffer + duplicateBlocks[d].first, pOutBuffer + duplicateBlocks[d].second, 16);
+
 #ifdef USE_DBGTRACE
     DbgTrace(("###########-----------DONE -------------###########"));
 #endif
@@ -26,12 +26,15 @@
 #include <math.h>
 #include <float.h>
 
+#include <mutex>
+
 #include "3dquant_constants.h"
 #include "3dquant_vpc.h"
 #include "shake.h"
 #include "bc7_utils.h"
 #include "debug.h"
 #include "bc7_encode.h"
+#include "bc7_ramps.h"
 
 #define LOG_CL_BASE 2
 #define BIT_BASE 5
@@ -183,19 +186,15 @@ int par_vectors_nd[][2 * MAX_DIMENSION_BIG][(1 << (2 * MAX_DIMENSION_BIG - 1))][
 
 };
 
-//#define GIG_TABLE
-#ifdef GIG_TABLE
-static double ramp_err[LOG_CL_RANGE - LOG_CL_BASE][BIT_RANGE - BIT_BASE][256][256][256][16];
-#endif
-
-static double ramp[LOG_CL_RANGE - LOG_CL_BASE][BIT_RANGE - BIT_BASE][256][256][16];
 static double ep_d[BIT_RANGE - BIT_BASE][256];
-// inverted table
+// inverted table, the endpoint codes are 0..255
 // <log2 clusters >,  bits, value, par1, par2, <ep1>
-static int sp_idx[LOG_CL_RANGE - LOG_CL_BASE][BIT_RANGE - BIT_BASE][256][2][2][MAX_CLUSTERS_BIG][2];
+static unsigned char sp_idx[LOG_CL_RANGE - LOG_CL_BASE][BIT_RANGE - BIT_BASE][256][2][2][MAX_CLUSTERS_BIG][2];
+// squared distance from value to the nearest ramp entry, at most 255 * 255
 // <log2 clusters >,  bits, value, par1, par2,
-static double sp_err[LOG_CL_RANGE - LOG_CL_BASE][BIT_RANGE - BIT_BASE][256][2][2][MAX_CLUSTERS_BIG];
-//#endif
+static unsigned short sp_err[LOG_CL_RANGE - LOG_CL_BASE][BIT_RANGE - BIT_BASE][256][2][2][MAX_CLUSTERS_BIG];
+
+#define SP_ERR_UNSET 0xffff
 
 //
 int expand_(int bits, int v)
@@ -204,12 +203,27 @@ int expand_(int bits, int v)
     return (v << (8 - bits) | v >> (2 * bits - 8));
 }
 
-static bool ramp_init = false;
+// Value of entry i of the ramp between the quantized endpoints p1 and p2.
+// This is computed when needed instead of looking it up in a table of every ramp, see bc7_ramps.h
+static inline double ramp_value(int clog, int bits, int p1, int p2, int i)
+{
+    return (double)BC7RampValue(clog, BC7ExpandEndpoint(bits, p1), BC7ExpandEndpoint(bits, p2), i);
+}
 
-void init_ramps(void)
+// Fills the (1 << clog) entries of the ramp between the quantized endpoints p1 and p2
+static inline void ramp_row(int clog, int bits, int p1, int p2, double row[MAX_CLUSTERS_BIG])
+{
+    int e1 = BC7ExpandEndpoint(bits, p1);
+    int e2 = BC7ExpandEndpoint(bits, p2);
+
+    for (int i = 0; i < (1 << clog); i++)
+        row[i] = (double)BC7RampValue(clog, e1, e2, i);
+}
+
+static std::once_flag ramp_init;
+
+static void build_ramps(void)
 {
-    if (ramp_init)
-        return;
 #ifdef USE_DBGTRACE
     DbgTrace(());
 #endif
@@ -224,25 +238,6 @@ void init_ramps(void)
         for (p1 = 0; p1 < (1 << bits); p1++)
             ep_d[BTT(bits)][p1] = (double)expand_(bits, p1);
 
-    for (clog1 = LOG_CL_BASE; clog1 < LOG_CL_RANGE; clog1++)
-        for (bits = BIT_BASE; bits < BIT_RANGE; bits++)
-            for (p1 = 0; p1 < (1 << bits); p1++)
-                for (p2 = 0; p2 < (1 << bits); p2++)
-                {
-                    for (i = 0; i < (1 << clog1); i++)
-                        ramp[CLT(clog1)][BTT(bits)][p1][p2][i] =
-                            floor((double)ep_d[BTT(bits)][p1] + rampLerpWeights[clog1][i] * (double)((ep_d[BTT(bits)][p2] - ep_d[BTT(bits)][p1])) + 0.5);
-
-#ifdef GIG_TABLE
-                    double v;
-                    int    vi;
-                    for (vi = 0; vi < 256; vi++)
-                        for (i = 0; i < (1 << clog1); i++)
-                            ramp_err[CLT(clog1)][BTT(bits)][p1][p2][vi][i] =
-                                (ramp[CLT(clog1)][BTT(bits)][p1][p2][i] - (double)vi) * (ramp[CLT(clog1)][BTT(bits)][p1][p2][i] - (double)vi);
-#endif
-                }
-
     //-----------------------------------------------------------------------------
 
     for (clog1 = LOG_CL_BASE; clog1 < LOG_CL_RANGE; clog1++)
@@ -252,20 +247,26 @@ void init_ramps(void)
                     for (o2 = 0; o2 < 2; o2++)
                         for (i = 0; i < 16; i++)
                         {
-                            sp_idx[CLT(clog1)][BTT(bits)][j][o1][o2][i][0] = -1;
-                            sp_err[CLT(clog1)][BTT(bits)][j][o1][o2][i]    = DBL_MAX;
+                            sp_idx[CLT(clog1)][BTT(bits)][j][o1][o2][i][0] = 0;
+                            sp_idx[CLT(clog1)][BTT(bits)][j][o1][o2][i][1] = 0;
+                            sp_err[CLT(clog1)][BTT(bits)][j][o1][o2][i]    = SP_ERR_UNSET;
                         }
 
     for (clog1 = LOG_CL_BASE; clog1 < LOG_CL_RANGE; clog1++)
         for (bits = BIT_BASE; bits < BIT_RANGE; bits++)
             for (p1 = 0; p1 < (1 << bits); p1++)
                 for (p2 = 0; p2 < (1 << bits); p2++)
+                {
+                    double ramp[MAX_CLUSTERS_BIG];
+                    ramp_row(clog1, bits, p1, p2, ramp);
+
                     for (i = 0; i < (1 << clog1); i++)
                     {
-                        sp_idx[CLT(clog1)][BTT(bits)][(int)ramp[CLT(clog1)][BTT(bits)][p1][p2][i]][p1 & 0x1][p2 & 0x1][i][0] = p1;
-                        sp_idx[CLT(clog1)][BTT(bits)][(int)ramp[CLT(clog1)][BTT(bits)][p1][p2][i]][p1 & 0x1][p2 & 0x1][i][1] = p2;
-                        sp_err[CLT(clog1)][BTT(bits)][(int)ramp[CLT(clog1)][BTT(bits)][p1][p2][i]][p1 & 0x1][p2 & 0x1][i]    = 0.;
+                        sp_idx[CLT(clog1)][BTT(bits)][(int)ramp[i]][p1 & 0x1][p2 & 0x1][i][0] = p1;
+                        sp_idx[CLT(clog1)][BTT(bits)][(int)ramp[i]][p1 & 0x1][p2 & 0x1][i][1] = p2;
+                        sp_err[CLT(clog1)][BTT(bits)][(int)ramp[i]][p1 & 0x1][p2 & 0x1][i]    = 0;
                     }
+                }
 
     for (clog1 = LOG_CL_BASE; clog1 < LOG_CL_RANGE; clog1++)
         for (bits = BIT_BASE; bits < BIT_RANGE; bits++)
@@ -273,7 +274,7 @@ void init_ramps(void)
                 for (o1 = 0; o1 < 2; o1++)
                     for (o2 = 0; o2 < 2; o2++)
                         for (i = 0; i < (1 << clog1); i++)
-                            if (sp_idx[CLT(clog1)][BTT(bits)][j][o1][o2][i][0] < 0)
+                            if (sp_err[CLT(clog1)][BTT(bits)][j][o1][o2][i] == SP_ERR_UNSET)
                             {
                                 int k;
                                 for (k = 1; k < 256; k++)
@@ -294,8 +295,12 @@ void init_ramps(void)
                                     sp_err[CLT(clog1)][BTT(bits)][j][o1][o2][i] = k * k;
                                 }
                             }
+}
 
-    ramp_init = true;
+// Builds the tables once per process, on first use by any thread
+void init_ramps(void)
+{
+    std::call_once(ramp_init, build_ramps);
 }
 
 // finds "floor in the set" if exists, otherwise returns min
@@ -601,7 +606,7 @@ double BC7BlockEncoder::quant_single_point_d(double data[MAX_ENTRIES][MAX_DIMENS
                                 dr[j] = (int)floor(data[0][j] + 0.5);
 
                             tr = sp_err[CLT(clog2)][BTT(bits[j])][dr[j]][t1][t2][i] +
-                                 2 * sqrt(sp_err[CLT(clog2)][BTT(bits[j])][dr[j]][t1][t2][i]) * fabs((double)dr[j] - data[0][j]) +
+                                 2 * sqrt((double)sp_err[CLT(clog2)][BTT(bits[j])][dr[j]][t1][t2][i]) * fabs((double)dr[j] - data[0][j]) +
                                  (dr[j] - data[0][j]) * (dr[j] - data[0][j]);
 
                             if (tr < t_)
@@ -652,7 +657,7 @@ double BC7BlockEncoder::quant_single_point_d(double data[MAX_ENTRIES][MAX_DIMENS
         index[i] = idx_1;
         for (j = 0; j < dimension; j++)
         {
-            out[i][j] = ramp[CLT(clog2)][BTT(bits[j])][epo_1[0][j]][epo_1[1][j]][idx_1];
+            out[i][j] = ramp_value(clog2, bits[j], epo_1[0][j], epo_1[1][j], idx_1);
         }
     }
     return err_1 * numEntries;
@@ -768,8 +773,8 @@ double BC7BlockEncoder::ep_shaker_2_d(double data[MAX_ENTRIES][MAX_DIMENSION_BIG
 
             for (j = 0; j < dimension; j++)
             {
-                epo[0][j] = ramp[CLT(clog3)][BTT(max_bits[j])][epo_code[0][j]][epo_code[1][j]][0];
-                epo[1][j] = ramp[CLT(clog3)][BTT(max_bits[j])][epo_code[0][j]][epo_code[1][j]][(1 << clog3) - 1];
+                epo[0][j] = ramp_value(clog3, max_bits[j], epo_code[0][j], epo_code[1][j], 0);
+                epo[1][j] = ramp_value(clog3, max_bits[j], epo_code[0][j], epo_code[1][j], (1 << clog3) - 1);
             }
 
             return err_o;
@@ -861,8 +866,6 @@ double BC7BlockEncoder::ep_shaker_2_d(double data[MAX_ENTRIES][MAX_DIMENSION_BIG
 
                 for (j = 0; j < dimension; j++)
                 {
-                    double(*rb)[256][16] = ramp[CLT(clog3)][BTT(max_bits[j])];
-
                     int pp[2] = {0, 0};
                     int rr    = (use_par ? 2 : 1);
 
@@ -887,7 +890,9 @@ double BC7BlockEncoder::ep_shaker_2_d(double data[MAX_ENTRIES][MAX_DIMENSION_BIG
                             for (p1 = epi[0][0]; p1 <= epi[0][1]; p1 += step)
                                 for (p2 = epi[1][0]; p2 <= epi[1][1]; p2 += step)
                                 {
-                                    double* rbp = rb[p1][p2];
+                                    double rbp[MAX_CLUSTERS_BIG];
+                                    ramp_row(clog3, max_bits[j], p1, p2, rbp);
+
                                     double  t   = 0;
                                     int*    ci  = cidx;
                                     int     m   = numEntries;
@@ -949,13 +954,17 @@ double BC7BlockEncoder::ep_shaker_2_d(double data[MAX_ENTRIES][MAX_DIMENSION_BIG
 #endif
 
         // requantize
+        double  ramps[MAX_DIMENSION_BIG][MAX_CLUSTERS_BIG];
         double* r[MAX_DIMENSION_BIG];
         int     idg[MAX_ENTRIES];
 
         double err_r = 0;
 
         for (j = 0; j < dimension; j++)
-            r[j] = ramp[CLT(clog3)][BTT(max_bits[j])][epo_0[0][j]][epo_0[1][j]];
+        {
+            ramp_row(clog3, max_bits[j], epo_0[0][j], epo_0[1][j], ramps[j]);
+            r[j] = ramps[j];
+        }
 
         for (i = 0; i < numEntries; i++)
         {
@@ -1016,8 +1025,8 @@ double BC7BlockEncoder::ep_shaker_2_d(double data[MAX_ENTRIES][MAX_DIMENSION_BIG
 
     for (j = 0; j < dimension; j++)
     {
-        epo[0][j] = ramp[CLT(clog3)][BTT(max_bits[j])][epo_code[0][j]][epo_code[1][j]][0];
-        epo[1][j] = ramp[CLT(clog3)][BTT(max_bits[j])][epo_code[0][j]][epo_code[1][j]][(1 << clog3) - 1];
+        epo[0][j] = ramp_value(clog3, max_bits[j], epo_code[0][j], epo_code[1][j], 0);
+        epo[1][j] = ramp_value(clog3, max_bits[j], epo_code[0][j], epo_code[1][j], (1 << clog3) - 1);
     }
 
     return err_o;
@@ -1224,12 +1233,16 @@ double BC7BlockEncoder::ep_shaker_d(double     data[MAX_ENTRIES][MAX_DIMENSION_B
                             }
                         }
 
+                        double  ramps[MAX_DIMENSION_BIG][MAX_CLUSTERS_BIG];
                         double* r[MAX_DIMENSION_BIG];
 
                         double ce[MAX_ENTRIES][MAX_CLUSTERS_BIG][MAX_DIMENSION_BIG];
 
                         for (j = 0; j < dimension; j++)
-                            r[j] = ramp[CLT(clog4)][BTT(bits[j])][epi[0][j][0]][epi[1][j][0]];
+                        {
+                            ramp_row(clog4, bits[j], epi[0][j][0], epi[1][j][0], ramps[j]);
+                            r[j] = ramps[j];
+                        }
 
                         double err_0 = 0;
                         double out_0[MAX_ENTRIES][MAX_DIMENSION_BIG];
@@ -1266,7 +1279,7 @@ double BC7BlockEncoder::ep_shaker_d(double     data[MAX_ENTRIES][MAX_DIMENSION_B
                                 }
                             }
                             s     = s ^ g;
-                            r[j0] = ramp[CLT(clog4)][BTT(bits[j0])][epi[0][j0][ei0]][epi[1][j0][ei1]];
+                            ramp_row(clog4, bits[j0], epi[0][j0][ei0], epi[1][j0][ei1], ramps[j0]);
 
                             err_0 = 0;
 
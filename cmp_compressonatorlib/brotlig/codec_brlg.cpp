@@ -42,7 +42,6 @@
 CCodec_BRLG::CCodec_BRLG()
     : CCodec_DXTC(CT_BRLG)
 {
-    m_numThreads          = 0;
     m_useGPUDecompression = false;
     m_pageSize            = 65536;  // Fixed max size for v1.0
     m_textureWidth        = 0;
@@ -59,9 +58,9 @@ bool CCodec_BRLG::SetParameter(const CMP_CHAR* paramName, CMP_CHAR* value)
     if (value == NULL)
         return false;
 
+    // Accepted for compatibility, BrotliG::Encode takes no thread count
     if (strcmp(paramName, CodecParameters::NumThreads) == 0)
     {
-        m_numThreads = (CMP_BYTE)std::stoi(value) & 0xFF;
     }
     else if (strcmp(paramName, CodecParameters::PageSize) == 0)
     {
@@ -75,9 +74,9 @@ bool CCodec_BRLG::SetParameter(const CMP_CHAR* paramName, CMP_CHAR* value)
 
 bool CCodec_BRLG::SetParameter(const CMP_CHAR* paramName, CMP_DWORD value)
 {
+    // Accepted for compatibility, BrotliG::Encode takes no thread count
     if (strcmp(paramName, CodecParameters::NumThreads) == 0)
     {
-        m_numThreads = (CMP_BYTE)value;
     }
     else if (strcmp(paramName, CodecParameters::UseGPUDecompression) == 0)
     {
@@ -70,7 +70,6 @@ public:
 private:
     // Brotli-G encoding parameters
     CMP_DWORD m_pageSize;
-    CMP_WORD  m_numThreads;
     bool      m_useGPUDecompression;
 
     // Preconditioning parameters
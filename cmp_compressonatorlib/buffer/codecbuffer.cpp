@@ -29,6 +29,8 @@
 
 #include "common.h"
 #include "codecbuffer.h"
+#include "halfconvert.h"
+#include "cmp_swizzle.h"
 #include "codecbuffer_rgba8888.h"
 #include "codecbuffer_rgb888.h"
 #include "codecbuffer_rg8.h"
@@ -300,6 +302,34 @@ void CCodecBuffer::Copy(CCodecBuffer& srcBuffer)
 #define MAX_BLOCK_HEIGHT 8
 #define MAX_BLOCK MAX_BLOCK_WIDTH* MAX_BLOCK_HEIGHT
 
+// Conversions between CMP_HALF and the other channel types are staged
+// through a float buffer so the half part runs as one batch call
+template <typename T, typename Convert>
+static void ConvertHalfBlock(T dst[], const CMP_HALF hBlock[], CMP_DWORD dwBlockSize, Convert convert)
+{
+    float fTemp[MAX_BLOCK * 4];
+    for (CMP_DWORD n = 0; n < dwBlockSize; n += MAX_BLOCK * 4)
+    {
+        CMP_DWORD dwCount = cmp_minT(dwBlockSize - n, (CMP_DWORD)(MAX_BLOCK * 4));
+        CMP_HalfToFloatN(fTemp, reinterpret_cast<const unsigned short*>(hBlock + n), dwCount);
+        for (CMP_DWORD i = 0; i < dwCount; i++)
+            dst[n + i] = convert(fTemp[i]);
+    }
+}
+
+template <typename T, typename Convert>
+static void ConvertToHalfBlock(CMP_HALF hBlock[], const T src[], CMP_DWORD dwBlockSize, Convert convert)
+{
+    float fTemp[MAX_BLOCK * 4];
+    for (CMP_DWORD n = 0; n < dwBlockSize; n += MAX_BLOCK * 4)
+    {
+        CMP_DWORD dwCount = cmp_minT(dwBlockSize - n, (CMP_DWORD)(MAX_BLOCK * 4));
+        for (CMP_DWORD i = 0; i < dwCount; i++)
+            fTemp[i] = convert(src[n + i]);
+        CMP_FloatToHalfN(reinterpret_cast<unsigned short*>(hBlock + n), fTemp, dwCount);
+    }
+}
+
 #define ATTEMPT_BLOCK_READ(b, c, t)          \
     {                                        \
         t block[MAX_BLOCK];                  \
@@ -2971,8 +3001,7 @@ void CCodecBuffer::ConvertBlock(double dBlock[], CMP_HALF hBlock[], CMP_DWORD dw
     assert(dwBlockSize);
     if (dBlock && hBlock && dwBlockSize)
     {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            dBlock[i] = hBlock[i];
+        ConvertHalfBlock(dBlock, hBlock, dwBlockSize, [](float f) { return (double)f; });
     }
 }
 
@@ -3066,10 +3095,7 @@ void CCodecBuffer::ConvertBlock(float fBlock[], CMP_HALF hBlock[], CMP_DWORD dwB
     assert(hBlock);
     assert(dwBlockSize);
     if (fBlock && hBlock && dwBlockSize)
-    {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            fBlock[i] = (float)hBlock[i];
-    }
+        CMP_HalfToFloatN(fBlock, (const unsigned short*)hBlock, dwBlockSize);
 }
 
 void CCodecBuffer::ConvertBlock(float fBlock[], CMP_DWORD dwBlock[], CMP_DWORD dwBlockSize)
@@ -3147,8 +3173,7 @@ void CCodecBuffer::ConvertBlock(CMP_HALF hBlock[], double dBlock[], CMP_DWORD dw
     assert(dwBlockSize);
     if (hBlock && dBlock && dwBlockSize)
     {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            hBlock[i] = (float)dBlock[i];
+        ConvertToHalfBlock(hBlock, dBlock, dwBlockSize, [](double d) { return (float)d; });
     }
 }
 
@@ -3162,10 +3187,7 @@ void CCodecBuffer::ConvertBlock(CMP_HALF hBlock[], float fBlock[], CMP_DWORD dwB
     assert(fBlock);
     assert(dwBlockSize);
     if (hBlock && fBlock && dwBlockSize)
-    {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            hBlock[i] = (float)fBlock[i];
-    }
+        CMP_FloatToHalfN((unsigned short*)hBlock, fBlock, dwBlockSize);
 }
 
 void CCodecBuffer::ConvertBlock(CMP_HALF hBlock[], CMP_DWORD dwBlock[], CMP_DWORD dwBlockSize)
@@ -3179,8 +3201,7 @@ void CCodecBuffer::ConvertBlock(CMP_HALF hBlock[], CMP_DWORD dwBlock[], CMP_DWOR
     assert(dwBlockSize);
     if (hBlock && dwBlock && dwBlockSize)
     {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            hBlock[i] = CONVERT_DWORD_TO_FLOAT(dwBlock[i]);
+        ConvertToHalfBlock(hBlock, dwBlock, dwBlockSize, [](CMP_DWORD v) { return CONVERT_DWORD_TO_FLOAT(v); });
     }
 }
 
@@ -3195,8 +3216,7 @@ void CCodecBuffer::ConvertBlock(CMP_HALF hBlock[], CMP_WORD wBlock[], CMP_DWORD
     assert(dwBlockSize);
     if (hBlock && wBlock && dwBlockSize)
     {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            hBlock[i] = CONVERT_WORD_TO_FLOAT(wBlock[i]);
+        ConvertToHalfBlock(hBlock, wBlock, dwBlockSize, [](CMP_WORD v) { return CONVERT_WORD_TO_FLOAT(v); });
     }
 }
 
@@ -3211,8 +3231,7 @@ void CCodecBuffer::ConvertBlock(CMP_HALF hBlock[], CMP_BYTE cBlock[], CMP_DWORD
     assert(dwBlockSize);
     if (hBlock && cBlock && dwBlockSize)
     {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            hBlock[i] = CONVERT_BYTE_TO_FLOAT(cBlock[i]);
+        ConvertToHalfBlock(hBlock, cBlock, dwBlockSize, [](CMP_BYTE v) { return CONVERT_BYTE_TO_FLOAT(v); });
     }
 }
 
@@ -3227,8 +3246,7 @@ void CCodecBuffer::ConvertBlock(CMP_HALF hBlock[], CMP_SBYTE cBlock[], CMP_DWORD
     assert(dwBlockSize);
     if (hBlock && cBlock && dwBlockSize)
     {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            hBlock[i] = CONVERT_SBYTE_TO_FLOAT(cBlock[i]);
+        ConvertToHalfBlock(hBlock, cBlock, dwBlockSize, [](CMP_SBYTE v) { return CONVERT_SBYTE_TO_FLOAT(v); });
     }
 }
 
@@ -3275,8 +3293,7 @@ void CCodecBuffer::ConvertBlock(CMP_DWORD dwBlock[], CMP_HALF hBlock[], CMP_DWOR
     assert(dwBlockSize);
     if (dwBlock && hBlock && dwBlockSize)
     {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            dwBlock[i] = CONVERT_FLOAT_TO_DWORD(hBlock[i]);
+        ConvertHalfBlock(dwBlock, hBlock, dwBlockSize, [](float f) { return CONVERT_FLOAT_TO_DWORD(f); });
     }
 }
 
@@ -3371,8 +3388,7 @@ void CCodecBuffer::ConvertBlock(CMP_WORD wBlock[], CMP_HALF hBlock[], CMP_DWORD
     assert(dwBlockSize);
     if (wBlock && hBlock && dwBlockSize)
     {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            wBlock[i] = CONVERT_FLOAT_TO_WORD(hBlock[i]);
+        ConvertHalfBlock(wBlock, hBlock, dwBlockSize, [](float f) { return CONVERT_FLOAT_TO_WORD(f); });
     }
 }
 
@@ -3467,8 +3483,7 @@ void CCodecBuffer::ConvertBlock(CMP_BYTE cBlock[], CMP_HALF hBlock[], CMP_DWORD
     assert(dwBlockSize);
     if (cBlock && hBlock && dwBlockSize)
     {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            cBlock[i] = CONVERT_FLOAT_TO_BYTE(hBlock[i]);
+        ConvertHalfBlock(cBlock, hBlock, dwBlockSize, [](float f) { return CONVERT_FLOAT_TO_BYTE(f); });
     }
 }
 
@@ -3563,8 +3578,7 @@ void CCodecBuffer::ConvertBlock(CMP_SBYTE cBlock[], CMP_HALF hBlock[], CMP_DWORD
     assert(dwBlockSize);
     if (cBlock && hBlock && dwBlockSize)
     {
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            cBlock[i] = CONVERT_FLOAT_TO_SBYTE(hBlock[i]);
+        ConvertHalfBlock(cBlock, hBlock, dwBlockSize, [](float f) { return CONVERT_FLOAT_TO_SBYTE(f); });
     }
 }
 
@@ -3638,8 +3652,7 @@ void CCodecBuffer::SwizzleBlock(float fBlock[], CMP_DWORD dwBlockSize)
     assert(fBlock);
     assert(dwBlockSize);
     if (fBlock && dwBlockSize)
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            SWAP_FLOATS(fBlock[(i * 4)], fBlock[(i * 4) + 2]);
+        CMP_SwapRedBlueN(fBlock, dwBlockSize, 4, 4);
 }
 
 void CCodecBuffer::SwizzleBlock(CMP_HALF hBlock[], CMP_DWORD dwBlockSize)
@@ -3651,8 +3664,7 @@ void CCodecBuffer::SwizzleBlock(CMP_HALF hBlock[], CMP_DWORD dwBlockSize)
     assert(hBlock);
     assert(dwBlockSize);
     if (hBlock && dwBlockSize)
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            SWAP_HALFS(hBlock[(i * 4)], hBlock[(i * 4) + 2]);
+        CMP_SwapRedBlueN(hBlock, dwBlockSize, 4, 2);
 }
 
 void CCodecBuffer::SwizzleBlock(CMP_DWORD dwBlock[], CMP_DWORD dwBlockSize)
@@ -3664,8 +3676,7 @@ void CCodecBuffer::SwizzleBlock(CMP_DWORD dwBlock[], CMP_DWORD dwBlockSize)
     assert(dwBlock);
     assert(dwBlockSize);
     if (dwBlock && dwBlockSize)
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            SWAP_DWORDS(dwBlock[(i * 4)], dwBlock[(i * 4) + 2]);
+        CMP_SwapRedBlueN(dwBlock, dwBlockSize, 4, 4);
 }
 
 void CCodecBuffer::SwizzleBlock(CMP_WORD wBlock[], CMP_DWORD dwBlockSize)
@@ -3677,8 +3688,7 @@ void CCodecBuffer::SwizzleBlock(CMP_WORD wBlock[], CMP_DWORD dwBlockSize)
     assert(wBlock);
     assert(dwBlockSize);
     if (wBlock && dwBlockSize)
-        for (CMP_DWORD i = 0; i < dwBlockSize; i++)
-            SWAP_WORDS(wBlock[(i * 4)], wBlock[(i * 4) + 2]);
+        CMP_SwapRedBlueN(wBlock, dwBlockSize, 4, 2);
 }
 
 void CCodecBuffer::SwizzleBlock(CMP_BYTE bBlock[], CMP_DWORD dwBlockSize)
@@ -3690,10 +3700,7 @@ void CCodecBuffer::SwizzleBlock(CMP_BYTE bBlock[], CMP_DWORD dwBlockSize)
     assert(bBlock);
     assert(dwBlockSize);
     if (bBlock && dwBlockSize)
-    {
-        for (CMP_DWORD i = 0; i < dwBlockSize; ++i)
-            SWAP_BYTES(bBlock[i * 4], bBlock[i * 4 + 2]);
-    }
+        CMP_SwapRedBlueN(bBlock, dwBlockSize, 4, 1);
 }
 
 void CCodecBuffer::SwizzleBlock(CMP_SBYTE sbBlock[], CMP_DWORD dwBlockSize)
@@ -3705,8 +3712,5 @@ void CCodecBuffer::SwizzleBlock(CMP_SBYTE sbBlock[], CMP_DWORD dwBlockSize)
     assert(sbBlock);
     assert(dwBlockSize);
     if (sbBlock && dwBlockSize)
-    {
-        for (CMP_DWORD i = 0; i < dwBlockSize; ++i)
-            SWAP_SBYTES(sbBlock[i * 4], sbBlock[i * 4 + 2]);
-    }
+        CMP_SwapRedBlueN(sbBlock, dwBlockSize, 4, 1);
 }
\ No newline at end of file
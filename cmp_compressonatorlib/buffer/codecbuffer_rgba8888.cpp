@@ -29,6 +29,7 @@
 
 #include "common.h"
 #include "codecbuffer_rgba8888.h"
+#include "cmp_swizzle.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -252,10 +253,9 @@ bool CCodecBuffer_RGBA8888::ReadBlockRGBA(CMP_DWORD xw, CMP_DWORD yh, CMP_BYTE w
 
             if (m_bSwizzle)
             {
-                for (iw = 0; iw < minWidth; iw++)
-                {
-                    pdwBlock[(jh * minWidth) + iw] = SWIZZLE_RGBA_BGRA(pdwData[iw]);
-                }
+                static const unsigned char mapBGRA[4] = {2, 1, 0, 3};
+                CMP_SwizzleN(&pdwBlock[jh * minWidth], pdwData, minWidth, 4, mapBGRA);
+                iw = minWidth;
             }
             else
             {
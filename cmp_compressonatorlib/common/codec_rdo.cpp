@@ -0,0 +1,530 @@
+//===============================================================================
+// Copyright (c) 2024  Advanced Micro Devices, Inc. All rights reserved.
+//===============================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+//  File Name:   Codec_RDO.cpp
+//  Description: Rate-distortion optimization of compressed BCn textures
+//
+//  Blocks are changed to repeat the bytes of blocks encoded before them, so that
+//  a lossless compressor run over the texture (Brotli-G, zstd, deflate) finds
+//  more and longer matches. A block keeps its encoding unless a change lowers
+//      distortion + lambda * bits that do not repeat earlier bytes
+//  where the distortion is the sum of squared 8 bit errors against the source.
+//  A change may take over a whole block of a neighbour (or one of its BC1/BC4
+//  parts), its endpoints with selectors chosen for this block, or its selectors
+//  with the endpoints of this block.
+//  A change is never kept when it raises the root mean square error of the
+//  block by more than the given number of 8 bit levels.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "compress.h"
+
+#include <math.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "cmp_core.h"
+#include "cmp_profiler.h"
+#include "codecbuffer.h"
+#include "common.h"
+
+// Block rows optimized together. Bands are independent, so the result does not
+// depend on the number of threads.
+#define RDO_BAND_ROWS 16
+
+// Earlier blocks of the band that are tried as a match, besides the one above
+#define RDO_WINDOW 8
+
+// Increase of the root mean square error of a block, in 8 bit levels, allowed
+// when CMP_CompressOptions::fRDOMaxErrorIncrease is 0
+#define RDO_DEFAULT_MAX_ERROR_INCREASE 1.0f
+
+typedef enum
+{
+    RDO_UNIT_COLOR,  // BC1 colour: two RGB565 endpoints and 2 bit selectors
+    RDO_UNIT_ALPHA,  // BC4 channel: two 8 bit endpoints and 3 bit selectors
+    RDO_UNIT_BLOCK,  // A block that is only reused as a whole (BC7)
+} RDOUnitType;
+
+typedef struct
+{
+    RDOUnitType type;
+    CMP_BYTE    offset;   // Byte offset of the unit in its block
+    CMP_BYTE    channel;  // Decoded channel of an alpha unit
+} RDOUnit;
+
+typedef struct
+{
+    CMP_FORMAT format;
+    CMP_BYTE   blockSize;
+    CMP_BYTE   numUnits;
+    RDOUnit    units[2];
+    bool       punchThrough;  // BC1: the transparent pixels of a block must not change
+} RDOFormat;
+
+static const RDOFormat g_RDOFormats[] = {
+    {CMP_FORMAT_BC1, 8, 1, {{RDO_UNIT_COLOR, 0, 0}}, true},
+    {CMP_FORMAT_DXT1, 8, 1, {{RDO_UNIT_COLOR, 0, 0}}, true},
+    {CMP_FORMAT_BC3, 16, 2, {{RDO_UNIT_ALPHA, 0, 3}, {RDO_UNIT_COLOR, 8, 0}}, false},
+    {CMP_FORMAT_DXT5, 16, 2, {{RDO_UNIT_ALPHA, 0, 3}, {RDO_UNIT_COLOR, 8, 0}}, false},
+    {CMP_FORMAT_BC4, 8, 1, {{RDO_UNIT_ALPHA, 0, 0}}, false},
+    {CMP_FORMAT_ATI1N, 8, 1, {{RDO_UNIT_ALPHA, 0, 0}}, false},
+    {CMP_FORMAT_BC5, 16, 2, {{RDO_UNIT_ALPHA, 0, 0}, {RDO_UNIT_ALPHA, 8, 1}}, false},
+    {CMP_FORMAT_BC7, 16, 1, {{RDO_UNIT_BLOCK, 0, 0}}, false},
+};
+
+static const RDOFormat* GetRDOFormat(CMP_FORMAT format)
+{
+    for (size_t i = 0; i < sizeof(g_RDOFormats) / sizeof(g_RDOFormats[0]); i++)
+        if (g_RDOFormats[i].format == format)
+            return &g_RDOFormats[i];
+    return NULL;
+}
+
+bool CodecSupportsRDO(CMP_FORMAT format)
+{
+    return GetRDOFormat(format) != NULL;
+}
+
+// Channels of a unit that count in its error
+static int GetUnitChannels(RDOUnitType type)
+{
+    return (type == RDO_UNIT_COLOR) ? 3 : ((type == RDO_UNIT_ALPHA) ? 1 : 4);
+}
+
+static CMP_BYTE GetUnitSize(RDOUnitType type)
+{
+    return (type == RDO_UNIT_BLOCK) ? 16 : 8;
+}
+
+// Bytes at the start of a unit that hold its endpoints
+static CMP_BYTE GetEndpointSize(RDOUnitType type)
+{
+    return (type == RDO_UNIT_COLOR) ? 4 : 2;
+}
+
+// Decodes a block to 16 RGBA pixels. Single and two channel formats decode to
+// the first one or two channels.
+static void DecodeBlock(const RDOFormat* pFormat, const CMP_BYTE* block, CMP_BYTE rgba[64])
+{
+    switch (pFormat->format)
+    {
+    case CMP_FORMAT_BC1:
+    case CMP_FORMAT_DXT1:
+        DecompressBlockBC1(block, rgba, NULL);
+        break;
+    case CMP_FORMAT_BC3:
+    case CMP_FORMAT_DXT5:
+        DecompressBlockBC3(block, rgba, NULL);
+        break;
+    case CMP_FORMAT_BC7:
+        DecompressBlockBC7(block, rgba, NULL);
+        break;
+    default:
+    {
+        CMP_BYTE channels[2][16];
+        memset(channels, 0, sizeof(channels));
+        if (pFormat->blockSize == 16)
+            DecompressBlockBC5(block, channels[0], channels[1], NULL);
+        else
+            DecompressBlockBC4(block, channels[0], NULL);
+        for (int i = 0; i < 16; i++)
+        {
+            rgba[i * 4]     = channels[0][i];
+            rgba[i * 4 + 1] = channels[1][i];
+            rgba[i * 4 + 2] = 0;
+            rgba[i * 4 + 3] = 0;
+        }
+        break;
+    }
+    }
+}
+
+// Squared error of the channels of a unit
+static CMP_DWORD UnitError(const RDOUnit& unit, const CMP_BYTE decoded[64], const CMP_BYTE source[64])
+{
+    int firstChannel = 0;
+    int lastChannel  = 3;
+    if (unit.type == RDO_UNIT_COLOR)
+        lastChannel = 2;
+    else if (unit.type == RDO_UNIT_ALPHA)
+        firstChannel = lastChannel = unit.channel;
+
+    CMP_DWORD error = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        for (int c = firstChannel; c <= lastChannel; c++)
+        {
+            int d = (int)decoded[i * 4 + c] - (int)source[i * 4 + c];
+            error += d * d;
+        }
+    }
+    return error;
+}
+
+// Squared error of all the units of a block
+static CMP_DWORD BlockError(const RDOFormat* pFormat, const CMP_BYTE decoded[64], const CMP_BYTE source[64])
+{
+    CMP_DWORD error = 0;
+    for (int u = 0; u < pFormat->numUnits; u++)
+        error += UnitError(pFormat->units[u], decoded, source);
+    return error;
+}
+
+static void WriteSelectors(const RDOUnit& unit, CMP_BYTE* block, const CMP_BYTE selectors[16])
+{
+    CMP_BYTE* pUnit = block + unit.offset;
+    if (unit.type == RDO_UNIT_COLOR)
+    {
+        CMP_DWORD bits = 0;
+        for (int i = 0; i < 16; i++)
+            bits |= (CMP_DWORD)selectors[i] << (2 * i);
+        for (int b = 0; b < 4; b++)
+            pUnit[4 + b] = (CMP_BYTE)(bits >> (8 * b));
+    }
+    else
+    {
+        uint64_t bits = 0;
+        for (int i = 0; i < 16; i++)
+            bits |= (uint64_t)selectors[i] << (3 * i);
+        for (int b = 0; b < 6; b++)
+            pUnit[2 + b] = (CMP_BYTE)(bits >> (8 * b));
+    }
+}
+
+// Gives the unit of block the endpoints of a candidate and picks the selector of
+// each pixel that is closest to the source. The palette is read back from the
+// decoder, so it matches the decoder exactly.
+static void FitSelectors(const RDOFormat* pFormat, const RDOUnit& unit, CMP_BYTE* block, const CMP_BYTE* endpoints, const CMP_BYTE source[64], const CMP_BYTE decodedAlpha[16])
+{
+    int      numIndices = (unit.type == RDO_UNIT_COLOR) ? 4 : 8;
+    CMP_BYTE selectors[16];
+    for (int i = 0; i < 16; i++)
+        selectors[i] = (CMP_BYTE)(i % numIndices);
+
+    memcpy(block + unit.offset, endpoints, GetEndpointSize(unit.type));
+    WriteSelectors(unit, block, selectors);
+
+    CMP_BYTE palette[64];
+    DecodeBlock(pFormat, block, palette);
+
+    // In the three colour mode of BC1 the fourth index is transparent black: it
+    // is only used, and must be used, where the block was transparent
+    bool threeColour = pFormat->punchThrough && (palette[3 * 4 + 3] == 0);
+
+    for (int i = 0; i < 16; i++)
+    {
+        if (threeColour && (decodedAlpha[i] == 0))
+        {
+            selectors[i] = 3;
+            continue;
+        }
+
+        CMP_DWORD bestError = 0xFFFFFFFF;
+        for (int k = 0; k < (threeColour ? 3 : numIndices); k++)
+        {
+            CMP_DWORD error = 0;
+            if (unit.type == RDO_UNIT_COLOR)
+            {
+                for (int c = 0; c < 3; c++)
+                {
+                    int d = (int)palette[k * 4 + c] - (int)source[i * 4 + c];
+                    error += d * d;
+                }
+            }
+            else
+            {
+                int d = (int)palette[k * 4 + unit.channel] - (int)source[i * 4 + unit.channel];
+                error = d * d;
+            }
+
+            if (error < bestError)
+            {
+                bestError    = error;
+                selectors[i] = (CMP_BYTE)k;
+            }
+        }
+    }
+
+    WriteSelectors(unit, block, selectors);
+}
+
+class CRDOBand
+{
+public:
+    CRDOBand(const RDOFormat* pFormat, CMP_BYTE* pDest, CMP_DWORD dwBlocksX, float fLambda, float fMaxErrorIncrease)
+        : m_pFormat(pFormat)
+        , m_pDest(pDest)
+        , m_dwBlocksX(dwBlocksX)
+        , m_fLambda(fLambda)
+        , m_fMaxErrorIncrease(fMaxErrorIncrease)
+    {
+    }
+
+    void OptimizeBlock(CMP_DWORD x, CMP_DWORD y, bool bHasAbove, const CMP_BYTE source[64]);
+
+private:
+    void OptimizeUnit(const RDOUnit& unit, CMP_BYTE* block, const CMP_BYTE* above, const CMP_BYTE source[64], double maxBlockError);
+
+    const RDOFormat* m_pFormat;
+    CMP_BYTE*        m_pDest;
+    CMP_DWORD        m_dwBlocksX;
+    float            m_fLambda;
+    float            m_fMaxErrorIncrease;
+
+    // Final blocks of this band in encoding order, most recent last
+    std::vector<CMP_BYTE> m_window;
+};
+
+// Changes the unit of block when that lowers its cost, keeping the squared error
+// of the whole block at or below maxBlockError
+void CRDOBand::OptimizeUnit(const RDOUnit& unit, CMP_BYTE* block, const CMP_BYTE* above, const CMP_BYTE source[64], double maxBlockError)
+{
+    const CMP_BYTE blockSize    = m_pFormat->blockSize;
+    const CMP_BYTE unitSize     = GetUnitSize(unit.type);
+    const CMP_BYTE endpointSize = GetEndpointSize(unit.type);
+
+    CMP_BYTE decoded[64];
+    DecodeBlock(m_pFormat, block, decoded);
+
+    CMP_BYTE decodedAlpha[16];
+    for (int i = 0; i < 16; i++)
+        decodedAlpha[i] = decoded[i * 4 + 3];
+
+    float    bestCost = (float)UnitError(unit, decoded, source) + m_fLambda * (unitSize * 8);
+    CMP_BYTE bestUnit[16];
+    memcpy(bestUnit, block + unit.offset, unitSize);
+
+    // Units of the same type in the block above and in the window, nearest first
+    std::vector<const CMP_BYTE*> candidates;
+    for (int u = 0; u < m_pFormat->numUnits; u++)
+    {
+        if (m_pFormat->units[u].type != unit.type)
+            continue;
+        if (above)
+            candidates.push_back(above + m_pFormat->units[u].offset);
+        for (size_t w = m_window.size(); w >= blockSize; w -= blockSize)
+            candidates.push_back(&m_window[w - blockSize] + m_pFormat->units[u].offset);
+    }
+
+    CMP_BYTE trial[16];
+    for (size_t c = 0; c < candidates.size(); c++)
+    {
+        const CMP_BYTE* candidate = candidates[c];
+        if (memcmp(candidate, bestUnit, unitSize) == 0)
+            continue;
+
+        // Whole unit, then its endpoints, then its selectors
+        for (int variant = 0; variant < ((unit.type == RDO_UNIT_BLOCK) ? 1 : 3); variant++)
+        {
+            memcpy(trial, block, blockSize);
+            CMP_DWORD newBits = 0;
+            if (variant == 0)
+                memcpy(trial + unit.offset, candidate, unitSize);
+            else if (variant == 1)
+            {
+                FitSelectors(m_pFormat, unit, trial, candidate, source, decodedAlpha);
+                newBits = (unitSize - endpointSize) * 8;
+            }
+            else
+            {
+                memcpy(trial + unit.offset + endpointSize, candidate + endpointSize, unitSize - endpointSize);
+                newBits = endpointSize * 8;
+            }
+
+            // Selectors that happen to equal the candidate's cost nothing either
+            if ((variant == 1) && (memcmp(trial + unit.offset + endpointSize, candidate + endpointSize, unitSize - endpointSize) == 0))
+                newBits = 0;
+
+            CMP_BYTE trialDecoded[64];
+            DecodeBlock(m_pFormat, trial, trialDecoded);
+
+            if (m_pFormat->punchThrough)
+            {
+                bool sameAlpha = true;
+                for (int i = 0; i < 16; i++)
+                    sameAlpha = sameAlpha && (trialDecoded[i * 4 + 3] == decodedAlpha[i]);
+                if (!sameAlpha)
+                    continue;
+            }
+
+            if ((double)BlockError(m_pFormat, trialDecoded, source) > maxBlockError)
+                continue;
+
+            float cost = (float)UnitError(unit, trialDecoded, source) + m_fLambda * newBits;
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                memcpy(bestUnit, trial + unit.offset, unitSize);
+            }
+        }
+    }
+
+    memcpy(block + unit.offset, bestUnit, unitSize);
+}
+
+void CRDOBand::OptimizeBlock(CMP_DWORD x, CMP_DWORD y, bool bHasAbove, const CMP_BYTE source[64])
+{
+    const CMP_BYTE blockSize = m_pFormat->blockSize;
+    CMP_BYTE*      block     = m_pDest + ((size_t)y * m_dwBlocksX + x) * blockSize;
+    const CMP_BYTE* above    = bHasAbove ? block - (size_t)m_dwBlocksX * blockSize : NULL;
+
+    // The error the block may reach: its root mean square error over the channels
+    // of its units, raised by m_fMaxErrorIncrease
+    CMP_BYTE decoded[64];
+    DecodeBlock(m_pFormat, block, decoded);
+
+    int numValues = 0;
+    for (int u = 0; u < m_pFormat->numUnits; u++)
+        numValues += 16 * GetUnitChannels(m_pFormat->units[u].type);
+
+    double maxRMSE       = sqrt((double)BlockError(m_pFormat, decoded, source) / numValues) + m_fMaxErrorIncrease;
+    double maxBlockError   = maxRMSE * maxRMSE * numValues;
+
+    for (int u = 0; u < m_pFormat->numUnits; u++)
+        OptimizeUnit(m_pFormat->units[u], block, above, source, maxBlockError);
+
+    if (m_window.size() == (size_t)RDO_WINDOW * blockSize)
+        m_window.erase(m_window.begin(), m_window.begin() + blockSize);
+    m_window.insert(m_window.end(), block, block + blockSize);
+}
+
+// Reads a source block the way the codec of format reads it, as RGBA pixels in
+// the channel order of the decoder.
+// Single and two channel formats read into the first one or two channels.
+static void ReadSourceBlock(const RDOFormat* pFormat, CCodecBuffer* pSrcBuffer, CMP_DWORD x, CMP_DWORD y, CMP_BYTE source[64])
+{
+    // Formats with a colour unit have it last (BC3)
+    RDOUnitType lastType = pFormat->units[pFormat->numUnits - 1].type;
+    if (lastType != RDO_UNIT_ALPHA)
+    {
+        pSrcBuffer->ReadBlockRGBA(x * 4, y * 4, 4, 4, source);
+
+        // The DXTC codecs read BGRA pixels, the decoder writes RGBA
+        if (lastType == RDO_UNIT_COLOR)
+        {
+            for (int i = 0; i < 16; i++)
+            {
+                CMP_BYTE red      = source[i * 4 + 2];
+                source[i * 4 + 2] = source[i * 4];
+                source[i * 4]     = red;
+            }
+        }
+        return;
+    }
+
+    CMP_BYTE channels[2][16];
+    memset(channels, 0, sizeof(channels));
+    if (pSrcBuffer->m_bSwizzle)
+        pSrcBuffer->ReadBlockB(x * 4, y * 4, 4, 4, channels[0]);
+    else
+        pSrcBuffer->ReadBlockR(x * 4, y * 4, 4, 4, channels[0]);
+    if (pFormat->numUnits > 1)
+        pSrcBuffer->ReadBlockG(x * 4, y * 4, 4, 4, channels[1]);
+
+    for (int i = 0; i < 16; i++)
+    {
+        source[i * 4]     = channels[0][i];
+        source[i * 4 + 1] = channels[1][i];
+        source[i * 4 + 2] = 0;
+        source[i * 4 + 3] = 0;
+    }
+}
+
+CMP_ERROR CodecRDOTexture(const CMP_Texture* srcTexture, CMP_Texture* destTexture, float fLambda, float fMaxErrorIncrease)
+{
+    const RDOFormat* pFormat = GetRDOFormat(destTexture->format);
+    if (!pFormat)
+        return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
+    if (fLambda <= 0.0f)
+        return CMP_OK;
+    if (fMaxErrorIncrease <= 0.0f)
+        fMaxErrorIncrease = RDO_DEFAULT_MAX_ERROR_INCREASE;
+
+    CMP_PROFILE_SCOPE("RDO");
+
+    const CMP_DWORD dwBlocksX = (destTexture->dwWidth + 3) >> 2;
+    const CMP_DWORD dwBlocksY = (destTexture->dwHeight + 3) >> 2;
+    const CMP_DWORD dwBands   = (dwBlocksY + RDO_BAND_ROWS - 1) / RDO_BAND_ROWS;
+
+    CodecBufferType srcBufferType    = GetCodecBufferType(srcTexture->format);
+    bool            swizzleSrcBuffer = CodecSwizzleSrcBuffer(srcTexture->format, destTexture->format);
+
+    CMP_DWORD dwThreadCount = cmp_minT((CMP_DWORD)CMP_GetNumberOfProcessors(), dwBands);
+    if (dwThreadCount < 1)
+        dwThreadCount = 1;
+
+    std::atomic<CMP_DWORD> nextBand(0);
+    std::atomic<bool>      failed(false);
+
+    auto optimizeBands = [&]() {
+        // Codec buffers are not shared between threads
+        CCodecBuffer* pSrcBuffer = CreateCodecBuffer(srcBufferType,
+                                                     srcTexture->nBlockWidth,
+                                                     srcTexture->nBlockHeight,
+                                                     srcTexture->nBlockDepth,
+                                                     srcTexture->dwWidth,
+                                                     srcTexture->dwHeight,
+                                                     srcTexture->dwPitch,
+                                                     srcTexture->pData,
+                                                     srcTexture->dwDataSize);
+        if (!pSrcBuffer)
+        {
+            failed = true;
+            return;
+        }
+        pSrcBuffer->SetFormat(srcTexture->format);
+        pSrcBuffer->m_bSwizzle = swizzleSrcBuffer;
+
+        for (CMP_DWORD band = nextBand++; band < dwBands; band = nextBand++)
+        {
+            CRDOBand  rdoBand(pFormat, destTexture->pData, dwBlocksX, fLambda, fMaxErrorIncrease);
+            CMP_DWORD firstRow = band * RDO_BAND_ROWS;
+            CMP_DWORD endRow   = cmp_minT(firstRow + RDO_BAND_ROWS, dwBlocksY);
+            for (CMP_DWORD y = firstRow; y < endRow; y++)
+            {
+                for (CMP_DWORD x = 0; x < dwBlocksX; x++)
+                {
+                    CMP_BYTE source[64];
+                    ReadSourceBlock(pFormat, pSrcBuffer, x, y, source);
+                    rdoBand.OptimizeBlock(x, y, y > firstRow, source);
+                }
+            }
+        }
+
+        delete pSrcBuffer;
+    };
+
+    DISABLE_FP_EXCEPTIONS;
+    std::vector<std::thread> threads;
+    for (CMP_DWORD t = 1; t < dwThreadCount; t++)
+        threads.push_back(std::thread(optimizeBands));
+    optimizeBands();
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+    RESTORE_FP_EXCEPTIONS;
+
+    return failed ? CMP_ERR_GENERIC : CMP_OK;
+}
@@ -65,4 +65,12 @@ CMP_ERROR CodecCompressTextureThreaded(const CMP_Texture*         srcTexture,
 
 CMP_ERROR CodecDecompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destTexture, const CMP_CompressOptions* options, CMP_Feedback_Proc feedbackProc);
 
+// True when the codec must read a source of srcFormat with red and blue swapped to compress to destFormat
+bool CodecSwizzleSrcBuffer(CMP_FORMAT srcFormat, CMP_FORMAT destFormat);
+
+// Rate-distortion optimization of BC1, BC3, BC4, BC5 and BC7 blocks, run over the compressed
+// destTexture of srcTexture so that lossless compression of the blocks gets smaller. See codec_rdo.cpp
+bool      CodecSupportsRDO(CMP_FORMAT format);
+CMP_ERROR CodecRDOTexture(const CMP_Texture* srcTexture, CMP_Texture* destTexture, float fLambda, float fMaxErrorIncrease);
+
 #endif  // !COMPRESS_H
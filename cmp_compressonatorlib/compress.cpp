@@ -39,6 +39,7 @@
 #include "atiformats.h"
 #include "codec.h"
 #include "codec_common.h"
+#include "cmp_profiler.h"
 #include "common.h"
 #include "compressonator.h"
 #include "texture_utils.h"
@@ -89,6 +90,22 @@ static bool NeedSwizzle(CMP_FORMAT destformat)
     return false;
 }
 
+bool CodecSwizzleSrcBuffer(CMP_FORMAT srcFormat, CMP_FORMAT destFormat)
+{
+    if (!NeedSwizzle(destFormat))
+        return false;
+
+    switch (GetCodecBufferType(srcFormat))
+    {
+    case CBT_BGRA8888:
+    case CBT_BGR888:
+    case CBT_R8:
+        return false;
+    default:
+        return true;
+    }
+}
+
 CMP_ERROR GetError(CodecError err)
 {
     switch (err)
@@ -191,10 +208,14 @@ static void CMP_PrepareCMPSourceForIMG_Destination(CMP_Texture* destTexture, CMP
 
 CMP_ERROR CodecCompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destTexture, const CMP_CompressOptions* options, CMP_Feedback_Proc feedbackProc)
 {
+    CMP_PROFILE_SCOPE("Codec encode");
+
     CodecType destType = GetCodecType(destTexture->format);
     if (destType == CT_Unknown)
         return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
 
+    CMP_PROFILE_COUNT("Texels encoded", (long long)srcTexture->dwWidth * srcTexture->dwHeight);
+
     CCodec* codec = CreateCodec(destType);
     if (codec == NULL)
         return CMP_ERR_UNABLE_TO_INIT_CODEC;
@@ -294,21 +315,7 @@ CMP_ERROR CodecCompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destT
         }
 
         // GPUOpen issue # 59 fix
-        CodecBufferType srcBufferType = GetCodecBufferType(srcTexture->format);
-        if (NeedSwizzle(destTexture->format))
-        {
-            switch (srcBufferType)
-            {
-            case CBT_BGRA8888:
-            case CBT_BGR888:
-            case CBT_R8:
-                swizzleSrcBuffer = false;
-                break;
-            default:
-                swizzleSrcBuffer = true;
-                break;
-            }
-        }
+        swizzleSrcBuffer = CodecSwizzleSrcBuffer(srcTexture->format, destTexture->format);
     }
 
     CodecBufferType srcBufferType = GetCodecBufferType(srcTexture->format);
@@ -384,6 +391,8 @@ CMP_ERROR CodecCompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destT
 
 CMP_ERROR CodecDecompressTexture(const CMP_Texture* srcTexture, CMP_Texture* destTexture, const CMP_CompressOptions* options, CMP_Feedback_Proc feedbackProc)
 {
+    CMP_PROFILE_SCOPE("Codec decode");
+
     CodecType srcType = GetCodecType(srcTexture->format);
     if (srcType == CT_Unknown)
         return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
@@ -510,6 +519,8 @@ CMP_ERROR CodecCompressTextureThreaded(const CMP_Texture*         srcTexture,
                                        const CMP_CompressOptions* options,
                                        CMP_Feedback_Proc          feedbackProc)
 {
+    CMP_PROFILE_SCOPE("Codec encode");
+
     CodecType destType = GetCodecType(destTexture->format);
     if (destType == CT_Unknown)
         return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
@@ -538,6 +549,8 @@ CMP_ERROR CodecCompressTextureThreaded(const CMP_Texture*         srcTexture,
         return CMP_ABORTED;
 #endif
 
+    CMP_PROFILE_COUNT("Texels encoded", (long long)srcTexture->dwWidth * srcTexture->dwHeight);
+
     CMP_DWORD dwMaxThreadCount = cmp_minT(CMP_GetNumberOfProcessors(), MAX_THREADS);
     CMP_DWORD dwLinesRemaining = destTexture->dwHeight;
     CMP_BYTE* pSourceData      = srcTexture->pData;
@@ -618,20 +631,7 @@ CMP_ERROR CodecCompressTextureThreaded(const CMP_Texture*         srcTexture,
         CodecBufferType srcBufferType = GetCodecBufferType(srcTexture->format);
 
         // GPUOpen issue # 59 fix
-        if (NeedSwizzle(destTexture->format))
-        {
-            switch (srcBufferType)
-            {
-            case CBT_BGRA8888:
-            case CBT_BGR888:
-            case CBT_R8:
-                swizzleSrcBuffer = false;
-                break;
-            default:
-                swizzleSrcBuffer = true;
-                break;
-            }
-        }
+        swizzleSrcBuffer = CodecSwizzleSrcBuffer(srcTexture->format, destTexture->format);
 
         CMP_DWORD dwThreadsRemaining = dwMaxThreadCount - dwThread;
         CMP_DWORD dwHeight           = 0;
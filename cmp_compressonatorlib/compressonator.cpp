@@ -39,6 +39,8 @@
 #include "codec.h"
 #include "codec_common.h"
 #include "cmp_mips.h"
+#include "cmp_profiler.h"
+#include "cmp_swizzle.h"
 #include "common.h"
 #include "compress.h"
 #include "debug.h"
@@ -56,40 +58,14 @@ char DbgTracer::PrintBuff[MAX_DBGPPRINTBUFF_SIZE];
 
 // This call is used to swizzle source data content.
 // Use example: CMP_Map_Bytes(pData, dwWidth, dwHeight, { 2, 1, 0, 3 },4);
+// For 3 byte pixels (offset 3) only B0..B2 are used.
 void CMP_Map_Bytes(BYTE* src, int width, int height, CMP_MAP_BYTES_SET map, CMP_BYTE offset)
 {
-    int  i, j;
-    BYTE b[4];
+    if (width <= 0 || height <= 0 || (offset != 3 && offset != 4))
+        return;
 
-    for (i = 0; i < height; i++)
-    {
-        for (j = 0; j < width; j++)
-        {
-            if (offset == 4)
-            {
-                b[0]       = *src;
-                b[1]       = *(src + 1);
-                b[2]       = *(src + 2);
-                b[3]       = *(src + 3);
-                *(src)     = b[map.B0];
-                *(src + 1) = b[map.B1];
-                *(src + 2) = b[map.B2];
-                *(src + 3) = b[map.B3];
-                src        = src + 4;  // move to next set of bytes
-            }
-            else if (offset == 3)
-            {
-                b[0]       = *src;
-                b[1]       = *(src + 1);
-                b[2]       = *(src + 2);
-                b[3]       = *(src + 3);
-                *(src)     = b[map.B0];
-                *(src + 1) = b[map.B1];
-                *(src + 2) = b[map.B2];
-                src        = src + 3;  // move to next set of bytes
-            }
-        }
-    }
+    const unsigned char byteMap[4] = {map.B0, map.B1, map.B2, map.B3};
+    CMP_SwizzleN(src, src, (size_t)width * height, offset, byteMap);
 }
 
 #ifndef USE_OLD_SWIZZLE
@@ -372,6 +348,8 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture*               pSourceTexture,
         if (!pOptions->bDisableMultiThreading && (pOptions->dwnumThreads == 1))
             bMultithread = false;
 
+        CMP_ERROR cmp_status = CMP_OK;
+
 #ifdef THREADED_COMPRESS
         // Note:
         // BC7/BC6H has issues with this setting - we already set multithreading via numThreads so
@@ -396,13 +374,20 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture*               pSourceTexture,
 #endif
         )
         {
-            return CodecCompressTextureThreaded(&srcTextureCopy, pDestTexture, pOptions, pFeedbackProc);
+            cmp_status = CodecCompressTextureThreaded(&srcTextureCopy, pDestTexture, pOptions, pFeedbackProc);
         }
         else
 #endif  // THREADED_COMPRESS
         {
-            return CodecCompressTexture(&srcTextureCopy, pDestTexture, pOptions, pFeedbackProc);
+            cmp_status = CodecCompressTexture(&srcTextureCopy, pDestTexture, pOptions, pFeedbackProc);
         }
+
+        // Optional post-pass over the compressed blocks
+        if ((cmp_status == CMP_OK) && pOptions && (pOptions->dwSize == sizeof(CMP_CompressOptions)) && (pOptions->fRDOLambda > 0.0f) &&
+            CodecSupportsRDO(pDestTexture->format))
+            cmp_status = CodecRDOTexture(&srcTextureCopy, pDestTexture, pOptions->fRDOLambda, pOptions->fRDOMaxErrorIncrease);
+
+        return cmp_status;
     }
     else if (!compressing && decompressing)  // Decompression
     {
@@ -708,6 +693,7 @@ CMP_ERROR CMP_API CMP_ConvertMipTexture(CMP_MipSet* p_MipSetIn, CMP_MipSet* p_Mi
                 //========================
                 // Process ConvertTexture
                 //========================
+                CMP_PROFILE_SCOPE_ARG("Encode mip", nMipLevel);
                 CMP_ERROR cmp_status = CMP_ConvertTexture(&srcTexture, &destTexture, pOptions, pFeedbackProc);
 
                 if (cmp_status != CMP_OK)
@@ -31,6 +31,7 @@
 #define AMD_COMPRESS_VERSION_MINOR 3  // The minor version number of this release.
 
 #include <stdint.h>
+#include <stdio.h>
 #include <vector>
 #include <stddef.h>
 
@@ -280,6 +281,16 @@ struct KernelPerformanceStats
     CMP_FLOAT m_CmpMTxPerSec;            // Number of Mega Texels processed per second
 };
 
+#define CMP_MAX_PERF_WORKERS 128
+
+// Per worker thread stats of the last compression, use CMP_GetWorkerStats to query them
+struct KernelWorkerStats
+{
+    CMP_INT   m_num_workers;                          // Number of CPU worker threads used (HPC only, 0 otherwise)
+    CMP_INT   m_worker_blocks[CMP_MAX_PERF_WORKERS];  // Blocks processed by each CPU worker thread
+    CMP_FLOAT m_worker_busyMS[CMP_MAX_PERF_WORKERS];  // Time each CPU worker thread spent processing blocks
+};
+
 struct KernelDeviceInfo
 {
     CMP_CHAR m_deviceName[256];  // Device name (CPU or GPU)
@@ -344,6 +355,7 @@ struct KernelOptions
 #define MS_FLAG_Default 0x0000
 #define MS_FLAG_AlphaPremult 0x0001
 #define MS_FLAG_DisableMipMapping 0x0002
+#define MS_FLAG_ArenaAlloc 0x0004  // Back all MipLevels of the MipSet with a single aligned allocation, see CMP_SetMipSetAllocator
 #define AMD_MAX_CMDS 20
 #define AMD_MAX_CMD_STR 32
 #define AMD_MAX_CMD_PARAM 16
@@ -492,6 +504,19 @@ typedef struct
     CMP_BOOL genGPUMipMaps;  // When ecoding with GPU HW use it to generate MipMap images, valid only when miplevels is set else default is toplevel 1
     CMP_BOOL useSRGBFrames;  // when using GPU HW for encoding and mipmap generation use SRGB frames, default is RGB
     CMP_INT  miplevels;      // miplevels to use when GPU is used to generate them
+
+    // New to v4.6, appended so that the fields above keep their offsets
+    // Used by the KTX2 file plugin: Zstandard supercompression level (1 to 22) applied to each saved level, 0 disables supercompression
+    CMP_INT nKTX2ZstdLevel;
+
+    // New to v4.6, appended
+    // Rate-distortion optimization of BC1, BC3, BC4, BC5 and BC7 blocks for a better ratio when the blocks are compressed again
+    // with Brotli-G, zstd or deflate. Blocks reuse parts of nearby blocks when that costs less than fRDOLambda squared error per bit saved.
+    // 0 disables it, larger values give smaller files at lower quality. Applies to the CPU codecs of CMP_ConvertTexture
+    CMP_FLOAT fRDOLambda;
+    // Largest increase of the root mean square error of a block, in 8 bit levels, that the rate-distortion optimization may cause.
+    // 0 uses the default of 1
+    CMP_FLOAT fRDOMaxErrorIncrease;
 } CMP_CompressOptions;
 
 #pragma pack(pop)
@@ -569,6 +594,14 @@ typedef struct
 #define CMP_D3DX_FILTER_SRGB (3 << 21)
 #define CMP_D3DX_FILTER_MIRROR (7 << 16)
 
+// FidelityFX effects run by the "FILTERS","EFFECTS" plugin
+#define CMP_FX_FILTER_CAS 0  // Contrast Adaptive Sharpening, with optional scaling up to 4x area
+#define CMP_FX_FILTER_FSR 1  // FSR 1.0 edge adaptive upscaling (EASU) followed by RCAS sharpening
+
+#define CMP_FX_BACKEND_DEFAULT 0  // DirectX 11 when available, else CPU
+#define CMP_FX_BACKEND_GPU 1      // DirectX 11, Windows only
+#define CMP_FX_BACKEND_CPU 2      // SIMD and multithreaded CPU implementation
+
 typedef struct
 {
     int nFilterType;  // This is either CPU Box Filter or GPU Based CMP_D3DX_FILTER_... definitions
@@ -584,6 +617,10 @@ typedef struct
     int   destHeight;  // Scale source texture height to destHeight default 0 no scalwing
     bool  useSRGB;     // if set true process image as SRGB else use linear color space. Default is false
 
+    // Settings that apply to the FidelityFX effects
+    int nFxFilter;   // CMP_FX_FILTER_... default CAS
+    int nFxBackend;  // CMP_FX_BACKEND_... default uses DirectX when available
+
 } CMP_CFilterParams;
 
 typedef enum
@@ -1043,6 +1080,31 @@ CMP_INT CMP_API   CMP_GenerateMIPLevels(CMP_MipSet* pMipSet, CMP_INT nMinSize);
 CMP_ERROR CMP_API CMP_CreateCompressMipSet(CMP_MipSet* pMipSetCMP, CMP_MipSet* pMipSetSRC);
 CMP_ERROR CMP_API CMP_CreateMipSet(CMP_MipSet* pMipSet, CMP_INT nWidth, CMP_INT nHeight, CMP_INT nDepth, ChannelFormat channelFormat, TextureType textureType);
 
+// MipSet arena allocation
+// A MipSet allocated with MS_FLAG_ArenaAlloc set in m_Flags reserves one block for all of its MipLevels and faces,
+// each level starting on a 64 byte boundary. Large arenas are aligned to 2MB so the OS can back them with huge pages.
+// The block is reserved when the first level's data is allocated and sized for every level in that level's format;
+// levels that do not fit their slot are allocated on the heap. CMP_FreeMipSet releases the block.
+// A copy of a CMP_MipSet struct shares the MipLevels, and so the arena, of the original: as for any MipSet,
+// free only one of them.
+// The callbacks let an application recycle arenas between jobs instead of returning the memory to the OS.
+// \param[in] size       Size of the arena in bytes
+// \param[in] alignment  Required alignment of the arena, a power of two of at least 64
+// \param[in] pUserData  The pUserData member of CMP_MipSetAllocator
+typedef void*(CMP_API* CMP_ArenaAlloc_Proc)(size_t size, size_t alignment, void* pUserData);
+typedef void(CMP_API* CMP_ArenaFree_Proc)(void* pArena, size_t size, void* pUserData);
+
+typedef struct
+{
+    CMP_ArenaAlloc_Proc pAlloc;       // Reserves an arena, NULL to use the default aligned allocator
+    CMP_ArenaFree_Proc  pFree;        // Releases an arena reserved by pAlloc
+    void*               pUserData;    // Passed to pAlloc and pFree
+    CMP_BOOL            bAllMipSets;  // Use arenas for every MipSet, not only those with MS_FLAG_ArenaAlloc set
+} CMP_MipSetAllocator;
+
+// Sets the allocator used for MipSet arenas, call before any MipSets are allocated. NULL restores the defaults.
+CMP_VOID CMP_API CMP_SetMipSetAllocator(const CMP_MipSetAllocator* pAllocator);
+
 // MIP Map Quality
 CMP_UINT CMP_API  CMP_getFormat_nChannels(CMP_FORMAT format);
 CMP_ERROR CMP_API CMP_MipSetAnlaysis(CMP_MipSet* src1, CMP_MipSet* src2, CMP_INT nMipLevel, CMP_INT nFaceOrSlice, CMP_AnalysisData* pAnalysisData);
@@ -1061,6 +1123,16 @@ CMP_ERROR CMP_API CMP_ConvertMipTexture(CMP_MipSet* p_MipSetIn, CMP_MipSet* p_Mi
 // CMP_Framework Lib: Texture Encoder Interfaces
 //--------------------------------------------
 CMP_ERROR CMP_API  CMP_LoadTexture(const char* sourceFile, CMP_MipSet* pMipSet);
+/// Loads a texture that is already held in memory, such as a file received over the network.
+/// The image type is detected from the file signature: DDS and KTX data is passed to the image plugins,
+/// anything else is decoded by stb_image (PNG, JPG, BMP, TGA, PSD, GIF and HDR).
+/// KTX2, EXR and ASTC files cannot be loaded from memory, use CMP_LoadTexture for them.
+/// Decoded pixels are owned by pMipSet and released by CMP_FreeMipSet.
+/// \param[in] pBuffer Pointer to the file contents
+/// \param[in] size Size of the file contents in bytes
+/// \param[out] pMipSet The MipSet to load the texture into
+/// \return CMP_OK if successful, otherwise an error code
+CMP_ERROR CMP_API  CMP_LoadTextureFromMemory(const void* pBuffer, size_t size, CMP_MipSet* pMipSet);
 CMP_ERROR CMP_API  CMP_SaveTexture(const char* destFile, CMP_MipSet* pMipSet);
 /// Saves a CMP_Texture to a file. For simple formats, this is a quick call to stb_image_write. 
 /// For more complex formats, a temporary mip set is created, therefore if you're working with a complex format, it is recommended to work with MipSets Directly.
@@ -1077,6 +1149,7 @@ CMP_VOID CMP_API   CMP_FreeMipSet(CMP_MipSet* MipSetIn);
 CMP_VOID CMP_API   CMP_GetMipLevel(CMP_MipLevel** data, const CMP_MipSet* pMipSet, CMP_INT nMipLevel, CMP_INT nFaceOrSlice);
 CMP_ERROR CMP_API  CMP_GetPerformanceStats(KernelPerformanceStats* pPerfStats);
 CMP_ERROR CMP_API  CMP_GetDeviceInfo(KernelDeviceInfo* pDeviceInfo);
+CMP_ERROR CMP_API  CMP_GetWorkerStats(KernelWorkerStats* pWorkerStats);
 CMP_BOOL CMP_API   CMP_IsCompressedFormat(CMP_FORMAT format);
 CMP_BOOL CMP_API   CMP_IsFloatFormat(CMP_FORMAT InFormat);
 CMP_BOOL CMP_API   CMP_IsValidFormat(CMP_FORMAT InFormat);
@@ -1102,6 +1175,25 @@ CMP_ERROR CMP_API CMP_CompressBlockXY(void**       blockEncoder,
                                       unsigned int dstStride);
 void CMP_API      CMP_DestroyBlockEncoder(void** blockEncoder);
 
+//--------------------------------------------
+// CMP_Framework Lib: Profiling
+//--------------------------------------------
+// Times the stages of a job (load, format conversion, mip generation, encode, analysis, save) and counts the work they do.
+// The application, CMP_Compressonator and CMP_Framework record into the same trace, kept by CMP_Framework which exports these functions.
+// The libraries use the macros of cmp_profiler.h.
+// Nothing is recorded until CMP_Profiler_Enable(true) is called, enabling restarts the clock of the trace.
+// Names are kept by pointer and must be string literals.
+CMP_VOID CMP_API  CMP_Profiler_Enable(CMP_BOOL enable);
+CMP_BOOL CMP_API  CMP_Profiler_IsEnabled();
+CMP_VOID CMP_API  CMP_Profiler_Reset();                                             // Drops all recorded scopes and counters
+CMP_VOID CMP_API  CMP_Profiler_Count(const char* name, long long value);           // Adds value to the counter name
+long long CMP_API CMP_Profiler_Time();                                              // Microseconds since the profiler was enabled
+CMP_VOID CMP_API  CMP_Profiler_AddScope(const char* name, CMP_INT arg, long long start);  // Records name from start, a CMP_Profiler_Time value, until now. arg is shown when 0 or more
+// Writes the scopes and counters as Chrome trace event JSON, which opens in chrome://tracing and Perfetto. Returns false if the file cannot be written.
+CMP_BOOL CMP_API CMP_Profiler_WriteTrace(const char* fileName);
+// Prints the number of calls and the total, average and longest time of each scope name, then the total of each counter
+CMP_VOID CMP_API CMP_Profiler_PrintSummary(FILE* fp);
+
 //-----------------------------------
 // CMP_Framework Lib: Host interface
 //-----------------------------------
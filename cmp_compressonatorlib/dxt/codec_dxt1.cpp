@@ -31,6 +31,7 @@
 #include "common.h"
 #include "compressonator.h"
 #include "codec_dxt1.h"
+#include "cmp_blockcache.h"
 
 #ifdef TEST_CMP_CORE_DECODER
 #include "cmp_core.h"
@@ -125,6 +126,9 @@ CodecError CCodec_DXT1::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
 
     bool bUseFixed = (!bufferIn.IsFloat() && bufferIn.GetChannelDepth() == 8 && !m_bUseFloat);
 
+    // Uniform and repeated blocks are encoded once
+    CMP_BlockCache blockCache(BLOCK_SIZE_4X4, bUseFixed ? 4 * sizeof(CMP_BYTE) : 4 * sizeof(float), sizeof(CMP_DWORD) * 2, dwBlocksX * dwBlocksY);
+
     float fAlphaThreshold = CONVERT_BYTE_TO_FLOAT(m_nAlphaThreshold);
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
@@ -135,13 +139,17 @@ CodecError CCodec_DXT1::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
             {
                 CMP_BYTE srcBlock[BLOCK_SIZE_4X4X4];
                 bufferIn.ReadBlockRGBA(i * 4, j * 4, 4, 4, srcBlock);
-                CompressRGBBlock(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock), true, m_bDXT1UseAlpha, m_nAlphaThreshold);
+                blockCache.Encode(srcBlock, compressedBlock, [&]() {
+                    CompressRGBBlock(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock), true, m_bDXT1UseAlpha, m_nAlphaThreshold);
+                });
             }
             else
             {
                 float srcBlock[BLOCK_SIZE_4X4X4];
                 bufferIn.ReadBlockRGBA(i * 4, j * 4, 4, 4, srcBlock);
-                CompressRGBBlock(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock), true, m_bDXT1UseAlpha, fAlphaThreshold);
+                blockCache.Encode(srcBlock, compressedBlock, [&]() {
+                    CompressRGBBlock(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock), true, m_bDXT1UseAlpha, fAlphaThreshold);
+                });
             }
             bufferOut.WriteBlock(i * 4, j * 4, compressedBlock, 2);
         }
@@ -30,6 +30,7 @@
 
 #include "common.h"
 #include "codec_dxt3.h"
+#include "cmp_blockcache.h"
 
 #ifdef TEST_CMP_CORE_DECODER
 #include "cmp_core.h"
@@ -67,6 +68,9 @@ CodecError CCodec_DXT3::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
 
     bool bUseFixed = (!bufferIn.IsFloat() && bufferIn.GetChannelDepth() == 8 && !m_bUseFloat);
 
+    // Uniform and repeated blocks are encoded once
+    CMP_BlockCache blockCache(BLOCK_SIZE_4X4, bUseFixed ? 4 * sizeof(CMP_BYTE) : 4 * sizeof(float), sizeof(CMP_DWORD) * 4, dwBlocksX * dwBlocksY);
+
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
         for (CMP_DWORD i = 0; i < dwBlocksX; i++)
@@ -76,13 +80,17 @@ CodecError CCodec_DXT3::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
             {
                 CMP_BYTE srcBlock[BLOCK_SIZE_4X4X4];
                 bufferIn.ReadBlockRGBA(i * 4, j * 4, 4, 4, srcBlock);
-                CompressRGBABlock_ExplicitAlpha(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock));
+                blockCache.Encode(srcBlock, compressedBlock, [&]() {
+                    CompressRGBABlock_ExplicitAlpha(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock));
+                });
             }
             else
             {
                 float srcBlock[BLOCK_SIZE_4X4X4];
                 bufferIn.ReadBlockRGBA(i * 4, j * 4, 4, 4, srcBlock);
-                CompressRGBABlock_ExplicitAlpha(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock));
+                blockCache.Encode(srcBlock, compressedBlock, [&]() {
+                    CompressRGBABlock_ExplicitAlpha(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock));
+                });
             }
             bufferOut.WriteBlock(i * 4, j * 4, compressedBlock, 4);
         }
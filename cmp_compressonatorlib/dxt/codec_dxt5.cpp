@@ -30,6 +30,7 @@
 
 #include "common.h"
 #include "codec_dxt5.h"
+#include "cmp_blockcache.h"
 
 #ifdef TEST_CMP_CORE_DECODER
 #include "cmp_core.h"
@@ -89,6 +90,9 @@ CodecError CCodec_DXT5::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
 
     bool bUseFixed = (!bufferIn.IsFloat() && bufferIn.GetChannelDepth() == 8 && !m_bUseFloat);
 
+    // Uniform and repeated blocks are encoded once
+    CMP_BlockCache blockCache(BLOCK_SIZE_4X4, bUseFixed ? 4 * sizeof(CMP_BYTE) : 4 * sizeof(float), sizeof(CMP_DWORD) * 4, dwBlocksX * dwBlocksY);
+
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
         for (CMP_DWORD i = 0; i < dwBlocksX; i++)
@@ -105,13 +109,13 @@ CodecError CCodec_DXT5::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
                 g_CompClient.SendData(1, sizeof(srcBlock), srcBlock);
 #endif
 
-                CompressRGBABlock(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock));
+                blockCache.Encode(srcBlock, compressedBlock, [&]() { CompressRGBABlock(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock)); });
             }
             else
             {
                 float srcBlock[BLOCK_SIZE_4X4X4];
                 bufferIn.ReadBlockRGBA(i * 4, j * 4, 4, 4, srcBlock);
-                CompressRGBABlock(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock));
+                blockCache.Encode(srcBlock, compressedBlock, [&]() { CompressRGBABlock(srcBlock, compressedBlock, CalculateColourWeightings(srcBlock)); });
             }
 
             bufferOut.WriteBlock(i * 4, j * 4, compressedBlock, 4);
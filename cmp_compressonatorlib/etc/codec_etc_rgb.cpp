@@ -30,6 +30,7 @@
 
 #include "common.h"
 #include "codec_etc_rgb.h"
+#include "cmp_blockcache.h"
 #include "compressonator_tc.h"
 #include "etcpack_lib.h"
 
@@ -77,12 +78,16 @@ CodecError CCodec_ETC_RGB::Compress(CCodecBuffer&       bufferIn,
 
     CMP_BYTE  srcBlock[BLOCK_SIZE_4X4X4];
     CMP_DWORD compressedBlock[2];
+
+    // Uniform and repeated blocks are encoded once
+    CMP_BlockCache blockCache(BLOCK_SIZE_4X4, 4 * sizeof(CMP_BYTE), sizeof(compressedBlock), dwBlocksX * dwBlocksY);
+
     for (CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
         for (CMP_DWORD i = 0; i < dwBlocksX; i++)
         {
             bufferIn.ReadBlockRGBA(i * 4, j * 4, 4, 4, srcBlock);
-            CompressRGBBlock(srcBlock, compressedBlock);
+            blockCache.Encode(srcBlock, compressedBlock, [&]() { CompressRGBBlock(srcBlock, compressedBlock); });
             bufferOut.WriteBlock(i * 4, j * 4, compressedBlock, 2);
         }
         if (pFeedbackProc)
@@ -35,6 +35,7 @@
 #include "common_def.h"
 #include "bcn_common_api.h"
 #include <algorithm>
+#include <mutex>
 #endif
 
 // TryMode456CS
@@ -942,14 +943,8 @@ CGU_INT old_expandbits(CGU_INT bits, CGU_INT v)
     return (v << (8 - bits) | v >> (2 * bits - 8));
 }
 
-void old_init_BC7ramps()
+static void old_build_BC7ramps()
 {
-    CMP_STATIC CGU_BOOL g_rampsInitialized = FALSE;
-    if (g_rampsInitialized == TRUE)
-        return;
-    g_rampsInitialized        = TRUE;
-    BC7EncodeRamps2.ramp_init = TRUE;
-
     //bc7_isa(); ASPM_PRINT((" INIT Ramps\n"));
 
     CGU_INT bits;
@@ -1071,6 +1066,15 @@ void old_init_BC7ramps()
 
         }  //bits<BIT_RANGE
     }      //clogBC7<LOG_CL_RANGE
+
+    BC7EncodeRamps2.ramp_init = TRUE;
+}
+
+// Builds the tables once per process, on first use by any thread
+void old_init_BC7ramps()
+{
+    static std::once_flag rampsInitialized;
+    std::call_once(rampsInitialized, old_build_BC7ramps);
 }
 
 CGV_FLOAT old_img_absf(CGV_FLOAT a)
@@ -59,6 +59,11 @@
 
 #include "bc7_common_encoder.h"
 
+#ifndef ASPM_GPU
+#include "bc7_ramps.h"
+#include <mutex>
+#endif
+
 #ifndef ASPM
 //---------------------------------------------
 // Predefinitions for GPU and CPU compiled code
@@ -137,16 +142,9 @@ CMP_EXPORT CGU_INT bc7_isa()
     return -1;
 }
 
-CMP_EXPORT void init_BC7ramps()
+#ifndef ASPM_GPU
+static void build_BC7ramps()
 {
-#ifdef ASPM_GPU
-#else
-    CMP_STATIC CGU_BOOL g_rampsInitialized = FALSE;
-    if (g_rampsInitialized == TRUE)
-        return;
-    g_rampsInitialized       = TRUE;
-    BC7EncodeRamps.ramp_init = TRUE;
-
     //bc7_isa(); ASPM_PRINT((" INIT Ramps\n"));
 
     CGU_INT bits;
@@ -221,9 +219,7 @@ CMP_EXPORT void init_BC7ramps()
                             (CGV_INT)
                                 BC7EncodeRamps.ramp[(CLT(clogBC7) * 4 * 256 * 256 * 16) + (BTT(bits) * 256 * 256 * 16) + (p1 * 256 * 16) + (p2 * 16) + index];
 #else
-                        CGV_INT floatf = cmp_floor(
-                            (CGV_FLOAT)BC7EncodeRamps.ep_d[BTT(bits)][p1] +
-                            rampWeights[clogBC7][index] * (CGV_FLOAT)((BC7EncodeRamps.ep_d[BTT(bits)][p2] - BC7EncodeRamps.ep_d[BTT(bits)][p1])) + 0.5F);
+                        CGV_INT floatf = BC7RampValue(clogBC7, BC7EncodeRamps.ep_d[BTT(bits)][p1], BC7EncodeRamps.ep_d[BTT(bits)][p2], index);
 #endif
                         BC7EncodeRamps.sp_idx[(CLT(clogBC7) * 4 * 256 * 2 * 2 * 16 * 2) + (BTT(bits) * 256 * 2 * 2 * 16 * 2) + (floatf * 2 * 2 * 16 * 2) +
                                               ((p1 & 0x1) * 2 * 16 * 2) + ((p2 & 0x1) * 16 * 2) + (index * 2) + 0] = p1;
@@ -295,6 +291,17 @@ CMP_EXPORT void init_BC7ramps()
 
         }  //bits<BIT_RANGE
     }      //clogBC7<LOG_CL_RANGE
+
+    BC7EncodeRamps.ramp_init = TRUE;
+}
+#endif
+
+// Builds the tables once per process, on first use by any thread
+CMP_EXPORT void init_BC7ramps()
+{
+#ifndef ASPM_GPU
+    static std::once_flag rampsInitialized;
+    std::call_once(rampsInitialized, build_BC7ramps);
 #endif
 }
 
@@ -921,8 +928,7 @@ INLINE CGV_FLOAT GetRamp(CGU_INT   clogBC7,  // ramp bits Valid range 2..4
     CGV_FLOAT rampf = BC7EncodeRamps.ramp[(CLT(clogBC7) * 4 * 256 * 256 * 16) + (BTT(bits) * 256 * 256 * 16) + (p1 * 256 * 16) + (p2 * 16) + index];
     return rampf;
 #else
-    return (CGV_FLOAT)cmp_floor((CGV_FLOAT)BC7EncodeRamps.ep_d[BTT(bits)][p1] +
-                                rampWeights[clogBC7][index] * (CGV_FLOAT)((BC7EncodeRamps.ep_d[BTT(bits)][p2] - BC7EncodeRamps.ep_d[BTT(bits)][p1])) + 0.5F);
+    return (CGV_FLOAT)BC7RampValue(clogBC7, BC7EncodeRamps.ep_d[BTT(bits)][p1], BC7EncodeRamps.ep_d[BTT(bits)][p2], index);
 #endif
 #endif
 }
@@ -427,7 +427,8 @@ typedef CGV_UINT32<4> CGV_Vec4ui;
 
 // using CPU compiler
 #define ASPM_PRINT(args) printf args
-#define USE_BC7_RAMP
+// The BC7 ramp is evaluated on the fly (see bc7_ramps.h) instead of using a 50 MB table
+//#define USE_BC7_RAMP
 #define USE_BC7_SP_ERR_IDX
 
 #define CMP_EXPORT
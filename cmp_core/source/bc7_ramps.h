@@ -0,0 +1,54 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+#ifndef BC7_RAMPS_H
+#define BC7_RAMPS_H
+
+// BC7 ramp evaluation shared by the CMP_Core BC7 encoder and the legacy BC7 shaker.
+//
+// Both encoders used to precompute every ramp entry for every pair of quantized endpoints, which costs tens of MB
+// per process. All BC7 index weights are multiples of 1/64 and the expanded endpoints are integers, so
+// floor(e1 + w * (e2 - e1) + 0.5) is exact in float and in double, and equals the integer expression below.
+// Evaluating it directly is cheaper than a lookup into those tables.
+
+// BC7 index weights in 1/64 units, indexed by the number of index bits (2..4) and the index
+static const int BC7RampWeights64[5][16] = {
+    {0},                                                              // 0 bit index
+    {0, 64},                                                          // 1 bit index
+    {0, 21, 43, 64},                                                  // 2 bit index
+    {0, 9, 18, 27, 37, 46, 55, 64},                                   // 3 bit index
+    {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64}  // 4 bit index
+};
+
+// Expands a quantized endpoint component of 4..8 bits to 8 bits
+static inline int BC7ExpandEndpoint(int bits, int v)
+{
+    return (v << (8 - bits)) | (v >> (2 * bits - 8));
+}
+
+// Returns entry index of the ramp between the expanded endpoint components e1 and e2 (0..255)
+static inline int BC7RampValue(int indexBits, int e1, int e2, int index)
+{
+    return (e1 * 64 + BC7RampWeights64[indexBits][index] * (e2 - e1) + 32) >> 6;
+}
+
+#endif
@@ -0,0 +1,112 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "cmp_blockcache.h"
+
+#include <string.h>
+#include <stdint.h>
+
+#define CMP_BLOCKCACHE_MIN_BITS 4
+#define CMP_BLOCKCACHE_MAX_BITS 10  // 1024 slots per table
+
+// Hashes size bytes, 8 bytes at a time
+static uint64_t HashKey(const unsigned char* key, size_t size)
+{
+    uint64_t hash = size;
+    size_t   i    = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, key + i, 8);
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 32;
+    }
+    if (i < size)
+    {
+        uint64_t word = 0;
+        memcpy(&word, key + i, size - i);
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 32;
+    }
+    return hash * 0x9E3779B97F4A7C15ULL;
+}
+
+CMP_BlockCache::CMP_BlockCache(unsigned int numTexels, unsigned int texelSize, unsigned int encodedSize, size_t numBlocks)
+{
+    m_texelSize   = texelSize;
+    m_blockSize   = numTexels * texelSize;
+    m_encodedSize = encodedSize;
+    m_lastUniform = false;
+    m_lastSlot    = 0;
+    m_hits        = 0;
+
+    // About one slot per block for small jobs
+    m_tableBits = CMP_BLOCKCACHE_MIN_BITS;
+    while ((m_tableBits < CMP_BLOCKCACHE_MAX_BITS) && (((size_t)1 << m_tableBits) < numBlocks))
+        m_tableBits++;
+
+    size_t numSlots = (size_t)1 << m_tableBits;
+    m_uniformKeys.resize(numSlots * m_texelSize);
+    m_uniformEncoded.resize(numSlots * m_encodedSize);
+    m_uniformValid.assign(numSlots, 0);
+    m_blockKeys.resize(numSlots * m_blockSize);
+    m_blockEncoded.resize(numSlots * m_encodedSize);
+    m_blockValid.assign(numSlots, 0);
+}
+
+bool CMP_BlockCache::Find(const void* srcBlock, void* encoded)
+{
+    const unsigned char* block = (const unsigned char*)srcBlock;
+
+    // All texels are equal when every byte equals the byte one texel before it
+    m_lastUniform = memcmp(block + m_texelSize, block, m_blockSize - m_texelSize) == 0;
+
+    size_t                      keySize = m_lastUniform ? m_texelSize : m_blockSize;
+    std::vector<unsigned char>& keys    = m_lastUniform ? m_uniformKeys : m_blockKeys;
+    std::vector<unsigned char>& codes   = m_lastUniform ? m_uniformEncoded : m_blockEncoded;
+    std::vector<unsigned char>& valid   = m_lastUniform ? m_uniformValid : m_blockValid;
+
+    m_lastSlot = (size_t)(HashKey(block, keySize) >> (64 - m_tableBits));
+
+    unsigned char* slotKey = &keys[m_lastSlot * keySize];
+    if (valid[m_lastSlot] && (memcmp(slotKey, block, keySize) == 0))
+    {
+        memcpy(encoded, &codes[m_lastSlot * m_encodedSize], m_encodedSize);
+        m_hits++;
+        return true;
+    }
+
+    // Keep the key now, codecs may change their source block while encoding it
+    memcpy(slotKey, block, keySize);
+    valid[m_lastSlot] = 0;
+    return false;
+}
+
+void CMP_BlockCache::Add(const void* encoded)
+{
+    std::vector<unsigned char>& codes = m_lastUniform ? m_uniformEncoded : m_blockEncoded;
+    std::vector<unsigned char>& valid = m_lastUniform ? m_uniformValid : m_blockValid;
+
+    memcpy(&codes[m_lastSlot * m_encodedSize], encoded, m_encodedSize);
+    valid[m_lastSlot] = 1;
+}
@@ -0,0 +1,104 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef _CMP_BLOCKCACHE_H_
+#define _CMP_BLOCKCACHE_H_
+
+#include <stddef.h>
+#include <vector>
+
+// Remembers the encodings of the source blocks of one compression job, so that
+// uniform blocks (solid colour regions, masks, padding) and exact duplicates of
+// earlier blocks are encoded only once.
+//
+// The encodings come from the codec itself, so the output is the same as when
+// every block is encoded. Uniform blocks are keyed by their single texel, so a
+// large table of solid colours stays cheap; other blocks are keyed by all of
+// their texels. Both tables are direct mapped: a new entry replaces the one in
+// its slot.
+//
+// A cache must only be used by one thread, and only for blocks encoded with the
+// same codec settings. Blocks must be read with the same padding as the codec
+// sees them.
+//
+// Codecs call Encode from their own block loop. CodecCompressTexture and
+// CodecCompressTextureThreaded hand each codec a whole buffer, so only the codec
+// sees its blocks, in the form its encoder reads them: 8 bit or float texels,
+// one channel per ATI1N/ATI2N block, swizzled or not. BC7 and BC6H encode on
+// their own threads and cache the output offset of the first encoding instead
+// of the encoding itself.
+class CMP_BlockCache
+{
+public:
+    // numTexels texels of texelSize bytes per source block, encodedSize bytes per
+    // encoding. numBlocks, the number of blocks of the job, sizes the tables.
+    CMP_BlockCache(unsigned int numTexels, unsigned int texelSize, unsigned int encodedSize, size_t numBlocks);
+
+    // Copies the encoding of srcBlock to encoded and returns true if a block with
+    // the same texels was added before
+    bool Find(const void* srcBlock, void* encoded);
+
+    // Adds the encoding of the block of the last Find, which returned false
+    void Add(const void* encoded);
+
+    // Copies the encoding of srcBlock to encoded and returns true if a block with
+    // the same texels was added before. Otherwise calls encodeBlock(), which must
+    // write encoded, adds the result and returns false.
+    template <typename EncodeBlock>
+    bool Encode(const void* srcBlock, void* encoded, EncodeBlock encodeBlock)
+    {
+        if (Find(srcBlock, encoded))
+            return true;
+
+        encodeBlock();
+        Add(encoded);
+        return false;
+    }
+
+    // Number of blocks found so far
+    size_t GetHits() const
+    {
+        return m_hits;
+    }
+
+private:
+    unsigned int m_texelSize;
+    unsigned int m_blockSize;
+    unsigned int m_encodedSize;
+    unsigned int m_tableBits;
+
+    // Slot of the last Find, reused by Add
+    bool   m_lastUniform;
+    size_t m_lastSlot;
+    size_t m_hits;
+
+    // Key bytes, encoding bytes and a valid flag per slot, for each table
+    std::vector<unsigned char> m_uniformKeys;
+    std::vector<unsigned char> m_uniformEncoded;
+    std::vector<unsigned char> m_uniformValid;
+    std::vector<unsigned char> m_blockKeys;
+    std::vector<unsigned char> m_blockEncoded;
+    std::vector<unsigned char> m_blockValid;
+};
+
+#endif
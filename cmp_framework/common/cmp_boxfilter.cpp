@@ -23,10 +23,13 @@
 //
 
 #include <stdio.h>
+#include <vector>
 #include "cmp_mips.h"
 #include "cmp_boxfilter.h"
 #include "format_conversion.h"
 #include "atiformats.h"
+#include "halfconvert.h"
+#include "cmp_profiler.h"
 
 // the filter used for mipmap generation, holds pixel pointers for the four corners of the box
 union BoxFilter
@@ -132,32 +135,26 @@ void CMP_SetMipLevelGammaf(MipLevel* pCurMipLevel, T* pdata, CMP_FLOAT Gamma, CM
     }
 }
 
-static CMP_FLOAT F16toF32(CMP_HALFSHORT f)
-{
-    CMP_HALF A;
-    A.setBits(f);
-    return ((CMP_FLOAT)A);
-}
-
 void CMP_SetMipLevelGammaHalfShort(MipLevel* pCurMipLevel, CMP_HALFSHORT* pdata, CMP_FLOAT Gamma, CMP_INT numchannels)
 {
+    // Work a row at a time so the half <-> float conversions can be batched
+    CMP_INT                rowElements = pCurMipLevel->m_nWidth * numchannels;
+    std::vector<CMP_FLOAT> row(rowElements);
+
     for (int y = 0; y < pCurMipLevel->m_nHeight; y++)
     {
+        CMP_HalfToFloatN(row.data(), (const unsigned short*)pdata, rowElements);
+
         for (int x = 0; x < pCurMipLevel->m_nWidth; x++)
         {
-            // calc Gamma for the all color channels
+            // calc Gamma for the all color channels, alpha is left as is
+            CMP_FLOAT* pixel = &row[x * numchannels];
             for (int i = 0; i < 3 && i < numchannels; i++)
-            {
-                CMP_FLOAT pixf = F16toF32(*pdata);  // convert short int to float
-                pixf           = pow(pixf, Gamma);  // Do gamma using float
-                CMP_HALF pixh  = pixf;              // back to half type
-                *pdata         = pixh.bits();       // back to short int bits
-                pdata++;                            // move on to next pixel
-            }
-            // if alpha skip it
-            if (numchannels > 3)
-                pdata++;
+                pixel[i] = pow(pixel[i], Gamma);
         }
+
+        CMP_FloatToHalfN((unsigned short*)pdata, row.data(), rowElements);
+        pdata += rowElements;
     }
 }
 
@@ -353,6 +350,8 @@ void GenerateMipmapLevel(MipLevel* currMipLevel, MipLevel** prevMipLevels, uint3
 //nMinSize : The size in pixels used to determine how many mip levels to generate. Once all dimensions are less than or equal to nMinSize your mipper should generate no more mip levels.
 CMP_INT CMP_API CMP_GenerateMIPLevelsEx(CMP_MipSet* pMipSet, CMP_CFilterParams* CFilterParam)
 {
+    CMP_PROFILE_SCOPE("Mip generation");
+
     CMP_CMIPS CMips;
     assert(pMipSet);
     assert(pMipSet->m_nMipLevels);
@@ -25,6 +25,7 @@
 #include "compressonator.h"
 
 #include "cmp_mips.h"
+#include "cmp_mipsetarena.h"
 #include "format_conversion.h"
 #include "atiformats.h"
 
@@ -189,7 +190,7 @@ CMP_ERROR CMP_API CMP_CreateMipSet(CMP_MipSet* pMipSet, CMP_INT nWidth, CMP_INT
 {
     CMP_CMIPS CMips;
 
-    pMipSet->m_Flags         = MS_FLAG_Default;
+    pMipSet->m_Flags         = MS_FLAG_Default | (pMipSet->m_Flags & MS_FLAG_ArenaAlloc);
     pMipSet->m_nHeight       = nHeight;
     pMipSet->m_nWidth        = nWidth;
     pMipSet->dwWidth         = 0;
@@ -967,6 +968,66 @@ bool CMP_CMIPS::AllocateAllMipLevels(CMP_MipLevelTable* pMipLevelTable, CMP_Text
     return true;
 }
 
+static CMP_DWORD CMP_MipLevelBitsPerPixel(CMP_ChannelFormat channelFormat, CMP_TextureDataType textureDataType)
+{
+    CMP_DWORD dwBitsPerPixel;
+    switch (channelFormat)
+    {
+    case CF_8bit:
+    case CF_2101010:
+    case CF_1010102:
+    case CF_Float9995E:
+        dwBitsPerPixel = 8;
+        break;
+
+    case CF_16bit:
+    case CF_Float16:
+        dwBitsPerPixel = 16;
+        break;
+
+    case CF_32bit:
+    case CF_Float32:
+        dwBitsPerPixel = 32;
+        break;
+
+    default:
+        return 0;
+    }
+
+    switch (textureDataType)
+    {
+    case TDT_XRGB:
+    case TDT_ARGB:
+    case TDT_NORMAL_MAP:
+        dwBitsPerPixel *= 4;
+        break;
+    case TDT_RGB:
+        dwBitsPerPixel *= 3;
+        break;
+    case TDT_RG:
+    case TDT_16:
+        dwBitsPerPixel *= 2;
+        break;
+    case TDT_R:
+    case TDT_8:
+        break;
+    default:
+        return 0;
+    }
+
+    return dwBitsPerPixel;
+}
+
+// Places the level data in its arena slot when the MipSet has an arena and the data fits, otherwise on the heap
+static CMP_BYTE* CMP_AllocateMipLevelBuffer(CMP_MipLevel* pMipLevel, size_t size, CMP_DWORD dwBitsPerPixel)
+{
+    CMP_BYTE* pData = CMP_AllocateMipSetArenaLevel(pMipLevel, size, dwBitsPerPixel);
+    if (pData)
+        return pData;
+
+    return reinterpret_cast<CMP_BYTE*>(malloc(size));
+}
+
 bool CMP_CMIPS::AllocateMipSet(CMP_MipSet*       pMipSet,
                                CMP_ChannelFormat channelFormat,
                                TextureDataType   textureDataType,
@@ -1015,6 +1076,9 @@ bool CMP_CMIPS::AllocateMipSet(CMP_MipSet*       pMipSet,
         }
         return false;
     }
+
+    CMP_RegisterMipSetArena(pMipSet, numLevelsToAllocate);
+
     return true;
 }
 
@@ -1025,49 +1089,9 @@ bool CMP_CMIPS::AllocateMipLevelData(CMP_MipLevel* pMipLevel, int nWidth, int nH
     assert(pMipLevel);
     assert(nWidth > 0 && nHeight > 0);
 
-    CMP_DWORD dwBitsPerPixel;
-    switch (channelFormat)
-    {
-    case CF_8bit:
-    case CF_2101010:
-    case CF_1010102:
-    case CF_Float9995E:
-        dwBitsPerPixel = 8;
-        break;
-
-    case CF_16bit:
-    case CF_Float16:
-        dwBitsPerPixel = 16;
-        break;
-
-    case CF_32bit:
-    case CF_Float32:
-        dwBitsPerPixel = 32;
-        break;
-
-    default:
-        assert(0);
-        return false;
-    }
-
-    switch (textureDataType)
+    CMP_DWORD dwBitsPerPixel = CMP_MipLevelBitsPerPixel(channelFormat, textureDataType);
+    if (dwBitsPerPixel == 0)
     {
-    case TDT_XRGB:
-    case TDT_ARGB:
-    case TDT_NORMAL_MAP:
-        dwBitsPerPixel *= 4;
-        break;
-    case TDT_RGB:
-        dwBitsPerPixel *= 3;
-        break;
-    case TDT_RG:
-    case TDT_16:
-        dwBitsPerPixel *= 2;
-        break;
-    case TDT_R:
-    case TDT_8:
-        break;
-    default:
         assert(0);
         return false;
     }
@@ -1077,7 +1101,7 @@ bool CMP_CMIPS::AllocateMipLevelData(CMP_MipLevel* pMipLevel, int nWidth, int nH
     pMipLevel->m_nHeight      = nHeight;
     pMipLevel->m_dwLinearSize = dwPitch * nHeight;
 
-    pMipLevel->m_pbData = reinterpret_cast<CMP_BYTE*>(malloc(pMipLevel->m_dwLinearSize));
+    pMipLevel->m_pbData = CMP_AllocateMipLevelBuffer(pMipLevel, pMipLevel->m_dwLinearSize, dwBitsPerPixel);
 
     return (pMipLevel->m_pbData != NULL);
 }
@@ -1092,7 +1116,7 @@ bool CMP_CMIPS::AllocateCompressedMipLevelData(CMP_MipLevel* pMipLevel, int nWid
     pMipLevel->m_nWidth       = nWidth;
     pMipLevel->m_nHeight      = nHeight;
 
-    pMipLevel->m_pbData = reinterpret_cast<CMP_BYTE*>(malloc(pMipLevel->m_dwLinearSize));
+    pMipLevel->m_pbData = CMP_AllocateMipLevelBuffer(pMipLevel, pMipLevel->m_dwLinearSize, 0);
 
     return (pMipLevel->m_pbData != NULL);
 }
@@ -1102,9 +1126,11 @@ void CMP_CMIPS::FreeMipLevelData(CMP_MipLevel* pMipLevel)
     if (!pMipLevel)
         return;
     // Other formats, all use variations of malloc which means they are safe to use with free.
+    // Data placed in the MipSet arena is released with the arena in FreeMipSet.
     if (pMipLevel->m_pbData)
     {
-        free(pMipLevel->m_pbData);
+        if (!CMP_IsMipSetArenaLevelData(pMipLevel))
+            free(pMipLevel->m_pbData);
         pMipLevel->m_pbData = NULL;
     }
 }
@@ -1171,6 +1197,8 @@ void CMP_CMIPS::FreeMipSet(CMP_MipSet* pMipSet)
                 }
             }
 
+            CMP_FreeMipSetArena(pMipSet);
+
             free(pMipSet->m_pMipLevelTable);
             pMipSet->m_pMipLevelTable = NULL;
             pMipSet->m_nMaxMipLevels  = 0;
@@ -0,0 +1,311 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "cmp_mipsetarena.h"
+#include "cmp_mips.h"
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+//--------------------------------------------------------------------------------------------
+// One block is reserved for the whole MipSet and split into a slot per MipLevel, in the same
+// order as the MipLevel table. The block is reserved when the first level's data is allocated,
+// so MipSets whose levels adopt buffers from elsewhere never reserve one.
+//--------------------------------------------------------------------------------------------
+
+#define CMP_ARENA_ALIGNMENT 64
+#define CMP_ARENA_HUGEPAGE_SIZE (2 * 1024 * 1024)
+#define CMP_ARENA_HUGEPAGE_MIN (4 * 1024 * 1024)  // Smaller arenas are not worth a huge page alignment
+
+struct CMP_MipSetArena;
+
+struct CMP_ArenaSlot
+{
+    CMP_MipSetArena* pArena;
+    CMP_MipLevel*    pMipLevel;
+    int              nWidth;
+    int              nHeight;
+    CMP_BYTE*        pData;
+    size_t           capacity;
+};
+
+struct CMP_MipSetArena
+{
+    bool                       bSized;  // Set by the first level allocation, pBase stays NULL if no arena could be used
+    CMP_BYTE*                  pBase;
+    size_t                     size;
+    CMP_ArenaFree_Proc         pFree;  // Kept with the arena so it is released by the allocator that reserved it
+    void*                      pUserData;
+    std::vector<CMP_ArenaSlot> slots;
+};
+
+static void* CMP_API CMP_DefaultArenaAlloc(size_t size, size_t alignment, void* /*pUserData*/)
+{
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* pArena = NULL;
+    if (posix_memalign(&pArena, alignment, size) != 0)
+        return NULL;
+#ifdef MADV_HUGEPAGE
+    if (alignment >= CMP_ARENA_HUGEPAGE_SIZE)
+        madvise(pArena, size, MADV_HUGEPAGE);
+#endif
+    return pArena;
+#endif
+}
+
+static void CMP_API CMP_DefaultArenaFree(void* pArena, size_t /*size*/, void* /*pUserData*/)
+{
+#ifdef _WIN32
+    _aligned_free(pArena);
+#else
+    free(pArena);
+#endif
+}
+
+static std::mutex          g_ArenaMutex;
+static CMP_MipSetAllocator g_MipSetAllocator = {CMP_DefaultArenaAlloc, CMP_DefaultArenaFree, NULL, false};
+
+// Arenas by MipLevel table, and their slots by MipLevel
+static std::unordered_map<const void*, CMP_MipSetArena*>         g_Arenas;
+static std::unordered_map<const CMP_MipLevel*, CMP_ArenaSlot*> g_ArenaSlots;
+static std::atomic<size_t>                                        g_nArenaSlots(0);  // Lets MipSets without arenas skip the lock
+
+CMP_VOID CMP_API CMP_SetMipSetAllocator(const CMP_MipSetAllocator* pAllocator)
+{
+    std::lock_guard<std::mutex> lock(g_ArenaMutex);
+
+    if (pAllocator && pAllocator->pAlloc && pAllocator->pFree)
+        g_MipSetAllocator = *pAllocator;
+    else
+    {
+        g_MipSetAllocator.pAlloc      = CMP_DefaultArenaAlloc;
+        g_MipSetAllocator.pFree       = CMP_DefaultArenaFree;
+        g_MipSetAllocator.pUserData   = NULL;
+        g_MipSetAllocator.bAllMipSets = pAllocator ? pAllocator->bAllMipSets : false;
+    }
+}
+
+// Drops the table entries of an arena, called with g_ArenaMutex held
+static void CMP_ForgetMipSetArena(const void* pMipLevelTable, CMP_MipSetArena* pArena)
+{
+    for (CMP_ArenaSlot& slot : pArena->slots)
+    {
+        auto it = g_ArenaSlots.find(slot.pMipLevel);
+        if (it != g_ArenaSlots.end() && it->second == &slot)
+        {
+            g_ArenaSlots.erase(it);
+            g_nArenaSlots--;
+        }
+    }
+    g_Arenas.erase(pMipLevelTable);
+}
+
+void CMP_API CMP_RegisterMipSetArena(CMP_MipSet* pMipSet, CMP_INT nLevelsAllocated)
+{
+    std::lock_guard<std::mutex> lock(g_ArenaMutex);
+
+    // A MipSet that was not released with FreeMipSet can leave entries for memory that has been reused
+    if (!g_Arenas.empty())
+    {
+        auto it = g_Arenas.find(pMipSet->m_pMipLevelTable);
+        if (it != g_Arenas.end())
+            CMP_ForgetMipSetArena(it->first, it->second);
+        for (int i = 0; i < nLevelsAllocated; i++)
+        {
+            if (g_ArenaSlots.erase(pMipSet->m_pMipLevelTable[i]))
+                g_nArenaSlots--;
+        }
+    }
+
+    if (!(pMipSet->m_Flags & MS_FLAG_ArenaAlloc) && !g_MipSetAllocator.bAllMipSets)
+        return;
+
+    CMP_MipSetArena* pArena = new CMP_MipSetArena();
+    pArena->bSized          = false;
+    pArena->pBase           = NULL;
+    pArena->size            = 0;
+    pArena->pFree           = NULL;
+    pArena->pUserData       = NULL;
+    pArena->slots.resize(nLevelsAllocated);
+
+    // Walk the levels and faces in the order GetMipLevel indexes the table
+    int index  = 0;
+    int nDepth = pMipSet->m_nDepth;
+    for (int nMipLevel = 0; nMipLevel < pMipSet->m_nMaxMipLevels && index < nLevelsAllocated; nMipLevel++)
+    {
+        int nFaces = (pMipSet->m_TextureType == TT_CubeMap || pMipSet->m_TextureType == TT_VolumeTexture) ? nDepth : 1;
+        for (int nFace = 0; nFace < nFaces && index < nLevelsAllocated; nFace++, index++)
+        {
+            CMP_ArenaSlot& slot = pArena->slots[index];
+            slot.pArena         = pArena;
+            slot.pMipLevel      = pMipSet->m_pMipLevelTable[index];
+            slot.nWidth         = CMP_MAX(pMipSet->m_nWidth >> nMipLevel, 1);
+            slot.nHeight        = CMP_MAX(pMipSet->m_nHeight >> nMipLevel, 1);
+            slot.pData          = NULL;
+            slot.capacity       = 0;
+
+            g_ArenaSlots[slot.pMipLevel] = &slot;
+            g_nArenaSlots++;
+        }
+
+        if (pMipSet->m_TextureType == TT_VolumeTexture && nDepth > 1)
+            nDepth >>= 1;
+    }
+
+    g_Arenas[pMipSet->m_pMipLevelTable] = pArena;
+}
+
+static size_t CMP_ArenaSlotSize(size_t size)
+{
+    return (size + CMP_ARENA_ALIGNMENT - 1) & ~static_cast<size_t>(CMP_ARENA_ALIGNMENT - 1);
+}
+
+static size_t CMP_ArenaBlocks(int nWidth, int nHeight)
+{
+    return static_cast<size_t>((nWidth + 3) / 4) * ((nHeight + 3) / 4);
+}
+
+// Sizes every slot like the first level allocated and reserves the arena, called with g_ArenaMutex held
+static void CMP_ReserveMipSetArena(CMP_MipSetArena* pArena, const CMP_MipLevel* pMipLevel, size_t levelSize, CMP_DWORD dwBitsPerPixel)
+{
+    pArena->bSized = true;
+
+    // Data given only by its size, as CMP_CreateMipSet also does for uncompressed levels, is taken
+    // to be in 4x4 blocks when it divides evenly into them, else to be whole bytes per pixel
+    size_t blockSize = 0;
+    if (dwBitsPerPixel == 0)
+    {
+        size_t nBlocks = CMP_ArenaBlocks(pMipLevel->m_nWidth, pMipLevel->m_nHeight);
+        size_t nPixels = static_cast<size_t>(pMipLevel->m_nWidth) * pMipLevel->m_nHeight;
+        if (nBlocks > 0 && levelSize % nBlocks == 0)
+            blockSize = levelSize / nBlocks;
+        else if (nPixels > 0 && levelSize % nPixels == 0)
+            dwBitsPerPixel = static_cast<CMP_DWORD>(levelSize / nPixels * 8);
+        else
+            return;  // The levels are allocated individually
+    }
+
+    size_t size = 0;
+    for (CMP_ArenaSlot& slot : pArena->slots)
+    {
+        // Levels that already hold data, such as an adopted decoder buffer, get no slot
+        if (slot.pMipLevel != pMipLevel && slot.pMipLevel->m_pbData)
+            slot.capacity = 0;
+        else if (dwBitsPerPixel)
+            slot.capacity = CMP_ArenaSlotSize(static_cast<size_t>(CMP_PAD_BYTE(slot.nWidth, dwBitsPerPixel)) * slot.nHeight);
+        else
+            slot.capacity = CMP_ArenaSlotSize(CMP_ArenaBlocks(slot.nWidth, slot.nHeight) * blockSize);
+        size += slot.capacity;
+    }
+
+    size_t alignment = CMP_ARENA_ALIGNMENT;
+    if (size >= CMP_ARENA_HUGEPAGE_MIN)
+    {
+        alignment = CMP_ARENA_HUGEPAGE_SIZE;
+        size      = (size + CMP_ARENA_HUGEPAGE_SIZE - 1) & ~static_cast<size_t>(CMP_ARENA_HUGEPAGE_SIZE - 1);
+    }
+
+    // Not an error if this fails, the levels are allocated individually instead
+    pArena->pBase = reinterpret_cast<CMP_BYTE*>(g_MipSetAllocator.pAlloc(size, alignment, g_MipSetAllocator.pUserData));
+    if (!pArena->pBase)
+        return;
+
+    pArena->size      = size;
+    pArena->pFree     = g_MipSetAllocator.pFree;
+    pArena->pUserData = g_MipSetAllocator.pUserData;
+
+    CMP_BYTE* pData = pArena->pBase;
+    for (CMP_ArenaSlot& slot : pArena->slots)
+    {
+        if (slot.capacity)
+            slot.pData = pData;
+        pData += slot.capacity;
+    }
+}
+
+CMP_BYTE* CMP_API CMP_AllocateMipSetArenaLevel(CMP_MipLevel* pMipLevel, size_t size, CMP_DWORD dwBitsPerPixel)
+{
+    if (g_nArenaSlots == 0)
+        return NULL;
+
+    std::lock_guard<std::mutex> lock(g_ArenaMutex);
+
+    auto it = g_ArenaSlots.find(pMipLevel);
+    if (it == g_ArenaSlots.end())
+        return NULL;
+
+    CMP_ArenaSlot*   pSlot  = it->second;
+    CMP_MipSetArena* pArena = pSlot->pArena;
+    if (!pArena->bSized)
+        CMP_ReserveMipSetArena(pArena, pMipLevel, size, dwBitsPerPixel);
+
+    if (pSlot->pData && size <= pSlot->capacity)
+        return pSlot->pData;
+
+    return NULL;
+}
+
+CMP_BOOL CMP_API CMP_IsMipSetArenaLevelData(const CMP_MipLevel* pMipLevel)
+{
+    if (g_nArenaSlots == 0)
+        return false;
+
+    std::lock_guard<std::mutex> lock(g_ArenaMutex);
+
+    auto it = g_ArenaSlots.find(pMipLevel);
+    return (it != g_ArenaSlots.end()) && it->second->pData && (pMipLevel->m_pbData == it->second->pData);
+}
+
+void CMP_API CMP_FreeMipSetArena(CMP_MipSet* pMipSet)
+{
+    if (g_nArenaSlots == 0)
+        return;
+
+    CMP_MipSetArena* pArena = NULL;
+    {
+        std::lock_guard<std::mutex> lock(g_ArenaMutex);
+
+        auto it = g_Arenas.find(pMipSet->m_pMipLevelTable);
+        if (it == g_Arenas.end())
+            return;
+
+        pArena = it->second;
+        CMP_ForgetMipSetArena(it->first, pArena);
+    }
+
+    if (pArena->pBase)
+        pArena->pFree(pArena->pBase, pArena->size, pArena->pUserData);
+    delete pArena;
+}
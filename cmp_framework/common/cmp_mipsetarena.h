@@ -0,0 +1,58 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// cmp_mipsetarena.h : Single allocation backing for the MipLevels of a MipSet
+//
+
+#ifndef _CMP_MIPSETARENA_H_
+#define _CMP_MIPSETARENA_H_
+
+#include "compressonator.h"
+
+// Used by CMP_CMIPS for MipSets allocated with MS_FLAG_ArenaAlloc, or for every
+// MipSet when CMP_MipSetAllocator::bAllMipSets is set.
+//
+// The arenas are kept in a table of the library, keyed by the MipLevel table and
+// the MipLevels of their MipSet, so CMP_MipSet and CMP_MipLevel keep their
+// layout. Copies of a CMP_MipSet share its MipLevels and so share its arena.
+//
+// cmp_mipsetarena.cpp is only built into CMP_Framework. CMP_Compressonator
+// compiles its own CMP_CMIPS and calls these exports, so there is one table and
+// one allocator per process.
+
+// Registers the MipLevels of a MipSet whose MipLevel table has just been
+// allocated. Nothing is reserved until a level's data is allocated.
+void CMP_API CMP_RegisterMipSetArena(CMP_MipSet* pMipSet, CMP_INT nLevelsAllocated);
+
+// Returns the arena slot for size bytes of pMipLevel data, NULL when the level
+// has no arena or the data does not fit in its slot. The first call for a MipSet
+// reserves its arena, sizing every slot like this level: dwBitsPerPixel for
+// uncompressed data, or 0 for data in 4x4 blocks of the same size.
+CMP_BYTE* CMP_API CMP_AllocateMipSetArenaLevel(CMP_MipLevel* pMipLevel, size_t size, CMP_DWORD dwBitsPerPixel);
+
+// True when the data of pMipLevel lives in an arena and must not be freed
+CMP_BOOL CMP_API CMP_IsMipSetArenaLevelData(const CMP_MipLevel* pMipLevel);
+
+// Releases the arena of a MipSet whose MipLevel data has been freed
+void CMP_API CMP_FreeMipSetArena(CMP_MipSet* pMipSet);
+
+#endif
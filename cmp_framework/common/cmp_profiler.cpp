@@ -0,0 +1,238 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "cmp_profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Events kept before new ones are dropped, about 40 MB
+#define CMP_PROFILER_MAX_EVENTS (1 << 20)
+
+typedef struct
+{
+    const char*  name;
+    bool         isCounter;
+    int          arg;       // Scope argument, -1 for none
+    unsigned int thread;    // Small thread number, 1 for the first thread seen
+    long long    start;     // Microseconds since the profiler was enabled
+    long long    duration;  // Scope duration in microseconds, or the counter total
+} CMP_ProfileEvent;
+
+static std::atomic<bool>                g_profilerEnabled(false);
+static std::atomic<unsigned int>        g_profilerThreads(0);
+static std::mutex                       g_profilerMutex;
+static std::vector<CMP_ProfileEvent>    g_profilerEvents;
+static std::map<std::string, long long> g_profilerCounters;
+static size_t                           g_profilerDropped = 0;
+
+static long long SteadyMicroseconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Written under the mutex by Enable and Reset, read by every scope without it
+static std::atomic<long long> g_profilerStart(SteadyMicroseconds());
+
+static long long ProfilerNow()
+{
+    return SteadyMicroseconds() - g_profilerStart.load(std::memory_order_relaxed);
+}
+
+static unsigned int ProfilerThread()
+{
+    static thread_local unsigned int thread = 0;
+    if (thread == 0)
+        thread = ++g_profilerThreads;
+    return thread;
+}
+
+static void AddEvent(const CMP_ProfileEvent& event)
+{
+    if (g_profilerEvents.size() < CMP_PROFILER_MAX_EVENTS)
+        g_profilerEvents.push_back(event);
+    else
+        g_profilerDropped++;
+}
+
+CMP_VOID CMP_API CMP_Profiler_Enable(CMP_BOOL enable)
+{
+    std::lock_guard<std::mutex> lock(g_profilerMutex);
+    if (enable && !g_profilerEnabled)
+        g_profilerStart.store(SteadyMicroseconds(), std::memory_order_relaxed);
+    g_profilerEnabled = enable;
+}
+
+CMP_BOOL CMP_API CMP_Profiler_IsEnabled()
+{
+    return g_profilerEnabled.load(std::memory_order_relaxed);
+}
+
+CMP_VOID CMP_API CMP_Profiler_Reset()
+{
+    std::lock_guard<std::mutex> lock(g_profilerMutex);
+    g_profilerEvents.clear();
+    g_profilerCounters.clear();
+    g_profilerDropped = 0;
+    g_profilerStart.store(SteadyMicroseconds(), std::memory_order_relaxed);
+}
+
+CMP_VOID CMP_API CMP_Profiler_Count(const char* name, long long value)
+{
+    if (!CMP_Profiler_IsEnabled())
+        return;
+
+    unsigned int                thread = ProfilerThread();
+    std::lock_guard<std::mutex> lock(g_profilerMutex);
+
+    long long& total = g_profilerCounters[name];
+    total += value;
+
+    CMP_ProfileEvent event = {name, true, -1, thread, ProfilerNow(), total};
+    AddEvent(event);
+}
+
+long long CMP_API CMP_Profiler_Time()
+{
+    return ProfilerNow();
+}
+
+CMP_VOID CMP_API CMP_Profiler_AddScope(const char* name, CMP_INT arg, long long start)
+{
+    long long                   end    = ProfilerNow();
+    unsigned int                thread = ProfilerThread();
+    std::lock_guard<std::mutex> lock(g_profilerMutex);
+
+    CMP_ProfileEvent event = {name, false, arg, thread, start, end - start};
+    AddEvent(event);
+}
+
+// Names are literals from this code base, only quotes and backslashes need escaping
+static void WriteJSONString(FILE* fp, const char* str)
+{
+    fputc('"', fp);
+    for (; *str; str++)
+    {
+        if ((*str == '"') || (*str == '\\'))
+            fputc('\\', fp);
+        fputc(*str, fp);
+    }
+    fputc('"', fp);
+}
+
+CMP_BOOL CMP_API CMP_Profiler_WriteTrace(const char* fileName)
+{
+    FILE* fp = fopen(fileName, "w");
+    if (!fp)
+        return false;
+
+    std::lock_guard<std::mutex> lock(g_profilerMutex);
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (size_t i = 0; i < g_profilerEvents.size(); i++)
+    {
+        const CMP_ProfileEvent& event = g_profilerEvents[i];
+
+        fprintf(fp, "{\"name\":");
+        WriteJSONString(fp, event.name);
+        if (event.isCounter)
+        {
+            fprintf(fp, ",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%lld,\"args\":{\"value\":%lld}}", event.thread, event.start, event.duration);
+        }
+        else
+        {
+            fprintf(fp, ",\"cat\":\"cmp\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lld,\"dur\":%lld", event.thread, event.start, event.duration);
+            if (event.arg >= 0)
+                fprintf(fp, ",\"args\":{\"level\":%d}", event.arg);
+            fprintf(fp, "}");
+        }
+        fprintf(fp, "%s\n", (i + 1 < g_profilerEvents.size()) ? "," : "");
+    }
+    fprintf(fp, "]}\n");
+
+    bool result = !ferror(fp);
+    fclose(fp);
+    return result;
+}
+
+CMP_VOID CMP_API CMP_Profiler_PrintSummary(FILE* fp)
+{
+    typedef struct
+    {
+        std::string name;
+        size_t      calls;
+        long long   total;
+        long long   longest;
+    } ScopeSummary;
+
+    std::lock_guard<std::mutex> lock(g_profilerMutex);
+
+    // Scope names in order of first completion
+    std::vector<ScopeSummary> scopes;
+    for (size_t i = 0; i < g_profilerEvents.size(); i++)
+    {
+        const CMP_ProfileEvent& event = g_profilerEvents[i];
+        if (event.isCounter)
+            continue;
+
+        size_t s = 0;
+        while ((s < scopes.size()) && (scopes[s].name != event.name))
+            s++;
+        if (s == scopes.size())
+        {
+            ScopeSummary summary = {event.name, 0, 0, 0};
+            scopes.push_back(summary);
+        }
+
+        scopes[s].calls++;
+        scopes[s].total += event.duration;
+        if (event.duration > scopes[s].longest)
+            scopes[s].longest = event.duration;
+    }
+
+    fprintf(fp, "\n%-24s %8s %12s %12s %12s\n", "Stage", "Calls", "Total ms", "Average ms", "Longest ms");
+    for (size_t s = 0; s < scopes.size(); s++)
+    {
+        fprintf(fp,
+                "%-24s %8zu %12.3f %12.3f %12.3f\n",
+                scopes[s].name.c_str(),
+                scopes[s].calls,
+                scopes[s].total / 1000.0,
+                scopes[s].total / 1000.0 / scopes[s].calls,
+                scopes[s].longest / 1000.0);
+    }
+
+    if (!g_profilerCounters.empty())
+    {
+        fprintf(fp, "\n%-24s %12s\n", "Counter", "Total");
+        for (std::map<std::string, long long>::const_iterator it = g_profilerCounters.begin(); it != g_profilerCounters.end(); ++it)
+            fprintf(fp, "%-24s %12lld\n", it->first.c_str(), it->second);
+    }
+
+    if (g_profilerDropped > 0)
+        fprintf(fp, "\n%zu events were not recorded, the limit is %d\n", g_profilerDropped, CMP_PROFILER_MAX_EVENTS);
+}
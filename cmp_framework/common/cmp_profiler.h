@@ -0,0 +1,89 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// cmp_profiler.h : Timing of the stages of a compression job
+//
+
+#ifndef _CMP_PROFILER_H_
+#define _CMP_PROFILER_H_
+
+#include "compressonator.h"
+
+// Records how long the stages of a job take (load, format conversion, mip
+// generation, encode, analysis, save) and counts the work they do, for finding
+// regressions and tuning thread counts. The CMP_Profiler_ functions declared in
+// compressonator.h enable the recording and write it out.
+//
+// Nothing is recorded until CMP_Profiler_Enable(true) is called. While it is
+// disabled a scope or counter only tests a flag. Defining CMP_NO_PROFILER
+// removes the macros from a build altogether.
+//
+// Names are kept by pointer and must be string literals. Scopes may be nested
+// and used from any thread.
+//
+// Use example:
+//     CMP_PROFILE_SCOPE_ARG("Encode mip", nMipLevel);
+//     ...
+//     CMP_PROFILE_COUNT("Blocks encoded", dwBlocksX * dwBlocksY);
+
+// Times its lifetime under name. arg, when 0 or more, is shown with the scope
+// in the trace, for example the mip level being processed.
+class CMP_ProfileScope
+{
+public:
+    CMP_ProfileScope(const char* name, int arg = -1)
+        : m_name(CMP_Profiler_IsEnabled() ? name : NULL)
+        , m_arg(arg)
+        , m_start(m_name ? CMP_Profiler_Time() : 0)
+    {
+    }
+
+    ~CMP_ProfileScope()
+    {
+        if (m_name)
+            CMP_Profiler_AddScope(m_name, m_arg, m_start);
+    }
+
+private:
+    const char* m_name;  // NULL when not recording
+    int         m_arg;
+    long long   m_start;
+};
+
+#ifndef CMP_NO_PROFILER
+#define CMP_PROFILE_CONCAT_(a, b) a##b
+#define CMP_PROFILE_CONCAT(a, b) CMP_PROFILE_CONCAT_(a, b)
+#define CMP_PROFILE_SCOPE(name) CMP_ProfileScope CMP_PROFILE_CONCAT(cmp_profile_scope_, __LINE__)(name)
+#define CMP_PROFILE_SCOPE_ARG(name, arg) CMP_ProfileScope CMP_PROFILE_CONCAT(cmp_profile_scope_, __LINE__)(name, (int)(arg))
+#define CMP_PROFILE_COUNT(name, value)                    \
+    do                                                    \
+    {                                                     \
+        if (CMP_Profiler_IsEnabled())                     \
+            CMP_Profiler_Count(name, (long long)(value)); \
+    } while (0)
+#else
+#define CMP_PROFILE_SCOPE(name)
+#define CMP_PROFILE_SCOPE_ARG(name, arg)
+#define CMP_PROFILE_COUNT(name, value)
+#endif
+
+#endif
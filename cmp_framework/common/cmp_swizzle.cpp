@@ -0,0 +1,413 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "cmp_swizzle.h"
+
+#include <string.h>
+#include <atomic>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CMP_SWIZZLE_USE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(CMP_SWIZZLE_USE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CMP_SWIZZLE_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define CMP_SWIZZLE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CMP_SWIZZLE_TARGET_SSSE3
+#define CMP_SWIZZLE_TARGET_AVX2
+#endif
+
+#define CMP_SWIZZLE_MAX_ELEMENT 16
+
+//-------------------------------------------------------------
+// Scalar conversion
+//-------------------------------------------------------------
+
+static void SwizzleScalar(unsigned char* dst, const unsigned char* src, size_t count, unsigned int elementSize, const unsigned char* map)
+{
+    unsigned char element[CMP_SWIZZLE_MAX_ELEMENT];
+
+    for (size_t i = 0; i < count; i++)
+    {
+        // Copied first so that dst can be src
+        memcpy(element, src, elementSize);
+        for (unsigned int j = 0; j < elementSize; j++)
+            dst[j] = element[map[j]];
+        src += elementSize;
+        dst += elementSize;
+    }
+}
+
+static void ExpandToRGBA8Scalar(unsigned char* dst, const unsigned char* src, size_t count, unsigned int srcSize, const unsigned char* map, unsigned char alpha)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned char c0 = src[map[0]];
+        unsigned char c1 = src[map[1]];
+        unsigned char c2 = src[map[2]];
+        dst[0]           = c0;
+        dst[1]           = c1;
+        dst[2]           = c2;
+        dst[3]           = alpha;
+        src += srcSize;
+        dst += 4;
+    }
+}
+
+static void ExtractChannelScalar(unsigned char* dst, const unsigned char* src, size_t count, unsigned int numChannels, unsigned int channel)
+{
+    src += channel;
+    for (size_t i = 0; i < count; i++)
+    {
+        dst[i] = *src;
+        src += numChannels;
+    }
+}
+
+#ifdef CMP_SWIZZLE_USE_X86
+
+//-------------------------------------------------------------
+// SSSE3 conversion
+//-------------------------------------------------------------
+
+// pshufb mask that applies map to every whole element of a 16 byte register.
+// The bytes after the last whole element are left as they are, so that storing
+// the full register writes them back unchanged. Returns the number of bytes
+// converted per register.
+static unsigned int SwizzleMask(unsigned char mask[16], unsigned int elementSize, const unsigned char* map)
+{
+    unsigned int chunk = 0;
+    for (; chunk + elementSize <= 16; chunk += elementSize)
+    {
+        for (unsigned int j = 0; j < elementSize; j++)
+            mask[chunk + j] = (unsigned char)(chunk + map[j]);
+    }
+    for (unsigned int k = chunk; k < 16; k++)
+        mask[k] = (unsigned char)k;
+    return chunk;
+}
+
+// pshufb mask that expands the 4 pixels of srcSize bytes at the start of a register to 4 bytes each,
+// with zero in the alpha bytes
+static void ExpandMask(unsigned char mask[16], unsigned int srcSize, const unsigned char* map)
+{
+    for (unsigned int p = 0; p < 4; p++)
+    {
+        mask[4 * p]     = (unsigned char)(p * srcSize + map[0]);
+        mask[4 * p + 1] = (unsigned char)(p * srcSize + map[1]);
+        mask[4 * p + 2] = (unsigned char)(p * srcSize + map[2]);
+        mask[4 * p + 3] = 0x80;
+    }
+}
+
+// Converts the whole registers of bytes with a mask from SwizzleMask, returns the number of bytes converted
+CMP_SWIZZLE_TARGET_SSSE3 static size_t SwizzleRegisters(unsigned char* dst, const unsigned char* src, size_t bytes, unsigned int chunk, __m128i mask)
+{
+    // Each step reads and writes 16 bytes but only advances by the whole elements it converted.
+    // The next register is loaded before the current one is stored, so that in place conversions
+    // never load bytes that were just stored, which would stall store forwarding.
+    size_t i = 0;
+    if (bytes >= 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)src);
+        for (; i + chunk + 16 <= bytes; i += chunk)
+        {
+            __m128i next = _mm_loadu_si128((const __m128i*)(src + i + chunk));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_shuffle_epi8(v, mask));
+            v = next;
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_shuffle_epi8(v, mask));
+        i += chunk;
+    }
+    return i;
+}
+
+CMP_SWIZZLE_TARGET_SSSE3 static void SwizzleSSSE3(unsigned char* dst, const unsigned char* src, size_t count, unsigned int elementSize, const unsigned char* map)
+{
+    unsigned char maskBytes[16];
+    unsigned int  chunk = SwizzleMask(maskBytes, elementSize, map);
+
+    size_t bytes = count * elementSize;
+    size_t i     = SwizzleRegisters(dst, src, bytes, chunk, _mm_loadu_si128((const __m128i*)maskBytes));
+    SwizzleScalar(dst + i, src + i, (bytes - i) / elementSize, elementSize, map);
+}
+
+CMP_SWIZZLE_TARGET_SSSE3 static void ExpandToRGBA8SSSE3(unsigned char* dst, const unsigned char* src, size_t count, unsigned int srcSize, const unsigned char* map, unsigned char alpha)
+{
+    unsigned char maskBytes[16];
+    ExpandMask(maskBytes, srcSize, map);
+    __m128i mask  = _mm_loadu_si128((const __m128i*)maskBytes);
+    __m128i alpha4 = _mm_set1_epi32((int)((unsigned int)alpha << 24));
+
+    // 4 pixels per step, the load must stay within the source
+    size_t i = 0;
+    for (; (count - i) * srcSize >= 16; i += 4)
+    {
+        __m128i pixels = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i * srcSize)), mask);
+        _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_or_si128(pixels, alpha4));
+    }
+    ExpandToRGBA8Scalar(dst + i * 4, src + i * srcSize, count - i, srcSize, map, alpha);
+}
+
+CMP_SWIZZLE_TARGET_SSSE3 static void ExtractChannelSSSE3(unsigned char* dst, const unsigned char* src, size_t count, unsigned int numChannels, unsigned int channel)
+{
+    size_t i = 0;
+    if (numChannels == 4)
+    {
+        // Gathers the channel of 4 pixels in the low 4 bytes of each register, then packs 4 registers together
+        char    c    = (char)channel;
+        __m128i mask = _mm_setr_epi8(c, c + 4, c + 8, c + 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i* s  = (const __m128i*)(src + i * 4);
+            __m128i        p0 = _mm_shuffle_epi8(_mm_loadu_si128(s), mask);
+            __m128i        p1 = _mm_shuffle_epi8(_mm_loadu_si128(s + 1), mask);
+            __m128i        p2 = _mm_shuffle_epi8(_mm_loadu_si128(s + 2), mask);
+            __m128i        p3 = _mm_shuffle_epi8(_mm_loadu_si128(s + 3), mask);
+            __m128i        lo = _mm_unpacklo_epi32(p0, p1);
+            __m128i        hi = _mm_unpacklo_epi32(p2, p3);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi64(lo, hi));
+        }
+    }
+    ExtractChannelScalar(dst + i, src + i * numChannels, count - i, numChannels, channel);
+}
+
+//-------------------------------------------------------------
+// AVX2 conversion
+//-------------------------------------------------------------
+
+CMP_SWIZZLE_TARGET_AVX2 static void SwizzleAVX2(unsigned char* dst, const unsigned char* src, size_t count, unsigned int elementSize, const unsigned char* map)
+{
+    // pshufb does not cross 128 bit lanes, so elements that straddle them are left to SSSE3
+    if (16 % elementSize)
+    {
+        SwizzleSSSE3(dst, src, count, elementSize, map);
+        return;
+    }
+
+    unsigned char maskBytes[16];
+    unsigned int  chunk  = SwizzleMask(maskBytes, elementSize, map);
+    __m128i       mask16 = _mm_loadu_si128((const __m128i*)maskBytes);
+    __m256i       mask   = _mm256_broadcastsi128_si256(mask16);
+
+    size_t bytes = count * elementSize;
+    size_t i     = 0;
+    for (; i + 32 <= bytes; i += 32)
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src + i)), mask));
+    i += SwizzleRegisters(dst + i, src + i, bytes - i, chunk, mask16);
+    SwizzleScalar(dst + i, src + i, (bytes - i) / elementSize, elementSize, map);
+}
+
+CMP_SWIZZLE_TARGET_AVX2 static void ExpandToRGBA8AVX2(unsigned char* dst, const unsigned char* src, size_t count, unsigned int srcSize, const unsigned char* map, unsigned char alpha)
+{
+    unsigned char maskBytes[16];
+    ExpandMask(maskBytes, srcSize, map);
+    __m256i mask   = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)maskBytes));
+    __m256i alpha8 = _mm256_set1_epi32((int)((unsigned int)alpha << 24));
+
+    // 8 pixels per step, 4 in each lane, the loads must stay within the source
+    size_t i = 0;
+    for (; (count - i) * srcSize >= 4 * srcSize + 16; i += 8)
+    {
+        const unsigned char* s      = src + i * srcSize;
+        __m256i              pixels = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)s));
+        pixels                      = _mm256_inserti128_si256(pixels, _mm_loadu_si128((const __m128i*)(s + 4 * srcSize)), 1);
+        pixels                      = _mm256_shuffle_epi8(pixels, mask);
+        _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_or_si256(pixels, alpha8));
+    }
+    ExpandToRGBA8SSSE3(dst + i * 4, src + i * srcSize, count - i, srcSize, map, alpha);
+}
+
+static void CPUFeatures(bool& ssse3, bool& avx2)
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    ssse3        = (info[2] & (1 << 9)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+
+    avx2 = false;
+    if (maxLeaf >= 7 && avx && osxsave)
+    {
+        __cpuidex(info, 7, 0);
+        // The OS must save the YMM registers on context switches
+        avx2 = ((info[1] & (1 << 5)) != 0) && ((_xgetbv(0) & 0x6) == 0x6);
+    }
+#else
+    __builtin_cpu_init();
+    ssse3 = __builtin_cpu_supports("ssse3") != 0;
+    avx2  = __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif  // CMP_SWIZZLE_USE_X86
+
+//-------------------------------------------------------------
+// Dispatch
+//-------------------------------------------------------------
+
+typedef void (*SwizzleProc)(unsigned char*, const unsigned char*, size_t, unsigned int, const unsigned char*);
+typedef void (*ExpandToRGBA8Proc)(unsigned char*, const unsigned char*, size_t, unsigned int, const unsigned char*, unsigned char);
+typedef void (*ExtractChannelProc)(unsigned char*, const unsigned char*, size_t, unsigned int, unsigned int);
+
+struct SwizzleProcs
+{
+    SwizzleProc        swizzle;
+    ExpandToRGBA8Proc  expandToRGBA8;
+    ExtractChannelProc extractChannel;
+};
+
+static const SwizzleProcs ScalarProcs = {SwizzleScalar, ExpandToRGBA8Scalar, ExtractChannelScalar};
+#if defined(CMP_SWIZZLE_USE_X86)
+static const SwizzleProcs SSSE3Procs = {SwizzleSSSE3, ExpandToRGBA8SSSE3, ExtractChannelSSSE3};
+static const SwizzleProcs AVX2Procs  = {SwizzleAVX2, ExpandToRGBA8AVX2, ExtractChannelSSSE3};
+#endif
+
+// Returns the kernels of simd, or NULL if the CPU does not support it
+static const SwizzleProcs* SelectSwizzleProcs(CMP_SwizzleSIMD simd)
+{
+#if defined(CMP_SWIZZLE_USE_X86)
+    struct Features
+    {
+        bool ssse3, avx2;
+        Features()
+        {
+            CPUFeatures(ssse3, avx2);
+        }
+    };
+    static const Features cpu;
+
+    switch (simd)
+    {
+    case CMP_SWIZZLE_AUTO:
+        return cpu.avx2 ? &AVX2Procs : (cpu.ssse3 ? &SSSE3Procs : &ScalarProcs);
+    case CMP_SWIZZLE_SSSE3:
+        return cpu.ssse3 ? &SSSE3Procs : NULL;
+    case CMP_SWIZZLE_AVX2:
+        return cpu.avx2 ? &AVX2Procs : NULL;
+    default:
+        break;
+    }
+#else
+    if (simd == CMP_SWIZZLE_AUTO)
+        return &ScalarProcs;
+#endif
+
+    return (simd == CMP_SWIZZLE_SCALAR) ? &ScalarProcs : NULL;
+}
+
+static std::atomic<const SwizzleProcs*> g_swizzleProcs(NULL);
+
+static const SwizzleProcs& GetSwizzleProcs()
+{
+    const SwizzleProcs* procs = g_swizzleProcs.load(std::memory_order_acquire);
+    if (!procs)
+    {
+        // Keep a choice made by CMP_SwizzleSetSIMD on another thread
+        const SwizzleProcs* expected = NULL;
+        procs                        = SelectSwizzleProcs(CMP_SWIZZLE_AUTO);
+        if (!g_swizzleProcs.compare_exchange_strong(expected, procs, std::memory_order_acq_rel))
+            procs = expected;
+    }
+    return *procs;
+}
+
+bool CMP_SwizzleSetSIMD(CMP_SwizzleSIMD simd)
+{
+    const SwizzleProcs* procs = SelectSwizzleProcs(simd);
+    if (!procs)
+        return false;
+
+    g_swizzleProcs.store(procs, std::memory_order_release);
+    return true;
+}
+
+void CMP_SwizzleN(void* dst, const void* src, size_t count, unsigned int elementSize, const unsigned char* map)
+{
+    if (!dst || !src || !map || !count || elementSize == 0 || elementSize > CMP_SWIZZLE_MAX_ELEMENT)
+        return;
+
+    for (unsigned int j = 0; j < elementSize; j++)
+    {
+        if (map[j] >= elementSize)
+            return;
+    }
+
+    GetSwizzleProcs().swizzle((unsigned char*)dst, (const unsigned char*)src, count, elementSize, map);
+}
+
+void CMP_ByteSwap16N(void* data, size_t count)
+{
+    static const unsigned char map[2] = {1, 0};
+    CMP_SwizzleN(data, data, count, 2, map);
+}
+
+void CMP_ByteSwap32N(void* data, size_t count)
+{
+    static const unsigned char map[4] = {3, 2, 1, 0};
+    CMP_SwizzleN(data, data, count, 4, map);
+}
+
+void CMP_SwapRedBlueN(void* data, size_t count, unsigned int numChannels, unsigned int bytesPerChannel)
+{
+    if (numChannels < 3 || numChannels > 4 || bytesPerChannel == 0 || bytesPerChannel > 4)
+        return;
+
+    unsigned int  pixelSize = numChannels * bytesPerChannel;
+    unsigned char map[CMP_SWIZZLE_MAX_ELEMENT];
+    for (unsigned int j = 0; j < pixelSize; j++)
+        map[j] = (unsigned char)j;
+    for (unsigned int j = 0; j < bytesPerChannel; j++)
+    {
+        map[j]                       = (unsigned char)(2 * bytesPerChannel + j);
+        map[2 * bytesPerChannel + j] = (unsigned char)j;
+    }
+
+    CMP_SwizzleN(data, data, count, pixelSize, map);
+}
+
+void CMP_ExpandToRGBA8N(unsigned char* dst, const unsigned char* src, size_t count, unsigned int srcSize, const unsigned char map[3], unsigned char alpha)
+{
+    if (!dst || !src || !map || !count || (srcSize != 3 && srcSize != 4))
+        return;
+
+    if (map[0] >= srcSize || map[1] >= srcSize || map[2] >= srcSize)
+        return;
+
+    GetSwizzleProcs().expandToRGBA8(dst, src, count, srcSize, map, alpha);
+}
+
+void CMP_ExtractChannelN(unsigned char* dst, const unsigned char* src, size_t count, unsigned int numChannels, unsigned int channel)
+{
+    if (dst && src && count && channel < numChannels)
+        GetSwizzleProcs().extractChannel(dst, src, count, numChannels, channel);
+}
@@ -0,0 +1,75 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef _CMP_SWIZZLE_H_
+#define _CMP_SWIZZLE_H_
+
+#include <stddef.h>
+
+// Batch channel reordering and byte order conversion of pixel data.
+//
+// The best path for the running CPU is picked once on first use: AVX2 or SSSE3
+// byte shuffles on x86 processors that support them and a scalar path
+// otherwise. All paths give the same results.
+//
+// Unless stated otherwise dst may be equal to src, for an in place conversion,
+// but must not partially overlap it.
+
+// Reorders the bytes of count elements of elementSize bytes (1 to 16): byte j
+// of each dst element is byte map[j] of the src element, map[j] < elementSize.
+// Use example: CMP_SwizzleN(pData, pData, width * height, 4, {2, 1, 0, 3})
+// converts RGBA8888 pixels to BGRA8888.
+void CMP_SwizzleN(void* dst, const void* src, size_t count, unsigned int elementSize, const unsigned char* map);
+
+// Reverses the byte order of count 16 or 32 bit values, in place
+void CMP_ByteSwap16N(void* data, size_t count);
+void CMP_ByteSwap32N(void* data, size_t count);
+
+// Swaps the first and third channels (RGB <-> BGR) of count pixels, in place.
+// numChannels is 3 or 4 and bytesPerChannel 1, 2 or 4.
+void CMP_SwapRedBlueN(void* data, size_t count, unsigned int numChannels, unsigned int bytesPerChannel);
+
+// Expands count 8 bit pixels of srcSize (3 or 4) bytes to 4 bytes: the first
+// three dst channels are src channels map[0..2] and the fourth is alpha. dst
+// may only be equal to src when srcSize is 4.
+void CMP_ExpandToRGBA8N(unsigned char* dst, const unsigned char* src, size_t count, unsigned int srcSize, const unsigned char map[3], unsigned char alpha);
+
+// Copies channel (0 to numChannels - 1) of count 8 bit pixels of numChannels
+// bytes to a single channel image. dst and src must not overlap.
+void CMP_ExtractChannelN(unsigned char* dst, const unsigned char* src, size_t count, unsigned int numChannels, unsigned int channel);
+
+// Manually sets which instruction set the functions above use, for testing and
+// benchmarking. The most recent call wins, CMP_SWIZZLE_AUTO restores the
+// automatic choice. Returns false and keeps the current choice if the CPU does
+// not support the requested instruction set.
+typedef enum
+{
+    CMP_SWIZZLE_AUTO,
+    CMP_SWIZZLE_SCALAR,
+    CMP_SWIZZLE_SSSE3,
+    CMP_SWIZZLE_AVX2,
+} CMP_SwizzleSIMD;
+
+bool CMP_SwizzleSetSIMD(CMP_SwizzleSIMD simd);
+
+#endif
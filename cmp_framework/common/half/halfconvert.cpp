@@ -0,0 +1,321 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "halfconvert.h"
+
+#include <string.h>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CMP_HALF_USE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CMP_HALF_USE_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(CMP_HALF_USE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CMP_HALF_TARGET_F16C __attribute__((target("avx,f16c")))
+#else
+#define CMP_HALF_TARGET_F16C
+#endif
+
+//-------------------------------------------------------------
+// Scalar conversion
+//-------------------------------------------------------------
+
+static inline unsigned int FloatAsUInt(float f)
+{
+    unsigned int u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static inline float UIntAsFloat(unsigned int u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static inline float HalfToFloat(unsigned short h)
+{
+    const unsigned int shiftedExp = 0x7c00u << 13;
+
+    unsigned int o   = (h & 0x7fffu) << 13;
+    unsigned int exp = o & shiftedExp;
+    o += (127 - 15) << 23;
+
+    if (exp == shiftedExp)
+    {
+        // Inf or NaN: move the exponent up to 255
+        o += (128 - 16) << 23;
+    }
+    else if (exp == 0)
+    {
+        // Zero or denormal: renormalize through the float unit
+        o = FloatAsUInt(UIntAsFloat(o + (1 << 23)) - UIntAsFloat(113u << 23));
+    }
+
+    return UIntAsFloat(o | ((h & 0x8000u) << 16));
+}
+
+static inline unsigned short FloatToHalf(float f)
+{
+    const unsigned int f16Max      = (127 + 16) << 23;
+    const unsigned int f32Inf      = 255u << 23;
+    const unsigned int denormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+    unsigned int   u    = FloatAsUInt(f);
+    unsigned int   sign = u & 0x80000000u;
+    unsigned short o;
+
+    u ^= sign;
+
+    if (u >= f16Max)
+    {
+        // Inf, NaN or too large for a half: the latter rounds to Inf
+        o = (u > f32Inf) ? 0x7e00 : 0x7c00;
+    }
+    else if (u < (113u << 23))
+    {
+        // Result is a half denormal or zero: let the float add do the rounding
+        o = (unsigned short)(FloatAsUInt(UIntAsFloat(u) + UIntAsFloat(denormMagic)) - denormMagic);
+    }
+    else
+    {
+        // Rebias the exponent and round the mantissa to nearest even
+        unsigned int mantOdd = (u >> 13) & 1;
+        u += ((unsigned int)(15 - 127) << 23) + 0xfff;
+        u += mantOdd;
+        o = (unsigned short)(u >> 13);
+    }
+
+    return (unsigned short)(o | (sign >> 16));
+}
+
+static void HalfToFloatScalar(float* dst, const unsigned short* src, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        dst[i] = HalfToFloat(src[i]);
+}
+
+static void FloatToHalfScalar(unsigned short* dst, const float* src, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        dst[i] = FloatToHalf(src[i]);
+}
+
+#ifdef CMP_HALF_USE_X86
+
+//-------------------------------------------------------------
+// SSE2 conversion, same bit manipulation as the scalar code
+//-------------------------------------------------------------
+
+static inline __m128 HalfToFloat4(__m128i h)
+{
+    const __m128i shiftedExp = _mm_set1_epi32(0x7c00 << 13);
+
+    __m128i o   = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7fff)), 13);
+    __m128i exp = _mm_and_si128(o, shiftedExp);
+    o           = _mm_add_epi32(o, _mm_set1_epi32((127 - 15) << 23));
+
+    __m128i infNan = _mm_cmpeq_epi32(exp, shiftedExp);
+    o              = _mm_add_epi32(o, _mm_and_si128(infNan, _mm_set1_epi32((128 - 16) << 23)));
+
+    __m128i denorm  = _mm_cmpeq_epi32(exp, _mm_setzero_si128());
+    __m128  renorm  = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(o, _mm_set1_epi32(1 << 23))), _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+    o               = _mm_or_si128(_mm_andnot_si128(denorm, o), _mm_and_si128(denorm, _mm_castps_si128(renorm)));
+
+    __m128i sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+    return _mm_castsi128_ps(_mm_or_si128(o, sign));
+}
+
+static inline __m128i FloatToHalf4(__m128 f)
+{
+    const __m128i denormMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+
+    __m128  signBits = _mm_and_ps(f, _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000u)));
+    __m128  absf     = _mm_xor_ps(f, signBits);
+    __m128i u        = _mm_castps_si128(absf);
+
+    __m128i isRegular = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), u);
+    __m128i isNan     = _mm_castps_si128(_mm_cmpunord_ps(absf, absf));
+    __m128i infNan    = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(isNan, _mm_set1_epi32(0x0200)));
+
+    __m128i isDenorm = _mm_cmpgt_epi32(_mm_set1_epi32(113 << 23), u);
+    __m128i denorm   = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absf, _mm_castsi128_ps(denormMagic))), denormMagic);
+
+    __m128i mantOdd = _mm_srai_epi32(_mm_slli_epi32(u, 31 - 13), 31);
+    __m128i normal  = _mm_add_epi32(u, _mm_set1_epi32(0xfff - ((127 - 15) << 23)));
+    normal          = _mm_srli_epi32(_mm_sub_epi32(normal, mantOdd), 13);
+
+    __m128i o = _mm_or_si128(_mm_and_si128(isDenorm, denorm), _mm_andnot_si128(isDenorm, normal));
+    o         = _mm_or_si128(_mm_and_si128(isRegular, o), _mm_andnot_si128(isRegular, infNan));
+
+    // The arithmetic shift keeps negative lanes in range for the signed pack
+    return _mm_or_si128(o, _mm_srai_epi32(_mm_castps_si128(signBits), 16));
+}
+
+static void HalfToFloatSSE2(float* dst, const unsigned short* src, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_ps(dst + i, HalfToFloat4(_mm_unpacklo_epi16(h, _mm_setzero_si128())));
+        _mm_storeu_ps(dst + i + 4, HalfToFloat4(_mm_unpackhi_epi16(h, _mm_setzero_si128())));
+    }
+    HalfToFloatScalar(dst + i, src + i, count - i);
+}
+
+static void FloatToHalfSSE2(unsigned short* dst, const float* src, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i lo = FloatToHalf4(_mm_loadu_ps(src + i));
+        __m128i hi = FloatToHalf4(_mm_loadu_ps(src + i + 4));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(lo, hi));
+    }
+    FloatToHalfScalar(dst + i, src + i, count - i);
+}
+
+//-------------------------------------------------------------
+// F16C conversion
+//-------------------------------------------------------------
+
+CMP_HALF_TARGET_F16C static void HalfToFloatF16C(float* dst, const unsigned short* src, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i))));
+    HalfToFloatScalar(dst + i, src + i, count - i);
+}
+
+CMP_HALF_TARGET_F16C static void FloatToHalfF16C(unsigned short* dst, const float* src, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm_storeu_si128((__m128i*)(dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+    FloatToHalfScalar(dst + i, src + i, count - i);
+}
+
+static bool CPUHasF16C()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool f16c    = (info[2] & (1 << 29)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!f16c || !avx || !osxsave)
+        return false;
+    // The OS must save the YMM registers on context switches
+    return (_xgetbv(0) & 0x6) == 0x6;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#endif
+}
+
+#endif  // CMP_HALF_USE_X86
+
+#ifdef CMP_HALF_USE_NEON
+
+//-------------------------------------------------------------
+// NEON conversion
+//-------------------------------------------------------------
+
+static void HalfToFloatNEON(float* dst, const unsigned short* src, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+    HalfToFloatScalar(dst + i, src + i, count - i);
+}
+
+static void FloatToHalfNEON(unsigned short* dst, const float* src, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+    FloatToHalfScalar(dst + i, src + i, count - i);
+}
+
+#endif  // CMP_HALF_USE_NEON
+
+//-------------------------------------------------------------
+// Dispatch
+//-------------------------------------------------------------
+
+typedef void (*HalfToFloatProc)(float*, const unsigned short*, size_t);
+typedef void (*FloatToHalfProc)(unsigned short*, const float*, size_t);
+
+struct HalfConvertProcs
+{
+    HalfToFloatProc halfToFloat;
+    FloatToHalfProc floatToHalf;
+
+    HalfConvertProcs()
+    {
+#if defined(CMP_HALF_USE_X86)
+        if (CPUHasF16C())
+        {
+            halfToFloat = HalfToFloatF16C;
+            floatToHalf = FloatToHalfF16C;
+        }
+        else
+        {
+            halfToFloat = HalfToFloatSSE2;
+            floatToHalf = FloatToHalfSSE2;
+        }
+#elif defined(CMP_HALF_USE_NEON)
+        halfToFloat = HalfToFloatNEON;
+        floatToHalf = FloatToHalfNEON;
+#else
+        halfToFloat = HalfToFloatScalar;
+        floatToHalf = FloatToHalfScalar;
+#endif
+    }
+};
+
+static const HalfConvertProcs& GetHalfConvertProcs()
+{
+    static const HalfConvertProcs procs;
+    return procs;
+}
+
+void CMP_HalfToFloatN(float* dst, const unsigned short* src, size_t count)
+{
+    if (dst && src && count)
+        GetHalfConvertProcs().halfToFloat(dst, src, count);
+}
+
+void CMP_FloatToHalfN(unsigned short* dst, const float* src, size_t count)
+{
+    if (dst && src && count)
+        GetHalfConvertProcs().floatToHalf(dst, src, count);
+}
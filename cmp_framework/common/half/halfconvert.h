@@ -0,0 +1,44 @@
+//=====================================================================
+// Copyright 2024 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef _CMP_HALFCONVERT_H_
+#define _CMP_HALFCONVERT_H_
+
+#include <stddef.h>
+
+// Batch conversion between IEEE 754 half floats (stored as their raw 16 bit
+// pattern) and 32 bit floats.
+//
+// The best path for the running CPU is picked once on first use: F16C on x86
+// processors that support it, the NEON conversion instructions on AArch64 and
+// an SSE2 or scalar bit manipulation path otherwise. All paths give the same
+// results as the CMP_HALF class: half to float is exact, float to half rounds
+// to nearest even. The only difference is NaN payloads, which are not preserved
+// when converting from float to half.
+//
+// dst and src must not overlap.
+
+void CMP_HalfToFloatN(float* dst, const unsigned short* src, size_t count);
+void CMP_FloatToHalfN(unsigned short* dst, const float* src, size_t count);
+
+#endif
@@ -32,6 +32,7 @@
 #include "cmp_core.h"
 #include "atiformats.h"
 #include "bcn_common_kernel.h"
+#include "cmp_profiler.h"
 
 #ifndef _WIN32
 #include <unistd.h> /* For open(), creat() */
@@ -55,7 +56,7 @@
 CMP_CHAR*                GetFormatDesc(CMP_FORMAT nFormat);
 PluginManager            g_pluginManager;
 PluginInterface_Encoder* plugin_encoder_codec  = NULL;
-static CMP_BOOL          HostPluginsRegistered = FALSE;
+static std::once_flag    HostPluginsRegistered;
 static CMP_FORMAT        cmp_format_hold       = CMP_FORMAT_Unknown;
 
 PluginInterface_Pipeline* g_ComputeBase = NULL;
@@ -90,8 +91,8 @@ extern void* make_Codec_Plugin_BRLG();
 
 void CMP_RegisterHostPlugins()
 {
-    if (HostPluginsRegistered == FALSE)
-    {
+    // Runs once per process, later calls only check the flag
+    std::call_once(HostPluginsRegistered, []() {
         // Hosts
         g_pluginManager.registerStaticPlugin("IMAGE", "DDS", (void*)make_Plugin_DDS);
         g_pluginManager.registerStaticPlugin("PIPELINE", "HPC", (void*)make_Plugin_HPC);
@@ -116,8 +117,7 @@ void CMP_RegisterHostPlugins()
         g_pluginManager.registerStaticPlugin("ENCODER", "BRLG", (void*)make_Codec_Plugin_BRLG);
 #endif
         g_pluginManager.getPluginList(".", TRUE);
-        HostPluginsRegistered = TRUE;
-    }
+    });
 }
 
 //
@@ -251,6 +251,8 @@ bool isDX12Supported()
 //
 CMP_ERROR CMP_API CMP_CreateComputeLibrary(MipSet* srcTexture, KernelOptions* kernel_options, void* CMips)
 {
+    CMP_PROFILE_SCOPE("Compute setup");
+
     CMP_Compute_type CompType   = kernel_options->encodeWith;
     CMP_FORMAT       cmp_format = kernel_options->format;
     if ((CompType != ComputeType) || cmp_format != cmp_format_hold)
@@ -385,6 +387,20 @@ CMP_ERROR CMP_API CMP_GetDeviceInfo(KernelDeviceInfo* pDeviceInfo)
     return CMP_OK;
 }
 
+CMP_ERROR CMP_API CMP_GetWorkerStats(KernelWorkerStats* pWorkerStats)
+{
+    CMP_ERROR result;
+    if (g_ComputeBase)
+    {
+        result = g_ComputeBase->TC_GetWorkerStats(pWorkerStats);
+        if (result != CMP_OK)
+            return (result);
+    }
+    else
+        return CMP_ABORTED;
+    return CMP_OK;
+}
+
 CMP_ERROR CMP_API CMP_CompressTexture(KernelOptions* options, CMP_MipSet srcMipSet, CMP_MipSet dstMipSet, CMP_Feedback_Proc pFeedback)
 {
     CMP_ERROR result;
@@ -552,7 +568,13 @@ CMP_ERROR CMP_API CMP_ProcessTexture(CMP_MipSet* srcMipSet, CMP_MipSet* dstMipSe
             }
 
             // Do the compression
-            if (CMP_CompressTexture(&kernelOptions, *srcMipSet, *dstMipSet, pFeedbackProc) != CMP_OK)
+            CMP_ERROR compressStatus;
+            {
+                CMP_PROFILE_SCOPE_ARG("Encode mip", nMipLevel);
+                compressStatus = CMP_CompressTexture(&kernelOptions, *srcMipSet, *dstMipSet, pFeedbackProc);
+            }
+
+            if (compressStatus != CMP_OK)
             {
                 CMips.FreeMipSet(dstMipSet);
                 CMP_DestroyComputeLibrary(true);
@@ -655,50 +677,73 @@ void CMP_API CMP_GetMipLevel(CMP_MipLevel** data, const CMP_MipSet* pMipSet, CMP
 // FILE IO static plugin libs
 //==============================
 
-CMP_ERROR stb_load(const char* SourceFile, MipSet* MipSetIn)
+// Adopts an RGBA 8888 image decoded by stbi_load* as mip level 0 of MipSetIn.
+// stb allocates with malloc so the buffer is owned by the mip level from here on and released by CMP_FreeMipSet.
+static CMP_ERROR stb_adopt(unsigned char* pTempData, int Width, int Height, MipSet* MipSetIn)
 {
-    int            Width, Height, ComponentCount;
-    unsigned char* pTempData = stbi_load(SourceFile, &Width, &Height, &ComponentCount, STBI_rgb_alpha);
-
-    if (pTempData == NULL)
-    {
-        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
-    }
-
     CMP_CMIPS CMips;
 
+    // Keep an arena request so the mip levels generated later are placed in it
+    CMP_UINT flags = MipSetIn->m_Flags & MS_FLAG_ArenaAlloc;
     memset(MipSetIn, 0, sizeof(MipSet));
+    MipSetIn->m_Flags = flags;
     if (!CMips.AllocateMipSet(MipSetIn, CF_8bit, TDT_ARGB, TT_2D, Width, Height, 1))
     {
+        stbi_image_free(pTempData);
         return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
     }
 
-    if (!CMips.AllocateMipLevelData(CMips.GetMipLevel(MipSetIn, 0), Width, Height, CF_8bit, TDT_ARGB))
-    {
-        return CMP_ERR_MEM_ALLOC_FOR_MIPSET;
-    }
-
-    MipSetIn->m_nMipLevels = 1;
-    MipSetIn->m_format     = CMP_FORMAT_RGBA_8888;
-
-    CMP_BYTE* pData = CMips.GetMipLevel(MipSetIn, 0)->m_pbData;
-
     // RGBA : 8888 = 4 bytes
     CMP_DWORD dwPitch = (4 * MipSetIn->m_nWidth);
     CMP_DWORD dwSize  = dwPitch * MipSetIn->m_nHeight;
 
-    memcpy(pData, pTempData, dwSize);
+    CMP_MipLevel* pMipLevel   = CMips.GetMipLevel(MipSetIn, 0);
+    pMipLevel->m_nWidth       = Width;
+    pMipLevel->m_nHeight      = Height;
+    pMipLevel->m_dwLinearSize = dwSize;
+    pMipLevel->m_pbData       = pTempData;
+
+    MipSetIn->m_nMipLevels = 1;
+    MipSetIn->m_format     = CMP_FORMAT_RGBA_8888;
 
     // Assign miplevel 0 to MipSetin pData ref
     // both miplevel pData and mipset pData will point to the same location
     // Typically mipset pData is assign a pointer to the current miplevel data been processed at run time
-    MipSetIn->pData      = pData;
+    MipSetIn->pData      = pTempData;
     MipSetIn->dwDataSize = dwSize;
 
-    stbi_image_free(pTempData);
     return CMP_OK;
 }
 
+CMP_ERROR stb_load(const char* SourceFile, MipSet* MipSetIn)
+{
+    int            Width, Height, ComponentCount;
+    unsigned char* pTempData = stbi_load(SourceFile, &Width, &Height, &ComponentCount, STBI_rgb_alpha);
+
+    if (pTempData == NULL)
+    {
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+    }
+
+    return stb_adopt(pTempData, Width, Height, MipSetIn);
+}
+
+static CMP_ERROR stb_load_from_memory(const CMP_BYTE* pBuffer, size_t size, MipSet* MipSetIn)
+{
+    if (size > 0x7FFFFFFF)  // stb takes the buffer length as an int
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+
+    int            Width, Height, ComponentCount;
+    unsigned char* pTempData = stbi_load_from_memory(pBuffer, static_cast<int>(size), &Width, &Height, &ComponentCount, STBI_rgb_alpha);
+
+    if (pTempData == NULL)
+    {
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+    }
+
+    return stb_adopt(pTempData, Width, Height, MipSetIn);
+}
+
 void CMP_API CMP_FreeMipSet(CMP_MipSet* MipSetIn)
 {
     if (!MipSetIn)
@@ -737,6 +782,8 @@ CMP_ERROR CMP_API CMP_LoadTexture(const char* SourceFile, CMP_MipSet* MipSetIn)
 {
     CMP_RegisterHostPlugins();  // Keep for legacy, user should now use CMP_InitFramework
 
+    CMP_PROFILE_SCOPE("Load");
+
     CMP_CMIPS CMips;
     CMP_ERROR status = CMP_OK;
 
@@ -789,10 +836,67 @@ CMP_ERROR CMP_API CMP_LoadTexture(const char* SourceFile, CMP_MipSet* MipSetIn)
     return status;
 }
 
+// Returns the image plugin name for a texture held in memory from its file signature,
+// or an empty string when the data is left to stb_image. Only the plugins listed here
+// implement TC_PluginMemoryLoadTexture.
+static std::string GetImageTypeFromMemory(const CMP_BYTE* pBuffer, size_t size)
+{
+    static const CMP_BYTE KTX1_ID[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    if (size >= sizeof(KTX1_ID) && memcmp(pBuffer, KTX1_ID, sizeof(KTX1_ID)) == 0)
+        return "KTX";
+
+    if (size >= 4 && CMP_MAKEFOURCC(pBuffer[0], pBuffer[1], pBuffer[2], pBuffer[3]) == CMP_MAKEFOURCC('D', 'D', 'S', ' '))
+        return "DDS";
+
+    return "";
+}
+
+CMP_ERROR CMP_API CMP_LoadTextureFromMemory(const void* pBuffer, size_t size, CMP_MipSet* MipSetIn)
+{
+    CMP_RegisterHostPlugins();  // Keep for legacy, user should now use CMP_InitFramework
+
+    if (!pBuffer || size == 0 || !MipSetIn)
+        return CMP_ERR_INVALID_SOURCE_TEXTURE;
+
+    const CMP_BYTE* pData     = reinterpret_cast<const CMP_BYTE*>(pBuffer);
+    std::string     imageType = GetImageTypeFromMemory(pData, size);
+
+    // PNG, JPG, BMP, TGA, PSD, GIF, HDR and similar formats are decoded by stb_image
+    if (imageType.empty())
+        return stb_load_from_memory(pData, size, MipSetIn);
+
+    PluginInterface_Image* plugin_Image = reinterpret_cast<PluginInterface_Image*>(g_pluginManager.GetPlugin("IMAGE", (char*)imageType.c_str()));
+    if (plugin_Image == NULL)
+        return CMP_ERR_PLUGIN_FILE_NOT_FOUND;
+
+    CMP_CMIPS CMips;
+    plugin_Image->TC_PluginSetSharedIO(&CMips);
+    int result = plugin_Image->TC_PluginMemoryLoadTexture(pBuffer, size, MipSetIn);
+    delete plugin_Image;
+
+    if (result != 0)
+        return CMP_ERR_UNABLE_TO_LOAD_FILE;
+
+    // Make sure MipSetIn->pData is at top mip level
+    if (MipSetIn->pData == NULL)
+    {
+        CMP_MipLevel* pOutMipLevel = CMips.GetMipLevel(MipSetIn, 0, 0);
+        MipSetIn->pData            = pOutMipLevel->m_pbData;
+        MipSetIn->dwDataSize       = pOutMipLevel->m_dwLinearSize;
+        MipSetIn->dwHeight         = pOutMipLevel->m_nHeight;
+        MipSetIn->dwWidth          = pOutMipLevel->m_nWidth;
+    }
+
+    return CMP_OK;
+}
+
 CMP_ERROR CMP_API CMP_SaveTexture(const char* DestFile, CMP_MipSet* MipSetIn)
 {
     CMP_RegisterHostPlugins();  // Keep for legacy, user should now use CMP_InitFramework
 
+    CMP_PROFILE_SCOPE("Save");
+
     bool  filesaved = false;
     CMIPS m_CMIPS;
 
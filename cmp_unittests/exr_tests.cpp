@@ -0,0 +1,269 @@
+//=====================================================================
+// Copyright (c) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "single_include/catch2/catch.hpp"
+
+#include "compressonator.h"
+#include "common.h"
+#include "tc_pluginapi.h"
+#include "exr.h"
+#include "test_constants.h"
+
+#include "namespacealias.h"
+#include <ImfHeader.h>
+#include <ImfMultiPartInputFile.h>
+#include <ImfPartType.h>
+#include <ImfRgbaFile.h>
+#include <ImfTiledRgbaFile.h>
+
+// Pixel (x, y) of level l of the test images, every value differs from its neighbours
+static IMF::Rgba TestPixel(int x, int y, int l)
+{
+    return IMF::Rgba(x * 0.25f, y * 0.5f - 3.0f, (float)l, 1.0f - (x + y) / 1024.0f);
+}
+
+static int LevelSize(int size, int level)
+{
+    return (std::max)(1, size >> level);
+}
+
+// An RGBA_16F MipSet holding the test pixels in nLevels levels
+static void MakeMipSet(CMIPS* pCMips, CMP_MipSet* pMipSet, int nWidth, int nHeight, int nLevels)
+{
+    memset(pMipSet, 0, sizeof(CMP_MipSet));
+    REQUIRE(pCMips->AllocateMipSet(pMipSet, CF_Float16, TDT_ARGB, TT_2D, nWidth, nHeight, 1));
+    pMipSet->m_format         = CMP_FORMAT_RGBA_16F;
+    pMipSet->m_isDeCompressed = CMP_FORMAT_RGBA_16F;  // The data holds half values, as the CLI marks it before saving
+    pMipSet->m_nMipLevels     = nLevels;
+
+    for (int l = 0; l < nLevels; l++)
+    {
+        int           w         = LevelSize(nWidth, l);
+        int           h         = LevelSize(nHeight, l);
+        CMP_MipLevel* pMipLevel = pCMips->GetMipLevel(pMipSet, l);
+        REQUIRE(pCMips->AllocateMipLevelData(pMipLevel, w, h, CF_Float16, TDT_ARGB));
+
+        IMF::Rgba* pixels = (IMF::Rgba*)pMipLevel->m_phfsData;
+        for (int y = 0; y < h; y++)
+            for (int x = 0; x < w; x++)
+                pixels[y * w + x] = TestPixel(x, y, l);
+    }
+}
+
+// Checks that level l of the MipSet is w x h and holds the test pixels of level nSourceLevel
+static bool SameLevel(CMIPS* pCMips, CMP_MipSet* pMipSet, int l, int w, int h, int nSourceLevel)
+{
+    CMP_MipLevel* pMipLevel = pCMips->GetMipLevel(pMipSet, l);
+    if (!pMipLevel || !pMipLevel->m_phfsData || (pMipLevel->m_nWidth != w) || (pMipLevel->m_nHeight != h))
+        return false;
+
+    const IMF::Rgba* pixels = (const IMF::Rgba*)pMipLevel->m_phfsData;
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            IMF::Rgba expected = TestPixel(x, y, nSourceLevel);
+            const IMF::Rgba& p = pixels[y * w + x];
+            if ((p.r.bits() != expected.r.bits()) || (p.g.bits() != expected.g.bits()) || (p.b.bits() != expected.b.bits()) ||
+                (p.a.bits() != expected.a.bits()))
+                return false;
+        }
+    }
+    return true;
+}
+
+// Writes the test pixels as a tiled file, level (lx, ly) of a ripmap holds the pixels of level lx
+static void WriteTiledFile(const std::string& fileName, int nWidth, int nHeight, IMF::LevelMode levelMode, IMF::LevelRoundingMode roundingMode)
+{
+    IMF::TiledRgbaOutputFile file(fileName.c_str(), nWidth, nHeight, 16, 16, levelMode, roundingMode);
+    std::vector<IMF::Rgba>   pixels;
+
+    int nXLevels = (levelMode == IMF::RIPMAP_LEVELS) ? file.numXLevels() : file.numLevels();
+    int nYLevels = (levelMode == IMF::RIPMAP_LEVELS) ? file.numYLevels() : 1;
+    for (int ly = 0; ly < nYLevels; ly++)
+    {
+        for (int lx = 0; lx < nXLevels; lx++)
+        {
+            int lyFile = (levelMode == IMF::RIPMAP_LEVELS) ? ly : lx;
+            int w      = file.levelWidth(lx);
+            int h      = file.levelHeight(lyFile);
+
+            pixels.resize((size_t)w * h);
+            for (int y = 0; y < h; y++)
+                for (int x = 0; x < w; x++)
+                    pixels[y * w + x] = TestPixel(x, y, lx);
+
+            file.setFrameBuffer(pixels.data(), 1, w);
+            file.writeTiles(0, file.numXTiles(lx) - 1, 0, file.numYTiles(lyFile) - 1, lx, lyFile);
+        }
+    }
+}
+
+static bool LoadEXR(const std::string& fileName, CMIPS* pCMips, CMP_MipSet* pMipSet)
+{
+    Plugin_EXR* plugin = (Plugin_EXR*)make_Plugin_EXR();
+    plugin->TC_PluginSetSharedIO(pCMips);
+
+    memset(pMipSet, 0, sizeof(CMP_MipSet));
+    bool bLoaded = plugin->TC_PluginFileLoadTexture(fileName.c_str(), pMipSet) == PE_OK;
+
+    delete plugin;
+    return bLoaded;
+}
+
+static bool SaveEXR(const std::string& fileName, CMIPS* pCMips, CMP_MipSet* pMipSet)
+{
+    Plugin_EXR* plugin = (Plugin_EXR*)make_Plugin_EXR();
+    plugin->TC_PluginSetSharedIO(pCMips);
+
+    bool bSaved = plugin->TC_PluginFileSaveTexture(fileName.c_str(), pMipSet) == PE_OK;
+
+    delete plugin;
+    return bSaved;
+}
+
+static std::string PartType(const std::string& fileName)
+{
+    IMF::MultiPartInputFile file(fileName.c_str());
+    return file.header(0).type();
+}
+
+TEST_CASE("EXR_Scanline_Round_Trip", "[EXR]")
+{
+    CMIPS             cmips;
+    const std::string fileName = TEST_DATA_PATH + std::string("/EXR_Scanline_Round_Trip.exr");
+
+    CMP_MipSet source;
+    MakeMipSet(&cmips, &source, 37, 19, 1);
+    REQUIRE(SaveEXR(fileName, &cmips, &source));
+    CHECK(PartType(fileName) == IMF::SCANLINEIMAGE);
+
+    CMP_MipSet loaded;
+    REQUIRE(LoadEXR(fileName, &cmips, &loaded));
+    std::remove(fileName.c_str());
+
+    CHECK(loaded.m_format == CMP_FORMAT_RGBA_16F);
+    CHECK(loaded.m_nMipLevels == 1);
+    CHECK(SameLevel(&cmips, &loaded, 0, 37, 19, 0));
+
+    CMP_FreeMipSet(&source);
+    CMP_FreeMipSet(&loaded);
+}
+
+TEST_CASE("EXR_Tiled_Mip_Round_Trip", "[EXR]")
+{
+    CMIPS             cmips;
+    const std::string fileName = TEST_DATA_PATH + std::string("/EXR_Tiled_Mip_Round_Trip.exr");
+    const int         nLevels  = CMP_CalcMaxMipLevel(33, 70, false);
+
+    // Odd sizes, so the levels are rounded down and the tiles at the edges are partly filled
+    CMP_MipSet source;
+    MakeMipSet(&cmips, &source, 70, 33, nLevels);
+    REQUIRE(SaveEXR(fileName, &cmips, &source));
+    CHECK(PartType(fileName) == IMF::TILEDIMAGE);
+
+    CMP_MipSet loaded;
+    REQUIRE(LoadEXR(fileName, &cmips, &loaded));
+    std::remove(fileName.c_str());
+
+    REQUIRE(loaded.m_nMipLevels == nLevels);
+    for (int l = 0; l < nLevels; l++)
+        CHECK(SameLevel(&cmips, &loaded, l, LevelSize(70, l), LevelSize(33, l), l));
+
+    CMP_FreeMipSet(&source);
+    CMP_FreeMipSet(&loaded);
+}
+
+TEST_CASE("EXR_Ripmap_Load", "[EXR]")
+{
+    CMIPS             cmips;
+    const std::string fileName = TEST_DATA_PATH + std::string("/EXR_Ripmap_Load.exr");
+    WriteTiledFile(fileName, 64, 16, IMF::RIPMAP_LEVELS, IMF::ROUND_DOWN);
+
+    // The levels reduced in both directions, down to level (4, 4) of 4 x 1 pixels
+    CMP_MipSet loaded;
+    REQUIRE(LoadEXR(fileName, &cmips, &loaded));
+    std::remove(fileName.c_str());
+
+    REQUIRE(loaded.m_nMipLevels == 5);
+    for (int l = 0; l < 5; l++)
+        CHECK(SameLevel(&cmips, &loaded, l, LevelSize(64, l), LevelSize(16, l), l));
+
+    CMP_FreeMipSet(&loaded);
+}
+
+TEST_CASE("EXR_Round_Up_Load", "[EXR]")
+{
+    CMIPS             cmips;
+    const std::string fileName = TEST_DATA_PATH + std::string("/EXR_Round_Up_Load.exr");
+    WriteTiledFile(fileName, 70, 33, IMF::MIPMAP_LEVELS, IMF::ROUND_UP);
+
+    // The 35 x 17 level of the file does not fit the 35 x 16 level of a MipSet, only the image is loaded
+    CMP_MipSet loaded;
+    REQUIRE(LoadEXR(fileName, &cmips, &loaded));
+    std::remove(fileName.c_str());
+
+    CHECK(loaded.m_nMipLevels == 1);
+    CHECK(SameLevel(&cmips, &loaded, 0, 70, 33, 0));
+
+    CMP_FreeMipSet(&loaded);
+}
+
+TEST_CASE("EXR_Truncated_File", "[EXR]")
+{
+    CMIPS             cmips;
+    const std::string fileName = TEST_DATA_PATH + std::string("/EXR_Truncated_File.exr");
+    const int         nLevels  = CMP_CalcMaxMipLevel(256, 256, false);
+    std::vector<char> data;
+
+    CMP_MipSet source;
+    MakeMipSet(&cmips, &source, 256, 256, nLevels);
+    REQUIRE(SaveEXR(fileName, &cmips, &source));
+    CMP_FreeMipSet(&source);
+
+    FILE* pFile = fopen(fileName.c_str(), "rb");
+    REQUIRE(pFile);
+    fseek(pFile, 0, SEEK_END);
+    data.resize(ftell(pFile));
+    fseek(pFile, 0, SEEK_SET);
+    REQUIRE(fread(data.data(), data.size(), 1, pFile) == 1);
+    fclose(pFile);
+
+    // Cut the file in the middle of the tiles, the load fails rather than giving a partly black image
+    pFile = fopen(fileName.c_str(), "wb");
+    REQUIRE(pFile);
+    REQUIRE(fwrite(data.data(), data.size() / 2, 1, pFile) == 1);
+    fclose(pFile);
+
+    CMP_MipSet loaded;
+    CHECK(!LoadEXR(fileName, &cmips, &loaded));
+    std::remove(fileName.c_str());
+
+    CMP_FreeMipSet(&loaded);
+}
@@ -25,6 +25,9 @@
 #include <iostream>
 #include <fstream>
 #include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <vector>
 
 #include "single_include/catch2/catch.hpp"
 
@@ -511,4 +514,95 @@ TEST_CASE("CMP_ReplaceExt", "[fileio]")
     CMP_ReplaceExt(file, newExt);
     std::string newFile = TEST_DATA_PATH + std::string("/createTextFile.pdf");
     REQUIRE(file == newFile);
-}
\ No newline at end of file
+}
+static std::vector<char> ReadWholeFile(const std::string& filePath)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+static void CheckSameMipSet(const CMP_MipSet& fromMemory, const CMP_MipSet& fromFile)
+{
+    CHECK(fromMemory.m_nWidth == fromFile.m_nWidth);
+    CHECK(fromMemory.m_nHeight == fromFile.m_nHeight);
+    CHECK(fromMemory.m_nMipLevels == fromFile.m_nMipLevels);
+    CHECK(fromMemory.m_format == fromFile.m_format);
+    REQUIRE(fromMemory.dwDataSize == fromFile.dwDataSize);
+    CHECK(memcmp(fromMemory.pData, fromFile.pData, fromFile.dwDataSize) == 0);
+}
+
+TEST_CASE("LoadTextureFromMemory", "[fileio]")
+{
+    const std::string pngPath = TEST_DATA_PATH + std::string("/mipmap_128x512.png");
+
+    SECTION("PNG matches the file load")
+    {
+        std::vector<char> buffer = ReadWholeFile(pngPath);
+        REQUIRE(!buffer.empty());
+
+        CMP_MipSet fromFile   = {};
+        CMP_MipSet fromMemory = {};
+        REQUIRE(CMP_LoadTexture(pngPath.c_str(), &fromFile) == CMP_OK);
+        REQUIRE(CMP_LoadTextureFromMemory(buffer.data(), buffer.size(), &fromMemory) == CMP_OK);
+
+        CheckSameMipSet(fromMemory, fromFile);
+
+        CMP_FreeMipSet(&fromFile);
+        CMP_FreeMipSet(&fromMemory);
+    }
+
+    SECTION("DDS matches the file load")
+    {
+        const std::string ddsPath = TEST_DATA_PATH + std::string("/LoadTextureFromMemory.dds");
+
+        CMP_MipSet source = {};
+        REQUIRE(CMP_LoadTexture(pngPath.c_str(), &source) == CMP_OK);
+        REQUIRE(CMP_SaveTexture(ddsPath.c_str(), &source) == CMP_OK);
+        CMP_FreeMipSet(&source);
+
+        std::vector<char> buffer = ReadWholeFile(ddsPath);
+        REQUIRE(!buffer.empty());
+
+        CMP_MipSet fromFile   = {};
+        CMP_MipSet fromMemory = {};
+        REQUIRE(CMP_LoadTexture(ddsPath.c_str(), &fromFile) == CMP_OK);
+        REQUIRE(CMP_LoadTextureFromMemory(buffer.data(), buffer.size(), &fromMemory) == CMP_OK);
+
+        CheckSameMipSet(fromMemory, fromFile);
+
+        CMP_FreeMipSet(&fromFile);
+        CMP_FreeMipSet(&fromMemory);
+        std::remove(ddsPath.c_str());
+    }
+
+    SECTION("Truncated DDS data")
+    {
+        const char header[8] = {'D', 'D', 'S', ' ', 124, 0, 0, 0};
+        CMP_MipSet mipSet    = {};
+        CHECK(CMP_LoadTextureFromMemory(header, sizeof(header), &mipSet) != CMP_OK);
+    }
+
+    SECTION("Unknown data")
+    {
+        const char junk[16] = {1, 2, 3};
+        CMP_MipSet mipSet   = {};
+        CHECK(CMP_LoadTextureFromMemory(junk, sizeof(junk), &mipSet) != CMP_OK);
+    }
+
+    SECTION("Formats without a memory loader")
+    {
+        // KTX2, OpenEXR and ASTC signatures followed by a header's worth of zeros
+        const unsigned char signatures[3][12] = {{0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'},
+                                                 {0x76, 0x2F, 0x31, 0x01, 2},
+                                                 {0x13, 0xAB, 0xA1, 0x5C, 4, 4, 1}};
+        for (int i = 0; i < 3; i++)
+        {
+            std::vector<char> buffer(256, 0);
+            memcpy(buffer.data(), signatures[i], sizeof(signatures[i]));
+
+            CMP_MipSet mipSet = {};
+            CHECK(CMP_LoadTextureFromMemory(buffer.data(), buffer.size(), &mipSet) == CMP_ERR_UNSUPPORTED_SOURCE_FORMAT);
+            CMP_FreeMipSet(&mipSet);
+        }
+    }
+}
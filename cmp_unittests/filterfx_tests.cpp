@@ -0,0 +1,136 @@
+//=====================================================================
+// Copyright (c) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include <cstring>
+#include <vector>
+
+#include "single_include/catch2/catch.hpp"
+
+#include "compressonator.h"
+#include "cpuresources.h"
+
+// Odd sizes so that the last vector of a row is partial
+static const int FX_TEST_WIDTH  = 61;
+static const int FX_TEST_HEIGHT = 37;
+
+// RGBA pixels of gradients, noise and hard edges, 8 bit or float
+static std::vector<CMP_BYTE> MakeFxImage(CMP_FORMAT format)
+{
+    const bool            isFloat = (format == CMP_FORMAT_RGBA_32F);
+    std::vector<CMP_BYTE> pixels((size_t)FX_TEST_WIDTH * FX_TEST_HEIGHT * 4 * (isFloat ? sizeof(float) : 1));
+    unsigned int          seed = 2468;
+
+    for (int i = 0; i < FX_TEST_WIDTH * FX_TEST_HEIGHT * 4; i++)
+    {
+        int x = (i / 4) % FX_TEST_WIDTH;
+        int y = (i / 4) / FX_TEST_WIDTH;
+        seed  = seed * 1103515245 + 12345;
+
+        float value;
+        if ((x / 8 + y / 8) % 2)
+            value = (float)((seed >> 16) % 256) / 255.0f;
+        else
+            value = ((i % 4) == 1) ? (float)(x + y) / (FX_TEST_WIDTH + FX_TEST_HEIGHT) : (((x + y * 3) % 11) < 5 ? 0.1f : 0.9f);
+
+        if (isFloat)
+            memcpy(&pixels[i * sizeof(float)], &value, sizeof(float));
+        else
+            pixels[i] = (CMP_BYTE)(value * 255.0f + 0.5f);
+    }
+
+    return pixels;
+}
+
+static void InitMipSet(CMP_MipSet* mipSet, CMP_FORMAT format, int width, int height, std::vector<CMP_BYTE>& data)
+{
+    memset(mipSet, 0, sizeof(CMP_MipSet));
+    mipSet->m_format   = format;
+    mipSet->m_nWidth   = width;
+    mipSet->m_nHeight  = height;
+    mipSet->dwDataSize = (CMP_DWORD)data.size();
+    mipSet->pData      = data.data();
+}
+
+enum FxTestFilter
+{
+    FX_TEST_CAS,
+    FX_TEST_CAS_SCALING,
+    FX_TEST_FSR
+};
+
+static std::vector<CMP_BYTE> RunFilter(FxTestFilter filter, CMP_FORMAT format, const std::vector<CMP_BYTE>& pixels)
+{
+    int dstWidth  = FX_TEST_WIDTH;
+    int dstHeight = FX_TEST_HEIGHT;
+    if (filter == FX_TEST_CAS_SCALING)
+    {
+        dstWidth  = FX_TEST_WIDTH * 3 / 2;
+        dstHeight = FX_TEST_HEIGHT * 3 / 2;
+    }
+    else if (filter == FX_TEST_FSR)
+    {
+        dstWidth  = FX_TEST_WIDTH * 2;
+        dstHeight = FX_TEST_HEIGHT * 2;
+    }
+
+    const size_t          pixelSize = (format == CMP_FORMAT_RGBA_32F) ? 4 * sizeof(float) : 4;
+    std::vector<CMP_BYTE> srcData(pixels);
+    std::vector<CMP_BYTE> dstData((size_t)dstWidth * dstHeight * pixelSize);
+
+    CMP_MipSet src, dst;
+    InitMipSet(&src, format, FX_TEST_WIDTH, FX_TEST_HEIGHT, srcData);
+    InitMipSet(&dst, format, dstWidth, dstHeight, dstData);
+
+    CpuResources cpu;
+    if (filter == FX_TEST_FSR)
+        REQUIRE(cpu.FSR(0.8f, &src, &dst) == CMP_OK);
+    else
+        REQUIRE(cpu.CAS(0.6f, true, &src, &dst) == CMP_OK);
+
+    return dstData;
+}
+
+TEST_CASE("FilterFX_SIMD_Kernels", "[FilterFX]")
+{
+    CMP_FORMAT   format = GENERATE(CMP_FORMAT_RGBA_8888, CMP_FORMAT_RGBA_32F);
+    FxTestFilter filter = GENERATE(FX_TEST_CAS, FX_TEST_CAS_SCALING, FX_TEST_FSR);
+    INFO("Format " << format << " filter " << filter);
+
+    std::vector<CMP_BYTE> pixels = MakeFxImage(format);
+
+    REQUIRE(CpuResources::SetSIMD(CpuResources::SIMD_SCALAR));
+    std::vector<CMP_BYTE> reference = RunFilter(filter, format, pixels);
+
+    // The kernels of each instruction set give the same results as the scalar ones,
+    // the ones not built for the target or not supported by the CPU are skipped
+    const CpuResources::SIMD simds[] = {CpuResources::SIMD_SSE2, CpuResources::SIMD_AVX, CpuResources::SIMD_AVX2, CpuResources::SIMD_NEON, CpuResources::SIMD_AUTO};
+    for (CpuResources::SIMD simd : simds)
+    {
+        INFO("SIMD " << simd);
+        if (!CpuResources::SetSIMD(simd))
+            continue;
+        CHECK((RunFilter(filter, format, pixels) == reference));
+    }
+
+    CHECK(CpuResources::SetSIMD(CpuResources::SIMD_AUTO));
+}
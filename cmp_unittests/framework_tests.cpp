@@ -24,8 +24,13 @@
 #include "single_include/catch2/catch.hpp"
 
 #include <string>
+#include <cstring>
+#include <vector>
 
 #include "compressonator.h"
+#include "halfconvert.h"
+#include "cmp_swizzle.h"
+#include "cmp_blockcache.h"
 
 #include "test_constants.h"
 
@@ -52,4 +57,234 @@ TEST_CASE("Load_Texture_16_Bit", "[FRAMEWORK]")
     REQUIRE(texture.m_ChannelFormat == CF_8bit);
 
     CMP_FreeMipSet(&texture);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Half_Float_Batch_Conversion", "[FRAMEWORK]")
+{
+    // Every half bit pattern must convert the same way as the CMP_HALF lookup tables
+    std::vector<unsigned short> halfs(1 << 16);
+    for (size_t i = 0; i < halfs.size(); ++i)
+        halfs[i] = (unsigned short)i;
+
+    std::vector<float> floats(halfs.size());
+    CMP_HalfToFloatN(floats.data(), halfs.data(), halfs.size());
+
+    for (size_t i = 0; i < halfs.size(); ++i)
+    {
+        CMP_HALF h;
+        h.setBits(halfs[i]);
+
+        if (h.isNan())
+            REQUIRE(floats[i] != floats[i]);
+        else
+            REQUIRE(floats[i] == (float)h);
+    }
+
+    // Converting back must give the original bits, NaN payloads aside
+    std::vector<unsigned short> roundTrip(halfs.size());
+    CMP_FloatToHalfN(roundTrip.data(), floats.data(), floats.size());
+
+    for (size_t i = 0; i < halfs.size(); ++i)
+    {
+        CMP_HALF h;
+        h.setBits(halfs[i]);
+
+        if (!h.isNan())
+            REQUIRE(roundTrip[i] == halfs[i]);
+    }
+
+    // Values between halfs round to nearest even, overflow and tiny values as CMP_HALF does
+    const float values[] = {65504.0f, 65519.0f, 65520.0f, 1.0e6f, 1.0f + 1.0f / 2048.0f, 1.0f + 3.0f / 2048.0f, 2.0e-8f, 3.0e-8f, -1.0e-5f, 1.0e-40f};
+    const size_t count = sizeof(values) / sizeof(values[0]);
+
+    unsigned short converted[count];
+    CMP_FloatToHalfN(converted, values, count);
+
+    for (size_t i = 0; i < count; ++i)
+        REQUIRE(converted[i] == CMP_HALF(values[i]).bits());
+}
+
+TEST_CASE("Channel_Swizzle", "[FRAMEWORK]")
+{
+    // Odd pixel counts exercise both the vector and the scalar tail of every path
+    const size_t               count = 1001;
+    std::vector<unsigned char> rgba(count * 4);
+    for (size_t i = 0; i < rgba.size(); ++i)
+        rgba[i] = (unsigned char)(i * 7 + 3);
+
+    // RGBA <-> BGRA, in place and to a separate buffer
+    const unsigned char mapBGRA[4] = {2, 1, 0, 3};
+    std::vector<unsigned char> bgra(rgba.size());
+    CMP_SwizzleN(bgra.data(), rgba.data(), count, 4, mapBGRA);
+
+    std::vector<unsigned char> inPlace = rgba;
+    CMP_SwapRedBlueN(inPlace.data(), count, 4, 1);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        REQUIRE(bgra[i * 4] == rgba[i * 4 + 2]);
+        REQUIRE(bgra[i * 4 + 1] == rgba[i * 4 + 1]);
+        REQUIRE(bgra[i * 4 + 2] == rgba[i * 4]);
+        REQUIRE(bgra[i * 4 + 3] == rgba[i * 4 + 3]);
+    }
+    REQUIRE(inPlace == bgra);
+
+    // 3 byte pixels, elements that do not fill a vector register
+    const unsigned char mapBGR[3] = {2, 1, 0};
+    std::vector<unsigned char> bgr(rgba.begin(), rgba.begin() + count * 3);
+    CMP_SwizzleN(bgr.data(), bgr.data(), count, 3, mapBGR);
+    for (size_t i = 0; i < count; ++i)
+    {
+        REQUIRE(bgr[i * 3] == rgba[i * 3 + 2]);
+        REQUIRE(bgr[i * 3 + 2] == rgba[i * 3]);
+    }
+
+    // Byte order
+    unsigned short values16[3] = {0x1234, 0xabcd, 0x00ff};
+    CMP_ByteSwap16N(values16, 3);
+    REQUIRE(values16[0] == 0x3412);
+    REQUIRE(values16[1] == 0xcdab);
+    REQUIRE(values16[2] == 0xff00);
+
+    unsigned int values32[2] = {0x11223344, 0xaabbccdd};
+    CMP_ByteSwap32N(values32, 2);
+    REQUIRE(values32[0] == 0x44332211);
+    REQUIRE(values32[1] == 0xddccbbaa);
+
+    // 3 to 4 channel expansion
+    const unsigned char        mapRGB[3] = {0, 1, 2};
+    std::vector<unsigned char> expanded(count * 4);
+    CMP_ExpandToRGBA8N(expanded.data(), rgba.data(), count, 3, mapRGB, 0xFF);
+    for (size_t i = 0; i < count; ++i)
+    {
+        REQUIRE(expanded[i * 4] == rgba[i * 3]);
+        REQUIRE(expanded[i * 4 + 1] == rgba[i * 3 + 1]);
+        REQUIRE(expanded[i * 4 + 2] == rgba[i * 3 + 2]);
+        REQUIRE(expanded[i * 4 + 3] == 0xFF);
+    }
+
+    // Channel extraction
+    std::vector<unsigned char> green(count);
+    CMP_ExtractChannelN(green.data(), rgba.data(), count, 4, 1);
+    for (size_t i = 0; i < count; ++i)
+        REQUIRE(green[i] == rgba[i * 4 + 1]);
+
+    // The SIMD kernels must give the scalar results for every element size, in place and to a separate buffer
+    const CMP_SwizzleSIMD simds[] = {CMP_SWIZZLE_SSSE3, CMP_SWIZZLE_AVX2};
+
+    std::vector<unsigned char> src(count * 16);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (unsigned char)(i * 13 + i / 251);
+
+    for (unsigned int elementSize = 1; elementSize <= 16; ++elementSize)
+    {
+        unsigned char map[16];
+        for (unsigned int j = 0; j < elementSize; ++j)
+            map[j] = (unsigned char)((j * 5 + 3) % elementSize);
+
+        std::vector<unsigned char> expected(count * elementSize);
+        REQUIRE(CMP_SwizzleSetSIMD(CMP_SWIZZLE_SCALAR));
+        CMP_SwizzleN(expected.data(), src.data(), count, elementSize, map);
+
+        for (CMP_SwizzleSIMD simd : simds)
+        {
+            if (!CMP_SwizzleSetSIMD(simd))
+                continue;
+
+            std::vector<unsigned char> result(count * elementSize);
+            CMP_SwizzleN(result.data(), src.data(), count, elementSize, map);
+            REQUIRE(result == expected);
+
+            std::vector<unsigned char> inPlaceResult(src.begin(), src.begin() + count * elementSize);
+            CMP_SwizzleN(inPlaceResult.data(), inPlaceResult.data(), count, elementSize, map);
+            REQUIRE(inPlaceResult == expected);
+        }
+    }
+
+    for (unsigned int srcSize = 3; srcSize <= 4; ++srcSize)
+    {
+        const unsigned char        mapBGR[3] = {2, 1, 0};
+        std::vector<unsigned char> expected(count * 4);
+        REQUIRE(CMP_SwizzleSetSIMD(CMP_SWIZZLE_SCALAR));
+        CMP_ExpandToRGBA8N(expected.data(), src.data(), count, srcSize, mapBGR, 0x80);
+
+        for (CMP_SwizzleSIMD simd : simds)
+        {
+            if (!CMP_SwizzleSetSIMD(simd))
+                continue;
+
+            std::vector<unsigned char> result(count * 4);
+            CMP_ExpandToRGBA8N(result.data(), src.data(), count, srcSize, mapBGR, 0x80);
+            REQUIRE(result == expected);
+        }
+    }
+
+    for (unsigned int numChannels = 1; numChannels <= 4; ++numChannels)
+    {
+        std::vector<unsigned char> expected(count);
+        REQUIRE(CMP_SwizzleSetSIMD(CMP_SWIZZLE_SCALAR));
+        CMP_ExtractChannelN(expected.data(), src.data(), count, numChannels, numChannels - 1);
+
+        for (CMP_SwizzleSIMD simd : simds)
+        {
+            if (!CMP_SwizzleSetSIMD(simd))
+                continue;
+
+            std::vector<unsigned char> result(count);
+            CMP_ExtractChannelN(result.data(), src.data(), count, numChannels, numChannels - 1);
+            REQUIRE(result == expected);
+        }
+    }
+
+    REQUIRE(CMP_SwizzleSetSIMD(CMP_SWIZZLE_AUTO));
+}
+
+TEST_CASE("Block_Cache", "[FRAMEWORK]")
+{
+    CMP_BlockCache cache(16, 4, 8, 64);
+
+    unsigned char solid[64];
+    for (int i = 0; i < 64; ++i)
+        solid[i] = (unsigned char)(0x10 + (i & 3));
+
+    unsigned char mixed[64];
+    for (int i = 0; i < 64; ++i)
+        mixed[i] = (unsigned char)(i * 5);
+
+    unsigned char encoded[8]   = {0};
+    unsigned char solidCode[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    unsigned char mixedCode[8] = {9, 10, 11, 12, 13, 14, 15, 16};
+
+    // Nothing is found before it is added
+    REQUIRE_FALSE(cache.Find(solid, encoded));
+    cache.Add(solidCode);
+    REQUIRE_FALSE(cache.Find(mixed, encoded));
+    cache.Add(mixedCode);
+
+    REQUIRE(cache.Find(solid, encoded));
+    REQUIRE(memcmp(encoded, solidCode, sizeof(encoded)) == 0);
+    REQUIRE(cache.Find(mixed, encoded));
+    REQUIRE(memcmp(encoded, mixedCode, sizeof(encoded)) == 0);
+
+    // A block that differs in its last texel only is a different block
+    mixed[63] ^= 1;
+    REQUIRE_FALSE(cache.Find(mixed, encoded));
+    solid[63] ^= 1;
+    REQUIRE_FALSE(cache.Find(solid, encoded));
+
+    REQUIRE(cache.GetHits() == 2);
+
+    // Encode only calls the encoder for a block it has not seen
+    int  numEncoded  = 0;
+    auto encodeBlock = [&]() {
+        memcpy(encoded, mixedCode, sizeof(encoded));
+        numEncoded++;
+    };
+
+    memset(encoded, 0, sizeof(encoded));
+    REQUIRE_FALSE(cache.Encode(mixed, encoded, encodeBlock));
+    REQUIRE(cache.Encode(mixed, encoded, encodeBlock));
+    REQUIRE(memcmp(encoded, mixedCode, sizeof(encoded)) == 0);
+    REQUIRE(numEncoded == 1);
+    REQUIRE(cache.GetHits() == 3);
+}
@@ -0,0 +1,151 @@
+//=====================================================================
+// Copyright (c) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "single_include/catch2/catch.hpp"
+
+#include "jrtcommon.h"
+#include "jrtkdtree.h"
+#include "jrtmesh.h"
+#include "jrtheuristickdtreebuilder.h"
+#include "jrtparallelkdtreebuilder.h"
+
+static float RandomFloat(unsigned int& seed)
+{
+    seed = seed * 1103515245 + 12345;
+    return (float)((seed >> 8) & 0xffff) / 65535.0f;
+}
+
+// Small triangles scattered through the unit cube, dense in one corner so the tree is unbalanced
+static JRTMesh* MakeTriangleSoup(unsigned int nTriangles)
+{
+    std::vector<Vec3f> positions;
+    std::vector<Vec3f> normals;
+    std::vector<UINT>  indices;
+    unsigned int       seed = 4321;
+
+    for (unsigned int i = 0; i < nTriangles; i++)
+    {
+        float fScale = (i % 3 == 0) ? 0.25f : 1.0f;
+        Vec3f center(RandomFloat(seed) * fScale, RandomFloat(seed) * fScale, RandomFloat(seed) * fScale);
+        for (int v = 0; v < 3; v++)
+        {
+            Vec3f offset(RandomFloat(seed) - 0.5f, RandomFloat(seed) - 0.5f, RandomFloat(seed) - 0.5f);
+            positions.push_back(center + offset * 0.05f);
+            indices.push_back((UINT)indices.size());
+        }
+
+        Vec3f normal = Cross(positions[3 * i + 1] - positions[3 * i], positions[3 * i + 2] - positions[3 * i]);
+        for (int v = 0; v < 3; v++)
+            normals.push_back(Normalize(normal));
+    }
+
+    return JRTMesh::CreateMesh(&positions[0], &normals[0], (UINT)positions.size(), nTriangles, &indices[0]);
+}
+
+// The faces hit by a ray and their distances, in order of face
+static std::vector<TootleRayHit> FindHits(JRTKDTree* pTree, const Vec3f& rOrigin, const Vec3f& rDirection, TootleRayHit** ppHitArray, UINT* pnArraySize)
+{
+    UINT nHits        = pTree->FindAllHits(rOrigin, rDirection, ppHitArray, pnArraySize);
+    bool bOutOfMemory = (nHits == JRTKDTree::OUT_OF_MEMORY);
+    REQUIRE(!bOutOfMemory);
+
+    std::vector<TootleRayHit> hits(*ppHitArray, *ppHitArray + nHits);
+    std::sort(hits.begin(), hits.end(), [](const TootleRayHit& a, const TootleRayHit& b) { return a.nFaceID < b.nFaceID; });
+    return hits;
+}
+
+TEST_CASE("JRT_Parallel_KDTree_Hits", "[JRT]")
+{
+    JRTMesh*              pMesh = MakeTriangleSoup(20000);
+    std::vector<JRTMesh*> meshes(1, pMesh);
+    REQUIRE(pMesh);
+
+    JRTHeuristicKDTreeBuilder heuristicBuilder;
+    JRTParallelKDTreeBuilder  parallelBuilder(4);
+    JRTParallelKDTreeBuilder  serialBuilder(1);
+
+    JRTKDTree* pHeuristicTree = heuristicBuilder.BuildTree(meshes);
+    JRTKDTree* pParallelTree  = parallelBuilder.BuildTree(meshes);
+    JRTKDTree* pSerialTree    = serialBuilder.BuildTree(meshes);
+    REQUIRE(pHeuristicTree);
+    REQUIRE(pParallelTree);
+    REQUIRE(pSerialTree);
+
+    // The statistics describe the tree that was built, whatever the thread count. The node array of the parallel
+    // builder also holds the unreachable leaves that keep siblings in one cache line.
+    const JRTKDTreeStats& stats = parallelBuilder.GetStats();
+    CHECK(heuristicBuilder.GetStats().nNodes == pHeuristicTree->GetNodeCount());
+    CHECK(stats.nNodes == 2 * stats.nLeaves - 1);
+    CHECK(stats.nNodes <= pParallelTree->GetNodeCount());
+    CHECK(pParallelTree->GetNodeCount() - stats.nNodes == pParallelTree->GetLeafCount() - stats.nLeaves);
+    CHECK(stats.nMaxDepth == pParallelTree->GetMaxDepth());
+    CHECK(stats.nTriangleRefs == pParallelTree->GetIndexCount());
+    CHECK(stats.nTriangleRefs >= 20000);
+    CHECK(stats.fTrisPerLeaf > 0.0f);
+    CHECK(stats.fSAHCost > 0.0f);
+    CHECK(stats.fBuildSeconds >= 0.0);
+    CHECK(serialBuilder.GetStats().nNodes == stats.nNodes);
+    CHECK(serialBuilder.GetStats().fSAHCost == stats.fSAHCost);
+
+    // Binning only considers some of the planes of the full sweep, it should not cost much more to traverse
+    CHECK(stats.fSAHCost <= heuristicBuilder.GetStats().fSAHCost * 1.5f);
+
+    TootleRayHit* pHitArray   = new TootleRayHit[5];
+    UINT          nArraySize  = 5;
+    unsigned int  seed        = 1234;
+    unsigned int  nRaysWithHits = 0;
+
+    for (int i = 0; i < 2000; i++)
+    {
+        // Rays from outside the cube through a point inside it
+        Vec3f target(RandomFloat(seed), RandomFloat(seed), RandomFloat(seed));
+        Vec3f direction(RandomFloat(seed) - 0.5f, RandomFloat(seed) - 0.5f, RandomFloat(seed) - 0.5f);
+        direction = Normalize(direction);
+        Vec3f origin = target - direction * 3.0f;
+
+        std::vector<TootleRayHit> expected = FindHits(pHeuristicTree, origin, direction, &pHitArray, &nArraySize);
+        std::vector<TootleRayHit> parallel = FindHits(pParallelTree, origin, direction, &pHitArray, &nArraySize);
+
+        REQUIRE(parallel.size() == expected.size());
+        for (size_t h = 0; h < expected.size(); h++)
+        {
+            CHECK(parallel[h].nFaceID == expected[h].nFaceID);
+            CHECK(parallel[h].t == expected[h].t);
+        }
+
+        if (!expected.empty())
+            nRaysWithHits++;
+    }
+
+    CHECK(nRaysWithHits > 1000);
+
+    delete[] pHitArray;
+    delete pHeuristicTree;
+    delete pParallelTree;
+    delete pSerialTree;
+    delete pMesh;
+}
@@ -0,0 +1,371 @@
+//=====================================================================
+// Copyright (c) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "single_include/catch2/catch.hpp"
+
+#include "compressonator.h"
+#include "common.h"
+#include "tc_pluginapi.h"
+#include "cmp_mips.h"
+#include "ktx.h"
+#include "ktxint.h"
+#include "test_constants.h"
+
+// Declared here rather than by including ktx1.h, which defines the file identifier
+extern void* make_Plugin_KTX();
+
+extern PluginManager g_pluginManager;
+
+static int LevelSize(int size, int level)
+{
+    return (std::max)(1, size >> level);
+}
+
+// Byte i of face or slice f of level l of the test MipSets
+static CMP_BYTE TestByte(size_t i, int f, int l)
+{
+    return (CMP_BYTE)(i * 7 + f * 31 + l * 67 + 1);
+}
+
+// A MipSet of nLevels levels holding the test bytes, compressed formats are BC1
+static void MakeMipSet(CMIPS*          pCMips,
+                       CMP_MipSet*     pMipSet,
+                       CMP_FORMAT      format,
+                       ChannelFormat   channelFormat,
+                       TextureDataType textureDataType,
+                       TextureType     textureType,
+                       int             nWidth,
+                       int             nHeight,
+                       int             nDepth,
+                       int             nLevels)
+{
+    memset(pMipSet, 0, sizeof(CMP_MipSet));
+    REQUIRE(pCMips->AllocateMipSet(pMipSet, channelFormat, textureDataType, textureType, nWidth, nHeight, nDepth));
+    pMipSet->m_format     = format;
+    pMipSet->m_nMipLevels = nLevels;
+    if (channelFormat == CF_Compressed)
+    {
+        pMipSet->m_compressed   = true;
+        pMipSet->m_nBlockWidth  = 4;
+        pMipSet->m_nBlockHeight = 4;
+        pMipSet->m_nBlockDepth  = 1;
+    }
+
+    for (int l = 0; l < nLevels; l++)
+    {
+        int w = LevelSize(nWidth, l);
+        int h = LevelSize(nHeight, l);
+        for (int f = 0; f < CMP_MaxFacesOrSlices(pMipSet, l); f++)
+        {
+            CMP_MipLevel* pMipLevel = pCMips->GetMipLevel(pMipSet, l, f);
+            if (channelFormat == CF_Compressed)
+                REQUIRE(pCMips->AllocateCompressedMipLevelData(pMipLevel, w, h, ((w + 3) / 4) * ((h + 3) / 4) * 8));
+            else
+                REQUIRE(pCMips->AllocateMipLevelData(pMipLevel, w, h, channelFormat, textureDataType));
+
+            for (CMP_DWORD i = 0; i < pMipLevel->m_dwLinearSize; i++)
+                pMipLevel->m_pbData[i] = TestByte(i, f, l);
+        }
+    }
+}
+
+// Checks that every level and face or slice of the MipSets holds the same data
+static bool SameMipSets(CMIPS* pCMips, CMP_MipSet* pMipSet, CMP_MipSet* pExpected)
+{
+    if ((pMipSet->m_format != pExpected->m_format) || (pMipSet->m_TextureType != pExpected->m_TextureType) ||
+        (pMipSet->m_nWidth != pExpected->m_nWidth) || (pMipSet->m_nHeight != pExpected->m_nHeight) ||
+        (pMipSet->m_nDepth != pExpected->m_nDepth) || (pMipSet->m_nMipLevels != pExpected->m_nMipLevels))
+        return false;
+
+    for (int l = 0; l < pExpected->m_nMipLevels; l++)
+    {
+        for (int f = 0; f < CMP_MaxFacesOrSlices(pExpected, l); f++)
+        {
+            CMP_MipLevel* pMipLevel     = pCMips->GetMipLevel(pMipSet, l, f);
+            CMP_MipLevel* pExpectedData = pCMips->GetMipLevel(pExpected, l, f);
+            if (!pMipLevel || !pMipLevel->m_pbData || (pMipLevel->m_nWidth != pExpectedData->m_nWidth) ||
+                (pMipLevel->m_nHeight != pExpectedData->m_nHeight) || (pMipLevel->m_dwLinearSize != pExpectedData->m_dwLinearSize) ||
+                (memcmp(pMipLevel->m_pbData, pExpectedData->m_pbData, pExpectedData->m_dwLinearSize) != 0))
+                return false;
+        }
+    }
+    return true;
+}
+
+static bool LoadKTX(const std::string& fileName, CMIPS* pCMips, CMP_MipSet* pMipSet)
+{
+    PluginInterface_Image* plugin = (PluginInterface_Image*)make_Plugin_KTX();
+    plugin->TC_PluginSetSharedIO(pCMips);
+
+    memset(pMipSet, 0, sizeof(CMP_MipSet));
+    bool bLoaded = plugin->TC_PluginFileLoadTexture(fileName.c_str(), pMipSet) == 0;
+
+    delete plugin;
+    return bLoaded;
+}
+
+static bool SaveKTX(const std::string& fileName, CMIPS* pCMips, CMP_MipSet* pMipSet)
+{
+    PluginInterface_Image* plugin = (PluginInterface_Image*)make_Plugin_KTX();
+    plugin->TC_PluginSetSharedIO(pCMips);
+
+    bool bSaved = plugin->TC_PluginFileSaveTexture(fileName.c_str(), pMipSet) == 0;
+
+    delete plugin;
+    return bSaved;
+}
+
+static std::vector<CMP_BYTE> ReadFileBytes(const std::string& fileName)
+{
+    std::vector<CMP_BYTE> bytes;
+    FILE*                 pFile = fopen(fileName.c_str(), "rb");
+    if (!pFile)
+        return bytes;
+
+    CMP_BYTE buffer[4096];
+    size_t   nRead;
+    while ((nRead = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+        bytes.insert(bytes.end(), buffer, buffer + nRead);
+
+    fclose(pFile);
+    return bytes;
+}
+
+// Appends v in the byte order of a file written on a little or big endian machine
+static void AppendU32(std::vector<CMP_BYTE>& file, uint32_t v, bool bBigEndian)
+{
+    for (int i = 0; i < 4; i++)
+        file.push_back((CMP_BYTE)(v >> (bBigEndian ? (24 - i * 8) : (i * 8))));
+}
+
+// The header of a single level 2D KTX file without key value data
+static std::vector<CMP_BYTE> MakeKTXHeader(uint32_t glType, uint32_t glTypeSize, uint32_t glFormat, uint32_t nWidth, uint32_t nHeight, bool bBigEndian)
+{
+    static const CMP_BYTE identifier[12] = KTX_IDENTIFIER_REF;
+    std::vector<CMP_BYTE> file(identifier, identifier + sizeof(identifier));
+
+    const uint32_t fields[] = {KTX_ENDIAN_REF, glType, glTypeSize, glFormat, glFormat, glFormat, nWidth, nHeight, 0, 0, 1, 1, 0};
+    for (uint32_t field : fields)
+        AppendU32(file, field, bBigEndian);
+    return file;
+}
+
+// Loads the file through the framework, as an application holding it in memory would
+static CMP_ERROR LoadFromMemory(const std::vector<CMP_BYTE>& file, CMP_MipSet* pMipSet)
+{
+    // CMP_RegisterHostPlugins leaves KTX to the applications, register it as the CLI does
+    static bool bRegistered = false;
+    if (!bRegistered)
+    {
+        g_pluginManager.registerStaticPlugin((char*)"IMAGE", (char*)"KTX", (void*)make_Plugin_KTX);
+        bRegistered = true;
+    }
+
+    memset(pMipSet, 0, sizeof(CMP_MipSet));
+    return CMP_LoadTextureFromMemory(file.data(), file.size(), pMipSet);
+}
+
+TEST_CASE("KTX_2D_Matches_libktx", "[KTX]")
+{
+    CMIPS      cmips;
+    CMP_MipSet mipSet;
+    uint32_t   glFormat = 0;
+    uint32_t   glInternalFormat = 0;
+
+    SECTION("R_8 with padded rows")
+    {
+        MakeMipSet(&cmips, &mipSet, CMP_FORMAT_R_8, CF_8bit, TDT_R, TT_2D, 13, 7, 1, 3);
+        glFormat         = GL_RED;
+        glInternalFormat = GL_RED;
+    }
+    SECTION("ARGB_8888")
+    {
+        MakeMipSet(&cmips, &mipSet, CMP_FORMAT_ARGB_8888, CF_8bit, TDT_ARGB, TT_2D, 16, 8, 1, 4);
+        glFormat         = GL_RGBA;
+        glInternalFormat = GL_RGBA8;
+    }
+    SECTION("BC1")
+    {
+        MakeMipSet(&cmips, &mipSet, CMP_FORMAT_BC1, CF_Compressed, TDT_ARGB, TT_2D, 20, 12, 1, 3);
+        glInternalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    }
+
+    const std::string fileName = TEST_DATA_PATH + std::string("/KTX_2D_Matches_libktx.ktx");
+    REQUIRE(SaveKTX(fileName, &cmips, &mipSet));
+    std::vector<CMP_BYTE> saved = ReadFileBytes(fileName);
+    std::remove(fileName.c_str());
+    REQUIRE(saved.size() >= sizeof(KTX_header));
+
+    KTX_header header;
+    memcpy(&header, saved.data(), sizeof(header));
+    CHECK(header.glFormat == glFormat);
+    CHECK(header.glInternalFormat == glInternalFormat);
+
+    // The same texture written by libktx, as the plugin used to save it
+    KTX_texture_info textureinfo;
+    textureinfo.glType                = header.glType;
+    textureinfo.glTypeSize            = header.glTypeSize;
+    textureinfo.glFormat              = header.glFormat;
+    textureinfo.glInternalFormat      = header.glInternalFormat;
+    textureinfo.glBaseInternalFormat  = header.glBaseInternalFormat;
+    textureinfo.pixelWidth            = header.pixelWidth;
+    textureinfo.pixelHeight           = header.pixelHeight;
+    textureinfo.pixelDepth            = header.pixelDepth;
+    textureinfo.numberOfArrayElements = header.numberOfArrayElements;
+    textureinfo.numberOfFaces         = header.numberOfFaces;
+    textureinfo.numberOfMipmapLevels  = header.numberOfMipmapLevels;
+
+    std::vector<KTX_image_info> images(mipSet.m_nMipLevels);
+    for (int l = 0; l < mipSet.m_nMipLevels; l++)
+    {
+        images[l].size = cmips.GetMipLevel(&mipSet, l)->m_dwLinearSize;
+        images[l].data = cmips.GetMipLevel(&mipSet, l)->m_pbData;
+    }
+
+    unsigned char* pExpected     = NULL;
+    GLsizei        nExpectedSize = 0;
+    REQUIRE(ktxWriteKTXM(&pExpected, &nExpectedSize, &textureinfo, 0, NULL, (GLuint)images.size(), images.data()) == KTX_SUCCESS);
+
+    CHECK(saved.size() == (size_t)nExpectedSize);
+    CHECK(memcmp(saved.data(), pExpected, (std::min)(saved.size(), (size_t)nExpectedSize)) == 0);
+
+    free(pExpected);
+    CMP_FreeMipSet(&mipSet);
+}
+
+TEST_CASE("KTX_Cube_Map_And_Volume_Round_Trip", "[KTX]")
+{
+    CMIPS      cmips;
+    CMP_MipSet mipSet;
+
+    SECTION("Cube map")
+    {
+        MakeMipSet(&cmips, &mipSet, CMP_FORMAT_ARGB_8888, CF_8bit, TDT_ARGB, TT_CubeMap, 8, 8, 6, 2);
+    }
+    SECTION("Cube map with padded rows")
+    {
+        MakeMipSet(&cmips, &mipSet, CMP_FORMAT_R_8, CF_8bit, TDT_R, TT_CubeMap, 5, 5, 6, 3);
+    }
+    SECTION("Volume texture")
+    {
+        MakeMipSet(&cmips, &mipSet, CMP_FORMAT_ARGB_8888, CF_8bit, TDT_ARGB, TT_VolumeTexture, 8, 4, 4, 3);
+    }
+    SECTION("Volume texture with padded rows")
+    {
+        MakeMipSet(&cmips, &mipSet, CMP_FORMAT_R_8, CF_8bit, TDT_R, TT_VolumeTexture, 7, 3, 3, 2);
+    }
+
+    const std::string fileName = TEST_DATA_PATH + std::string("/KTX_Cube_Map_And_Volume_Round_Trip.ktx");
+    REQUIRE(SaveKTX(fileName, &cmips, &mipSet));
+
+    CMP_MipSet loaded;
+    REQUIRE(LoadKTX(fileName, &cmips, &loaded));
+    std::remove(fileName.c_str());
+    CHECK(SameMipSets(&cmips, &loaded, &mipSet));
+
+    CMP_FreeMipSet(&mipSet);
+    CMP_FreeMipSet(&loaded);
+}
+
+TEST_CASE("KTX_Load_From_Memory", "[KTX]")
+{
+    CMP_MipSet mipSet;
+
+    SECTION("Padded rows")
+    {
+        // 5 byte rows padded to 8 bytes
+        std::vector<CMP_BYTE> file = MakeKTXHeader(GL_UNSIGNED_BYTE, 1, GL_RED, 5, 3, false);
+        AppendU32(file, 24, false);
+        for (int y = 0; y < 3; y++)
+        {
+            for (int x = 0; x < 8; x++)
+                file.push_back((x < 5) ? (CMP_BYTE)(y * 16 + x) : 0xEE);
+        }
+
+        REQUIRE(LoadFromMemory(file, &mipSet) == CMP_OK);
+        CHECK(mipSet.m_format == CMP_FORMAT_R_8);
+        REQUIRE(mipSet.m_nWidth == 5);
+        REQUIRE(mipSet.m_nHeight == 3);
+        REQUIRE(mipSet.dwDataSize == 15);
+        for (int y = 0; y < 3; y++)
+            for (int x = 0; x < 5; x++)
+                CHECK(mipSet.pData[y * 5 + x] == y * 16 + x);
+    }
+    SECTION("Big endian padded rows")
+    {
+        // 6 byte rows of 16 bit values padded to 8 bytes
+        std::vector<CMP_BYTE> file = MakeKTXHeader(GL_UNSIGNED_SHORT, 2, GL_RED, 3, 2, true);
+        AppendU32(file, 16, true);
+        for (int y = 0; y < 2; y++)
+        {
+            for (int x = 0; x < 3; x++)
+            {
+                uint16_t v = (uint16_t)(0x1234 + y * 0x0100 + x);
+                file.push_back((CMP_BYTE)(v >> 8));
+                file.push_back((CMP_BYTE)v);
+            }
+            file.push_back(0xEE);
+            file.push_back(0xEE);
+        }
+
+        REQUIRE(LoadFromMemory(file, &mipSet) == CMP_OK);
+        CHECK(mipSet.m_format == CMP_FORMAT_R_16);
+        REQUIRE(mipSet.m_nWidth == 3);
+        REQUIRE(mipSet.m_nHeight == 2);
+        REQUIRE(mipSet.dwDataSize == 12);
+        const uint16_t* pValues = (const uint16_t*)mipSet.pData;
+        for (int y = 0; y < 2; y++)
+            for (int x = 0; x < 3; x++)
+                CHECK(pValues[y * 3 + x] == 0x1234 + y * 0x0100 + x);
+    }
+    SECTION("Big endian float")
+    {
+        const float values[16] = {0.0f, 1.0f, -2.5f, 0.125f, 3.0e5f, -1.0e-3f, 42.0f, 0.5f, 7.0f, -8.0f, 0.25f, 1.5f, 100.0f, -0.0625f, 2.0f, 0.75f};
+
+        std::vector<CMP_BYTE> file = MakeKTXHeader(GL_FLOAT, 4, GL_RGBA, 2, 2, true);
+        AppendU32(file, sizeof(values), true);
+        for (float value : values)
+        {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            AppendU32(file, bits, true);
+        }
+
+        REQUIRE(LoadFromMemory(file, &mipSet) == CMP_OK);
+        CHECK(mipSet.m_format == CMP_FORMAT_ARGB_32F);
+        REQUIRE(mipSet.m_nWidth == 2);
+        REQUIRE(mipSet.m_nHeight == 2);
+        REQUIRE(mipSet.dwDataSize == sizeof(values));
+        CHECK(memcmp(mipSet.pData, values, sizeof(values)) == 0);
+    }
+
+    CMP_FreeMipSet(&mipSet);
+}
@@ -0,0 +1,135 @@
+//=====================================================================
+// Copyright (c) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "single_include/catch2/catch.hpp"
+
+#include "mesh_compressor.h"
+#include "test_constants.h"
+
+// A width x height grid of quads with varying normals and texture coordinates
+static CMP_Mesh MakeGridMesh(unsigned int width, unsigned int height)
+{
+    CMP_Mesh mesh;
+
+    for (unsigned int y = 0; y <= height; y++)
+    {
+        for (unsigned int x = 0; x <= width; x++)
+        {
+            Vertex v;
+            v.px = (float)x;
+            v.py = (float)y;
+            v.pz = (float)((x * 7 + y * 3) % 5) * 0.25f;
+            v.nx = 0.0f;
+            v.ny = (float)(x % 2);
+            v.nz = 1.0f;
+            v.tx = (float)x / width;
+            v.ty = (float)y / height;
+            mesh.vertices.push_back(v);
+        }
+    }
+
+    for (unsigned int y = 0; y < height; y++)
+    {
+        for (unsigned int x = 0; x < width; x++)
+        {
+            unsigned int i = y * (width + 1) + x;
+            unsigned int quad[6] = {i, i + 1, i + width + 1, i + 1, i + width + 2, i + width + 1};
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+
+    return mesh;
+}
+
+// The index codec keeps the winding of each triangle but may rotate its vertices
+static bool SameTriangles(const std::vector<unsigned int>& a, const std::vector<unsigned int>& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t i = 0; i < a.size(); i += 3)
+    {
+        bool same = false;
+        for (int r = 0; r < 3; r++)
+            same |= (a[i] == b[i + r]) && (a[i + 1] == b[i + (r + 1) % 3]) && (a[i + 2] == b[i + (r + 2) % 3]);
+        if (!same)
+            return false;
+    }
+
+    return true;
+}
+
+TEST_CASE("Mesh_Compressor_Meshopt_Codec", "[MESH]")
+{
+    Plugin_Mesh_Compressor* plugin = (Plugin_Mesh_Compressor*)make_Plugin_Mesh_Compressor();
+    REQUIRE(plugin->Init() == 0);
+
+    CMP_Mesh          mesh     = MakeGridMesh(32, 16);
+    const std::string meshFile = TEST_DATA_PATH + std::string("/Mesh_Compressor_Meshopt_Codec.cmsh");
+
+    CMP_DracoOptions options;
+    options.use_meshopt_codec = true;
+    options.output            = meshFile;
+
+    REQUIRE(plugin->ProcessMesh(&mesh, &options, NULL, NULL) == &mesh);
+
+    std::ifstream     file(meshFile, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove(meshFile.c_str());
+
+    // The codec output must be smaller than the raw vertex and index buffers
+    CHECK(data.size() < mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(unsigned int));
+
+    SECTION("Decode")
+    {
+        options.m_bDecode = true;
+
+        CMP_Mesh* decoded = (CMP_Mesh*)plugin->ProcessMesh(&data, &options, NULL, NULL);
+        REQUIRE(decoded != NULL);
+
+        REQUIRE(decoded->vertices.size() == mesh.vertices.size());
+        CHECK(memcmp(decoded->vertices.data(), mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex)) == 0);
+        CHECK(SameTriangles(decoded->indices, mesh.indices));
+
+        delete decoded;
+    }
+
+    SECTION("Truncated data")
+    {
+        options.m_bDecode = true;
+        data.resize(data.size() / 2);
+
+        CHECK(plugin->ProcessMesh(&data, &options, NULL, NULL) == NULL);
+    }
+
+    plugin->CleanUp();
+    delete plugin;
+}
@@ -22,6 +22,13 @@
 //=====================================================================
 
 #include <string>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 
 #include "single_include/catch2/catch.hpp"
 
@@ -350,3 +357,122 @@ TEST_CASE("Filter Gamma", "[MIPMAP]")
         CHECK(adjustedScore < colorScore);
     }
 }
+
+static CMP_INT   g_arenaAllocs = 0;
+static CMP_INT   g_arenaFrees  = 0;
+static CMP_BYTE* g_arenaBase   = NULL;
+static size_t    g_arenaSize   = 0;
+
+static void* CMP_API TestArenaAlloc(size_t size, size_t alignment, void* pUserData)
+{
+    (void)pUserData;
+    g_arenaAllocs++;
+    CHECK(alignment >= 64);
+#ifdef _WIN32
+    g_arenaBase = reinterpret_cast<CMP_BYTE*>(_aligned_malloc(size, alignment));
+#else
+    void* pArena = NULL;
+    g_arenaBase  = posix_memalign(&pArena, alignment, size) == 0 ? reinterpret_cast<CMP_BYTE*>(pArena) : NULL;
+#endif
+    g_arenaSize = size;
+    return g_arenaBase;
+}
+
+static void CMP_API TestArenaFree(void* pArena, size_t size, void* pUserData)
+{
+    (void)size;
+    (void)pUserData;
+    g_arenaFrees++;
+#ifdef _WIN32
+    _aligned_free(pArena);
+#else
+    free(pArena);
+#endif
+}
+
+static bool InArena(const CMP_MipSet* pMipSet, CMP_INT nMipLevel)
+{
+    CMP_MipLevel* level = 0;
+    CMP_GetMipLevel(&level, pMipSet, nMipLevel, 0);
+    return level && (level->m_pbData >= g_arenaBase) && (level->m_pbData + level->m_dwLinearSize <= g_arenaBase + g_arenaSize) &&
+           ((reinterpret_cast<size_t>(level->m_pbData) % 64) == 0);
+}
+
+TEST_CASE("Arena_MipSet", "[MIPMAP]")
+{
+    CMP_MipSetAllocator allocator = {TestArenaAlloc, TestArenaFree, NULL, false};
+    CMP_SetMipSetAllocator(&allocator);
+
+    g_arenaAllocs = 0;
+    g_arenaFrees  = 0;
+
+    CMP_MipSet texture = {};
+    texture.m_format   = CMP_FORMAT_RGBA_8888;
+    texture.m_Flags    = MS_FLAG_ArenaAlloc;
+
+    CMP_ERROR error = CMP_CreateMipSet(&texture, 300, 200, 1, CF_8bit, TT_2D);
+    REQUIRE(error == CMP_OK);
+    CHECK(g_arenaAllocs == 1);
+
+    CMP_MipLevel* baseLevel = 0;
+    CMP_GetMipLevel(&baseLevel, &texture, 0, 0);
+    REQUIRE(baseLevel != 0);
+    memset(baseLevel->m_pbData, 0x80, baseLevel->m_dwLinearSize);
+
+    error = (CMP_ERROR)CMP_GenerateMIPLevels(&texture, 1);
+    REQUIRE(error == CMP_OK);
+    CHECK(texture.m_nMipLevels == texture.m_nMaxMipLevels);
+
+    // Every level is carved from the arena at a 64 byte boundary
+    for (CMP_INT i = 0; i < texture.m_nMipLevels; i++)
+        CHECK(InArena(&texture, i));
+
+    // A copy of the MipSet shares the arena, so the pipeline can hand a MipSet over by copying it
+    CMP_MipSet copy;
+    memcpy(&copy, &texture, sizeof(CMP_MipSet));
+    texture.m_pMipLevelTable = NULL;
+
+    CMP_FreeMipSet(&texture);
+    CHECK(g_arenaFrees == 0);
+
+    CMP_FreeMipSet(&copy);
+    CHECK(g_arenaAllocs == 1);
+    CHECK(g_arenaFrees == 1);
+
+    CMP_SetMipSetAllocator(NULL);
+}
+
+TEST_CASE("Arena_All_MipSets", "[MIPMAP]")
+{
+    CMP_MipSetAllocator allocator = {TestArenaAlloc, TestArenaFree, NULL, true};
+    CMP_SetMipSetAllocator(&allocator);
+
+    g_arenaAllocs = 0;
+    g_arenaFrees  = 0;
+
+    // A 64x64 32 bit TGA, decoded by stb_image
+    std::vector<CMP_BYTE> tga(18 + 64 * 64 * 4, 0x40);
+    memset(tga.data(), 0, 18);
+    tga[2]  = 2;
+    tga[12] = 64;
+    tga[14] = 64;
+    tga[16] = 32;
+    tga[17] = 8;
+
+    CMP_MipSet texture = {};
+    REQUIRE(CMP_LoadTextureFromMemory(tga.data(), tga.size(), &texture) == CMP_OK);
+
+    // The loader adopts its decoded image as level 0, which needs no arena
+    CHECK(g_arenaAllocs == 0);
+
+    REQUIRE(CMP_GenerateMIPLevels(&texture, 1) == CMP_OK);
+    CHECK(g_arenaAllocs == 1);
+    CHECK(!InArena(&texture, 0));
+    for (CMP_INT i = 1; i < texture.m_nMipLevels; i++)
+        CHECK(InArena(&texture, i));
+
+    CMP_FreeMipSet(&texture);
+    CHECK(g_arenaFrees == 1);
+
+    CMP_SetMipSetAllocator(NULL);
+}
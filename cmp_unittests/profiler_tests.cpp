@@ -0,0 +1,274 @@
+//=====================================================================
+// Copyright (c) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "single_include/catch2/catch.hpp"
+
+#include "compressonator.h"
+#include "cmp_profiler.h"
+#include "test_constants.h"
+
+// The fields of one line of the trace, as CMP_Profiler_WriteTrace writes them
+typedef struct
+{
+    std::string name;
+    std::string ph;
+    long long   tid;
+    long long   ts;
+    long long   dur;    // -1 for counters
+    long long   value;  // Counter total, -1 for scopes
+    long long   level;  // Scope argument, -1 when there is none
+} TraceEvent;
+
+static std::string ReadFile(const std::string& fileName)
+{
+    std::ifstream     file(fileName.c_str(), std::ios::binary);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+static std::string StringField(const std::string& line, const char* key)
+{
+    std::string pattern = std::string("\"") + key + "\":\"";
+    size_t      start   = line.find(pattern);
+    if (start == std::string::npos)
+        return "";
+    start += pattern.size();
+    return line.substr(start, line.find('"', start) - start);
+}
+
+static long long NumberField(const std::string& line, const char* key)
+{
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t      start   = line.find(pattern);
+    if (start == std::string::npos)
+        return -1;
+    return atoll(line.c_str() + start + pattern.size());
+}
+
+// Checks the document around the events, one event per line, and returns the events
+static bool ParseTrace(const std::string& text, std::vector<TraceEvent>& events)
+{
+    const std::string head = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    const std::string tail = "]}\n";
+    if ((text.compare(0, head.size(), head) != 0) || (text.size() < head.size() + tail.size()) ||
+        (text.compare(text.size() - tail.size(), tail.size(), tail) != 0))
+        return false;
+
+    std::stringstream lines(text.substr(head.size(), text.size() - head.size() - tail.size()));
+    std::string       line;
+    while (std::getline(lines, line))
+    {
+        // Every event but the last is followed by a comma
+        bool bLast = lines.peek() == EOF;
+        if (!bLast && (line.empty() || line[line.size() - 1] != ','))
+            return false;
+        if (!bLast)
+            line.erase(line.size() - 1);
+        if ((line.size() < 2) || (line[0] != '{') || (line[line.size() - 1] != '}'))
+            return false;
+
+        TraceEvent event;
+        event.name  = StringField(line, "name");
+        event.ph    = StringField(line, "ph");
+        event.tid   = NumberField(line, "tid");
+        event.ts    = NumberField(line, "ts");
+        event.dur   = NumberField(line, "dur");
+        event.value = NumberField(line, "value");
+        event.level = NumberField(line, "level");
+        if ((NumberField(line, "pid") != 1) || (event.tid < 1) || (event.ts < 0))
+            return false;
+        if ((event.ph == "X") ? ((event.dur < 0) || (StringField(line, "cat") != "cmp")) : ((event.ph != "C") || (event.value < 0)))
+            return false;
+        events.push_back(event);
+    }
+
+    return true;
+}
+
+static const TraceEvent* FindEvent(const std::vector<TraceEvent>& events, const char* name, size_t nth = 0)
+{
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        if ((events[i].name == name) && (nth-- == 0))
+            return &events[i];
+    }
+    return NULL;
+}
+
+static bool WriteAndParseTrace(const char* testName, std::vector<TraceEvent>& events)
+{
+    const std::string traceFile = TEST_DATA_PATH + std::string("/") + testName + ".json";
+    if (!CMP_Profiler_WriteTrace(traceFile.c_str()))
+        return false;
+
+    std::string text = ReadFile(traceFile);
+    std::remove(traceFile.c_str());
+    return ParseTrace(text, events);
+}
+
+TEST_CASE("Profiler_Disabled", "[Profiler]")
+{
+    CMP_Profiler_Enable(false);
+    CMP_Profiler_Reset();
+    {
+        CMP_PROFILE_SCOPE("Not recorded");
+        CMP_PROFILE_COUNT("Not counted", 1);
+    }
+
+    std::vector<TraceEvent> events;
+    REQUIRE(WriteAndParseTrace("Profiler_Disabled", events));
+    CHECK(events.empty());
+}
+
+TEST_CASE("Profiler_Nested_Scopes", "[Profiler]")
+{
+    CMP_Profiler_Reset();
+    CMP_Profiler_Enable(true);
+    {
+        CMP_PROFILE_SCOPE("Outer");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        for (int nMipLevel = 0; nMipLevel < 2; nMipLevel++)
+        {
+            CMP_PROFILE_SCOPE_ARG("Inner", nMipLevel);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    CMP_Profiler_Enable(false);
+
+    std::vector<TraceEvent> events;
+    REQUIRE(WriteAndParseTrace("Profiler_Nested_Scopes", events));
+    REQUIRE(events.size() == 3);
+
+    // Scopes are recorded as they end, the inner ones first
+    const TraceEvent* outer  = FindEvent(events, "Outer");
+    const TraceEvent* inner0 = FindEvent(events, "Inner", 0);
+    const TraceEvent* inner1 = FindEvent(events, "Inner", 1);
+    REQUIRE(outer);
+    REQUIRE(inner0);
+    REQUIRE(inner1);
+    CHECK(&events[2] == outer);
+
+    CHECK(outer->level == -1);
+    CHECK(inner0->level == 0);
+    CHECK(inner1->level == 1);
+    CHECK(inner0->tid == outer->tid);
+
+    // Each inner scope lies within the outer one and after the previous one
+    CHECK(inner0->dur >= 2000);
+    CHECK(inner1->dur >= 2000);
+    CHECK(outer->dur >= 8000);
+    CHECK(inner0->ts >= outer->ts + 2000);
+    CHECK(inner1->ts >= inner0->ts + inner0->dur);
+    CHECK(inner1->ts + inner1->dur + 2000 <= outer->ts + outer->dur);
+}
+
+TEST_CASE("Profiler_Counters", "[Profiler]")
+{
+    CMP_Profiler_Reset();
+    CMP_Profiler_Enable(true);
+
+    // Counted from several threads, each event carries the running total
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.push_back(std::thread([]() {
+            for (int i = 0; i < 100; i++)
+                CMP_PROFILE_COUNT("Blocks", 3);
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+    CMP_PROFILE_COUNT("Texels", 16);
+    CMP_Profiler_Enable(false);
+
+    std::vector<TraceEvent> events;
+    REQUIRE(WriteAndParseTrace("Profiler_Counters", events));
+    REQUIRE(events.size() == 401);
+
+    long long lastBlocks = 0;
+    for (size_t i = 0; i < 400; i++)
+    {
+        CHECK(events[i].name == "Blocks");
+        CHECK(events[i].ph == "C");
+        CHECK(events[i].value == lastBlocks + 3);
+        lastBlocks = events[i].value;
+    }
+    CHECK(lastBlocks == 1200);
+    CHECK(events[400].name == "Texels");
+    CHECK(events[400].value == 16);
+}
+
+TEST_CASE("Profiler_Library_Scopes", "[Profiler]")
+{
+    // The codecs of CMP_Compressonator record into the trace the application enabled
+    std::vector<CMP_BYTE> pixels(16 * 16 * 4, 128);
+    std::vector<CMP_BYTE> blocks(8 * 4 * 4);
+
+    CMP_Texture srcTexture = {};
+    srcTexture.dwSize      = sizeof(srcTexture);
+    srcTexture.dwWidth     = 16;
+    srcTexture.dwHeight    = 16;
+    srcTexture.dwPitch     = 16 * 4;
+    srcTexture.format      = CMP_FORMAT_RGBA_8888;
+    srcTexture.dwDataSize  = (CMP_DWORD)pixels.size();
+    srcTexture.pData       = pixels.data();
+
+    CMP_Texture destTexture = {};
+    destTexture.dwSize      = sizeof(destTexture);
+    destTexture.dwWidth     = 16;
+    destTexture.dwHeight    = 16;
+    destTexture.format      = CMP_FORMAT_BC1;
+    destTexture.dwDataSize  = CMP_CalculateBufferSize(&destTexture);
+    REQUIRE(destTexture.dwDataSize == blocks.size());
+    destTexture.pData = blocks.data();
+
+    CMP_CompressOptions options = {};
+    options.dwSize              = sizeof(options);
+    options.dwnumThreads        = 1;
+
+    CMP_Profiler_Reset();
+    CMP_Profiler_Enable(true);
+    REQUIRE(CMP_ConvertTexture(&srcTexture, &destTexture, &options, NULL) == CMP_OK);
+    CMP_Profiler_Enable(false);
+
+    std::vector<TraceEvent> events;
+    REQUIRE(WriteAndParseTrace("Profiler_Library_Scopes", events));
+
+    const TraceEvent* encode = FindEvent(events, "Codec encode");
+    const TraceEvent* texels = FindEvent(events, "Texels encoded");
+    REQUIRE(encode);
+    REQUIRE(texels);
+    CHECK(encode->ph == "X");
+    CHECK(texels->value == 256);
+}
@@ -0,0 +1,192 @@
+//=====================================================================
+// Copyright (c) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "single_include/catch2/catch.hpp"
+
+#include "compressonator.h"
+#include "cmp_core.h"
+
+static const int RDO_TEST_WIDTH  = 128;
+static const int RDO_TEST_HEIGHT = 64;
+
+// RGBA pixels of gradients, noise and repeated patterns, so that the blocks have
+// neighbours worth matching. Red equals blue, so the error does not depend on
+// the channel order a codec reads the pixels in.
+static std::vector<CMP_BYTE> MakeRDOImage()
+{
+    std::vector<CMP_BYTE> pixels((size_t)RDO_TEST_WIDTH * RDO_TEST_HEIGHT * 4);
+    unsigned int          seed = 4321;
+
+    for (int y = 0; y < RDO_TEST_HEIGHT; y++)
+    {
+        for (int x = 0; x < RDO_TEST_WIDTH; x++)
+        {
+            seed        = seed * 1103515245 + 12345;
+            int noise   = (int)((seed >> 16) % 9) - 4;
+            CMP_BYTE* p = &pixels[((size_t)y * RDO_TEST_WIDTH + x) * 4];
+
+            if ((x / 16 + y / 16) % 2)
+            {
+                p[0] = (CMP_BYTE)std::min(255, std::max(0, x * 2 + noise));
+                p[1] = (CMP_BYTE)std::min(255, std::max(0, 255 - y * 3 - noise));
+                p[3] = (CMP_BYTE)std::min(255, std::max(0, 128 + (x - y) + noise));
+            }
+            else
+            {
+                p[0] = (CMP_BYTE)(((x % 8) < 4) ? 40 : 200);
+                p[1] = (CMP_BYTE)(((y % 8) < 4) ? 90 : 160);
+                p[3] = (CMP_BYTE)((x % 4) * 60);
+            }
+            p[2] = p[0];
+        }
+    }
+
+    return pixels;
+}
+
+static std::vector<CMP_BYTE> CompressRDO(const std::vector<CMP_BYTE>& pixels, CMP_FORMAT format, float fLambda, float fMaxErrorIncrease)
+{
+    CMP_Texture srcTexture = {};
+    srcTexture.dwSize      = sizeof(srcTexture);
+    srcTexture.dwWidth     = RDO_TEST_WIDTH;
+    srcTexture.dwHeight    = RDO_TEST_HEIGHT;
+    srcTexture.dwPitch     = RDO_TEST_WIDTH * 4;
+    srcTexture.format      = CMP_FORMAT_RGBA_8888;
+    srcTexture.dwDataSize  = (CMP_DWORD)pixels.size();
+    srcTexture.pData       = (CMP_BYTE*)pixels.data();
+
+    CMP_Texture destTexture = {};
+    destTexture.dwSize      = sizeof(destTexture);
+    destTexture.dwWidth     = RDO_TEST_WIDTH;
+    destTexture.dwHeight    = RDO_TEST_HEIGHT;
+    destTexture.format      = format;
+    destTexture.dwDataSize  = CMP_CalculateBufferSize(&destTexture);
+
+    std::vector<CMP_BYTE> blocks(destTexture.dwDataSize);
+    destTexture.pData = blocks.data();
+
+    CMP_CompressOptions options  = {};
+    options.dwSize               = sizeof(options);
+    options.fquality             = 0.05f;
+    options.fRDOLambda           = fLambda;
+    options.fRDOMaxErrorIncrease = fMaxErrorIncrease;
+    REQUIRE(CMP_ConvertTexture(&srcTexture, &destTexture, &options, NULL) == CMP_OK);
+
+    return blocks;
+}
+
+// Root mean square error of each block over the channels that the format holds
+static std::vector<double> BlockRMSE(const std::vector<CMP_BYTE>& pixels, CMP_FORMAT format, const std::vector<CMP_BYTE>& blocks)
+{
+    const int blocksX   = RDO_TEST_WIDTH / 4;
+    const int blocksY   = RDO_TEST_HEIGHT / 4;
+    size_t    blockSize = blocks.size() / ((size_t)blocksX * blocksY);
+
+    int numChannels = 4;
+    if (format == CMP_FORMAT_BC1)
+        numChannels = 3;
+    else if (format == CMP_FORMAT_BC4)
+        numChannels = 1;
+    else if (format == CMP_FORMAT_BC5)
+        numChannels = 2;
+
+    std::vector<double> rmse;
+    for (int by = 0; by < blocksY; by++)
+    {
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            const CMP_BYTE* block = &blocks[((size_t)by * blocksX + bx) * blockSize];
+            CMP_BYTE        decoded[64];
+            CMP_BYTE        channels[2][16];
+            memset(decoded, 0, sizeof(decoded));
+
+            if (format == CMP_FORMAT_BC1)
+                DecompressBlockBC1(block, decoded, NULL);
+            else if (format == CMP_FORMAT_BC3)
+                DecompressBlockBC3(block, decoded, NULL);
+            else if (format == CMP_FORMAT_BC7)
+                DecompressBlockBC7(block, decoded, NULL);
+            else
+            {
+                if (format == CMP_FORMAT_BC4)
+                    DecompressBlockBC4(block, channels[0], NULL);
+                else
+                    DecompressBlockBC5(block, channels[0], channels[1], NULL);
+                for (int i = 0; i < 16; i++)
+                    for (int c = 0; c < numChannels; c++)
+                        decoded[i * 4 + c] = channels[c][i];
+            }
+
+            double error = 0;
+            for (int i = 0; i < 16; i++)
+            {
+                const CMP_BYTE* p = &pixels[((size_t)(by * 4 + i / 4) * RDO_TEST_WIDTH + bx * 4 + i % 4) * 4];
+                for (int c = 0; c < numChannels; c++)
+                {
+                    double d = (double)decoded[i * 4 + c] - p[c];
+                    error += d * d;
+                }
+            }
+            rmse.push_back(sqrt(error / (16 * numChannels)));
+        }
+    }
+
+    return rmse;
+}
+
+// Largest increase of the error of a block from before to after
+static double MaxIncrease(const std::vector<double>& before, const std::vector<double>& after)
+{
+    double maxIncrease = 0;
+    for (size_t i = 0; i < before.size(); i++)
+        maxIncrease = std::max(maxIncrease, after[i] - before[i]);
+    return maxIncrease;
+}
+
+TEST_CASE("RDO_Max_Error_Increase", "[RDO]")
+{
+    CMP_FORMAT format = GENERATE(CMP_FORMAT_BC1, CMP_FORMAT_BC3, CMP_FORMAT_BC4, CMP_FORMAT_BC5, CMP_FORMAT_BC7);
+    INFO("Format " << format);
+
+    std::vector<CMP_BYTE> pixels  = MakeRDOImage();
+    std::vector<CMP_BYTE> blocks  = CompressRDO(pixels, format, 0.0f, 0.0f);
+    std::vector<double>   before  = BlockRMSE(pixels, format, blocks);
+
+    // Lambda 0 leaves the blocks of the codec as they are
+    CHECK((CompressRDO(pixels, format, 0.0f, 100.0f) == blocks));
+
+    // No block gets worse than the bound allows, 0 gives the default bound of 1 level
+    float fMaxErrorIncrease = GENERATE(0.0f, 0.25f, 4.0f);
+    INFO("Max error increase " << fMaxErrorIncrease);
+
+    std::vector<CMP_BYTE> rdoBlocks = CompressRDO(pixels, format, 32.0f, fMaxErrorIncrease);
+    CHECK(MaxIncrease(before, BlockRMSE(pixels, format, rdoBlocks)) <= ((fMaxErrorIncrease > 0.0f) ? fMaxErrorIncrease : 1.0f) + 1e-6);
+
+    if (fMaxErrorIncrease > 1.0f)
+        CHECK((rdoBlocks != blocks));
+}
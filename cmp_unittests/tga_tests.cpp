@@ -0,0 +1,220 @@
+//=====================================================================
+// Copyright (c) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//=====================================================================
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "single_include/catch2/catch.hpp"
+
+#include "compressonator.h"
+#include "common.h"
+#include "tc_pluginapi.h"
+#include "tga.h"
+#include "test_constants.h"
+
+// Large enough for the loader and writer to work in parallel bands of rows. The width is not
+// a multiple of the 128 pixel packet limit, so packets start at varying columns.
+static const int TGA_TEST_WIDTH  = 520;
+static const int TGA_TEST_HEIGHT = 520;
+
+// RGBA pixels, top row first, made of runs of one color and of noise. Runs are up to 300
+// pixels long, so they span several packets and continue onto the next row.
+static std::vector<CMP_BYTE> MakeRunsImage(bool bAlpha)
+{
+    std::vector<CMP_BYTE> pixels((size_t)TGA_TEST_WIDTH * TGA_TEST_HEIGHT * 4);
+    unsigned int          seed = 12345;
+    size_t                i    = 0;
+
+    while (i < pixels.size())
+    {
+        seed          = seed * 1103515245 + 12345;
+        bool   bRun   = (seed >> 16) & 1;
+        size_t nCount = 1 + ((seed >> 17) % 300);
+
+        CMP_BYTE color[4];
+        for (size_t p = 0; (p < nCount) && (i < pixels.size()); p++, i += 4)
+        {
+            if ((p == 0) || !bRun)
+            {
+                seed = seed * 1103515245 + 12345;
+                for (int c = 0; c < 4; c++)
+                    color[c] = (CMP_BYTE)(seed >> (8 + c * 6));
+                if (!bAlpha)
+                    color[3] = 255;
+            }
+            memcpy(&pixels[i], color, 4);
+        }
+    }
+
+    return pixels;
+}
+
+// Run length encodes the image as a bottom up TGA of nSize (3 or 4) byte BGR(A) pixels.
+// Unlike the plugin, packets do not stop at the end of a row.
+static std::vector<CMP_BYTE> EncodeRowCrossingRLE(const std::vector<CMP_BYTE>& pixels, int nSize)
+{
+    std::vector<CMP_BYTE> stream;
+    for (int y = TGA_TEST_HEIGHT - 1; y >= 0; y--)
+    {
+        for (int x = 0; x < TGA_TEST_WIDTH; x++)
+        {
+            const CMP_BYTE* p = &pixels[((size_t)y * TGA_TEST_WIDTH + x) * 4];
+            CMP_BYTE        tga[4] = {p[2], p[1], p[0], p[3]};
+            stream.insert(stream.end(), tga, tga + nSize);
+        }
+    }
+
+    std::vector<CMP_BYTE> out;
+    size_t                nPixels = stream.size() / nSize;
+    size_t                i       = 0;
+    while (i < nPixels)
+    {
+        size_t nRun = 1;
+        while ((i + nRun < nPixels) && (nRun < 128) && (memcmp(&stream[i * nSize], &stream[(i + nRun) * nSize], nSize) == 0))
+            nRun++;
+
+        if (nRun > 1)
+        {
+            out.push_back((CMP_BYTE)(0x80 | (nRun - 1)));
+            out.insert(out.end(), &stream[i * nSize], &stream[i * nSize] + nSize);
+            i += nRun;
+            continue;
+        }
+
+        size_t nRaw = 1;
+        while ((i + nRaw < nPixels) && (nRaw < 128) &&
+               ((i + nRaw + 1 >= nPixels) || (memcmp(&stream[(i + nRaw) * nSize], &stream[(i + nRaw + 1) * nSize], nSize) != 0)))
+            nRaw++;
+
+        out.push_back((CMP_BYTE)(nRaw - 1));
+        out.insert(out.end(), &stream[i * nSize], &stream[(i + nRaw) * nSize]);
+        i += nRaw;
+    }
+
+    return out;
+}
+
+static bool WriteTGAFile(const std::string& fileName, const TGAHeader& header, const std::vector<CMP_BYTE>& data)
+{
+    FILE* pFile = fopen(fileName.c_str(), "wb");
+    if (!pFile)
+        return false;
+
+    bool bResult = (fwrite(&header, sizeof(header), 1, pFile) == 1) && (fwrite(data.data(), data.size(), 1, pFile) == 1);
+    fclose(pFile);
+    return bResult;
+}
+
+static int ReadTGAImageType(const std::string& fileName)
+{
+    TGAHeader header = {};
+    FILE*     pFile  = fopen(fileName.c_str(), "rb");
+    if (!pFile)
+        return -1;
+
+    size_t nRead = fread(&header, sizeof(header), 1, pFile);
+    fclose(pFile);
+    return (nRead == 1) ? header.cImageType : -1;
+}
+
+static bool LoadTGA(const std::string& fileName, CMIPS* pCMips, CMP_MipSet* pMipSet)
+{
+    Plugin_TGA* plugin = (Plugin_TGA*)make_Plugin_TGA();
+    plugin->TC_PluginSetSharedIO(pCMips);
+
+    memset(pMipSet, 0, sizeof(CMP_MipSet));
+    bool bLoaded = plugin->TC_PluginFileLoadTexture(fileName.c_str(), pMipSet) == PE_OK;
+
+    delete plugin;
+    return bLoaded;
+}
+
+static bool SaveTGA(const std::string& fileName, CMIPS* pCMips, CMP_MipSet* pMipSet, const char* pszFileSaveParams)
+{
+    Plugin_TGA* plugin = (Plugin_TGA*)make_Plugin_TGA();
+    plugin->TC_PluginSetSharedIO(pCMips);
+    if (pszFileSaveParams)
+        plugin->TC_PluginSetFileSaveParams(pszFileSaveParams);
+
+    bool bSaved = plugin->TC_PluginFileSaveTexture(fileName.c_str(), pMipSet) == PE_OK;
+
+    delete plugin;
+    return bSaved;
+}
+
+static bool SamePixels(CMIPS* pCMips, CMP_MipSet* pMipSet, const std::vector<CMP_BYTE>& pixels)
+{
+    CMP_MipLevel* pMipLevel = pCMips->GetMipLevel(pMipSet, 0);
+    return (pMipSet->m_nWidth == TGA_TEST_WIDTH) && (pMipSet->m_nHeight == TGA_TEST_HEIGHT) && pMipLevel && pMipLevel->m_pbData &&
+           (memcmp(pMipLevel->m_pbData, pixels.data(), pixels.size()) == 0);
+}
+
+TEST_CASE("TGA_RLE_Round_Trip", "[TGA]")
+{
+    CMIPS      cmips;
+    int        nSize = GENERATE(3, 4);
+    const bool bAlpha = (nSize == 4);
+
+    std::vector<CMP_BYTE> pixels   = MakeRunsImage(bAlpha);
+    const std::string     srcFile  = TEST_DATA_PATH + std::string("/TGA_RLE_Round_Trip_src.tga");
+    const std::string     rleFile  = TEST_DATA_PATH + std::string("/TGA_RLE_Round_Trip_rle.tga");
+    const std::string     flatFile = TEST_DATA_PATH + std::string("/TGA_RLE_Round_Trip_flat.tga");
+
+    TGAHeader header    = {};
+    header.cImageType   = ImageType_ARGB8888_RLE;
+    header.nWidth       = TGA_TEST_WIDTH;
+    header.nHeight      = TGA_TEST_HEIGHT;
+    header.cColorDepth  = (CMP_BYTE)(nSize * 8);
+    header.cFormatFlags = bAlpha ? 0x8 : 0;
+    REQUIRE(WriteTGAFile(srcFile, header, EncodeRowCrossingRLE(pixels, nSize)));
+
+    // Packets that continue onto the next row are decoded where each row starts
+    CMP_MipSet mipSet;
+    REQUIRE(LoadTGA(srcFile, &cmips, &mipSet));
+    std::remove(srcFile.c_str());
+    CHECK(SamePixels(&cmips, &mipSet, pixels));
+
+    // The saved RLE image reads back the same
+    REQUIRE(SaveTGA(rleFile, &cmips, &mipSet, "RLE"));
+    CHECK(ReadTGAImageType(rleFile) == ImageType_ARGB8888_RLE);
+
+    CMP_MipSet rleMipSet;
+    REQUIRE(LoadTGA(rleFile, &cmips, &rleMipSet));
+    std::remove(rleFile.c_str());
+    CHECK(SamePixels(&cmips, &rleMipSet, pixels));
+
+    // RLE was asked for by the previous save only, this one is uncompressed
+    REQUIRE(SaveTGA(flatFile, &cmips, &mipSet, NULL));
+    CHECK(ReadTGAImageType(flatFile) == ImageType_ARGB8888);
+
+    CMP_MipSet flatMipSet;
+    REQUIRE(LoadTGA(flatFile, &cmips, &flatMipSet));
+    std::remove(flatFile.c_str());
+    CHECK(SamePixels(&cmips, &flatMipSet, pixels));
+
+    CMP_FreeMipSet(&mipSet);
+    CMP_FreeMipSet(&rleMipSet);
+    CMP_FreeMipSet(&flatMipSet);
+}